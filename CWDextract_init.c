@@ -145,10 +145,10 @@ int CWDextract_init(file init, control_struct* ctrl, CWDextract_struct* CWE)
 			
 
 		/* allocate space for the temporary MGM array */
-		CWE->CWEyear_array         = (int*) malloc(CWE->CWE_num*sizeof(int));  
-		CWE->CWEmonth_array        = (int*) malloc(CWE->CWE_num*sizeof(int)); 
-		CWE->CWEday_array          = (int*) malloc(CWE->CWE_num*sizeof(int)); 
-		CWE->removePROP_CWE        = (double*) malloc(CWE->CWE_num*sizeof(double)); 
+		CWE->CWEyear_array         = (int*) arena_malloc(CWE->CWE_num*sizeof(int));  
+		CWE->CWEmonth_array        = (int*) arena_malloc(CWE->CWE_num*sizeof(int)); 
+		CWE->CWEday_array          = (int*) arena_malloc(CWE->CWE_num*sizeof(int)); 
+		CWE->removePROP_CWE        = (double*) arena_malloc(CWE->CWE_num*sizeof(double)); 
 	
 		for (nmgm = 0; nmgm < CWE->CWE_num; nmgm++)
 		{
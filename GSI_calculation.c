@@ -30,7 +30,8 @@ int GSI_calculation(const metarr_struct* metarr, const siteconst_struct* sitec,
 
 {
 	int errorCode=0;
-	int ny, yday, back;
+	int ny, yday, back, ni;
+	double*** index_array[6];
 
 	int firstdayLP = 240;		/* theoretically first day of litterfall */
 
@@ -91,44 +92,28 @@ int GSI_calculation(const metarr_struct* metarr, const siteconst_struct* sitec,
 	/////////////allocate memory for arrays containing ondays and offdays /////////////////////////////////////
 	if (!errorCode) 
 	{
-		/* allocate space for the onday_arr and offday_arr: first column - year, second column: day*/
-		phenarr->onday_arr  = (int**) malloc(nyears*sizeof(int*));  
-        phenarr->offday_arr = (int**) malloc(nyears*sizeof(int*));  
-
-		phenarr->Tmin_index     = (double**) malloc(nyears*sizeof(int*));  
-		phenarr->vpd_index      = (double**) malloc(nyears*sizeof(int*));  
-		phenarr->dayl_index     = (double**) malloc(nyears*sizeof(int*));  
-		phenarr->gsi_indexAVG   = (double**) malloc(nyears*sizeof(int*));  
-		phenarr->heatsum_index  = (double**) malloc(nyears*sizeof(int*));  
-		phenarr->heatsum        = (double**) malloc(nyears*sizeof(int*));  
-
-		for (ny = 0; ny<nyears; ny++)
+		/* the onday_arr and offday_arr are allocated by the caller; the rows of the index arrays are in one block per array,
+		   which is pointed by the first row */
+		index_array[0] = &phenarr->Tmin_index;
+		index_array[1] = &phenarr->vpd_index;
+		index_array[2] = &phenarr->dayl_index;
+		index_array[3] = &phenarr->gsi_indexAVG;
+		index_array[4] = &phenarr->heatsum_index;
+		index_array[5] = &phenarr->heatsum;
+
+		for (ni = 0; !errorCode && ni < 6; ni++)
 		{
-			phenarr->onday_arr[ny]  = (int*) malloc(2*sizeof(int));  
-			phenarr->offday_arr[ny] = (int*) malloc(2*sizeof(int));  
-			phenarr->onday_arr[ny]  = (int*) malloc(2*sizeof(int));  
-			phenarr->offday_arr[ny] = (int*) malloc(2*sizeof(int)); 
-
-			phenarr->Tmin_index[ny]     = (double*) malloc(nDAYS_OF_YEAR*sizeof(double));  
-			phenarr->vpd_index[ny]      = (double*) malloc(nDAYS_OF_YEAR*sizeof(double));  
-			phenarr->dayl_index[ny]     = (double*) malloc(nDAYS_OF_YEAR*sizeof(double));  
-			phenarr->gsi_indexAVG[ny]   = (double*) malloc(nDAYS_OF_YEAR*sizeof(double));  
-			phenarr->heatsum_index[ny]  = (double*) malloc(nDAYS_OF_YEAR*sizeof(double));  
-			phenarr->heatsum[ny]        = (double*) malloc(nDAYS_OF_YEAR*sizeof(double));  
-		}
-	
-		if (!phenarr->onday_arr)
-		{
-			printf("\n");
-			printf("ERROR allocating for onday_arr, GSI_calculation()\n");
-			errorCode=1;
-		}
-
-		if (!phenarr->offday_arr)
-		{
-			printf("\n");
-			printf("ERROR allocating for offday_arr, GSI_calculation()\n");
-			errorCode=1;
+			*index_array[ni] = (double**) malloc(nyears*sizeof(double*));  
+			if (!*index_array[ni] || !((*index_array[ni])[0] = (double*) malloc(nyears*nDAYS_OF_YEAR*sizeof(double))))
+			{
+				printf("\n");
+				printf("ERROR allocating for index arrays, GSI_calculation()\n");
+				errorCode=1;
+			}
+			else
+			{
+				for (ny = 1; ny<nyears; ny++) (*index_array[ni])[ny] = (*index_array[ni])[0] + ny*nDAYS_OF_YEAR;
+			}
 		}
 	}
 	
@@ -144,12 +129,12 @@ int GSI_calculation(const metarr_struct* metarr, const siteconst_struct* sitec,
 		/* ******************************************************************* */
 		/* 1. calculation of snow loss and plus*/
 		
-			Tmax_act     = metarr->Tmax_array[ny*n_yday+yday];
-			Tmin_act     = metarr->Tmin_array[ny*n_yday+yday];
+			Tmax_act     = metarr_value(metarr, METARR_TMAX, ny*n_yday+yday);
+			Tmin_act     = metarr_value(metarr, METARR_TMIN, ny*n_yday+yday);
 			Tavg_act     = (Tmax_act+Tmin_act)/2.;
-			prcp_act     = metarr->prcp_array[ny*n_yday+yday];	
-			srad_act     = metarr->swavgfd_array[ny*n_yday+yday];
-			dayl_act     = metarr->dayl_array[ny*n_yday+yday];
+			prcp_act     = metarr_value(metarr, METARR_PRCP, ny*n_yday+yday);	
+			srad_act     = metarr_value(metarr, METARR_SWAVGFD, ny*n_yday+yday);
+			dayl_act     = metarr_value(metarr, METARR_DAYL, ny*n_yday+yday);
 
 			/* canopy transmitted radiaiton: convert from W/m2 --> KJ/m2/d */	
 			rn = srad_act * (1.0 - albedo_sw) * dayl_act * sn_abs * 0.001;
@@ -202,11 +187,11 @@ int GSI_calculation(const metarr_struct* metarr, const siteconst_struct* sitec,
 				for (back=0; back<=n_moving_avg; back++)
 				{
 					/* search actual values of variables */
-					Tmax_act = metarr->Tmax_array[ny*n_yday+yday-(n_moving_avg-back)];
-					Tmin_act = metarr->Tmin_array[ny*n_yday+yday-(n_moving_avg-back)];
+					Tmax_act = metarr_value(metarr, METARR_TMAX, ny*n_yday+yday-(n_moving_avg-back));
+					Tmin_act = metarr_value(metarr, METARR_TMIN, ny*n_yday+yday-(n_moving_avg-back));
 					Tavg_act = (Tmax_act+Tmin_act)/2.;
-					vpd_act  = metarr->vpd_array[ny*n_yday+yday-(n_moving_avg-back)];
-					dayl_act = metarr->dayl_array[ny*n_yday+yday-(n_moving_avg-back)];
+					vpd_act  = metarr_value(metarr, METARR_VPD, ny*n_yday+yday-(n_moving_avg-back));
+					dayl_act = metarr_value(metarr, METARR_DAYL, ny*n_yday+yday-(n_moving_avg-back));
 					 
 			
 					/* ******************************************************************* */
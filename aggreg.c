@@ -0,0 +1,170 @@
+/*
+aggreg.c
+online user-defined temporal aggregation of the outputs: sum, mean, minimum, maximum or number of days above a threshold
+of a model variable over calendar windows (year, month, period of the year), while a condition holds (e.g. phenophase)
+or between events (e.g. management actions); each window is written into the aggregation output file when it is closed
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_constants.h"
+#include "bgc_func.h"
+
+
+/* writing the actual window of an aggregation into the output file */
+static int aggreg_write(const aggspec_struct* spec, int ns, file aggout)
+{
+	static const char* funcname[]   = {"SUM", "MEAN", "MIN", "MAX", "COUNT"};
+	static const char* windowname[] = {"YEAR", "MONTH", "PERIOD", "WHILE", "EVENT"};
+	double value;
+
+	value = spec->value;
+	if (spec->func == 1) value /= (double) spec->ndays;
+
+	if (fprintf(aggout.ptr, "%4i %7i %5s %6s %8i %8i %5i %14.9f\n", ns+1, spec->outcode, funcname[spec->func], windowname[spec->window],
+		        spec->start_date, spec->end_date, spec->ndays, value) < 0)
+	{
+		printf("ERROR writing to %s, aggreg_write()\n", aggout.name);
+		return (1);
+	}
+
+	return (0);
+}
+
+
+int aggreg_update(aggreg_struct* AGG, file aggout, double** output_map, int header, int yearOUT, int monthOUT, int dayOUT)
+{
+	/* the values are read directly from the output map, therefore the aggregation
+	   works also if no daily output is requested */
+	int errorCode=0;
+	int ns, mmdd, inwin, newwin;
+	double value, cond;
+	aggspec_struct* spec;
+
+	if (!errorCode && header && fprintf(aggout.ptr, "%4s %7s %5s %6s %8s %8s %5s %14s\n",
+		                                "aggr", "outcode", "func", "window", "start", "end", "ndays", "value") < 0)
+	{
+		printf("ERROR writing to %s, aggreg_update()\n", aggout.name);
+		errorCode=1;
+	}
+
+	mmdd = monthOUT*100 + dayOUT;
+
+	for (ns = 0; !errorCode && ns < AGG->nspec; ns++)
+	{
+		spec = &AGG->spec[ns];
+
+		if (output_map[spec->outcode] == NULL || ((spec->window == 3 || spec->window == 4) && output_map[spec->cond_outcode] == NULL))
+		{
+			printf("ERROR in aggregation.txt: output variable %i is not available (not part of the soil profile of the run)\n",
+				   output_map[spec->outcode] == NULL ? spec->outcode : spec->cond_outcode);
+			errorCode=1;
+			continue;
+		}
+
+		value = *(output_map[spec->outcode]);
+
+		/* the day belongs to the window (inwin) and starts a new window (newwin) */
+		switch (spec->window)
+		{
+		case 0:
+			inwin  = 1;
+			newwin = (mmdd == 101);
+			break;
+		case 1:
+			inwin  = 1;
+			newwin = (dayOUT == 1);
+			break;
+		case 2:
+			if (spec->start_mmdd <= spec->end_mmdd)
+				inwin = (mmdd >= spec->start_mmdd && mmdd <= spec->end_mmdd);
+			else
+				inwin = (mmdd >= spec->start_mmdd || mmdd <= spec->end_mmdd);
+			newwin = 0;
+			break;
+		case 3:
+			cond   = *(output_map[spec->cond_outcode]);
+			inwin  = (cond >= spec->cond_min && cond <= spec->cond_max);
+			newwin = 0;
+			break;
+		default:
+			cond   = *(output_map[spec->cond_outcode]);
+			newwin = (cond > spec->cond_min);
+			inwin  = (spec->open || newwin);
+			break;
+		}
+
+		/* closing the actual window */
+		if (spec->open && (!inwin || newwin))
+		{
+			if (aggreg_write(spec, ns, aggout)) errorCode=1;
+			spec->open = 0;
+		}
+
+		/* opening a new window */
+		if (inwin && !spec->open)
+		{
+			spec->open       = 1;
+			spec->start_date = yearOUT*10000 + mmdd;
+			spec->ndays      = 0;
+			spec->value      = 0;
+		}
+
+		if (spec->open)
+		{
+			switch (spec->func)
+			{
+			case 0:
+			case 1:
+				spec->value += value;
+				break;
+			case 2:
+				if (spec->ndays == 0 || value < spec->value) spec->value = value;
+				break;
+			case 3:
+				if (spec->ndays == 0 || value > spec->value) spec->value = value;
+				break;
+			default:
+				if (value > spec->threshold) spec->value += 1;
+				break;
+			}
+			spec->ndays   += 1;
+			spec->end_date = yearOUT*10000 + mmdd;
+		}
+	}
+
+	return (errorCode);
+}
+
+
+int aggreg_finish(aggreg_struct* AGG, file aggout)
+{
+	/* the windows open at the end of the simulation are written (partial windows) */
+	int errorCode=0;
+	int ns;
+
+	for (ns = 0; !errorCode && ns < AGG->nspec; ns++)
+	{
+		if (AGG->spec[ns].open && AGG->spec[ns].ndays)
+		{
+			if (aggreg_write(&AGG->spec[ns], ns, aggout)) errorCode=1;
+			AGG->spec[ns].open = 0;
+		}
+	}
+
+	return (errorCode);
+}
+
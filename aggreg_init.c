@@ -0,0 +1,195 @@
+/*
+aggreg_init.c
+read the user-defined temporal aggregations of the outputs if they are available and open the aggregation output file
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_constants.h"
+#include "bgc_func.h"
+
+
+int aggreg_init(aggreg_struct* AGG, const control_struct* ctrl, const resim_struct* RSM, output_struct* output)
+{
+	int errorCode=0;
+	file AGG_file;
+	char keyword[STRINGSIZE];
+	char name[STRINGSIZE];
+	aggspec_struct* spec;
+
+	/* default values: no aggregation, output file: outprefix.aggregation */
+	AGG->nspec = 0;
+	output->aggout.ptr = NULL;
+	strcpy(output->aggout.name, output->outprefix);
+	strcat(output->aggout.name, ".aggregation");
+
+	/********************************************************************
+	**                                                                 **
+	** Reading aggregation settings if available (only in normal run)  **
+	**                                                                 **
+	********************************************************************/
+
+	if (ctrl->spinup != 0) return (errorCode);
+
+	strcpy(AGG_file.name, "aggregation.txt");
+	if (file_open(&AGG_file,'j',1)) return (errorCode);
+
+	/* the file consists of keyword-blocks, the order of the blocks is arbitrary */
+	while (!errorCode && !scan_array(AGG_file, keyword, 's', 1, 0))
+	{
+		/* FILE block: name of the aggregation output file */
+		if (!strcmp(keyword, "FILE"))
+		{
+			if (!errorCode && scan_value(AGG_file, output->aggout.name, 's'))
+			{
+				printf("ERROR reading name of aggregation output file: aggreg_init()\n");
+				errorCode=22401;
+			}
+		}
+		/* AGGREGATE block: output code, function (SUM, MEAN, MIN, MAX or COUNT and threshold),
+		   window (YEAR, MONTH, PERIOD and first and last day (mmdd), WHILE and output code, lower and upper limit of the condition,
+		   EVENT and output code and threshold of the event), one value per line */
+		else if (!strcmp(keyword, "AGGREGATE"))
+		{
+			if (!errorCode && AGG->nspec == N_AGGSPEC)
+			{
+				printf("ERROR in aggregation.txt: maximum number of aggregations is %i\n", N_AGGSPEC);
+				errorCode=22402;
+			}
+
+			if (!errorCode)
+			{
+				spec = &AGG->spec[AGG->nspec];
+				memset(spec, 0, sizeof(aggspec_struct));
+			}
+
+			if (!errorCode && scan_value(AGG_file, &spec->outcode, 'i'))
+			{
+				printf("ERROR reading output code of aggregation: aggreg_init()\n");
+				errorCode=22403;
+			}
+			if (!errorCode && output_code_check(spec->outcode, "aggregation.txt"))
+				errorCode=22404;
+
+			/* function */
+			if (!errorCode && scan_value(AGG_file, name, 's'))
+			{
+				printf("ERROR reading function of aggregation: aggreg_init()\n");
+				errorCode=22403;
+			}
+			if (!errorCode)
+			{
+				if (!strcmp(name, "SUM"))
+					spec->func = 0;
+				else if (!strcmp(name, "MEAN"))
+					spec->func = 1;
+				else if (!strcmp(name, "MIN"))
+					spec->func = 2;
+				else if (!strcmp(name, "MAX"))
+					spec->func = 3;
+				else if (!strcmp(name, "COUNT"))
+					spec->func = 4;
+				else
+				{
+					printf("ERROR in aggregation.txt: unknown function --> %s\n", name);
+					errorCode=22405;
+				}
+			}
+			if (!errorCode && spec->func == 4 && scan_value(AGG_file, &spec->threshold, 'd'))
+			{
+				printf("ERROR reading threshold of counted days: aggreg_init()\n");
+				errorCode=22403;
+			}
+
+			/* window */
+			if (!errorCode && scan_value(AGG_file, name, 's'))
+			{
+				printf("ERROR reading window of aggregation: aggreg_init()\n");
+				errorCode=22403;
+			}
+			if (!errorCode)
+			{
+				if (!strcmp(name, "YEAR"))
+					spec->window = 0;
+				else if (!strcmp(name, "MONTH"))
+					spec->window = 1;
+				else if (!strcmp(name, "PERIOD"))
+					spec->window = 2;
+				else if (!strcmp(name, "WHILE"))
+					spec->window = 3;
+				else if (!strcmp(name, "EVENT"))
+					spec->window = 4;
+				else
+				{
+					printf("ERROR in aggregation.txt: unknown window --> %s\n", name);
+					errorCode=22405;
+				}
+			}
+			if (!errorCode && spec->window == 2)
+			{
+				if (scan_value(AGG_file, &spec->start_mmdd, 'i') || scan_value(AGG_file, &spec->end_mmdd, 'i'))
+				{
+					printf("ERROR reading first and last day of period: aggreg_init()\n");
+					errorCode=22403;
+				}
+				else if (spec->start_mmdd < 101 || spec->start_mmdd > 1231 || spec->end_mmdd < 101 || spec->end_mmdd > 1231)
+				{
+					printf("ERROR in aggregation.txt: first and last day of period must be given as mmdd\n");
+					errorCode=22406;
+				}
+			}
+			if (!errorCode && (spec->window == 3 || spec->window == 4))
+			{
+				if (scan_value(AGG_file, &spec->cond_outcode, 'i') || scan_value(AGG_file, &spec->cond_min, 'd') ||
+					(spec->window == 3 && scan_value(AGG_file, &spec->cond_max, 'd')))
+				{
+					printf("ERROR reading condition or event of aggregation window: aggreg_init()\n");
+					errorCode=22403;
+				}
+				else if (output_code_check(spec->cond_outcode, "aggregation.txt (condition or event)"))
+					errorCode=22404;
+				else if (spec->window == 3 && spec->cond_max < spec->cond_min)
+				{
+					printf("ERROR in aggregation.txt: upper limit of condition is less than lower limit\n");
+					errorCode=22406;
+				}
+			}
+
+			if (!errorCode) AGG->nspec += 1;
+		}
+		else
+		{
+			printf("ERROR in aggregation.txt: unknown keyword --> %s\n", keyword);
+			errorCode=224;
+		}
+	}
+
+	fclose(AGG_file.ptr);
+
+	/* the aggregation output file (the earlier file is kept for the incremental re-simulation) */
+	if (!errorCode && AGG->nspec)
+	{
+		if (RSM->flag) resim_backup(output->aggout.name);
+		if (file_open(&output->aggout,'o',1))
+		{
+			printf("ERROR opening aggregation output file: aggreg_init()\n");
+			errorCode=22407;
+		}
+	}
+
+	return (errorCode);
+}
+
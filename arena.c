@@ -0,0 +1,199 @@
+/*
+arena.c
+arena of the simulation: the arrays which live until the end of the simulation (met arrays, management and output
+settings, variable parameters) are allocated in large blocks and released at once at the end of the run;
+the arena of the calling thread is set by pointbgc_run(), arena_malloc() falls back to malloc() without arena;
+the released blocks of the standard size are kept by the thread for its next arenas until arena_cache_free()
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+
+/* alignment of the allocations (double and pointer arrays) */
+#define ARENA_ALIGN 16
+
+/* number of released blocks kept for the next arenas of the thread: the many short simulations of the optimizer,
+   sensitivity and server runs would otherwise give the blocks back to the system (heap trimming) and fault them in again */
+#define ARENA_NCACHE 16
+
+/* block of the arena: the allocated memory follows the header */
+struct arenablock
+{
+	struct arenablock* next;		/* earlier block */
+	size_t size;					/* (byte) usable size of the block */
+	size_t used;					/* (byte) given out from the block */
+};
+
+/* header size rounded up to the alignment */
+#define ARENA_HEADER (((sizeof(struct arenablock) + ARENA_ALIGN - 1) / ARENA_ALIGN) * ARENA_ALIGN)
+
+static arena_struct* arena_actual = NULL;		/* arena of the calling thread */
+#pragma omp threadprivate(arena_actual)
+
+static struct arenablock* arena_cache = NULL;	/* released blocks of the calling thread (of arena_cachesize) */
+static int arena_ncache = 0;
+static size_t arena_cachesize = 0;
+#pragma omp threadprivate(arena_cache, arena_ncache, arena_cachesize)
+
+static size_t arena_peak = 0;					/* largest arena of the simulations of the process */
+
+
+void arena_init(arena_struct* arena, size_t blocksize)
+{
+	memset(arena, 0, sizeof(arena_struct));
+	arena->blocksize = blocksize;
+}
+
+
+void* arena_alloc(arena_struct* arena, size_t size)
+{
+	struct arenablock* block;
+	size_t blocksize;
+	char* ptr;
+
+	size = ((size + ARENA_ALIGN - 1) / ARENA_ALIGN) * ARENA_ALIGN;
+
+	block = arena->block;
+	if (!block || block->size - block->used < size)
+	{
+		/* large arrays get their own block, the remainder of the actual block remains in use */
+		blocksize = (size > arena->blocksize) ? size : arena->blocksize;
+		if (arena_cache && blocksize == arena_cachesize)
+		{
+			block       = arena_cache;
+			arena_cache = block->next;
+			arena_ncache -= 1;
+		}
+		else
+			block = (struct arenablock*) malloc(ARENA_HEADER + blocksize);
+		if (!block) return (NULL);
+		block->size = blocksize;
+		block->used = 0;
+		if (size > arena->blocksize && arena->block)
+		{
+			block->next        = arena->block->next;
+			arena->block->next = block;
+		}
+		else
+		{
+			block->next  = arena->block;
+			arena->block = block;
+		}
+		arena->reserved += ARENA_HEADER + blocksize;
+		arena->nblock   += 1;
+	}
+
+	ptr = (char*) block + ARENA_HEADER + block->used;
+	block->used  += size;
+	arena->used  += size;
+	arena->nalloc += 1;
+
+	return ((void*) ptr);
+}
+
+
+void arena_cache_free(void)
+{
+	/* the released blocks kept by the calling thread are given back */
+	struct arenablock* block;
+
+	while (arena_cache)
+	{
+		block = arena_cache->next;
+		free(arena_cache);
+		arena_cache = block;
+	}
+	arena_ncache = 0;
+}
+
+
+void arena_release(arena_struct* arena)
+{
+	/* all memory of the arena is released at once (blocks of the standard size are kept for the next arenas) */
+	struct arenablock* block;
+
+	#pragma omp critical (arena)
+	{
+		if (arena->reserved > arena_peak) arena_peak = arena->reserved;
+	}
+
+	while (arena->block)
+	{
+		block = arena->block->next;
+		if (arena->block->size == arena->blocksize && (arena_ncache < ARENA_NCACHE || arena_cachesize != arena->blocksize))
+		{
+			/* the cache holds blocks of one size */
+			if (arena_cachesize != arena->blocksize) arena_cache_free();
+			arena_cachesize     = arena->blocksize;
+			arena->block->next  = arena_cache;
+			arena_cache         = arena->block;
+			arena_ncache       += 1;
+		}
+		else
+			free(arena->block);
+		arena->block = block;
+	}
+
+	arena_init(arena, arena->blocksize);
+}
+
+
+arena_struct* arena_enter(arena_struct* arena)
+{
+	/* the arena becomes the arena of the calling thread, the earlier one is returned */
+	arena_struct* previous;
+
+	previous     = arena_actual;
+	arena_actual = arena;
+
+	return (previous);
+}
+
+
+void* arena_malloc(size_t size)
+{
+	if (arena_actual) return (arena_alloc(arena_actual, size));
+
+	return (malloc(size));
+}
+
+
+int arena_report(file logfile)
+{
+	/* size of the arena of the calling thread in the log file */
+	if (!arena_actual) return (0);
+
+	fprintf(logfile.ptr, "\n");
+	fprintf(logfile.ptr, "MEMORY OF THE SIMULATION (ARENA)\n");
+	fprintf(logfile.ptr, "allocations: %li, used: %lu bytes, reserved: %lu bytes in %i blocks\n",
+		    arena_actual->nalloc, (unsigned long) arena_actual->used, (unsigned long) arena_actual->reserved, arena_actual->nblock);
+
+	return (ferror(logfile.ptr) ? 1 : 0);
+}
+
+
+size_t arena_highwater(void)
+{
+	/* high-water mark: largest reserved size of the released arenas */
+	size_t peak;
+
+	#pragma omp critical (arena)
+	{
+		peak = arena_peak;
+	}
+
+	return (peak);
+}
+
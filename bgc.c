@@ -114,9 +114,10 @@ int bgc(bgcin_struct* bgcin, bgcout_struct* bgcout)
 	int yday  = 0;
 	int i     = 0;
 	int first_balance;
-	int annual_alloc;
+	int snapshot_tofile;
 
-	double dailyNdep; 
+	/* daily step engine */
+	daystep_struct D;
 
 	double CbalanceERR = -100;
 	double NbalanceERR = -100;
@@ -383,22 +384,45 @@ int bgc(bgcin_struct* bgcin, bgcout_struct* bgcout)
 
 	fprintf(bgcout->log_file.ptr, " \n");
 
-	fprintf(bgcout->log_file.ptr, "SOIL PROPERTIES FOR 10 SOIL LAYERS (POTENTIALLY) ESTIMATED BY THE MODEL \n");
-	fprintf(bgcout->log_file.ptr, "Clapp-Hornberger b parameter [dimless]:%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f\n",sprop.soilB[0],sprop.soilB[1],sprop.soilB[2],sprop.soilB[3],sprop.soilB[4],sprop.soilB[5],sprop.soilB[6],sprop.soilB[7],sprop.soilB[8],sprop.soilB[9]);
-	fprintf(bgcout->log_file.ptr, "bulk density [g/cm3]:                  %12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f\n",sprop.BD[0],sprop.BD[1],sprop.BD[2],sprop.BD[3],sprop.BD[4],sprop.BD[5],sprop.BD[6],sprop.BD[7],sprop.BD[8],sprop.BD[9]);
-	fprintf(bgcout->log_file.ptr, "VWC at saturation [m3/m3]:             %12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f\n",sprop.VWCsat[0],sprop.VWCsat[1],sprop.VWCsat[2],sprop.VWCsat[3],sprop.VWCsat[4],sprop.VWCsat[5],sprop.VWCsat[6],sprop.VWCsat[7],sprop.VWCsat[8],sprop.VWCsat[9]);
-	fprintf(bgcout->log_file.ptr, "VWC at field capacity [m3/m3]:         %12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f\n",sprop.VWCfc[0],sprop.VWCfc[1],sprop.VWCfc[2],sprop.VWCfc[3],sprop.VWCfc[4],sprop.VWCfc[5],sprop.VWCfc[6],sprop.VWCfc[7],sprop.VWCfc[8],sprop.VWCfc[9]);
-	fprintf(bgcout->log_file.ptr, "VWC at wilting point [m3/m3]:          %12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f\n",sprop.VWCwp[0],sprop.VWCwp[1],sprop.VWCwp[2],sprop.VWCwp[3],sprop.VWCwp[4],sprop.VWCwp[5],sprop.VWCwp[6],sprop.VWCwp[7],sprop.VWCwp[8],sprop.VWCwp[9]);
-	fprintf(bgcout->log_file.ptr, "VWC at hygroscopic water [m3/m3]:      %12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f\n",sprop.VWChw[0],sprop.VWChw[1],sprop.VWChw[2],sprop.VWChw[3],sprop.VWChw[4],sprop.VWChw[5],sprop.VWChw[6],sprop.VWChw[7],sprop.VWChw[8],sprop.VWChw[9]);
-	fprintf(bgcout->log_file.ptr, "PSI at saturation [MPa]:               %12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f\n",sprop.PSIsat[0],sprop.PSIsat[1],sprop.PSIsat[2],sprop.PSIsat[3],sprop.PSIsat[4],sprop.PSIsat[5],sprop.PSIsat[6],sprop.PSIsat[7],sprop.PSIsat[8],sprop.PSIsat[9]);
-	fprintf(bgcout->log_file.ptr, "PSI at field capacity [MPa]:           %12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f\n",sprop.PSIfc[0],sprop.PSIfc[1],sprop.PSIfc[2],sprop.PSIfc[3],sprop.PSIfc[4],sprop.PSIfc[5],sprop.PSIfc[6],sprop.PSIfc[7],sprop.PSIfc[8],sprop.PSIfc[9]);
-	fprintf(bgcout->log_file.ptr, "PSI at wilting point [MPa]:            %12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f\n",sprop.PSIwp[0],sprop.PSIwp[1],sprop.PSIwp[2],sprop.PSIwp[3],sprop.PSIwp[4],sprop.PSIwp[5],sprop.PSIwp[6],sprop.PSIwp[7],sprop.PSIwp[8],sprop.PSIwp[9]);
-	fprintf(bgcout->log_file.ptr, "drainage coefficient [prop]:           %12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f\n",sprop.drainCoeff[0],sprop.drainCoeff[1],sprop.drainCoeff[2],sprop.drainCoeff[3],sprop.drainCoeff[4],sprop.drainCoeff[5],sprop.drainCoeff[6],sprop.drainCoeff[7],sprop.drainCoeff[8],sprop.drainCoeff[9]);
-	fprintf(bgcout->log_file.ptr, "hydr. conduct. at saturation [m/day]:  %12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f\n",sprop.hydrCONDUCTsat[0]*nSEC_IN_DAY,sprop.hydrCONDUCTsat[1]*nSEC_IN_DAY,sprop.hydrCONDUCTsat[2]*nSEC_IN_DAY,sprop.hydrCONDUCTsat[3]*nSEC_IN_DAY,sprop.hydrCONDUCTsat[4]*nSEC_IN_DAY,sprop.hydrCONDUCTsat[5]*nSEC_IN_DAY,sprop.hydrCONDUCTsat[6]*nSEC_IN_DAY,sprop.hydrCONDUCTsat[7]*nSEC_IN_DAY,sprop.hydrCONDUCTsat[8]*nSEC_IN_DAY,sprop.hydrCONDUCTsat[9]*nSEC_IN_DAY);
-	fprintf(bgcout->log_file.ptr, "capillary fringe [m]:                  %12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f%12.3f\n",sprop.CapillFringe[0],sprop.CapillFringe[1],sprop.CapillFringe[2],sprop.CapillFringe[3],sprop.CapillFringe[4],sprop.CapillFringe[5],sprop.CapillFringe[6],sprop.CapillFringe[7],sprop.CapillFringe[8],sprop.CapillFringe[9]);
+	fprintf(bgcout->log_file.ptr, "SOIL PROPERTIES FOR %i SOIL LAYERS (POTENTIALLY) ESTIMATED BY THE MODEL \n", sitec.n_soillayers);
+	fprintf(bgcout->log_file.ptr, "Clapp-Hornberger b parameter [dimless]:");
+	for (i = 0; i < sitec.n_soillayers; i++) fprintf(bgcout->log_file.ptr, "%12.3f", sprop.soilB[i]);
+	fprintf(bgcout->log_file.ptr, "\n");
+	fprintf(bgcout->log_file.ptr, "bulk density [g/cm3]:                  ");
+	for (i = 0; i < sitec.n_soillayers; i++) fprintf(bgcout->log_file.ptr, "%12.3f", sprop.BD[i]);
+	fprintf(bgcout->log_file.ptr, "\n");
+	fprintf(bgcout->log_file.ptr, "VWC at saturation [m3/m3]:             ");
+	for (i = 0; i < sitec.n_soillayers; i++) fprintf(bgcout->log_file.ptr, "%12.3f", sprop.VWCsat[i]);
+	fprintf(bgcout->log_file.ptr, "\n");
+	fprintf(bgcout->log_file.ptr, "VWC at field capacity [m3/m3]:         ");
+	for (i = 0; i < sitec.n_soillayers; i++) fprintf(bgcout->log_file.ptr, "%12.3f", sprop.VWCfc[i]);
+	fprintf(bgcout->log_file.ptr, "\n");
+	fprintf(bgcout->log_file.ptr, "VWC at wilting point [m3/m3]:          ");
+	for (i = 0; i < sitec.n_soillayers; i++) fprintf(bgcout->log_file.ptr, "%12.3f", sprop.VWCwp[i]);
+	fprintf(bgcout->log_file.ptr, "\n");
+	fprintf(bgcout->log_file.ptr, "VWC at hygroscopic water [m3/m3]:      ");
+	for (i = 0; i < sitec.n_soillayers; i++) fprintf(bgcout->log_file.ptr, "%12.3f", sprop.VWChw[i]);
+	fprintf(bgcout->log_file.ptr, "\n");
+	fprintf(bgcout->log_file.ptr, "PSI at saturation [MPa]:               ");
+	for (i = 0; i < sitec.n_soillayers; i++) fprintf(bgcout->log_file.ptr, "%12.3f", sprop.PSIsat[i]);
+	fprintf(bgcout->log_file.ptr, "\n");
+	fprintf(bgcout->log_file.ptr, "PSI at field capacity [MPa]:           ");
+	for (i = 0; i < sitec.n_soillayers; i++) fprintf(bgcout->log_file.ptr, "%12.3f", sprop.PSIfc[i]);
+	fprintf(bgcout->log_file.ptr, "\n");
+	fprintf(bgcout->log_file.ptr, "PSI at wilting point [MPa]:            ");
+	for (i = 0; i < sitec.n_soillayers; i++) fprintf(bgcout->log_file.ptr, "%12.3f", sprop.PSIwp[i]);
+	fprintf(bgcout->log_file.ptr, "\n");
+	fprintf(bgcout->log_file.ptr, "drainage coefficient [prop]:           ");
+	for (i = 0; i < sitec.n_soillayers; i++) fprintf(bgcout->log_file.ptr, "%12.3f", sprop.drainCoeff[i]);
+	fprintf(bgcout->log_file.ptr, "\n");
+	fprintf(bgcout->log_file.ptr, "hydr. conduct. at saturation [m/day]:  ");
+	for (i = 0; i < sitec.n_soillayers; i++) fprintf(bgcout->log_file.ptr, "%12.3f", sprop.hydrCONDUCTsat[i]*nSEC_IN_DAY);
+	fprintf(bgcout->log_file.ptr, "\n");
+	fprintf(bgcout->log_file.ptr, "capillary fringe [m]:                  ");
+	for (i = 0; i < sitec.n_soillayers; i++) fprintf(bgcout->log_file.ptr, "%12.3f", sprop.CapillFringe[i]);
+	fprintf(bgcout->log_file.ptr, "\n");
 	fprintf(bgcout->log_file.ptr, " \n");
 
-	if (HRV.HRV_num) fprintf(bgcout->econout_file.ptr, "year planttype primaryProd[tC/ha] secondaryProd[tC/ha] condIRGamunt condIRGtype\n");
 	/********************************************************************************************************* */
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -466,26 +490,27 @@ int bgc(bgcin_struct* bgcin, bgcout_struct* bgcout)
 		}
 	}
 	
-	/* allocate space for the onday_arr and offday_arr: first column - year, second column: day*/
+	/* allocate space for the onday_arr and offday_arr: first column - year, second column: day
+	   (the rows are in one block, which is pointed by the first row) */
 	if (!errorCode)
 	{
 		phenarr.onday_arr  = (int**) malloc(nyears*sizeof(int*));  
         phenarr.offday_arr = (int**) malloc(nyears*sizeof(int*));  
-			
-		for (i = 0; i<nyears; i++)
-		{
-			phenarr.onday_arr[i]  = (int*) malloc(2*sizeof(int));  
-			phenarr.offday_arr[i] = (int*) malloc(2*sizeof(int));  
-			phenarr.onday_arr[i]  = (int*) malloc(2*sizeof(int));  
-			phenarr.offday_arr[i] = (int*) malloc(2*sizeof(int));  
-		}
 
-
-		if (!phenarr.onday_arr || !phenarr.onday_arr)
+		if (!phenarr.onday_arr || !phenarr.offday_arr || !(phenarr.onday_arr[0] = (int*) malloc(2*nyears*sizeof(int))) ||
+			!(phenarr.offday_arr[0] = (int*) malloc(2*nyears*sizeof(int))))
 		{
 			printf("ERROR allocating for onday_arr/offday_arr, bgc.c()\n");
 			errorCode=306;
 		}
+		else
+		{
+			for (i = 1; i<nyears; i++)
+			{
+				phenarr.onday_arr[i]  = phenarr.onday_arr[0] + 2*i;  
+				phenarr.offday_arr[i] = phenarr.offday_arr[0] + 2*i;  
+			}
+		}
 	}
 
 	/* allocate space for enddays */
@@ -510,14 +535,27 @@ int bgc(bgcin_struct* bgcin, bgcout_struct* bgcout)
 			errorCode=308;
 		}
 	}
+
+	/* streamed met input: own window of the run */
+	if (!errorCode && metarr.stream && metarr_stream_copy(&metarr))
+	{
+		printf("ERROR in call to metarr_stream_copy() from bgc.c\n");
+		errorCode=309;
+	}
 	
 	
 	/* initialize the output mapping array */
-	if (!errorCode && output_map_init(output_map,&phen,&metv,&ws,&wf,&cs,&cf,&ns,&nf,&sprop,&epv,&psn_sun,&psn_shade,&summary))
+	if (!errorCode && output_map_init(output_map,&phen,&metv,&ws,&wf,&cs,&cf,&ns,&nf,&sprop,&epv,&psn_sun,&psn_shade,&summary,sitec.n_soillayers))
 	{
 		printf("ERROR in call to output_map_init() from bgc.c\n");
 		errorCode=401;
 	}
+
+	if (!errorCode && output_map_check(output_map, &ctrl))
+	{
+		printf("ERROR in call to output_map_check() from bgc.c\n");
+		errorCode=401;
+	}
 	
 
 	/* atmospheric pressure (Pa) as a function of elevation (m) */
@@ -539,7 +577,7 @@ int bgc(bgcin_struct* bgcin, bgcout_struct* bgcout)
 	}
 
 	/* calculate conductance limitation factors */	
-	if (!errorCode && conduct_limit_factors(bgcout->log_file, &ctrl, &sprop, &epc, &epv))
+	if (!errorCode && conduct_limit_factors(bgcout->log_file, &ctrl, &sitec, &sprop, &epc, &epv))
 	{
 		printf("ERROR in call to conduct_limit_factors(), from bgc.c\n");
 		errorCode=404;
@@ -580,11 +618,49 @@ int bgc(bgcin_struct* bgcin, bgcout_struct* bgcout)
 
 	/* initialize the indicator for first day of current simulation, so that the checks for mass balance can have two days for comparison */
 	first_balance = 1;
+
+	/* incremental re-simulation: continuation from the last snapshot before the first changed input */
+	if (!errorCode && bgcin->RSM.flag && resim_prepare(bgcin, bgcout, &phenarr))
+	{
+		printf("ERROR in call to resim_prepare() from bgc.c\n");
+		errorCode=413;
+	}
+
+	if (!errorCode && bgcin->RSM.start_simyr && 
+		resim_restore(&bgcin->RSM, &bgcin->OBS, &bgcin->AGG, &first_balance, &ctrl, &metv, &ws, &wf, &cinit, &cs, &cf, &ns, &nf, &epv, &sitec, &sprop, &gwc, 
+		              &epc, &phen, &psn_sun, &psn_shade, &nt, &summary, &PLT, &THN, &MOW, &GRZ, &HRV, &PLG, &FRZ, &IRG, &MUL, &CWE, &FLD, &GWS))
+	{
+		printf("ERROR in call to resim_restore() from bgc.c\n");
+		errorCode=414;
+	}
+
+	/* initial state after the initialization (restart, first day): the coarse propagator of parareal.c extrapolates from it */
+	if (!errorCode && bgcin->RSM.init_state && !bgcin->RSM.start_simyr)
+	{
+		bgcin->RSM.init_state->ws = ws;
+		bgcin->RSM.init_state->cs = cs;
+		bgcin->RSM.init_state->ns = ns;
+	}
+
+	if (!errorCode && HRV.HRV_num && (!bgcin->RSM.start_simyr || bgcin->RSM.fork_flag)) 
+		fprintf(bgcout->econout_file.ptr, "year planttype primaryProd[tC/ha] secondaryProd[tC/ha] condIRGamunt condIRGtype\n");
 		
+	/* daily step engine on the local structures */
+	daystep_init(&D, bgcin, bgcout, &first_balance, &ctrl, &metarr, &metv, &ndep, &ws, &wf, &cs, &cf, &ns, &nf, &epc, &epv, &sitec, &sprop, &gwc, 
+		         &phenarr, &phen, &psn_sun, &psn_shade, &nt, &summary, &PLT, &THN, &MOW, &GRZ, &HRV, &PLG, &FRZ, &IRG, &MUL, &CWE, &FLD, &GWS, 
+				 output_map, dayarr, monavgarr, annavgarr, annarr, mondays, enddays);
+
+	/* daily step specialized for the configuration of the run */
+	if (!errorCode && daystep_select(&D, DAYSTEP_NORMAL))
+	{
+		printf("ERROR in call to daystep_select() from bgc.c\n");
+		errorCode=430;
+	}
+
 	/* !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! */
 	/* 1. BEGIN OF THE ANNUAL LOOP */
 
-	for (simyr=0 ; !errorCode && simyr<ctrl.simyears ; simyr++)
+	for (simyr=bgcin->RSM.start_simyr ; !errorCode && simyr<ctrl.simyears ; simyr++)
 	{
 
 
@@ -628,12 +704,12 @@ int bgc(bgcin_struct* bgcin, bgcout_struct* bgcout)
 		if (!(ndep.varndep))
 		{
 			/*constant Ndep */
-			dailyNdep = ndep.ndep / nDAYS_OF_YEAR;
+			D.dailyNdep = ndep.ndep / nDAYS_OF_YEAR;
 		}
 		else
 		{	
 			/* Ndep from file */
-			dailyNdep = ndep.Ndep_array[simyr] / nDAYS_OF_YEAR;
+			D.dailyNdep = ndep.Ndep_array[simyr] / nDAYS_OF_YEAR;
 		}
 		
 		if (ctrl.onscreen) printf("-------------------\n");
@@ -646,505 +722,21 @@ int bgc(bgcin_struct* bgcin, bgcout_struct* bgcout)
 		
 		for (yday=0 ; !errorCode && yday<nDAYS_OF_YEAR ; yday++)
 		{
+			errorCode = D.step(&D, simyr, yday);
+		}   /* end of daily model loop */
 
-		
-			/* set the day index for meteorological and phenological arrays */
-			ctrl.yday   = yday;
-			ctrl.metday	= simyr*nDAYS_OF_YEAR + yday;		
-
-			
-			/* set fluxes to zero */
-			if (!errorCode && make_zero_flux_struct(&wf, &cf, &nf, &gwc))
-			{
-				printf("ERROR in call to make_zero_flux_struct() from bgc.c\n");
-				errorCode=501;
-			}
-			
-
-			/* initalizing annmax and cumulative variables */
-			if (yday == 0)
-			{
-				if (!errorCode && annVARinit(&summary, &epv, &cs, &ws, &cf, &nf))
-				{
-					printf("ERROR in call to annVARinit() from bgc.c\n");
-					errorCode=502;
-				}
-			}
-			
-
-			/* set the day index for meteorological and phenological arrays */
-			ctrl.metday = simyr*nDAYS_OF_YEAR + yday;
-			
-
-			/* nitrogen deposition and fixation */
-			nf.ndep_to_sminn_total = dailyNdep;
-			nf.nfix_to_sminn_total = epc.nfix / nDAYS_OF_YEAR;
-
-	
-
-
-			/* calculating actual onday and offday */
-			if (!errorCode && dayphen(&ctrl, &epc, &phenarr, &PLT, &phen))
-			{
-				printf("ERROR in dayphen() from bgc.c\n");
-				errorCode=503;
-			}
-			
-
-			/* setting MANAGEMENT DAYS based on input data */
-			if (!errorCode && management(&ctrl, &FRZ, &GRZ, &HRV, &MOW, &PLT, &PLG, &THN, &IRG, &MUL, &CWE, &FLD, &GWS, mondays))
-			{
-				printf("ERROR in management days() from bgc.c\n");
-				errorCode=504;
-			}
-			
-
-		
-			/* determining soil hydrological parameters  */
- 			if (!errorCode && multilayer_hydrolparams(&sitec, &sprop, &ws, &epv))
-			{
-				printf("ERROR in multilayer_hydrolparams() from bgc.c\n");
-				errorCode=505;
-			}
-			
-		
-			/* daily meteorological variables from metarrays */
-			if (!errorCode && daymet(&ctrl, &metarr, &epc, &metv, ws.snoww))
-			{
-				printf("ERROR in daymet() from bgc.c\n");
-				errorCode=506;
-			}
-			
-		
-
-			/* phenophases calculation */
-			if (!errorCode && phenphase(bgcout->log_file, &ctrl, &epc, &sprop, &PLT, &phen, &metv, &epv, &cs))
-			{
-				printf("ERROR in phenphase() from bgc.c\n");
-				errorCode=507;
-			}
-			
-			
-			
-			/* soil temperature calculations */
-			if (!errorCode && multilayer_tsoil(&epc, &sitec, &sprop, &epv, yday, ws.snoww, &metv))
-			{
-				printf("ERROR in multilayer_tsoil() from bgc.c\n");
-				errorCode=508;
-			}
-			
-
-			/* soilCover calculations */
-			if (!errorCode && soilCover(&sitec, &sprop, &metv, &epv, &cs))
-			{
-				printf("ERROR in soilCover() from bgc.c\n");
-				errorCode=509;
-			}
-			
-
-			/* phenology calculation */
-			if (!errorCode && phenology(&epc, &cs, &ns, &phen, &metv, &epv, &cf, &nf))
-			{
-				printf("ERROR in phenology() from bgc.c\n");
-				errorCode=510;
-			}
-			
-
-			
-			/* calculate leaf area index, sun and shade fractions, and specific leaf area for sun and shade canopy fractions, then calculate canopy radiation interception and transmission */          
-			if (!errorCode && radtrans(&ctrl, &phen, &cs, &epc, &sitec, &metv, &epv))
-			{
-				printf("ERROR in radtrans() from bgc.c\n");
-				errorCode=511;
-			}
-			
-		
-			/* update the annmax LAI/rootingDepth/plantHeight for annual diagnostic output */
-			if (epv.proj_lai > epv.annmax_lai)             epv.annmax_lai = epv.proj_lai;
-			if (epv.rootDepth > epv.annmax_rootDepth)      epv.annmax_rootDepth = epv.rootDepth;
-			if (epv.plantHeight > epv.annmax_plantHeight)  epv.annmax_plantHeight = epv.plantHeight;
-
-			
-			/* IRRIGATING separately from other management routines*/
-			if (!errorCode && irrigating(&ctrl, &IRG, &sitec, &sprop, &epv, &ws, &wf))
-			{
-				printf("ERROR in irrigating() from bgc.c\n");
-				errorCode=512;
-			}
-			
-
-		
-			/* precip routing (when there is precip) */
-			if (!errorCode && metv.prcp && prcpANDrunoffH(&metv, &sprop, &epc, &epv, &wf))
-			{
-				printf("ERROR in prcpANDrunoffH() from bgc.c\n");
-				errorCode=513;
-			}
-			
-			
-			/* snowmelt (when there is a snowpack) */
-			if (!errorCode && ws.snoww && snowmelt(&metv, &wf, ws.snoww))
-			{
-				printf("ERROR in snowmelt() from bgc.c\n");
-				errorCode=514;
-			}
-			
-		
-
-			/* potential evaporation and transpiration */
-			if (!errorCode && Elimit_and_PET(&epc, &sprop, &metv, &epv, &wf))
-			{
-				printf("ERROR in Elimit_and_PET() from bgc.c\n");
-				errorCode=515;
-			}
-			
-
-			/* conductance calculation */
-			if (!errorCode && conduct_calc(&ctrl, &metv, &epc, &epv, simyr))
-			{
-				printf("ERROR in conduct_calc() from bgc.c\n");
-				errorCode=516;
-			}
-			
-
-		
-			/* begin canopy bio-physical process simulation */
-			/* do canopy ET calculations whenever there is leaf area displayed, since there may be intercepted water on the canopy that needs to be dealt with */
-			if (!errorCode && epv.n_actphen > epc.n_emerg_phenophase && metv.dayl)
-			{
-				/* evapotranspiration */
-				if (!errorCode && cs.leafc && canopy_et(&epc, &metv, &epv, &wf))
-				{
-					printf("ERROR in canopy_et() from bgc.c\n");
-					errorCode=517;
-				}
-			}
-			
-
-			/* daily maintenance respiration */
-			if (!errorCode && maint_resp(&PLT, &cs, &ns, &epc, &metv, &epv, &cf))
-			{
-				printf("ERROR in m_resp() from bgc.c\n");
-				errorCode=518;
-			}
-			
-
-
-			/* photosynthesis calculation */
-			if (!errorCode && cs.leafc && photosynthesis(&epc, &metv, &cs, &ws, &phen, &epv, &psn_sun, &psn_shade, &cf))
-			{
-				printf("ERROR in photosynthesis() from bgc.c\n");
-				errorCode=519;
-			}
-			
-			
-	
-		
-			/* daily litter and soil decomp and nitrogen fluxes */
-			if (!errorCode && decomp(&metv,&epc, &sprop, &sitec,&cs,&ns,&epv,&cf,&nf,&nt))
-			{
-				printf("ERROR in decomp() from bgc.c\n");
-				errorCode=520;
-			}
-			
-
-			/* Daily allocation gets called whether or not this is a current growth day, because the competition between decomp immobilization fluxes 
-			and plant growth N demand is resolved here.  On days with no growth, no allocation occurs, but immobilization fluxes are updated normally */
-
-			if (!errorCode && daily_allocation(&epc,&sprop,&metv,&ndep,&cs,&ns,&cf,&nf,&epv,&nt,0))
-			{
-				printf("ERROR in daily_allocation() from bgc.c\n");
-				errorCode=521;
-			}
-					
-			
-			/* heat stress during flowering can affect daily allocation of yield */
-			if (epc.n_flowHS_phenophase > 0)
-			{
-				if (!errorCode && flowering_heatstress(&epc, &metv, &cs, &epv, &cf, &nf))
-				{
-					printf("ERROR in flowering_heatstress() from bgc.c\n");
-					errorCode=522;
-				}
-			}
-			
-
-			/* reassess the annual turnover rates for livewood --> deadwood, and for evergreen leaf and fine root litterfall. 
-			This happens once each year, on the annual_alloc day (the last litterfall day - test for annual allocation day) */
-			
-			if (phen.remdays_litfall == 1) 
-				annual_alloc = 1;
-			else 
-				annual_alloc = 0;
-		
-
-			/* litterfall rates once a year */
-			if (!errorCode && annual_alloc)
-			{
-				if (!errorCode && annual_rates(&epc,&epv))
-				{
-					printf("ERROR in annual_rates() from bgc.c\n");
-					errorCode=523;
-				}
-				
-			} 
-			
-
-
-			/* daily growth respiration */
-			if (!errorCode && growth_resp(&epc, &cf))
-			{
-				printf("ERROR in growth_resp() from bgc.c\n");
-				errorCode=524;
-			}
-			
-			
-
-	
-			/* !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! */
-			/* 3. WATER CALCULATIONS WITH STATE UPDATE */
-
-	
-			/* EVAPORATION: calculation of actual evaporation from potential evaporation */
-			if (!errorCode && potEVPsurface_to_actEVPsurface(&ctrl, &sitec, &sprop, &epv, &ws, &wf))
-			{
-				printf("ERROR in potEVPsurface_to_actEVPsurface() from bgc.c()\n");
-				errorCode=525;
-			}
-			
-
-			
-	    	/* multilayer soil hydrology: percolation calculation based on PRCP, RUNOFF, EVP, TRP */
-			if (!errorCode && multilayer_hydrolprocess(&ctrl, &sitec, &sprop, &epc,  &epv, &ws, &wf, &GWS, &gwc, &FLD, mondays))
-			{
-				printf("ERROR in multilayer_hydrolprocess() from bgc.c\n");
-				errorCode=526;
-			}
-			
-	
-			/* !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! */
-			/* 4. STATE UPDATE */
-
-			/* daily update of the water state variables */
-			if (!errorCode && water_state_update(&wf, &ws))
-			{
-				printf("ERROR in water_state_update() from bgc.c\n");
-				errorCode=527;
-			}
-					
-
-			/* daily update of carbon and nitrogen state variables */
-			if (!errorCode && CN_state_update(&sitec, &epc, &ctrl, &epv, &cf, &nf, &cs, &ns, annual_alloc, epc.evergreen))
-			{
-				printf("ERROR in CN_state_update() from bgc.c\n");
-				errorCode=528;
-			}
-			
-    
-			/* !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! */
-			/* 5. MORTALITY AND NITROGEN FLUXES CALCULATION WITH OWN STATE UPDATE: 
-			to insure that pools don't go negative due to mortality/leaching fluxes conflicting with other proportional fluxes */
-
-			
-			/* calculate daily senescence mortality fluxes and update state variables */
-			if (!errorCode && senescence(&sitec, &epc, &GRZ, &metv, &ctrl, &cs, &cf, &ns, &nf, &epv))
-			{
-				printf("ERROR in senescence() from bgc.c\n");
-				errorCode=529;
-			}
-			
-			
-		    /* calculate daily mortality fluxes  and update state variables */
-			if (!errorCode && mortality(&ctrl, &sitec, &epc, &epv, &cs, &cf, &ns, &nf, simyr))
-			{
-				printf("ERROR in mortality() from bgc.c\n");
-				errorCode=530;
-			}
-			
-					
-			/* calculate the change of soil mineralized N in multilayer soil */ 
-			if (!errorCode && multilayer_sminn(&ctrl, &metv,&sprop, &sitec, &cf, &ndep, &epv, &ns, &nf))
-			{
-				printf("ERROR in multilayer_sminn() from bgc.c\n");
-				errorCode=531;
-			}
-			
-			
-			/* calculate the leaching of N, DOC and DON from multilayer soil */
-			if (!errorCode && multilayer_leaching(&sprop, &epv, &ctrl, &cs, &cf, &ns, &nf, &ws, &wf))
-			{
-				printf("ERROR in multilayer_leaching() from bgc.c\n");
-				errorCode=532;
-			}
-			
-			
-
-			/* !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! */
-			/* 6. MANAGEMENT FLUXES */
-			
-			/* PLANTING */
-			if (!errorCode && planting(&ctrl, &sitec, &PLT, &epc, &epv, &phen, &cs, &ns, &cf, &nf))
-			{
-				printf("ERROR in planting() from bgc.c\n");
-				errorCode=533;
-			}
-			
-
-
-		   	/* THINNIG  */
-			if (!errorCode && thinning(&ctrl, &epc, &THN, &cs, &ns, &ws, &cf, &nf, &wf))
-			{
-				printf("ERROR in thinning() from bgc.c\n");
-				errorCode=534;
-			}
-			
-
-			/* MOWING  */
-			if (!errorCode && mowing(&ctrl, &epc, &MOW, &epv, &cs, &ns, &ws, &cf, &nf, &wf))
-			{
-				printf("ERROR in mowing() from bgc.c\n");
-				errorCode=535;
-			}
-			
-
-			/* grazing  */
-			if (!errorCode && grazing(&ctrl, &epc, &sitec, &GRZ, &epv, &cs, &ns, &ws, &cf, &nf, &wf, mondays))
-			{
-				printf("ERROR in grazing() from bgc.c\n");
-				errorCode=536;
-			}
-			
-	
-		   	/* HARVESTING  */
-			if (!errorCode && harvesting(bgcout->econout_file, &ctrl, &phen, &epc, &HRV, &IRG, &epv, &cs, &ns, &ws, &cf, &nf, &wf))
-			{
-				printf("ERROR in harvesting() from bgc.c\n");
-				errorCode=537;
-			}
-			
- 
-			/* PLOUGHING */
- 			if (!errorCode && ploughing(&ctrl, &epc, &sitec, &sprop, &metv, &epv, &PLG, &cs, &ns, &ws, &cf, &nf, &wf))
-			{
-				printf("ERROR in ploughing() from bgc.c\n");
-				errorCode=538;
-			}
-			
-		 
-			/* FERTILIZING  */
-	    	if (!errorCode && fertilizing(&ctrl, &sitec, &sprop, &FRZ, &cs, &ns, &ws, &cf, &nf, &wf))
-			{
-				printf("ERROR in fertilizing() from bgc.c\n");
-				errorCode=539;
-			}	
-			
-
-			/* MULCHING */
-			if (!errorCode && mulching(&ctrl, &MUL, &cs, &ns, &cf, &nf))
-			{
-				printf("ERROR in mulching() from bgc.c\n");
-				errorCode=540;
-			}
-			
-
-			/* CWD-extract */
-			if (!errorCode && CWDextract(&ctrl, &CWE, &cs, &ns, &cf, &nf))
-			{
-				printf("ERROR in CWDextract() from bgc.c\n");
-				errorCode=541;
-			}
-			
-
-				
-			/* cut-down plant material (due to management) */
-			if (!errorCode && cutdown2litter(&sitec, &epc, &epv, &cs, &cf, &ns, &nf))
-			{
-				printf("ERROR in cutdown2litter() from bgc.c\n");
-				errorCode=542;
-			}
-			
-
-
-			/* calculating rooting depth, n_rootlayers, n_maxrootlayers, rootlengthProp */
- 			 if (!errorCode && multilayer_rootDepth(&epc, &sprop, &cs, &sitec, &epv))
-			 {
-				printf("ERROR in multilayer_rootDepth() from bgc.c\n");
-				errorCode=543;
-			 }
-			 
-
-			/* !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! */
-			/* 7. ERROR CHECKING AND SUMMARY VARIABLES  */
-			
-			/* test for very low state variable values and force them to 0.0 to avoid rounding and floating point overflow errors */
-			if (!errorCode && precision_control(&ws, &cs, &ns))
-			{
-				printf("ERROR in call to precision_control() from bgc.c\n");
-				errorCode=544;
-			} 
-			
-				
-		
-			/* test for water balance*/
- 			if (!errorCode && check_water_balance(&ws, first_balance))
-			{
-				printf("ERROR in check_water_balance() from bgc.c\n");
-				errorCode=545;
-			}
-			
-	
-	        /* test for carbon balance */
-			if (!errorCode && check_carbon_balance(&cs, first_balance))
-			{
-				printf("ERROR in check_carbon_balance() from bgc.c\n");
-				errorCode=546;
-			}
-			
-	
-			/* test for nitrogen balance */
-			if (!errorCode && check_nitrogen_balance(&ns, first_balance))
-			{
-				printf("ERROR in check_nitrogen_balance() from bgc.c\n");
-				errorCode=547;
-			}
-			
-			
-
-			/* calculate summary variables */
-			if (!errorCode && cnw_summary(&epc, &sitec, &sprop, &metv, &cs, &cf, &ns, &nf, &wf, &epv, &summary))
-			{
-				printf("ERROR in cnw_summary() from bgc.c\n");
-				errorCode=548;
-			}
-			
-		
-			/* output handling */
-			if (!errorCode && output_handling(mondays, enddays, &ctrl, output_map, dayarr, monavgarr, annavgarr, annarr, 
-				                            bgcout->dayout, bgcout->monavgout, bgcout->annavgout, bgcout->annout))
-			{
-				printf("ERROR in output_handling() from bgc.c\n");
-				errorCode=549;
-			}
-			
-
-			/*  if no dormant period (e.g. evergreen): last day is the dormant day */
-			if (phen.offday - phen.onday == 364 && phen.offday == phen.yday_total) 
-			{
-				epv.n_actphen = 0;
-				phen.onday = -1;
-				phen.offday = -1;
-				phen.remdays_litfall =-1;
-			}
-
-		
-			/* at the end of first day of simulation, turn off the first_balance switch */
-			if (first_balance) first_balance = 0;
-
-			/* if this is the last day of the current month: increment current month counter */
-			if (yday == enddays[ctrl.curmonth]) ctrl.curmonth++;
+		/* incremental re-simulation: snapshot of the state at the end of the year;
+		   management optimizer: the state at the end of the last simulated year is kept in memory */
+		snapshot_tofile = bgcin->RSM.flag && ((simyr+1) % bgcin->RSM.interval == 0 || simyr+1 == ctrl.simyears);
+		if (!errorCode && (snapshot_tofile || simyr == bgcin->RSM.stop_simyr) &&
+			resim_snapshot(&bgcin->RSM, bgcout, snapshot_tofile, &bgcin->OBS, &bgcin->AGG, first_balance, &ctrl, &metv, &ws, &wf, &cinit, &cs, &cf, &ns, &nf, &epv, &sitec, &sprop, &gwc, 
+			               &epc, &phen, &psn_sun, &psn_shade, &nt, &summary, &PLT, &THN, &MOW, &GRZ, &HRV, &PLG, &FRZ, &IRG, &MUL, &CWE, &FLD, &GWS))
+		{
+			printf("ERROR in call to resim_snapshot() from bgc.c\n");
+			errorCode=551;
+		}
 
-		}   /* end of daily model loop */
-		
+		if (simyr == bgcin->RSM.stop_simyr) break;
 
 	}   /* end of annual model loop */
 
@@ -1335,21 +927,30 @@ int bgc(bgcin_struct* bgcin, bgcout_struct* bgcout)
 	if ((errorCode == 0 || errorCode > 305)) free(output_map);
 	if (((errorCode == 0 ||errorCode > 306) && !ctrl.GSI_flag) || ((errorCode == 0 || errorCode > 405) && ctrl.GSI_flag)) 
 	{
+		free(phenarr.onday_arr[0]);
+		free(phenarr.offday_arr[0]);
 		free(phenarr.onday_arr);
 		free(phenarr.offday_arr);
 		if (ctrl.GSI_flag)
 		{
+			free(phenarr.Tmin_index[0]);
 			free(phenarr.Tmin_index);
+			free(phenarr.vpd_index[0]);
 			free(phenarr.vpd_index);
+			free(phenarr.heatsum_index[0]);
 			free(phenarr.heatsum_index);
+			free(phenarr.dayl_index[0]);
 			free(phenarr.dayl_index);
+			free(phenarr.gsi_indexAVG[0]);
 			free(phenarr.gsi_indexAVG);
+			free(phenarr.heatsum[0]);
 			free(phenarr.heatsum);
 
 		}
 	}
 	if (errorCode == 0 || errorCode > 307) free(enddays);
 	if (errorCode == 0 || errorCode > 308) free(mondays);
+	if (errorCode == 0 || errorCode > 309) metarr_stream_free(&metarr);
 	
 	/* print timing info if error */
 	if (errorCode)
@@ -16,12 +16,14 @@ int leapControl(int year, int* enddays, int* mondays, int* leap);
 
 int soilb_estimation(double sand, double silt, double* soilB, double* VWCsat,double* VWCfc, double* VWCwp,  
 	                 double* BD, double* RCN, int* soiltype);
-int multilayer_soilcalc(control_struct* ctrl,  soilprop_struct* sprop);
+int multilayer_soilcalc(control_struct* ctrl, const siteconst_struct* sitec, soilprop_struct* sprop);
 
 
 int output_map_init(double** output_map, phenology_struct* phen, metvar_struct* metv, wstate_struct* ws,
 	wflux_struct* wf, cstate_struct* cs, cflux_struct* cf, nstate_struct* ns, nflux_struct* nf, 
-	soilprop_struct* sprop, epvar_struct* epv, psn_struct* psn_sun, psn_struct* psn_shade, summary_struct* summary);
+	soilprop_struct* sprop, epvar_struct* epv, psn_struct* psn_sun, psn_struct* psn_shade, summary_struct* summary, int n_soillayers);
+int output_map_check(double** output_map, const control_struct* ctrl);
+int output_code_check(int code, const char* source);
 
 int make_zero_flux_struct(wflux_struct* wf, cflux_struct* cf, nflux_struct* nf, GWcalc_struct* gwc);
 
@@ -46,7 +48,11 @@ int management(control_struct* ctrl, fertilizing_struct* FRZ, grazing_struct* GR
 
 int multilayer_hydrolparams(const siteconst_struct* sitec, const soilprop_struct* sprop, wstate_struct* ws, epvar_struct* epv);
 
-int daymet(const control_struct* ctrl,const metarr_struct* metarr, const epconst_struct* epc, metvar_struct* metv, double snoww);
+int daymet(const control_struct* ctrl,const metarr_struct* metarr, const epconst_struct* epc, const siteconst_struct* sitec, metvar_struct* metv, double snoww);
+double metarr_value(const metarr_struct* metarr, int var, int day);
+double metarr_stream_value(metstream_struct* S, int var, int day);
+int metarr_stream_copy(metarr_struct* metarr);
+void metarr_stream_free(metarr_struct* metarr);
 
 int phenphase(file logfile, const control_struct* ctrl, const epconst_struct* epc, const soilprop_struct* sprop, const planting_struct* PLT, 
 	          phenology_struct *phen, metvar_struct *metv, epvar_struct* epv, cstate_struct* cs);
@@ -99,7 +105,7 @@ int decomp(const metvar_struct* metv, const epconst_struct* epc, const soilprop_
 	       epvar_struct* epv, cflux_struct* cf, nflux_struct* nf, ntemp_struct* nt);
 	int CH4flux_estimation(const soilprop_struct* sprop, int layer, double VWC, double T, double* CH4flux);
 
-int daily_allocation(const epconst_struct* epc, const soilprop_struct* sprop, const metvar_struct* metv, const NdepControl_struct* ndep,
+int daily_allocation(const epconst_struct* epc, const siteconst_struct* sitec, const soilprop_struct* sprop, const metvar_struct* metv, const NdepControl_struct* ndep,
 	                 cstate_struct*cs,  nstate_struct* ns, cflux_struct* cf, nflux_struct* nf, epvar_struct* epv, ntemp_struct* nt, double naddfrac);
 
 
@@ -117,13 +123,17 @@ int irrigating(const control_struct* ctrl, const irrigating_struct* IRG, const s
 
 int multilayer_hydrolprocess(control_struct* ctrl, siteconst_struct* sitec, soilprop_struct* sprop, const epconst_struct* epc, epvar_struct* epv, 
 	                         wstate_struct* ws, wflux_struct* wf, groundwater_struct* GWS, GWcalc_struct* gwc, flooding_struct* FLD, int* mondays);
+int multilayer_hydrolprocessR(control_struct* ctrl, siteconst_struct* sitec, soilprop_struct* sprop, const epconst_struct* epc, epvar_struct* epv, 
+	                          wstate_struct* ws, wflux_struct* wf, groundwater_struct* GWS, GWcalc_struct* gwc);
+int multilayer_hydrolprocessT(control_struct* ctrl, siteconst_struct* sitec, soilprop_struct* sprop, const epconst_struct* epc, epvar_struct* epv, 
+	                          wstate_struct* ws, wflux_struct* wf, groundwater_struct* GWS, flooding_struct* FLD, int* mondays);
 	int infiltANDpond(siteconst_struct* sitec, soilprop_struct* sprop, epvar_struct* epv, wstate_struct* ws, wflux_struct* wf);
 	int pondANDrunoffD(control_struct* ctrl, siteconst_struct* sitec, soilprop_struct* sprop, epvar_struct* epv, wstate_struct* ws, wflux_struct* wf);
-	int richards(const epconst_struct* epc, soilprop_struct* sprop, wstate_struct* ws, wflux_struct* wf, GWcalc_struct* gwc);
+	int richards(const siteconst_struct* sitec, const epconst_struct* epc, soilprop_struct* sprop, wstate_struct* ws, wflux_struct* wf, GWcalc_struct* gwc);
 	int tipping(siteconst_struct* sitec, soilprop_struct* sprop, const epconst_struct* epc, epvar_struct* epv, wstate_struct* ws, wflux_struct* wf);
 	int diffusCalc(const soilprop_struct* sprop, double dz0, double VWC0, double rVWC0, double VWC0_sat, double VWC0_fc, double VWC0_wp, 
 		                                         double dz1, double VWC1, double rVWC1, double VWC1_sat, double VWC1_fc, double VWC1_wp, double* soilwDiffus);
-	int soilstress_calculation(soilprop_struct* sprop, const epconst_struct* epc, 
+	int soilstress_calculation(const siteconst_struct* sitec, soilprop_struct* sprop, const epconst_struct* epc, 
 		                       epvar_struct* epv, wstate_struct* ws, wflux_struct* wf);
 	int flooding(control_struct* ctrl, const siteconst_struct* sitec, const flooding_struct* FLD, soilprop_struct* sprop, epvar_struct* epv, 
 		         wstate_struct* ws, wflux_struct* wf, int* mondays);
@@ -138,7 +148,7 @@ int multilayer_hydrolprocess(control_struct* ctrl, siteconst_struct* sitec, soil
 	                   epvar_struct* epv, wstate_struct* ws, wflux_struct* wf);
 		int EVPphase1TOphase2(const soilprop_struct* sprop, epvar_struct* epv, wstate_struct* ws, wflux_struct* wf);
 
-int water_state_update(const wflux_struct* wf, wstate_struct* ws);
+int water_state_update(const siteconst_struct* sitec, const wflux_struct* wf, wstate_struct* ws);
 
 int CN_state_update(const siteconst_struct* sitec, const epconst_struct* epc, control_struct* ctrl, epvar_struct* epv, 
 	                      cflux_struct* cf, nflux_struct* nf, cstate_struct* cs, nstate_struct* ns, int alloc, int evergreen);
@@ -154,12 +164,25 @@ int mortality(const control_struct* ctrl, const siteconst_struct* sitec, const e
 
 int multilayer_sminn(const control_struct* ctrl, const metvar_struct* metv,  const soilprop_struct* sprop, const siteconst_struct* sitec, const cflux_struct* cf, const NdepControl_struct *ndep,
 	                 epvar_struct* epv, nstate_struct* ns, nflux_struct* nf);
-	int nitrification(int layer, const soilprop_struct* sprop, double net_miner, double tsoil, double pH, double WFPS, double sminNH4avail, 
+	int nitrification(int layer, const soilprop_struct* sprop, double net_miner, double WFPS, double sminNH4avail, 
 	                  epvar_struct* epv, double* N2O_flux_NITRIF, double* sminNH4_to_nitrif);
-	int denitrification(double soiltype, double sminNO3avail_ppm, double pH, double WFPS, double SR_total, 
+	int denitrification(double soiltype, double sminNO3avail_ppm, double pH, double WFPS, double SR_total, double FrWFPS, double FrPH,
 		                double* sminNO3_to_denitr, double* ratioN2_N2O);
 
-int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
+/* soil response kernels of a number of soil layers (multilayer_scalars.c); first argument: number of soil layers */
+typedef struct
+{
+	int nlayers;
+	int (*tresponse)(int nlayers, const double* tsoil, double Tmin, double Tp1, double Tp2, double Tp3, double Tp4, double* ts_scalar);
+	int (*zscalar)(int nlayers, const siteconst_struct* sitec, double efolding_depth, double* z_scalar);
+	int (*pHresponse)(int nlayers, const soilprop_struct* sprop, double* ps_nitrif);
+	int (*denitr_ratio)(int nlayers, const double* WFPS, const double* pH, double* FrWFPS, double* FrPH);
+} multilayer_kernels_struct;
+
+const multilayer_kernels_struct* multilayer_kernels(int n_soillayers);
+int multilayer_generic_mode(int flag);
+
+int multilayer_leaching(const siteconst_struct* sitec, const soilprop_struct* sprop, const epvar_struct* epv,
 					    control_struct* ctrl, cstate_struct* cs, cflux_struct* cf, nstate_struct* ns, nflux_struct* nf, wstate_struct* ws, wflux_struct* wf);
 
 int planting(control_struct* ctrl, const siteconst_struct* sitec, const planting_struct* PLT, epconst_struct* epc, 
@@ -192,7 +215,7 @@ int cutdown2litter(const siteconst_struct *sitec, const epconst_struct* epc, con
 
 int precision_control(wstate_struct* ws, cstate_struct* cs, nstate_struct* ns);
 
-int check_water_balance(wstate_struct* ws, int first_balance);
+int check_water_balance(const siteconst_struct* sitec, wstate_struct* ws, int first_balance);
 int check_carbon_balance(cstate_struct* cs, int first_balance);
 int check_nitrogen_balance(nstate_struct* ns, int first_balance);
 
@@ -200,4 +223,9 @@ int cnw_summary(const epconst_struct* epc, const siteconst_struct* sitec, const
 	            const cstate_struct* cs, const cflux_struct* cf, const nstate_struct* ns, const nflux_struct* nf, const wflux_struct* wf, 
 				epvar_struct* epv, summary_struct* summary);
 
-int restart_output(const wstate_struct* ws, const cstate_struct* cs, const nstate_struct* ns, const epvar_struct* epv, restart_data_struct* restart);
\ No newline at end of file
+int restart_output(const wstate_struct* ws, const cstate_struct* cs, const nstate_struct* ns, const epvar_struct* epv, restart_data_struct* restart);
+
+int conv_monitor_init(const control_struct* ctrl, convmonitor_struct* conv);
+int conv_monitor_update(const control_struct* ctrl, const cstate_struct* cs, const nstate_struct* ns, int Nadd, 
+	                    double spinup_tolerance, int minwindows, convmonitor_struct* conv);
+int conv_monitor_report(file logfile, const convmonitor_struct* conv);
@@ -14,6 +14,17 @@ See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentatio
 */
 
 
+/* run of the sensitivity analysis (sensitivity.c) or of a site of the regional run (regional.c): output variables accumulated in the run,
+   spun-up state exchanged in memory */
+typedef struct
+{
+	int nout;							/* (n) number of output variables */
+	const int* outcode;					/* (n) output codes of the variables */
+	const int* outmode;					/* (n) 0=sum of the daily values, 1=sum of the values at the end of the years, 2=value at the end of the simulation */
+	double objective[N_SENSOUT];		/* (unit of the output) accumulated values of the actual run */
+	restart_data_struct* snapshot;		/* spinup run: end state of the run; normal run: initial state (NULL: restart file of the init file) */
+} senssample_struct;
+
 /* structure for passing input parameters to bgc() */
 typedef struct
 {
@@ -41,6 +52,13 @@ typedef struct
 	mulching_struct MUL;			/* parameters for mulching */
 	CWDextract_struct CWE;			/* parameters for CWD extract */
 	flooding_struct FLD;            /* parameters for flooding */
+	spinupopt_struct SPO;           /* optional spinup settings */
+	obscomp_struct OBS;             /* optional comparison with observations */
+	resim_struct RSM;               /* incremental re-simulation */
+	optim_struct OPT;               /* management strategy optimizer */
+	aggreg_struct AGG;              /* user-defined temporal aggregation of the outputs */
+	parareal_struct PAR;            /* parallel-in-time execution of the normal run */
+	senssample_struct* SEN;         /* run of the sensitivity analysis (NULL: ordinary run) */
 
 } bgcin_struct;
 
@@ -60,11 +78,260 @@ typedef struct
 	int spinup_years;       /* number of years before reaching steady-state */
 	file log_file;
 	file econout_file;
+	file aggout;            /* file containing the user-defined temporal aggregations */
 } bgcout_struct;
 
+/* scenario fork control: shared prefix run until the branch year, then the scenario runs from the state of the prefix */
+typedef struct
+{
+	int branch_year;					/* (year) first simulation year of the scenarios */
+	int nthreads;						/* (n) number of parallel scenario runs (0: all available processors) */
+	int nscen;							/* (n) number of scenarios */
+	char** scen_ini;					/* (filename) main init files of the scenarios */
+	int* scen_error;					/* error codes of the scenario runs */
+	int simstartyear;					/* (year) first simulation year of the prefix run (and of the scenario init files) */
+	epconst_struct epc;					/* initial EPC of the prefix run (without the arrays) */
+	resimstate_struct* state;			/* complete state of the prefix run at the end of the year before the branch year */
+} fork_struct;
+
+/* methods of the global sensitivity analysis */
+#define SENS_MORRIS 0
+#define SENS_SOBOL  1
+
+/* parameter of the sensitivity analysis: value in a line of the EPC file or of the soil file */
+typedef struct
+{
+	char name[STRINGSIZE];				/* name of the parameter in the report */
+	int file;							/* (n) file of the value: 0=EPC file, 1=soil file */
+	int line;							/* (n) line of the value in the file (from 1) */
+	int column;							/* (n) column of the value in the line (from 1, e.g. soil layer) */
+	double min;							/* (unit of the parameter) lower bound of the range */
+	double max;							/* (unit of the parameter) upper bound of the range */
+	int spinup;							/* (flag) 1=the parameter influences the spinup run, 0=only the normal run */
+} senspar_struct;
+
+/* global sensitivity analysis: sample design of the parameters, evaluated by in-process runs of the init files */
+typedef struct
+{
+	int method;							/* (n) SENS_MORRIS: elementary effects, SENS_SOBOL: first and total-order indices */
+	int nsample;						/* (n) number of trajectories (Morris) or base samples (Sobol) */
+	int nlevel;							/* (n) number of levels of the Morris grid (even) */
+	int seed;							/* (n) seed of the random sample design */
+	int nthreads;						/* (n) number of parallel runs (0: all available processors) */
+	char spinup_ini[FILENAMESIZE];		/* (filename) main init file of the spinup run (empty: restart file of the normal run) */
+	char normal_ini[FILENAMESIZE];		/* (filename) main init file of the normal run */
+	char epc_file[FILENAMESIZE];		/* (filename) EPC file as it is given in the init files */
+	char soil_file[FILENAMESIZE];		/* (filename) soil file as it is given in the init files */
+	char report_file[FILENAMESIZE];		/* (filename) file of the index tables */
+	int npar;							/* (n) number of parameters */
+	senspar_struct par[N_SENSPAR];		/* parameters */
+	int nout;							/* (n) number of output variables */
+	int outcode[N_SENSOUT];				/* (n) output codes of the variables */
+	int outmode[N_SENSOUT];				/* (n) 0=sum of the daily values, 1=sum of the values at the end of the years, 2=value at the end of the simulation */
+	int nrun;							/* (n) number of runs of the design */
+	double* design;						/* (prop) parameter values of the runs scaled to the ranges (nrun x npar) */
+	int ngroup;							/* (n) number of different spun-up states */
+	int* group;							/* (n) spun-up state of the runs */
+	restart_data_struct* snapshot;		/* spun-up states of the groups */
+	double* result;						/* (unit of the output) output variables of the runs (nrun x nout) */
+	char* text[2];						/* contents of the EPC file and of the soil file */
+	size_t size[2];						/* (byte) size of the contents */
+} sensitivity_struct;
+
+/* job of the simulation server: main init file with string substitutions, latency metrics */
+typedef struct
+{
+	char id[STRINGSIZE];						/* identifier of the job given by the client */
+	char ini[FILENAMESIZE];						/* (filename) main init file */
+	int nsubst;									/* (n) number of string substitutions */
+	char subst_from[N_SRVSUBST][FILENAMESIZE];	/* string values of the input files to be replaced (e.g. EPC file name, output prefix) */
+	char subst_to[N_SRVSUBST][FILENAMESIZE];	/* replacing string values */
+	char outprefix[FILENAMESIZE];				/* output prefix of the job */
+	int metcache_hit;							/* (flag) 1=met arrays from the cache, 0=met file read */
+	int errorCode;								/* error code of the run */
+	double t_accept;							/* (s) time of acceptance */
+	double t_start;								/* (s) start of the run */
+	double t_end;								/* (s) end of the run */
+} srvjob_struct;
+
+/* site of the regional run: spinup and normal run with string substitutions of the input files */
+typedef struct
+{
+	char id[STRINGSIZE];						/* identifier of the site in the regional file */
+	char spinup_ini[FILENAMESIZE];				/* (filename) main init file of the spinup run (empty: restart file of the normal run) */
+	char normal_ini[FILENAMESIZE];				/* (filename) main init file of the normal run */
+	int nsubst;									/* (n) number of string substitutions */
+	char subst_from[N_SRVSUBST][FILENAMESIZE];	/* string values of the input files to be replaced (e.g. met file name, soil file name) */
+	char subst_to[N_SRVSUBST][FILENAMESIZE];	/* replacing string values */
+} regsite_struct;
+
+/* regional run: sites of the manifest distributed over the MPI processes (or threads), summary outputs of the sites */
+typedef struct
+{
+	int nthreads;						/* (n) number of parallel runs without MPI (0: all available processors) */
+	char report_file[FILENAMESIZE];		/* (filename) regional file of the summary outputs */
+	int nout;							/* (n) number of summary output variables */
+	int outcode[N_SENSOUT];				/* (n) output codes of the variables */
+	int outmode[N_SENSOUT];				/* (n) 0=sum of the daily values, 1=sum of the values at the end of the years, 2=value at the end of the simulation */
+	int nsite;							/* (n) number of sites */
+	char** site;						/* SITE lines of the manifest (parsed again by the run of the site) */
+	double* result;						/* error code, run time (s) and summary outputs of the sites (nsite x (nout+2)) */
+} regional_struct;
+
+/* kinds of the entries of the server cache */
+#define SRVCACHE_MET 1
+#define SRVCACHE_SPINUP 2
+
+/* entry of the in-memory LRU cache of the simulation server */
+typedef struct
+{
+	int kind;									/* (n) 0=empty, SRVCACHE_MET: met arrays, SRVCACHE_SPINUP: end-of-spinup state */
+	unsigned long long key;						/* (hash) key of the inputs */
+	unsigned long long check;					/* (hash) independent check hash of the inputs */
+	size_t size;								/* (byte) size of the data */
+	void* data;									/* cached data */
+	long last_used;								/* (n) counter of the last use (LRU order) */
+} srvcache_struct;
+
+/* modes of the stored simulation states (statepack.c) */
+#define STATEPACK_FULL 0
+#define STATEPACK_NOFLUX 1
+#define STATEPACK_COMPACT 2
+
+/* run phases of the daily step engine */
+#define DAYSTEP_NORMAL    0
+#define DAYSTEP_SPINUP    1
+#define DAYSTEP_TRANSIENT 2
+
+/* configuration of the daily step: the specialized steps are compiled for combinations of these bits */
+#define DAYSTEP_RICHARDS  1			/* Richards-method soil hydrology (otherwise tipping) */
+#define DAYSTEP_MGM       2			/* management (otherwise no management fluxes and irrigating) */
+#define DAYSTEP_FLOWHS    4			/* heat stress during flowering */
+#define DAYSTEP_GENERIC   8			/* configuration tested at runtime (rare combinations) */
+
+/* state of the daily step engine (daystep.c): pointers to the local structures of the calling run (bgc(), spinup_bgc(), 
+   transient_bgc()) and the day-invariant inputs of the actual year */
+typedef struct daystep
+{
+	int (*step)(struct daystep* D, int simyr, int yday);	/* daily step selected for the run phase and configuration */
+	int config;												/* configuration bits of the run */
+	control_struct* ctrl;
+	metarr_struct* metarr;
+	metvar_struct* metv;
+	NdepControl_struct* ndep;
+	wstate_struct* ws;
+	wflux_struct* wf;
+	cstate_struct* cs;
+	cflux_struct* cf;
+	nstate_struct* ns;
+	nflux_struct* nf;
+	epconst_struct* epc;
+	epvar_struct* epv;
+	siteconst_struct* sitec;
+	soilprop_struct* sprop;
+	GWcalc_struct* gwc;
+	phenarray_struct* phenarr;
+	phenology_struct* phen;
+	psn_struct* psn_sun;
+	psn_struct* psn_shade;
+	ntemp_struct* nt;
+	summary_struct* summary;
+	planting_struct* PLT;
+	thinning_struct* THN;
+	mowing_struct* MOW;
+	grazing_struct* GRZ;
+	harvesting_struct* HRV;
+	ploughing_struct* PLG;
+	fertilizing_struct* FRZ;
+	irrigating_struct* IRG;
+	mulching_struct* MUL;
+	CWDextract_struct* CWE;
+	flooding_struct* FLD;
+	groundwater_struct* GWS;
+	double** output_map;				/* output mapping and local output arrays */
+	double* dayarr;
+	double* monavgarr;
+	double* annavgarr;
+	double* annarr;
+	int* mondays;
+	int* enddays;
+	bgcin_struct* bgcin;				/* observations, aggregations and optimizer objectives (normal run) */
+	bgcout_struct* bgcout;				/* output and log files */
+	int* first_balance;					/* (flag) first day of the simulation: mass balance check without comparison */
+	double dailyNdep;					/* (kgN/m2/day) nitrogen deposition of the actual year */
+	double naddfrac;					/* (prop) scaling of the supplemental N addition (spinup, 0: no addition) */
+} daystep_struct;
+
 /* function prototypes for calling bgc */
 int bgc(bgcin_struct* bgcin, bgcout_struct* bgcout);
 int spinup_bgc(bgcin_struct* bgcin, bgcout_struct* bgcout);
 /* transient run  */
 int transient_bgc(bgcin_struct* bgcin, bgcout_struct* bgcout);
+/* spinup cache and warm start */
+int spinup_cache_resume(bgcin_struct* bgcin, bgcout_struct* bgcout);
+int spinup_cache_store(const bgcin_struct* bgcin, const bgcout_struct* bgcout, const wstate_struct* ws, const cstate_struct* cs, 
+	                   const nstate_struct* ns, const epvar_struct* epv);
+int spinup_cache_warmstart(bgcin_struct* bgcin);
+void hash_bytes(unsigned long long* key, unsigned long long* check, const void* data, size_t nbytes);
+void hash_array(unsigned long long* key, unsigned long long* check, const void* data, int n, size_t size);
+/* scenario fork mode */
+int pointbgc_run(const char* ininame, const char* systime, fork_struct* fork, int scenario, srvjob_struct* job);
+int fork_init(const char* forkname, fork_struct* fork);
+int fork_prepare(fork_struct* fork, int scenario, control_struct* ctrl, const epconst_struct* epc, resim_struct* RSM);
+/* incremental re-simulation */
+int resim_prepare(bgcin_struct* bgcin, bgcout_struct* bgcout, const phenarray_struct* phenarr);
+int resim_snapshot(resim_struct* RSM, bgcout_struct* bgcout, int tofile, obscomp_struct* OBS, aggreg_struct* AGG, int first_balance, control_struct* ctrl, 
+	               metvar_struct* metv, wstate_struct* ws, wflux_struct* wf, cinit_struct* cinit, cstate_struct* cs, cflux_struct* cf, 
+				   nstate_struct* ns, nflux_struct* nf, epvar_struct* epv, siteconst_struct* sitec, soilprop_struct* sprop, GWcalc_struct* gwc, 
+				   epconst_struct* epc, phenology_struct* phen, psn_struct* psn_sun, psn_struct* psn_shade, ntemp_struct* nt, summary_struct* summary,
+				   planting_struct* PLT, thinning_struct* THN, mowing_struct* MOW, grazing_struct* GRZ, harvesting_struct* HRV, ploughing_struct* PLG, 
+				   fertilizing_struct* FRZ, irrigating_struct* IRG, mulching_struct* MUL, CWDextract_struct* CWE, flooding_struct* FLD, groundwater_struct* GWS);
+void resim_mgmdyear(int* mgmd, int year, const planting_struct* PLT, const thinning_struct* THN, const mowing_struct* MOW, 
+	                const harvesting_struct* HRV, const ploughing_struct* PLG, const fertilizing_struct* FRZ, const irrigating_struct* IRG, 
+					const mulching_struct* MUL, const CWDextract_struct* CWE, const groundwater_struct* GWS);
+int resim_restore(resim_struct* RSM, obscomp_struct* OBS, aggreg_struct* AGG, int* first_balance, control_struct* ctrl, 
+	              metvar_struct* metv, wstate_struct* ws, wflux_struct* wf, cinit_struct* cinit, cstate_struct* cs, cflux_struct* cf, 
+				  nstate_struct* ns, nflux_struct* nf, epvar_struct* epv, siteconst_struct* sitec, soilprop_struct* sprop, GWcalc_struct* gwc, 
+				  epconst_struct* epc, phenology_struct* phen, psn_struct* psn_sun, psn_struct* psn_shade, ntemp_struct* nt, summary_struct* summary,
+				  planting_struct* PLT, thinning_struct* THN, mowing_struct* MOW, grazing_struct* GRZ, harvesting_struct* HRV, ploughing_struct* PLG, 
+				  fertilizing_struct* FRZ, irrigating_struct* IRG, mulching_struct* MUL, CWDextract_struct* CWE, flooding_struct* FLD, groundwater_struct* GWS);
+/* daily step of the simulation (specialized by run phase) */
+void daystep_init(daystep_struct* D, bgcin_struct* bgcin, bgcout_struct* bgcout, int* first_balance, control_struct* ctrl, metarr_struct* metarr, 
+	              metvar_struct* metv, NdepControl_struct* ndep, wstate_struct* ws, wflux_struct* wf, cstate_struct* cs, cflux_struct* cf, 
+				  nstate_struct* ns, nflux_struct* nf, epconst_struct* epc, epvar_struct* epv, siteconst_struct* sitec, soilprop_struct* sprop, 
+				  GWcalc_struct* gwc, phenarray_struct* phenarr, phenology_struct* phen, psn_struct* psn_sun, psn_struct* psn_shade, ntemp_struct* nt, 
+				  summary_struct* summary, planting_struct* PLT, thinning_struct* THN, mowing_struct* MOW, grazing_struct* GRZ, harvesting_struct* HRV, 
+				  ploughing_struct* PLG, fertilizing_struct* FRZ, irrigating_struct* IRG, mulching_struct* MUL, CWDextract_struct* CWE, 
+				  flooding_struct* FLD, groundwater_struct* GWS, double** output_map, double* dayarr, double* monavgarr, double* annavgarr, 
+				  double* annarr, int* mondays, int* enddays);
+int daystep_select(daystep_struct* D, int phase);
+int daystep_generic_mode(int flag);
+/* compact format of the stored simulation states */
+size_t state_packbound(void);
+int state_pack(const resimstate_struct* state, int mode, unsigned char* buffer, size_t* nbytes);
+int state_unpack(const unsigned char* buffer, size_t nbytes, resimstate_struct* state);
+int state_packreport(const resimstate_struct* state, file logfile);
+/* management strategy optimizer */
+int optim_run(bgcin_struct* bgcin, bgcout_struct* bgcout);
+int optim_update(optim_struct* OPT, const control_struct* ctrl, double** output_map);
+int optim_report(const optim_struct* OPT);
+/* parallel-in-time execution of the normal run */
+int parareal_run(bgcin_struct* bgcin, bgcout_struct* bgcout);
+int parareal_report(const parareal_struct* PAR);
+/* global sensitivity analysis */
+int sensitivity_init(const char* sensname, sensitivity_struct* SEN);
+int sensitivity_run(const char* sensname, const char* systime);
+senssample_struct* sensitivity_sample(void);
+int sensitivity_update(senssample_struct* sample, const control_struct* ctrl, double** output_map);
+int sensitivity_select(senssample_struct* sample);
+/* regional run */
+int regional_init(const char* manifest, regional_struct* REG);
+int regional_parse(const char* line, regsite_struct* site);
+int regional_run(const char* manifest, const char* systime);
+/* simulation server */
+int server_run(const char* systime, int nthreads, int ncache);
+int server_cache_find(int kind, unsigned long long key, unsigned long long check, void* data, size_t size);
+int server_cache_insert(int kind, unsigned long long key, unsigned long long check, const void* data, size_t size);
+int server_metarr_init(point_struct* point, metarr_struct* metarr, const climchange_struct* scc, const siteconst_struct* sitec, 
+	                   const control_struct* ctrl, srvjob_struct* job);
 
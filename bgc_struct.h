@@ -14,9 +14,28 @@ See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentatio
 
 #define N_POOLS 3			    /*  number of type of pools: water, carbon, nitrogen */
 #define N_MGMDAYS 7		        /*  number of type of management events in a single year */
-#define N_SOILLAYERS 10		    /*  number of type of soil layers in multilayer soil module */
-#define N_SOILLAYERS_GWC 12		/*  number of type of soil layers in multilayer soil module (in case of GW-calculation) */
+#ifndef N_SOILLAYERS
+#define N_SOILLAYERS 10		    /*  maximal number of soil layers in multilayer soil module (can be set at compile time, e.g. -DN_SOILLAYERS=20) */
+#endif
+#if N_SOILLAYERS < 4
+#error "N_SOILLAYERS must be at least 4 (the top 30 cm is always divided into 3 layers)"
+#endif
+/* N_SOILLAYERS sizes the layer arrays (state structures, restart and output layouts); the number of layers of a run
+   (sitec.n_soillayers) is the number of values in the lines of the soil composition block of the soil file (at most
+   N_SOILLAYERS); the output codes of the layer variables cover the first 10 layers only (output_map_init.c) */
+#define N_SOILLAYERS_GWC (N_SOILLAYERS+2)	/*  number of type of soil layers in multilayer soil module (in case of GW-calculation: the two deepest layers are halved) */
 #define N_PHENPHASES 7		    /*  number of phenological phases */
+#define N_OBSSERIES 20		    /*  maximal number of observation series compared with the model outputs */
+#define N_AGGSPEC 50		    /*  maximal number of user-defined temporal aggregations of the outputs */
+#define N_RESIMOUT 6		    /*  number of output files continued by the incremental re-simulation */
+#define N_RESIMMGM 12		    /*  number of management (and groundwater) arrays with position counters */
+#define N_OPTOBJ 10		    /*  maximal number of objective terms of the management optimizer */
+#define N_OPTDEC 50		    /*  maximal number of management decisions of the optimizer */
+#define N_OPTCAND 20		    /*  maximal number of candidate values of a management decision */
+#define N_PARSLICE 64		    /*  maximal number of time slices of the parallel-in-time execution */
+#define N_SRVSUBST 20		    /*  maximal number of string substitutions (input file names, output prefix) of a server job */
+#define N_SENSPAR 100		    /*  maximal number of parameters of the sensitivity analysis */
+#define N_SENSOUT 10		    /*  maximal number of output variables of the sensitivity analysis */
 #define nDAYS_OF_YEAR 365       /* number of days in a year */
 
 /* VAR ctrl: simulation control variables */
@@ -149,6 +168,46 @@ typedef struct
 	double heatsum;
 } phenology_struct;
 /* endOUT  */
+/* daily variables of the met arrays which are calculated on demand in the compact met store (metarr_value()), tempradF
+   is always stored; the raw drivers are read by metarr_value() in the streamed met input */
+#define METARR_TAVG       0
+#define METARR_TAVGRA11   1
+#define METARR_TAVGRA10   2
+#define METARR_TAVGRA30   3
+#define METARR_TEMPRADFRA 4
+#define METARR_PAR        5
+#define METARR_DAYL       6
+#define METARR_TEMPRADF   7
+#define METARR_TMAX       8
+#define METARR_TMIN       9
+#define METARR_TDAY       10
+#define METARR_PRCP       11
+#define METARR_VPD        12
+#define METARR_SWAVGFD    13
+#define METARR_NVAR       14
+
+/* streamed met input (metarr_stream_mode()): the daily variables are read in a window of the simulation years from the
+   met file when a day outside of the window is needed (metarr_value()) */
+typedef struct metstream
+{
+	file metf;                     /* met file (opened for the loads of the window) */
+	long* offset;                  /* position of the first record of the simulation years in the met file */
+	double* tempradF_last;         /* tempradF of the last day of the simulation years (recursion between the windows) */
+	double* gap;                   /* days after the last record in the met file (averages of the previous years) */
+	double scale[5];               /* climate change scenario: Tmax, Tmin, prcp, vpd, swavgfd */
+	double albedo_sw;              /* albedo of the site (recursion of tempradF) */
+	int nyears;                    /* number of simulation years */
+	int nwindow;                   /* number of years in the window (with the preceding year: nwindow+1) */
+	int firstgap;                  /* first day after the last record in the met file */
+	int first;                     /* first day of the window */
+	int last;                      /* the day after the window */
+	int nload;                     /* number of loads of the window */
+	int errorCode;                 /* error of a load of the window */
+	double* array[METARR_NVAR];    /* window arrays of the variables (NULL: calculated by metarr_value()) */
+	struct metstream* parent;      /* the stream of the window copy of a run (metarr_stream_copy()) */
+	void* prefetch;                /* prefetch of the next window (metarr_init.c, NULL: none) */
+} metstream_struct;
+
 /* VAR metarr: meteorological variable arrays */
 /* inputs from mtclim, except Tavg11, Tavg30, TavgRA30 and TavgRA11
 which are used for an 11-day running average of daily average air T,
@@ -175,7 +234,11 @@ typedef struct
 	double* annTrange_array;     /* (Celsius) annual average temperature range (difference between Tavg of the coldest and warmest month) */
 	double* annTavgRA_array;     /* (Celsius) annual average temperature */
 	double* annTrangeRA_array;   /* (Celsius) annual average temperature range (difference between Tavg of the coldest and warmest month) */
+	float* dayl_float;           /* (s)     daylength in single precision (compact met store, if it is exact) */
+	int compact;                 /* (flag)  compact met store: the derived daily arrays are not stored (metarr_value()) */
+	metstream_struct* stream;    /* streamed met input: the daily arrays are not stored (NULL: not streamed) */
 } metarr_struct;
+
 /* endVAR */
 
 /* OUT metv: daily values that are passed to daily model subroutines */
@@ -265,6 +328,7 @@ typedef struct
 	double GW_waterlogging;          /* amount of water above the surface (negative GWD data) */
 	double cumGWchange;              /* cumulative water change in soil column due to groundwater */
     double WbalanceERR;              /* SUM of water balance error  */
+    double Wbalance_old;             /* water balance of the previous day */
 	double inW;						 /* SUM of nitrogen input */
 	double outW;					 /* SUM of nitrogen output */
 	double storeW;					 /* SUM of nitrogen store */
@@ -456,6 +520,7 @@ typedef struct
 	double frootC_HRV;                  /* SUM of carbon content of fine root at harvest */
 	double vegC_HRV;                    /* SUM of carbon content of havested leaf, stem and yield */
 	double CbalanceERR;					/* SUM of carbon balance error */
+	double Cbalance_old;				/* carbon balance of the previous day */
 	double CNratioERR;                  /* SUM of carbon-nitrogen ratio error */
 	double inC;							/* SUM of carbon input */
 	double outC;						/* SUM of carbon output */
@@ -990,6 +1055,7 @@ typedef struct
 	double GRZsrc_N;					/* SUM of leaf N from fertilizer*/
 	double SPINUPsrc;					/* SUM of leaf N from spinup correction*/
     double NbalanceERR;                 /* SUM of nitrogen balance error */
+    double Nbalance_old;                /* nitrogen balance of the previous day */
 	double inN;							/* SUM of nitrogen input */
 	double outN;						/* SUM of nitrogen output */
 	double storeN;						/* SUM of nitrogen store */
@@ -1648,6 +1714,7 @@ typedef struct
 	double soillayer_depth[N_SOILLAYERS];			    /* (m) contains the soil layer depths (positive values)*/
 	double soillayer_thickness[N_SOILLAYERS];		    /* (m) contains the soil layer thicknesses (positive values) */
 	double soillayer_midpoint[N_SOILLAYERS];			/* (m) contains the depths of the middle layers (positive values)*/
+	int n_soillayers;									/* (n) number of soil layers of the run (from the soil file, at most N_SOILLAYERS) */
 } siteconst_struct;								
 /* endVAR */
 
@@ -2162,6 +2229,103 @@ typedef struct
 } flooding_struct;
 /* endVAR */
 
+/* spinup convergence monitor: tracked pool groups (litter C, CWD C, SOM C, soil N) in each soil layer */
+#define N_CONVPOOLS 4
+
+typedef struct
+{
+	int ncycle;												/* (n) number of years of the met cycle (length of the windows) */
+	int nyears;												/* (n) number of consecutive years without N-addition */
+	double* history;										/* (kg/m2) end-of-year pools of the last three met cycles (ring buffer) */
+	double mean[3][N_CONVPOOLS][N_SOILLAYERS];				/* (kg/m2) means of the last three met-cycle windows (2: latest) */
+	double trend[N_CONVPOOLS][N_SOILLAYERS];				/* (kg/m2/yr) projected trend of the pools */
+	double residual[N_CONVPOOLS][N_SOILLAYERS];				/* (kg/m2) estimated distance from equilibrium (exponential approach) */
+	double tolerance;										/* (1/yr) relative tolerance of the pool trends */
+	double trend_totalC;									/* (kgC/m2/yr) projected trend of the sum of the carbon pools */
+	int limit_pool;											/* (n) pool group with the highest trend/tolerance ratio */
+	int limit_layer;										/* (n) soil layer with the highest trend/tolerance ratio */
+	double limit_ratio;										/* (dimless) highest trend/tolerance ratio */
+	int converged;											/* (flag) 1=all projected pool trends are below tolerance */
+} convmonitor_struct;
+
+/* VAR SPO: optional spinup settings (spinup_options.txt) */
+typedef struct
+{
+	int cache_flag;								/* (flag) 1=use spinup cache, 0=no spinup cache */
+	int cache_strict;							/* (flag) 1=stop on stale cache entries, 0=recompute them */
+	int cache_hit;								/* (flag) 1=end-of-spinup state is restored from the cache */
+	char cache_dir[FILENAMESIZE];				/* (dir) directory of the cache entries */
+	char cache_file[FILENAMESIZE];				/* (filename) cache entry belonging to the actual spinup inputs */
+	unsigned long long cache_key;				/* (hash) key of the spinup inputs (name of the cache entry) */
+	unsigned long long cache_check;				/* (hash) independent check hash of the spinup inputs */
+	int warm_flag;								/* (flag) 1=warm start from the nearest stored equilibrium state, 0=no warm start */
+	char library_dir[FILENAMESIZE];				/* (dir) directory of the state library used for warm start */
+	double warm_weight[3];						/* (dimless) weights of soil, climate and EPC features in the distance */
+	double warm_maxdist;						/* (dimless) maximal distance of the neighbour (DATA_GAP: no limit) */
+	int warm_years;								/* (n) spinup years of the neighbour used for warm start (-1: no warm start) */
+	double warm_dist;							/* (dimless) distance of the neighbour used for warm start */
+	char warm_file[FILENAMESIZE];				/* (filename) cache entry used for warm start */
+	int conv_flag;								/* (flag) 1=early end of spinup based on the convergence monitor, 0=original test only */
+	int conv_minwindows;						/* (n) minimum number of met cycles without N-addition before early end of spinup */
+} spinupopt_struct;
+/* endVAR */
+
+/* observation series compared with a model output variable */
+typedef struct
+{
+	int outcode;								/* (n) output code of the compared model variable */
+	int timestep;								/* (flag) 0=daily values, 1=monthly averages */
+	double sigma;								/* (unit of variable) standard deviation of observation error (DATA_GAP: estimated from the residuals) */
+	char obs_file[FILENAMESIZE];				/* (filename) file of the observations */
+	int nobs;									/* (n) number of observations in the simulation period */
+	int* date_array;							/* (yyyymmdd or yyyymm) dates of the observations in ascending order */
+	double* value_array;						/* (unit of variable) observed values */
+	int mgmdOBS;								/* (n) index of the next observation */
+	double monsum;								/* (unit of variable) sum of the simulated daily values in the actual month */
+	int n;										/* (n) number of compared value pairs */
+	double sum_res;								/* (unit of variable) sum of residuals (simulated - observed) */
+	double sum_res2;							/* (unit of variable) sum of squared residuals */
+	double sum_sim;								/* (unit of variable) sum of simulated values */
+	double mean_obs;							/* (unit of variable) running mean of the observed values */
+	double M2_obs;								/* (unit of variable) running sum of squared deviations of the observed values from their mean */
+} obsseries_struct;
+
+/* VAR OBS: optional comparison with observations (observations.txt) */
+typedef struct
+{
+	int nseries;								/* (n) number of observation series */
+	obsseries_struct series[N_OBSSERIES];		/* observation series */
+	char summary_file[FILENAMESIZE];			/* (filename) file of the goodness-of-fit metrics */
+} obscomp_struct;
+/* endVAR */
+
+/* user-defined temporal aggregation of a model output variable */
+typedef struct
+{
+	int outcode;								/* (n) output code of the aggregated model variable */
+	int func;									/* (n) 0=sum, 1=mean, 2=minimum, 3=maximum, 4=number of days above threshold */
+	double threshold;							/* (unit of variable) threshold of the counted days */
+	int window;									/* (n) 0=calendar year, 1=calendar month, 2=period of the year, 3=while condition holds, 4=between events */
+	int start_mmdd;								/* (mmdd) first day of the period of the year */
+	int end_mmdd;								/* (mmdd) last day of the period of the year */
+	int cond_outcode;							/* (n) output code of the condition (window 3) or of the event (window 4) */
+	double cond_min;							/* (unit of variable) lower limit of the condition, threshold of the event */
+	double cond_max;							/* (unit of variable) upper limit of the condition */
+	int open;									/* (flag) 1=the actual window is open */
+	int start_date;								/* (yyyymmdd) first day of the actual window */
+	int end_date;								/* (yyyymmdd) last aggregated day of the actual window */
+	int ndays;									/* (n) number of aggregated days in the actual window */
+	double value;								/* (unit of variable) sum, minimum, maximum or number of days in the actual window */
+} aggspec_struct;
+
+/* VAR AGG: optional user-defined temporal aggregation of the outputs (aggregation.txt) */
+typedef struct
+{
+	int nspec;									/* (n) number of aggregations */
+	aggspec_struct spec[N_AGGSPEC];				/* aggregations */
+} aggreg_struct;
+/* endVAR */
+
 /* OUT psn: structure for the photosynthesis routine */
 typedef struct
 {
@@ -2488,3 +2652,112 @@ typedef struct
 /* endVAR*/
 
 } restart_data_struct;
+
+/* state of the normal run at the end of a simulation year (snapshot of the incremental re-simulation);
+   the pointer members of ctrl and epc are not valid after reading from file, they are restored from the actual run */
+typedef struct
+{
+	int simyr;										/* (n) index of the last simulated year */
+	long outpos[N_RESIMOUT];						/* (byte) end position in the daily, monthly average, annual average, annual, economic and aggregation output files */
+	int mgmd[N_RESIMMGM];							/* (n) position counters of the management and groundwater arrays */
+	double trampleff_act;							/* (dimless) actual trampling effect of grazing */
+	int first_balance;								/* (flag) first day of the balance checks */
+	char planttypeName[STRINGSIZE];					/* name of the actual plant type */
+	control_struct ctrl;
+	metvar_struct metv;
+	wstate_struct ws;
+	wflux_struct wf;
+	cinit_struct cinit;
+	cstate_struct cs;
+	cflux_struct cf;
+	nstate_struct ns;
+	nflux_struct nf;
+	epvar_struct epv;
+	siteconst_struct sitec;
+	soilprop_struct sprop;
+	GWcalc_struct gwc;
+	epconst_struct epc;
+	phenology_struct phen;
+	psn_struct psn_sun;
+	psn_struct psn_shade;
+	ntemp_struct nt;
+	summary_struct summary;
+	obsseries_struct obs[N_OBSSERIES];				/* accumulators of the comparison with observations (arrays are not used) */
+	aggspec_struct agg[N_AGGSPEC];					/* actual windows of the temporal aggregations */
+} resimstate_struct;
+
+/* VAR RSM: incremental re-simulation (resim_options.txt) */
+typedef struct
+{
+	int flag;										/* (flag) 1=snapshots and re-simulation from the first changed input, 0=no */
+	int interval;									/* (n) number of years between snapshots */
+	int start_simyr;								/* (n) first simulated year (>0: continued from a snapshot) */
+	int diff_metday;								/* (n) first metday with changed input (-1: no previous run) */
+	unsigned long long key;							/* (hash) key of the inputs without daily resolution */
+	int nmetdays;									/* (n) number of hashed metdays */
+	unsigned long long* dayhash;					/* (hash) key of the inputs of each metday */
+	unsigned long long* daycheck;					/* (hash) independent check hash of the inputs of each metday */
+	resimstate_struct* state;						/* snapshot buffer */
+	int pack_mode;									/* (n) format of the snapshots: 0=full state, 1=state without daily fluxes, 2=compact (statepack.c) */
+	unsigned char* pack_buffer;						/* buffer of the packed snapshot */
+	int nsnap;										/* (n) number of snapshots written in the actual run */
+	int stop_simyr;									/* (n) last simulated year, its end state is kept in the snapshot buffer (-1: until the end) */
+	resimstate_struct* init_state;					/* buffer of the water, carbon and nitrogen state at the beginning of the first year (0: not kept) */
+	int fork_flag;									/* (flag) 0=no fork, 1=scenario run of the fork mode (new output files), 2=scenario run with its own EPC */
+	file snap_file;									/* file of the snapshots (outprefix.snapshot) */
+} resim_struct;
+/* endVAR */
+
+/* management decision of the optimizer: amount or date of one fertilizing, irrigating or mowing action */
+typedef struct
+{
+	int mgmtype;									/* (n) type of management: 0=fertilizing, 1=irrigating, 2=mowing */
+	int action;										/* (n) index of the action in the management file (from 0) */
+	int param;										/* (n) decision variable: 0=amount (fertilizer, irrigated water, LAI after mowing), 1=date shift */
+	int simyr;										/* (n) simulation year of the action: branching point of the candidates */
+	int base_doy;									/* (n) day of year of the action in the management file */
+	int ncand;										/* (n) number of candidate values */
+	double cand[N_OPTCAND];							/* (unit of the amount or days) candidate values */
+	double objective[N_OPTCAND];					/* (unit of the objective) objective of the candidates (DATA_GAP: not feasible) */
+	int best;										/* (n) index of the selected candidate (-1: not optimized yet) */
+} optdecision_struct;
+
+/* VAR OPT: management strategy optimizer (optimizer.txt) */
+typedef struct
+{
+	int nobj;										/* (n) number of objective terms */
+	int obj_outcode[N_OPTOBJ];						/* (n) output code of the objective terms */
+	int obj_mode[N_OPTOBJ];							/* (n) 0=sum of the daily values, 1=sum of the values at the end of the years, 2=value at the end of the simulation */
+	double obj_weight[N_OPTOBJ];					/* (dimless) weight of the objective terms (negative: minimized) */
+	double objective;								/* (unit of the objective) objective accumulated in the actual run */
+	int ndec;										/* (n) number of decisions */
+	optdecision_struct dec[N_OPTDEC];				/* decisions in chronological order */
+	int nthreads;									/* (n) number of parallel candidate runs (0: all available processors) */
+	char report_file[FILENAMESIZE];					/* (filename) file of the optimization results */
+} optim_struct;
+/* endVAR */
+
+/* VAR PAR: parallel-in-time execution of the normal run (parareal.txt) */
+typedef struct
+{
+	int nslice;										/* (n) number of time slices (0: sequential run) */
+	double tolerance;								/* (dimless) maximal relative difference of the states at the slice boundaries */
+	int maxiter;									/* (n) maximal number of iterations (0: number of slices) */
+	int nthreads;									/* (n) number of parallel slice runs (0: all available processors) */
+	int coarse_SHCM;								/* (flag) soil hydrology of the coarse propagator (SHCM_flag: 0, 2=tipping) */
+	int coarse_years;								/* (n) simulated years of the coarse propagator in a slice (0: whole slice) */
+	char report_file[FILENAMESIZE];					/* (filename) file of the iterations */
+	int done;										/* (flag) 1=the normal run is completed by the parallel-in-time execution */
+	int converged;									/* (flag) 1=the states at the slice boundaries agree within the tolerance */
+	int niter;										/* (n) number of iterations */
+	int nfine[N_PARSLICE];							/* (n) number of fine slice runs in the iterations */
+	double maxdiff[N_PARSLICE];						/* (dimless) maximal relative difference at the slice boundaries in the iterations */
+	double time_fine[N_PARSLICE];					/* (s) wall time of the fine slice runs in the iterations */
+	double time_coarse[N_PARSLICE];					/* (s) wall time of the coarse propagation in the iterations */
+	double time_predict;							/* (s) wall time of the first coarse prediction */
+	int ncoarse;									/* (n) number of coarse slice runs */
+	double time_coarseruns;							/* (s) time of the coarse slice runs */
+	double time_slice[N_PARSLICE];					/* (s) time of the last fine run of the slices */
+	double time_wall;								/* (s) wall time of the parallel-in-time execution */
+} parareal_struct;
+/* endVAR */
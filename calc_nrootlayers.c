@@ -23,6 +23,7 @@ int calc_nrootlayers(int flag, double maxRD, double frootc, siteconst_struct* si
 {
 
 	int errorCode=0;
+	int layer;
 
 
 	if (flag == 0)
@@ -32,69 +33,11 @@ int calc_nrootlayers(int flag, double maxRD, double frootc, siteconst_struct* si
 	
 		if (maxRD > 0)
 		{
-			if (maxRD > sitec->soillayer_depth[0])
+			/* number of layers the top of which is above the maximal rooting depth */
+			epv->n_maxrootlayers = 1;
+			for (layer = 0; layer < sitec->n_soillayers-1; layer++)
 			{
-				if (maxRD > sitec->soillayer_depth[1])
-				{	
-					if (maxRD > sitec->soillayer_depth[2])
-					{
-						if (maxRD > sitec->soillayer_depth[3])
-						{
-							if (maxRD > sitec->soillayer_depth[4])
-							{
-								if (maxRD > sitec->soillayer_depth[5])
-								{
-									if (maxRD > sitec->soillayer_depth[6])
-									{
-										if (maxRD > sitec->soillayer_depth[7])
-										{
-											if (maxRD > sitec->soillayer_depth[8])
-											{
-													epv->n_maxrootlayers = 10;
-											}
-											else 
-											{
-												epv->n_maxrootlayers = 9;
-											}
-										}
-										else 
-										{
-											epv->n_maxrootlayers = 8;
-										}
-									}
-									else 
-									{
-										epv->n_maxrootlayers = 7;
-									}
-								}
-								else 
-								{
-									epv->n_maxrootlayers = 6;
-								}
-							}
-							else 
-							{
-								epv->n_maxrootlayers = 5;
-							}
-						}
-						else
-						{
-							epv->n_maxrootlayers = 4;
-						}
-					}
-					else 
-					{
-						epv->n_maxrootlayers = 3;
-					}	
-				}
-				else 
-				{
-					epv->n_maxrootlayers = 2;
-				}
-			}
-			else
-			{
-				epv->n_maxrootlayers = 1;
+				if (maxRD > sitec->soillayer_depth[layer]) epv->n_maxrootlayers = layer + 2;
 			}
 		}
 		else 
@@ -114,69 +57,11 @@ int calc_nrootlayers(int flag, double maxRD, double frootc, siteconst_struct* si
 	
 		if (epv->rootDepth > 0)
 		{
-			if (epv->rootDepth > sitec->soillayer_depth[0])
-			{
-				if (epv->rootDepth > sitec->soillayer_depth[1])
-				{	
-					if (epv->rootDepth > sitec->soillayer_depth[2])
-					{
-						if (epv->rootDepth > sitec->soillayer_depth[3])
-						{
-							if (epv->rootDepth > sitec->soillayer_depth[4])
-							{
-								if (epv->rootDepth > sitec->soillayer_depth[5])
-								{
-									if (epv->rootDepth > sitec->soillayer_depth[6])
-									{
-										if (epv->rootDepth > sitec->soillayer_depth[7])
-										{
-											if (epv->rootDepth > sitec->soillayer_depth[8])
-											{	
-												epv->n_rootlayers = 10;		
-											}
-											else 
-											{
-												epv->n_rootlayers = 9;
-											}
-										}
-										else 
-										{
-											epv->n_rootlayers = 8;
-										}
-									}
-									else 
-									{
-										epv->n_rootlayers = 7;
-									}
-								}
-								else 
-								{
-									epv->n_rootlayers = 6;
-								}
-							}
-							else 
-							{
-								epv->n_rootlayers = 5;
-							}
-						}
-						else
-						{
-							epv->n_rootlayers = 4;
-						}
-					}
-					else 
-					{
-						epv->n_rootlayers = 3;
-					}	
-				}
-				else 
-				{
-					epv->n_rootlayers = 2;
-				}
-			}
-			else
+			/* number of layers the top of which is above the actual rooting depth */
+			epv->n_rootlayers = 1;
+			for (layer = 0; layer < sitec->n_soillayers-1; layer++)
 			{
-				epv->n_rootlayers = 1;
+				if (epv->rootDepth > sitec->soillayer_depth[layer]) epv->n_rootlayers = layer + 2;
 			}
 		}
 		else 
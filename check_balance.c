@@ -22,11 +22,9 @@ See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentatio
 #include "bgc_func.h"
 #include "bgc_constants.h"
 
-int check_water_balance(wstate_struct* ws, int first_balance)
+int check_water_balance(const siteconst_struct* sitec, wstate_struct* ws, int first_balance)
 {
 	int errorCode=0;
-	static double old_balance;
-	
 	int layer; 
 	double balance, soilw_SUM, soilw_2m;
 	balance=soilw_SUM=soilw_2m=0;
@@ -34,7 +32,7 @@ int check_water_balance(wstate_struct* ws, int first_balance)
 	/* DAILY CHECK ON WATER BALANCE */
 
 	/* control to avoid negative storage */
-	for (layer=0; layer < N_SOILLAYERS; layer++)
+	for (layer=0; layer < sitec->n_soillayers; layer++)
 	{
 		if (ws->soilw[layer] < 0.0)
 		{
@@ -43,7 +41,7 @@ int check_water_balance(wstate_struct* ws, int first_balance)
 			errorCode=1;
 		}
 		soilw_SUM += ws->soilw[layer];
-		if (layer < 7) soilw_2m += ws->soilw[layer];
+		if (sitec->soillayer_depth[layer] < 2.0) soilw_2m += ws->soilw[layer];
 
 	}
 	ws->soilw_SUM = soilw_SUM;
@@ -78,12 +76,12 @@ int check_water_balance(wstate_struct* ws, int first_balance)
 	balance = ws->inW - ws->outW - ws->storeW;
 	 
 	/* calculate actual maximum balance error */
-	if (!first_balance && (fabs(old_balance - balance) > ws->WbalanceERR))
+	if (!first_balance && (fabs(ws->Wbalance_old - balance) > ws->WbalanceERR))
 	{
-		ws->WbalanceERR = fabs(old_balance - balance);
+		ws->WbalanceERR = fabs(ws->Wbalance_old - balance);
 
 	}
-	old_balance = balance;
+	ws->Wbalance_old = balance;
 	
 	return (errorCode);
 }
@@ -92,7 +90,6 @@ int check_carbon_balance(cstate_struct* cs, int first_balance)
 {
 	int errorCode=0;
 	int layer=0;
-	static double old_balance;
 	double balance;
 	
 	/* control avoiding negative pools */
@@ -216,11 +213,11 @@ int check_carbon_balance(cstate_struct* cs, int first_balance)
 	balance = cs->inC - cs->outC - cs->storeC;
 	 
 	/* calculate actual maximum balance error */
-	if (!first_balance && (fabs(old_balance - balance) > cs->CbalanceERR))
+	if (!first_balance && (fabs(cs->Cbalance_old - balance) > cs->CbalanceERR))
 	{
-	 	cs->CbalanceERR = fabs(old_balance - balance);
+	 	cs->CbalanceERR = fabs(cs->Cbalance_old - balance);
 	}
-	old_balance = balance;
+	cs->Cbalance_old = balance;
 
 
 	return (errorCode);
@@ -231,7 +228,6 @@ int check_nitrogen_balance(nstate_struct* ns, int first_balance)
 	int errorCode=0;
 	int layer=0;
 	double balance;
-	static double old_balance = 0.0;
 	
 	/* CONTROL AVOIDING NITROGEN POOLS */
 	if (ns->leafn < 0.0 || ns->leafn < 0.0 ||  ns->leafn_storage < 0.0 || ns->leafn_transfer < 0.0 || 
@@ -354,12 +350,12 @@ int check_nitrogen_balance(nstate_struct* ns, int first_balance)
 	balance = ns->inN - ns->outN - ns->storeN;
 	 
 	/* calculate actual maximum balance error */
-	if (!first_balance && (fabs(old_balance - balance) > ns->NbalanceERR))
+	if (!first_balance && (fabs(ns->Nbalance_old - balance) > ns->NbalanceERR))
 	{
-		ns->NbalanceERR = fabs(old_balance - balance);
+		ns->NbalanceERR = fabs(ns->Nbalance_old - balance);
 
 	}
-	old_balance = balance;
+	ns->Nbalance_old = balance;
 
 	
 	
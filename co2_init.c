@@ -78,8 +78,8 @@ int co2_init(file init, co2control_struct* co2, control_struct *ctrl)
 		/* allocate space for the annual CO2 array */
 		if (!errorCode) 
 		{
-			co2->co2ppm_array = (double*) malloc(ctrl->simyears * sizeof(double));
-			co2->co2yrs_array = (int*) malloc(ctrl->simyears * sizeof(int));
+			co2->co2ppm_array = (double*) arena_malloc(ctrl->simyears * sizeof(double));
+			co2->co2yrs_array = (int*) arena_malloc(ctrl->simyears * sizeof(int));
 			if (!co2->co2ppm_array)
 			{
 				printf("ERROR allocating for annual CO2 array, co2_init()\n");
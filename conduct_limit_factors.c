@@ -21,7 +21,7 @@ See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentatio
 #include "bgc_constants.h"
 
 
-int conduct_limit_factors(file logfile, const control_struct* ctrl, const soilprop_struct* sprop, const epconst_struct* epc, 
+int conduct_limit_factors(file logfile, const control_struct* ctrl, const siteconst_struct* sitec, const soilprop_struct* sprop, const epconst_struct* epc, 
 						  epvar_struct* epv)
 {
 	int errorCode=0;
@@ -35,7 +35,7 @@ int conduct_limit_factors(file logfile, const control_struct* ctrl, const soilpr
 	
 
 	/* calculations layer by layer (due to different soil properties) */
-	for (layer=0; layer < N_SOILLAYERS; layer++)
+	for (layer=0; layer < sitec->n_soillayers; layer++)
 	{
 		VWCsat = sprop->VWCsat[layer]; 
 		VWCfc  = sprop->VWCfc[layer]; 
@@ -83,11 +83,22 @@ int conduct_limit_factors(file logfile, const control_struct* ctrl, const soilpr
 		PSI_SScrit2[layer]             = exp(VWCsat/VWC_SScrit2*log(sprop->soilB[layer]))*sprop->PSIsat[layer];
 
 	}
-	if (ctrl->spinup < 2) fprintf(logfile.ptr, "CRITICAL VALUES OF VWC and PSI FOR 10 SOIL LAYERS\n");  
-	if (ctrl->spinup < 2) fprintf(logfile.ptr, "VWC [m3/m3] at limit1:      %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f\n", epv->VWC_SScrit1[0], epv->VWC_SScrit1[1], epv->VWC_SScrit1[2], epv->VWC_SScrit1[3], epv->VWC_SScrit1[4], epv->VWC_SScrit1[5], epv->VWC_SScrit1[6], epv->VWC_SScrit1[7], epv->VWC_SScrit1[8], epv->VWC_SScrit1[9]);
-	if (ctrl->spinup < 2) fprintf(logfile.ptr, "VWC [m3/m3] at limit2:      %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f\n", epv->VWC_SScrit2[0], epv->VWC_SScrit2[1], epv->VWC_SScrit2[2], epv->VWC_SScrit2[3], epv->VWC_SScrit2[4], epv->VWC_SScrit2[5], epv->VWC_SScrit2[6], epv->VWC_SScrit2[7], epv->VWC_SScrit2[8], epv->VWC_SScrit2[9]);
-	if (ctrl->spinup < 2) fprintf(logfile.ptr, "PSI [MPa]   at limit1:      %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f\n", PSI_SScrit1[0], PSI_SScrit1[1], PSI_SScrit1[2], PSI_SScrit1[3], PSI_SScrit1[4], PSI_SScrit1[5], PSI_SScrit1[6], PSI_SScrit1[7], PSI_SScrit1[8], PSI_SScrit1[9]);
-	if (ctrl->spinup < 2) fprintf(logfile.ptr, "PSI [MPa]   at limit2:      %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f\n", PSI_SScrit2[0], PSI_SScrit2[1], PSI_SScrit2[2], PSI_SScrit2[3], PSI_SScrit2[4], PSI_SScrit2[5], PSI_SScrit2[6], PSI_SScrit2[7], PSI_SScrit2[8], PSI_SScrit2[9]);
+	if (ctrl->spinup < 2) fprintf(logfile.ptr, "CRITICAL VALUES OF VWC and PSI FOR %i SOIL LAYERS\n", sitec->n_soillayers);  
+	if (ctrl->spinup < 2)
+	{
+		fprintf(logfile.ptr, "VWC [m3/m3] at limit1:     ");
+		for (layer = 0; layer < sitec->n_soillayers; layer++) fprintf(logfile.ptr, " %12.3f", epv->VWC_SScrit1[layer]);
+		fprintf(logfile.ptr, "\n");
+		fprintf(logfile.ptr, "VWC [m3/m3] at limit2:     ");
+		for (layer = 0; layer < sitec->n_soillayers; layer++) fprintf(logfile.ptr, " %12.3f", epv->VWC_SScrit2[layer]);
+		fprintf(logfile.ptr, "\n");
+		fprintf(logfile.ptr, "PSI [MPa]   at limit1:     ");
+		for (layer = 0; layer < sitec->n_soillayers; layer++) fprintf(logfile.ptr, " %12.3f", PSI_SScrit1[layer]);
+		fprintf(logfile.ptr, "\n");
+		fprintf(logfile.ptr, "PSI [MPa]   at limit2:     ");
+		for (layer = 0; layer < sitec->n_soillayers; layer++) fprintf(logfile.ptr, " %12.3f", PSI_SScrit2[layer]);
+		fprintf(logfile.ptr, "\n");
+	}
 
 	if (ctrl->spinup < 2) fprintf(logfile.ptr, " \n");
 		
@@ -135,7 +135,7 @@ int cutdown2litter(const siteconst_struct *sitec, const epconst_struct* epc, con
 	/* 2.2 	belowground biomass divided between soil layers based on their root content */ 
 	if (epv->rootDepth > CRIT_PREC)
 	{
-		for (layer=0; layer < N_SOILLAYERS; layer++)
+		for (layer=0; layer < sitec->n_soillayers; layer++)
 		{
 			cs->litr1c[layer]  += cf->CTDBc_froot_to_litr * epc->frootlitr_flab  * epv->rootlengthProp[layer];
 			cs->litr2c[layer]  += cf->CTDBc_froot_to_litr * epc->frootlitr_fucel * epv->rootlengthProp[layer];
@@ -152,7 +152,7 @@ int cutdown2litter(const siteconst_struct *sitec, const epconst_struct* epc, con
 	}
 	else
 	{
-		for (layer=0; layer < N_SOILLAYERS; layer++)
+		for (layer=0; layer < sitec->n_soillayers; layer++)
 		{
 			cs->litr1c[layer]  += cf->CTDBc_froot_to_litr * epc->frootlitr_flab  * epv->rootlengthLandD_prop[layer];
 			cs->litr2c[layer]  += cf->CTDBc_froot_to_litr * epc->frootlitr_fucel * epv->rootlengthLandD_prop[layer];
@@ -91,7 +91,7 @@ the accumulation of soil mineral N.
 #include "bgc_func.h"
 #include "bgc_constants.h"
 
-int daily_allocation(const epconst_struct* epc, const soilprop_struct* sprop, const metvar_struct* metv, const NdepControl_struct* ndep,
+int daily_allocation(const epconst_struct* epc, const siteconst_struct* sitec, const soilprop_struct* sprop, const metvar_struct* metv, const NdepControl_struct* ndep,
 	                 cstate_struct*cs,  nstate_struct* ns, cflux_struct* cf, nflux_struct* nf, epvar_struct* epv, ntemp_struct* nt, double naddfrac)
 {
 	int errorCode=0;
@@ -265,7 +265,7 @@ int daily_allocation(const epconst_struct* epc, const soilprop_struct* sprop, co
 	/* 4. calculation of spinup N-add and sminnAVAIL and potIMMOB */
 
 	nf->sminn_to_npool_total = nf->retransn_to_npool_total = plantNalloc = plantCalloc = 0;
-	for (layer=0; layer < N_SOILLAYERS; layer++)
+	for (layer=0; layer < sitec->n_soillayers; layer++)
 	{
 		ns->sminNH4avail[layer] = ns->sminNH4[layer] * sprop->NH4_mobilen_prop;
 		ns->sminNO3avail[layer] = ns->sminNO3[layer] * NO3_mobilen_prop;
@@ -507,7 +507,7 @@ int daily_allocation(const epconst_struct* epc, const soilprop_struct* sprop, co
 
 	
 
-	for (layer = 0; layer < N_SOILLAYERS; layer++)
+	for (layer = 0; layer < sitec->n_soillayers; layer++)
 	{
 		
 		IMMOBratio = epv->IMMOBratio[layer];
@@ -1,5 +1,6 @@
 /*daymet.c
-transfer one day of meteorological data from metarr struct to metv struct
+transfer one day of meteorological data from metarr struct to metv struct (the variables are read by metarr_value(): the
+derived variables of the compact met store are calculated, the streamed met input is read from the window)
 
 *-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
 Biome-BGCMuSo v7.0.
@@ -21,7 +22,7 @@ See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentatio
 #include "bgc_func.h"
 #include "bgc_constants.h"
 
-int daymet(const control_struct* ctrl,const metarr_struct* metarr, const epconst_struct* epc, metvar_struct* metv, double snoww)
+int daymet(const control_struct* ctrl,const metarr_struct* metarr, const epconst_struct* epc, const siteconst_struct* sitec, metvar_struct* metv, double snoww)
 {
 	/* generates daily meteorological variables from the metarray struct */
 	double Tmax,Tmin,Tavg,TavgRA11,TavgRA30,TavgRA10,Tday,tdiff, tsoil_top;
@@ -29,28 +30,28 @@ int daymet(const control_struct* ctrl,const metarr_struct* metarr, const epconst
 
 
 	/* convert prcp from cm --> kg/m2 */
-	metv->prcp = metarr->prcp_array[ctrl->metday] * 10.0;
+	metv->prcp = metarr_value(metarr, METARR_PRCP, ctrl->metday) * 10.0;
 	
 
 	/* air temperature calculations (all temperatures deg C) */
-	metv->Tmax			= Tmax    = metarr->Tmax_array[ctrl->metday];
-	metv->Tmin			= Tmin    = metarr->Tmin_array[ctrl->metday];
-	metv->Tavg		    = Tavg    = metarr->Tavg_array[ctrl->metday];
+	metv->Tmax			= Tmax    = metarr_value(metarr, METARR_TMAX, ctrl->metday);
+	metv->Tmin			= Tmin    = metarr_value(metarr, METARR_TMIN, ctrl->metday);
+	metv->Tavg		    = Tavg    = metarr_value(metarr, METARR_TAVG, ctrl->metday);
 
-	metv->Tday			= Tday	= metarr->Tday_array[ctrl->metday];
+	metv->Tday			= Tday	= metarr_value(metarr, METARR_TDAY, ctrl->metday);
 
 	metv->tnight		= (Tday + Tmin) / 2.0;
-	metv->TavgRA11	    = TavgRA11 = metarr->TavgRA11_array[ctrl->metday];
-	metv->TavgRA30	    = TavgRA30 = metarr->TavgRA30_array[ctrl->metday];
-	metv->TavgRA10	    = TavgRA10 = metarr->TavgRA10_array[ctrl->metday];
+	metv->TavgRA11	    = TavgRA11 = metarr_value(metarr, METARR_TAVGRA11, ctrl->metday);
+	metv->TavgRA30	    = TavgRA30 = metarr_value(metarr, METARR_TAVGRA30, ctrl->metday);
+	metv->TavgRA10	    = TavgRA10 = metarr_value(metarr, METARR_TAVGRA10, ctrl->metday);
 	
 	metv->annTavg       = metarr->annTavg_array[ctrl->simyr];
 	metv->annTavgRA     = metarr->annTavgRA_array[ctrl->simyr];
 	metv->annTrange     = metarr->annTrange_array[ctrl->simyr];
 	metv->annTrangeRA   = metarr->annTrangeRA_array[ctrl->simyr];
 	
-	metv->tempradF     = metarr->tempradF_array[ctrl->metday];
-	metv->tempradFra   = metarr->tempradFra_array[ctrl->metday];
+	metv->tempradF     = metarr_value(metarr, METARR_TEMPRADF, ctrl->metday);
+	metv->tempradFra   = metarr_value(metarr, METARR_TEMPRADFRA, ctrl->metday);
 
 	if (!ctrl->metday)
 	{
@@ -96,24 +97,30 @@ int daymet(const control_struct* ctrl,const metarr_struct* metarr, const epconst
 	}
 
 	/* 3 m below the ground surface (last layer) is specified by the annual mean surface air temperature */
-	metv->tsoil[N_SOILLAYERS-1] = metv->annTavgRA;
+	metv->tsoil[sitec->n_soillayers-1] = metv->annTavgRA;
 	
 
 	
 	/* **********************************************************************************/
 	
 	/* daylight average vapor pressure deficit (Pa) */
-	metv->vpd = metarr->vpd_array[ctrl->metday];
+	metv->vpd = metarr_value(metarr, METARR_VPD, ctrl->metday);
 
 	/* daylight average	shortwave flux density (W/m2) */
-	metv->swavgfd =  metarr->swavgfd_array[ctrl->metday];
+	metv->swavgfd =  metarr_value(metarr, METARR_SWAVGFD, ctrl->metday);
 	
 	/* PAR (W/m2) */
-	metv->par = metarr->par_array[ctrl->metday];
+	metv->par = metarr_value(metarr, METARR_PAR, ctrl->metday);
 
 	/* daylength (s) */
-	metv->dayl = metarr->dayl_array[ctrl->metday];
+	metv->dayl = metarr_value(metarr, METARR_DAYL, ctrl->metday);
 
+	/* streamed met input: error of a load of the window */
+	if (metarr->stream && metarr->stream->errorCode)
+	{
+		printf("ERROR reading the window of the streamed met input, daymet()\n");
+		errorCode=1;
+	}
 	
 
 	return (errorCode);
@@ -0,0 +1,714 @@
+/*
+daystep.c
+daily step of the simulation: one engine for the normal run (bgc()), the spinup run (spinup_bgc()) and the transient run
+(transient_bgc()), specialized at compile time by the run phase and by the configuration of the run (soil hydrology method,
+management, flowering heat stress); the daily step of the run is selected once from a table by daystep_select(), rare
+configurations use the generic step with runtime tests
+
+phase-dependent parts of the daily step:
+DAYSTEP_NORMAL:    management fluxes, irrigating, outputs with comparison to observations, aggregations, optimizer objectives
+                   and outputs of the sensitivity analysis
+DAYSTEP_SPINUP:    supplemental N addition in daily allocation, no management fluxes and irrigating (only the management days are set),
+                   output handling only if spinup outputs are requested
+DAYSTEP_TRANSIENT: management fluxes, irrigating, transient outputs (error codes are multiplied by 10)
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "bgc_constants.h"
+#include "bgc_func.h"
+#include "pointbgc_struct.h"
+#include "bgc_io.h"
+#include "pointbgc_func.h"
+
+/* the engine has to be inlined into the specialized steps, so that the branches of the other phases and configurations are 
+   removed by the compiler */
+#if defined(_MSC_VER)
+#define INLINE_DAYSTEP static __forceinline
+#else
+#define INLINE_DAYSTEP static inline __attribute__((always_inline))
+#endif
+
+
+static int daystep_config(const daystep_struct* D, int phase)
+{
+	/* configuration bits of the run from the EPC and the management settings */
+	int config=0;
+
+	if (D->epc->SHCM_flag == 1) config |= DAYSTEP_RICHARDS;
+	if (D->epc->n_flowHS_phenophase > 0) config |= DAYSTEP_FLOWHS;
+
+	/* management fluxes and irrigating are calculated only in normal and transient runs */
+	if (phase != DAYSTEP_SPINUP &&
+		(D->PLT->PLT_num || D->THN->THN_num || D->MOW->MOW_num || D->MOW->condMOW_flag || D->GRZ->GRZ_num || D->HRV->HRV_num || 
+		 D->PLG->PLG_num || D->FRZ->FRZ_num || D->IRG->IRG_num || D->IRG->condIRG_flag || D->MUL->MUL_num || D->CWE->CWE_num))
+		config |= DAYSTEP_MGM;
+
+	return (config);
+}
+
+
+INLINE_DAYSTEP int daystep_engine(const int phase, const int config, daystep_struct* D, int simyr, int yday)
+{
+	int errorCode=0;
+	int annual_alloc;
+
+	/* configuration: compile-time constant in the specialized steps, from the run in the generic step */
+	const int cfg = (config & DAYSTEP_GENERIC) ? D->config : config;
+
+	control_struct* ctrl       = D->ctrl;
+	metvar_struct* metv        = D->metv;
+	wstate_struct* ws          = D->ws;
+	wflux_struct* wf           = D->wf;
+	cstate_struct* cs          = D->cs;
+	cflux_struct* cf           = D->cf;
+	nstate_struct* ns          = D->ns;
+	nflux_struct* nf           = D->nf;
+	epconst_struct* epc        = D->epc;
+	epvar_struct* epv          = D->epv;
+	siteconst_struct* sitec    = D->sitec;
+	soilprop_struct* sprop     = D->sprop;
+	phenology_struct* phen     = D->phen;
+	summary_struct* summary    = D->summary;
+	bgcout_struct* bgcout      = D->bgcout;
+
+	/* set the day index for meteorological and phenological arrays */
+	ctrl->yday   = yday;
+	ctrl->metday = simyr*nDAYS_OF_YEAR + yday;
+
+	/* set fluxes to zero */
+	if (!errorCode && make_zero_flux_struct(wf, cf, nf, D->gwc))
+	{
+		printf("ERROR in call to make_zero_flux_struct() from daystep()\n");
+		errorCode=501;
+	}
+
+	/* initalizing annmax and cumulative variables */
+	if (yday == 0)
+	{
+		if (!errorCode && annVARinit(summary, epv, cs, ws, cf, nf))
+		{
+			printf("ERROR in call to annVARinit() from daystep()\n");
+			errorCode=502;
+		}
+	}
+
+	/* nitrogen deposition and fixation */
+	nf->ndep_to_sminn_total = D->dailyNdep;
+	nf->nfix_to_sminn_total = epc->nfix / nDAYS_OF_YEAR;
+
+	/* calculating actual onday and offday */
+	if (!errorCode && dayphen(ctrl, epc, D->phenarr, D->PLT, phen))
+	{
+		printf("ERROR in dayphen() from daystep()\n");
+		errorCode=503;
+	}
+
+	/* setting MANAGEMENT DAYS based on input data */
+	if (!errorCode && management(ctrl, D->FRZ, D->GRZ, D->HRV, D->MOW, D->PLT, D->PLG, D->THN, D->IRG, D->MUL, D->CWE, D->FLD, D->GWS, D->mondays))
+	{
+		printf("ERROR in management days() from daystep()\n");
+		errorCode=504;
+	}
+
+	/* determining soil hydrological parameters  */
+	if (!errorCode && multilayer_hydrolparams(sitec, sprop, ws, epv))
+	{
+		printf("ERROR in multilayer_hydrolparams() from daystep()\n");
+		errorCode=505;
+	}
+
+	/* daily meteorological variables from metarrays */
+	if (!errorCode && daymet(ctrl, D->metarr, epc, sitec, metv, ws->snoww))
+	{
+		printf("ERROR in daymet() from daystep()\n");
+		errorCode=506;
+	}
+
+	/* phenophases calculation */
+	if (!errorCode && phenphase(bgcout->log_file, ctrl, epc, sprop, D->PLT, phen, metv, epv, cs))
+	{
+		printf("ERROR in phenphase() from daystep()\n");
+		errorCode=507;
+	}
+
+	/* soil temperature calculations */
+	if (!errorCode && multilayer_tsoil(epc, sitec, sprop, epv, yday, ws->snoww, metv))
+	{
+		printf("ERROR in multilayer_tsoil() from daystep()\n");
+		errorCode=508;
+	}
+
+	/* soilCover calculations */
+	if (!errorCode && soilCover(sitec, sprop, metv, epv, cs))
+	{
+		printf("ERROR in soilCover() from daystep()\n");
+		errorCode=509;
+	}
+
+	/* phenology calculation */
+	if (!errorCode && phenology(epc, cs, ns, phen, metv, epv, cf, nf))
+	{
+		printf("ERROR in phenology() from daystep()\n");
+		errorCode=510;
+	}
+
+	/* calculate leaf area index, sun and shade fractions, and specific leaf area for sun and shade canopy fractions, then calculate canopy radiation interception and transmission */
+	if (!errorCode && radtrans(ctrl, phen, cs, epc, sitec, metv, epv))
+	{
+		printf("ERROR in radtrans() from daystep()\n");
+		errorCode=511;
+	}
+
+	/* update the annmax LAI/rootingDepth/plantHeight for annual diagnostic output */
+	if (epv->proj_lai > epv->annmax_lai)             epv->annmax_lai = epv->proj_lai;
+	if (epv->rootDepth > epv->annmax_rootDepth)      epv->annmax_rootDepth = epv->rootDepth;
+	if (epv->plantHeight > epv->annmax_plantHeight)  epv->annmax_plantHeight = epv->plantHeight;
+
+	/* IRRIGATING separately from other management routines (no irrigating in spinup) */
+	if (phase != DAYSTEP_SPINUP && (cfg & DAYSTEP_MGM))
+	{
+		if (!errorCode && irrigating(ctrl, D->IRG, sitec, sprop, epv, ws, wf))
+		{
+			printf("ERROR in irrigating() from daystep()\n");
+			errorCode=512;
+		}
+	}
+
+	/* precip routing (when there is precip) */
+	if (!errorCode && metv->prcp && prcpANDrunoffH(metv, sprop, epc, epv, wf))
+	{
+		printf("ERROR in prcpANDrunoffH() from daystep()\n");
+		errorCode=513;
+	}
+
+	/* snowmelt (when there is a snowpack) */
+	if (!errorCode && ws->snoww && snowmelt(metv, wf, ws->snoww))
+	{
+		printf("ERROR in snowmelt() from daystep()\n");
+		errorCode=514;
+	}
+
+	/* potential evaporation and transpiration */
+	if (!errorCode && Elimit_and_PET(epc, sprop, metv, epv, wf))
+	{
+		printf("ERROR in Elimit_and_PET() from daystep()\n");
+		errorCode=515;
+	}
+
+	/* conductance calculation */
+	if (!errorCode && conduct_calc(ctrl, metv, epc, epv, simyr))
+	{
+		printf("ERROR in conduct_calc() from daystep()\n");
+		errorCode=516;
+	}
+
+	/* begin canopy bio-physical process simulation */
+	/* do canopy ET calculations whenever there is leaf area displayed, since there may be intercepted water on the canopy that needs to be dealt with */
+	if (!errorCode && epv->n_actphen > epc->n_emerg_phenophase && metv->dayl)
+	{
+		/* evapotranspiration */
+		if (!errorCode && cs->leafc && canopy_et(epc, metv, epv, wf))
+		{
+			printf("ERROR in canopy_et() from daystep()\n");
+			errorCode=517;
+		}
+	}
+
+	/* daily maintenance respiration */
+	if (!errorCode && maint_resp(D->PLT, cs, ns, epc, metv, epv, cf))
+	{
+		printf("ERROR in m_resp() from daystep()\n");
+		errorCode=518;
+	}
+
+	/* photosynthesis calculation */
+	if (!errorCode && cs->leafc && photosynthesis(epc, metv, cs, ws, phen, epv, D->psn_sun, D->psn_shade, cf))
+	{
+		printf("ERROR in photosynthesis() from daystep()\n");
+		errorCode=519;
+	}
+
+	/* daily litter and soil decomp and nitrogen fluxes */
+	if (!errorCode && decomp(metv, epc, sprop, sitec, cs, ns, epv, cf, nf, D->nt))
+	{
+		printf("ERROR in decomp() from daystep()\n");
+		errorCode=520;
+	}
+
+	/* Daily allocation gets called whether or not this is a current growth day, because the competition between decomp immobilization fluxes
+	and plant growth N demand is resolved here.  On days with no growth, no allocation occurs, but immobilization fluxes are updated normally.
+	Spinup: in the rising limb the spinup allocation code supplements N supply (naddfrac > 0) */
+	if (!errorCode && daily_allocation(epc, sitec, sprop, metv, D->ndep, cs, ns, cf, nf, epv, D->nt, (phase == DAYSTEP_SPINUP) ? D->naddfrac : 0))
+	{
+		printf("ERROR in daily_allocation() from daystep()\n");
+		errorCode=521;
+	}
+
+	/* heat stress during flowering can affect daily allocation of yield */
+	if (cfg & DAYSTEP_FLOWHS)
+	{
+		if (!errorCode && flowering_heatstress(epc, metv, cs, epv, cf, nf))
+		{
+			printf("ERROR in flowering_heatstress() from daystep()\n");
+			errorCode=522;
+		}
+	}
+
+	/* reassess the annual turnover rates for livewood --> deadwood, and for evergreen leaf and fine root litterfall.
+	This happens once each year, on the annual_alloc day (the last litterfall day - test for annual allocation day) */
+	if (phen->remdays_litfall == 1)
+		annual_alloc = 1;
+	else
+		annual_alloc = 0;
+
+	/* litterfall rates once a year */
+	if (!errorCode && annual_alloc)
+	{
+		if (!errorCode && annual_rates(epc, epv))
+		{
+			printf("ERROR in annual_rates() from daystep()\n");
+			errorCode=523;
+		}
+	}
+
+	/* daily growth respiration */
+	if (!errorCode && growth_resp(epc, cf))
+	{
+		printf("ERROR in growth_resp() from daystep()\n");
+		errorCode=524;
+	}
+
+
+	/* !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! */
+	/* 3. WATER CALCULATIONS WITH STATE UPDATE */
+
+	/* EVAPORATION: calculation of actual evaporation from potential evaporation */
+	if (!errorCode && potEVPsurface_to_actEVPsurface(ctrl, sitec, sprop, epv, ws, wf))
+	{
+		printf("ERROR in potEVPsurface_to_actEVPsurface() from daystep()\n");
+		errorCode=525;
+	}
+
+	/* multilayer soil hydrology: percolation calculation based on PRCP, RUNOFF, EVP, TRP */
+	if (cfg & DAYSTEP_RICHARDS)
+	{
+		if (!errorCode && multilayer_hydrolprocessR(ctrl, sitec, sprop, epc, epv, ws, wf, D->GWS, D->gwc))
+		{
+			printf("ERROR in multilayer_hydrolprocess() from daystep()\n");
+			errorCode=526;
+		}
+	}
+	else
+	{
+		if (!errorCode && multilayer_hydrolprocessT(ctrl, sitec, sprop, epc, epv, ws, wf, D->GWS, D->FLD, D->mondays))
+		{
+			printf("ERROR in multilayer_hydrolprocess() from daystep()\n");
+			errorCode=526;
+		}
+	}
+
+
+	/* !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! */
+	/* 4. STATE UPDATE */
+
+	/* daily update of the water state variables */
+	if (!errorCode && water_state_update(sitec, wf, ws))
+	{
+		printf("ERROR in water_state_update() from daystep()\n");
+		errorCode=527;
+	}
+
+	/* daily update of carbon and nitrogen state variables */
+	if (!errorCode && CN_state_update(sitec, epc, ctrl, epv, cf, nf, cs, ns, annual_alloc, epc->evergreen))
+	{
+		printf("ERROR in CN_state_update() from daystep()\n");
+		errorCode=528;
+	}
+
+
+	/* !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! */
+	/* 5. MORTALITY AND NITROGEN FLUXES CALCULATION WITH OWN STATE UPDATE:
+	to insure that pools don't go negative due to mortality/leaching fluxes conflicting with other proportional fluxes */
+
+	/* calculate daily senescence mortality fluxes and update state variables */
+	if (!errorCode && senescence(sitec, epc, D->GRZ, metv, ctrl, cs, cf, ns, nf, epv))
+	{
+		printf("ERROR in senescence() from daystep()\n");
+		errorCode=529;
+	}
+
+	/* calculate daily mortality fluxes  and update state variables */
+	if (!errorCode && mortality(ctrl, sitec, epc, epv, cs, cf, ns, nf, simyr))
+	{
+		printf("ERROR in mortality() from daystep()\n");
+		errorCode=530;
+	}
+
+	/* calculate the change of soil mineralized N in multilayer soil */
+	if (!errorCode && multilayer_sminn(ctrl, metv, sprop, sitec, cf, D->ndep, epv, ns, nf))
+	{
+		printf("ERROR in multilayer_sminn() from daystep()\n");
+		errorCode=531;
+	}
+
+	/* calculate the leaching of N, DOC and DON from multilayer soil */
+	if (!errorCode && multilayer_leaching(sitec, sprop, epv, ctrl, cs, cf, ns, nf, ws, wf))
+	{
+		printf("ERROR in multilayer_leaching() from daystep()\n");
+		errorCode=532;
+	}
+
+
+	/* !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! */
+	/* 6. MANAGEMENT FLUXES (no management fluxes in spinup and without management) */
+
+	if (phase != DAYSTEP_SPINUP && (cfg & DAYSTEP_MGM))
+	{
+		/* PLANTING */
+		if (!errorCode && planting(ctrl, sitec, D->PLT, epc, epv, phen, cs, ns, cf, nf))
+		{
+			printf("ERROR in planting() from daystep()\n");
+			errorCode=533;
+		}
+
+		/* the EPC of a planting (crop rotation) can change the configuration: the step of the following days is selected again
+		   (the configuration is not used after this point of the day) */
+		if (!errorCode && D->PLT->PLT_num && daystep_config(D, phase) != D->config && daystep_select(D, phase))
+		{
+			printf("ERROR in daystep_select() from daystep()\n");
+			errorCode=554;
+		}
+
+		/* THINNIG  */
+		if (!errorCode && thinning(ctrl, epc, D->THN, cs, ns, ws, cf, nf, wf))
+		{
+			printf("ERROR in thinning() from daystep()\n");
+			errorCode=534;
+		}
+
+		/* MOWING  */
+		if (!errorCode && mowing(ctrl, epc, D->MOW, epv, cs, ns, ws, cf, nf, wf))
+		{
+			printf("ERROR in mowing() from daystep()\n");
+			errorCode=535;
+		}
+
+		/* grazing  */
+		if (!errorCode && grazing(ctrl, epc, sitec, D->GRZ, epv, cs, ns, ws, cf, nf, wf, D->mondays))
+		{
+			printf("ERROR in grazing() from daystep()\n");
+			errorCode=536;
+		}
+
+		/* HARVESTING  */
+		if (!errorCode && harvesting(bgcout->econout_file, ctrl, phen, epc, D->HRV, D->IRG, epv, cs, ns, ws, cf, nf, wf))
+		{
+			printf("ERROR in harvesting() from daystep()\n");
+			errorCode=537;
+		}
+
+		/* PLOUGHING */
+		if (!errorCode && ploughing(ctrl, epc, sitec, sprop, metv, epv, D->PLG, cs, ns, ws, cf, nf, wf))
+		{
+			printf("ERROR in ploughing() from daystep()\n");
+			errorCode=538;
+		}
+
+		/* FERTILIZING  */
+		if (!errorCode && fertilizing(ctrl, sitec, sprop, D->FRZ, cs, ns, ws, cf, nf, wf))
+		{
+			printf("ERROR in fertilizing() from daystep()\n");
+			errorCode=539;
+		}
+
+		/* MULCHING */
+		if (!errorCode && mulching(ctrl, D->MUL, cs, ns, cf, nf))
+		{
+			printf("ERROR in mulching() from daystep()\n");
+			errorCode=540;
+		}
+
+		/* CWD-extract */
+		if (!errorCode && CWDextract(ctrl, D->CWE, cs, ns, cf, nf))
+		{
+			printf("ERROR in CWDextract() from daystep()\n");
+			errorCode=541;
+		}
+	}
+
+	/* cut-down plant material (due to management): decay of the cut-down pools also after the management events */
+	if (phase != DAYSTEP_SPINUP)
+	{
+		if (!errorCode && cutdown2litter(sitec, epc, epv, cs, cf, ns, nf))
+		{
+			printf("ERROR in cutdown2litter() from daystep()\n");
+			errorCode=542;
+		}
+	}
+
+	/* calculating rooting depth, n_rootlayers, n_maxrootlayers, rootlengthProp */
+	if (!errorCode && multilayer_rootDepth(epc, sprop, cs, sitec, epv))
+	{
+		printf("ERROR in multilayer_rootDepth() from daystep()\n");
+		errorCode=543;
+	}
+
+
+	/* !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! */
+	/* 7. ERROR CHECKING AND SUMMARY VARIABLES  */
+
+	/* test for very low state variable values and force them to 0.0 to avoid rounding and floating point overflow errors */
+	if (!errorCode && precision_control(ws, cs, ns))
+	{
+		printf("ERROR in call to precision_control() from daystep()\n");
+		errorCode=544;
+	}
+
+	/* test for water balance*/
+	if (!errorCode && check_water_balance(sitec, ws, *D->first_balance))
+	{
+		printf("ERROR in check_water_balance() from daystep()\n");
+		errorCode=545;
+	}
+
+	/* test for carbon balance */
+	if (!errorCode && check_carbon_balance(cs, *D->first_balance))
+	{
+		printf("ERROR in check_carbon_balance() from daystep()\n");
+		errorCode=546;
+	}
+
+	/* test for nitrogen balance */
+	if (!errorCode && check_nitrogen_balance(ns, *D->first_balance))
+	{
+		printf("ERROR in check_nitrogen_balance() from daystep()\n");
+		errorCode=547;
+	}
+
+	/* calculate summary variables */
+	if (!errorCode && cnw_summary(epc, sitec, sprop, metv, cs, cf, ns, nf, wf, epv, summary))
+	{
+		printf("ERROR in cnw_summary() from daystep()\n");
+		errorCode=548;
+	}
+
+	/* output handling: normal run with comparison to observations and aggregations, transient run into the transient files,
+	   spinup only if spinup outputs are requested */
+	if (phase == DAYSTEP_NORMAL)
+	{
+		if (!errorCode && output_handling(D->mondays, D->enddays, ctrl, D->output_map, D->dayarr, D->monavgarr, D->annavgarr, D->annarr,
+			                              bgcout->dayout, bgcout->monavgout, bgcout->annavgout, bgcout->annout, &D->bgcin->OBS, &D->bgcin->AGG, bgcout->aggout))
+		{
+			printf("ERROR in output_handling() from daystep()\n");
+			errorCode=549;
+		}
+	}
+	else if (phase == DAYSTEP_TRANSIENT)
+	{
+		if (!errorCode && output_handling(D->mondays, D->enddays, ctrl, D->output_map, D->dayarr, D->monavgarr, D->annavgarr, D->annarr,
+			                              bgcout->dayoutT, bgcout->monavgoutT, bgcout->annavgoutT, bgcout->annoutT, NULL, NULL, bgcout->aggout))
+		{
+			printf("ERROR in output_handling() from daystep()\n");
+			errorCode=549;
+		}
+	}
+	else if (ctrl->dodaily || ctrl->domonavg || ctrl->doannavg || ctrl->doannual)
+	{
+		if (!errorCode && output_handling(D->mondays, D->enddays, ctrl, D->output_map, D->dayarr, D->monavgarr, D->annavgarr, D->annarr,
+			                              bgcout->dayout, bgcout->monavgout, bgcout->annavgout, bgcout->annout, NULL, NULL, bgcout->aggout))
+		{
+			printf("ERROR in output_handling() from daystep()\n");
+			errorCode=549;
+		}
+	}
+
+	/* management optimizer: objective of the actual run */
+	if (phase == DAYSTEP_NORMAL)
+	{
+		if (!errorCode && D->bgcin->OPT.nobj && optim_update(&D->bgcin->OPT, ctrl, D->output_map))
+		{
+			printf("ERROR in optim_update() from daystep()\n");
+			errorCode=552;
+		}
+
+		/* sensitivity analysis: output variables of the actual run */
+		if (!errorCode && D->bgcin->SEN && sensitivity_update(D->bgcin->SEN, ctrl, D->output_map))
+		{
+			printf("ERROR in sensitivity_update() from daystep()\n");
+			errorCode=553;
+		}
+	}
+
+	/*  if no dormant period (e.g. evergreen): last day is the dormant day */
+	if (phen->offday - phen->onday == 364 && phen->offday == phen->yday_total)
+	{
+		epv->n_actphen = 0;
+		phen->onday = -1;
+		phen->offday = -1;
+		phen->remdays_litfall =-1;
+	}
+
+	/* at the end of first day of simulation, turn off the first_balance switch */
+	if (*D->first_balance) *D->first_balance = 0;
+
+	/* if this is the last day of the current month: increment current month counter */
+	if (yday == D->enddays[ctrl->curmonth]) ctrl->curmonth++;
+
+	/* error codes of the transient run: 10 times the codes of the daily step */
+	if (phase == DAYSTEP_TRANSIENT) errorCode *= 10;
+
+	return (errorCode);
+}
+
+
+void daystep_init(daystep_struct* D, bgcin_struct* bgcin, bgcout_struct* bgcout, int* first_balance, control_struct* ctrl, metarr_struct* metarr, 
+	              metvar_struct* metv, NdepControl_struct* ndep, wstate_struct* ws, wflux_struct* wf, cstate_struct* cs, cflux_struct* cf, 
+				  nstate_struct* ns, nflux_struct* nf, epconst_struct* epc, epvar_struct* epv, siteconst_struct* sitec, soilprop_struct* sprop, 
+				  GWcalc_struct* gwc, phenarray_struct* phenarr, phenology_struct* phen, psn_struct* psn_sun, psn_struct* psn_shade, ntemp_struct* nt, 
+				  summary_struct* summary, planting_struct* PLT, thinning_struct* THN, mowing_struct* MOW, grazing_struct* GRZ, harvesting_struct* HRV, 
+				  ploughing_struct* PLG, fertilizing_struct* FRZ, irrigating_struct* IRG, mulching_struct* MUL, CWDextract_struct* CWE, 
+				  flooding_struct* FLD, groundwater_struct* GWS, double** output_map, double* dayarr, double* monavgarr, double* annavgarr, 
+				  double* annarr, int* mondays, int* enddays)
+{
+	/* the engine works on the local structures of the calling run, the inputs of the actual year are set by the caller */
+	memset(D, 0, sizeof(daystep_struct));
+
+	D->bgcin         = bgcin;
+	D->bgcout        = bgcout;
+	D->first_balance = first_balance;
+	D->ctrl          = ctrl;
+	D->metarr        = metarr;
+	D->metv          = metv;
+	D->ndep          = ndep;
+	D->ws            = ws;
+	D->wf            = wf;
+	D->cs            = cs;
+	D->cf            = cf;
+	D->ns            = ns;
+	D->nf            = nf;
+	D->epc           = epc;
+	D->epv           = epv;
+	D->sitec         = sitec;
+	D->sprop         = sprop;
+	D->gwc           = gwc;
+	D->phenarr       = phenarr;
+	D->phen          = phen;
+	D->psn_sun       = psn_sun;
+	D->psn_shade     = psn_shade;
+	D->nt            = nt;
+	D->summary       = summary;
+	D->PLT           = PLT;
+	D->THN           = THN;
+	D->MOW           = MOW;
+	D->GRZ           = GRZ;
+	D->HRV           = HRV;
+	D->PLG           = PLG;
+	D->FRZ           = FRZ;
+	D->IRG           = IRG;
+	D->MUL           = MUL;
+	D->CWE           = CWE;
+	D->FLD           = FLD;
+	D->GWS           = GWS;
+	D->output_map    = output_map;
+	D->dayarr        = dayarr;
+	D->monavgarr     = monavgarr;
+	D->annavgarr     = annavgarr;
+	D->annarr        = annarr;
+	D->mondays       = mondays;
+	D->enddays       = enddays;
+}
+
+
+/* specialized daily steps */
+#define DAYSTEP_INSTANCE(name, phase, config) \
+	static int name(daystep_struct* D, int simyr, int yday) { return (daystep_engine(phase, config, D, simyr, yday)); }
+
+DAYSTEP_INSTANCE(daystep_N_T,    DAYSTEP_NORMAL, 0)
+DAYSTEP_INSTANCE(daystep_N_TM,   DAYSTEP_NORMAL, DAYSTEP_MGM)
+DAYSTEP_INSTANCE(daystep_N_TMF,  DAYSTEP_NORMAL, DAYSTEP_MGM | DAYSTEP_FLOWHS)
+DAYSTEP_INSTANCE(daystep_N_R,    DAYSTEP_NORMAL, DAYSTEP_RICHARDS)
+DAYSTEP_INSTANCE(daystep_N_RM,   DAYSTEP_NORMAL, DAYSTEP_RICHARDS | DAYSTEP_MGM)
+DAYSTEP_INSTANCE(daystep_N_RMF,  DAYSTEP_NORMAL, DAYSTEP_RICHARDS | DAYSTEP_MGM | DAYSTEP_FLOWHS)
+DAYSTEP_INSTANCE(daystep_N_GEN,  DAYSTEP_NORMAL, DAYSTEP_GENERIC)
+
+DAYSTEP_INSTANCE(daystep_S_T,    DAYSTEP_SPINUP, 0)
+DAYSTEP_INSTANCE(daystep_S_TF,   DAYSTEP_SPINUP, DAYSTEP_FLOWHS)
+DAYSTEP_INSTANCE(daystep_S_R,    DAYSTEP_SPINUP, DAYSTEP_RICHARDS)
+DAYSTEP_INSTANCE(daystep_S_RF,   DAYSTEP_SPINUP, DAYSTEP_RICHARDS | DAYSTEP_FLOWHS)
+DAYSTEP_INSTANCE(daystep_S_GEN,  DAYSTEP_SPINUP, DAYSTEP_GENERIC)
+
+DAYSTEP_INSTANCE(daystep_T_T,    DAYSTEP_TRANSIENT, 0)
+DAYSTEP_INSTANCE(daystep_T_TM,   DAYSTEP_TRANSIENT, DAYSTEP_MGM)
+DAYSTEP_INSTANCE(daystep_T_TMF,  DAYSTEP_TRANSIENT, DAYSTEP_MGM | DAYSTEP_FLOWHS)
+DAYSTEP_INSTANCE(daystep_T_R,    DAYSTEP_TRANSIENT, DAYSTEP_RICHARDS)
+DAYSTEP_INSTANCE(daystep_T_RM,   DAYSTEP_TRANSIENT, DAYSTEP_RICHARDS | DAYSTEP_MGM)
+DAYSTEP_INSTANCE(daystep_T_RMF,  DAYSTEP_TRANSIENT, DAYSTEP_RICHARDS | DAYSTEP_MGM | DAYSTEP_FLOWHS)
+DAYSTEP_INSTANCE(daystep_T_GEN,  DAYSTEP_TRANSIENT, DAYSTEP_GENERIC)
+
+/* table of the specialized steps: configuration and step of each run phase (the last entry: generic step) */
+#define N_DAYSTEP 7
+
+typedef struct
+{
+	int config;
+	int (*step)(daystep_struct* D, int simyr, int yday);
+} daystep_entry;
+
+static const daystep_entry daystep_table[3][N_DAYSTEP] =
+{
+	{{0, daystep_N_T}, {DAYSTEP_MGM, daystep_N_TM}, {DAYSTEP_MGM | DAYSTEP_FLOWHS, daystep_N_TMF}, {DAYSTEP_RICHARDS, daystep_N_R},
+	 {DAYSTEP_RICHARDS | DAYSTEP_MGM, daystep_N_RM}, {DAYSTEP_RICHARDS | DAYSTEP_MGM | DAYSTEP_FLOWHS, daystep_N_RMF}, {DAYSTEP_GENERIC, daystep_N_GEN}},
+	{{0, daystep_S_T}, {DAYSTEP_FLOWHS, daystep_S_TF}, {DAYSTEP_RICHARDS, daystep_S_R}, {DAYSTEP_RICHARDS | DAYSTEP_FLOWHS, daystep_S_RF},
+	 {DAYSTEP_GENERIC, daystep_S_GEN}, {DAYSTEP_GENERIC, daystep_S_GEN}, {DAYSTEP_GENERIC, daystep_S_GEN}},
+	{{0, daystep_T_T}, {DAYSTEP_MGM, daystep_T_TM}, {DAYSTEP_MGM | DAYSTEP_FLOWHS, daystep_T_TMF}, {DAYSTEP_RICHARDS, daystep_T_R},
+	 {DAYSTEP_RICHARDS | DAYSTEP_MGM, daystep_T_RM}, {DAYSTEP_RICHARDS | DAYSTEP_MGM | DAYSTEP_FLOWHS, daystep_T_RMF}, {DAYSTEP_GENERIC, daystep_T_GEN}}
+};
+
+
+/* generic step of the process (daystep_generic_mode()) */
+static int daystep_generic_flag = 0;
+
+
+int daystep_generic_mode(int flag)
+{
+	/* every run of the following simulations uses the generic step of its phase (comparison of the specialized steps with
+	   the generic step, tools/daystep_bench.c); flag < 0: the mode is only queried */
+	if (flag >= 0) daystep_generic_flag = flag;
+
+	return (daystep_generic_flag);
+}
+
+
+int daystep_select(daystep_struct* D, int phase)
+{
+	/* configuration of the run (after the initialization and the restore of the state, and after a new EPC of a planting) */
+	int n;
+
+	if (phase < DAYSTEP_NORMAL || phase > DAYSTEP_TRANSIENT)
+	{
+		printf("ERROR in run phase of the daily step (%i), daystep_select()\n", phase);
+		return (1);
+	}
+
+	D->config = daystep_config(D, phase);
+
+	/* the specialized step of the configuration, the generic step for the other configurations */
+	for (n = 0; n < N_DAYSTEP-1 && daystep_table[phase][n].config != D->config; n++) ;
+	if (daystep_generic_flag) n = N_DAYSTEP-1;
+	D->step = daystep_table[phase][n].step;
+
+	return (0);
+}
+
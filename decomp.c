@@ -33,8 +33,9 @@ int decomp(const metvar_struct* metv,const epconst_struct* epc, const soilprop_s
 	int errorCode=0;
 	int layer;
 	double ts_decomp, ws_decomp, z_scalar;
+	double z_scalar_array[N_SOILLAYERS];
+	const multilayer_kernels_struct* kernels = multilayer_kernels(sitec->n_soillayers);
 	double rs_decomp, rs_decomp_avg;
-	double tsoil;
 	double minVWC, maxVWC, opt1VWC, opt2VWC, VWC;
 	double rfl1s1, rfl2s2,rfl4s3,rfs1s2,rfs2s3,rfs3s4;
 	double kl1_base,kl2_base,kl4_base,ks1_base,ks2_base,ks3_base,ks4_base,kfrag_base;
@@ -71,8 +72,24 @@ int decomp(const metvar_struct* metv,const epconst_struct* epc, const soilprop_s
 	nf->grossMINERflux_total = 0;
 	nf->potIMMOBflux_total = 0;;
 
+	/* 0. temperature and depth scalars for the whole soil profile (see 1.1 and 1.3) */
+	if (!errorCode && kernels->tresponse(sitec->n_soillayers, metv->tsoil, sprop->Tmin_decomp, sprop->Tp1_decomp, sprop->Tp2_decomp, sprop->Tp3_decomp, sprop->Tp4_decomp, 
+		                                   epv->ts_decomp))
+	{
+		printf("\n");
+ 		printf("ERROR in ts_decomp calculation in decomp.c\n");
+		errorCode=1;
+	}
+
+	if (!errorCode && kernels->zscalar(sitec->n_soillayers, sitec, sprop->efolding_depth, z_scalar_array))
+	{
+		printf("\n");
+ 		printf("ERROR in z_scalar calculation in decomp.c\n");
+		errorCode=1;
+	}
+
 	/* 1. calculate the rate constant scalar in multilayer soil: layer by layer  */
-	for (layer=0; layer < N_SOILLAYERS; layer++)
+	for (layer=0; layer < sitec->n_soillayers; layer++)
 	{
 
 		/* initialize the potential loss and mineral N flux variables */
@@ -81,7 +98,6 @@ int decomp(const metvar_struct* metv,const epconst_struct* epc, const soilprop_s
 		pmnf_l1s1=pmnf_l2s2=pmnf_l4s3=pmnf_s1s2=pmnf_s2s3=pmnf_s3s4=pmnf_s4=0.0;
 		cwdc_to_litr2c=cwdc_to_litr3c =cwdc_to_litr4c=cwdn_to_litr2n=cwdn_to_litr3n =cwdn_to_litr4n=0;
 
-		tsoil = metv->tsoil[layer]; 
 	
 		/* 1.1: calculate the rate constant scalar for soil temperature, assuming that the base rate constants are assigned for non-moisture
 		limiting conditions at 25 C. The function used here is taken from Lloyd, J., and J.A. Taylor, 1994. On the temperature dependence of 
@@ -92,32 +108,8 @@ int decomp(const metvar_struct* metv,const epconst_struct* epc, const soilprop_s
 		/* modification by Hidy 2021: new shape of tsoil function - similar to nitrification
 		                              parameter for no decomp lmitation */
 
-		
-		if (sprop->Tp1_decomp == DATA_GAP)
-		{
-			/* no decomp processes for tsoil < -10.0 C */
-			if (tsoil < sprop->Tmin_decomp)	
-					ts_decomp = 0.0;
-			else
-				ts_decomp = exp(sprop->Tp2_decomp*((1.0/sprop->Tp3_decomp)-(1.0/((tsoil+Celsius2Kelvin)-sprop->Tp4_decomp))));
-		}
-		else
-		{
-			/* no decomp processes for tsoil < -10.0 C */
-			if (tsoil < sprop->Tmin_decomp)	
-					ts_decomp = 0.0;
-			else
-				ts_decomp = sprop->Tp1_decomp/(1+pow(fabs((tsoil-sprop->Tp4_decomp)/sprop->Tp2_decomp),sprop->Tp3_decomp));
-			
-		}
-
-		/* CONTROL - ts_decomp must be grater than 0 */
-		if (ts_decomp < 0)
-		{
-			printf("\n");
- 			printf("ERROR in ts_decomp calculation in decomp.c\n");
-			errorCode=1;
-		}
+		/* no decomp processes for tsoil < Tmin_decomp (calculated for the whole profile by the tresponse kernel of multilayer_scalars.c) */
+		ts_decomp = epv->ts_decomp[layer];
 			
 		/* 1.2: calculate the rate constant scalar for soil water content.
 		Uses the log relationship with water potential given in Andren, O., and K. Paustian, 1987. Barley straw decomposition in the field:
@@ -172,7 +164,7 @@ int decomp(const metvar_struct* metv,const epconst_struct* epc, const soilprop_s
 
 
 		/* 1.3: depth dependence of decompostion rate */
-		z_scalar = exp(-1*(sitec->soillayer_midpoint[layer] / sprop->efolding_depth));
+		z_scalar = z_scalar_array[layer];
 
 	
 		/* 1.4: calculate the final rate scalar as the product of the temperature water and depth scalars */
@@ -183,7 +175,7 @@ int decomp(const metvar_struct* metv,const epconst_struct* epc, const soilprop_s
 		epv->ts_decomp[layer]	= ts_decomp;
 		epv->ws_decomp[layer]	= ws_decomp;
 		epv->rs_decomp[layer] = rs_decomp;
-		rs_decomp_avg        += rs_decomp * (sitec->soillayer_thickness[layer]/sitec->soillayer_depth[N_SOILLAYERS-1]);
+		rs_decomp_avg        += rs_decomp * (sitec->soillayer_thickness[layer]/sitec->soillayer_depth[sitec->n_soillayers-1]);
 
 
 		epv->rs_decomp_avg = rs_decomp_avg;
@@ -51,7 +51,7 @@ int epc_init(file init, epconst_struct* epc, control_struct* ctrl, int EPCfromIN
 
 	sum=maxIND=diff=0;
 
-	ctrl->planttypeName = (char*) malloc(STRINGSIZE * sizeof(char));
+	ctrl->planttypeName = (char*) arena_malloc(STRINGSIZE * sizeof(char));
 			
 	/* allocate space for the optional input temporal variables */
 	OPTINyear_array    = (int*) malloc(ctrl->simyears*sizeof(int));  
@@ -195,7 +195,7 @@ int epc_init(file init, epconst_struct* epc, control_struct* ctrl, int EPCfromIN
 	if (!errorCode && ctrl->varSGS_flag) 
 	{
 		/* allocate space for the annual SGS array */
-		epc->SGS_array = (double*) malloc(ctrl->simyears * sizeof(double));
+		epc->SGS_array = (double*) arena_malloc(ctrl->simyears * sizeof(double));
 		if (!epc->SGS_array)
 		{
 			printf("ERROR allocating for annual SGS array, epc_init()\n");
@@ -208,7 +208,7 @@ int epc_init(file init, epconst_struct* epc, control_struct* ctrl, int EPCfromIN
 		ndata=0;
 		while (!errorCode && !(dataread = scan_array (SGS_file, &p1, 'i', 0, 0)))
 		{
-			dataread = fscanf(SGS_file.ptr, "%lf%*[^\n]", &p2);
+			dataread = scan_array(SGS_file, &p2, 'd', 1, 0);
 				
 			if (p1 >= ctrl->simstartyear && p1 < ctrl->simstartyear + ctrl->simyears)
 			{
@@ -280,7 +280,7 @@ int epc_init(file init, epconst_struct* epc, control_struct* ctrl, int EPCfromIN
 	if (!errorCode && ctrl->varEGS_flag) 
 	{
 		/* allocate space for the annual EGS array */
-		epc->EGS_array = (double*) malloc(ctrl->simyears * sizeof(double));
+		epc->EGS_array = (double*) arena_malloc(ctrl->simyears * sizeof(double));
 		if (!epc->EGS_array)
 		{
 			printf("ERROR allocating for annual EGS array, epc_init()\n");
@@ -293,7 +293,7 @@ int epc_init(file init, epconst_struct* epc, control_struct* ctrl, int EPCfromIN
 		ndata=0;
 		while (!errorCode && !(dataread = scan_array (EGS_file, &p1, 'i', 0, 0)))
 		{
-			dataread = fscanf(EGS_file.ptr, "%lf%*[^\n]", &p2);
+			dataread = scan_array(EGS_file, &p2, 'd', 1, 0);
 				
 			if (p1 >= ctrl->simstartyear && p1 < ctrl->simstartyear + ctrl->simyears)
 			{
@@ -511,7 +511,7 @@ int epc_init(file init, epconst_struct* epc, control_struct* ctrl, int EPCfromIN
 	if (!errorCode && ctrl->varFM_flag) 
 	{
 		/* allocate space for the annual FM array */
-		epc->FMyr_array = (double*) malloc(ctrl->simyears * sizeof(double));
+		epc->FMyr_array = (double*) arena_malloc(ctrl->simyears * sizeof(double));
 		if (!epc->FMyr_array)
 		{
 			printf("ERROR allocating for annual FM array, epc_init()\n");
@@ -525,7 +525,7 @@ int epc_init(file init, epconst_struct* epc, control_struct* ctrl, int EPCfromIN
 		ndata=0;
 		while (!errorCode && !(dataread = scan_array (FM_file, &p1, 'i', 0, 0)))
 		{
-			dataread = fscanf(FM_file.ptr, "%lf%*[^\n]", &p2);
+			dataread = scan_array(FM_file, &p2, 'd', 1, 0);
 				
 			if (p1 >= ctrl->simstartyear && p1 < ctrl->simstartyear + ctrl->simyears)
 			{
@@ -581,7 +581,7 @@ int epc_init(file init, epconst_struct* epc, control_struct* ctrl, int EPCfromIN
 	if (!errorCode && ctrl->varWPM_flag) 
 	{
 		/* allocate space for the annual WPM array */
-		epc->WPMyr_array = (double*) malloc(ctrl->simyears * sizeof(double));
+		epc->WPMyr_array = (double*) arena_malloc(ctrl->simyears * sizeof(double));
 		if (!epc->WPMyr_array)
 		{
 			printf("ERROR allocating for annual WPM array, epc_init()\n");
@@ -595,7 +595,7 @@ int epc_init(file init, epconst_struct* epc, control_struct* ctrl, int EPCfromIN
 		ndata=0;
 		while (!errorCode && !(dataread = scan_array (WPM_file, &p1, 'i', 0, 0)))
 		{
-			dataread = fscanf(WPM_file.ptr, "%lf%*[^\n]", &p2);
+			dataread = scan_array(WPM_file, &p2, 'd', 1, 0);
 				
 			if (p1 >= ctrl->simstartyear && p1 < ctrl->simstartyear + ctrl->simyears)
 			{
@@ -1178,7 +1178,7 @@ int epc_init(file init, epconst_struct* epc, control_struct* ctrl, int EPCfromIN
 	if (!errorCode && ctrl->varMSC_flag) 
 	{
 		/* allocate space for the annual MSC array */
-		epc->MSC_array = (double*) malloc(ctrl->simyears * sizeof(double));
+		epc->MSC_array = (double*) arena_malloc(ctrl->simyears * sizeof(double));
 		if (!epc->MSC_array)
 		{
 			printf("ERROR allocating for annual MSC array, epc_init()\n");
@@ -1192,7 +1192,7 @@ int epc_init(file init, epconst_struct* epc, control_struct* ctrl, int EPCfromIN
 		ndata=0;
 		while (!errorCode && !(dataread = scan_array (MSC_file, &p1, 'i', 0, 0)))
 		{
-			dataread = fscanf(MSC_file.ptr, "%lf%*[^\n]", &p2);
+			dataread = scan_array(MSC_file, &p2, 'd', 1, 0);
 				
 			if (p1 >= ctrl->simstartyear && p1 < ctrl->simstartyear + ctrl->simyears)
 			{
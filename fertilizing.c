@@ -131,7 +131,7 @@ int fertilizing(const control_struct* ctrl, const siteconst_struct* sitec, const
 			FRZlayer = 0;
 			if (FRZdepth > sitec->soillayer_depth[0])
 			{
-				while (FRZlayer == 0 && layer < N_SOILLAYERS)
+				while (FRZlayer == 0 && layer < sitec->n_soillayers)
 				{
 					if ((FRZdepth > sitec->soillayer_depth[layer-1]) && (FRZdepth <= sitec->soillayer_depth[layer])) FRZlayer = layer;
 					layer += 1;
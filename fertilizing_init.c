@@ -138,8 +138,6 @@ int fertilizing_init(file init, const control_struct* ctrl, fertilizing_struct*
 	
 		while (!errorCode && !(mgmread = scan_array (FRZ_file, &p1, 'i', 0, 0)))
 		{
-			ferttype_array[nmgm] = (char*) malloc(STRINGSIZE * sizeof(char));
-
 			n_FRZparam = 16;
 
 			mgmread = fscanf(FRZ_file.ptr, "%c%d%c%d%s%lf%lf%lf%lf%lf%lf%lf%lf%lf%lf%lf%*[^\n]",
@@ -174,6 +172,7 @@ int fertilizing_init(file init, const control_struct* ctrl, fertilizing_struct*
 				litr_fcel_array[nmgm]   = p13;
 				EFfert_N2O[nmgm]        = p14;
 
+				ferttype_array[nmgm] = (char*) arena_malloc(STRINGSIZE * sizeof(char));
 				strcpy(ferttype_array[nmgm],  ferttype);
 
 				nmgm += 1;
@@ -185,22 +184,22 @@ int fertilizing_init(file init, const control_struct* ctrl, fertilizing_struct*
 		nmgm = 0;
 
 		
-		FRZ->FRZyear_array         = (int*) malloc(FRZ->FRZ_num*sizeof(int));  
-		FRZ->FRZmonth_array        = (int*) malloc(FRZ->FRZ_num*sizeof(int)); 
-		FRZ->FRZday_array          = (int*) malloc(FRZ->FRZ_num*sizeof(int)); 
-		FRZ->FRZdepth_array        = (double*) malloc(FRZ->FRZ_num*sizeof(double)); 
-		FRZ->fertilizer_array      = (double*) malloc(FRZ->FRZ_num*sizeof(double)); 
-		FRZ->DM_array              = (double*) malloc(FRZ->FRZ_num*sizeof(double)); 
-		FRZ->NO3content_array      = (double*) malloc(FRZ->FRZ_num*sizeof(double)); 
-		FRZ->NH4content_array      = (double*) malloc(FRZ->FRZ_num*sizeof(double)); 
-		FRZ->UREAcontent_array     = (double*) malloc(FRZ->FRZ_num*sizeof(double)); 
-		FRZ->orgNcontent_array     = (double*) malloc(FRZ->FRZ_num*sizeof(double));
-		FRZ->orgCcontent_array     = (double*) malloc(FRZ->FRZ_num*sizeof(double)); 
-		FRZ->litr_flab_array       = (double*) malloc(FRZ->FRZ_num*sizeof(double)); 
-		FRZ->litr_fcel_array       = (double*) malloc(FRZ->FRZ_num*sizeof(double)); 
-		FRZ->EFfert_N2O            = (double*) malloc(FRZ->FRZ_num*sizeof(double));
+		FRZ->FRZyear_array         = (int*) arena_malloc(FRZ->FRZ_num*sizeof(int));  
+		FRZ->FRZmonth_array        = (int*) arena_malloc(FRZ->FRZ_num*sizeof(int)); 
+		FRZ->FRZday_array          = (int*) arena_malloc(FRZ->FRZ_num*sizeof(int)); 
+		FRZ->FRZdepth_array        = (double*) arena_malloc(FRZ->FRZ_num*sizeof(double)); 
+		FRZ->fertilizer_array      = (double*) arena_malloc(FRZ->FRZ_num*sizeof(double)); 
+		FRZ->DM_array              = (double*) arena_malloc(FRZ->FRZ_num*sizeof(double)); 
+		FRZ->NO3content_array      = (double*) arena_malloc(FRZ->FRZ_num*sizeof(double)); 
+		FRZ->NH4content_array      = (double*) arena_malloc(FRZ->FRZ_num*sizeof(double)); 
+		FRZ->UREAcontent_array     = (double*) arena_malloc(FRZ->FRZ_num*sizeof(double)); 
+		FRZ->orgNcontent_array     = (double*) arena_malloc(FRZ->FRZ_num*sizeof(double));
+		FRZ->orgCcontent_array     = (double*) arena_malloc(FRZ->FRZ_num*sizeof(double)); 
+		FRZ->litr_flab_array       = (double*) arena_malloc(FRZ->FRZ_num*sizeof(double)); 
+		FRZ->litr_fcel_array       = (double*) arena_malloc(FRZ->FRZ_num*sizeof(double)); 
+		FRZ->EFfert_N2O            = (double*) arena_malloc(FRZ->FRZ_num*sizeof(double));
 		
-		FRZ->ferttype_array        = (char**) malloc(FRZ->FRZ_num * sizeof(char*));
+		FRZ->ferttype_array        = (char**) arena_malloc(FRZ->FRZ_num * sizeof(char*));
 
 		for (nmgm = 0; nmgm < FRZ->FRZ_num; nmgm++)
 		{
@@ -219,8 +218,8 @@ int fertilizing_init(file init, const control_struct* ctrl, fertilizing_struct*
 			FRZ->litr_fcel_array[nmgm]   = litr_fcel_array[nmgm] ;
 			FRZ->EFfert_N2O[nmgm]        = EFfert_N2O[nmgm];
 
-			FRZ->ferttype_array[nmgm] = (char*) malloc(STRINGSIZE * sizeof(char));
-			strcpy(FRZ->ferttype_array[nmgm], ferttype_array[nmgm]);
+			/* the type names are already in the arena */
+			FRZ->ferttype_array[nmgm] = ferttype_array[nmgm];
 		}
 
 		/* close FERTILIZING file  and free temporary memory */
@@ -128,7 +128,7 @@ int firstday(const control_struct* ctrl, const soilprop_struct* sprop, const epc
 	}
 
 	/* initialize multilayer variables (first approximation: field cap.) and multipliers for stomatal limitation calculation */
-	for (layer = 0; layer < N_SOILLAYERS; layer++)
+	for (layer = 0; layer < sitec->n_soillayers; layer++)
 	{
 		epv->VWC[layer]				    = sprop->VWCfc[layer];
 		epv->relVWCsat_fc[layer]	    = 0;
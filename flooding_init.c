@@ -151,13 +151,13 @@ int flooding_init(flooding_struct* FLD, control_struct* ctrl)
 		FLD->FLD_num = nmgm;
 		nmgm = 0;
 	
-		FLD->FLDstart_year_array      = (int*) malloc(FLD->FLD_num*sizeof(double));  
-		FLD->FLDstart_month_array     = (int*) malloc(FLD->FLD_num*sizeof(double)); 
-		FLD->FLDstart_day_array       = (int*) malloc(FLD->FLD_num*sizeof(double)); 
-		FLD->FLDend_year_array        = (int*) malloc(FLD->FLD_num*sizeof(double));  
-		FLD->FLDend_month_array       = (int*) malloc(FLD->FLD_num*sizeof(double)); 
-		FLD->FLDend_day_array         = (int*) malloc(FLD->FLD_num*sizeof(double)); 
-		FLD->FLDheight                = (double*) malloc(FLD->FLD_num*sizeof(double)); 
+		FLD->FLDstart_year_array      = (int*) arena_malloc(FLD->FLD_num*sizeof(double));  
+		FLD->FLDstart_month_array     = (int*) arena_malloc(FLD->FLD_num*sizeof(double)); 
+		FLD->FLDstart_day_array       = (int*) arena_malloc(FLD->FLD_num*sizeof(double)); 
+		FLD->FLDend_year_array        = (int*) arena_malloc(FLD->FLD_num*sizeof(double));  
+		FLD->FLDend_month_array       = (int*) arena_malloc(FLD->FLD_num*sizeof(double)); 
+		FLD->FLDend_day_array         = (int*) arena_malloc(FLD->FLD_num*sizeof(double)); 
+		FLD->FLDheight                = (double*) arena_malloc(FLD->FLD_num*sizeof(double)); 
 
 		for (nmgm = 0; nmgm < FLD->FLD_num; nmgm++)
 		{
@@ -0,0 +1,213 @@
+/*
+fork_init.c
+read the scenario fork settings (branch year, scenario init files, number of threads) and
+prepare the shared prefix run and the scenario runs (the complete state of the simulation is passed in memory)
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_constants.h"
+#include "bgc_io.h"
+
+
+int fork_init(const char* forkname, fork_struct* fork)
+{
+	int errorCode=0;
+	int maxscen=0;
+	file FORK_file;
+	char keyword[STRINGSIZE];
+	char** scen_ini;
+
+	fork->branch_year = DATA_GAP;
+	fork->nthreads    = 0;
+	fork->nscen       = 0;
+	fork->scen_ini    = 0;
+	fork->scen_error  = 0;
+	fork->simstartyear = DATA_GAP;
+	fork->state       = 0;
+	memset(&fork->epc, 0, sizeof(epconst_struct));
+
+	strcpy(FORK_file.name, forkname);
+	if (file_open(&FORK_file,'i',1))
+	{
+		printf("ERROR opening fork file: %s\n", forkname);
+		return (221);
+	}
+
+	/* the file consists of keyword-blocks, the order of the blocks is arbitrary */
+	while (!errorCode && !scan_array(FORK_file, keyword, 's', 1, 0))
+	{
+		/* BRANCH_YEAR block: first simulation year of the scenarios */
+		if (!strcmp(keyword, "BRANCH_YEAR"))
+		{
+			if (!errorCode && scan_value(FORK_file, &fork->branch_year, 'i'))
+			{
+				printf("ERROR reading branch year: fork_init()\n");
+				errorCode=22101;
+			}
+		}
+		/* THREADS block: number of parallel scenario runs (0: all available processors) */
+		else if (!strcmp(keyword, "THREADS"))
+		{
+			if (!errorCode && scan_value(FORK_file, &fork->nthreads, 'i'))
+			{
+				printf("ERROR reading number of threads: fork_init()\n");
+				errorCode=22102;
+			}
+		}
+		/* SCENARIO block: main init file of the scenario (with its own output prefix) */
+		else if (!strcmp(keyword, "SCENARIO"))
+		{
+			if (fork->nscen == maxscen)
+			{
+				maxscen = maxscen ? 2*maxscen : 8;
+				scen_ini = (char**) realloc(fork->scen_ini, maxscen*sizeof(char*));
+				if (!scen_ini)
+				{
+					printf("ERROR allocating for scenario names: fork_init()\n");
+					errorCode=22103;
+				}
+				else
+					fork->scen_ini = scen_ini;
+			}
+			if (!errorCode)
+			{
+				fork->scen_ini[fork->nscen] = (char*) malloc(FILENAMESIZE*sizeof(char));
+				if (!fork->scen_ini[fork->nscen])
+				{
+					printf("ERROR allocating for scenario names: fork_init()\n");
+					errorCode=22103;
+				}
+			}
+			if (!errorCode && scan_value(FORK_file, fork->scen_ini[fork->nscen], 's'))
+			{
+				printf("ERROR reading init file of scenario: fork_init()\n");
+				free(fork->scen_ini[fork->nscen]);
+				errorCode=22104;
+			}
+			if (!errorCode) fork->nscen += 1;
+		}
+		else
+		{
+			printf("ERROR in fork file: unknown keyword --> %s\n", keyword);
+			errorCode=221;
+		}
+	}
+
+	fclose(FORK_file.ptr);
+
+	if (!errorCode && fork->branch_year == DATA_GAP)
+	{
+		printf("ERROR in fork file: BRANCH_YEAR block is missing\n");
+		errorCode=22105;
+	}
+
+	if (!errorCode && fork->nscen == 0)
+	{
+		printf("ERROR in fork file: no SCENARIO block is found\n");
+		errorCode=22106;
+	}
+
+	if (!errorCode && fork->nthreads < 0)
+	{
+		printf("ERROR in fork file: number of threads must be non-negative\n");
+		errorCode=22107;
+	}
+
+	if (!errorCode)
+	{
+		fork->scen_error = (int*) calloc(fork->nscen, sizeof(int));
+		fork->state      = (resimstate_struct*) malloc(sizeof(resimstate_struct));
+		if (!fork->scen_error || !fork->state)
+		{
+			printf("ERROR allocating for scenario error codes and state of prefix run: fork_init()\n");
+			errorCode=22103;
+		}
+	}
+
+	return (errorCode);
+}
+
+
+static void fork_epc(const epconst_struct* epc, epconst_struct* copy)
+{
+	/* EPC without the yearly arrays (they belong to the run) */
+	*copy = *epc;
+	copy->SGS_array   = 0;
+	copy->EGS_array   = 0;
+	copy->FMyr_array  = 0;
+	copy->WPMyr_array = 0;
+	copy->MSC_array   = 0;
+}
+
+
+int fork_prepare(fork_struct* fork, int scenario, control_struct* ctrl, const epconst_struct* epc, resim_struct* RSM)
+{
+	/* the input arrays of both runs are built for the whole simulation period of the init file (running averages, CO2 and
+	   N-deposition of the years); prefix run (scenario < 0): from the first simulation year until the end of the year before
+	   the branch year, its end state is kept in memory; scenario runs: continued from that state until the last simulation
+	   year of the scenario init file (outputs from the branch year). The scenario init files describe the whole period:
+	   the inputs before the branch year (e.g. management events) are the same as in the prefix run. */
+	int errorCode=0;
+	epconst_struct epc_act;
+
+	if (ctrl->spinup != 0)
+	{
+		printf("ERROR in fork mode: the init files must define normal runs (spinup flag: 0)\n");
+		errorCode=1;
+	}
+
+	if (!errorCode && (fork->branch_year <= ctrl->simstartyear || fork->branch_year >= ctrl->simstartyear + ctrl->simyears))
+	{
+		printf("ERROR in fork mode: branch year (%i) must be after the first and not after the last simulation year (%i-%i)\n",
+			   fork->branch_year, ctrl->simstartyear, ctrl->simstartyear + ctrl->simyears - 1);
+		errorCode=1;
+	}
+
+	if (!errorCode && scenario >= 0 && ctrl->simstartyear != fork->simstartyear)
+	{
+		printf("ERROR in fork mode: first simulation year of the scenario (%i) differs from that of the prefix run (%i)\n",
+			   ctrl->simstartyear, fork->simstartyear);
+		errorCode=1;
+	}
+
+	/* incremental re-simulation and parallel-in-time execution continue their own states */
+	if (!errorCode && RSM->flag)
+	{
+		printf("ERROR in fork mode: incremental re-simulation is not available in the prefix and scenario runs\n");
+		errorCode=1;
+	}
+
+	if (!errorCode)
+	{
+		RSM->state = fork->state;
+		if (scenario < 0)
+		{
+			fork->simstartyear = ctrl->simstartyear;
+			fork_epc(epc, &fork->epc);
+			ctrl->simyears     = fork->branch_year - ctrl->simstartyear;
+			RSM->stop_simyr    = ctrl->simyears - 1;
+		}
+		else
+		{
+			/* a scenario with its own EPC continues with it, otherwise with the EPC of the state (e.g. of a planting) */
+			fork_epc(epc, &epc_act);
+			RSM->start_simyr = fork->branch_year - ctrl->simstartyear;
+			RSM->fork_flag   = memcmp(&epc_act, &fork->epc, sizeof(epconst_struct)) ? 2 : 1;
+		}
+	}
+
+	return (errorCode);
+}
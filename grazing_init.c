@@ -184,25 +184,25 @@ int grazing_init(file init, const control_struct* ctrl, grazing_struct* GRZ)
 		nmgm = 0;
 
 		
-		GRZ->GRZstart_year_array       = (int*) malloc(GRZ->GRZ_num*sizeof(double));  
-		GRZ->GRZstart_month_array      = (int*) malloc(GRZ->GRZ_num*sizeof(double)); 
-		GRZ->GRZstart_day_array        = (int*) malloc(GRZ->GRZ_num*sizeof(double)); 
-		GRZ->GRZend_year_array         = (int*) malloc(GRZ->GRZ_num*sizeof(double));  
-		GRZ->GRZend_month_array        = (int*) malloc(GRZ->GRZ_num*sizeof(double)); 
-		GRZ->GRZend_day_array          = (int*) malloc(GRZ->GRZ_num*sizeof(double)); 
-		GRZ->trampling_effect          = (double*) malloc(GRZ->GRZ_num*sizeof(double)); 
-		GRZ->weight_LSU                = (double*) malloc(GRZ->GRZ_num*sizeof(double)); 
-		GRZ->stocking_rate_array       = (double*) malloc(GRZ->GRZ_num*sizeof(double)); 
-		GRZ->DMintake_array            = (double*) malloc(GRZ->GRZ_num*sizeof(double));
-		GRZ->DMintake2excr_array       = (double*) malloc(GRZ->GRZ_num*sizeof(double)); 
-		GRZ->excr2litter_array         = (double*) malloc(GRZ->GRZ_num*sizeof(double)); 
-		GRZ->DM_Ccontent_array         = (double*) malloc(GRZ->GRZ_num*sizeof(double)); 
-		GRZ->EXCR_Ncontent_array       = (double*) malloc(GRZ->GRZ_num*sizeof(double));
-		GRZ->EXCR_Ccontent_array       = (double*) malloc(GRZ->GRZ_num*sizeof(double)); 
-		GRZ->Nexrate                   = (double*) malloc(GRZ->GRZ_num*sizeof(double)); 
-		GRZ->EFman_N2O                 = (double*) malloc(GRZ->GRZ_num*sizeof(double)); 
-		GRZ->EFman_CH4                 = (double*) malloc(GRZ->GRZ_num*sizeof(double));
-		GRZ->EFfer_CH4                 = (double*) malloc(GRZ->GRZ_num*sizeof(double));
+		GRZ->GRZstart_year_array       = (int*) arena_malloc(GRZ->GRZ_num*sizeof(double));  
+		GRZ->GRZstart_month_array      = (int*) arena_malloc(GRZ->GRZ_num*sizeof(double)); 
+		GRZ->GRZstart_day_array        = (int*) arena_malloc(GRZ->GRZ_num*sizeof(double)); 
+		GRZ->GRZend_year_array         = (int*) arena_malloc(GRZ->GRZ_num*sizeof(double));  
+		GRZ->GRZend_month_array        = (int*) arena_malloc(GRZ->GRZ_num*sizeof(double)); 
+		GRZ->GRZend_day_array          = (int*) arena_malloc(GRZ->GRZ_num*sizeof(double)); 
+		GRZ->trampling_effect          = (double*) arena_malloc(GRZ->GRZ_num*sizeof(double)); 
+		GRZ->weight_LSU                = (double*) arena_malloc(GRZ->GRZ_num*sizeof(double)); 
+		GRZ->stocking_rate_array       = (double*) arena_malloc(GRZ->GRZ_num*sizeof(double)); 
+		GRZ->DMintake_array            = (double*) arena_malloc(GRZ->GRZ_num*sizeof(double));
+		GRZ->DMintake2excr_array       = (double*) arena_malloc(GRZ->GRZ_num*sizeof(double)); 
+		GRZ->excr2litter_array         = (double*) arena_malloc(GRZ->GRZ_num*sizeof(double)); 
+		GRZ->DM_Ccontent_array         = (double*) arena_malloc(GRZ->GRZ_num*sizeof(double)); 
+		GRZ->EXCR_Ncontent_array       = (double*) arena_malloc(GRZ->GRZ_num*sizeof(double));
+		GRZ->EXCR_Ccontent_array       = (double*) arena_malloc(GRZ->GRZ_num*sizeof(double)); 
+		GRZ->Nexrate                   = (double*) arena_malloc(GRZ->GRZ_num*sizeof(double)); 
+		GRZ->EFman_N2O                 = (double*) arena_malloc(GRZ->GRZ_num*sizeof(double)); 
+		GRZ->EFman_CH4                 = (double*) arena_malloc(GRZ->GRZ_num*sizeof(double));
+		GRZ->EFfer_CH4                 = (double*) arena_malloc(GRZ->GRZ_num*sizeof(double));
 
 		for (nmgm = 0; nmgm < GRZ->GRZ_num; nmgm++)
 		{
@@ -34,7 +34,7 @@ int groundwaterR_postproc(const siteconst_struct* sitec,  epvar_struct* epv, wst
 
 	/* calculation of soillayer thickness, soilw, rootlength proportion in GWC arrays */
 	layerGWC = 0;
-	for (layer = 0; layer < N_SOILLAYERS; layer++)
+	for (layer = 0; layer < sitec->n_soillayers; layer++)
 	{
 		
 		/* same bottom layer */
@@ -57,7 +57,7 @@ int groundwaterR_postproc(const siteconst_struct* sitec,  epvar_struct* epv, wst
 			soilwTRPdemand_act=0;
 			GWrecharge_act=0;
 			GWdischarge_act=0;
-			while (sitec->soillayer_depth[layer] >= gwc->soillayer_depthGWC[layerGWC] && layerGWC < N_SOILLAYERS_GWC)
+			while (sitec->soillayer_depth[layer] >= gwc->soillayer_depthGWC[layerGWC] && layerGWC < sitec->n_soillayers+2)
 			{
 				soilw_act             += gwc->soilw_GWC[layerGWC];
 				soilwFlux_act         = gwc->soilwFlux_GWC[layerGWC];
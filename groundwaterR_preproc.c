@@ -63,7 +63,7 @@ int groundwaterR_preproc(const control_struct* ctrl, const siteconst_struct* sit
 	{
 		/* 2. define GWlayer and actual CF */
 		/* lower and upper boundary of the laye */
-		layer = N_SOILLAYERS-1;
+		layer = sitec->n_soillayers-1;
 		while (GWlayer == DATA_GAP && layer >=0)
 		{
 			GWboundL = sitec->soillayer_depth[layer];
@@ -73,13 +73,13 @@ int groundwaterR_preproc(const control_struct* ctrl, const siteconst_struct* sit
 				GWboundU  = sitec->soillayer_depth[layer-1];
 				
 			/* if groundwater table is in actual layer (above lower boundary): GWlayer   */
-			if ((sprop->GWD >= sitec->soillayer_depth[N_SOILLAYERS-1]) || (sprop->GWD < GWboundL && sprop->GWD >= GWboundU)) 
+			if ((sprop->GWD >= sitec->soillayer_depth[sitec->n_soillayers-1]) || (sprop->GWD < GWboundL && sprop->GWD >= GWboundU)) 
 			{
 				/* if GW-table is under 10 meter */
-				if (sprop->GWD >= sitec->soillayer_depth[N_SOILLAYERS-1])
+				if (sprop->GWD >= sitec->soillayer_depth[sitec->n_soillayers-1])
 				{
-					GWlayer=N_SOILLAYERS;
-					CFact=sprop->CapillFringe[N_SOILLAYERS-1];
+					GWlayer=sitec->n_soillayers;
+					CFact=sprop->CapillFringe[sitec->n_soillayers-1];
 				}
 				else
 				{
@@ -126,7 +126,7 @@ int groundwaterR_preproc(const control_struct* ctrl, const siteconst_struct* sit
 				{
 					CFlayer = layer;
 					sprop->CFD = sprop->GWD - CFact;
-					if (sprop->CFD > sitec->soillayer_depth[N_SOILLAYERS-1]) CFlayer = N_SOILLAYERS;
+					if (sprop->CFD > sitec->soillayer_depth[sitec->n_soillayers-1]) CFlayer = sitec->n_soillayers;
 
 				}
 
@@ -146,8 +146,8 @@ int groundwaterR_preproc(const control_struct* ctrl, const siteconst_struct* sit
 		sprop->GWlayer=(double) GWlayer;
 
 		/* 3.  calculation of VWC and soil properties */
-		layerGWC = N_SOILLAYERS_GWC-1;
-		layer=N_SOILLAYERS-1;
+		layerGWC = sitec->n_soillayers+1;
+		layer=sitec->n_soillayers-1;
 		while (layerGWC>=0)
 		{
 			GWboundL = sitec->soillayer_depth[layer];
@@ -285,7 +285,7 @@ int groundwaterR_preproc(const control_struct* ctrl, const siteconst_struct* sit
 		
 		/* 4. calculation of soillayer thickness, soilw in GWC arrays */
 		layer = 0;
-		for (layerGWC = 0; layerGWC < N_SOILLAYERS_GWC; layerGWC++)
+		for (layerGWC = 0; layerGWC < sitec->n_soillayers+2; layerGWC++)
 		{
 			if (layerGWC > 0) 
 				gwc->soillayer_thicknessGWC[layerGWC] = gwc->soillayer_depthGWC[layerGWC] - gwc->soillayer_depthGWC[layerGWC-1];
@@ -349,7 +349,7 @@ int groundwaterR_preproc(const control_struct* ctrl, const siteconst_struct* sit
 		sprop->GWlayer=DATA_GAP;
 		sprop->CFlayer=DATA_GAP;
 
-		for (layer = 0; layer < 8; layer++) 
+		for (layer = 0; layer < sitec->n_soillayers-2; layer++) 
 		{
 			gwc->soillayer_depthGWC[layer]     = sitec->soillayer_depth[layer];
 			gwc->VWC_GWC[layer]                = epv->VWC[layer];
@@ -365,7 +365,8 @@ int groundwaterR_preproc(const control_struct* ctrl, const siteconst_struct* sit
 			gwc->rootlengthProp_GWC[layer]     = epv->rootlengthProp[layer];
 		}
 		
-		for (layerGWC = 8; layerGWC < N_SOILLAYERS_GWC; layerGWC++) 
+		/* the two deepest soil layers are halved (in case of 10 layers: 2-3 m, 3-4 m, 4-7 m and 7-10 m) */
+		for (layerGWC = sitec->n_soillayers-2; layerGWC < sitec->n_soillayers+2; layerGWC++) 
 		{
 
 			gwc->VWC_GWC[layerGWC]						= epv->VWC[layer];
@@ -378,16 +379,16 @@ int groundwaterR_preproc(const control_struct* ctrl, const siteconst_struct* sit
 			gwc->HYDROflag[layerGWC]					= 0;
 			ratio                                       = 1;
 			
-			if (layerGWC == 8)
+			if (layerGWC == sitec->n_soillayers-2 || layerGWC == sitec->n_soillayers)
 			{
-				gwc->soillayer_depthGWC[layerGWC]       = 3;
-				gwc->soillayer_thicknessGWC[layerGWC]   = 1;
+				gwc->soillayer_thicknessGWC[layerGWC]   = sitec->soillayer_thickness[layer] / 2.;
+				gwc->soillayer_depthGWC[layerGWC]       = sitec->soillayer_depth[layer] - gwc->soillayer_thicknessGWC[layerGWC];
 				ratio                                   = gwc->soillayer_thicknessGWC[layerGWC]/sitec->soillayer_thickness[layer];
 				gwc->soilw_GWC[layerGWC]				= ws->soilw[layer] * ratio;
 				gwc->rootlengthProp_GWC[layerGWC]		= epv->rootlengthProp[layer] * ratio;
 			}
 
-			if (layerGWC == 9 || layerGWC == 11)
+			if (layerGWC == sitec->n_soillayers-1 || layerGWC == sitec->n_soillayers+1)
 			{
 				gwc->soillayer_depthGWC[layerGWC]       = sitec->soillayer_depth[layer];
 				gwc->soillayer_thicknessGWC[layerGWC]   = gwc->soillayer_depthGWC[layerGWC] - gwc->soillayer_depthGWC[layerGWC-1];
@@ -397,14 +398,6 @@ int groundwaterR_preproc(const control_struct* ctrl, const siteconst_struct* sit
 				layer                                  += 1;
 			}
 			
-			if (layerGWC == 10)
-			{
-				gwc->soillayer_depthGWC[layerGWC]       = 7;
-				gwc->soillayer_thicknessGWC[layerGWC]   = 3;
-				ratio                                   = gwc->soillayer_thicknessGWC[layerGWC]/sitec->soillayer_thickness[layer];
-				gwc->soilw_GWC[layerGWC]				= ws->soilw[layer] * ratio;
-				gwc->rootlengthProp_GWC[layerGWC]		= epv->rootlengthProp[layer] * ratio;
-			}
 
 			
 		
@@ -415,7 +408,7 @@ int groundwaterR_preproc(const control_struct* ctrl, const siteconst_struct* sit
 
 	/* calculation of rootlength proportion */
 	layer = 0;
-	for (layerGWC = 0; layerGWC < N_SOILLAYERS_GWC; layerGWC++)
+	for (layerGWC = 0; layerGWC < sitec->n_soillayers+2; layerGWC++)
 	{
 		/* 4.1. same bottom layer */
 		if (sitec->soillayer_depth[layer] == gwc->soillayer_depthGWC[layerGWC])
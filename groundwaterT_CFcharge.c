@@ -39,7 +39,7 @@ int groundwaterT_CFcharge(const siteconst_struct* sitec, soilprop_struct* sprop,
 	if (GWS->GWD_num)
 	{
 		/* if GW and CF are in the same layer, GW-zone fills the capillary zone in the same layer - special diffusion routine */
-		if (GWlayer < N_SOILLAYERS && sprop->GWD != sitec->soillayer_depth[GWlayer-1] && sprop->GWD > sprop->CFD)
+		if (GWlayer < sitec->n_soillayers && sprop->GWD != sitec->soillayer_depth[GWlayer-1] && sprop->GWD > sprop->CFD)
 		{
 
 			/* capillary zone is from GW to CF, the VWC can be calculated from the saturated GW part and the averaged out value */
@@ -102,7 +102,7 @@ int groundwaterT_CFcharge(const siteconst_struct* sitec, soilprop_struct* sprop,
 		}
 
 		/*  if GW is below 10, but CF is in the bottom layer, GW-zone fills the capillary zone  - special diffusion routine */
-		if (sprop->GWlayer == N_SOILLAYERS && sprop->CFlayer == N_SOILLAYERS-1)
+		if (sprop->GWlayer == sitec->n_soillayers && sprop->CFlayer == sitec->n_soillayers-1)
 		{
 			
 			/* capillary zone is from depth of soil system to CF, the VWC can be calculated from the saturated GW part and the averaged out value */
@@ -43,7 +43,7 @@ int groundwaterT_preproc(const control_struct* ctrl, const epconst_struct* epc,
 	/*------------------------------------*/
 	/* I. relative soil water content (SAT-FCbase) */
 
-	for (layer=0; layer < N_SOILLAYERS; layer++)
+	for (layer=0; layer < sitec->n_soillayers; layer++)
 	{
 		
 		/* 1. relative soil water content (SAT-FCbase) */
@@ -77,7 +77,7 @@ int groundwaterT_preproc(const control_struct* ctrl, const epconst_struct* epc,
 		else
 		{
 			sprop->GWD = 100;
-			for (layer = 0; layer < N_SOILLAYERS; layer++) sprop->VWCfc[layer] = sprop->VWCfc_base[layer];
+			for (layer = 0; layer < sitec->n_soillayers; layer++) sprop->VWCfc[layer] = sprop->VWCfc_base[layer];
 		}
 
 		/*-----------------------------------------------------------------------------*/
@@ -86,10 +86,10 @@ int groundwaterT_preproc(const control_struct* ctrl, const epconst_struct* epc,
 		if (sprop->GWD != sprop->preGWD)
 		{
 			/* new calculation of GW-eff */
-			for (layer = 0; layer<N_SOILLAYERS; layer++) sprop->GWeff[layer] = DATA_GAP;
+			for (layer = 0; layer<sitec->n_soillayers; layer++) sprop->GWeff[layer] = DATA_GAP;
 
 			/* lower and upper boundary of the laye */
-			layer = N_SOILLAYERS-1;
+			layer = sitec->n_soillayers-1;
 			while (GWlayer == DATA_GAP && layer >=0)
 			{
 				GWboundL = sitec->soillayer_depth[layer];
@@ -99,13 +99,13 @@ int groundwaterT_preproc(const control_struct* ctrl, const epconst_struct* epc,
 					GWboundU  = sitec->soillayer_depth[layer-1];
 				
 				/* if groundwater table is in actual layer (above lower boundary): GWlayer   */
-				if (sprop->GWD >= sitec->soillayer_depth[N_SOILLAYERS-1] || (sprop->GWD < GWboundL && sprop->GWD >= GWboundU)) 
+				if (sprop->GWD >= sitec->soillayer_depth[sitec->n_soillayers-1] || (sprop->GWD < GWboundL && sprop->GWD >= GWboundU)) 
 				{
 					/* if GW-table is under 10 meter */
-					if (sprop->GWD >= sitec->soillayer_depth[N_SOILLAYERS-1])
+					if (sprop->GWD >= sitec->soillayer_depth[sitec->n_soillayers-1])
 					{
-						GWlayer=N_SOILLAYERS;
-						CFact=sprop->CapillFringe[N_SOILLAYERS-1];
+						GWlayer=sitec->n_soillayers;
+						CFact=sprop->CapillFringe[sitec->n_soillayers-1];
 					}
 					else
 					{
@@ -151,7 +151,7 @@ int groundwaterT_preproc(const control_struct* ctrl, const epconst_struct* epc,
 					{
 						CFlayer = layer;
 						sprop->CFD = sprop->GWD - CFact;
-						if (sprop->CFD >= sitec->soillayer_depth[N_SOILLAYERS-1]) CFlayer = N_SOILLAYERS;
+						if (sprop->CFD >= sitec->soillayer_depth[sitec->n_soillayers-1]) CFlayer = sitec->n_soillayers;
 
 					}
 
@@ -172,7 +172,7 @@ int groundwaterT_preproc(const control_struct* ctrl, const epconst_struct* epc,
 
 		
 			/* 4. soil layers below the groundwater table are saturated - net water gain from soil system */
-			for (layer = N_SOILLAYERS-1; layer >= 0; layer--)
+			for (layer = sitec->n_soillayers-1; layer >= 0; layer--)
 			{
 				GWboundL = sitec->soillayer_depth[layer];
 			
@@ -295,7 +295,7 @@ int groundwaterT_preproc(const control_struct* ctrl, const epconst_struct* epc,
 		
 		for (layer = GWlayer-1; layer >= CFlayer; layer--)
 		{	
-			if (layer < N_SOILLAYERS-1 && (sprop->VWCsat[layer+1] - epv->VWC[layer+1]) > CRIT_PRECwater)
+			if (layer < sitec->n_soillayers-1 && (sprop->VWCsat[layer+1] - epv->VWC[layer+1]) > CRIT_PRECwater)
 			{
 				sprop->CFeff[layer] = -1;
 				sprop->VWCfc[layer] = sprop->VWCfc_base[layer];
@@ -315,7 +315,7 @@ int groundwaterT_preproc(const control_struct* ctrl, const epconst_struct* epc,
 	/*------------------------------------*/
 	/* III. relative soil water content (FC-WP) */
 
-	for (layer=0; layer < N_SOILLAYERS; layer++)
+	for (layer=0; layer < sitec->n_soillayers; layer++)
 	{
 		
 		if (sprop->VWCfc[layer] - sprop->VWCwp[layer] > CRIT_PRECwater)
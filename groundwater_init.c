@@ -130,10 +130,10 @@ int groundwater_init(groundwater_struct* GWS, control_struct* ctrl)
 		GWS->GWD_num = nmgm;
 		nmgm = 0;
 	
-		GWS->GWyear_array      = (int*) malloc(GWS->GWD_num*sizeof(double));  
-		GWS->GWmonth_array     = (int*) malloc(GWS->GWD_num*sizeof(double)); 
-		GWS->GWday_array       = (int*) malloc(GWS->GWD_num*sizeof(double)); 
-		GWS->GWdepth_array  = (double*) malloc(GWS->GWD_num*sizeof(double)); 
+		GWS->GWyear_array      = (int*) arena_malloc(GWS->GWD_num*sizeof(double));  
+		GWS->GWmonth_array     = (int*) arena_malloc(GWS->GWD_num*sizeof(double)); 
+		GWS->GWday_array       = (int*) arena_malloc(GWS->GWD_num*sizeof(double)); 
+		GWS->GWdepth_array  = (double*) arena_malloc(GWS->GWD_num*sizeof(double)); 
 
 		for (nmgm = 0; nmgm < GWS->GWD_num; nmgm++)
 		{
@@ -137,11 +137,11 @@ int harvesting_init(file init, const control_struct* ctrl, harvesting_struct* HR
 		nmgm = 0;
 			
 		
-		HRV->HRVyear_array         = (int*) malloc(HRV->HRV_num*sizeof(double));  
-		HRV->HRVmonth_array        = (int*) malloc(HRV->HRV_num*sizeof(double)); 
-		HRV->HRVday_array          = (int*) malloc(HRV->HRV_num*sizeof(double)); 
-		HRV->snagprop_array        = (double*) malloc(HRV->HRV_num*sizeof(double)); 
-		HRV->transportHRV_array    = (double*) malloc(HRV->HRV_num*sizeof(double)); 
+		HRV->HRVyear_array         = (int*) arena_malloc(HRV->HRV_num*sizeof(double));  
+		HRV->HRVmonth_array        = (int*) arena_malloc(HRV->HRV_num*sizeof(double)); 
+		HRV->HRVday_array          = (int*) arena_malloc(HRV->HRV_num*sizeof(double)); 
+		HRV->snagprop_array        = (double*) arena_malloc(HRV->HRV_num*sizeof(double)); 
+		HRV->transportHRV_array    = (double*) arena_malloc(HRV->HRV_num*sizeof(double)); 
 
 		for (nmgm = 0; nmgm < HRV->HRV_num; nmgm++)
 		{		
@@ -48,7 +48,7 @@ int infiltANDpond(siteconst_struct* sitec, soilprop_struct* sprop, epvar_struct*
 	soilwEXTRA = (sprop->VWCsat[0] - epv->VWC[0]) * sitec->soillayer_thickness[0] * water_density;
 	if (soilwEXTRA < CRIT_PRECwater) soilwEXTRA = 0;
 
-	while (flagEXTRA == 0 && layer < N_SOILLAYERS-1)
+	while (flagEXTRA == 0 && layer < sitec->n_soillayers-1)
 	{
 		if (soilw_dist > sitec->soillayer_depth[layer])
 			soilwEXTRA += (sprop->VWCsat[layer+1] - epv->VWC[layer+1]) * sitec->soillayer_thickness[layer+1] * water_density;
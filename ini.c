@@ -14,10 +14,39 @@ See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentatio
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <limits.h>
 
 #include "ini.h"
 #include "bgc_constants.h"
 
+/* string substitutions of the calling thread (jobs of the simulation server): a string value read from
+   an input file (e.g. name of the EPC file or output prefix) which equals from[i] is replaced by to[i] */
+static int subst_n = 0;
+static char (*subst_from)[FILENAMESIZE] = NULL;
+static char (*subst_to)[FILENAMESIZE] = NULL;
+#pragma omp threadprivate(subst_n, subst_from, subst_to)
+
+/* output files of the calling thread are written into temporary files (runs of the sensitivity analysis) */
+static int discard_flag = 0;
+#pragma omp threadprivate(discard_flag)
+
+int file_substitution (int n, char (*from)[FILENAMESIZE], char (*to)[FILENAMESIZE])
+{
+	subst_n    = n;
+	subst_from = from;
+	subst_to   = to;
+
+	return (0);
+}
+
+int file_discard (int flag)
+{
+	discard_flag = flag;
+
+	return (0);
+}
+
 /* file_open() is the generic file opening routine using the file structure
 defined above */
 int file_open (file *target, char mode, int errormessage)
@@ -27,9 +56,33 @@ int file_open (file *target, char mode, int errormessage)
 	'j' for read ascii without error message
     'w' for write binary
     'o' for write ascii
+	'a' for append ascii
 */
 {
 	int errorCode=0;
+
+	/* registered inputs (in-memory buffers, memory-mapped files, archive members) are read from the memory */
+	if ((mode == 'r' || mode == 'i' || mode == 'j') && !input_provider_open(target->name, &target->ptr, NULL))
+	{
+		if (target->ptr == NULL)
+		{
+			if (errormessage) printf("Can't open %s for read from memory\n",target->name);
+			errorCode=1;
+		}
+		return(errorCode);
+	}
+
+	/* discarded outputs: temporary file, which is deleted when it is closed */
+	if ((mode == 'w' || mode == 'o' || mode == 'a') && discard_flag)
+	{
+		if ((target->ptr = tmpfile()) == NULL)
+		{
+			if (errormessage) printf("Can't open temporary file instead of %s\n",target->name);
+			errorCode=1;
+		}
+		return(errorCode);
+	}
+
 	switch (mode)
 	{
         case 'r':
@@ -70,6 +123,13 @@ int file_open (file *target, char mode, int errormessage)
             }
             break;
 
+        case 'a':
+            if ((target->ptr = fopen(target->name,"a")) == NULL)
+            {
+                if (errormessage) printf("Can't open %s for ascii append\n",target->name);
+                errorCode=1;
+            }
+            break;
         default:
             printf("Invalid mode specification for file_open ... Exiting\n");
             errorCode=1;
@@ -77,6 +137,250 @@ int file_open (file *target, char mode, int errormessage)
     return(errorCode);
 }
 
+/* tokenizer of scan_array(): the characters are taken from the buffer of the stream without locking and the numbers
+   are converted without the locale-aware scanf machinery; the accepted characters and the values are the same as those
+   of fscanf() with the formats "%d", "%lf" and "%s" (the rest of the line is skipped as by "%*[^\n]") */
+#if defined(_MSC_VER)
+#define SCAN_GETC(f) _getc_nolock(f)
+#elif defined(_WIN32)
+#define SCAN_GETC(f) getc(f)
+#else
+#define SCAN_GETC(f) getc_unlocked(f)
+#endif
+
+#define SCAN_NUMSIZE 512				/* maximal stored length of a number */
+#define SCAN_MAXDIGITS 19				/* significant digits of an exactly converted number */
+#define SCAN_ISDIGIT(c) ((c) >= '0' && (c) <= '9')
+#define SCAN_ISSPACE(c) ((c) == ' ' || (c) == '\t' || (c) == '\n' || (c) == '\v' || (c) == '\f' || (c) == '\r')
+
+/* powers of ten which are exact in double precision */
+static const double scan_pow10[23] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16,
+                                      1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+
+double scan_strtod(const char* str, char** endptr)
+{
+	/* locale-independent strtod(): decimal numbers with at most 19 significant digits and a decimal exponent within +-22
+	   are converted by one correctly rounded multiplication or division (the result of strtod()), the others by strtod() */
+	const char* p = str;
+	int neg=0, ndigit=0, nmant=0, exp10=0, expval=0, expneg=0;
+	unsigned long long mant=0;
+	double value;
+
+	while (SCAN_ISSPACE(*p)) p++;
+	if (*p == '+' || *p == '-') neg = (*p++ == '-');
+	if (*p == '0' && (p[1] == 'x' || p[1] == 'X')) return (strtod(str, endptr));
+
+	for (; SCAN_ISDIGIT(*p); p++)
+	{
+		ndigit++;
+		if (mant || *p != '0') nmant++;
+		if (nmant > SCAN_MAXDIGITS) return (strtod(str, endptr));
+		mant = mant * 10 + (*p - '0');
+	}
+	if (*p == '.')
+	{
+		for (p++; SCAN_ISDIGIT(*p); p++)
+		{
+			ndigit++;
+			if (mant || *p != '0') nmant++;
+			if (nmant > SCAN_MAXDIGITS) return (strtod(str, endptr));
+			mant = mant * 10 + (*p - '0');
+			exp10--;
+		}
+	}
+
+	/* no digits: infinity, not-a-number or no conversion */
+	if (!ndigit) return (strtod(str, endptr));
+
+	/* the exponent belongs to the number only if it has digits */
+	if ((*p == 'e' || *p == 'E') && (SCAN_ISDIGIT(p[1]) || ((p[1] == '+' || p[1] == '-') && SCAN_ISDIGIT(p[2]))))
+	{
+		p++;
+		if (*p == '+' || *p == '-') expneg = (*p++ == '-');
+		for (; SCAN_ISDIGIT(*p); p++)
+		{
+			if (expval < 100000) expval = expval * 10 + (*p - '0');
+		}
+		exp10 += expneg ? -expval : expval;
+	}
+
+	if (mant == 0)
+		value = 0;
+	else if (mant <= (1ULL << 53) && exp10 >= -22 && exp10 <= 22)
+		value = (exp10 < 0) ? (double) mant / scan_pow10[-exp10] : (double) mant * scan_pow10[exp10];
+	else
+		return (strtod(str, endptr));
+
+	if (endptr) *endptr = (char*) p;
+
+	return (neg ? -value : value);
+}
+
+
+/* first character after the whitespace */
+static int scan_skipspace(FILE* f)
+{
+	int c;
+
+	do c = SCAN_GETC(f); while (SCAN_ISSPACE(c));
+
+	return (c);
+}
+
+
+/* the return values of the readers are those of fscanf(): 1 (converted), 0 (no conversion) or EOF (end of input) */
+static int scan_int(FILE* f, int* var)
+{
+	int c, neg=0, overflow=0;
+	unsigned long long value=0, limit;
+	long result;
+
+	if ((c = scan_skipspace(f)) == EOF) return (EOF);
+
+	if (c == '+' || c == '-')
+	{
+		neg = (c == '-');
+		c = SCAN_GETC(f);
+	}
+	if (!SCAN_ISDIGIT(c))
+	{
+		if (c != EOF) ungetc(c, f);
+		return (0);
+	}
+	for (; SCAN_ISDIGIT(c); c = SCAN_GETC(f))
+	{
+		if (value > (ULLONG_MAX - 9) / 10) overflow = 1;
+		if (!overflow) value = value * 10 + (c - '0');
+	}
+	if (c != EOF) ungetc(c, f);
+
+	/* out-of-range values are saturated to the range of long, then converted to int (as by fscanf()) */
+	limit = neg ? (unsigned long long) LONG_MAX + 1 : (unsigned long long) LONG_MAX;
+	if (overflow || value > limit)
+		result = neg ? LONG_MIN : LONG_MAX;
+	else if (neg)
+		result = (value == limit) ? LONG_MIN : -(long) value;
+	else
+		result = (long) value;
+
+	*var = (int) result;
+
+	return (1);
+}
+
+
+static int scan_double(FILE* f, double* var)
+{
+	/* the characters of the number are collected as by fscanf() (the exponent character is consumed even without
+	   exponent digits), then converted by scan_strtod() */
+	char num[SCAN_NUMSIZE];
+	char* end;
+	double value;
+	int c, n=0, ndigit=0;
+
+	if ((c = scan_skipspace(f)) == EOF) return (EOF);
+
+	#define SCAN_STORE(ch) { if (n < SCAN_NUMSIZE-1) num[n++] = (char) (ch); }
+
+	if (c == '+' || c == '-')
+	{
+		SCAN_STORE(c);
+		c = SCAN_GETC(f);
+	}
+
+	if (c == 'i' || c == 'I' || c == 'n' || c == 'N')
+		ndigit = -1;
+	else if (c == '0')
+	{
+		SCAN_STORE(c);
+		ndigit++;
+		c = SCAN_GETC(f);
+		if (c == 'x' || c == 'X') ndigit = -1;
+	}
+
+	if (ndigit < 0)
+	{
+		/* hexadecimal number, infinity or not-a-number: the word of the number is converted by strtod() */
+		while (c != EOF && (SCAN_ISDIGIT(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '.' || c == '(' || c == ')' || c == '_' ||
+			   ((c == '+' || c == '-') && n && (num[n-1] == 'p' || num[n-1] == 'P'))))
+		{
+			SCAN_STORE(c);
+			c = SCAN_GETC(f);
+		}
+		if (c != EOF) ungetc(c, f);
+		num[n] = '\0';
+		/* the word must be a complete number (e.g. 0x without digits is a matching failure, as in fscanf()) */
+		value = strtod(num, &end);
+		if (end != num + n) return (0);
+		*var = value;
+		return (1);
+	}
+
+	for (; SCAN_ISDIGIT(c); c = SCAN_GETC(f))
+	{
+		SCAN_STORE(c);
+		ndigit++;
+	}
+	if (c == '.')
+	{
+		SCAN_STORE(c);
+		for (c = SCAN_GETC(f); SCAN_ISDIGIT(c); c = SCAN_GETC(f))
+		{
+			SCAN_STORE(c);
+			ndigit++;
+		}
+	}
+	if (!ndigit)
+	{
+		if (c != EOF) ungetc(c, f);
+		return (0);
+	}
+	if (c == 'e' || c == 'E')
+	{
+		SCAN_STORE(c);
+		c = SCAN_GETC(f);
+		if (c == '+' || c == '-')
+		{
+			SCAN_STORE(c);
+			c = SCAN_GETC(f);
+		}
+		for (; SCAN_ISDIGIT(c); c = SCAN_GETC(f)) SCAN_STORE(c);
+	}
+	if (c != EOF) ungetc(c, f);
+
+	#undef SCAN_STORE
+
+	num[n] = '\0';
+	*var = scan_strtod(num, NULL);
+
+	return (1);
+}
+
+
+static int scan_string(FILE* f, char* var)
+{
+	int c;
+
+	if ((c = scan_skipspace(f)) == EOF) return (EOF);
+
+	for (; c != EOF && !SCAN_ISSPACE(c); c = SCAN_GETC(f)) *var++ = (char) c;
+	*var = '\0';
+	if (c != EOF) ungetc(c, f);
+
+	return (1);
+}
+
+
+/* rest of the line without the newline character */
+static void scan_skipline(FILE* f)
+{
+	int c;
+
+	do c = SCAN_GETC(f); while (c != EOF && c != '\n');
+	if (c != EOF) ungetc(c, f);
+}
+
 /* scan_value is the generic ascii input function for use with text
 initialization files. Reads the first whitespace delimited word on a line,
 and discards the remainder of the line. Returns a pointer to value depending
@@ -91,12 +395,13 @@ int scan_array (file ini, void *var, char type, int nl, int errormessage)
 {
     int ok_scan;
     int errorCode=0;
+	int i;
 
     switch (type)
     {
         case 'i':
-			if (nl) ok_scan = fscanf(ini.ptr, "%d%*[^\n]",(int*)var);
-			else ok_scan = fscanf(ini.ptr, "%d",(int*)var);
+			ok_scan = scan_int(ini.ptr, (int*)var);
+			if (nl && ok_scan == 1) scan_skipline(ini.ptr);
 			
             if (ok_scan == 0 || ok_scan == EOF) 
 			{
@@ -106,8 +411,8 @@ int scan_array (file ini, void *var, char type, int nl, int errormessage)
             break;
 
         case 'd':
-			if (nl) ok_scan = fscanf(ini.ptr, "%lf%*[^\n]",(double*)var);
-			else ok_scan = fscanf(ini.ptr, "%lf",(double*)var);
+			ok_scan = scan_double(ini.ptr, (double*)var);
+			if (nl && ok_scan == 1) scan_skipline(ini.ptr);
 			
             if (ok_scan == 0 || ok_scan == EOF)
 			{
@@ -117,14 +422,22 @@ int scan_array (file ini, void *var, char type, int nl, int errormessage)
             break;
 
         case 's':
-			if (nl) ok_scan = fscanf(ini.ptr, "%s%*[^\n]",(char*)var);
-			else ok_scan = fscanf(ini.ptr, "%s",(char*)var);
+			ok_scan = scan_string(ini.ptr, (char*)var);
+			if (nl && ok_scan == 1) scan_skipline(ini.ptr);
 
             if (ok_scan == 0 || ok_scan == EOF) 
 			{
 				if (errormessage) printf("ERROR reading string value from %s\n",ini.name);
 				errorCode=1;
 			}
+			for (i = 0; !errorCode && i < subst_n; i++)
+			{
+				if (!strcmp((char*)var, subst_from[i]))
+				{
+					strcpy((char*)var, subst_to[i]);
+					break;
+				}
+			}
             break;
 
         default:
@@ -140,6 +453,54 @@ int scan_value (file ini, void *var, char type)
 	return scan_array (ini, var, type, 1, 1);
 }
 
+/* scan_row reads the row of numbers at the beginning of a line (e.g. the values of the soil layers) and discards the
+remainder of the line (the first word which is not a number starts the comment); the number of values is returned in
+nvalue, at least one and at most nmax values are accepted */
+int scan_row (file ini, double* var, int nmax, int* nvalue)
+{
+	int c, n, errorCode=0;
+	char num[SCAN_NUMSIZE];
+	char* end;
+	double value;
+
+	*nvalue = 0;
+	c = scan_skipspace(ini.ptr);
+
+	while (!errorCode && c != EOF && c != '\n')
+	{
+		/* next word of the line */
+		for (n = 0; c != EOF && !SCAN_ISSPACE(c); c = SCAN_GETC(ini.ptr))
+		{
+			if (n < SCAN_NUMSIZE-1) num[n++] = (char) c;
+		}
+		num[n] = '\0';
+
+		value = scan_strtod(num, &end);
+		if (end != num + n) break;
+
+		if (*nvalue == nmax)
+		{
+			printf("ERROR reading row of values from %s: more than %i values\n", ini.name, nmax);
+			errorCode=1;
+		}
+		else
+			var[(*nvalue)++] = value;
+
+		while (c != EOF && c != '\n' && SCAN_ISSPACE(c)) c = SCAN_GETC(ini.ptr);
+	}
+
+	if (c != EOF && c != '\n') scan_skipline(ini.ptr);
+	else if (c != EOF) ungetc(c, ini.ptr);
+
+	if (!errorCode && *nvalue == 0)
+	{
+		printf("ERROR reading row of values from %s\n", ini.name);
+		errorCode=1;
+	}
+
+	return (errorCode);
+}
+
 /* combines scan_value with file_open for reading a filename from an
 initialization file and then opening it with a specified access mode */
 int scan_open (file ini,file *target,char mode, int errormessage)
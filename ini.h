@@ -25,4 +25,15 @@ typedef struct
 int file_open (file *target, char mode, int errormessage);
 int scan_value (file ini, void *var, char mode);
 int scan_array (file ini, void *var, char mode, int nl, int errormessage);
+int scan_row (file ini, double* var, int nmax, int* nvalue);
 int scan_open (file ini,file *target,char mode, int errormessage);
+double scan_strtod(const char* str, char** endptr);
+int file_substitution (int n, char (*from)[FILENAMESIZE], char (*to)[FILENAMESIZE]);
+int file_discard (int flag);
+/* input providers: in-memory buffers, memory-mapped files and archive members (input_provider.c) */
+int input_buffer_register(const char* name, const char* data, size_t size);
+int input_file_map(const char* name);
+int input_archive_open(const char* name, int* nmember);
+int input_provider_open(const char* name, FILE** ptr, unsigned long* serial);
+int input_buffer_release(const char* name);
+void input_provider_free(void);
@@ -0,0 +1,565 @@
+/*
+input_provider.c
+input providers beneath file_open(): input files can be given as in-memory buffers, memory-mapped files or members
+of an archive (many site inputs in one file), the readers get a FILE pointer to the registered contents and no
+file has to be written for batch runs; a new registration of a name replaces the earlier one, released or replaced
+contents are freed when no read stream has them open
+
+archive format (text header lines, the contents of the members are copied verbatim):
+MUSOARCHIVE 1
+FILE <name> <number of bytes>
+<contents of the member>
+FILE <name> <number of bytes>
+...
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#ifndef _WIN32
+#define _GNU_SOURCE
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "ini.h"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+
+/* read streams with a closing function (the open streams of a storage block are counted) */
+#if defined(__GLIBC__)
+#define INPUT_STREAM_COOKIE
+#endif
+
+#define ARCHIVE_MAGIC "MUSOARCHIVE 1"
+
+/* storage of registered contents: malloc-ed buffer or memory mapping (shared by the members of an archive) */
+typedef struct
+{
+	char name[FILENAMESIZE];
+	char* data;
+	size_t size;
+	int mapped;
+	int nentry;
+	int nopen;
+} inputblock_struct;
+
+/* registered input: name and contents (pointer into a storage block) */
+typedef struct inputentry
+{
+	char name[FILENAMESIZE];
+	const char* data;
+	size_t size;
+	unsigned long serial;
+	inputblock_struct* block;
+	struct inputentry* next;
+} inputentry_struct;
+
+static inputentry_struct* input_entries = NULL;	/* registered inputs, the latest registration first */
+static inputblock_struct** input_blocks = NULL;	/* storage blocks */
+static int input_nblocks = 0;					/* number of storage blocks */
+static unsigned long input_serial = 0;			/* counter of the registrations */
+
+#ifdef INPUT_STREAM_COOKIE
+/* read stream of a registered input */
+typedef struct
+{
+	inputblock_struct* block;
+	const char* data;
+	size_t size;
+	size_t pos;
+} inputstream_struct;
+#endif
+
+
+/* loading a whole file into a storage block (memory mapping if available) */
+static inputblock_struct* input_block_load(const char* name)
+{
+	inputblock_struct* block;
+#ifndef _WIN32
+	int fd;
+	struct stat st;
+#else
+	file in;
+	long size;
+#endif
+
+	block = (inputblock_struct*) calloc(1, sizeof(inputblock_struct));
+	if (!block) return (NULL);
+
+#ifndef _WIN32
+	fd = open(name, O_RDONLY);
+	if (fd < 0 || fstat(fd, &st) || st.st_size == 0)
+	{
+		if (fd >= 0) close(fd);
+		free(block);
+		return (NULL);
+	}
+	block->data = (char*) mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (block->data == (char*) MAP_FAILED)
+	{
+		free(block);
+		return (NULL);
+	}
+	block->size   = (size_t) st.st_size;
+	block->mapped = 1;
+#else
+	strcpy(in.name, name);
+	if (file_open(&in,'r',0))
+	{
+		free(block);
+		return (NULL);
+	}
+	fseek(in.ptr, 0, SEEK_END);
+	size = ftell(in.ptr);
+	rewind(in.ptr);
+	if (size > 0) block->data = (char*) malloc((size_t) size);
+	if (size <= 0 || !block->data || fread(block->data, 1, (size_t) size, in.ptr) != (size_t) size)
+	{
+		fclose(in.ptr);
+		free(block->data);
+		free(block);
+		return (NULL);
+	}
+	fclose(in.ptr);
+	block->size = (size_t) size;
+#endif
+
+	return (block);
+}
+
+
+static void input_block_free(inputblock_struct* block)
+{
+#ifndef _WIN32
+	if (block->mapped)
+		munmap(block->data, block->size);
+	else
+#endif
+		free(block->data);
+	free(block);
+}
+
+
+/* a storage block without registered entries and open read streams is removed and freed (called in a critical section) */
+static void input_block_collect(inputblock_struct* block)
+{
+	int n;
+
+	if (block->nentry || block->nopen) return;
+
+	for (n = 0; n < input_nblocks && input_blocks[n] != block; n++) ;
+	if (n < input_nblocks)
+	{
+		input_nblocks -= 1;
+		input_blocks[n] = input_blocks[input_nblocks];
+	}
+	input_block_free(block);
+}
+
+
+/* removing a registered entry (called in a critical section) */
+static void input_entry_unlink(inputentry_struct** link)
+{
+	inputentry_struct* entry = *link;
+
+	*link = entry->next;
+	entry->block->nentry -= 1;
+	input_block_collect(entry->block);
+	free(entry);
+}
+
+
+/* adding a storage block and its entries (called in a critical section) */
+static int input_block_add(inputblock_struct* block)
+{
+	inputblock_struct** blocks;
+
+	blocks = (inputblock_struct**) realloc(input_blocks, (input_nblocks + 1) * sizeof(inputblock_struct*));
+	if (!blocks) return (1);
+	input_blocks = blocks;
+	input_blocks[input_nblocks] = block;
+	input_nblocks += 1;
+
+	return (0);
+}
+
+
+static inputentry_struct* input_entry_new(const char* name, const char* data, size_t size, inputblock_struct* block)
+{
+	inputentry_struct* entry;
+
+	if (strlen(name) >= FILENAMESIZE || size == 0) return (NULL);
+
+	entry = (inputentry_struct*) malloc(sizeof(inputentry_struct));
+	if (!entry) return (NULL);
+	strcpy(entry->name, name);
+	entry->data  = data;
+	entry->size  = size;
+	entry->block = block;
+	entry->next  = NULL;
+
+	return (entry);
+}
+
+
+/* the new entries replace the earlier entries of their names (the earlier contents remain valid for the readers which
+   have opened them; called in a critical section) */
+static void input_entries_add(inputentry_struct* first, inputentry_struct* last)
+{
+	inputentry_struct *entry, *added, **link;
+
+	for (entry = first; entry; entry = entry->next)
+	{
+		input_serial += 1;
+		entry->serial = input_serial;
+		entry->block->nentry += 1;
+	}
+
+	link = &input_entries;
+	while (*link)
+	{
+		for (added = first; added && strcmp(added->name, (*link)->name); added = added->next) ;
+		if (added)
+			input_entry_unlink(link);
+		else
+			link = &(*link)->next;
+	}
+
+	last->next    = input_entries;
+	input_entries = first;
+}
+
+
+#ifdef INPUT_STREAM_COOKIE
+static ssize_t input_stream_read(void* cookie, char* buf, size_t size)
+{
+	inputstream_struct* stream = (inputstream_struct*) cookie;
+	size_t n = stream->size - stream->pos;
+
+	if (n > size) n = size;
+	memcpy(buf, stream->data + stream->pos, n);
+	stream->pos += n;
+
+	return ((ssize_t) n);
+}
+
+
+static int input_stream_seek(void* cookie, off64_t* offset, int whence)
+{
+	inputstream_struct* stream = (inputstream_struct*) cookie;
+	off64_t pos;
+
+	if (whence == SEEK_SET)
+		pos = *offset;
+	else if (whence == SEEK_CUR)
+		pos = (off64_t) stream->pos + *offset;
+	else
+		pos = (off64_t) stream->size + *offset;
+
+	if (pos < 0 || pos > (off64_t) stream->size) return (-1);
+	stream->pos = (size_t) pos;
+	*offset     = pos;
+
+	return (0);
+}
+
+
+static int input_stream_close(void* cookie)
+{
+	/* the last reader of released or replaced contents frees them */
+	inputstream_struct* stream = (inputstream_struct*) cookie;
+
+	#pragma omp critical (input_provider)
+	{
+		stream->block->nopen -= 1;
+		input_block_collect(stream->block);
+	}
+	free(stream);
+
+	return (0);
+}
+#endif
+
+
+int input_buffer_register(const char* name, const char* data, size_t size)
+{
+	/* in-memory buffer (copied) under the given name */
+	int errorCode=0;
+	inputblock_struct* block;
+	inputentry_struct* entry=NULL;
+
+	block = (inputblock_struct*) calloc(1, sizeof(inputblock_struct));
+	if (block) block->data = (char*) malloc(size ? size : 1);
+	if (!block || !block->data)
+	{
+		printf("ERROR allocating for input buffer %s, input_buffer_register()\n", name);
+		free(block);
+		return (1);
+	}
+	memcpy(block->data, data, size);
+	block->size = size;
+	if (strlen(name) < FILENAMESIZE) strcpy(block->name, name);
+
+	entry = input_entry_new(name, block->data, size, block);
+	if (!entry)
+	{
+		printf("ERROR in input buffer %s: empty contents or too long name\n", name);
+		errorCode=1;
+	}
+
+	#pragma omp critical (input_provider)
+	{
+		if (!errorCode && input_block_add(block)) errorCode=1;
+		if (!errorCode) input_entries_add(entry, entry);
+	}
+
+	if (errorCode)
+	{
+		free(entry);
+		input_block_free(block);
+	}
+
+	return (errorCode);
+}
+
+
+int input_file_map(const char* name)
+{
+	/* memory-mapped file under its own name: the file is read from the memory in the later openings */
+	int errorCode=0;
+	inputblock_struct* block;
+	inputentry_struct* entry=NULL;
+
+	block = input_block_load(name);
+	if (!block)
+	{
+		printf("ERROR mapping input file %s, input_file_map()\n", name);
+		return (1);
+	}
+	if (strlen(name) < FILENAMESIZE) strcpy(block->name, name);
+
+	entry = input_entry_new(name, block->data, block->size, block);
+	if (!entry) errorCode=1;
+
+	#pragma omp critical (input_provider)
+	{
+		if (!errorCode && input_block_add(block)) errorCode=1;
+		if (!errorCode) input_entries_add(entry, entry);
+	}
+
+	if (errorCode)
+	{
+		printf("ERROR registering input file %s, input_file_map()\n", name);
+		free(entry);
+		input_block_free(block);
+	}
+
+	return (errorCode);
+}
+
+
+int input_archive_open(const char* name, int* nmember)
+{
+	/* archive of input files: the archive is mapped, its members are registered under their names */
+	int errorCode=0;
+	int magic=1;
+	unsigned long nbytes;
+	size_t pos, len;
+	char line[STRINGSIZE];
+	char member[STRINGSIZE];
+	const char* eol;
+	inputblock_struct* block;
+	inputentry_struct *first=NULL, *last=NULL, *entry;
+
+	*nmember = 0;
+
+	block = input_block_load(name);
+	if (!block)
+	{
+		printf("ERROR opening input archive %s, input_archive_open()\n", name);
+		return (1);
+	}
+	if (strlen(name) < FILENAMESIZE) strcpy(block->name, name);
+
+	/* header lines: magic string, then FILE <name> <number of bytes> before each member (empty lines are skipped) */
+	pos = 0;
+	while (!errorCode && pos < block->size)
+	{
+		eol = (const char*) memchr(block->data + pos, '\n', block->size - pos);
+		len = eol ? (size_t) (eol - (block->data + pos)) : block->size - pos;
+		if (len >= STRINGSIZE)
+		{
+			errorCode=1;
+			break;
+		}
+		memcpy(line, block->data + pos, len);
+		line[len] = '\0';
+		if (len && line[len-1] == '\r') line[len-1] = '\0';
+		pos += len + 1;
+		if (pos > block->size) pos = block->size;
+
+		if (magic)
+		{
+			if (strcmp(line, ARCHIVE_MAGIC)) errorCode=1;
+			magic = 0;
+		}
+		else if (line[0] != '\0')
+		{
+			if (sscanf(line, "FILE %199s %lu", member, &nbytes) != 2 || (size_t) nbytes > block->size - pos)
+				errorCode=1;
+			else if (!(entry = input_entry_new(member, block->data + pos, (size_t) nbytes, block)))
+				errorCode=1;
+			else
+			{
+				if (last)
+					last->next = entry;
+				else
+					first = entry;
+				last = entry;
+				*nmember += 1;
+				pos += (size_t) nbytes;
+			}
+		}
+	}
+
+	if (errorCode) printf("ERROR in format of input archive %s, input_archive_open()\n", name);
+
+	#pragma omp critical (input_provider)
+	{
+		if (!errorCode && first && input_block_add(block)) errorCode=1;
+		if (!errorCode && first) input_entries_add(first, last);
+	}
+
+	if (errorCode || !first)
+	{
+		while (first)
+		{
+			entry = first->next;
+			free(first);
+			first = entry;
+		}
+		input_block_free(block);
+	}
+
+	return (errorCode);
+}
+
+
+int input_provider_open(const char* name, FILE** ptr, unsigned long* serial)
+{
+	/* read stream of a registered input (ptr == NULL: only lookup); returns 1 if the name is not registered
+	   (the file is read from the disk), the serial number identifies the registered contents */
+	int miss=1;
+	inputentry_struct* entry;
+#ifdef INPUT_STREAM_COOKIE
+	inputstream_struct* stream;
+	cookie_io_functions_t io = {input_stream_read, NULL, input_stream_seek, input_stream_close};
+#endif
+
+	if (serial) *serial = 0;
+
+	/* input_entries is only read inside the critical section: a registration or release by another thread may change it */
+	#pragma omp critical (input_provider)
+	{
+		for (entry = input_entries; entry && strcmp(entry->name, name); entry = entry->next) ;
+		if (entry)
+		{
+			miss = 0;
+			if (serial) *serial = entry->serial;
+			if (ptr)
+			{
+#if defined(INPUT_STREAM_COOKIE)
+				*ptr   = NULL;
+				stream = (inputstream_struct*) malloc(sizeof(inputstream_struct));
+				if (stream)
+				{
+					stream->block = entry->block;
+					stream->data  = entry->data;
+					stream->size  = entry->size;
+					stream->pos   = 0;
+					*ptr = fopencookie(stream, "r", io);
+					if (*ptr)
+						entry->block->nopen += 1;
+					else
+						free(stream);
+				}
+#elif !defined(_WIN32)
+				/* the closing of the stream is not seen: the contents are kept until the end of the program */
+				*ptr = fmemopen((void*) entry->data, entry->size, "r");
+				if (*ptr) entry->block->nopen = 1;
+#else
+				/* no in-memory stream on Windows: temporary file with the contents */
+				*ptr = tmpfile();
+				if (*ptr && fwrite(entry->data, 1, entry->size, *ptr) != entry->size)
+				{
+					fclose(*ptr);
+					*ptr = NULL;
+				}
+				if (*ptr) rewind(*ptr);
+#endif
+			}
+		}
+	}
+
+	return (miss);
+}
+
+
+int input_buffer_release(const char* name)
+{
+	/* every registration of the name is released: in-memory buffer, memory-mapped file, archive member or all members of
+	   the archive of the name; the contents are freed when no read stream has them open; returns 1 if nothing is
+	   registered under the name */
+	int miss=1;
+	inputentry_struct** link;
+
+	#pragma omp critical (input_provider)
+	{
+		link = &input_entries;
+		while (*link)
+		{
+			if (!strcmp((*link)->name, name) || !strcmp((*link)->block->name, name))
+			{
+				input_entry_unlink(link);
+				miss = 0;
+			}
+			else
+				link = &(*link)->next;
+		}
+	}
+
+	return (miss);
+}
+
+
+void input_provider_free(void)
+{
+	int n;
+	inputentry_struct* entry;
+
+	#pragma omp critical (input_provider)
+	{
+		while (input_entries)
+		{
+			entry = input_entries->next;
+			free(input_entries);
+			input_entries = entry;
+		}
+		for (n = 0; n < input_nblocks; n++) input_block_free(input_blocks[n]);
+		free(input_blocks);
+		input_blocks  = NULL;
+		input_nblocks = 0;
+	}
+}
+
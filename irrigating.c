@@ -85,7 +85,7 @@ int irrigating(const control_struct* ctrl, const irrigating_struct* IRG, const s
 				IRGlayer = 0;
 				if (IRGdepth > sitec->soillayer_depth[0])
 				{
-					while (IRGlayer == 0 && layer < N_SOILLAYERS)
+					while (IRGlayer == 0 && layer < sitec->n_soillayers)
 					{
 						if ((IRGdepth > sitec->soillayer_depth[layer-1]) && (IRGdepth <= sitec->soillayer_depth[layer])) IRGlayer = layer;
 						layer += 1;
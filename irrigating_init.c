@@ -143,11 +143,11 @@ int irrigating_init(file init, const control_struct* ctrl, irrigating_struct* IR
 		IRG->IRG_num = nmgm;
 		nmgm = 0;
 	
-		IRG->IRGyear_array      = (int*) malloc(IRG->IRG_num*sizeof(double));  
-		IRG->IRGmonth_array     = (int*) malloc(IRG->IRG_num*sizeof(double)); 
-		IRG->IRGday_array       = (int*) malloc(IRG->IRG_num*sizeof(double)); 
-		IRG->IRGquantity_array  = (double*) malloc(IRG->IRG_num*sizeof(double)); 
-		IRG->IRGheight_array     = (double*) malloc(IRG->IRG_num*sizeof(double)); 
+		IRG->IRGyear_array      = (int*) arena_malloc(IRG->IRG_num*sizeof(double));  
+		IRG->IRGmonth_array     = (int*) arena_malloc(IRG->IRG_num*sizeof(double)); 
+		IRG->IRGday_array       = (int*) arena_malloc(IRG->IRG_num*sizeof(double)); 
+		IRG->IRGquantity_array  = (double*) arena_malloc(IRG->IRG_num*sizeof(double)); 
+		IRG->IRGheight_array     = (double*) arena_malloc(IRG->IRG_num*sizeof(double)); 
 
 		for (nmgm = 0; nmgm < IRG->IRG_num; nmgm++)
 		{
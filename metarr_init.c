@@ -1,6 +1,8 @@
 /*
 metarr_init.c
-Initialize meteorological data arrays for pointbgc simulation
+Initialize meteorological data arrays for pointbgc simulation (the met file is parsed and the climate change scenario is
+applied in parallel, the day-to-day recursions are calculated afterwards); streamed met input: the met file is scanned
+and the daily variables are read in windows of years during the simulation, the next window is prefetched by a thread
 
 *-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
 Biome-BGCMuSo v7.0.
@@ -14,13 +16,22 @@ See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentatio
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 #include "ini.h"
 #include "bgc_struct.h"
 #include "bgc_constants.h"
 #include "pointbgc_struct.h"
 #include "pointbgc_func.h"
+#include "bgc_func.h"
 #include "misc_func.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#define METSTREAM_PREFETCH						/* the next window of the streamed met input is read by a thread */
+#endif
   
 
 /* It is assumed here that the meteorological datafile contains the following 
@@ -38,28 +49,1025 @@ daylength   s      (daylight duration)
 
 */
 
+#define METREAD_NVAR     7					/* number of real variables in a line of the met file */
+#define METREAD_MAXCHUNK 256				/* maximal number of parallel parsed parts of the met file */
+#define METREAD_MINCHUNK 262144				/* (byte) minimal size of a parallel parsed part of the met file */
+#define METREAD_MINDAYS  10000				/* minimal number of days of the parallel scaling */
+#define METREAD_ISBLANK(c) ((c) == ' ' || (c) == '\t' || (c) == '\v' || (c) == '\f' || (c) == '\r')
+
+/* control to avoid negative meteorological data */
+#define METREAD_INVALID(prcp, vpd, swavgfd, dayl) ((prcp) < 0 || (vpd) < 0 || (swavgfd) <= 0 || (dayl) <= 0)
+
+/* compact met store of the process (metarr_compact_mode()) */
+static int metarr_compact_flag = 0;
+
+/* streamed met input of the process (metarr_stream_mode()): number of years in the window (0: the met file is stored) */
+static int metarr_stream_nwindow = 0;
+
+/* records of the met file: the rest of the file is parsed and checked in parallel if each non-empty line starts with 9
+   numbers (year, day and the real variables) separated by whitespace; otherwise the lines are read serially by fscanf()
+   (f != NULL), which gives the original results for irregular files, too */
+typedef struct
+{
+	FILE* f;
+	int nrec;
+	int next;
+	int* year;
+	int* day;
+	double* var;
+	char* invalid;
+} metread_struct;
+
+
+/* number of records in a part of the text, or the records are parsed (if MR->year is allocated) from the position pos;
+   return value: number of records, -1 for an irregular line */
+static int metread_chunk(const char* begin, const char* end, metread_struct* MR, int pos)
+{
+	int nrec=0, k;
+	long ivalue[2];
+	double* var;
+	const char* p;
+	const char* lineend;
+	char* e;
+
+	for (p = begin; p < end; p = lineend + 1)
+	{
+		lineend = (const char*) memchr(p, '\n', end - p);
+		if (!lineend) lineend = end;
+
+		while (p < lineend && METREAD_ISBLANK(*p)) p++;
+		if (p == lineend) continue;
+
+		if (MR->year)
+		{
+			/* integer fields as by "%i" (strtol() with base 0), real fields as by "%lf": each number must be followed by
+			   whitespace or by the end of the line */
+			var = MR->var + (size_t) (pos + nrec) * METREAD_NVAR;
+			for (k = 0; k < 2 + METREAD_NVAR; k++)
+			{
+				while (p < lineend && METREAD_ISBLANK(*p)) p++;
+				if (p == lineend) return (-1);
+
+				if (k < 2)
+					ivalue[k] = strtol(p, &e, 0);
+				else
+					var[k-2] = scan_strtod(p, &e);
+
+				if (e == p || (e < lineend && !METREAD_ISBLANK(*e))) return (-1);
+				p = e;
+			}
+			MR->year[pos + nrec]    = (int) ivalue[0];
+			MR->day[pos + nrec]     = (int) ivalue[1];
+			MR->invalid[pos + nrec] = (char) METREAD_INVALID(var[3], var[4], var[5], var[6]);
+		}
+		nrec++;
+	}
+
+	return (nrec);
+}
+
+
+static void metread_init(FILE* f, metread_struct* MR)
+{
+	int n, nchunk, irregular=0;
+	int nrec[METREAD_MAXCHUNK], pos[METREAD_MAXCHUNK];
+	const char* bound[METREAD_MAXCHUNK+1];
+	const char* p;
+	char* text=NULL;
+	long start, size=0, nread=0, chunk;
+
+	memset(MR, 0, sizeof(metread_struct));
+	MR->f = f;
+
+	/* the rest of the met file is loaded; without positioning (or memory) the file is read serially */
+	start = ftell(f);
+	if (start < 0 || fseek(f, 0, SEEK_END)) return;
+	size = ftell(f) - start;
+	if (fseek(f, start, SEEK_SET) || size < 0) return;
+
+	text = (char*) malloc(size + 1);
+	if (!text) return;
+	while (nread < size && (chunk = (long) fread(text + nread, 1, size - nread, f)) > 0) nread += chunk;
+	text[nread] = '\0';
+
+	/* the text is divided at line boundaries */
+#ifdef _OPENMP
+	nchunk = omp_get_max_threads();
+#else
+	nchunk = 1;
+#endif
+	if (nchunk > nread / METREAD_MINCHUNK) nchunk = (int) (nread / METREAD_MINCHUNK);
+	if (nchunk > METREAD_MAXCHUNK) nchunk = METREAD_MAXCHUNK;
+	if (nchunk < 1) nchunk = 1;
+
+	bound[0]      = text;
+	bound[nchunk] = text + nread;
+	for (n = 1; n < nchunk; n++)
+	{
+		p = (const char*) memchr(text + nread / nchunk * n, '\n', nread - nread / nchunk * n);
+		bound[n] = p ? p + 1 : text + nread;
+		if (bound[n] < bound[n-1]) bound[n] = bound[n-1];
+	}
+
+	/* first pass: number of records of the parts */
+	#pragma omp parallel for schedule(static,1) if (nchunk > 1)
+	for (n = 0; n < nchunk; n++) nrec[n] = metread_chunk(bound[n], bound[n+1], MR, 0);
+
+	for (n = 0; n < nchunk; n++)
+	{
+		pos[n]    = MR->nrec;
+		MR->nrec += nrec[n];
+	}
+
+	MR->year    = (int*) malloc((MR->nrec + 1) * sizeof(int));
+	MR->day     = (int*) malloc((MR->nrec + 1) * sizeof(int));
+	MR->var     = (double*) malloc(((size_t) MR->nrec * METREAD_NVAR + 1) * sizeof(double));
+	MR->invalid = (char*) malloc(MR->nrec + 1);
+
+	/* second pass: parsing and checking the records */
+	if (MR->year && MR->day && MR->var && MR->invalid)
+	{
+		#pragma omp parallel for schedule(static,1) if (nchunk > 1)
+		for (n = 0; n < nchunk; n++) nrec[n] = metread_chunk(bound[n], bound[n+1], MR, pos[n]);
+
+		for (n = 0; n < nchunk; n++)
+			if (nrec[n] < 0) irregular = 1;
+	}
+	else
+		irregular = 1;
+
+	free(text);
+
+	if (irregular)
+	{
+		free(MR->year);
+		free(MR->day);
+		free(MR->var);
+		free(MR->invalid);
+		memset(MR, 0, sizeof(metread_struct));
+		MR->f = f;
+		fseek(f, start, SEEK_SET);
+	}
+	else
+		MR->f = NULL;
+}
+
+
+/* next record of the met file: return value and unchanged variables at the end of the file as by fscanf() */
+static int metread_next(metread_struct* MR, int* year, int* day, double* Tmax, double* Tmin, double* Tday, double* prcp, double* vpd,
+	                    double* swavgfd, double* dayl)
+{
+	const double* var;
+
+	if (MR->f) return (fscanf(MR->f, "%i%i%lf%lf%lf%lf%lf%lf%lf%*[^\n]", year, day, Tmax, Tmin, Tday, prcp, vpd, swavgfd, dayl));
+
+	if (MR->next == MR->nrec) return (EOF);
+
+	var = MR->var + (size_t) MR->next * METREAD_NVAR;
+	*year    = MR->year[MR->next];
+	*day     = MR->day[MR->next];
+	*Tmax    = var[0];
+	*Tmin    = var[1];
+	*Tday    = var[2];
+	*prcp    = var[3];
+	*vpd     = var[4];
+	*swavgfd = var[5];
+	*dayl    = var[6];
+	MR->next += 1;
+
+	return (2 + METREAD_NVAR);
+}
+
+
+static void metread_free(metread_struct* MR)
+{
+	free(MR->year);
+	free(MR->day);
+	free(MR->var);
+	free(MR->invalid);
+}
+
+
+/* climate change scenario and derived variables of the stored days [first, last) (in parallel), tempradF without the
+   day-to-day recursion */
+static void metarr_scale(metarr_struct* metarr, const climchange_struct* scc, int first, int last)
+{
+	int sd;
+	double Tmax, Tmin, Tavg, Tavg_scc, sw_MJ;
+
+	#pragma omp parallel for schedule(static) private(Tmax, Tmin, Tavg, Tavg_scc, sw_MJ) if (last - first > METREAD_MINDAYS)
+	for (sd = first; sd < last; sd++)
+	{
+		Tmax = metarr->Tmax_array[sd];
+		Tmin = metarr->Tmin_array[sd];
+
+		metarr->Tmax_array[sd] = Tmax + scc->s_Tmax;
+		metarr->Tmin_array[sd] = Tmin + scc->s_Tmin;
+		Tavg = (Tmax + Tmin) / 2.0;
+
+		Tavg_scc = (metarr->Tmax_array[sd] + metarr->Tmin_array[sd]) / 2.0;
+		if (metarr->Tavg_array) metarr->Tavg_array[sd] = Tavg_scc;
+		metarr->Tday_array[sd] = metarr->Tday_array[sd] + (Tavg_scc - Tavg);
+
+		/* factor for soil temp. calculation (before the scaling of swavgfd) */
+		sw_MJ = metarr->swavgfd_array[sd] * metarr->dayl_array[sd] / 1000000;
+		metarr->tempradF_array[sd] = Tavg_scc +  (Tmax - Tavg_scc) * sqrt(sw_MJ*0.03);
+
+		metarr->prcp_array[sd]    = metarr->prcp_array[sd] * scc->s_prcp;
+		metarr->vpd_array[sd]     = metarr->vpd_array[sd] * scc->s_vpd;
+		if (metarr->par_array) metarr->par_array[sd] = metarr->swavgfd_array[sd] * 0.45 * scc->s_swavgfd;
+		metarr->swavgfd_array[sd] = metarr->swavgfd_array[sd] * scc->s_swavgfd;
+	}
+}
+
+
+/* sums of the annual temperature data of a year (metarr_annual_day()) */
+typedef struct
+{
+	double annTavgSUM;
+	double monthTavgSUM;
+	double minTmonth;
+	double maxTmonth;
+	int m;
+	int nm;
+} metannual_struct;
+
+
+/* arrays of the annual and monthly average air temperature, of the annual air temperature range and of their 10-year
+   running averages */
+static int metarr_annual_alloc(metarr_struct* metarr, int nyears)
+{
+	int errorCode=0;
+
+	if (!errorCode)
+	{
+		metarr->annTavg_array = (double*) arena_malloc(nyears * sizeof(double));
+		if (!metarr->annTavg_array)
+		{
+			printf("ERROR allocating for annTavg_array\n");
+			errorCode=218;
+		}
+	}
+
+	if (!errorCode)
+	{
+		metarr->monTavg_array = (double*) arena_malloc(nyears * 12 * sizeof(double));
+		if (!metarr->monTavg_array)
+		{
+			printf("ERROR allocating for monTavg_array\n");
+			errorCode=218;
+		}
+	}
+
+	if (!errorCode)
+	{
+		metarr->annTrange_array= (double*) arena_malloc(nyears * sizeof(double));
+		if (!metarr->annTrange_array)
+		{
+			printf("ERROR allocating for annTrange_array array\n");
+			errorCode=218;
+		}
+	}
+
+	if (!errorCode)
+	{
+		metarr->annTavgRA_array = (double*) arena_malloc(nyears * sizeof(double));
+		if (!metarr->annTavgRA_array)
+		{
+			printf("ERROR allocating for annTavgRA_array\n");
+			errorCode=218;
+		}
+	}
+
+	if (!errorCode)
+	{
+		metarr->annTrangeRA_array= (double*) arena_malloc(nyears * sizeof(double));
+		if (!metarr->annTrangeRA_array)
+		{
+			printf("ERROR allocating for annTrangeRA_array array\n");
+			errorCode=218;
+		}
+	}
+
+	return (errorCode);
+}
+
+
+/* daily average air temperature of the simulation day sd (in the order of the days): the sums of its year are updated, the
+   annual average and range are stored on the last day of the year (which is not summed) */
+static void metarr_annual_day(metarr_struct* metarr, metannual_struct* A, int sd, double Tavg)
+{
+	int y = sd / nDAYS_OF_YEAR;
+	int d = sd % nDAYS_OF_YEAR;
+
+	static const int nMONTHday_array[]={31,28,31,30,31,30,31,31,30,31,30,31};
+
+	if (d == 0)
+	{
+		A->annTavgSUM = 0;
+		A->monthTavgSUM = 0;
+		A->minTmonth = 0;
+		A->maxTmonth = 0;
+		A->m=0;
+		A->nm=0;
+	}
+
+	if (d < nDAYS_OF_YEAR-1)
+	{
+		A->annTavgSUM += Tavg;
+
+		if (A->nm < nMONTHday_array[A->m])
+		{
+			A->monthTavgSUM += Tavg;
+			A->nm=A->nm+1;
+		}
+		else
+		{
+			metarr->monTavg_array[y*nMONTHS_OF_YEAR+A->m] = A->monthTavgSUM/nMONTHday_array[A->m];
+
+			if (A->monthTavgSUM/nMONTHday_array[A->m] < A->minTmonth) A->minTmonth = A->monthTavgSUM/nMONTHday_array[A->m];
+			if (A->monthTavgSUM/nMONTHday_array[A->m] > A->maxTmonth) A->maxTmonth = A->monthTavgSUM/nMONTHday_array[A->m];
+
+			A->m=A->m+1;
+			A->nm=0;
+			A->monthTavgSUM = 0;
+		}
+	}
+	else
+	{
+		metarr->annTavg_array[y]    = A->annTavgSUM/nDAYS_OF_YEAR;
+		metarr->annTrange_array[y] = A->maxTmonth - A->minTmonth;
+	}
+}
+
+
+/* 10-year running average of mean annual air temperature and mean annual air tempearture range */
+static int metarr_annual_avg(metarr_struct* metarr, int nyears)
+{
+	int errorCode=0;
+	int y;
+	double annTavgSUM, annTrangeSUM;
+
+	if (nyears > 10)
+	{
+		if (!errorCode && run_avg(metarr->annTavg_array, metarr->annTavgRA_array, nyears, 10, 0))
+		{
+			printf("ERROR: run_avg() in metv_init.c \n");
+			errorCode=218;
+		}
+		if (!errorCode && run_avg(metarr->annTrange_array, metarr->annTrangeRA_array, nyears, 10, 0))
+		{
+			printf("ERROR: run_avg() in metv_init.c \n");
+			errorCode=218;
+		}
+	}
+	else
+	{
+
+		annTavgSUM=0;
+		annTrangeSUM=0;
+		for (y=0; !errorCode && y<nyears; y++)
+		{
+			annTavgSUM   += metarr->annTavg_array[y];
+			annTrangeSUM += metarr->annTrange_array[y];
+		}
+		for (y=0; !errorCode && y<nyears; y++)
+		{
+			metarr->annTavgRA_array[y]   = annTavgSUM/nyears;
+			metarr->annTrangeRA_array[y] = annTrangeSUM/nyears;
+		}
+	}
+
+	return (errorCode);
+}
+
+
+/* annual and monthly average air temperature, annual air temperature range and their 10-year running averages of the
+   stored met arrays (the daily average temperature is read by metarr_value(); the streamed met input sums the days during
+   the scan of the met file) */
+static int metarr_annual(metarr_struct* metarr, int nyears)
+{
+	int errorCode=0;
+	int sd;
+	metannual_struct A;
+
+	errorCode = metarr_annual_alloc(metarr, nyears);
+
+	for (sd=0; !errorCode && sd<nyears*nDAYS_OF_YEAR; sd++)
+		metarr_annual_day(metarr, &A, sd, metarr_value(metarr, METARR_TAVG, sd));
+
+	if (!errorCode) errorCode = metarr_annual_avg(metarr, nyears);
+
+	return (errorCode);
+}
+
+
+int metarr_compact_mode(int flag)
+{
+	/* compact met store of the following simulations: only the raw drivers (Tmax, Tmin, Tday, prcp, vpd, swavgfd, dayl) and
+	   the tempradF recursion are stored, Tavg, par (if swavgfd is not scaled) and the running averages are calculated on demand
+	   (metarr_value()), daylength is stored in single precision if it is exact; flag < 0: the mode is only queried */
+	if (flag >= 0) metarr_compact_flag = flag;
+
+	return (metarr_compact_flag);
+}
+
+
+int metarr_stream_mode(int nwindow)
+{
+	/* streamed met input of the following simulations: the met file is scanned once (checks, positions of the years, sums
+	   for the days after the last record), then the daily variables are read in a window of nwindow years (and the
+	   preceding year) when a day outside of the window is needed; nwindow < 0: the mode is only queried */
+	if (nwindow >= 0) metarr_stream_nwindow = nwindow;
+
+	return (metarr_stream_nwindow);
+}
+
+
+/* prefetch of the next window of the streamed met input: the years after the window are read into a second set of window
+   arrays by a POSIX thread while the simulation runs on the window (an OpenMP task would not be deferred outside of the
+   parallel regions) */
+typedef struct
+{
+	const metstream_struct* S;     /* stream of the prefetch */
+	FILE* f;                       /* met file of the thread (opened and positioned by the calling thread) */
+	int first_year;                /* first year of the prefetched window (-1: none) */
+	int last_year;                 /* the year after the prefetched window */
+	int errorCode;                 /* error of the reading of the thread */
+	int active;                    /* (flag) the thread is running or is not waited for yet */
+	int nswap;                     /* number of exchanges of the window arrays with the stream */
+	double* array[METARR_NVAR];    /* the second window arrays */
+#ifdef METSTREAM_PREFETCH
+	pthread_t thread;
+#endif
+} metprefetch_struct;
+
+/* stream of the simulation of the calling thread (its prefetch is finished by metarr_stream_release()) */
+static metstream_struct* metstream_actual = NULL;
+#pragma omp threadprivate(metstream_actual)
+
+
+/* years of the window from the year before simyr */
+static void metarr_stream_range(const metstream_struct* S, int simyr, int* first_year, int* last_year)
+{
+	*first_year = simyr > 0 ? simyr - 1 : 0;
+	*last_year  = *first_year + S->nwindow + 1;
+	if (*last_year > S->nyears) *last_year = S->nyears;
+}
+
+
+/* met file positioned at the first record of first_year (NULL: the window is after the last record); verbose: the errors
+   are reported */
+static int metarr_stream_open(const metstream_struct* S, int first_year, FILE** f, int verbose)
+{
+	int errorCode=0;
+	file metf;
+
+	metf     = S->metf;
+	metf.ptr = NULL;
+	if (first_year * nDAYS_OF_YEAR < S->firstgap && file_open(&metf, 'j', 0))
+	{
+		if (verbose) printf("ERROR opening met file for the window of the streamed met input: %s\n", S->metf.name);
+		errorCode=218;
+	}
+
+	if (!errorCode && metf.ptr && fseek(metf.ptr, S->offset[first_year], SEEK_SET))
+	{
+		if (verbose) printf("ERROR positioning met file for the window of the streamed met input: %s\n", S->metf.name);
+		errorCode=218;
+	}
+
+	if (errorCode && metf.ptr)
+	{
+		fclose(metf.ptr);
+		metf.ptr = NULL;
+	}
+
+	*f = metf.ptr;
+	return (errorCode);
+}
+
+
+/* window of the years [first_year, last_year) in the window arrays: the records are read from the met file, the days after
+   the last record from the stored averages; climate change scenario and tempradF recursion as in metarr_init(). Only the
+   results of the scan of the met file are used from the stream (the prefetch thread reads the next window with it) */
+static int metarr_stream_read(const metstream_struct* S, FILE* f, int first_year, int last_year, double** array, int verbose)
+{
+	int errorCode=0;
+	int ndays, i, k, sd, year, day;
+	double var[METREAD_NVAR];
+	metarr_struct W;
+	climchange_struct scc;
+
+	ndays = (last_year - first_year) * nDAYS_OF_YEAR;
+
+	for (i = 0; !errorCode && i < ndays; i++)
+	{
+		sd = first_year * nDAYS_OF_YEAR + i;
+		if (sd < S->firstgap)
+		{
+			if (fscanf(f, "%i%i%lf%lf%lf%lf%lf%lf%lf%*[^\n]", &year, &day, &var[0], &var[1], &var[2], &var[3], &var[4], &var[5], &var[6]) != 2 + METREAD_NVAR)
+			{
+				if (verbose) printf("ERROR reading MET variables for the window of the streamed met input (simulation day %i)\n", sd);
+				errorCode=218;
+			}
+		}
+		else
+		{
+			for (k = 0; k < METREAD_NVAR; k++) var[k] = S->gap[(sd - S->firstgap) * METREAD_NVAR + k];
+		}
+
+		array[METARR_TMAX][i]    = var[0];
+		array[METARR_TMIN][i]    = var[1];
+		array[METARR_TDAY][i]    = var[2];
+		array[METARR_PRCP][i]    = var[3];
+		array[METARR_VPD][i]     = var[4];
+		array[METARR_SWAVGFD][i] = var[5];
+		array[METARR_DAYL][i]    = var[6];
+	}
+
+	if (!errorCode)
+	{
+		memset(&W, 0, sizeof(metarr_struct));
+		W.Tmax_array     = array[METARR_TMAX];
+		W.Tmin_array     = array[METARR_TMIN];
+		W.Tday_array     = array[METARR_TDAY];
+		W.prcp_array     = array[METARR_PRCP];
+		W.vpd_array      = array[METARR_VPD];
+		W.swavgfd_array  = array[METARR_SWAVGFD];
+		W.par_array      = array[METARR_PAR];
+		W.dayl_array     = array[METARR_DAYL];
+		W.tempradF_array = array[METARR_TEMPRADF];
+
+		scc.s_Tmax    = S->scale[0];
+		scc.s_Tmin    = S->scale[1];
+		scc.s_prcp    = S->scale[2];
+		scc.s_vpd     = S->scale[3];
+		scc.s_swavgfd = S->scale[4];
+		metarr_scale(&W, &scc, 0, ndays);
+
+		/* the recursion is continued from the last day of the preceding year */
+		if (first_year)
+			W.tempradF_array[0] = (1 - S->albedo_sw) * W.tempradF_array[0] + S->albedo_sw * S->tempradF_last[first_year-1];
+		for (i = 1; i < ndays; i++)
+			W.tempradF_array[i] = (1 - S->albedo_sw) * W.tempradF_array[i] + S->albedo_sw * W.tempradF_array[i-1];
+	}
+
+	return (errorCode);
+}
+
+
+#ifdef METSTREAM_PREFETCH
+static void* metarr_prefetch_thread(void* arg)
+{
+	metprefetch_struct* P = (metprefetch_struct*) arg;
+
+	P->errorCode = metarr_stream_read(P->S, P->f, P->first_year, P->last_year, P->array, 0);
+
+	return (NULL);
+}
+#endif
+
+
+/* the prefetch thread of the stream is waited for */
+static void metarr_prefetch_join(metstream_struct* S)
+{
+	metprefetch_struct* P = (metprefetch_struct*) S->prefetch;
+
+	if (!P || !P->active) return;
+
+#ifdef METSTREAM_PREFETCH
+	pthread_join(P->thread, NULL);
+#endif
+	if (P->f) fclose(P->f);
+	P->f      = NULL;
+	P->active = 0;
+}
+
+
+/* prefetch of the window from the year before simyr into the second window arrays (the window is read by the load if the
+   prefetch can not be started) */
+static void metarr_prefetch_start(metstream_struct* S, int simyr)
+{
+#ifdef METSTREAM_PREFETCH
+	int n, first_year, last_year;
+	metprefetch_struct* P = (metprefetch_struct*) S->prefetch;
+
+	metarr_stream_range(S, simyr, &first_year, &last_year);
+	if (P) P->first_year = -1;
+
+	/* the actual window (the window holds every simulation year) */
+	if (S->last > S->first && first_year * nDAYS_OF_YEAR == S->first) return;
+
+	if (!P)
+	{
+		P = (metprefetch_struct*) calloc(1, sizeof(metprefetch_struct));
+		for (n = 0; P && n < METARR_NVAR; n++)
+		{
+			if (S->array[n] && !(P->array[n] = (double*) malloc((S->nwindow + 1) * nDAYS_OF_YEAR * sizeof(double))))
+			{
+				for (n = 0; n < METARR_NVAR; n++) free(P->array[n]);
+				free(P);
+				P = NULL;
+			}
+		}
+		if (!P) return;
+		P->S        = S;
+		S->prefetch = P;
+	}
+
+	if (metarr_stream_open(S, first_year, &P->f, 0)) return;
+
+	P->errorCode  = 0;
+	P->first_year = first_year;
+	P->last_year  = last_year;
+	P->active     = !pthread_create(&P->thread, NULL, metarr_prefetch_thread, P);
+	if (!P->active)
+	{
+		if (P->f) fclose(P->f);
+		P->f          = NULL;
+		P->first_year = -1;
+	}
+#else
+	(void) S;
+	(void) simyr;
+#endif
+}
+
+
+/* the prefetch of the stream is finished and its window arrays are freed */
+static void metarr_prefetch_free(metstream_struct* S)
+{
+	int n;
+	double* array;
+	metprefetch_struct* P = (metprefetch_struct*) S->prefetch;
+
+	if (!P) return;
+
+	metarr_prefetch_join(S);
+
+	/* the stream gets back its own window arrays */
+	if (P->nswap % 2)
+	{
+		for (n = 0; n < METARR_NVAR; n++)
+		{
+			array       = S->array[n];
+			S->array[n] = P->array[n];
+			P->array[n] = array;
+		}
+		S->first = S->last = 0;
+	}
+
+	for (n = 0; n < METARR_NVAR; n++) free(P->array[n]);
+	free(P);
+	S->prefetch = NULL;
+}
+
+
+/* window of the streamed met input from the year before simyr: the prefetched window is taken by exchanging the window
+   arrays, other windows are read; then the next window (after the last year: the first one, which the next spinup cycle
+   needs) is prefetched */
+static int metarr_stream_load(metstream_struct* S, int simyr)
+{
+	int errorCode=0;
+	int first_year, last_year, n;
+	double* array;
+	FILE* f=NULL;
+	metprefetch_struct* P;
+
+	metarr_stream_range(S, simyr, &first_year, &last_year);
+
+	S->first = S->last = 0;
+
+	metarr_prefetch_join(S);
+	P = (metprefetch_struct*) S->prefetch;
+
+	if (P && P->first_year == first_year && !P->errorCode)
+	{
+		for (n = 0; n < METARR_NVAR; n++)
+		{
+			array       = S->array[n];
+			S->array[n] = P->array[n];
+			P->array[n] = array;
+		}
+		P->nswap     += 1;
+		P->first_year = -1;
+	}
+	else
+	{
+		errorCode = metarr_stream_open(S, first_year, &f, 1);
+		if (!errorCode) errorCode = metarr_stream_read(S, f, first_year, last_year, S->array, 1);
+		if (f) fclose(f);
+	}
+
+	if (!errorCode)
+	{
+		S->first  = first_year * nDAYS_OF_YEAR;
+		S->last   = last_year * nDAYS_OF_YEAR;
+		S->nload += 1;
+
+		metarr_prefetch_start(S, last_year < S->nyears ? last_year : 0);
+	}
+
+	return (errorCode);
+}
+
+
+double metarr_stream_value(metstream_struct* S, int var, int day)
+{
+	/* a day outside of the window: the window is loaded (after an error of a load the value is 0, see daymet()) */
+	if ((day < S->first || day >= S->last) && !S->errorCode) S->errorCode = metarr_stream_load(S, day / nDAYS_OF_YEAR);
+
+	return (S->errorCode ? 0 : S->array[var][day - S->first]);
+}
+
+
+int metarr_stream_copy(metarr_struct* metarr)
+{
+	/* own window of a run (the slices of the parallel-in-time execution are simulated in parallel), the results of the scan
+	   of the met file are shared */
+	int errorCode=0;
+	int n;
+	double* array[METARR_NVAR];
+	metstream_struct* S;
+
+	S = (metstream_struct*) malloc(sizeof(metstream_struct));
+	if (!S) errorCode=1;
+
+	for (n = 0; n < METARR_NVAR; n++)
+	{
+		array[n] = NULL;
+		if (!errorCode && metarr->stream->array[n])
+		{
+			array[n] = (double*) malloc((metarr->stream->nwindow + 1) * nDAYS_OF_YEAR * sizeof(double));
+			if (!array[n]) errorCode=1;
+		}
+	}
+
+	if (errorCode)
+	{
+		printf("ERROR allocating for window of the streamed met input, metarr_stream_copy()\n");
+		for (n = 0; n < METARR_NVAR; n++) free(array[n]);
+		free(S);
+		return (errorCode);
+	}
+
+	*S = *metarr->stream;
+	for (n = 0; n < METARR_NVAR; n++) S->array[n] = array[n];
+	S->first    = S->last = 0;
+	S->nload    = 0;
+	S->prefetch = NULL;
+	S->parent = metarr->stream;
+	metarr->stream = S;
+
+	return (errorCode);
+}
+
+
+void metarr_stream_free(metarr_struct* metarr)
+{
+	/* window of a run (metarr_stream_copy()): its loads are counted in the stream of the simulation */
+	int n;
+	metstream_struct* S = metarr->stream;
+
+	if (!S || !S->parent) return;
+
+	#pragma omp atomic
+	S->parent->nload += S->nload;
+
+	metarr_prefetch_free(S);
+	for (n = 0; n < METARR_NVAR; n++) free(S->array[n]);
+	metarr->stream = S->parent;
+	free(S);
+}
+
+
+void metarr_stream_release(void)
+{
+	/* the prefetch of the stream of the simulation is finished before its arena is released (pointbgc_run()) */
+	if (metstream_actual) metarr_prefetch_free(metstream_actual);
+	metstream_actual = NULL;
+}
+
+
+/* streamed met input: the records of the met file are read serially and checked as in metarr_init(), the positions of the
+   simulation years, tempradF of the year ends and the days after the last record (averages of the previous years) are
+   stored; the annual temperature data are summed during the scan */
+static int metarr_stream_init(point_struct* point, metarr_struct* metarr, const climchange_struct* scc, const siteconst_struct* sitec, const control_struct* ctrl)
+{
+	int errorCode=0;
+	int sd, k, n, q, metread, shift, n_METvar;
+	int ndays, nsimdays, nyears, nwindays, year, day, gapday, invalid;
+	long pos;
+	double tempradF=0;
+	double var[METREAD_NVAR];
+	double value[METREAD_NVAR+2];
+	double* gapsum=NULL;
+	metarr_struct D;
+	metread_struct MR;
+	metannual_struct A;
+	metstream_struct* S;
+
+	n_METvar = 9;
+	year = day = 0;
+	nyears   = ctrl->simyears;
+	ndays    = nDAYS_OF_YEAR * nyears;
+	nsimdays = nDAYS_OF_YEAR * (nyears-1) + point->nday_lastsimyear;
+	nwindays = (metarr_stream_nwindow + 1) * nDAYS_OF_YEAR;
+	for (k = 0; k < METREAD_NVAR; k++) var[k] = 0;
+
+	/* the daily arrays are replaced by the window */
+	memset(metarr, 0, sizeof(metarr_struct));
+	metarr->compact = 1;
+
+	S = (metstream_struct*) arena_malloc(sizeof(metstream_struct));
+	if (!S)
+	{
+		printf("ERROR allocating for streamed met input\n");
+		errorCode=218;
+	}
+	else
+	{
+		memset(S, 0, sizeof(metstream_struct));
+		S->metf          = point->metf;
+		S->metf.ptr      = NULL;
+		S->scale[0]      = scc->s_Tmax;
+		S->scale[1]      = scc->s_Tmin;
+		S->scale[2]      = scc->s_prcp;
+		S->scale[3]      = scc->s_vpd;
+		S->scale[4]      = scc->s_swavgfd;
+		S->albedo_sw     = sitec->albedo_sw;
+		S->nyears        = nyears;
+		S->nwindow       = metarr_stream_nwindow;
+		S->offset        = (long*) arena_malloc(nyears * sizeof(long));
+		S->tempradF_last = (double*) arena_malloc(nyears * sizeof(double));
+		if (!S->offset || !S->tempradF_last) errorCode=218;
+
+		/* variables of the window, the others are calculated by metarr_value() */
+		for (n = METARR_PAR; n < METARR_NVAR; n++)
+		{
+			S->array[n] = (double*) arena_malloc(nwindays * sizeof(double));
+			if (!S->array[n]) errorCode=218;
+		}
+
+		gapsum = (double*) calloc(METREAD_NVAR * nDAYS_OF_YEAR, sizeof(double));
+		if (!gapsum) errorCode=218;
+
+		if (errorCode) printf("ERROR allocating for streamed met input\n");
+	}
+	metarr->stream   = S;
+	metstream_actual = S;
+
+	/* annual temperature data: the days are summed during the scan */
+	if (!errorCode) errorCode = metarr_annual_alloc(metarr, nyears);
+
+	/* southen hemisphere: year from 1th of July - last simulation year: truncated year */
+	shift = ctrl->south_shift;
+	point->nday_lastsimyear -= shift;
+	if (point->nday_lastsimyear < 0) 
+	{
+		printf("ERROR in meteorological file: in southen hemisphere the number of days in the last simulation year must greater than 182\n");
+		errorCode=218;
+	}
+
+	if (!errorCode)
+	{
+		S->firstgap = nDAYS_OF_YEAR * (nyears-1) + point->nday_lastsimyear;
+		if (S->firstgap < ndays)
+		{
+			S->gap = (double*) arena_malloc((ndays - S->firstgap) * METREAD_NVAR * sizeof(double));
+			if (!S->gap)
+			{
+				printf("ERROR allocating for streamed met input\n");
+				errorCode=218;
+			}
+		}
+	}
+
+	/* the climate change scenario is applied day by day (the same arithmetic as on the stored arrays) */
+	memset(&D, 0, sizeof(metarr_struct));
+	D.Tmax_array     = &value[0];
+	D.Tmin_array     = &value[1];
+	D.Tday_array     = &value[2];
+	D.prcp_array     = &value[3];
+	D.vpd_array      = &value[4];
+	D.swavgfd_array  = &value[5];
+	D.dayl_array     = &value[6];
+	D.par_array      = &value[7];
+	D.tempradF_array = &value[8];
+
+	memset(&MR, 0, sizeof(metread_struct));
+	MR.f = point->metf.ptr;
+
+	sd=0;
+	gapday=0;
+	while (!errorCode && sd < ndays)
+	{
+		pos     = ftell(MR.f);
+		metread = metread_next(&MR, &year,&day,&var[0],&var[1],&var[2],&var[3],&var[4],&var[5],&var[6]);
+		invalid = METREAD_INVALID(var[3], var[4], var[5], var[6]);
+
+		if (sd+shift < nsimdays && metread != n_METvar)
+		{
+			printf("ERROR reading MET variables (must be 9 columns: year,day,Tmax,Tmin,Tday,prcp,vpd,swavgfd,dayl)\n");
+			errorCode=218;
+		}
+
+		if (sd == 0 && year > ctrl->simstartyear)
+		{
+			printf("ERROR reading MET variables: file must contain meteorological data for each simulation day (from the beginning)\n");
+			errorCode=218;
+		}
+
+		/* shifting meteorological data in southen hemisphere (averages of the previous years with climate change scenario) */
+		if (point->nday_lastsimyear < nDAYS_OF_YEAR && sd+shift >= nsimdays)
+		{
+			q = point->nday_lastsimyear + gapday - 1;
+			if (q < 0) q = 0;
+			for (k = 0; k < METREAD_NVAR; k++) var[k] = gapsum[k * nDAYS_OF_YEAR + q] / (nyears-1);
+			gapday += 1;
+			invalid = METREAD_INVALID(var[3], var[4], var[5], var[6]);
+		}
+
+		if (year >= ctrl->simstartyear && year < ctrl->simstartyear + ctrl->simyears)
+		{
+			if (invalid)
+			{
+				printf("ERROR in met file: negative prcp/vpd/swavgfd/dayl or zero swavgfd/dayl data, metv_init()\n");
+				errorCode=218;
+			}
+		}
+		else
+		{
+			if (sd == 0 && year > ctrl->simstartyear)
+			{
+				printf("ERROR reading met array, metarr_init()\n");
+				printf("Note: file must contain meteorological data for each simulation day\n");
+				errorCode=218;
+			}
+		}
+
+		if (!errorCode && (year > ctrl->simstartyear || (year == ctrl->simstartyear && day > shift)))
+		{
+			if (sd % nDAYS_OF_YEAR == 0) S->offset[sd / nDAYS_OF_YEAR] = pos;
+			if (sd >= S->firstgap)
+				for (k = 0; k < METREAD_NVAR; k++) S->gap[(sd - S->firstgap) * METREAD_NVAR + k] = var[k];
+
+			/* tempradF of the year ends for the recursion in the windows */
+			for (k = 0; k < METREAD_NVAR; k++) value[k] = var[k];
+			metarr_scale(&D, scc, 0, 1);
+			if (sd) value[8] = (1 - sitec->albedo_sw) * value[8] + sitec->albedo_sw * tempradF;
+			tempradF = value[8];
+			if (sd % nDAYS_OF_YEAR == nDAYS_OF_YEAR - 1) S->tempradF_last[sd / nDAYS_OF_YEAR] = tempradF;
+
+			/* daily average temperature as in metarr_value() on the window */
+			metarr_annual_day(metarr, &A, sd, (value[0] + value[1]) / 2.0);
+
+			/* sums of the previous years for the days after the last record */
+			if (sd < nDAYS_OF_YEAR * (nyears-1))
+				for (k = 0; k < METREAD_NVAR; k++) gapsum[k * nDAYS_OF_YEAR + sd % nDAYS_OF_YEAR] += value[k];
+
+			sd += 1;
+		}
+	}
+
+	free(gapsum);
+
+	if (!errorCode) errorCode = metarr_annual_avg(metarr, nyears);
+
+	/* the first window is prefetched during the initialization of the simulation */
+	if (!errorCode) metarr_prefetch_start(S, 0);
+
+	return (errorCode);
+}
+
+
 int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_struct* scc,const siteconst_struct* sitec, const control_struct* ctrl) 
 {
 	int errorCode=0;
-	int sd,j, metread, shift,y,m,d,nm;
+	int sd,j, metread, shift;
 	int ndays, nsimdays, dd, n_METvar;
-	int nyears, year, day,gapday;
-	double Tmax, Tmin, Tday, Tavg, prcp, vpd, swavgfd, dayl;
-	double sw_MJ;
-	double annTavgSUM, annTrangeSUM,monthTavgSUM, minTmonth, maxTmonth;
-
-	int nMONTHday_array[]={31,28,31,30,31,30,31,31,30,31,30,31};
+	int nyears, year, day,gapday, nscaled, invalid;
+	double Tmax, Tmin, Tday, prcp, vpd, swavgfd, dayl;
+	double* dayl_temp;
+	metread_struct MR;
 
 	n_METvar = 9;
-	Tmax=Tmin=Tday=Tavg=prcp=vpd=swavgfd=dayl=0;
+	metarr->compact    = metarr_compact_flag;
+	metarr->dayl_float = NULL;
+	Tmax=Tmin=Tday=prcp=vpd=swavgfd=dayl=0;
 	nyears = ctrl->simyears;
 	ndays    = nDAYS_OF_YEAR * nyears;
 	nsimdays = nDAYS_OF_YEAR * (nyears-1) + point->nday_lastsimyear;
+	metarr->stream = NULL;
+
+	/* streamed met input: only a window of the daily variables is stored */
+	if (metarr_stream_nwindow) return (metarr_stream_init(point, metarr, scc, sitec, ctrl));
 
 	/* allocate space for the metv arrays */
 	if (!errorCode)
 	{
-		metarr->Tmax_array = (double*) malloc(ndays * sizeof(double));
+		metarr->Tmax_array = (double*) arena_malloc(ndays * sizeof(double));
 		if (!metarr->Tmax_array)
 		{
 			printf("ERROR allocating for Tmax array\n");
@@ -69,7 +1077,7 @@ int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_str
 
 	if (!errorCode)
 	{
-		metarr->Tmin_array = (double*) malloc(ndays * sizeof(double));
+		metarr->Tmin_array = (double*) arena_malloc(ndays * sizeof(double));
 		if (!metarr->Tmin_array)
 		{
 			printf("ERROR allocating for Tmin array\n");
@@ -79,7 +1087,7 @@ int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_str
 
 	if (!errorCode)
 	{
-		metarr->prcp_array = (double*) malloc(ndays * sizeof(double));
+		metarr->prcp_array = (double*) arena_malloc(ndays * sizeof(double));
 		if (!metarr->prcp_array)
 		{
 			printf("ERROR allocating for prcp array\n");
@@ -89,7 +1097,7 @@ int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_str
 
 	if (!errorCode)
 	{
-		metarr->vpd_array = (double*) malloc(ndays * sizeof(double));
+		metarr->vpd_array = (double*) arena_malloc(ndays * sizeof(double));
 		if (!metarr->vpd_array)
 		{
 			printf("ERROR allocating for vpd array\n");
@@ -99,7 +1107,7 @@ int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_str
 
 	if (!errorCode)
 	{
-		metarr->Tday_array = (double*) malloc(ndays * sizeof(double));
+		metarr->Tday_array = (double*) arena_malloc(ndays * sizeof(double));
 		if (!metarr->Tday_array)
 		{
 			printf("ERROR allocating for Tday array\n");
@@ -107,9 +1115,11 @@ int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_str
 		}
 	}
 
-	if (!errorCode)
+	/* derived arrays (Tavg, running averages): not stored in the compact met store */
+	metarr->Tavg_array = NULL;
+	if (!errorCode && !metarr->compact)
 	{
-		metarr->Tavg_array = (double*) malloc(ndays * sizeof(double));
+		metarr->Tavg_array = (double*) arena_malloc(ndays * sizeof(double));
 		if (!metarr->Tavg_array)
 		{
 			printf("ERROR allocating for Tavg11 array\n");
@@ -117,9 +1127,10 @@ int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_str
 		}
 	}
 
-	if (!errorCode)
+	metarr->TavgRA11_array = NULL;
+	if (!errorCode && !metarr->compact)
 	{
-		metarr->TavgRA11_array = (double*) malloc(ndays * sizeof(double));
+		metarr->TavgRA11_array = (double*) arena_malloc(ndays * sizeof(double));
 		if (!metarr->TavgRA11_array)
 		{
 			printf("ERROR allocating for TavgRA11 array\n");
@@ -129,9 +1140,10 @@ int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_str
 
 	/* new arrays */
 	
-	if (!errorCode)
+	metarr->TavgRA30_array = NULL;
+	if (!errorCode && !metarr->compact)
 	{
-		metarr->TavgRA30_array = (double*) malloc(ndays * sizeof(double));
+		metarr->TavgRA30_array = (double*) arena_malloc(ndays * sizeof(double));
 		if (!metarr->TavgRA30_array)
 		{
 			printf("ERROR allocating for TavgRA30 array\n");
@@ -139,9 +1151,10 @@ int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_str
 		}
 	}
 
-	if (!errorCode)
+	metarr->TavgRA10_array = NULL;
+	if (!errorCode && !metarr->compact)
 	{
-		metarr->TavgRA10_array = (double*) malloc(ndays * sizeof(double));
+		metarr->TavgRA10_array = (double*) arena_malloc(ndays * sizeof(double));
 		if (!metarr->TavgRA10_array)
 		{
 			printf("ERROR allocating for TavgRA10 array\n");
@@ -151,7 +1164,7 @@ int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_str
 
 	if (!errorCode)
 	{
-		metarr->tempradF_array = (double*) malloc(ndays * sizeof(double));
+		metarr->tempradF_array = (double*) arena_malloc(ndays * sizeof(double));
 		if (!metarr->tempradF_array)
 		{
 			printf("ERROR allocating for tempradF array\n");
@@ -159,9 +1172,10 @@ int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_str
 		}
 	}
 
-	if (!errorCode)
+	metarr->tempradFra_array = NULL;
+	if (!errorCode && !metarr->compact)
 	{
-		metarr->tempradFra_array = (double*) malloc(ndays * sizeof(double));
+		metarr->tempradFra_array = (double*) arena_malloc(ndays * sizeof(double));
 		if (!metarr->tempradFra_array)
 		{
 			printf("ERROR allocating for tempradFra array\n");
@@ -171,7 +1185,7 @@ int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_str
 
 	if (!errorCode)
 	{
-		metarr->swavgfd_array = (double*) malloc(ndays * sizeof(double));
+		metarr->swavgfd_array = (double*) arena_malloc(ndays * sizeof(double));
 		if (!metarr->swavgfd_array)
 		{
 			printf("ERROR allocating for swavgfd array\n");
@@ -179,9 +1193,11 @@ int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_str
 		}
 	}
 	
-	if (!errorCode)
+	/* par: not stored in the compact met store if swavgfd is not scaled (par = swavgfd * 0.45) */
+	metarr->par_array = NULL;
+	if (!errorCode && !(metarr->compact && scc->s_swavgfd == 1))
 	{
-		metarr->par_array = (double*) malloc(ndays * sizeof(double));
+		metarr->par_array = (double*) arena_malloc(ndays * sizeof(double));
 		if (!metarr->par_array)
 		{
 			printf("ERROR allocating for par array\n");
@@ -189,9 +1205,13 @@ int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_str
 		}
 	}
 	
+	/* daylength: temporary array in the compact met store (stored at the end in single precision, if it is exact) */
 	if (!errorCode)
 	{
-		metarr->dayl_array = (double*) malloc(ndays * sizeof(double));
+		if (metarr->compact)
+			metarr->dayl_array = (double*) malloc(ndays * sizeof(double));
+		else
+			metarr->dayl_array = (double*) arena_malloc(ndays * sizeof(double));
 		if (!metarr->dayl_array)
 		{
 			printf("ERROR allocating for dayl_array\n");
@@ -199,55 +1219,6 @@ int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_str
 		}
 	}
 
-	if (!errorCode)
-	{
-		metarr->annTavg_array = (double*) malloc(nyears * sizeof(double));
-		if (!metarr->annTavg_array)
-		{
-			printf("ERROR allocating for annTavg_array\n");
-			errorCode=218;
-		}
-	}
-
-	if (!errorCode)
-	{
-		metarr->monTavg_array = (double*) malloc(nyears * 12 * sizeof(double));
-		if (!metarr->monTavg_array)
-		{
-			printf("ERROR allocating for monTavg_array\n");
-			errorCode=218;
-		}
-	}
-
-	if (!errorCode)
-	{
-		metarr->annTrange_array= (double*) malloc(nyears * sizeof(double));
-		if (!metarr->annTrange_array)
-		{
-			printf("ERROR allocating for annTrange_array array\n");
-			errorCode=218;
-		}
-	}
-
-	if (!errorCode)
-	{
-		metarr->annTavgRA_array = (double*) malloc(nyears * sizeof(double));
-		if (!metarr->annTavgRA_array)
-		{
-			printf("ERROR allocating for annTavgRA_array\n");
-			errorCode=218;
-		}
-	}
-
-	if (!errorCode)
-	{
-		metarr->annTrangeRA_array= (double*) malloc(nyears * sizeof(double));
-		if (!metarr->annTrangeRA_array)
-		{
-			printf("ERROR allocating for annTrangeRA_array array\n");
-			errorCode=218;
-		}
-	}
 
 
 	/* southen hemisphere: year from 1th of July - last simulation year: truncated year */
@@ -259,12 +1230,18 @@ int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_str
 		errorCode=218;
 	}
 	
+	/* the met data lines are parsed and checked in parallel (or read serially, see metread_init()) */
+	memset(&MR, 0, sizeof(metread_struct));
+	if (!errorCode) metread_init(point->metf.ptr, &MR);
+
 	sd=0;
 	gapday=0;
-	/* begin daily loop: read input file, generate array values */
+	nscaled=0;
+	/* begin daily loop: read records, store the raw values (climate change scenario is applied after the loop) */
 	while (!errorCode && sd < ndays)
 	{
-		metread = fscanf(point->metf.ptr,"%i%i%lf%lf%lf%lf%lf%lf%lf%*[^\n]",&year,&day,&Tmax,&Tmin,&Tday,&prcp,&vpd,&swavgfd,&dayl);
+		metread = metread_next(&MR, &year,&day,&Tmax,&Tmin,&Tday,&prcp,&vpd,&swavgfd,&dayl);
+		invalid = (MR.f || !MR.next) ? METREAD_INVALID(prcp, vpd, swavgfd, dayl) : MR.invalid[MR.next-1];
 		
 		if (sd+shift < nsimdays && metread != n_METvar)
 		{
@@ -278,9 +1255,12 @@ int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_str
 			errorCode=218;
 		}
 			
-		/* shifting meteorological data in southen hemisphere */
+		/* shifting meteorological data in southen hemisphere (averages of the previous years with climate change scenario) */
 		if (point->nday_lastsimyear < nDAYS_OF_YEAR && sd+shift >= nsimdays)
 		{
+			metarr_scale(metarr, scc, nscaled, sd);
+			nscaled = sd;
+
 			Tmax=Tmin=Tday=prcp=vpd=swavgfd=dayl=0;
 			for (j=0; j<nyears-1;j++)
 			{
@@ -302,6 +1282,7 @@ int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_str
 			swavgfd = swavgfd / (nyears-1);
 			dayl    = dayl    / (nyears-1);
 			gapday      += 1;
+			invalid = METREAD_INVALID(prcp, vpd, swavgfd, dayl);
 		}
 	
 
@@ -311,7 +1292,7 @@ int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_str
 		{
 		
 			/* control to avoid negative meteorological data */
- 			if (prcp < 0 || vpd < 0 || swavgfd <= 0 || dayl <= 0)
+ 			if (invalid)
 			{
 				printf("ERROR in met file: negative prcp/vpd/swavgfd/dayl or zero swavgfd/dayl data, metv_init()\n");
 				errorCode=218;
@@ -328,30 +1309,16 @@ int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_str
 		}
 
 		
-		/* apply the climate change scenario and store */
+		/* store the raw values */
 		if (!errorCode && (year > ctrl->simstartyear || (year == ctrl->simstartyear && day > shift)))
 		{
-			metarr->Tmax_array[sd] = Tmax + scc->s_Tmax;
-			metarr->Tmin_array[sd] = Tmin + scc->s_Tmin;
-			Tavg = (Tmax + Tmin) / 2.0;
-			
-			metarr->Tavg_array[sd] = (metarr->Tmax_array[sd] + metarr->Tmin_array[sd]) / 2.0;
-			metarr->Tday_array[sd] = Tday + (metarr->Tavg_array[sd] - Tavg); 
-
-			metarr->prcp_array[sd] = prcp * scc->s_prcp;
-			metarr->vpd_array[sd] = vpd * scc->s_vpd;
-			metarr->swavgfd_array[sd] = swavgfd * scc->s_swavgfd;
-			metarr->par_array[sd] = swavgfd * 0.45 * scc->s_swavgfd;
-			metarr->dayl_array[sd] = dayl;
-
-			/* factor for soil temp. calculation */
-			sw_MJ = swavgfd * dayl / 1000000;
-			if (sd == 0)
-				metarr->tempradF_array[sd] = metarr->Tavg_array[sd] +  (Tmax - metarr->Tavg_array[sd]) * sqrt(sw_MJ*0.03);
-			else
-				metarr->tempradF_array[sd] = (1 - sitec->albedo_sw) * (metarr->Tavg_array[sd] +  (Tmax - metarr->Tavg_array[sd]) * sqrt(sw_MJ*0.03))
-										+ sitec->albedo_sw * metarr->tempradF_array[sd-1];
-
+			metarr->Tmax_array[sd]    = Tmax;
+			metarr->Tmin_array[sd]    = Tmin;
+			metarr->Tday_array[sd]    = Tday;
+			metarr->prcp_array[sd]    = prcp;
+			metarr->vpd_array[sd]     = vpd;
+			metarr->swavgfd_array[sd] = swavgfd;
+			metarr->dayl_array[sd]    = dayl;
 						
 			/* counter of simdays*/			
 			sd += 1;
@@ -360,106 +1327,90 @@ int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_str
 
 	}
 
-	/* calculating annual air temperature and annual air temperature range */
+	metread_free(&MR);
 
-	for (y=0; y<nyears;y++)
+	/* apply the climate change scenario (in parallel), then the recursion of the factor for soil temp. calculation */
+	if (!errorCode)
 	{
-		annTavgSUM = 0;
-		monthTavgSUM = 0;
-		minTmonth = 0;
-		maxTmonth = 0;
-		m=0;
-		nm=0;
-
-		for (d=0; d<nDAYS_OF_YEAR-1;d++)
-		{
-			annTavgSUM += metarr->Tavg_array[y*nDAYS_OF_YEAR+d];
-
-			if (nm < nMONTHday_array[m])
-			{
-				monthTavgSUM += metarr->Tavg_array[y*nDAYS_OF_YEAR+d];
-				nm=nm+1;
-			}
-			else
-			{
-				metarr->monTavg_array[y*nMONTHS_OF_YEAR+m] = monthTavgSUM/nMONTHday_array[m];
-
-				if (monthTavgSUM/nMONTHday_array[m] < minTmonth) minTmonth = monthTavgSUM/nMONTHday_array[m];
-				if (monthTavgSUM/nMONTHday_array[m] > maxTmonth) maxTmonth = monthTavgSUM/nMONTHday_array[m];
+		metarr_scale(metarr, scc, nscaled, sd);
 
-				m=m+1;
-				nm=0;
-				monthTavgSUM = 0;
-			}
-				
-		}
-		metarr->annTavg_array[y]    = annTavgSUM/nDAYS_OF_YEAR;
-		metarr->annTrange_array[y] = maxTmonth - minTmonth;
+		for (sd = 1; sd < ndays; sd++)
+			metarr->tempradF_array[sd] = (1 - sitec->albedo_sw) * metarr->tempradF_array[sd] + sitec->albedo_sw * metarr->tempradF_array[sd-1];
 	}
 
+	/* calculating annual air temperature and annual air temperature range (with their running averages) */
+	if (!errorCode) errorCode = metarr_annual(metarr, nyears);
+
 	/* perform running averages of daily average temperature for 
 	use in soil temperature routine. 
 
 	This implementation uses a linearly ramped 11-day running average 
 	of daily mean air temperature, with days 1-10 based on a 1-10 day
 	running average, respectively. 
+
+	In the compact met store the running averages are calculated on demand (metarr_value()).
 	*/
 	
 	
-	if (!errorCode && run_avg(metarr->Tavg_array, metarr->TavgRA11_array, ndays, 11, 1))
+	if (!errorCode && !metarr->compact && run_avg(metarr->Tavg_array, metarr->TavgRA11_array, ndays, 11, 1))
 	{
 		printf("ERROR: run_avg() in metv_init.c \n");
 		errorCode=218;
 	}
 	
 	/*  new averages */
-	if (!errorCode && run_avg(metarr->Tavg_array, metarr->TavgRA30_array, ndays, 30, 0))
+	if (!errorCode && !metarr->compact && run_avg(metarr->Tavg_array, metarr->TavgRA30_array, ndays, 30, 0))
 	{
 		printf("ERROR: run_avg() in metv_init.c \n");
 		errorCode=218;
 	}
 
-	if (!errorCode && run_avg(metarr->Tavg_array, metarr->TavgRA10_array, ndays, 10, 0))
+	if (!errorCode && !metarr->compact && run_avg(metarr->Tavg_array, metarr->TavgRA10_array, ndays, 10, 0))
 	{
 		printf("ERROR: run_avg() in metv_init.c \n");
 		errorCode=218;
 	}
 
-	if (!errorCode && run_avg(metarr->tempradF_array, metarr->tempradFra_array, ndays, 5, 0))
+	if (!errorCode && !metarr->compact && run_avg(metarr->tempradF_array, metarr->tempradFra_array, ndays, 5, 0))
 	{
 		printf("ERROR: run_avg() in metv_init.c \n");
 		errorCode=218;
 	}
 
 
-	/* calculation of 10-year running average of mean annual air temperature and mean annual air tempearture range */
-	if (nyears > 10)
-	{
-		if (!errorCode && run_avg(metarr->annTavg_array, metarr->annTavgRA_array, nyears, 10, 0))
-		{
-			printf("ERROR: run_avg() in metv_init.c \n");
-			errorCode=218;
-		}
-		if (!errorCode && run_avg(metarr->annTrange_array, metarr->annTrangeRA_array, nyears, 10, 0))
-		{
-			printf("ERROR: run_avg() in metv_init.c \n");
-			errorCode=218;
-		}
-	}
-	else
+	/* compact met store: daylength in single precision if each value is exact in it, otherwise in double precision */
+	if (metarr->compact && metarr->dayl_array)
 	{
+		for (sd = 0; sd < ndays && (double) (float) metarr->dayl_array[sd] == metarr->dayl_array[sd]; sd++);
 
-		annTavgSUM=0;
-		annTrangeSUM=0;
-		for (y=0; y<nyears; y++)
+		if (!errorCode && sd == ndays)
 		{
-			annTavgSUM   += metarr->annTavg_array[y];
-			annTrangeSUM += metarr->annTrange_array[y];
+			metarr->dayl_float = (float*) arena_malloc(ndays * sizeof(float));
+			if (!metarr->dayl_float)
+			{
+				printf("ERROR allocating for dayl_float array\n");
+				errorCode=218;
+			}
+			for (sd = 0; !errorCode && sd < ndays; sd++) metarr->dayl_float[sd] = (float) metarr->dayl_array[sd];
+			free(metarr->dayl_array);
+			metarr->dayl_array = NULL;
 		}
-		for (y=0; y<nyears; y++)
+		else
 		{
-			metarr->annTavgRA_array[y]   = annTavgSUM/nyears;
-			metarr->annTrangeRA_array[y] = annTrangeSUM/nyears;
+			dayl_temp = metarr->dayl_array;
+			metarr->dayl_array = NULL;
+			if (!errorCode)
+			{
+				metarr->dayl_array = (double*) arena_malloc(ndays * sizeof(double));
+				if (!metarr->dayl_array)
+				{
+					printf("ERROR allocating for dayl_array\n");
+					errorCode=218;
+				}
+				else
+					memcpy(metarr->dayl_array, dayl_temp, ndays * sizeof(double));
+			}
+			free(dayl_temp);
 		}
 	}
 
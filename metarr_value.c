@@ -0,0 +1,151 @@
+/*
+metarr_value.c
+daily variables of the met arrays which are derived from the stored drivers: they are read from the arrays, or in the
+compact met store (only the raw drivers are stored) calculated on demand with the same arithmetic as in metarr_init();
+in the streamed met input the stored variables are read from the window of the met file; size of the met store of a site
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "bgc_func.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_constants.h"
+
+
+/* running average of a day as by run_avg() (w: width of the window, w_flag: 1=linearly weighted, 0=constant weighted):
+   the window is summed in the same order, so the result is identical to the element of the stored array */
+static double metarr_runavg(const metarr_struct* metarr, int var, int day, int w, int w_flag)
+{
+	int j;
+	double total=0.0, sum=0.0, wt;
+
+	for (j = (day < w-1) ? w-day-1 : 0; j < w; j++)
+	{
+		wt     = w_flag ? (double) (j+1) : 1.0;
+		total += wt * metarr_value(metarr, var, day-w+j+1);
+		sum   += wt;
+	}
+
+	return (total/sum);
+}
+
+
+double metarr_value(const metarr_struct* metarr, int var, int day)
+{
+	double value=0;
+
+	/* streamed met input: the variables of the window, the others are calculated from them */
+	if (metarr->stream && metarr->stream->array[var]) return (metarr_stream_value(metarr->stream, var, day));
+
+	switch (var)
+	{
+		case METARR_TAVG:
+			value = metarr->Tavg_array ? metarr->Tavg_array[day] : (metarr_value(metarr, METARR_TMAX, day) + metarr_value(metarr, METARR_TMIN, day)) / 2.0;
+			break;
+		case METARR_TAVGRA11:
+			value = metarr->TavgRA11_array ? metarr->TavgRA11_array[day] : metarr_runavg(metarr, METARR_TAVG, day, 11, 1);
+			break;
+		case METARR_TAVGRA10:
+			value = metarr->TavgRA10_array ? metarr->TavgRA10_array[day] : metarr_runavg(metarr, METARR_TAVG, day, 10, 0);
+			break;
+		case METARR_TAVGRA30:
+			value = metarr->TavgRA30_array ? metarr->TavgRA30_array[day] : metarr_runavg(metarr, METARR_TAVG, day, 30, 0);
+			break;
+		case METARR_TEMPRADFRA:
+			value = metarr->tempradFra_array ? metarr->tempradFra_array[day] : metarr_runavg(metarr, METARR_TEMPRADF, day, 5, 0);
+			break;
+		/* without par array the shortwave flux density is not scaled by the climate change scenario (see metarr_init()) */
+		case METARR_PAR:
+			value = metarr->par_array ? metarr->par_array[day] : metarr->swavgfd_array[day] * 0.45;
+			break;
+		case METARR_DAYL:
+			value = metarr->dayl_array ? metarr->dayl_array[day] : (double) metarr->dayl_float[day];
+			break;
+		case METARR_TEMPRADF:
+			value = metarr->tempradF_array[day];
+			break;
+		case METARR_TMAX:
+			value = metarr->Tmax_array[day];
+			break;
+		case METARR_TMIN:
+			value = metarr->Tmin_array[day];
+			break;
+		case METARR_TDAY:
+			value = metarr->Tday_array[day];
+			break;
+		case METARR_PRCP:
+			value = metarr->prcp_array[day];
+			break;
+		case METARR_VPD:
+			value = metarr->vpd_array[day];
+			break;
+		case METARR_SWAVGFD:
+			value = metarr->swavgfd_array[day];
+			break;
+	}
+
+	return (value);
+}
+
+
+int metarr_report(const metarr_struct* metarr, int nyears, file logfile)
+{
+	/* memory of the met store of a site in the log file: size of the full store and of the actual store */
+	size_t ndays, nbytes, nfull;
+	int n;
+	const double* array[14];
+
+	const metstream_struct* S = metarr->stream;
+
+	ndays = (size_t) nyears * nDAYS_OF_YEAR;
+
+	array[0]  = metarr->Tmax_array;
+	array[1]  = metarr->Tmin_array;
+	array[2]  = metarr->prcp_array;
+	array[3]  = metarr->vpd_array;
+	array[4]  = metarr->swavgfd_array;
+	array[5]  = metarr->par_array;
+	array[6]  = metarr->dayl_array;
+	array[7]  = metarr->Tday_array;
+	array[8]  = metarr->Tavg_array;
+	array[9]  = metarr->TavgRA11_array;
+	array[10] = metarr->TavgRA10_array;
+	array[11] = metarr->TavgRA30_array;
+	array[12] = metarr->tempradF_array;
+	array[13] = metarr->tempradFra_array;
+
+	/* daily arrays, then the annual and monthly arrays */
+	nfull  = 14 * ndays * sizeof(double) + (4 + nMONTHS_OF_YEAR) * (size_t) nyears * sizeof(double);
+	nbytes = (4 + nMONTHS_OF_YEAR) * (size_t) nyears * sizeof(double);
+	for (n = 0; n < 14; n++)
+		if (array[n]) nbytes += ndays * sizeof(double);
+	if (metarr->dayl_float) nbytes += ndays * sizeof(float);
+
+	/* streamed met input: window arrays (and the second set of the prefetch), positions of the years, tempradF of the year
+	   ends and the days after the met file */
+	if (S)
+	{
+		for (n = 0; n < METARR_NVAR; n++)
+			if (S->array[n]) nbytes += (size_t) (S->prefetch ? 2 : 1) * (S->nwindow + 1) * nDAYS_OF_YEAR * sizeof(double);
+		nbytes += (size_t) S->nyears * (sizeof(long) + sizeof(double)) + sizeof(metstream_struct);
+		if (S->gap) nbytes += (ndays - S->firstgap) * 7 * sizeof(double);
+	}
+
+	fprintf(logfile.ptr, "\n");
+	fprintf(logfile.ptr, "MEMORY OF THE MET STORE (bytes per site)\n");
+	fprintf(logfile.ptr, "%-10s %10lu\n", "full", (unsigned long) nfull);
+	fprintf(logfile.ptr, "%-10s %10lu\n", S ? "streamed" : (metarr->compact ? "compact" : "actual"), (unsigned long) nbytes);
+	if (S) fprintf(logfile.ptr, "%-10s %10i\n", "loads", S->nload);
+
+	return (ferror(logfile.ptr) ? 1 : 0);
+}
@@ -379,7 +379,7 @@ int mortality(const control_struct* ctrl, const siteconst_struct* sitec, const e
 
 		if (epv->rootDepth > CRIT_PREC)
 		{
-			for (layer = 0; layer < N_SOILLAYERS; layer++)
+			for (layer = 0; layer < sitec->n_soillayers; layer++)
 			{
 				cs->litr1c[layer]  += (cf->m_frootc_to_litr1c) * epv->rootlengthProp[layer];	
 				cs->litr2c[layer]  += (cf->m_frootc_to_litr2c) * epv->rootlengthProp[layer];	
@@ -396,7 +396,7 @@ int mortality(const control_struct* ctrl, const siteconst_struct* sitec, const e
 		}
 		else
 		{
-			for (layer = 0; layer < N_SOILLAYERS; layer++)
+			for (layer = 0; layer < sitec->n_soillayers; layer++)
 			{
 				cs->litr1c[layer]  += (cf->m_frootc_to_litr1c) * epv->rootlengthLandD_prop[layer];	
 				cs->litr2c[layer]  += (cf->m_frootc_to_litr2c) * epv->rootlengthLandD_prop[layer];	
@@ -423,7 +423,7 @@ int mortality(const control_struct* ctrl, const siteconst_struct* sitec, const e
 	if (epv->FM)
 	{
 		/* +: estimating aboveground cwdc: calculation of cwdc_total1 (before mortality decreased value) -> ratio */
-		for (layer = 0; layer < N_SOILLAYERS; layer++) 
+		for (layer = 0; layer < sitec->n_soillayers; layer++) 
 		{
 			cwdc_total1 += cs->cwdc[layer];
 			litrc_total1 += cs->litr1c[layer] + cs->litr2c[layer] + cs->litr3c[layer] + cs->litr4c[layer];
@@ -138,11 +138,11 @@ int mowing_init(file init, const control_struct* ctrl, mowing_struct* MOW)
 		MOW->MOW_num = nmgm;
 		nmgm = 0;
 		
-		MOW->MOWyear_array         = (int*) malloc(MOW->MOW_num*sizeof(double));  
-		MOW->MOWmonth_array        = (int*) malloc(MOW->MOW_num*sizeof(double)); 
-		MOW->MOWday_array          = (int*) malloc(MOW->MOW_num*sizeof(double)); 
-		MOW->LAI_limit_array	   = (double*) malloc(MOW->MOW_num*sizeof(double)); 
-		MOW->transportMOW_array    = (double*) malloc(MOW->MOW_num*sizeof(double)); 
+		MOW->MOWyear_array         = (int*) arena_malloc(MOW->MOW_num*sizeof(double));  
+		MOW->MOWmonth_array        = (int*) arena_malloc(MOW->MOW_num*sizeof(double)); 
+		MOW->MOWday_array          = (int*) arena_malloc(MOW->MOW_num*sizeof(double)); 
+		MOW->LAI_limit_array	   = (double*) arena_malloc(MOW->MOW_num*sizeof(double)); 
+		MOW->transportMOW_array    = (double*) arena_malloc(MOW->MOW_num*sizeof(double)); 
 			
 		for (nmgm = 0; nmgm < MOW->MOW_num; nmgm++)
 		{
@@ -157,13 +157,13 @@ int mulching_init(file init, control_struct* ctrl, mulching_struct* MUL)
 			
 
 		/* allocate space for the temporary MGM array */
-		MUL->MULyear_array         = (int*) malloc(MUL->MUL_num*sizeof(int));  
-		MUL->MULmonth_array        = (int*) malloc(MUL->MUL_num*sizeof(int)); 
-		MUL->MULday_array          = (int*) malloc(MUL->MUL_num*sizeof(int)); 
-		MUL->litrCabove_MUL        = (double*) malloc(MUL->MUL_num*sizeof(double)); 
-		MUL->litrCNabove_MUL       = (double*) malloc(MUL->MUL_num*sizeof(double)); 
-		MUL->cwdCabove_MUL         = (double*) malloc(MUL->MUL_num*sizeof(double)); 
-		MUL->cwdCNabove_MUL        = (double*) malloc(MUL->MUL_num*sizeof(double)); 
+		MUL->MULyear_array         = (int*) arena_malloc(MUL->MUL_num*sizeof(int));  
+		MUL->MULmonth_array        = (int*) arena_malloc(MUL->MUL_num*sizeof(int)); 
+		MUL->MULday_array          = (int*) arena_malloc(MUL->MUL_num*sizeof(int)); 
+		MUL->litrCabove_MUL        = (double*) arena_malloc(MUL->MUL_num*sizeof(double)); 
+		MUL->litrCNabove_MUL       = (double*) arena_malloc(MUL->MUL_num*sizeof(double)); 
+		MUL->cwdCabove_MUL         = (double*) arena_malloc(MUL->MUL_num*sizeof(double)); 
+		MUL->cwdCNabove_MUL        = (double*) arena_malloc(MUL->MUL_num*sizeof(double)); 
 
 		for (nmgm = 0; nmgm < MUL->MUL_num; nmgm++)
 		{
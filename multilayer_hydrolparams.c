@@ -64,7 +64,7 @@ int multilayer_hydrolparams(const siteconst_struct* sitec, const soilprop_struct
 	/* calculating VWC PSI and hydr. cond. to every layer */
 
 
-	for (layer=0; layer < N_SOILLAYERS; layer++)
+	for (layer=0; layer < sitec->n_soillayers; layer++)
 	{
 		
 		/* convert kg/m2 --> m3/m2 --> m3/m3 */
@@ -21,6 +21,10 @@ See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentatio
 #include "bgc_constants.h"
 #include "bgc_func.h"    
 
+static int hydrolprocess_profile(siteconst_struct* sitec, soilprop_struct* sprop, const epconst_struct* epc, epvar_struct* epv, 
+	                              wstate_struct* ws, wflux_struct* wf);
+
+
 int multilayer_hydrolprocess(control_struct* ctrl, siteconst_struct* sitec, soilprop_struct* sprop, const epconst_struct* epc, epvar_struct* epv, 
 	                         wstate_struct* ws, wflux_struct* wf, groundwater_struct* GWS, GWcalc_struct* gwc, flooding_struct* FLD, int* mondays)
 {
@@ -37,146 +41,173 @@ int multilayer_hydrolprocess(control_struct* ctrl, siteconst_struct* sitec, soil
 
 	Chen and Dudhia 2001 - 
 	Coupling an Advanced Land Surface-Hydrology Model with the PMM5 Modeling System Part I - MonWRev.pdf*/
-	
 
-	/* internal variables */
-	double VWC_avg, VWC_maxRZ, relVWCsat_fc_maxRZ, relVWCfc_wp_maxRZ, VWC_RZ, PSI_RZ, soilw_RZ, weight, weight_SUM, ratio, hydrCONDUCTsat_avg;
-	double soilw_hw, soilw_wp, TRP_diff, TRP_diff_SUM, soilw_trans_ctrl, soilw_before;
-	double VWCsat_RZ, VWCfc_RZ, VWCwp_RZ, VWChw_RZ, soilw_RZ_avail;
-	int layer;
-	int errorCode=0;
-	soilw_before=soilw_hw=TRP_diff=TRP_diff_SUM=soilw_trans_ctrl=VWC_avg=VWC_RZ=PSI_RZ=soilw_RZ=weight=weight_SUM=ratio=soilw_wp=soilw_RZ_avail=0;
-	VWC_RZ=VWC_maxRZ=VWCsat_RZ=VWCfc_RZ=VWCwp_RZ=VWChw_RZ=hydrCONDUCTsat_avg=relVWCsat_fc_maxRZ=relVWCfc_wp_maxRZ=0.0;
-	
-	/* ---------------------------------------------------------------------------------------- */
-	/* 1. Richards-method */
-	/* ---------------------------------------------------------------------------------------- */
+	/* the method of the soil hydrology is chosen by SHCM_flag (specialized daily steps call the method functions directly) */
 	if (epc->SHCM_flag == 1)
-	{
-		/* *****************************/
-		/* 0. GROUNDWATER PREPROCESS: 10 layers to 12 layers */
-		if (!errorCode && groundwaterR_preproc(ctrl, sitec, sprop, epv, ws, wf, GWS, gwc))
-		{
-			printf("ERROR in groundwater() from bgc.c\n");
-			errorCode=1;
-		}
+		return (multilayer_hydrolprocessR(ctrl, sitec, sprop, epc, epv, ws, wf, GWS, gwc));
+	else
+		return (multilayer_hydrolprocessT(ctrl, sitec, sprop, epc, epv, ws, wf, GWS, FLD, mondays));
+}
 
-		/* *****************************/
-		/* 1. HYDROLOGICAL CALCULATION BASED ON RICHARDS-METHOD: infiltration, percolation, diffusion, evaporation, transpiration */
-		if (!errorCode && richards(epc, sprop, ws, wf, gwc))
-		{
-			printf("\n");
-			printf("ERROR in richards() from multilayer_hydrolprocess.c()\n");
-			errorCode=1; 
-		} 
-	
 
-		/* *****************************/
-		/* 2. GROUNDWATER POSTPROCESS: 12 layers to 10 layers  */
-		if (!errorCode && groundwaterR_postproc(sitec,epv, ws, wf, gwc))
-		{
-			printf("ERROR in groundwater() from bgc.c\n");
-			errorCode=1;
-		}
+/* ---------------------------------------------------------------------------------------- */
+/* 1. Richards-method */
+/* ---------------------------------------------------------------------------------------- */
+int multilayer_hydrolprocessR(control_struct* ctrl, siteconst_struct* sitec, soilprop_struct* sprop, const epconst_struct* epc, epvar_struct* epv, 
+	                          wstate_struct* ws, wflux_struct* wf, groundwater_struct* GWS, GWcalc_struct* gwc)
+{
+	int errorCode=0;
+
+	/* *****************************/
+	/* 0. GROUNDWATER PREPROCESS: 10 layers to 12 layers */
+	if (!errorCode && groundwaterR_preproc(ctrl, sitec, sprop, epv, ws, wf, GWS, gwc))
+	{
+		printf("ERROR in groundwater() from bgc.c\n");
+		errorCode=1;
+	}
+
+	/* *****************************/
+	/* 1. HYDROLOGICAL CALCULATION BASED ON RICHARDS-METHOD: infiltration, percolation, diffusion, evaporation, transpiration */
+	if (!errorCode && richards(sitec, epc, sprop, ws, wf, gwc))
+	{
+		printf("\n");
+		printf("ERROR in richards() from multilayer_hydrolprocess.c()\n");
+		errorCode=1; 
+	} 
 
-		/* *****************************/
-		/*  3. POND WATER from soil */
-		if (ws->pondw + wf->GW_to_pondw  > sprop->pondmax)
-		{
-			wf->prcp_to_runoff += ws->pondw + wf->GW_to_pondw  - sprop->pondmax;
-			ws->pondw = sprop->pondmax;
-		}
-		else
-			ws->pondw += wf->GW_to_pondw;
 
-		/* pond_flag: flag of WARNING writing (only at first time) */
-		if (ws->pondw > 0) if (!ctrl->pond_flag ) ctrl->pond_flag = 1;
+	/* *****************************/
+	/* 2. GROUNDWATER POSTPROCESS: 12 layers to 10 layers  */
+	if (!errorCode && groundwaterR_postproc(sitec,epv, ws, wf, gwc))
+	{
+		printf("ERROR in groundwater() from bgc.c\n");
+		errorCode=1;
+	}
 
+	/* *****************************/
+	/*  3. POND WATER from soil */
+	if (ws->pondw + wf->GW_to_pondw  > sprop->pondmax)
+	{
+		wf->prcp_to_runoff += ws->pondw + wf->GW_to_pondw  - sprop->pondmax;
+		ws->pondw = sprop->pondmax;
 	}
-	/* ---------------------------------------------------------------------------------------- */
-	/* 2. Tipping-method */
-	/* ---------------------------------------------------------------------------------------- */
 	else
+		ws->pondw += wf->GW_to_pondw;
+
+	/* pond_flag: flag of WARNING writing (only at first time) */
+	if (ws->pondw > 0) if (!ctrl->pond_flag ) ctrl->pond_flag = 1;
+
+
+	/* evapotranspiration, bottom layer, soilstress and rootzone averages */
+	if (hydrolprocess_profile(sitec, sprop, epc, epv, ws, wf)) errorCode=1;
+
+	return (errorCode);
+}
+
+
+/* ---------------------------------------------------------------------------------------- */
+/* 2. Tipping-method */
+/* ---------------------------------------------------------------------------------------- */
+int multilayer_hydrolprocessT(control_struct* ctrl, siteconst_struct* sitec, soilprop_struct* sprop, const epconst_struct* epc, epvar_struct* epv, 
+	                          wstate_struct* ws, wflux_struct* wf, groundwater_struct* GWS, flooding_struct* FLD, int* mondays)
+{
+	int errorCode=0;
+
+	/* ********************************************/
+	/* 0. GROUNDWATER preprocess: calculation depth of GW and CF, GW-movchange */
+
+	if (!errorCode && groundwaterT_preproc(ctrl, epc, sitec, sprop, epv, ws, wf, GWS))
 	{
-		/* ********************************************/
-		/* 0. GROUNDWATER preprocess: calculation depth of GW and CF, GW-movchange */
-	
-		if (!errorCode && groundwaterT_preproc(ctrl, epc, sitec, sprop, epv, ws, wf, GWS))
-		{
-			printf("ERROR in groundwaterT_preproc() from bgc.c\n");
-			errorCode=1;
-		}
+		printf("ERROR in groundwaterT_preproc() from bgc.c\n");
+		errorCode=1;
+	}
 
 
-		/* *****************************/
-		/* 2. INFILTRATION AND PONDW FORMATION */
-	
-		if (!errorCode && infiltANDpond(sitec,sprop, epv,ws, wf))
-		{
-			printf("\n");
-			printf("ERROR in infiltANDpond() from multilayer_hydrolprocess.c()\n");
-			errorCode=1; 
-		} 
+	/* *****************************/
+	/* 2. INFILTRATION AND PONDW FORMATION */
 
-		/* ********************************/
-		/* 3. PERCOLATION  AND DIFFUSION  */
-		
-		if (!errorCode && tipping(sitec, sprop, epc, epv, ws, wf))
-		{
-			printf("\n");
-			printf("ERROR in tipping() from multilayer_hydrolprocess.c()\n");
-			errorCode=1;
-		} 
+	if (!errorCode && infiltANDpond(sitec,sprop, epv,ws, wf))
+	{
+		printf("\n");
+		printf("ERROR in infiltANDpond() from multilayer_hydrolprocess.c()\n");
+		errorCode=1; 
+	} 
+
+	/* ********************************/
+	/* 3. PERCOLATION  AND DIFFUSION  */
 	
-		/* ********************************************/
-		/* 4. SOIL EVAPORATION */
+	if (!errorCode && tipping(sitec, sprop, epc, epv, ws, wf))
+	{
+		printf("\n");
+		printf("ERROR in tipping() from multilayer_hydrolprocess.c()\n");
+		errorCode=1;
+	} 
 
+	/* ********************************************/
+	/* 4. SOIL EVAPORATION */
+
+
+	if (!errorCode && soilEVP_calc(ctrl,sitec,sprop, epv, ws,wf))
+	{
+		printf("ERROR in soilEVP_calc() from multilayer_hydrolprocess.c()\n");
+		errorCode=1;
+	}
 
-		if (!errorCode && soilEVP_calc(ctrl,sitec,sprop, epv, ws,wf))
-		{
-			printf("ERROR in soilEVP_calc() from multilayer_hydrolprocess.c()\n");
-			errorCode=1;
-		}
 	
+	/* ********************************************/
+	/* 5. TRANSPIRATION */
+
+	if (!errorCode && multilayer_transpiration(ctrl, sitec, sprop, epv, ws, wf))
+	{
+		printf("ERROR in multilayer_transpiration() from multilayer_hydrolprocess.c()\n");
+		errorCode=1;
+	}
+
+	/* *****************************/
+	/* 6. POND AND RUNOFF */
+
+	if (!errorCode && pondANDrunoffD(ctrl,sitec,sprop, epv,ws, wf))
+	{
+		printf("\n");
+		printf("ERROR in pondANDrunoffD() from multilayer_hydrolprocess.c()\n");
+		errorCode=1; 
+	} 
 		
-		/* ********************************************/
-		/* 5. TRANSPIRATION */
+	/* **********************************/
+	/* 7. GROUNDWATER CF-charge: diffusion between GW and CF */
 
-		if (!errorCode && multilayer_transpiration(ctrl, sitec, sprop, epv, ws, wf))
-		{
-			printf("ERROR in multilayer_transpiration() from multilayer_hydrolprocess.c()\n");
-			errorCode=1;
-		}
-	
-		/* *****************************/
-		/* 6. POND AND RUNOFF */
-	
-		if (!errorCode && pondANDrunoffD(ctrl,sitec,sprop, epv,ws, wf))
-		{
-			printf("\n");
-			printf("ERROR in pondANDrunoffD() from multilayer_hydrolprocess.c()\n");
-			errorCode=1; 
-		} 
-			
-		/* **********************************/
-		/* 7. GROUNDWATER CF-charge: diffusion between GW and CF */
-	
-		if (!errorCode && groundwaterT_CFcharge(sitec, sprop, epv, ws, wf, GWS))
-		{
-			printf("ERROR in groundwaterT_CFcharge() from multilayer_hydrolprocess.cc\n");
-			errorCode=1;
-		}
+	if (!errorCode && groundwaterT_CFcharge(sitec, sprop, epv, ws, wf, GWS))
+	{
+		printf("ERROR in groundwaterT_CFcharge() from multilayer_hydrolprocess.cc\n");
+		errorCode=1;
+	}
 
-		/* FLOODING */
-		if (!errorCode && flooding(ctrl, sitec, FLD, sprop, epv, ws, wf, mondays))
-		{
-			printf("ERROR in flooding() from bgc.c\n");
-			errorCode=1;
-		}
-	
+	/* FLOODING */
+	if (!errorCode && flooding(ctrl, sitec, FLD, sprop, epv, ws, wf, mondays))
+	{
+		printf("ERROR in flooding() from bgc.c\n");
+		errorCode=1;
 	}
 
-	
+
+	/* evapotranspiration, bottom layer, soilstress and rootzone averages */
+	if (hydrolprocess_profile(sitec, sprop, epc, epv, ws, wf)) errorCode=1;
+
+	return (errorCode);
+}
+
+
+static int hydrolprocess_profile(siteconst_struct* sitec, soilprop_struct* sprop, const epconst_struct* epc, epvar_struct* epv, 
+	                              wstate_struct* ws, wflux_struct* wf)
+{
+	/* internal variables */
+	double VWC_avg, VWC_maxRZ, relVWCsat_fc_maxRZ, relVWCfc_wp_maxRZ, VWC_RZ, PSI_RZ, soilw_RZ, weight, weight_SUM, ratio, hydrCONDUCTsat_avg;
+	double soilw_hw, soilw_wp, TRP_diff, TRP_diff_SUM, soilw_trans_ctrl, soilw_before;
+	double VWCsat_RZ, VWCfc_RZ, VWCwp_RZ, VWChw_RZ, soilw_RZ_avail;
+	int layer;
+	int errorCode=0;
+	soilw_before=soilw_hw=TRP_diff=TRP_diff_SUM=soilw_trans_ctrl=VWC_avg=VWC_RZ=PSI_RZ=soilw_RZ=weight=weight_SUM=ratio=soilw_wp=soilw_RZ_avail=0;
+	VWC_RZ=VWC_maxRZ=VWCsat_RZ=VWCfc_RZ=VWCwp_RZ=VWChw_RZ=hydrCONDUCTsat_avg=relVWCsat_fc_maxRZ=relVWCfc_wp_maxRZ=0.0;
 
 	/* evaportanspiration calculation */	
 	
@@ -193,11 +224,11 @@ int multilayer_hydrolprocess(control_struct* ctrl, siteconst_struct* sitec, soil
 	
 	if (sprop->GWD == DATA_GAP || (sprop->GWlayer == DATA_GAP))
 	{
-		soilw_before              = ws->soilw[N_SOILLAYERS-1];
-		epv->VWC[N_SOILLAYERS-1]  = sprop->VWCfc[N_SOILLAYERS-1];
-		ws->soilw[N_SOILLAYERS-1] = sprop->VWCfc[N_SOILLAYERS-1] * (sitec->soillayer_thickness[N_SOILLAYERS-1]) * water_density;
+		soilw_before              = ws->soilw[sitec->n_soillayers-1];
+		epv->VWC[sitec->n_soillayers-1]  = sprop->VWCfc[sitec->n_soillayers-1];
+		ws->soilw[sitec->n_soillayers-1] = sprop->VWCfc[sitec->n_soillayers-1] * (sitec->soillayer_thickness[sitec->n_soillayers-1]) * water_density;
 	
-		wf->soilwFlux[N_SOILLAYERS-1] += soilw_before - ws->soilw[N_SOILLAYERS-1];
+		wf->soilwFlux[sitec->n_soillayers-1] += soilw_before - ws->soilw[sitec->n_soillayers-1];
 
 	}
 	
@@ -206,7 +237,7 @@ int multilayer_hydrolprocess(control_struct* ctrl, siteconst_struct* sitec, soil
 	/* ********************************************/
 	/* 7. Soilstress calculation based on VWC or transpiration demand-possibitiy */
 	
-	if (!errorCode && soilstress_calculation(sprop, epc, epv, ws, wf))
+	if (!errorCode && soilstress_calculation(sitec, sprop, epc, epv, ws, wf))
 	{
 		printf("\n");
 		printf("ERROR in soilstress_calculation() from multilayer_hydrolprocess.c()\n");
@@ -216,13 +247,13 @@ int multilayer_hydrolprocess(control_struct* ctrl, siteconst_struct* sitec, soil
 	/* ********************************/
 	/* 8. CONTROL and calculating averages - unrealistic VWC content (higher than saturation value or less then hygroscopic) - GWtest */
 
-	for (layer = 0; layer < N_SOILLAYERS; layer++)
+	for (layer = 0; layer < sitec->n_soillayers; layer++)
 	{
 		if (epv->VWC[layer] < sprop->VWChw[layer])       
 		{
 			if (sprop->VWChw[layer] - epv->VWC[layer] < 1e-3)
 			{
-				wf->soilwFlux[N_SOILLAYERS-1] -= (sprop->VWChw[layer] - epv->VWC[layer])* water_density * sitec->soillayer_thickness[layer];
+				wf->soilwFlux[sitec->n_soillayers-1] -= (sprop->VWChw[layer] - epv->VWC[layer])* water_density * sitec->soillayer_thickness[layer];
 				epv->VWC[layer]                = sprop->VWChw[layer];
 				ws->soilw[layer]               = epv->VWC[layer] * water_density * sitec->soillayer_thickness[layer];
 			}
@@ -247,7 +278,7 @@ int multilayer_hydrolprocess(control_struct* ctrl, siteconst_struct* sitec, soil
 			{
 				if (epv->VWC[layer] - sprop->VWCsat[layer] < CRIT_PRECwater)
 				{
-					wf->soilwFlux[N_SOILLAYERS-1] += (epv->VWC[layer] - sprop->VWCsat[layer])/(water_density * sitec->soillayer_thickness[layer]);
+					wf->soilwFlux[sitec->n_soillayers-1] += (epv->VWC[layer] - sprop->VWCsat[layer])/(water_density * sitec->soillayer_thickness[layer]);
 					epv->VWC[layer] = sprop->VWCsat[layer];
 					ws->soilw[layer] = epv->VWC[layer] * water_density * sitec->soillayer_thickness[layer];
 				}
@@ -260,8 +291,8 @@ int multilayer_hydrolprocess(control_struct* ctrl, siteconst_struct* sitec, soil
 			}
 
 		}
-		VWC_avg	            += epv->VWC[layer]    * (sitec->soillayer_thickness[layer] / sitec->soillayer_depth[N_SOILLAYERS-1]);
-		hydrCONDUCTsat_avg	+= sprop->hydrCONDUCTsat[layer]   * (sitec->soillayer_thickness[layer] / sitec->soillayer_depth[N_SOILLAYERS-1]);
+		VWC_avg	            += epv->VWC[layer]    * (sitec->soillayer_thickness[layer] / sitec->soillayer_depth[sitec->n_soillayers-1]);
+		hydrCONDUCTsat_avg	+= sprop->hydrCONDUCTsat[layer]   * (sitec->soillayer_thickness[layer] / sitec->soillayer_depth[sitec->n_soillayers-1]);
 		
 		
 		/* calculation of rootzone variables - weight of the last layer depends on the depth of the root */
@@ -19,7 +19,7 @@ See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentatio
 #include "bgc_func.h"
 #include "bgc_constants.h"
 
-int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
+int multilayer_leaching(const siteconst_struct* sitec, const soilprop_struct* sprop, const epvar_struct* epv,
 					    control_struct* ctrl, cstate_struct* cs, cflux_struct* cf, nstate_struct* ns, nflux_struct* nf, wstate_struct* ws, wflux_struct* wf)
 {
 	int errorCode=0;
@@ -46,12 +46,12 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 
 	
 
-	for (layer = 0; layer < N_SOILLAYERS; layer++)
+	for (layer = 0; layer < sitec->n_soillayers; layer++)
 	{
 		soilwater_NH4conc_downward = ns->sminNH4avail[layer]  / ws->soilw[layer];
 		soilwater_NO3conc_downward = ns->sminNO3avail[layer]  / ws->soilw[layer];
 
-		if (layer < N_SOILLAYERS-1)
+		if (layer < sitec->n_soillayers-1)
 		{
 			soilwater_NH4conc_upward   = ns->sminNH4avail[layer+1]  / ws->soilw[layer+1];
 			soilwater_NO3conc_upward   = ns->sminNO3avail[layer+1]  / ws->soilw[layer+1];
@@ -68,7 +68,7 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 				cn_ratio1=cs->soil1c[layer]/ns->soil1n[layer]; 
 				soilwater_DOC1conc_downward = sprop->SOIL1_dissolv_prop * cs->soil1c[layer]   / ws->soilw[layer];
 				soilwater_DON1conc_downward = soilwater_DOC1conc_downward/cn_ratio1;
-				if (layer < N_SOILLAYERS-1)
+				if (layer < sitec->n_soillayers-1)
 				{
 					soilwater_DOC1conc_upward   = sprop->SOIL1_dissolv_prop * cs->soil1c[layer+1] / ws->soilw[layer+1];
 					soilwater_DON1conc_upward   = soilwater_DOC1conc_upward/cn_ratio1;
@@ -94,7 +94,7 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 				cn_ratio2=cs->soil2c[layer]/ns->soil2n[layer]; 
 				soilwater_DOC2conc_downward = sprop->SOIL2_dissolv_prop * cs->soil2c[layer]   / ws->soilw[layer];
 				soilwater_DON2conc_downward = soilwater_DOC2conc_downward/cn_ratio2;
-				if (layer < N_SOILLAYERS-1)
+				if (layer < sitec->n_soillayers-1)
 				{
 					soilwater_DOC2conc_upward   = sprop->SOIL2_dissolv_prop * cs->soil2c[layer+1] / ws->soilw[layer+1];
 					soilwater_DON2conc_upward   = soilwater_DOC2conc_upward/cn_ratio2;
@@ -118,7 +118,7 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 				cn_ratio3=cs->soil3c[layer]/ns->soil3n[layer]; 
 				soilwater_DOC3conc_downward = sprop->SOIL3_dissolv_prop * cs->soil3c[layer]   / ws->soilw[layer];
 				soilwater_DON3conc_downward = soilwater_DOC3conc_downward/cn_ratio3;
-				if (layer < N_SOILLAYERS-1)
+				if (layer < sitec->n_soillayers-1)
 				{
 					soilwater_DOC3conc_upward   = sprop->SOIL3_dissolv_prop * cs->soil3c[layer+1] / ws->soilw[layer+1];
 					soilwater_DON3conc_upward   = soilwater_DOC3conc_upward/cn_ratio3;
@@ -142,7 +142,7 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 				cn_ratio4=cs->soil4c[layer]/ns->soil4n[layer]; 
 				soilwater_DOC4conc_downward = sprop->SOIL4_dissolv_prop * cs->soil4c[layer]   / ws->soilw[layer];
 				soilwater_DON4conc_downward = soilwater_DOC4conc_downward/cn_ratio4;
-				if (layer < N_SOILLAYERS-1)
+				if (layer < sitec->n_soillayers-1)
 				{
 					soilwater_DOC4conc_upward   = sprop->SOIL4_dissolv_prop * cs->soil4c[layer+1] / ws->soilw[layer+1];
 					soilwater_DON4conc_upward   = soilwater_DOC4conc_upward/cn_ratio4;
@@ -216,7 +216,7 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 	ns->sminNH4_total=0;
 	ns->sminNO3_total=0;
 
-	for (layer = 0; layer < N_SOILLAYERS; layer++)
+	for (layer = 0; layer < sitec->n_soillayers; layer++)
 	{
 
 		for (datatype = 0; datatype <= n_data; datatype++)
@@ -226,7 +226,7 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 			{	
 			
 				state0 = ns->sminNH4[layer];
-				if (layer < N_SOILLAYERS-1) state1 = ns->sminNH4[layer+1];
+				if (layer < sitec->n_soillayers-1) state1 = ns->sminNH4[layer+1];
 				lflux  = nf->sminNH4_leach[layer];
 			}
 
@@ -234,7 +234,7 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 			if (datatype == 1)
 			{	
 				state0 = ns->sminNO3[layer];
-				if (layer < N_SOILLAYERS-1) state1 = ns->sminNO3[layer+1];
+				if (layer < sitec->n_soillayers-1) state1 = ns->sminNO3[layer+1];
 				lflux  = nf->sminNO3_leach[layer];
 
 
@@ -244,7 +244,7 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 			if (datatype == 2)
 			{	
 				state0 = cs->soil1c[layer];
-				if (layer < N_SOILLAYERS-1) state1 = cs->soil1c[layer+1];
+				if (layer < sitec->n_soillayers-1) state1 = cs->soil1c[layer+1];
 				lflux  = cf->soil1DOC_leach[layer];
 			}
 
@@ -252,7 +252,7 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 			if (datatype == 3)
 			{	
 				state0 = cs->soil2c[layer];
-				if (layer < N_SOILLAYERS-1) state1 = cs->soil2c[layer+1];
+				if (layer < sitec->n_soillayers-1) state1 = cs->soil2c[layer+1];
 				lflux  = cf->soil2DOC_leach[layer];
 			}
 
@@ -260,7 +260,7 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 			if (datatype == 4)
 			{	
 				state0 = cs->soil3c[layer];
-				if (layer < N_SOILLAYERS-1) state1 = cs->soil3c[layer+1];
+				if (layer < sitec->n_soillayers-1) state1 = cs->soil3c[layer+1];
 				lflux  = cf->soil3DOC_leach[layer];
 			}
 
@@ -268,7 +268,7 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 			if (datatype == 5)
 			{	
 				state0 = cs->soil4c[layer];
-				if (layer < N_SOILLAYERS-1) state1 = cs->soil4c[layer+1];
+				if (layer < sitec->n_soillayers-1) state1 = cs->soil4c[layer+1];
 				lflux  = cf->soil4DOC_leach[layer];
 			}
 
@@ -276,7 +276,7 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 			if (datatype == 6)
 			{	
 				state0 = ns->soil1n[layer];
-				if (layer < N_SOILLAYERS-1) state1 = ns->soil1n[layer+1];
+				if (layer < sitec->n_soillayers-1) state1 = ns->soil1n[layer+1];
 				lflux  = nf->soil1DON_leach[layer];
 			}
 
@@ -284,7 +284,7 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 			if (datatype == 7)
 			{	
 				state0 = ns->soil2n[layer];
-				if (layer < N_SOILLAYERS-1) state1 = ns->soil2n[layer+1];
+				if (layer < sitec->n_soillayers-1) state1 = ns->soil2n[layer+1];
 				lflux  = nf->soil2DON_leach[layer];
 			}
 
@@ -292,7 +292,7 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 			if (datatype == 8)
 			{	
 				state0 = ns->soil3n[layer];
-				if (layer < N_SOILLAYERS-1) state1 = ns->soil3n[layer+1];
+				if (layer < sitec->n_soillayers-1) state1 = ns->soil3n[layer+1];
 				lflux  = nf->soil3DON_leach[layer];
 			}
 
@@ -300,7 +300,7 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 			if (datatype == 9)
 			{	
 				state0 = ns->soil4n[layer];
-				if (layer < N_SOILLAYERS-1) state1 = ns->soil4n[layer+1];
+				if (layer < sitec->n_soillayers-1) state1 = ns->soil4n[layer+1];
 				lflux  = nf->soil4DON_leach[layer];
 			}
 			
@@ -344,7 +344,7 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 			if (datatype == 0)
 			{	
 				ns->sminNH4[layer]			= state0;
-				if (layer < N_SOILLAYERS-1) ns->sminNH4[layer+1]		= state1;
+				if (layer < sitec->n_soillayers-1) ns->sminNH4[layer+1]		= state1;
 				nf->sminNH4_leach[layer]   = lflux;
 				nf->sminNH4_leachCUM[layer] += nf->sminNH4_leach[layer];
 			}
@@ -353,7 +353,7 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 			if (datatype == 1)
 			{	
 				ns->sminNO3[layer]			= state0;
-				if (layer < N_SOILLAYERS-1) ns->sminNO3[layer+1]		= state1;
+				if (layer < sitec->n_soillayers-1) ns->sminNO3[layer+1]		= state1;
 				nf->sminNO3_leach[layer]   = lflux;
 				nf->sminNO3_leachCUM[layer] += nf->sminNO3_leach[layer];
 			}
@@ -364,10 +364,10 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 			if (datatype == 2)
 			{	
 				cs->soil1c[layer]			  = state0;
-				if (layer < N_SOILLAYERS-1) cs->soil1c[layer+1]		      = state1;
+				if (layer < sitec->n_soillayers-1) cs->soil1c[layer+1]		      = state1;
 				cf->soil1DOC_leach[layer]   = lflux;
 				cs->soil1DOC[layer]		  = sprop->SOIL1_dissolv_prop * cs->soil1c[layer];
-				if (layer < N_SOILLAYERS-1) cs->soil1DOC[layer+1]		  = sprop->SOIL1_dissolv_prop * cs->soil1c[layer+1];
+				if (layer < sitec->n_soillayers-1) cs->soil1DOC[layer+1]		  = sprop->SOIL1_dissolv_prop * cs->soil1c[layer+1];
 
 				cf->soilDOC_leachCUM[layer] += cf->soil1DOC_leach[layer];
 			}
@@ -376,10 +376,10 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 			if (datatype == 3)
 			{	
 				cs->soil2c[layer]			  = state0;
-				if (layer < N_SOILLAYERS-1) cs->soil2c[layer+1]		      = state1;
+				if (layer < sitec->n_soillayers-1) cs->soil2c[layer+1]		      = state1;
 				cf->soil2DOC_leach[layer]   = lflux;
 				cs->soil2DOC[layer]		  = sprop->SOIL2_dissolv_prop * cs->soil2c[layer];
-				if (layer < N_SOILLAYERS-1) cs->soil2DOC[layer+1]		  = sprop->SOIL2_dissolv_prop * cs->soil2c[layer+1];
+				if (layer < sitec->n_soillayers-1) cs->soil2DOC[layer+1]		  = sprop->SOIL2_dissolv_prop * cs->soil2c[layer+1];
 
 				cf->soilDOC_leachCUM[layer] += cf->soil2DOC_leach[layer];
 			}
@@ -388,10 +388,10 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 			if (datatype == 4)
 			{	
 				cs->soil3c[layer]			  = state0;
-				if (layer < N_SOILLAYERS-1) cs->soil3c[layer+1]		      = state1;
+				if (layer < sitec->n_soillayers-1) cs->soil3c[layer+1]		      = state1;
 				cf->soil3DOC_leach[layer]   = lflux;
 				cs->soil3DOC[layer]		  = sprop->SOIL3_dissolv_prop * cs->soil3c[layer];
-				if (layer < N_SOILLAYERS-1) cs->soil3DOC[layer+1]		  = sprop->SOIL3_dissolv_prop * cs->soil3c[layer+1];
+				if (layer < sitec->n_soillayers-1) cs->soil3DOC[layer+1]		  = sprop->SOIL3_dissolv_prop * cs->soil3c[layer+1];
 
 				cf->soilDOC_leachCUM[layer] += cf->soil3DOC_leach[layer];
 			}
@@ -400,10 +400,10 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 			if (datatype == 5)
 			{	
 				cs->soil4c[layer]			  = state0;
-				if (layer < N_SOILLAYERS-1) cs->soil4c[layer+1]		      = state1;
+				if (layer < sitec->n_soillayers-1) cs->soil4c[layer+1]		      = state1;
 				cf->soil4DOC_leach[layer]   = lflux;
 				cs->soil4DOC[layer]		  = sprop->SOIL4_dissolv_prop * cs->soil4c[layer];
-				if (layer < N_SOILLAYERS-1) cs->soil4DOC[layer+1]		  = sprop->SOIL4_dissolv_prop * cs->soil4c[layer+1];
+				if (layer < sitec->n_soillayers-1) cs->soil4DOC[layer+1]		  = sprop->SOIL4_dissolv_prop * cs->soil4c[layer+1];
 
 				cf->soilDOC_leachCUM[layer] += cf->soil4DOC_leach[layer];
 			}
@@ -412,10 +412,10 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 			if (datatype == 6)
 			{	
 				ns->soil1n[layer]			  = state0;
-				if (layer < N_SOILLAYERS-1) ns->soil1n[layer+1]		      = state1;
+				if (layer < sitec->n_soillayers-1) ns->soil1n[layer+1]		      = state1;
 				nf->soil1DON_leach[layer]   = lflux;
 				ns->soil1DON[layer]		  = sprop->SOIL1_dissolv_prop * ns->soil1n[layer];
-				if (layer < N_SOILLAYERS-1) ns->soil1DON[layer+1]		  = sprop->SOIL1_dissolv_prop * ns->soil1n[layer+1];
+				if (layer < sitec->n_soillayers-1) ns->soil1DON[layer+1]		  = sprop->SOIL1_dissolv_prop * ns->soil1n[layer+1];
 
 				nf->soilDON_leachCUM[layer] += nf->soil1DON_leach[layer];
 			}
@@ -424,10 +424,10 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 			if (datatype == 7)
 			{	
 				ns->soil2n[layer]			  = state0;
-				if (layer < N_SOILLAYERS-1) ns->soil2n[layer+1]		      = state1;
+				if (layer < sitec->n_soillayers-1) ns->soil2n[layer+1]		      = state1;
 				nf->soil2DON_leach[layer]   = lflux;
 				ns->soil2DON[layer]		  = sprop->SOIL2_dissolv_prop * ns->soil2n[layer];
-				if (layer < N_SOILLAYERS-1) ns->soil2DON[layer+1]		  = sprop->SOIL2_dissolv_prop * ns->soil2n[layer+1];
+				if (layer < sitec->n_soillayers-1) ns->soil2DON[layer+1]		  = sprop->SOIL2_dissolv_prop * ns->soil2n[layer+1];
 
 				nf->soilDON_leachCUM[layer] += nf->soil2DON_leach[layer];
 			}
@@ -436,10 +436,10 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 			if (datatype == 8)
 			{	
 				ns->soil3n[layer]			  = state0;
-				if (layer < N_SOILLAYERS-1) ns->soil3n[layer+1]		      = state1;
+				if (layer < sitec->n_soillayers-1) ns->soil3n[layer+1]		      = state1;
 				nf->soil3DON_leach[layer]   = lflux;
 				ns->soil3DON[layer]		  = sprop->SOIL3_dissolv_prop * ns->soil3n[layer];
-				if (layer < N_SOILLAYERS-1) ns->soil3DON[layer+1]		  = sprop->SOIL3_dissolv_prop * ns->soil3n[layer+1];
+				if (layer < sitec->n_soillayers-1) ns->soil3DON[layer+1]		  = sprop->SOIL3_dissolv_prop * ns->soil3n[layer+1];
 
 				nf->soilDON_leachCUM[layer] += nf->soil3DON_leach[layer];
 			}
@@ -448,10 +448,10 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 			if (datatype == 9)
 			{	
 				ns->soil4n[layer]			  = state0;
-				if (layer < N_SOILLAYERS-1) ns->soil4n[layer+1]		      = state1;
+				if (layer < sitec->n_soillayers-1) ns->soil4n[layer+1]		      = state1;
 				nf->soil4DON_leach[layer]   = lflux;
 				ns->soil4DON[layer]		  = sprop->SOIL4_dissolv_prop * ns->soil4n[layer];
-				if (layer < N_SOILLAYERS-1) ns->soil4DON[layer+1]		  = sprop->SOIL4_dissolv_prop * ns->soil4n[layer+1];
+				if (layer < sitec->n_soillayers-1) ns->soil4DON[layer+1]		  = sprop->SOIL4_dissolv_prop * ns->soil4n[layer+1];
 
 				nf->soilDON_leachCUM[layer] += nf->soil4DON_leach[layer];
 			}
@@ -464,17 +464,17 @@ int multilayer_leaching(const soilprop_struct* sprop, const epvar_struct* epv,
 	
 
 	/* deepleach calculation from the bottom layer */
-	ns->Ndeepleach_snk += nf->sminNH4_leach[N_SOILLAYERS-1] + nf->sminNO3_leach[N_SOILLAYERS-1]  + 
-		                  nf->soil1DON_leach[N_SOILLAYERS-1] +nf->soil2DON_leach[N_SOILLAYERS-1] +
-						  nf->soil3DON_leach[N_SOILLAYERS-1] +nf->soil4DON_leach[N_SOILLAYERS-1];
+	ns->Ndeepleach_snk += nf->sminNH4_leach[sitec->n_soillayers-1] + nf->sminNO3_leach[sitec->n_soillayers-1]  + 
+		                  nf->soil1DON_leach[sitec->n_soillayers-1] +nf->soil2DON_leach[sitec->n_soillayers-1] +
+						  nf->soil3DON_leach[sitec->n_soillayers-1] +nf->soil4DON_leach[sitec->n_soillayers-1];
 
-	cs->Cdeepleach_snk += cf->soil1DOC_leach[N_SOILLAYERS-1] +cf->soil2DOC_leach[N_SOILLAYERS-1] +
-		                  cf->soil3DOC_leach[N_SOILLAYERS-1] +cf->soil4DOC_leach[N_SOILLAYERS-1];
+	cs->Cdeepleach_snk += cf->soil1DOC_leach[sitec->n_soillayers-1] +cf->soil2DOC_leach[sitec->n_soillayers-1] +
+		                  cf->soil3DOC_leach[sitec->n_soillayers-1] +cf->soil4DOC_leach[sitec->n_soillayers-1];
 
 
 
 	/* state update available SMINN */
-	for (layer = 0; layer < N_SOILLAYERS; layer++)
+	for (layer = 0; layer < sitec->n_soillayers; layer++)
 	{
 		ns->sminNH4avail[layer] = ns->sminNH4[layer] * sprop->NH4_mobilen_prop;
 		ns->sminNO3avail[layer] = ns->sminNO3[layer] * NO3_mobilen_prop;
@@ -91,7 +91,7 @@ int multilayer_rootDepth(const epconst_struct* epc, const soilprop_struct* sprop
 	/* 4. Calculating the distribution of the root in the soil layers based on empirical function (Jarvis, 1989)*/
 	
 
-	for (layer = 0; layer < N_SOILLAYERS; layer++)
+	for (layer = 0; layer < sitec->n_soillayers; layer++)
 	{
 		/* live root distribution for soil water calculation */
 		if (layer < epv->n_rootlayers && layer >= epv->germ_layer)
@@ -144,7 +144,7 @@ int multilayer_rootDepth(const epconst_struct* epc, const soilprop_struct* sprop
 	/* correction */
 	if (RLprop_sum1)
 	{
-		for (layer =0; layer < N_SOILLAYERS; layer++)
+		for (layer =0; layer < sitec->n_soillayers; layer++)
 		{	
 			epv->rootlengthProp[layer] = epv->rootlengthProp[layer] / RLprop_sum1;
 			RLprop_sum2                 += epv->rootlengthProp[layer];
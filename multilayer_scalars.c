@@ -0,0 +1,258 @@
+/*
+multilayer_scalars.c
+calculation of the temperature, depth, pH and WFPS response functions of the soil processes for the whole soil profile
+(loops over contiguous layer arrays without layer-dependent branching, which can be vectorized by the compiler); the kernels
+of the 4, 6, 10 and 20 (-DN_SOILLAYERS=20) layer profiles have constant loop counts, the kernels of the run are selected
+from a table by multilayer_kernels()
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "bgc_func.h"
+#include "bgc_constants.h"
+
+/* With -DMUSO_VECMATH exp and log are calculated without library calls: range reduction to [-ln2/2, ln2/2] (exp) and 
+   [sqrt(0.5), sqrt(2)] (log) and polynomial evaluation. The exponent is built and extracted with integer operations only, 
+   therefore the profile loops can be vectorized (e.g. GCC: -O3 -fno-trapping-math -mavx2).
+   Maximal relative error: 3e-16 (exp, x in [-708, 709]; log, x in [DBL_MIN, DBL_MAX]) and (1+|y*log(x)|)*3e-16 (pow).
+   By default the library functions are used (reproduction of earlier results to the last digit); the two versions of the
+   kernels are timed and compared by tools/scalars_bench.c */
+
+#define EXPB_MAGIC  6755399441055744.0		/* 1.5*2^52: adding it to an integer-valued double puts the integer in the low bits of the mantissa */
+#define EXPB_MAGICi 0x4338000000000000LL	/* bit pattern of EXPB_MAGIC */
+
+/* the functions have to be inlined into the profile loops to get vectorized */
+#if defined(_MSC_VER)
+#define INLINE_BND static __forceinline
+#else
+#define INLINE_BND static inline __attribute__((always_inline))
+#endif
+
+INLINE_BND double exp_bnd(double x)
+{
+#ifndef MUSO_VECMATH
+	return exp(x);
+#else
+	double k, r, p, scale;
+	long long scale_bits;
+
+	/* underflow to 0 and overflow to 2^1024 are handled by clamping */
+	double xc = x < -708.0 ? -708.0 : (x > 709.0 ? 709.0 : x);
+
+	/* x = k*ln2 + r, where the ln2 multiplication is split into two parts to keep r exact */
+	k = floor(xc * 1.4426950408889634 + 0.5);
+	r = xc - k * 6.93147180369123816490e-01;
+	r = r - k * 1.90821492927058770002e-10;
+
+	/* Taylor polynomial of degree 13 (truncation error below 5e-18 for |r| <= ln2/2) */
+	p = 1.0 + r*(1.0 + r*(1./2 + r*(1./6 + r*(1./24 + r*(1./120 + r*(1./720 + r*(1./5040 + r*(1./40320 +
+		r*(1./362880 + r*(1./3628800 + r*(1./39916800 + r*(1./479001600 + r*(1./6227020800.)))))))))))));
+
+	/* 2^k from the bits of k */
+	scale = k + EXPB_MAGIC;
+	memcpy(&scale_bits, &scale, sizeof(double));
+	scale_bits = (scale_bits - EXPB_MAGICi + 1023) << 52;
+	memcpy(&scale, &scale_bits, sizeof(double));
+
+	return x < -708.0 ? 0.0 : p * scale;
+#endif
+}
+
+INLINE_BND double log_bnd(double x)
+{
+#ifndef MUSO_VECMATH
+	return log(x);
+#else
+	double m, s, s2, e, p;
+	long long bits, ex;
+
+	/* x = m * 2^e, 1 <= m < 2; the exponent is shifted to get sqrt(0.5) <= m < sqrt(2) */
+	memcpy(&bits, &x, sizeof(double));
+	ex   = ((bits >> 52) & 0x7ff) - 1023;
+	bits = (bits & 0x000fffffffffffffLL) | 0x3ff0000000000000LL;
+	memcpy(&m, &bits, sizeof(double));
+	ex   = m > 1.4142135623730951 ? ex + 1 : ex;
+	m    = m > 1.4142135623730951 ? m * 0.5 : m;
+
+	bits = ex + EXPB_MAGICi;
+	memcpy(&e, &bits, sizeof(double));
+	e    = e - EXPB_MAGIC;
+
+	/* log(m) = 2*atanh(s), s = (m-1)/(m+1), |s| <= 0.1716: series up to s^21 (truncation error below 1e-18) */
+	s  = (m - 1.0) / (m + 1.0);
+	s2 = s * s;
+	p  = 1. + s2*(1./3 + s2*(1./5 + s2*(1./7 + s2*(1./9 + s2*(1./11 + s2*(1./13 + s2*(1./15 + s2*(1./17 + s2*(1./19 + s2*(1./21))))))))));
+
+	return e * 6.93147180369123816490e-01 + (e * 1.90821492927058770002e-10 + 2.0 * s * p);
+#endif
+}
+
+/* x^y for x >= 0 and y > 0 (x below DBL_MIN is treated as 0) */
+INLINE_BND double pow_bnd(double x, double y)
+{
+#ifndef MUSO_VECMATH
+	return pow(x, y);
+#else
+	return x < 2.2250738585072014e-308 ? 0.0 : exp_bnd(y * log_bnd(x));
+#endif
+}
+
+
+/* kernels for a number of soil layers (nlayers): with a constant nlayers the loops have a fixed trip count and are fully
+   unrolled or vectorized without remainder loops */
+INLINE_BND int tresponse_engine(const int nlayers, const double* tsoil, double Tmin, double Tp1, double Tp2, double Tp3, double Tp4, 
+	                            double* ts_scalar)
+{
+	/* soil temperature response function of decomposition and nitrification in all soil layers,
+	   0 below the minimum temperature (Tmin)
+	   Tp1 == DATA_GAP: Lloyd and Taylor (1994) function: exp(Tp2*(1/Tp3 - 1/(T+273.15-Tp4)))
+	   otherwise:       bell shaped function:             Tp1 / (1 + |(T-Tp4)/Tp2|^Tp3) */
+
+	int errorCode=0;
+	int layer;
+	double tresp[N_SOILLAYERS];
+
+	if (Tp1 == DATA_GAP)
+	{
+		for (layer = 0; layer < nlayers; layer++)
+			tresp[layer] = exp_bnd(Tp2*((1.0/Tp3)-(1.0/((tsoil[layer]+Celsius2Kelvin)-Tp4))));
+	}
+	else
+	{
+		for (layer = 0; layer < nlayers; layer++)
+			tresp[layer] = Tp1/(1+pow_bnd(fabs((tsoil[layer]-Tp4)/Tp2),Tp3));
+	}
+
+	for (layer = 0; layer < nlayers; layer++)
+	{
+		ts_scalar[layer] = tsoil[layer] < Tmin ? 0.0 : tresp[layer];
+		if (ts_scalar[layer] < 0) errorCode=1;
+	}
+
+	return (errorCode);
+}
+
+
+INLINE_BND int zscalar_engine(const int nlayers, const siteconst_struct* sitec, double efolding_depth, double* z_scalar)
+{
+	/* depth dependence of decompostion rate (Koven et al. 2013) */
+
+	int errorCode=0;
+	int layer;
+
+	for (layer = 0; layer < nlayers; layer++)
+		z_scalar[layer] = exp_bnd(-1*(sitec->soillayer_midpoint[layer] / efolding_depth));
+
+	return (errorCode);
+}
+
+
+INLINE_BND int pHresponse_engine(const int nlayers, const soilprop_struct* sprop, double* ps_nitrif)
+{
+	/* pH response function of nitrification */
+
+	int errorCode=0;
+	int layer;
+
+	for (layer = 0; layer < nlayers; layer++)
+		ps_nitrif[layer] = sprop->pHp2_nitrif + (sprop->pHp1_nitrif-sprop->pHp2_nitrif)/(1 + exp_bnd((sprop->pH[layer]-sprop->pHp3_nitrif)/sprop->pHp4_nitrif));
+
+	return (errorCode);
+}
+
+
+INLINE_BND int denitr_ratio_engine(const int nlayers, const double* WFPS, const double* pH, double* FrWFPS, double* FrPH)
+{
+	/* WFPS and pH dependent factors of the N2/N2O ratio of denitrification (Parton et al. 1996):
+	   FrWFPS = 1.4 / 13^(17/13^(2.2*WFPS)), FrPH = 1 / (1470 * exp(-1.1*pH)) */
+
+	int errorCode=0;
+	int layer;
+	double pDEN1;
+
+	for (layer = 0; layer < nlayers; layer++)
+	{
+		pDEN1         = pow_bnd(13,2.2*WFPS[layer]);
+		FrWFPS[layer] = 1.4 / pow_bnd(13,17/pDEN1);
+		FrPH[layer]   = 1. / (1470 * exp_bnd(-1.1 * pH[layer]));
+	}
+
+	return (errorCode);
+}
+
+
+/* kernels of the usual soil profiles (nlayers: constant) and the generic kernels (nlayers: number of layers of the run) */
+#define MULTILAYER_INSTANCE(suffix, nlayers) \
+	static int tresponse_##suffix(int n, const double* tsoil, double Tmin, double Tp1, double Tp2, double Tp3, double Tp4, double* ts_scalar) \
+		{ return (tresponse_engine(nlayers, tsoil, Tmin, Tp1, Tp2, Tp3, Tp4, ts_scalar)); } \
+	static int zscalar_##suffix(int n, const siteconst_struct* sitec, double efolding_depth, double* z_scalar) \
+		{ return (zscalar_engine(nlayers, sitec, efolding_depth, z_scalar)); } \
+	static int pHresponse_##suffix(int n, const soilprop_struct* sprop, double* ps_nitrif) \
+		{ return (pHresponse_engine(nlayers, sprop, ps_nitrif)); } \
+	static int denitr_ratio_##suffix(int n, const double* WFPS, const double* pH, double* FrWFPS, double* FrPH) \
+		{ return (denitr_ratio_engine(nlayers, WFPS, pH, FrWFPS, FrPH)); }
+
+#define MULTILAYER_ENTRY(suffix, nlayers) {nlayers, tresponse_##suffix, zscalar_##suffix, pHresponse_##suffix, denitr_ratio_##suffix}
+
+MULTILAYER_INSTANCE(4,   4)
+MULTILAYER_INSTANCE(6,   6)
+#if N_SOILLAYERS >= 10
+MULTILAYER_INSTANCE(10,  10)
+#endif
+#if N_SOILLAYERS >= 20
+MULTILAYER_INSTANCE(20,  20)
+#endif
+MULTILAYER_INSTANCE(gen, n)
+
+/* table of the kernels: number of soil layers and kernels (the last entry: generic kernels) */
+static const multilayer_kernels_struct multilayer_table[] =
+{
+	MULTILAYER_ENTRY(4, 4),
+	MULTILAYER_ENTRY(6, 6),
+#if N_SOILLAYERS >= 10
+	MULTILAYER_ENTRY(10, 10),
+#endif
+#if N_SOILLAYERS >= 20
+	MULTILAYER_ENTRY(20, 20),
+#endif
+	MULTILAYER_ENTRY(gen, 0)
+};
+
+#define N_MULTILAYER ((int) (sizeof(multilayer_table) / sizeof(multilayer_table[0])))
+
+
+/* generic kernels for every number of layers (multilayer_generic_mode()) */
+static int multilayer_generic_flag = 0;
+
+
+int multilayer_generic_mode(int flag)
+{
+	/* the generic kernels are selected for every number of soil layers (comparison of the kernels of the usual profiles with
+	   the generic kernels, tools/scalars_bench.c); flag < 0: the mode is only queried */
+	if (flag >= 0) multilayer_generic_flag = flag;
+
+	return (multilayer_generic_flag);
+}
+
+
+const multilayer_kernels_struct* multilayer_kernels(int n_soillayers)
+{
+	/* the kernels of the number of soil layers of the run, the generic kernels for the other profiles; the kernels are called
+	   with the number of soil layers as first argument */
+	int n;
+
+	for (n = 0; n < N_MULTILAYER-1 && multilayer_table[n].nlayers != n_soillayers; n++) ;
+	if (multilayer_generic_flag) n = N_MULTILAYER-1;
+
+	return (&multilayer_table[n]);
+}
@@ -29,11 +29,14 @@ int multilayer_sminn(const control_struct* ctrl, const metvar_struct* metv,const
 	int errorCode=0;
 	int layer=0;
 	double NH4_prop,SR_layer,sminNO3avail,sminNO3avail_ppm;
-	double pH, tsoil, WFPS, net_miner,sminNH4avail, N2O_flux_NITRIF,sminNH4_to_nitrif;
+	double pH, WFPS, net_miner,sminNH4avail, N2O_flux_NITRIF,sminNH4_to_nitrif;
 	double weight,g_per_cm3_to_kg_per_m3;
 	double sminn_layer[N_SOILLAYERS];
 	double sminNH4_change[N_SOILLAYERS];
 	double sminNO3_change[N_SOILLAYERS];
+	double FrWFPS[N_SOILLAYERS];
+	double FrPH[N_SOILLAYERS];
+	const multilayer_kernels_struct* kernels = multilayer_kernels(sitec->n_soillayers);
 	double sminn_to_soilCTRL, sminn_to_npoolCTRL, ndep_to_sminnCTRL, nfix_to_sminnCTRL;
 	double SR_total,sminNO3_to_denitr,ratioN2_N2O;
 	
@@ -52,14 +55,36 @@ int multilayer_sminn(const control_struct* ctrl, const metvar_struct* metv,const
 
 	/* SR_total calculation - unit: kgC/ha */
 	SR_total = 0;
-	for (layer = 0; layer < N_SOILLAYERS; layer++) 
+	for (layer = 0; layer < sitec->n_soillayers; layer++) 
 		SR_total += (cf->soil1_hr[layer] + cf->soil2_hr[layer] + cf->soil3_hr[layer] + cf->soil4_hr[layer])* 10000;
 	
+	/* response functions of nitrification (Tsoil, pH) and denitrification (WFPS, pH) for the whole soil profile */
+	if (!errorCode && kernels->tresponse(sitec->n_soillayers, metv->tsoil, (sprop->Tp1_nitrif == DATA_GAP) ? sprop->Tmin_decomp : sprop->Tp1_nitrif, 
+		                                   sprop->Tp1_nitrif, sprop->Tp2_nitrif, sprop->Tp3_nitrif, sprop->Tp4_nitrif, epv->ts_nitrif))
+	{
+		printf("\n");
+		printf("ERROR in ts_nitrif calculation in multilayer_sminn.c\n");
+		errorCode=1;
+	}
+
+	if (!errorCode && kernels->pHresponse(sitec->n_soillayers, sprop, epv->ps_nitrif))
+	{
+		printf("\n");
+		printf("ERROR in ps_nitrif calculation in multilayer_sminn.c\n");
+		errorCode=1;
+	}
+
+	if (!errorCode && kernels->denitr_ratio(sitec->n_soillayers, epv->WFPS, sprop->pH, FrWFPS, FrPH))
+	{
+		printf("\n");
+		printf("ERROR in N2/N2O ratio calculation in multilayer_sminn.c\n");
+		errorCode=1;
+	}
 
 	/*-----------------------------------------------------------------------------*/
 	/* Calculations layer by layer */
 
-	for (layer = 0; layer < N_SOILLAYERS; layer++)
+	for (layer = 0; layer < sitec->n_soillayers; layer++)
 	{
 		/*************************************/
 		/* 0: calculation of sminn and NH4 prop in soil layers */
@@ -118,10 +143,9 @@ int multilayer_sminn(const control_struct* ctrl, const metvar_struct* metv,const
 		
 	 	WFPS         = epv->WFPS[layer];
 		sminNH4avail = ns->sminNH4avail[layer];
-		tsoil        = metv->tsoil[layer]; 
 		pH           = sprop->pH[layer];
 
-		if (!errorCode && nitrification(layer, sprop, net_miner,tsoil,pH,WFPS,sminNH4avail, epv, &N2O_flux_NITRIF, &sminNH4_to_nitrif))
+		if (!errorCode && nitrification(layer, sprop, net_miner,WFPS,sminNH4avail, epv, &N2O_flux_NITRIF, &sminNH4_to_nitrif))
 		{
 			printf("\n");
 			printf("ERROR in nitrification() for multilayer_sminn.c \n");
@@ -143,7 +167,7 @@ int multilayer_sminn(const control_struct* ctrl, const metvar_struct* metv,const
 		
 		SR_layer = (cf->soil1_hr[layer] + cf->soil2_hr[layer] + cf->soil3_hr[layer] + cf->soil4_hr[layer])* 1000;
 
-		if (!errorCode && denitrification(ctrl->soiltype, sminNO3avail_ppm, pH,WFPS, SR_layer, &sminNO3_to_denitr,&ratioN2_N2O))
+		if (!errorCode && denitrification(ctrl->soiltype, sminNO3avail_ppm, pH,WFPS, SR_layer, FrWFPS[layer], FrPH[layer], &sminNO3_to_denitr,&ratioN2_N2O))
 		{
 			printf("\n");
 			printf("ERROR in denitrification() for multilayer_sminn.c \n");
@@ -311,34 +335,14 @@ int multilayer_sminn(const control_struct* ctrl, const metvar_struct* metv,const
 	return (errorCode);
 }
 
-int nitrification(int layer, const soilprop_struct* sprop, double net_miner, double tsoil, double pH, double WFPS, double sminNH4avail, 
+int nitrification(int layer, const soilprop_struct* sprop, double net_miner, double WFPS, double sminNH4avail, 
 	                  epvar_struct* epv, double* N2O_flux_NITRIF, double* sminNH4_to_nitrif)
 {
 	int errorCode = 0;
 	double sminNH4_to_nit,N2O_flux_NIT;
 	
-	/* calculation of scalar functions: Tsoil response function, ps_nitrif and WFPS_scalar */
-
-	epv->ps_nitrif[layer] = sprop->pHp2_nitrif + (sprop->pHp1_nitrif-sprop->pHp2_nitrif)/(1 + exp((pH-sprop->pHp3_nitrif)/sprop->pHp4_nitrif));	
-
-				
-	if (sprop->Tp1_nitrif == DATA_GAP)
-	{
-		/* no decomp processes for tsoil < -10.0 C */
-		if (tsoil < sprop->Tmin_decomp)	
-				epv->ts_nitrif[layer] = 0.0;
-		else
-			epv->ts_nitrif[layer] = exp(sprop->Tp2_nitrif*((1.0/sprop->Tp3_nitrif)-(1.0/((tsoil+Celsius2Kelvin)-sprop->Tp4_nitrif))));
-	}
-	else
-	{
-		/* no decomp processes for tsoil < -10.0 C */
-		if (tsoil < sprop->Tp1_nitrif)	
-				epv->ts_nitrif[layer] = 0.0;
-		else
-			epv->ts_nitrif[layer] = sprop->Tp1_nitrif/(1+pow(fabs((tsoil-sprop->Tp4_nitrif)/sprop->Tp2_nitrif),sprop->Tp3_nitrif));
-			
-	}
+	/* calculation of scalar functions: Tsoil response function and ps_nitrif are calculated for the whole profile 
+	   by the tresponse and pHresponse kernels (multilayer_sminn), WFPS_scalar */
 
 	if (WFPS < sprop->minWFPS_nitrif)
 	{
@@ -389,15 +393,15 @@ int nitrification(int layer, const soilprop_struct* sprop, double net_miner, dou
 	return (errorCode);
 }
 
-int denitrification(double soiltype, double sminNO3avail_ppm, double pH, double WFPS, double SR_total, double* sminNO3_to_denitr, double* ratioN2_N2O)
+int denitrification(double soiltype, double sminNO3avail_ppm, double pH, double WFPS, double SR_total, double FrWFPS, double FrPH, double* sminNO3_to_denitr, double* ratioN2_N2O)
 {
 	int errorCode = 0;
-	double pDEN1, FrNO3, FrCO2, FrWFPS, FrPH;
+	double FrNO3, FrCO2;
 	double FdNO3, FdWFPS, FdCO2, FdPH;
 	double a,b,c,d,e;
 	double denitr_flux, denitr_ratio;
 
-	FrNO3=FrCO2=FrWFPS=FrPH=0;
+	FrNO3=FrCO2=0;
 	FdNO3=FdWFPS=FdCO2=FdPH=0;
 
 	/* coarse: sand, loamy sand, sandy loam */
@@ -457,10 +461,7 @@ int denitrification(double soiltype, double sminNO3avail_ppm, double pH, double
 		
 	FrCO2 = 13 + ((30.78 * atan(PI * 0.07 * (SR_total-13))) / PI);
 	
-	pDEN1 = pow(13,2.2*WFPS);
-	FrWFPS = 1.4 / pow(13,17/pDEN1);
-		
-	FrPH = 1. / (1470 * exp(-1.1 * pH));
+	/* FrWFPS and FrPH: calculated for the whole profile by the denitr_ratio kernel (multilayer_sminn) */
 
 	denitr_ratio = MIN(FrNO3, FrCO2) * FrWFPS * FrPH;
 
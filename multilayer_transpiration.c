@@ -47,7 +47,7 @@ int multilayer_transpiration(control_struct* ctrl, const siteconst_struct* sitec
 	soilwTRP_SUM=soilw_wp=0;
 
 
-	for (layer = 0; layer < N_SOILLAYERS; layer++)
+	for (layer = 0; layer < sitec->n_soillayers; layer++)
 	{
 		/* actual soil water content at theoretical lower limit of water content: hygroscopic water point */
 		soilw_wp = sprop->VWCwp[layer] * sitec->soillayer_thickness[layer] * water_density;
@@ -79,7 +79,7 @@ int multilayer_tsoil(const epconst_struct* epc, const siteconst_struct* sitec, c
 	
 	temp_diff_total = metv->annTavgRA - metv->tsoil_surface;
 	
-	for (layer = 0; layer < N_SOILLAYERS; layer++)
+	for (layer = 0; layer < sitec->n_soillayers; layer++)
 	{
 		
 	//	temp_diff = temp_diff_total * (0.1526 * log(depth) + 0.703);	
@@ -88,7 +88,7 @@ int multilayer_tsoil(const epconst_struct* epc, const siteconst_struct* sitec, c
 
 		STv1 = 1000 + 2500 * sprop->BD[layer]/((sprop->BD[layer] + 686 * exp(-5.63*sprop->BD[layer])));
 		STv2 = log(500/STv1);
-		WC = epv->VWC_avg / ((0.356-0.144*sprop->BD[layer]) * sitec->soillayer_depth[N_SOILLAYERS-2]*100); // rootzone_depth: m to cm 
+		WC = epv->VWC_avg / ((0.356-0.144*sprop->BD[layer]) * sitec->soillayer_depth[sitec->n_soillayers-2]*100); // rootzone_depth: m to cm 
 		FX = exp(STv2*pow((1-WC)/(1+WC),2));
 		f1 = 1/(FX*STv1);
 
@@ -103,7 +103,7 @@ int multilayer_tsoil(const epconst_struct* epc, const siteconst_struct* sitec, c
 		if (epc->STCM_flag) 
 			metv->tsoil[layer] = tsoil;
 
-		if (layer < N_SOILLAYERS-1) tsoil_avg += metv->tsoil[layer] * (sitec->soillayer_thickness[layer] / sitec->soillayer_depth[N_SOILLAYERS-2]);
+		if (layer < sitec->n_soillayers-1) tsoil_avg += metv->tsoil[layer] * (sitec->soillayer_thickness[layer] / sitec->soillayer_depth[sitec->n_soillayers-2]);
 
 	}
 
@@ -114,8 +114,8 @@ int ndep_init(file init, NdepControl_struct* ndep, control_struct *ctrl)
 		/* allocate space for the annual Ndep array */
 		if (!errorCode)
 		{
-			ndep->Ndep_array = (double*) malloc(ctrl->simyears * sizeof(double));
-			ndep->Nyrs_array = (int*) malloc(ctrl->simyears * sizeof(int));
+			ndep->Ndep_array = (double*) arena_malloc(ctrl->simyears * sizeof(double));
+			ndep->Nyrs_array = (int*) arena_malloc(ctrl->simyears * sizeof(int));
 			if (!ndep->Ndep_array)
 			{
 				printf("ERROR allocating for annual Ndep array, ndep_init()\n");
@@ -0,0 +1,150 @@
+/*
+obscomp.c
+in-process comparison of model outputs with observations: accumulation of the goodness-of-fit statistics day by day
+and writing of the metrics (RMSE, bias, NSE, log-likelihood) into the summary file
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_constants.h"
+#include "bgc_func.h"
+
+
+int obscomp_update(obscomp_struct* OBS, const control_struct* ctrl, double** output_map, int* mondays, int* enddays,
+	               int yearOUT, int monthOUT, int dayOUT)
+{
+	/* the simulated values are read directly from the output map, therefore the comparison
+	   works also if no daily, monthly or annual output is requested */
+	int errorCode=0;
+	int ns, date;
+	double sim, obs, res, delta;
+	obsseries_struct* series;
+
+	for (ns = 0; !errorCode && ns < OBS->nseries; ns++)
+	{
+		series = &OBS->series[ns];
+
+		if (output_map[series->outcode] == NULL)
+		{
+			printf("ERROR in observations.txt: output variable %i is not available (not part of the soil profile of the run)\n", series->outcode);
+			errorCode=1;
+			continue;
+		}
+
+		/* daily values or monthly averages (last day of the month) */
+		if (series->timestep == 0)
+		{
+			sim  = *(output_map[series->outcode]);
+			date = yearOUT*10000 + monthOUT*100 + dayOUT;
+		}
+		else
+		{
+			series->monsum += *(output_map[series->outcode]);
+			if (ctrl->yday != enddays[ctrl->curmonth]) continue;
+
+			sim  = series->monsum / (double)mondays[ctrl->curmonth];
+			date = yearOUT*100 + monthOUT;
+			series->monsum = 0;
+		}
+
+		/* observations without simulated pair (e.g. 29 February) are skipped */
+		while (series->mgmdOBS < series->nobs && series->date_array[series->mgmdOBS] < date) series->mgmdOBS += 1;
+
+		if (series->mgmdOBS < series->nobs && series->date_array[series->mgmdOBS] == date)
+		{
+			obs = series->value_array[series->mgmdOBS];
+			res = sim - obs;
+
+			series->n        += 1;
+			series->sum_res  += res;
+			series->sum_res2 += res * res;
+			series->sum_sim  += sim;
+
+			/* Welford's algorithm for the variance of the observations (used by NSE) */
+			delta             = obs - series->mean_obs;
+			series->mean_obs += delta / series->n;
+			series->M2_obs   += delta * (obs - series->mean_obs);
+
+			series->mgmdOBS += 1;
+		}
+	}
+
+	return (errorCode);
+}
+
+
+int obscomp_summary(const obscomp_struct* OBS)
+{
+	/* RMSE, bias, NSE and Gaussian log-likelihood of each series; in case of unknown observation error the
+	   maximum likelihood estimate of sigma (RMSE) is used. Undefined metrics are written as DATA_GAP */
+	int errorCode=0;
+	int ns;
+	double n, rmse, bias, nse, loglik, loglik_total, sigma2;
+	const obsseries_struct* series;
+	file SUM_file;
+
+	strcpy(SUM_file.name, OBS->summary_file);
+	if (file_open(&SUM_file,'o',1))
+	{
+		printf("ERROR opening summary file of observation comparison: %s\n", OBS->summary_file);
+		return (1);
+	}
+
+	fprintf(SUM_file.ptr, "%8s %8s %8s %8s %14s %14s %14s %14s %14s %14s\n",
+		    "outcode", "timestep", "nobs", "n", "RMSE", "bias", "NSE", "loglik", "mean_obs", "mean_sim");
+
+	loglik_total = 0;
+	for (ns = 0; ns < OBS->nseries; ns++)
+	{
+		series = &OBS->series[ns];
+		n      = (double) series->n;
+
+		rmse   = DATA_GAP;
+		bias   = DATA_GAP;
+		nse    = DATA_GAP;
+		loglik = DATA_GAP;
+
+		if (series->n > 0)
+		{
+			rmse = sqrt(series->sum_res2 / n);
+			bias = series->sum_res / n;
+			if (series->M2_obs > 0) nse = 1 - series->sum_res2 / series->M2_obs;
+
+			if (series->sigma != DATA_GAP)
+			{
+				sigma2 = series->sigma * series->sigma;
+				loglik = -0.5 * n * log(2 * PI * sigma2) - series->sum_res2 / (2 * sigma2);
+			}
+			else if (series->sum_res2 > 0)
+			{
+				sigma2 = series->sum_res2 / n;
+				loglik = -0.5 * n * (log(2 * PI * sigma2) + 1);
+			}
+		}
+
+		if (loglik != DATA_GAP) loglik_total += loglik;
+
+		fprintf(SUM_file.ptr, "%8i %8i %8i %8i %14.6e %14.6e %14.6e %14.6e %14.6e %14.6e\n",
+			    series->outcode, series->timestep, series->nobs, series->n, rmse, bias, nse, loglik,
+				series->n > 0 ? series->mean_obs : DATA_GAP, series->n > 0 ? series->sum_sim / n : DATA_GAP);
+	}
+
+	fprintf(SUM_file.ptr, "total log-likelihood: %14.6e\n", loglik_total);
+
+	fclose(SUM_file.ptr);
+
+	return (errorCode);
+}
@@ -0,0 +1,202 @@
+/*
+obscomp_init.c
+read the settings and the observation series of the in-process comparison of model outputs with observations if they are available
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_constants.h"
+#include "bgc_func.h"
+
+
+int obscomp_init(obscomp_struct* OBS, const control_struct* ctrl, const output_struct* output)
+{
+	int errorCode=0;
+	file OBS_file;
+	char keyword[STRINGSIZE];
+	obsseries_struct* series;
+
+	/* default values: no comparison, summary file: outprefix.obscomp */
+	OBS->nseries = 0;
+	strcpy(OBS->summary_file, output->outprefix);
+	strcat(OBS->summary_file, ".obscomp");
+
+	/********************************************************************
+	**                                                                 **
+	** Reading observation settings if available (only in normal run)  **
+	**                                                                 **
+	********************************************************************/
+
+	if (ctrl->spinup != 0) return (errorCode);
+
+	strcpy(OBS_file.name, "observations.txt");
+	if (file_open(&OBS_file,'j',1)) return (errorCode);
+
+	/* the file consists of keyword-blocks, the order of the blocks is arbitrary */
+	while (!errorCode && !scan_array(OBS_file, keyword, 's', 1, 0))
+	{
+		/* SUMMARY block: name of the file of the goodness-of-fit metrics */
+		if (!strcmp(keyword, "SUMMARY"))
+		{
+			if (!errorCode && scan_value(OBS_file, OBS->summary_file, 's'))
+			{
+				printf("ERROR reading name of summary file: obscomp_init()\n");
+				errorCode=22001;
+			}
+		}
+		/* OBSERVATION block: output code, timestep flag (0: daily, 1: monthly), sigma of observation error, file of the observations */
+		else if (!strcmp(keyword, "OBSERVATION"))
+		{
+			if (!errorCode && OBS->nseries == N_OBSSERIES)
+			{
+				printf("ERROR in observations.txt: maximum number of observation series is %i\n", N_OBSSERIES);
+				errorCode=22002;
+			}
+
+			if (!errorCode) series = &OBS->series[OBS->nseries];
+
+			if (!errorCode && scan_value(OBS_file, &series->outcode, 'i'))
+			{
+				printf("ERROR reading output code of observation series: obscomp_init()\n");
+				errorCode=22003;
+			}
+			if (!errorCode && scan_value(OBS_file, &series->timestep, 'i'))
+			{
+				printf("ERROR reading timestep flag of observation series: obscomp_init()\n");
+				errorCode=22004;
+			}
+			if (!errorCode && scan_value(OBS_file, &series->sigma, 'd'))
+			{
+				printf("ERROR reading sigma of observation series: obscomp_init()\n");
+				errorCode=22005;
+			}
+			if (!errorCode && scan_value(OBS_file, series->obs_file, 's'))
+			{
+				printf("ERROR reading file name of observation series: obscomp_init()\n");
+				errorCode=22006;
+			}
+			if (!errorCode && output_code_check(series->outcode, "observations.txt"))
+				errorCode=22007;
+			if (!errorCode && series->timestep != 0 && series->timestep != 1)
+			{
+				printf("ERROR in observations.txt: timestep flag must be 0 (daily) or 1 (monthly)\n");
+				errorCode=22008;
+			}
+			if (!errorCode && series->sigma <= 0) series->sigma = DATA_GAP;
+
+			if (!errorCode && obsseries_read(series, ctrl))
+			{
+				printf("ERROR in call to obsseries_read() from obscomp_init()\n");
+				errorCode=22009;
+			}
+
+			if (!errorCode) OBS->nseries += 1;
+		}
+		else
+		{
+			printf("ERROR in observations.txt: unknown keyword --> %s\n", keyword);
+			errorCode=220;
+		}
+	}
+
+	fclose(OBS_file.ptr);
+
+	return (errorCode);
+}
+
+
+int obsseries_read(obsseries_struct* series, const control_struct* ctrl)
+{
+	/* observation file: one observation per line (date: YYYY-MM-DD, value), the day of monthly observations is not used;
+	   observations outside of the simulation period are skipped, DATA_GAP values are missing observations */
+	int errorCode=0;
+	file DAT_file;
+
+	int p1,p2,p3, date, ndata, maxOBS_num;
+	double p4;
+	char tempvar;
+
+	maxOBS_num = ctrl->simyears * nDAYS_OF_YEAR;
+
+	series->nobs        = 0;
+	series->date_array  = 0;
+	series->value_array = 0;
+	series->mgmdOBS     = 0;
+	series->monsum      = 0;
+	series->n           = 0;
+	series->sum_res     = 0;
+	series->sum_res2    = 0;
+	series->sum_sim     = 0;
+	series->mean_obs    = 0;
+	series->M2_obs      = 0;
+
+	strcpy(DAT_file.name, series->obs_file);
+	if (file_open(&DAT_file,'i',1))
+	{
+		printf("ERROR opening observation file: %s\n", series->obs_file);
+		return (1);
+	}
+
+	series->date_array  = (int*) arena_malloc(maxOBS_num*sizeof(int));
+	series->value_array = (double*) arena_malloc(maxOBS_num*sizeof(double));
+	if (!series->date_array || !series->value_array)
+	{
+		printf("ERROR allocating for observation arrays in obscomp_init.c\n");
+		errorCode=1;
+	}
+
+	ndata = 0;
+	while (!errorCode && !scan_array(DAT_file, &p1, 'i', 0, 0))
+	{
+		if (fscanf(DAT_file.ptr, "%c%d%c%d%lf%*[^\n]", &tempvar,&p2,&tempvar,&p3,&p4) != 5)
+		{
+			printf("ERROR reading line of observation file %s (format: YYYY-MM-DD value)\n", series->obs_file);
+			errorCode=1;
+		}
+
+		if (!errorCode && p1 >= ctrl->simstartyear && p1 < ctrl->simstartyear + ctrl->simyears && p4 != DATA_GAP)
+		{
+			if (series->timestep == 0)
+				date = p1*10000 + p2*100 + p3;
+			else
+				date = p1*100 + p2;
+
+			/* the comparison follows the simulation day by day: dates have to be unique and in ascending order */
+			if (ndata && date <= series->date_array[ndata-1])
+			{
+				printf("ERROR in observation file %s: dates are not in ascending order or not unique (%i-%i-%i)\n", series->obs_file, p1, p2, p3);
+				errorCode=1;
+			}
+			if (!errorCode && ndata == maxOBS_num)
+			{
+				printf("ERROR in observation file %s: too many observations\n", series->obs_file);
+				errorCode=1;
+			}
+			if (!errorCode)
+			{
+				series->date_array[ndata]  = date;
+				series->value_array[ndata] = p4;
+				ndata += 1;
+			}
+		}
+	}
+
+	series->nobs = ndata;
+
+	fclose(DAT_file.ptr);
+
+	return (errorCode);
+}
@@ -0,0 +1,419 @@
+/*
+optim.c
+management strategy optimizer: the candidate values of the management decisions (amount or date of fertilizing, irrigating
+and mowing) are simulated in parallel from the state at the beginning of the year of the action instead of re-simulating
+the whole period; accumulation of the objective and writing of the results
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_constants.h"
+#include "bgc_func.h"
+#include "bgc_io.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+static const char* optim_mgmname[3]   = {"FERTILIZING", "IRRIGATING", "MOWING"};
+static const char* optim_paramname[2] = {"AMOUNT", "DATE"};
+
+
+static int optim_mgmarrays(bgcin_struct* bgcin, int mgmtype, int*** year, int*** month, int*** day, double*** amount)
+{
+	/* addresses of the date and amount arrays of the management type, returns the number of actions */
+	switch (mgmtype)
+	{
+	case 0:
+		*year   = &bgcin->FRZ.FRZyear_array;
+		*month  = &bgcin->FRZ.FRZmonth_array;
+		*day    = &bgcin->FRZ.FRZday_array;
+		*amount = &bgcin->FRZ.fertilizer_array;
+		return (bgcin->FRZ.FRZ_num);
+	case 1:
+		*year   = &bgcin->IRG.IRGyear_array;
+		*month  = &bgcin->IRG.IRGmonth_array;
+		*day    = &bgcin->IRG.IRGday_array;
+		*amount = &bgcin->IRG.IRGquantity_array;
+		return (bgcin->IRG.IRG_num);
+	default:
+		*year   = &bgcin->MOW.MOWyear_array;
+		*month  = &bgcin->MOW.MOWmonth_array;
+		*day    = &bgcin->MOW.MOWday_array;
+		*amount = &bgcin->MOW.LAI_limit_array;
+		return (bgcin->MOW.MOW_num);
+	}
+}
+
+
+static int optim_private(bgcin_struct* bgcin, int mgmtype)
+{
+	/* the candidate runs get their own copy of the modified arrays (the other arrays are shared with the main run) */
+	int errorCode=0;
+	int n;
+	int **year, **month, **day;
+	double** amount;
+	int *month_copy, *day_copy;
+	double* amount_copy;
+
+	n = optim_mgmarrays(bgcin, mgmtype, &year, &month, &day, &amount);
+
+	month_copy  = (int*) malloc(n * sizeof(int));
+	day_copy    = (int*) malloc(n * sizeof(int));
+	amount_copy = (double*) malloc(n * sizeof(double));
+
+	if (!month_copy || !day_copy || !amount_copy)
+	{
+		printf("ERROR allocating for management arrays of candidate run, optim_private()\n");
+		free(month_copy);
+		free(day_copy);
+		free(amount_copy);
+		errorCode=1;
+	}
+	else
+	{
+		memcpy(month_copy, *month, n * sizeof(int));
+		memcpy(day_copy, *day, n * sizeof(int));
+		memcpy(amount_copy, *amount, n * sizeof(double));
+		*month  = month_copy;
+		*day    = day_copy;
+		*amount = amount_copy;
+	}
+
+	return (errorCode);
+}
+
+
+static void optim_release(bgcin_struct* bgcin, int mgmtype)
+{
+	int **year, **month, **day;
+	double** amount;
+
+	optim_mgmarrays(bgcin, mgmtype, &year, &month, &day, &amount);
+	free(*month);
+	free(*day);
+	free(*amount);
+}
+
+
+static int optim_dayindex(int year, int month, int day)
+{
+	int mondays[nMONTHS_OF_YEAR], enddays[nMONTHS_OF_YEAR];
+	int leap;
+
+	leapControl(year, enddays, mondays, &leap);
+
+	return (year * nDAYS_OF_YEAR + date_to_doy(mondays, month, day));
+}
+
+
+static int optim_setvalue(bgcin_struct* bgcin, const optdecision_struct* dec, double value)
+{
+	/* returns 1 if the candidate is not feasible: the shifted date must remain in the same year and
+	   between the neighbouring actions of the same type (the actions are processed in chronological order) */
+	int n, act, doy, leap, month_new, day_new, index;
+	int mondays[nMONTHS_OF_YEAR], enddays[nMONTHS_OF_YEAR];
+	int **year, **month, **day;
+	double** amount;
+
+	n   = optim_mgmarrays(bgcin, dec->mgmtype, &year, &month, &day, &amount);
+	act = dec->action;
+
+	if (dec->param == 0)
+	{
+		(*amount)[act] = value;
+		return (0);
+	}
+
+	doy = dec->base_doy + (int) value;
+	if (doy < 0 || doy >= nDAYS_OF_YEAR) return (1);
+
+	leapControl((*year)[act], enddays, mondays, &leap);
+	doy_to_date(enddays, doy, &month_new, &day_new, 0);
+	index = optim_dayindex((*year)[act], month_new, day_new);
+
+	if (act > 0 && optim_dayindex((*year)[act-1], (*month)[act-1], (*day)[act-1]) >= index) return (1);
+	if (act < n-1 && optim_dayindex((*year)[act+1], (*month)[act+1], (*day)[act+1]) <= index) return (1);
+
+	(*month)[act] = month_new;
+	(*day)[act]   = day_new;
+
+	return (0);
+}
+
+
+static int optim_branch(const bgcin_struct* bgcin_main, const optdecision_struct* dec, double value, int start_simyr, int stop_simyr,
+	                    resimstate_struct* state, double* objective)
+{
+	/* one run of the optimizer without outputs: from the state of the beginning of start_simyr (start_simyr=0: from the
+	   initial state) until the end of the simulation or of stop_simyr (the state is then kept in the buffer);
+	   dec=NULL: run with the actual management settings */
+	int errorCode=0;
+	int feasible=1;
+	int private_arrays=0;
+	bgcin_struct* bgcin;
+	bgcout_struct bgcout;
+	char* planttypeName;
+	arena_struct arena;
+	arena_struct* previous;
+
+	*objective = DATA_GAP;
+
+	bgcin         = (bgcin_struct*) malloc(sizeof(bgcin_struct));
+	planttypeName = (char*) malloc(STRINGSIZE * sizeof(char));
+	if (!bgcin || !planttypeName)
+	{
+		printf("ERROR allocating for candidate run, optim_branch()\n");
+		free(bgcin);
+		free(planttypeName);
+		return (1);
+	}
+
+	*bgcin = *bgcin_main;
+	strcpy(planttypeName, bgcin_main->ctrl.planttypeName);
+	bgcin->ctrl.planttypeName = planttypeName;
+
+	/* no output files, no screen messages, no comparison with observations and no aggregation: only the objective is evaluated */
+	bgcin->ctrl.onscreen      = 0;
+	bgcin->ctrl.dodaily       = 0;
+	bgcin->ctrl.domonavg      = 0;
+	bgcin->ctrl.doannavg      = 0;
+	bgcin->ctrl.doannual      = 0;
+	bgcin->ctrl.write_restart = 0;
+	bgcin->OBS.nseries        = 0;
+	bgcin->AGG.nspec          = 0;
+
+	bgcin->RSM.flag          = 0;
+	bgcin->RSM.start_simyr   = start_simyr;
+	bgcin->RSM.stop_simyr    = stop_simyr;
+	bgcin->RSM.state         = state;
+	bgcin->RSM.fork_flag     = start_simyr == bgcin_main->RSM.start_simyr ? bgcin_main->RSM.fork_flag : 0;
+	bgcin->RSM.pack_buffer   = 0;
+	bgcin->RSM.dayhash       = 0;
+	bgcin->RSM.daycheck      = 0;
+	bgcin->RSM.snap_file.ptr = 0;
+
+	bgcin->OPT.objective = 0;
+
+	if (dec)
+	{
+		errorCode = optim_private(bgcin, dec->mgmtype);
+		if (!errorCode) private_arrays = 1;
+		if (!errorCode && optim_setvalue(bgcin, dec, value)) feasible = 0;
+	}
+
+	/* the log and the economic output of the candidate runs are written into temporary files */
+	memset(&bgcout, 0, sizeof(bgcout_struct));
+	if (!errorCode)
+	{
+		bgcout.log_file.ptr = tmpfile();
+		if (bgcin->HRV.HRV_num) bgcout.econout_file.ptr = tmpfile();
+		if (!bgcout.log_file.ptr || (bgcin->HRV.HRV_num && !bgcout.econout_file.ptr))
+		{
+			printf("ERROR opening temporary files of candidate run, optim_branch()\n");
+			errorCode=1;
+		}
+	}
+
+	/* the arrays allocated during the run (e.g. the EPC arrays read again at planting) belong to the arena of the candidate */
+	if (!errorCode && feasible)
+	{
+		arena_init(&arena, ARENA_BLOCKSIZE);
+		previous  = arena_enter(&arena);
+		errorCode = bgc(bgcin, &bgcout);
+		arena_enter(previous);
+		arena_release(&arena);
+		if (!errorCode) *objective = bgcin->OPT.objective;
+	}
+
+	if (bgcout.log_file.ptr) fclose(bgcout.log_file.ptr);
+	if (bgcout.econout_file.ptr) fclose(bgcout.econout_file.ptr);
+	if (private_arrays) optim_release(bgcin, dec->mgmtype);
+	free(planttypeName);
+	free(bgcin);
+
+	return (errorCode);
+}
+
+
+int optim_run(bgcin_struct* bgcin, bgcout_struct* bgcout)
+{
+	/* greedy search in chronological order: the candidates of a decision are simulated in parallel from the state at the
+	   beginning of the year of the action (earlier decisions are already fixed, later ones have the values of the management
+	   file), the best candidate is fixed, then the common trunk run is continued until the year of the next decision;
+	   a scenario of the fork mode starts the trunk from the end state of the common period */
+	int errorCode=0;
+	int nd, nc, trunk_simyr, nruns;
+	double trunk_objective;
+	optim_struct* OPT = &bgcin->OPT;
+	optdecision_struct* dec;
+	resimstate_struct* state;
+
+	state = (resimstate_struct*) malloc(sizeof(resimstate_struct));
+	if (!state)
+	{
+		printf("ERROR allocating for state of trunk run, optim_run()\n");
+		return (1);
+	}
+
+#ifdef _OPENMP
+	if (OPT->nthreads > 0) omp_set_num_threads(OPT->nthreads);
+#endif
+
+	trunk_simyr = bgcin->RSM.start_simyr;
+	nruns       = 0;
+	if (trunk_simyr) *state = *bgcin->RSM.state;
+
+	for (nd = 0; !errorCode && nd < OPT->ndec; nd++)
+	{
+		dec = &OPT->dec[nd];
+
+		if (dec->simyr < trunk_simyr)
+		{
+			printf("ERROR in management optimizer: %s action %i is before the year of the fork\n", optim_mgmname[dec->mgmtype], dec->action+1);
+			errorCode=1;
+			break;
+		}
+
+		if (bgcin->ctrl.onscreen) printf("OPTIMIZING decision %i/%i: %s %i %s\n", nd+1, OPT->ndec, optim_mgmname[dec->mgmtype], dec->action+1, optim_paramname[dec->param]);
+
+		/* common trunk run until the end of the year before the action */
+		if (dec->simyr > trunk_simyr)
+		{
+			errorCode = optim_branch(bgcin, NULL, 0, trunk_simyr, dec->simyr-1, state, &trunk_objective);
+			if (errorCode)
+				printf("ERROR in trunk run of management optimizer, optim_run()\n");
+			else
+			{
+				trunk_simyr = dec->simyr;
+				nruns += 1;
+			}
+		}
+
+		/* the candidate runs are independent: each has its own input structure and management arrays */
+		if (!errorCode)
+		{
+			#pragma omp parallel for schedule(dynamic,1)
+			for (nc = 0; nc < dec->ncand; nc++)
+			{
+				if (optim_branch(bgcin, dec, dec->cand[nc], trunk_simyr, -1, state, &dec->objective[nc]))
+					dec->objective[nc] = DATA_GAP;
+			}
+			nruns += dec->ncand;
+		}
+
+		/* selection of the best feasible candidate (maximum of the objective) */
+		if (!errorCode)
+		{
+			dec->best = -1;
+			for (nc = 0; nc < dec->ncand; nc++)
+			{
+				if (dec->objective[nc] != DATA_GAP && (dec->best < 0 || dec->objective[nc] > dec->objective[dec->best])) dec->best = nc;
+			}
+			if (dec->best < 0)
+			{
+				printf("ERROR in management optimizer: no feasible candidate for %s action %i\n", optim_mgmname[dec->mgmtype], dec->action+1);
+				errorCode=1;
+			}
+		}
+
+		if (!errorCode && optim_setvalue(bgcin, dec, dec->cand[dec->best]))
+		{
+			printf("ERROR in setting the selected candidate of %s action %i, optim_run()\n", optim_mgmname[dec->mgmtype], dec->action+1);
+			errorCode=1;
+		}
+	}
+
+	free(state);
+
+	if (!errorCode)
+	{
+		fprintf(bgcout->log_file.ptr, "MANAGEMENT OPTIMIZATION\n");
+		fprintf(bgcout->log_file.ptr, "number of decisions:              %12i\n", OPT->ndec);
+		fprintf(bgcout->log_file.ptr, "number of runs:                   %12i\n", nruns);
+		for (nd = 0; nd < OPT->ndec; nd++)
+		{
+			dec = &OPT->dec[nd];
+			fprintf(bgcout->log_file.ptr, "%-12s action %3i %-6s - selected: %12.3f\n",
+				    optim_mgmname[dec->mgmtype], dec->action+1, optim_paramname[dec->param], dec->cand[dec->best]);
+		}
+		fprintf(bgcout->log_file.ptr, " \n");
+	}
+
+	return (errorCode);
+}
+
+
+int optim_update(optim_struct* OPT, const control_struct* ctrl, double** output_map)
+{
+	/* the objective is read directly from the output map, therefore it works also if no output is requested */
+	int errorCode=0;
+	int no;
+
+	for (no = 0; !errorCode && no < OPT->nobj; no++)
+	{
+		if (output_map[OPT->obj_outcode[no]] == NULL)
+		{
+			printf("ERROR in optimizer.txt: output variable %i is not available (not part of the soil profile of the run)\n", OPT->obj_outcode[no]);
+			errorCode=1;
+		}
+		else if (OPT->obj_mode[no] == 0 ||
+			     (OPT->obj_mode[no] == 1 && ctrl->yday == nDAYS_OF_YEAR-1) ||
+				 (OPT->obj_mode[no] == 2 && ctrl->yday == nDAYS_OF_YEAR-1 && ctrl->simyr == ctrl->simyears-1))
+		{
+			OPT->objective += OPT->obj_weight[no] * *(output_map[OPT->obj_outcode[no]]);
+		}
+	}
+
+	return (errorCode);
+}
+
+
+int optim_report(const optim_struct* OPT)
+{
+	/* objective of every candidate (DATA_GAP: not feasible) and the objective of the optimized run */
+	int errorCode=0;
+	int nd, nc;
+	const optdecision_struct* dec;
+	file REP_file;
+
+	strcpy(REP_file.name, OPT->report_file);
+	if (file_open(&REP_file,'o',1))
+	{
+		printf("ERROR opening report file of management optimizer: %s\n", OPT->report_file);
+		return (1);
+	}
+
+	fprintf(REP_file.ptr, "%8s %12s %8s %8s %8s %14s %14s %8s\n",
+		    "decision", "management", "action", "simyr", "variable", "candidate", "objective", "selected");
+
+	for (nd = 0; nd < OPT->ndec; nd++)
+	{
+		dec = &OPT->dec[nd];
+		for (nc = 0; nc < dec->ncand; nc++)
+		{
+			fprintf(REP_file.ptr, "%8i %12s %8i %8i %8s %14.6e %14.6e %8i\n",
+				    nd+1, optim_mgmname[dec->mgmtype], dec->action+1, dec->simyr, optim_paramname[dec->param],
+					dec->cand[nc], dec->objective[nc], nc == dec->best);
+		}
+	}
+
+	fprintf(REP_file.ptr, "objective of the optimized run: %14.6e\n", OPT->objective);
+
+	fclose(REP_file.ptr);
+
+	return (errorCode);
+}
+
@@ -0,0 +1,284 @@
+/*
+optim_init.c
+read the settings of the management strategy optimizer (objective, decisions and their candidate values)
+if they are available
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_constants.h"
+#include "bgc_func.h"
+
+
+int optim_init(optim_struct* OPT, const control_struct* ctrl, const fertilizing_struct* FRZ, const irrigating_struct* IRG,
+	           const mowing_struct* MOW, const output_struct* output)
+{
+	int errorCode=0;
+	int nc, nd, leap;
+	int ndec_read=0;
+	int action_num=0, year=0, month=0, day=0;
+	int mondays[nMONTHS_OF_YEAR], enddays[nMONTHS_OF_YEAR];
+	file OPT_file;
+	char keyword[STRINGSIZE];
+	char name[STRINGSIZE];
+	optdecision_struct* dec;
+	optdecision_struct dec_tmp;
+
+	/* default values: no optimization, report file: outprefix.optimization */
+	OPT->nobj      = 0;
+	OPT->ndec      = 0;
+	OPT->nthreads  = 0;
+	OPT->objective = 0;
+	strcpy(OPT->report_file, output->outprefix);
+	strcat(OPT->report_file, ".optimization");
+
+	/********************************************************************
+	**                                                                 **
+	** Reading optimizer settings if available (only in normal run)    **
+	**                                                                 **
+	********************************************************************/
+
+	if (ctrl->spinup != 0) return (errorCode);
+
+	strcpy(OPT_file.name, "optimizer.txt");
+	if (file_open(&OPT_file,'j',1)) return (errorCode);
+
+	/* the file consists of keyword-blocks, the order of the blocks is arbitrary */
+	while (!errorCode && !scan_array(OPT_file, keyword, 's', 1, 0))
+	{
+		/* OBJECTIVE block: output code, mode (0: sum of daily values, 1: sum of end-of-year values, 2: end-of-simulation value), weight */
+		if (!strcmp(keyword, "OBJECTIVE"))
+		{
+			if (!errorCode && OPT->nobj == N_OPTOBJ)
+			{
+				printf("ERROR in optimizer.txt: maximum number of objective terms is %i\n", N_OPTOBJ);
+				errorCode=22301;
+			}
+			if (!errorCode && scan_value(OPT_file, &OPT->obj_outcode[OPT->nobj], 'i'))
+			{
+				printf("ERROR reading output code of objective term: optim_init()\n");
+				errorCode=22302;
+			}
+			if (!errorCode && scan_value(OPT_file, &OPT->obj_mode[OPT->nobj], 'i'))
+			{
+				printf("ERROR reading mode of objective term: optim_init()\n");
+				errorCode=22302;
+			}
+			if (!errorCode && scan_value(OPT_file, &OPT->obj_weight[OPT->nobj], 'd'))
+			{
+				printf("ERROR reading weight of objective term: optim_init()\n");
+				errorCode=22302;
+			}
+			if (!errorCode && output_code_check(OPT->obj_outcode[OPT->nobj], "optimizer.txt (objective term)"))
+				errorCode=22303;
+			if (!errorCode && (OPT->obj_mode[OPT->nobj] < 0 || OPT->obj_mode[OPT->nobj] > 2))
+			{
+				printf("ERROR in optimizer.txt: mode of objective term must be 0, 1 or 2\n");
+				errorCode=22303;
+			}
+			if (!errorCode) OPT->nobj += 1;
+		}
+		/* DECISION block: management type (FERTILIZING, IRRIGATING or MOWING), number of the action in the management file,
+		   decision variable (AMOUNT or DATE), number of candidates, candidate values (amount or date shift in days), one per line */
+		else if (!strcmp(keyword, "DECISION"))
+		{
+			if (!errorCode && OPT->ndec == N_OPTDEC)
+			{
+				printf("ERROR in optimizer.txt: maximum number of decisions is %i\n", N_OPTDEC);
+				errorCode=22304;
+			}
+
+			if (!errorCode) dec = &OPT->dec[OPT->ndec];
+
+			if (!errorCode && scan_value(OPT_file, name, 's'))
+			{
+				printf("ERROR reading management type of decision: optim_init()\n");
+				errorCode=22305;
+			}
+			if (!errorCode)
+			{
+				if (!strcmp(name, "FERTILIZING"))
+					dec->mgmtype = 0;
+				else if (!strcmp(name, "IRRIGATING"))
+					dec->mgmtype = 1;
+				else if (!strcmp(name, "MOWING"))
+					dec->mgmtype = 2;
+				else
+				{
+					printf("ERROR in optimizer.txt: unknown management type --> %s\n", name);
+					errorCode=22306;
+				}
+			}
+			if (!errorCode && scan_value(OPT_file, &dec->action, 'i'))
+			{
+				printf("ERROR reading number of management action of decision: optim_init()\n");
+				errorCode=22305;
+			}
+			if (!errorCode && scan_value(OPT_file, name, 's'))
+			{
+				printf("ERROR reading decision variable: optim_init()\n");
+				errorCode=22305;
+			}
+			if (!errorCode)
+			{
+				if (!strcmp(name, "AMOUNT"))
+					dec->param = 0;
+				else if (!strcmp(name, "DATE"))
+					dec->param = 1;
+				else
+				{
+					printf("ERROR in optimizer.txt: unknown decision variable --> %s\n", name);
+					errorCode=22306;
+				}
+			}
+			if (!errorCode && scan_value(OPT_file, &dec->ncand, 'i'))
+			{
+				printf("ERROR reading number of candidates of decision: optim_init()\n");
+				errorCode=22305;
+			}
+			if (!errorCode && (dec->ncand < 1 || dec->ncand > N_OPTCAND))
+			{
+				printf("ERROR in optimizer.txt: number of candidates must be between 1 and %i\n", N_OPTCAND);
+				errorCode=22307;
+			}
+			for (nc = 0; !errorCode && nc < dec->ncand; nc++)
+			{
+				if (scan_value(OPT_file, &dec->cand[nc], 'd'))
+				{
+					printf("ERROR reading candidate value of decision: optim_init()\n");
+					errorCode=22305;
+				}
+				else if (dec->param == 0 && dec->cand[nc] < 0)
+				{
+					printf("ERROR in optimizer.txt: candidate amounts must be non-negative\n");
+					errorCode=22307;
+				}
+				else if (dec->param == 1 && dec->cand[nc] != floor(dec->cand[nc]))
+				{
+					printf("ERROR in optimizer.txt: candidate date shifts must be whole days\n");
+					errorCode=22307;
+				}
+				dec->objective[nc] = DATA_GAP;
+			}
+
+			/* the action must exist: its year defines the branching point of the candidates */
+			if (!errorCode)
+			{
+				dec->action -= 1;
+				dec->best    = -1;
+				switch (dec->mgmtype)
+				{
+				case 0:
+					action_num = FRZ->FRZ_num;
+					if (dec->action >= 0 && dec->action < action_num)
+					{
+						year  = FRZ->FRZyear_array[dec->action];
+						month = FRZ->FRZmonth_array[dec->action];
+						day   = FRZ->FRZday_array[dec->action];
+					}
+					break;
+				case 1:
+					action_num = IRG->IRG_num;
+					if (dec->action >= 0 && dec->action < action_num)
+					{
+						year  = IRG->IRGyear_array[dec->action];
+						month = IRG->IRGmonth_array[dec->action];
+						day   = IRG->IRGday_array[dec->action];
+					}
+					break;
+				default:
+					action_num = MOW->MOW_num;
+					if (dec->action >= 0 && dec->action < action_num)
+					{
+						year  = MOW->MOWyear_array[dec->action];
+						month = MOW->MOWmonth_array[dec->action];
+						day   = MOW->MOWday_array[dec->action];
+					}
+					break;
+				}
+				if (dec->action < 0 || dec->action >= action_num)
+				{
+					printf("ERROR in optimizer.txt: management action %i does not exist (number of actions: %i)\n", dec->action+1, action_num);
+					errorCode=22308;
+				}
+			}
+			if (!errorCode && leapControl(year, enddays, mondays, &leap))
+			{
+				printf("ERROR in call to leapControl() from optim_init()\n");
+				errorCode=22309;
+			}
+
+			/* actions out of the simulation period (e.g. in the shared prefix run of the fork mode) are not optimized in this run */
+			if (!errorCode)
+			{
+				ndec_read += 1;
+				dec->simyr    = year - ctrl->simstartyear;
+				dec->base_doy = date_to_doy(mondays, month, day);
+				if (dec->simyr < 0 || dec->simyr >= ctrl->simyears)
+					printf("WARNING in optimizer.txt: management action %i is out of the simulation period, the decision is skipped\n", dec->action+1);
+				else
+					OPT->ndec += 1;
+			}
+		}
+		/* THREADS block: number of parallel candidate runs (0: all available processors) */
+		else if (!strcmp(keyword, "THREADS"))
+		{
+			if (!errorCode && scan_value(OPT_file, &OPT->nthreads, 'i'))
+			{
+				printf("ERROR reading number of threads: optim_init()\n");
+				errorCode=22310;
+			}
+			if (!errorCode && OPT->nthreads < 0)
+			{
+				printf("ERROR in optimizer.txt: number of threads must be non-negative\n");
+				errorCode=22310;
+			}
+		}
+		/* REPORT block: name of the file of the optimization results */
+		else if (!strcmp(keyword, "REPORT"))
+		{
+			if (!errorCode && scan_value(OPT_file, OPT->report_file, 's'))
+			{
+				printf("ERROR reading name of report file: optim_init()\n");
+				errorCode=22311;
+			}
+		}
+		else
+		{
+			printf("ERROR in optimizer.txt: unknown keyword --> %s\n", keyword);
+			errorCode=223;
+		}
+	}
+
+	fclose(OPT_file.ptr);
+
+	if (!errorCode && ndec_read && !OPT->nobj)
+	{
+		printf("ERROR in optimizer.txt: no OBJECTIVE block is found\n");
+		errorCode=22312;
+	}
+
+	/* the decisions are optimized in chronological order (stable sorting by simulation year) */
+	for (nd = 1; !errorCode && nd < OPT->ndec; nd++)
+	{
+		dec_tmp = OPT->dec[nd];
+		for (nc = nd; nc > 0 && OPT->dec[nc-1].simyr > dec_tmp.simyr; nc--) OPT->dec[nc] = OPT->dec[nc-1];
+		OPT->dec[nc] = dec_tmp;
+	}
+
+	return (errorCode);
+}
+
@@ -0,0 +1,305 @@
+/*
+outindex.c
+sidecar index of the binary output files (<output file>.idx): variable codes and names, record size and the first record
+of each simulation year, so that a slice of a variable can be read without reading the whole file; reader functions
+
+index format (text):
+MUSOINDEX 1
+FILE <binary output file>
+STEP <0: daily, 1: monthly average, 2: annual average, 3: annual>
+NVAR <number of variables>
+RECSIZE <bytes of a record (one value of each variable)>
+SOUTHSHIFT <shift of the days in southern hemisphere (0: no shift)>
+VAR <output code> <name>                  (one line per variable in the order of the record)
+YEAR <year> <first record> <number of records>   (one line per simulation year)
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_constants.h"
+
+#define OUTINDEX_MAGIC "MUSOINDEX 1"
+
+
+int outindex_write(file* data, int step, int nvar, const int* codes, char** names, const control_struct* ctrl, int first_simyr)
+{
+	/* the records of the years are counted from the size of the written file (truncated last year, re-simulation);
+	   first_simyr: first simulation year in the file (scenario run of the fork mode) */
+	int errorCode=0;
+	int i, simyr, nrec_year;
+	long size, nrec, first;
+	file idx;
+
+	nrec_year = (step == 0) ? nDAYS_OF_YEAR : ((step == 1) ? nMONTHS_OF_YEAR : 1);
+
+	fflush(data->ptr);
+	size = ftell(data->ptr);
+	if (size < 0)
+	{
+		printf("ERROR in determining the size of %s, outindex_write()\n", data->name);
+		return (1);
+	}
+	nrec = size / (nvar * (long) sizeof(double));
+
+	if (strlen(data->name) + 4 >= FILENAMESIZE)
+	{
+		printf("ERROR in outindex_write(): name of output file is too long for the index file (%s)\n", data->name);
+		return (1);
+	}
+	strcpy(idx.name, data->name);
+	strcat(idx.name, ".idx");
+	if (file_open(&idx,'o',1)) return (1);
+
+	fprintf(idx.ptr, "%s\n", OUTINDEX_MAGIC);
+	fprintf(idx.ptr, "FILE %s\n", data->name);
+	fprintf(idx.ptr, "STEP %i\n", step);
+	fprintf(idx.ptr, "NVAR %i\n", nvar);
+	fprintf(idx.ptr, "RECSIZE %i\n", nvar * (int) sizeof(double));
+	fprintf(idx.ptr, "SOUTHSHIFT %i\n", ctrl->south_shift);
+	for (i = 0; i < nvar; i++) fprintf(idx.ptr, "VAR %i %s\n", codes[i], names[i]);
+
+	for (simyr = first_simyr; simyr < ctrl->simyears; simyr++)
+	{
+		first = (long) (simyr - first_simyr) * nrec_year;
+		if (first >= nrec) break;
+		fprintf(idx.ptr, "YEAR %i %li %li\n", ctrl->simstartyear + simyr, first, (nrec - first < nrec_year) ? nrec - first : (long) nrec_year);
+	}
+
+	if (ferror(idx.ptr))
+	{
+		printf("ERROR writing index file %s, outindex_write()\n", idx.name);
+		errorCode=1;
+	}
+	fclose(idx.ptr);
+
+	return (errorCode);
+}
+
+
+int outindex_read(const char* idxname, outindex_struct* IDX)
+{
+	int errorCode=0;
+	int n, year;
+	long first, nrec;
+	char keyword[STRINGSIZE];
+	char line[STRINGSIZE];
+	file idx;
+
+	memset(IDX, 0, sizeof(outindex_struct));
+
+	strcpy(idx.name, idxname);
+	if (file_open(&idx,'i',1)) return (1);
+
+	if (!fgets(line, STRINGSIZE, idx.ptr) || strncmp(line, OUTINDEX_MAGIC, strlen(OUTINDEX_MAGIC)))
+	{
+		printf("ERROR in outindex_read(): %s is not an output index file\n", idxname);
+		errorCode=1;
+	}
+
+	while (!errorCode && fscanf(idx.ptr, "%199s", keyword) == 1)
+	{
+		if (!strcmp(keyword, "FILE"))
+		{
+			if (fscanf(idx.ptr, "%127s", IDX->data_file) != 1) errorCode=1;
+		}
+		else if (!strcmp(keyword, "STEP"))
+		{
+			if (fscanf(idx.ptr, "%i", &IDX->step) != 1) errorCode=1;
+		}
+		else if (!strcmp(keyword, "NVAR"))
+		{
+			if (fscanf(idx.ptr, "%i", &IDX->nvar) != 1 || IDX->nvar < 1 || IDX->codes) errorCode=1;
+			if (!errorCode)
+			{
+				IDX->codes = (int*) malloc(IDX->nvar * sizeof(int));
+				IDX->names = (char(*)[STRINGSIZE]) malloc(IDX->nvar * sizeof(*IDX->names));
+				if (!IDX->codes || !IDX->names)
+				{
+					printf("ERROR allocating for variables of output index, outindex_read()\n");
+					errorCode=1;
+				}
+			}
+		}
+		else if (!strcmp(keyword, "RECSIZE"))
+		{
+			if (fscanf(idx.ptr, "%i", &IDX->recsize) != 1) errorCode=1;
+		}
+		else if (!strcmp(keyword, "SOUTHSHIFT"))
+		{
+			if (fscanf(idx.ptr, "%i", &IDX->south_shift) != 1) errorCode=1;
+		}
+		else if (!strcmp(keyword, "VAR"))
+		{
+			n = IDX->nvar_read;
+			if (!IDX->codes || n >= IDX->nvar || fscanf(idx.ptr, "%i %199s", &IDX->codes[n], IDX->names[n]) != 2)
+				errorCode=1;
+			else
+				IDX->nvar_read += 1;
+		}
+		else if (!strcmp(keyword, "YEAR"))
+		{
+			if (fscanf(idx.ptr, "%i %li %li", &year, &first, &nrec) != 3) errorCode=1;
+			if (!errorCode)
+			{
+				IDX->year_array  = (int*)  realloc(IDX->year_array,  (IDX->nyears + 1) * sizeof(int));
+				IDX->first_array = (long*) realloc(IDX->first_array, (IDX->nyears + 1) * sizeof(long));
+				IDX->nrec_array  = (long*) realloc(IDX->nrec_array,  (IDX->nyears + 1) * sizeof(long));
+				if (!IDX->year_array || !IDX->first_array || !IDX->nrec_array)
+				{
+					printf("ERROR allocating for years of output index, outindex_read()\n");
+					errorCode=1;
+				}
+				else
+				{
+					IDX->year_array[IDX->nyears]  = year;
+					IDX->first_array[IDX->nyears] = first;
+					IDX->nrec_array[IDX->nyears]  = nrec;
+					IDX->nyears += 1;
+				}
+			}
+		}
+		else
+			errorCode=1;
+	}
+
+	if (!errorCode && (IDX->nvar_read != IDX->nvar || IDX->recsize != IDX->nvar * (int) sizeof(double))) errorCode=1;
+	if (errorCode) printf("ERROR in format of output index file %s, outindex_read()\n", idxname);
+
+	fclose(idx.ptr);
+
+	return (errorCode);
+}
+
+
+long outindex_offset(const outindex_struct* IDX, int year, long rec, int var)
+{
+	/* byte offset of a value in the binary output file: record rec (from 0) of the given year, variable var (from 0);
+	   -1: out of the file */
+	int ny;
+
+	if (var < 0 || var >= IDX->nvar) return (-1);
+
+	for (ny = 0; ny < IDX->nyears; ny++)
+	{
+		if (IDX->year_array[ny] == year)
+		{
+			if (rec < 0 || rec >= IDX->nrec_array[ny]) return (-1);
+			return ((IDX->first_array[ny] + rec) * IDX->recsize + var * (long) sizeof(double));
+		}
+	}
+
+	return (-1);
+}
+
+
+int outindex_column(const outindex_struct* IDX, int code, int first_year, int last_year, double** values, long* nvalues)
+{
+	/* values of a variable (output code) in the given years: only the needed records of the binary file are read */
+	int errorCode=0;
+	int var, ny;
+	long rec, n, offset;
+	file data;
+
+	*values  = NULL;
+	*nvalues = 0;
+
+	for (var = 0; var < IDX->nvar && IDX->codes[var] != code; var++) ;
+	if (var == IDX->nvar)
+	{
+		printf("ERROR in outindex_column(): output code %i is not in %s\n", code, IDX->data_file);
+		return (1);
+	}
+
+	n = 0;
+	for (ny = 0; ny < IDX->nyears; ny++)
+		if (IDX->year_array[ny] >= first_year && IDX->year_array[ny] <= last_year) n += IDX->nrec_array[ny];
+	if (n == 0) return (errorCode);
+
+	*values = (double*) malloc(n * sizeof(double));
+	if (!*values)
+	{
+		printf("ERROR allocating for values of output column, outindex_column()\n");
+		return (1);
+	}
+
+	strcpy(data.name, IDX->data_file);
+	if (file_open(&data,'r',1))
+	{
+		free(*values);
+		*values = NULL;
+		return (1);
+	}
+
+	for (ny = 0; !errorCode && ny < IDX->nyears; ny++)
+	{
+		if (IDX->year_array[ny] < first_year || IDX->year_array[ny] > last_year) continue;
+		for (rec = 0; !errorCode && rec < IDX->nrec_array[ny]; rec++)
+		{
+			offset = outindex_offset(IDX, IDX->year_array[ny], rec, var);
+			if (offset < 0 || fseek(data.ptr, offset, SEEK_SET) || fread(&(*values)[*nvalues], sizeof(double), 1, data.ptr) != 1)
+			{
+				printf("ERROR reading from %s, outindex_column()\n", data.name);
+				errorCode=1;
+			}
+			else
+				*nvalues += 1;
+		}
+	}
+
+	fclose(data.ptr);
+
+	return (errorCode);
+}
+
+
+void outindex_free(outindex_struct* IDX)
+{
+	free(IDX->codes);
+	free(IDX->names);
+	free(IDX->year_array);
+	free(IDX->first_array);
+	free(IDX->nrec_array);
+	memset(IDX, 0, sizeof(outindex_struct));
+}
+
+
+int outindex_extract(const char* idxname, int code, int first_year, int last_year)
+{
+	/* reader utility (command line: -extract): values of a variable written on the screen, one record per line */
+	int errorCode=0;
+	int ny, pos;
+	long rec;
+	double* values;
+	long nvalues;
+	outindex_struct IDX;
+
+	if (outindex_read(idxname, &IDX)) return (1);
+
+	errorCode = outindex_column(&IDX, code, first_year, last_year, &values, &nvalues);
+
+	pos = 0;
+	for (ny = 0; !errorCode && ny < IDX.nyears; ny++)
+	{
+		if (IDX.year_array[ny] < first_year || IDX.year_array[ny] > last_year) continue;
+		for (rec = 0; rec < IDX.nrec_array[ny] && pos < nvalues; rec++, pos++)
+			printf("%5i %4li %14.9f\n", IDX.year_array[ny], rec+1, values[pos]);
+	}
+
+	free(values);
+	outindex_free(&IDX);
+
+	return (errorCode);
+}
+
@@ -22,14 +22,220 @@ See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentatio
 #include "pointbgc_struct.h"
 #include "pointbgc_func.h"
 
+#define OUTPUT_MAXFIXED 400			/* maximal length of a formatted real value (fprintf() fallback of large values) */
+#define OUTPUT_LINEHEAD 64			/* maximal length of the date fields of a line */
+#define OUTPUT_LINESIZE(n) (OUTPUT_LINEHEAD + (size_t) (n) * (OUTPUT_MAXFIXED + 1) + 2)
+
+/* reusable line buffer of the ASCII outputs of the calling thread: the lines are formatted into the buffer and written
+   by one fwrite() */
+static char* outline = NULL;
+static size_t outline_size = 0;
+#pragma omp threadprivate(outline, outline_size)
+
+static const unsigned long long output_pow10[10] = {1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+                                                    100000000ULL, 1000000000ULL};
+static const unsigned long long output_pow5[10]  = {1ULL, 5ULL, 25ULL, 125ULL, 625ULL, 3125ULL, 15625ULL, 78125ULL, 390625ULL, 1953125ULL};
+
+
+/* line buffer of at least size bytes */
+static char* output_line(size_t size)
+{
+	char* line;
+
+	if (size > outline_size)
+	{
+		line = (char*) realloc(outline, size);
+		if (!line) return (NULL);
+		outline      = line;
+		outline_size = size;
+	}
+
+	return (outline);
+}
+
+
+/* string right-justified in the field as by "%<width>s" */
+static int output_string(char* s, const char* str, int width)
+{
+	int len, pad;
+
+	len = (int) strlen(str);
+	pad = (width > len) ? width - len : 0;
+	memset(s, ' ', pad);
+	memcpy(s + pad, str, len);
+
+	return (pad + len);
+}
+
+
+/* integer right-justified in the field as by "%<width>i" */
+static int output_int(char* s, int value, int width)
+{
+	char digits[16];
+	int n=0, len, pad;
+	unsigned int u;
+
+	u = (value < 0) ? 0U - (unsigned int) value : (unsigned int) value;
+	do
+	{
+		digits[n++] = (char) ('0' + u % 10);
+		u /= 10;
+	} while (u);
+
+	len = n + (value < 0);
+	pad = (width > len) ? width - len : 0;
+	memset(s, ' ', pad);
+	s += pad;
+	if (value < 0) *s++ = '-';
+	while (n) *s++ = digits[--n];
+
+	return (pad + len);
+}
+
+
+/* real value as by "%<width>.<prec>f": the value (|value| < 2^32, prec <= 9) is split into integer part and binary
+   fraction, the fraction is scaled by 10^prec exactly in 128-bit integer arithmetic and rounded to nearest with ties to
+   even, as the decimal conversion of fprintf(); NaN, infinity and larger values are formatted by snprintf() */
+static int output_fixed(char* s, double value, int width, int prec)
+{
+	unsigned long long bits, m, f, ipart, fpart, hi, lo, A, B, rem, half, odd;
+	int e2, sh, neg, n=0, len, pad;
+	char digits[32];
+
+	if (!(fabs(value) < 4294967296.0) || prec < 0 || prec > 9)
+		return (snprintf(s, OUTPUT_MAXFIXED, "%*.*f", width, prec, value));
+
+	/* value = m * 2^e2 */
+	memcpy(&bits, &value, sizeof(double));
+	neg = (int) (bits >> 63);
+	e2  = (int) ((bits >> 52) & 0x7FF);
+	m   = bits & 0xFFFFFFFFFFFFFULL;
+	if (e2)
+	{
+		m  |= 1ULL << 52;
+		e2 -= 1075;
+	}
+	else
+		e2 = -1074;
+
+	/* integer part and fraction: f / 2^-e2 (-e2 >= 21 below 2^32) */
+	if (-e2 < 64)
+	{
+		ipart = m >> -e2;
+		f     = m & ((1ULL << -e2) - 1);
+	}
+	else
+	{
+		ipart = 0;
+		f     = m;
+	}
+
+	/* fraction * 10^prec = f * 5^prec / 2^sh (f * 5^prec < 2^74, 12 <= sh) */
+	sh = -e2 - prec;
+	A  = (f >> 32) * output_pow5[prec];
+	B  = (f & 0xFFFFFFFFULL) * output_pow5[prec];
+	hi = A >> 32;
+	lo = A << 32;
+	lo += B;
+	if (lo < B) hi++;
+
+	/* ties to even: the last digit is the last fraction digit or, with prec == 0, the last digit of the integer part */
+	odd = prec ? 0 : ipart & 1;
+
+	if (sh > 75)
+		fpart = 0;
+	else if (sh < 64)
+	{
+		fpart = (lo >> sh) | (hi << (64 - sh));
+		rem   = lo & ((1ULL << sh) - 1);
+		half  = 1ULL << (sh - 1);
+		if (rem > half || (rem == half && ((fpart + odd) & 1))) fpart++;
+	}
+	else if (sh == 64)
+	{
+		fpart = hi;
+		half  = 1ULL << 63;
+		if (lo > half || (lo == half && ((fpart + odd) & 1))) fpart++;
+	}
+	else
+	{
+		fpart = hi >> (sh - 64);
+		rem   = hi & ((1ULL << (sh - 64)) - 1);
+		half  = 1ULL << (sh - 65);
+		if (rem > half || (rem == half && (lo || ((fpart + odd) & 1)))) fpart++;
+	}
+
+	/* digits of the rounded value * 10^prec (at least prec+1 digits) */
+	ipart = ipart * output_pow10[prec] + fpart;
+	do
+	{
+		digits[n++] = (char) ('0' + ipart % 10);
+		ipart /= 10;
+	} while (ipart || n <= prec);
+
+	len = neg + n + (prec > 0);
+	pad = (width > len) ? width - len : 0;
+	memset(s, ' ', pad);
+	s += pad;
+	if (neg) *s++ = '-';
+	while (n > prec) *s++ = digits[--n];
+	if (prec > 0)
+	{
+		*s++ = '.';
+		while (n) *s++ = digits[--n];
+	}
+
+	return (pad + len);
+}
+
+
+/* header line: first field (width of the date fields) and the names of the variables */
+static int output_header(FILE* f, const char* first, int firstwidth, char** names, int nnames, int width)
+{
+	int i, pos;
+	size_t size;
+	char* line;
+
+	size = OUTPUT_LINEHEAD + strlen(first) + 2;
+	for (i = 0; i < nnames; i++) size += strlen(names[i]) + width;
+
+	if ((line = output_line(size)) == NULL) return (1);
+
+	pos = output_string(line, first, firstwidth);
+	for (i = 0; i < nnames; i++) pos += output_string(line + pos, names[i], width);
+	line[pos++] = '\n';
+
+	fwrite(line, 1, pos, f);
+
+	return (0);
+}
+
+
+/* values of a line (after the date fields) as by "%<width>.<prec>f ", then the line is written */
+static void output_values(FILE* f, char* line, int pos, const double* values, int nvalues, int width, int prec)
+{
+	int i;
+
+	for (i = 0; i < nvalues; i++)
+	{
+		pos += output_fixed(line + pos, values[i], width, prec);
+		line[pos++] = ' ';
+	}
+	line[pos++] = '\n';
+
+	fwrite(line, 1, pos, f);
+}
+
+
 int output_handling(int* mondays, int* enddays, control_struct* ctrl, double** output_map, double* dayarr, double* monavgarr, double* annavgarr, double* annarr, 
-					file dayout, file monavgout, file annavgout, file annout)
+					file dayout, file monavgout, file annavgout, file annout, obscomp_struct* OBS, aggreg_struct* AGG, file aggout)
 {
-	int i = 0;
 	int errorCode = 0;
 	int outv;
 	int yday, simyr;
 	int yearOUT, monthOUT, dayOUT, ydayOUT;
+	int pos;
+	char* line;
 
 	if(ctrl->spinup == 1)
  		simyr = ctrl->spinyears;
@@ -77,6 +283,22 @@ int output_handling(int* mondays, int* enddays, control_struct* ctrl, double** o
 	
 
 
+	/* COMPARISON WITH OBSERVATIONS (normal run only, independent of the output flags) */
+	if (!errorCode && OBS && OBS->nseries && obscomp_update(OBS, ctrl, output_map, mondays, enddays, yearOUT, monthOUT, dayOUT))
+	{
+		printf("\n");
+		printf("ERROR in call to obscomp_update() from output_handling()\n");
+		errorCode=1;
+	}
+
+	/* USER-DEFINED TEMPORAL AGGREGATION (normal run only, independent of the output flags) */
+	if (!errorCode && AGG && AGG->nspec && aggreg_update(AGG, aggout, output_map, (yday == 0 && simyr == 0), yearOUT, monthOUT, dayOUT))
+	{
+		printf("\n");
+		printf("ERROR in call to aggreg_update() from output_handling()\n");
+		errorCode=1;
+	}
+
 	/* DAILY OUTPUT HANDLING */
 	/* fill the daily output array if daily output is requested,or if the monthly or annual average 
 	   of daily output variables have been requested */
@@ -93,25 +315,33 @@ int output_handling(int* mondays, int* enddays, control_struct* ctrl, double** o
 	{
 		if (ctrl->dodaily == 2)
 		{
-			/* write ASCII the daily output array to daily output file */
+			/* write ASCII the daily output array to daily output file (formatted into the line buffer, one write per day) */
 			/* header */
-			if (yday == 0 && simyr == 0)
+			if (yday == 0 && simyr == 0 && output_header(dayout.ptr, " year month day yday", 19, ctrl->daynames, ctrl->ndayout, 50))
 			{
-				fprintf(dayout.ptr, "%19s", " year month day yday");
-				for (i=0; i< ctrl->ndayout; i++)
-				{
-					fprintf(dayout.ptr, "%50s", ctrl->daynames[i]);
-				}
-				fprintf(dayout.ptr, "\n");
+				printf("\n");
+				printf("ERROR allocating for output line in output_handling()\n");
+				errorCode=1;
 			}
 			/* values  */
-			fprintf(dayout.ptr, "%5i %4i %4i %4i ", yearOUT, monthOUT, dayOUT, ydayOUT);
-		
-			for (i=0; i< ctrl->ndayout; i++)
+			if (!errorCode && (line = output_line(OUTPUT_LINESIZE(ctrl->ndayout))) == NULL)
 			{
-				fprintf(dayout.ptr, "%14.9f ", dayarr[i]);
+				printf("\n");
+				printf("ERROR allocating for output line in output_handling()\n");
+				errorCode=1;
+			}
+			if (!errorCode)
+			{
+				pos = output_int(line, yearOUT, 5);
+				line[pos++] = ' ';
+				pos += output_int(line + pos, monthOUT, 4);
+				line[pos++] = ' ';
+				pos += output_int(line + pos, dayOUT, 4);
+				line[pos++] = ' ';
+				pos += output_int(line + pos, ydayOUT, 4);
+				line[pos++] = ' ';
+				output_values(dayout.ptr, line, pos, dayarr, ctrl->ndayout, 14, 9);
 			}
-			fprintf(dayout.ptr, "\n");
 		}
 		else
 		{	
@@ -128,11 +358,14 @@ int output_handling(int* mondays, int* enddays, control_struct* ctrl, double** o
 			else
 			/* printing on the screen */
 			{
-				for (i=0; i< ctrl->ndayout; i++)
+				if ((line = output_line(OUTPUT_LINESIZE(ctrl->ndayout))) == NULL)
 				{
-					printf("%14.9f ", dayarr[i]);
+					printf("\n");
+					printf("ERROR allocating for output line in output_handling()\n");
+					errorCode=1;
 				}
-				printf("\n");
+				else
+					output_values(stdout, line, 0, dayarr, ctrl->ndayout, 14, 9);
 			}
 			
 
@@ -151,14 +384,11 @@ int output_handling(int* mondays, int* enddays, control_struct* ctrl, double** o
 		}
 
 		/* header of monavg file (only in case of ASCII) */
-		if (yday == 0 && simyr == 0 && ctrl->domonavg == 2)
+		if (yday == 0 && simyr == 0 && ctrl->domonavg == 2 && output_header(monavgout.ptr, " year month", 10, ctrl->daynames, ctrl->ndayout, 30))
 		{
-			fprintf(monavgout.ptr, "%10s", " year month");
-			for (i=0; i< ctrl->ndayout; i++)
-			{
-				fprintf(monavgout.ptr, "%30s", ctrl->daynames[i]);
-			}
-			fprintf(monavgout.ptr, "\n");
+			printf("\n");
+			printf("ERROR allocating for output line in output_handling()\n");
+			errorCode=1;
 		}
 		
 		/* if this is the last day of the current month, output... */
@@ -174,13 +404,19 @@ int output_handling(int* mondays, int* enddays, control_struct* ctrl, double** o
 			{
 
 				/* write ASCII the monthly output array to monthly output file */
-				fprintf(monavgout.ptr, "%5i %4i", yearOUT, monthOUT);
-			
-				for (i=0; i< ctrl->ndayout; i++)
+				if ((line = output_line(OUTPUT_LINESIZE(ctrl->ndayout))) == NULL)
+				{
+					printf("\n");
+					printf("ERROR allocating for output line in output_handling()\n");
+					errorCode=1;
+				}
+				else
 				{
-					fprintf(monavgout.ptr, "%14.8f ", monavgarr[i]);
+					pos = output_int(line, yearOUT, 5);
+					line[pos++] = ' ';
+					pos += output_int(line + pos, monthOUT, 4);
+					output_values(monavgout.ptr, line, pos, monavgarr, ctrl->ndayout, 14, 8);
 				}
-				fprintf(monavgout.ptr, "\n");
 			}
 			else
 			{
@@ -197,11 +433,14 @@ int output_handling(int* mondays, int* enddays, control_struct* ctrl, double** o
 				else
 				/* printing on the screen */
 				{
-					for (i=0; i< ctrl->ndayout; i++)
+					if ((line = output_line(OUTPUT_LINESIZE(ctrl->ndayout))) == NULL)
 					{
-						printf("%14.8f ", monavgarr[i]);
+						printf("\n");
+						printf("ERROR allocating for output line in output_handling()\n");
+						errorCode=1;
 					}
-					printf("\n");
+					else
+						output_values(stdout, line, 0, monavgarr, ctrl->ndayout, 14, 8);
 				}
 			}
 			
@@ -221,16 +460,11 @@ int output_handling(int* mondays, int* enddays, control_struct* ctrl, double** o
 		}
 
 		/* header of annavg file (only in case of ASCII) */
-		if (yday == 0 && simyr == 0 && ctrl->doannavg == 2)
+		if (yday == 0 && simyr == 0 && ctrl->doannavg == 2 && output_header(annavgout.ptr, " year", 5, ctrl->daynames, ctrl->ndayout, 30))
 		{
-			fprintf(annavgout.ptr, "%5s", " year");
-			for (i=0; i< ctrl->ndayout; i++)
-			{
-				fprintf(annavgout.ptr, "%30s", ctrl->daynames[i]);
-			}
-			fprintf(annavgout.ptr, "\n");
-
-
+			printf("\n");
+			printf("ERROR allocating for output line in output_handling()\n");
+			errorCode=1;
 		}
 			
 		/* if this is the last day of the year, output... */
@@ -247,15 +481,17 @@ int output_handling(int* mondays, int* enddays, control_struct* ctrl, double** o
 			if (ctrl->doannavg == 2)
 			{
 				/* write ASCII the annual output array to annual output file */
-				fprintf(annavgout.ptr, "%5i", yearOUT);
-					
-				for (i=0; i< ctrl->ndayout; i++)
+				if ((line = output_line(OUTPUT_LINESIZE(ctrl->ndayout))) == NULL)
 				{
-					fprintf(annavgout.ptr, "%14.8f ", annavgarr[i]);
-
+					printf("\n");
+					printf("ERROR allocating for output line in output_handling()\n");
+					errorCode=1;
+				}
+				else
+				{
+					pos = output_int(line, yearOUT, 5);
+					output_values(annavgout.ptr, line, pos, annavgarr, ctrl->ndayout, 14, 8);
 				}
-				fprintf(annavgout.ptr, "\n");
-
 			}
 			else
 			{
@@ -272,11 +508,14 @@ int output_handling(int* mondays, int* enddays, control_struct* ctrl, double** o
 				else
 				/* printing on the screen */
 				{
-					for (i=0; i< ctrl->ndayout; i++)
+					if ((line = output_line(OUTPUT_LINESIZE(ctrl->ndayout))) == NULL)
 					{
-						printf("%14.8f ", annavgarr[i]);
+						printf("\n");
+						printf("ERROR allocating for output line in output_handling()\n");
+						errorCode=1;
 					}
-					printf("\n");
+					else
+						output_values(stdout, line, 0, annavgarr, ctrl->ndayout, 14, 8);
 				}
 			}
 
@@ -296,14 +535,11 @@ int output_handling(int* mondays, int* enddays, control_struct* ctrl, double** o
 	if (!errorCode && ctrl->doannual)
 	{
 		/* header of monavg file (only in case of ASCII) */
-		if (yday == 0 && simyr == 0 && ctrl->doannual == 2)
+		if (yday == 0 && simyr == 0 && ctrl->doannual == 2 && output_header(annout.ptr, " year", 5, ctrl->annnames, ctrl->nannout, 30))
 		{
-			fprintf(annout.ptr, "%5s", " year");
-			for (i=0; i< ctrl->nannout; i++)
-			{
-				fprintf(annout.ptr, "%30s", ctrl->annnames[i]);
-			}
-			fprintf(annout.ptr, "\n");
+			printf("\n");
+			printf("ERROR allocating for output line in output_handling()\n");
+			errorCode=1;
 		}
 
 		if (yday == nDAYS_OF_YEAR-1)
@@ -319,13 +555,17 @@ int output_handling(int* mondays, int* enddays, control_struct* ctrl, double** o
 			if (ctrl->doannual == 2)
 			{
 				/* write ASCII the annual output array to annual output file */
-				fprintf(annout.ptr, "%5i", yearOUT);
-				
-				for (i=0; i< ctrl->nannout; i++)
+				if ((line = output_line(OUTPUT_LINESIZE(ctrl->nannout))) == NULL)
 				{
-					fprintf(annout.ptr, "%12.6f ", annarr[i]);
+					printf("\n");
+					printf("ERROR allocating for output line in output_handling()\n");
+					errorCode=1;
+				}
+				else
+				{
+					pos = output_int(line, yearOUT, 5);
+					output_values(annout.ptr, line, pos, annarr, ctrl->nannout, 12, 6);
 				}
-				fprintf(annout.ptr, "\n");
 			}
 			else
 			{
@@ -342,11 +582,14 @@ int output_handling(int* mondays, int* enddays, control_struct* ctrl, double** o
 				else
 				/* printing on the screen */
 				{
-					for (i=0; i< ctrl->ndayout; i++)
+					if ((line = output_line(OUTPUT_LINESIZE(ctrl->ndayout))) == NULL)
 					{
-						printf("%12.6f ", annarr[i]);
+						printf("\n");
+						printf("ERROR allocating for output line in output_handling()\n");
+						errorCode=1;
 					}
-					printf("\n");
+					else
+						output_values(stdout, line, 0, annarr, ctrl->ndayout, 12, 6);
 				}
 			}
 		}
@@ -1,6 +1,8 @@
 /* 
 output_init.c
 Reads output control information from initialization file
+(output codes of soil layer variables: only the layers of the soil profile of the build can be written, see the
+N_SOILLAYERS note in output_map_init.c; other codes are rejected here)
 
 *-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
 Biome-BGCMuSo v7.0.
@@ -22,10 +24,11 @@ temperature to the formatted annual ascii output file.
 #include <math.h>
 #include "ini.h"
 #include "bgc_struct.h"
+#include "bgc_func.h"
 #include "pointbgc_struct.h"
 #include "pointbgc_func.h"
 
-int output_init(file init, int transient, harvesting_struct* HRV, output_struct* output)
+int output_init(file init, int transient, harvesting_struct* HRV, resim_struct* RSM, output_struct* output)
 {
 	int errorCode=0;
 	int i;
@@ -102,9 +105,18 @@ int output_init(file init, int transient, harvesting_struct* HRV, output_struct*
 		errorCode=216008;
 	}
 
+	/* incremental re-simulation: the outputs of the earlier run are renamed (instead of overwritten),
+	   their part before the first changed input is copied back by resim_prepare() */
+	if (RSM->flag)
+	{
+		strcpy(RSM->snap_file.name, output->outprefix);
+		strcat(RSM->snap_file.name, ".snapshot");
+	}
+
 	/* open outfiles if specified */
 	strcpy(output->econout_file.name,output->outprefix);
 	strcat(output->econout_file.name,".econout");
+	if (RSM->flag && HRV->HRV_num) resim_backup(output->econout_file.name);
 
 	if (HRV->HRV_num)
 	{
@@ -121,6 +133,7 @@ int output_init(file init, int transient, harvesting_struct* HRV, output_struct*
 	{
 		strcpy(output->dayout.name, output->outprefix);
 		strcat(output->dayout.name, ".dayout");
+		if (RSM->flag) resim_backup(output->dayout.name);
 
 		/* transient output */
 		strcpy(output->dayoutT.name,output->outprefix);
@@ -165,6 +178,7 @@ int output_init(file init, int transient, harvesting_struct* HRV, output_struct*
 	{
 		strcpy(output->monavgout.name, output->outprefix);
 		strcat(output->monavgout.name,".monavgout");
+		if (RSM->flag) resim_backup(output->monavgout.name);
 
 		/* transient output */
 		strcpy(output->monavgoutT.name,output->outprefix);
@@ -208,6 +222,7 @@ int output_init(file init, int transient, harvesting_struct* HRV, output_struct*
 	{
 		strcpy(output->annavgout.name, output->outprefix);
 		strcat(output->annavgout.name,".annavgout");
+		if (RSM->flag) resim_backup(output->annavgout.name);
 
 		/* transient output */
 		strcpy(output->annavgoutT.name,output->outprefix);
@@ -251,6 +266,7 @@ int output_init(file init, int transient, harvesting_struct* HRV, output_struct*
 	{
 		strcpy(output->annout.name, output->outprefix);
 		strcat(output->annout.name,".annout");
+		if (RSM->flag) resim_backup(output->annout.name);
 
 		/* transient output */
 		strcpy(output->annoutT.name,output->outprefix);
@@ -321,8 +337,8 @@ int output_init(file init, int transient, harvesting_struct* HRV, output_struct*
 	/* allocate space for the daily output variable indices */
 	if (!errorCode && output->ndayout > 0)
 	{
-		output->daycodes = (int*) malloc(output->ndayout * sizeof(int));
-		output->daynames = (char**) malloc(output->ndayout * sizeof(char*));
+		output->daycodes = (int*) arena_malloc(output->ndayout * sizeof(int));
+		output->daynames = (char**) arena_malloc(output->ndayout * sizeof(char*));
 		if 	(!output->daycodes || !output->daynames)
 		{
 			printf("ERROR allocating for daycodes/daynames array: output_init()\n");
@@ -339,7 +355,7 @@ int output_init(file init, int transient, harvesting_struct* HRV, output_struct*
 				printf("ERROR reading daily output index #%d: output_init()\n",i);
 				errorCode=21610;
 			}
-			output->daynames[i] = (char*) malloc(STRINGSIZE * sizeof(char));
+			output->daynames[i] = (char*) arena_malloc(STRINGSIZE * sizeof(char));
 			if (!errorCode && scan_array(init, output->daynames[i], 's', 1, 1))
 			{
 				printf("ERROR reading daily output names #%d: output_init()\n",i);
@@ -356,11 +372,20 @@ int output_init(file init, int transient, harvesting_struct* HRV, output_struct*
 				printf("ERROR reading daily output index #%d: output_init()\n",i);
 				errorCode=21610;
 			}
-			output->daynames[i] = (char*) malloc(STRINGSIZE * sizeof(char));
+			output->daynames[i] = (char*) arena_malloc(STRINGSIZE * sizeof(char));
 			sprintf(output->daynames[i], "%s%i", "var", output->daycodes[i]);
 
 		}
 	}
+
+	/* the codes of the daily outputs must have a variable (soil layer variables: N_SOILLAYERS, output_map_init.c) */
+	if (output->dodaily || output->domonavg || output->doannavg)
+	{
+		for (i=0 ; !errorCode && i<output->ndayout ; i++)
+		{
+			if (output_code_check(output->daycodes[i], "DAILY_OUTPUT block of the INI file")) errorCode=21610;
+		}
+	}
 	
 	
 	/********************************************************************
@@ -392,8 +417,8 @@ int output_init(file init, int transient, harvesting_struct* HRV, output_struct*
 	/* allocate space for the annual output variable indices */
 	if (!errorCode && output->nannout > 0)
 	{
-		output->anncodes = (int*) malloc(output->nannout * sizeof(int));
-		output->annnames = (char**) malloc(output->nannout * sizeof(char*));
+		output->anncodes = (int*) arena_malloc(output->nannout * sizeof(int));
+		output->annnames = (char**) arena_malloc(output->nannout * sizeof(char*));
 		if 	(!output->anncodes || !output->annnames)
 		{
 			printf("ERROR allocating for anncodes or annnames array: output_init()\n");
@@ -411,7 +436,7 @@ int output_init(file init, int transient, harvesting_struct* HRV, output_struct*
 				printf("ERROR reading annual output index #%d: output_init()\n",i);
 				errorCode=21611;
 			}
-			output->annnames[i] = (char*) malloc(STRINGSIZE * sizeof(char));
+			output->annnames[i] = (char*) arena_malloc(STRINGSIZE * sizeof(char));
 			if (!errorCode && scan_array(init, output->annnames[i], 's',1, 1))
 			{
 				printf("ERROR reading annual output name #%d: output_init()\n",i);
@@ -428,11 +453,20 @@ int output_init(file init, int transient, harvesting_struct* HRV, output_struct*
 				printf("ERROR reading annual output index #%d: output_init()\n",i);
 				errorCode=21611;
 			}
-			output->annnames[i] = (char*) malloc(STRINGSIZE * sizeof(char));
+			output->annnames[i] = (char*) arena_malloc(STRINGSIZE * sizeof(char));
 			sprintf(output->annnames[i], "%s%i", "var", output->anncodes[i]);
 		}
 	}
 
+	/* the codes of the annual outputs must have a variable */
+	if (output->doannual)
+	{
+		for (i=0 ; !errorCode && i<output->nannout ; i++)
+		{
+			if (output_code_check(output->anncodes[i], "ANNUAL_OUTPUT block of the INI file")) errorCode=21611;
+		}
+	}
+
 
 	if (errorCode)
 	{
@@ -0,0 +1,607 @@
+/*
+parareal.c
+parallel-in-time execution of the normal run (parareal iteration): the simulation period is divided into time slices,
+the state at the beginning of each slice is predicted by a cheap coarse propagator (the first year(s) of the slice are
+simulated with tipping hydrology, the change of the state is extrapolated to the end of the slice), the slices are simulated concurrently by the full model from the predicted states and the predictions are corrected
+until the states at the slice boundaries agree within the tolerance; the outputs of the last runs of the slices are
+joined into the output files. Without convergence the normal run is executed sequentially.
+
+correction of the state at the beginning of slice k in iteration j (water, carbon and nitrogen state variables):
+U(k, j+1) = G(U(k-1, j+1)) + F(U(k-1, j)) - G(U(k-1, j)), where F is the full model and G the coarse propagator;
+the other parts of the state (phenology, management counters, etc.) are taken from the full model
+
+the iterations can only be faster than the sequential run if G is much cheaper than F: with N slices, K iterations and
+cost ratio r = G/F of a slice the wall time is about K*F + (K+1)*N*G, the speedup is at most 1 / (K/N + (K+1)*r)
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_constants.h"
+#include "bgc_func.h"
+#include "bgc_io.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define MAX(X, Y) (((X) > (Y)) ? (X) : (Y))
+#define MIN(X, Y) (((X) < (Y)) ? (X) : (Y))
+
+#define PARAREAL_SMALL   1e-10						/* values below are not compared in the relative difference */
+#define PARAREAL_BUFSIZE 65536						/* (byte) buffer size of joining the output files */
+
+
+static double parareal_time(void)
+{
+#ifdef _OPENMP
+	return (omp_get_wtime());
+#else
+	return ((double) clock() / CLOCKS_PER_SEC);
+#endif
+}
+
+
+static void parareal_setctrl(resimstate_struct* state, const control_struct* ctrl)
+{
+	/* the output settings of the stored control structure belong to the run which stored the state */
+	state->ctrl.dodaily  = ctrl->dodaily;
+	state->ctrl.domonavg = ctrl->domonavg;
+	state->ctrl.doannavg = ctrl->doannavg;
+	state->ctrl.doannual = ctrl->doannual;
+}
+
+
+static double parareal_combine(double* U, const double* Gnew, const double* F, const double* Gold, const double* Uold, int n)
+{
+	/* correction of a state structure of double variables, returns the maximal relative change of the state;
+	   the pools which are non-negative in the full model and in the coarse propagator remain non-negative */
+	int i;
+	double value, scale, diff, maxdiff=0;
+
+	for (i = 0; i < n; i++)
+	{
+		value = Gnew[i] + F[i] - Gold[i];
+		if (value < 0 && Gnew[i] >= 0 && F[i] >= 0) value = 0;
+		U[i] = value;
+
+		scale = MAX(fabs(value), fabs(Uold[i]));
+		if (scale > PARAREAL_SMALL)
+		{
+			diff = fabs(value - Uold[i]) / scale;
+			if (diff > maxdiff) maxdiff = diff;
+		}
+	}
+
+	return (maxdiff);
+}
+
+
+static double parareal_compare(const double* U, const double* Uold, int n)
+{
+	int i;
+	double scale, diff, maxdiff=0;
+
+	for (i = 0; i < n; i++)
+	{
+		scale = MAX(fabs(U[i]), fabs(Uold[i]));
+		if (scale > PARAREAL_SMALL)
+		{
+			diff = fabs(U[i] - Uold[i]) / scale;
+			if (diff > maxdiff) maxdiff = diff;
+		}
+	}
+
+	return (maxdiff);
+}
+
+
+static void parareal_extrapolate(double* X, const double* X0, int n, double factor)
+{
+	/* extrapolation of the change of a state structure of double variables from the beginning of the slice (X0); the pools
+	   which are non-negative at both ends of the simulated part remain non-negative */
+	int i;
+	double value;
+
+	for (i = 0; i < n; i++)
+	{
+		value = X0[i] + (X[i] - X0[i]) * factor;
+		if (value < 0 && X0[i] >= 0 && X[i] >= 0) value = 0;
+		X[i] = value;
+	}
+}
+
+
+static int parareal_openfiles(const bgcin_struct* bgcin, const bgcout_struct* bgcout_main, bgcout_struct* bgcout)
+{
+	/* the outputs of a fine slice run are written into temporary files (the earlier run of the slice is dropped) */
+	int errorCode=0;
+
+	if (bgcout->log_file.ptr)     fclose(bgcout->log_file.ptr);
+	if (bgcout->econout_file.ptr) fclose(bgcout->econout_file.ptr);
+	if (bgcout->aggout.ptr)       fclose(bgcout->aggout.ptr);
+	if (bgcout->dayout.ptr)       fclose(bgcout->dayout.ptr);
+	if (bgcout->monavgout.ptr)    fclose(bgcout->monavgout.ptr);
+	if (bgcout->annavgout.ptr)    fclose(bgcout->annavgout.ptr);
+	if (bgcout->annout.ptr)       fclose(bgcout->annout.ptr);
+
+	*bgcout = *bgcout_main;
+	bgcout->log_file.ptr     = tmpfile();
+	bgcout->econout_file.ptr = bgcin->HRV.HRV_num   ? tmpfile() : NULL;
+	bgcout->aggout.ptr       = bgcin->AGG.nspec     ? tmpfile() : NULL;
+	bgcout->dayout.ptr       = bgcin->ctrl.dodaily  ? tmpfile() : NULL;
+	bgcout->monavgout.ptr    = bgcin->ctrl.domonavg ? tmpfile() : NULL;
+	bgcout->annavgout.ptr    = bgcin->ctrl.doannavg ? tmpfile() : NULL;
+	bgcout->annout.ptr       = bgcin->ctrl.doannual ? tmpfile() : NULL;
+
+	if (!bgcout->log_file.ptr || (bgcin->HRV.HRV_num && !bgcout->econout_file.ptr) || (bgcin->AGG.nspec && !bgcout->aggout.ptr) ||
+		(bgcin->ctrl.dodaily && !bgcout->dayout.ptr) || (bgcin->ctrl.domonavg && !bgcout->monavgout.ptr) ||
+		(bgcin->ctrl.doannavg && !bgcout->annavgout.ptr) || (bgcin->ctrl.doannual && !bgcout->annout.ptr))
+	{
+		printf("ERROR opening temporary files of slice run, parareal_openfiles()\n");
+		errorCode=1;
+	}
+
+	return (errorCode);
+}
+
+
+static void parareal_closefiles(bgcout_struct* bgcout)
+{
+	if (bgcout->log_file.ptr)     fclose(bgcout->log_file.ptr);
+	if (bgcout->econout_file.ptr) fclose(bgcout->econout_file.ptr);
+	if (bgcout->aggout.ptr)       fclose(bgcout->aggout.ptr);
+	if (bgcout->dayout.ptr)       fclose(bgcout->dayout.ptr);
+	if (bgcout->monavgout.ptr)    fclose(bgcout->monavgout.ptr);
+	if (bgcout->annavgout.ptr)    fclose(bgcout->annavgout.ptr);
+	if (bgcout->annout.ptr)       fclose(bgcout->annout.ptr);
+	memset(bgcout, 0, sizeof(bgcout_struct));
+}
+
+
+static int parareal_append(file* outfile, FILE* tmp)
+{
+	/* the content of a temporary file is appended to the output file */
+	int errorCode=0;
+	char* buffer;
+	size_t nread;
+
+	if (!outfile->ptr || !tmp) return (0);
+
+	buffer = (char*) malloc(PARAREAL_BUFSIZE);
+	if (!buffer)
+	{
+		printf("ERROR allocating for joining of output files, parareal_append()\n");
+		return (1);
+	}
+
+	fflush(tmp);
+	rewind(tmp);
+	while (!errorCode && (nread = fread(buffer, 1, PARAREAL_BUFSIZE, tmp)) > 0)
+	{
+		if (fwrite(buffer, 1, nread, outfile->ptr) != nread) errorCode=1;
+	}
+	if (ferror(tmp)) errorCode=1;
+
+	if (errorCode) printf("ERROR writing to %s, parareal_append()\n", outfile->name);
+
+	free(buffer);
+
+	return (errorCode);
+}
+
+
+static int parareal_branch(const bgcin_struct* bgcin_main, int first_simyr, int last_simyr, int coarse, resimstate_struct* state,
+	                       bgcout_struct* bgcout, double* objective, obscomp_struct* OBS_end, aggreg_struct* AGG_end)
+{
+	/* one slice run from the state at the end of first_simyr-1 (first_simyr=0: from the initial state) until the end of
+	   last_simyr, the end state is kept in the buffer; coarse=1: coarse propagator (tipping hydrology, no outputs, only
+	   the first coarse_years years are simulated and extrapolated to the end of the slice), coarse=0: full model with the
+	   outputs written into the temporary files of bgcout */
+	int errorCode=0;
+	int last_run, nyears, mgmdPLT;
+	bgcin_struct* bgcin;
+	bgcout_struct bgcout_coarse;
+	char* planttypeName;
+	arena_struct arena;
+	arena_struct* previous;
+	wstate_struct ws0;
+	cstate_struct cs0;
+	nstate_struct ns0;
+	resimstate_struct* init=NULL;
+
+	bgcin         = (bgcin_struct*) malloc(sizeof(bgcin_struct));
+	planttypeName = (char*) malloc(STRINGSIZE * sizeof(char));
+	if (!bgcin || !planttypeName)
+	{
+		printf("ERROR allocating for slice run, parareal_branch()\n");
+		free(bgcin);
+		free(planttypeName);
+		return (1);
+	}
+
+	*bgcin = *bgcin_main;
+	strcpy(planttypeName, bgcin_main->ctrl.planttypeName);
+	bgcin->ctrl.planttypeName = planttypeName;
+	bgcin->ctrl.onscreen      = 0;
+
+	/* coarse propagator: only the state is needed */
+	if (coarse)
+	{
+		bgcin->ctrl.dodaily       = 0;
+		bgcin->ctrl.domonavg      = 0;
+		bgcin->ctrl.doannavg      = 0;
+		bgcin->ctrl.doannual      = 0;
+		bgcin->ctrl.write_restart = 0;
+		bgcin->OBS.nseries        = 0;
+		bgcin->AGG.nspec          = 0;
+		bgcin->OPT.nobj           = 0;
+		bgcin->epc.SHCM_flag      = bgcin_main->PAR.coarse_SHCM;
+		state->epc.SHCM_flag      = bgcin_main->PAR.coarse_SHCM;
+
+		memset(&bgcout_coarse, 0, sizeof(bgcout_struct));
+		bgcout_coarse.log_file.ptr = tmpfile();
+		if (bgcin->HRV.HRV_num) bgcout_coarse.econout_file.ptr = tmpfile();
+		if (!bgcout_coarse.log_file.ptr || (bgcin->HRV.HRV_num && !bgcout_coarse.econout_file.ptr))
+		{
+			printf("ERROR opening temporary files of slice run, parareal_branch()\n");
+			errorCode=1;
+		}
+		bgcout = &bgcout_coarse;
+	}
+
+	/* the first slice starts from the initial state (not stored in the buffer): bgc() keeps it in init after the
+	   initialization of the run */
+	nyears   = last_simyr - first_simyr + 1;
+	last_run = last_simyr;
+	if (coarse && bgcin_main->PAR.coarse_years > 0 && bgcin_main->PAR.coarse_years < nyears)
+	{
+		last_run = first_simyr + bgcin_main->PAR.coarse_years - 1;
+		if (first_simyr)
+		{
+			ws0 = state->ws;
+			cs0 = state->cs;
+			ns0 = state->ns;
+		}
+		else
+		{
+			init = (resimstate_struct*) malloc(sizeof(resimstate_struct));
+			if (!init)
+			{
+				printf("ERROR allocating for initial state of slice run, parareal_branch()\n");
+				errorCode=1;
+			}
+		}
+	}
+
+	bgcin->RSM.flag          = 0;
+	bgcin->RSM.start_simyr   = first_simyr;
+	bgcin->RSM.stop_simyr    = last_run;
+	bgcin->RSM.state         = state;
+	bgcin->RSM.init_state    = init;
+	bgcin->RSM.pack_buffer   = 0;
+	bgcin->RSM.dayhash       = 0;
+	bgcin->RSM.daycheck      = 0;
+	bgcin->RSM.snap_file.ptr = 0;
+
+	bgcin->OPT.objective = 0;
+
+	if (first_simyr) parareal_setctrl(state, &bgcin->ctrl);
+
+	/* the arrays allocated during the run (e.g. the EPC arrays read again at planting) belong to the arena of the slice run */
+	if (!errorCode)
+	{
+		arena_init(&arena, ARENA_BLOCKSIZE);
+		previous  = arena_enter(&arena);
+		errorCode = bgc(bgcin, bgcout);
+		arena_enter(previous);
+		arena_release(&arena);
+	}
+
+	/* extrapolation to the end of the slice: the water, carbon and nitrogen state changes linearly, the other parts of the
+	   state are taken from the last simulated year (the counters of the years, the management events and the phenological
+	   years are moved to the end of the slice) */
+	if (!errorCode && last_run < last_simyr)
+	{
+		if (init)
+		{
+			ws0 = init->ws;
+			cs0 = init->cs;
+			ns0 = init->ns;
+		}
+		parareal_extrapolate((double*) &state->ws, (const double*) &ws0, sizeof(wstate_struct) / sizeof(double), (double) nyears / (last_run - first_simyr + 1));
+		parareal_extrapolate((double*) &state->cs, (const double*) &cs0, sizeof(cstate_struct) / sizeof(double), (double) nyears / (last_run - first_simyr + 1));
+		parareal_extrapolate((double*) &state->ns, (const double*) &ns0, sizeof(nstate_struct) / sizeof(double), (double) nyears / (last_run - first_simyr + 1));
+
+		mgmdPLT = state->mgmd[0];
+		resim_mgmdyear(state->mgmd, bgcin->ctrl.simstartyear + last_simyr + 1, &bgcin->PLT, &bgcin->THN, &bgcin->MOW, &bgcin->HRV, 
+		               &bgcin->PLG, &bgcin->FRZ, &bgcin->IRG, &bgcin->MUL, &bgcin->CWE, &bgcin->GWS);
+		if (bgcin->PLT.PLT_num)
+			state->ctrl.plantyr += state->mgmd[0] - mgmdPLT;
+		else
+			state->ctrl.plantyr += last_simyr - last_run;
+
+		state->simyr      = last_simyr;
+		state->ctrl.simyr = last_simyr;
+	}
+
+	/* the predicted state is continued by the full model */
+	if (coarse) state->epc.SHCM_flag = bgcin_main->epc.SHCM_flag;
+
+	if (!errorCode && objective) *objective = bgcin->OPT.objective;
+	if (!errorCode && OBS_end) *OBS_end = bgcin->OBS;
+	if (!errorCode && AGG_end) *AGG_end = bgcin->AGG;
+
+	if (coarse)
+	{
+		if (bgcout_coarse.log_file.ptr) fclose(bgcout_coarse.log_file.ptr);
+		if (bgcout_coarse.econout_file.ptr) fclose(bgcout_coarse.econout_file.ptr);
+	}
+	free(init);
+	free(planttypeName);
+	free(bgcin);
+
+	return (errorCode);
+}
+
+
+int parareal_run(bgcin_struct* bgcin, bgcout_struct* bgcout)
+{
+	/* the normal run is completed if the iteration converges (PAR->done=1), otherwise it has to be executed sequentially */
+	int errorCode=0;
+	int nslice, maxiter, nw, nj, k, nk;
+	int first[N_PARSLICE+1];
+	int sliceError[N_PARSLICE];
+	double objective[N_PARSLICE];
+	double t_start, t0, ts, tc, diff, maxdiff, time_seq, ratio, bound;
+	parareal_struct* PAR = &bgcin->PAR;
+	resimstate_struct *U, *Gold, *F, *Gnew, *T;
+	bgcout_struct* slice_out;
+	obscomp_struct OBS_end;
+	aggreg_struct AGG_end;
+
+	PAR->done            = 0;
+	PAR->converged       = 0;
+	PAR->niter           = 0;
+	PAR->ncoarse         = 0;
+	PAR->time_coarseruns = 0;
+
+	/* the incremental re-simulation writes snapshots during the sequential run */
+	nslice = MIN(PAR->nslice, bgcin->ctrl.simyears);
+	if (nslice < 2 || bgcin->RSM.flag)
+	{
+		fprintf(bgcout->log_file.ptr, "PARALLEL-IN-TIME EXECUTION\n");
+		fprintf(bgcout->log_file.ptr, "sequential run (%s)\n", bgcin->RSM.flag ? "incremental re-simulation" : "less than two slices");
+		fprintf(bgcout->log_file.ptr, " \n");
+		return (errorCode);
+	}
+
+	maxiter = (PAR->maxiter > 0 && PAR->maxiter < nslice) ? PAR->maxiter : nslice;
+
+	/* state buffers: U: beginning of the slices, F: end of the fine slice runs, Gold: coarse prediction of the beginning of
+	   the slices from the previous iteration, Gnew and T: coarse prediction and corrected state of the actual iteration */
+	nw        = 3 * nslice + 2;
+	U         = (resimstate_struct*) calloc(nw, sizeof(resimstate_struct));
+	slice_out = (bgcout_struct*) calloc(nslice, sizeof(bgcout_struct));
+	if (!U || !slice_out)
+	{
+		printf("ERROR allocating for state buffers, parareal_run()\n");
+		free(U);
+		free(slice_out);
+		return (1);
+	}
+	F    = U + nslice;
+	Gold = U + 2 * nslice;
+	Gnew = U + 3 * nslice;
+	T    = Gnew + 1;
+
+	for (k = 0; k <= nslice; k++) first[k] = (int) ((long) k * bgcin->ctrl.simyears / nslice);
+
+#ifdef _OPENMP
+	if (PAR->nthreads > 0) omp_set_num_threads(PAR->nthreads);
+#endif
+
+	t_start = parareal_time();
+
+	/* prediction: coarse propagation over the slices */
+	for (k = 1; !errorCode && k < nslice; k++)
+	{
+		if (k > 1) Gold[k] = U[k-1];
+		tc = parareal_time();
+		errorCode = parareal_branch(bgcin, first[k-1], first[k]-1, 1, &Gold[k], NULL, NULL, NULL, NULL);
+		PAR->time_coarseruns += parareal_time() - tc;
+		PAR->ncoarse         += 1;
+		if (!errorCode) U[k] = Gold[k];
+	}
+	PAR->time_predict = parareal_time() - t_start;
+	if (errorCode) printf("ERROR in coarse prediction of parallel-in-time execution, parareal_run()\n");
+
+	/* iterations: slice nj is exact in iteration nj, therefore at most nslice iterations are needed */
+	for (nj = 0; !errorCode && !PAR->converged && nj < maxiter; nj++)
+	{
+		if (bgcin->ctrl.onscreen) printf("PARALLEL-IN-TIME iteration %i/%i\n", nj+1, maxiter);
+
+		/* fine runs of the slices which are not exact yet */
+		t0 = parareal_time();
+		#pragma omp parallel for schedule(dynamic,1) private(ts)
+		for (k = nj; k < nslice; k++)
+		{
+			ts = parareal_time();
+			if (k) F[k] = U[k];
+			sliceError[k] = parareal_openfiles(bgcin, bgcout, &slice_out[k]);
+			if (!sliceError[k])
+				sliceError[k] = parareal_branch(bgcin, first[k], first[k+1]-1, 0, &F[k], &slice_out[k], &objective[k],
+				                                (k == nslice-1) ? &OBS_end : NULL, (k == nslice-1) ? &AGG_end : NULL);
+			PAR->time_slice[k] = parareal_time() - ts;
+		}
+		PAR->time_fine[nj] = parareal_time() - t0;
+		PAR->nfine[nj]     = nslice - nj;
+
+		for (k = nj; !errorCode && k < nslice; k++)
+		{
+			if (sliceError[k])
+			{
+				printf("ERROR in slice %i (years %i-%i) of parallel-in-time execution, parareal_run()\n",
+					   k+1, bgcin->ctrl.simstartyear+first[k], bgcin->ctrl.simstartyear+first[k+1]-1);
+				errorCode=1;
+			}
+		}
+
+		/* correction of the beginning of the next slices (sequential: each uses the corrected state of the previous one) */
+		t0 = parareal_time();
+		maxdiff = 0;
+		for (k = nj+1; !errorCode && k < nslice; k++)
+		{
+			if (k == nj+1)
+			{
+				/* the previous slice started from an exact state */
+				diff = parareal_compare((const double*) &F[k-1].ws, (const double*) &U[k].ws, sizeof(wstate_struct) / sizeof(double));
+				diff = MAX(diff, parareal_compare((const double*) &F[k-1].cs, (const double*) &U[k].cs, sizeof(cstate_struct) / sizeof(double)));
+				diff = MAX(diff, parareal_compare((const double*) &F[k-1].ns, (const double*) &U[k].ns, sizeof(nstate_struct) / sizeof(double)));
+				U[k] = F[k-1];
+			}
+			else
+			{
+				*Gnew = U[k-1];
+				tc = parareal_time();
+				errorCode = parareal_branch(bgcin, first[k-1], first[k]-1, 1, Gnew, NULL, NULL, NULL, NULL);
+				PAR->time_coarseruns += parareal_time() - tc;
+				PAR->ncoarse         += 1;
+				if (errorCode)
+				{
+					printf("ERROR in coarse propagation of slice %i, parareal_run()\n", k);
+					continue;
+				}
+				*T   = F[k-1];
+				diff = parareal_combine((double*) &T->ws, (const double*) &Gnew->ws, (const double*) &F[k-1].ws, (const double*) &Gold[k].ws,
+					                    (const double*) &U[k].ws, sizeof(wstate_struct) / sizeof(double));
+				diff = MAX(diff, parareal_combine((double*) &T->cs, (const double*) &Gnew->cs, (const double*) &F[k-1].cs, (const double*) &Gold[k].cs,
+					                    (const double*) &U[k].cs, sizeof(cstate_struct) / sizeof(double)));
+				diff = MAX(diff, parareal_combine((double*) &T->ns, (const double*) &Gnew->ns, (const double*) &F[k-1].ns, (const double*) &Gold[k].ns,
+					                    (const double*) &U[k].ns, sizeof(nstate_struct) / sizeof(double)));
+				Gold[k] = *Gnew;
+				U[k]    = *T;
+			}
+			if (diff > maxdiff) maxdiff = diff;
+		}
+		PAR->time_coarse[nj] = parareal_time() - t0;
+		PAR->maxdiff[nj]     = maxdiff;
+		PAR->niter           = nj+1;
+
+		if (!errorCode && maxdiff <= PAR->tolerance) PAR->converged = 1;
+	}
+
+	/* joining the outputs of the slices (the ASCII headers are written only in the first slice) */
+	if (!errorCode && PAR->converged)
+	{
+		for (k = 0; !errorCode && k < nslice; k++)
+		{
+			if (parareal_append(&bgcout->dayout,       slice_out[k].dayout.ptr)       ||
+				parareal_append(&bgcout->monavgout,    slice_out[k].monavgout.ptr)    ||
+				parareal_append(&bgcout->annavgout,    slice_out[k].annavgout.ptr)    ||
+				parareal_append(&bgcout->annout,       slice_out[k].annout.ptr)       ||
+				parareal_append(&bgcout->econout_file, slice_out[k].econout_file.ptr) ||
+				parareal_append(&bgcout->aggout,       slice_out[k].aggout.ptr))
+			{
+				errorCode=1;
+			}
+		}
+
+		/* log file of the last slice (information from the last simulation year), accumulators and restart data of the end */
+		if (!errorCode && parareal_append(&bgcout->log_file, slice_out[nslice-1].log_file.ptr)) errorCode=1;
+		if (!errorCode)
+		{
+			bgcin->OBS = OBS_end;
+			bgcin->AGG = AGG_end;
+			bgcout->restart_output = slice_out[nslice-1].restart_output;
+			for (k = 0; k < nslice; k++) bgcin->OPT.objective += objective[k];
+			PAR->done = 1;
+		}
+	}
+
+	for (k = 0; k < nslice; k++) parareal_closefiles(&slice_out[k]);
+	free(slice_out);
+	free(U);
+
+	PAR->time_wall = parareal_time() - t_start;
+
+	if (!errorCode)
+	{
+		time_seq = 0;
+		for (k = 0; k < nslice; k++) time_seq += PAR->time_slice[k];
+		nk = 0;
+		for (nj = 0; nj < PAR->niter; nj++) nk += PAR->nfine[nj];
+
+		fprintf(bgcout->log_file.ptr, "\n");
+		fprintf(bgcout->log_file.ptr, "PARALLEL-IN-TIME EXECUTION\n");
+		fprintf(bgcout->log_file.ptr, "number of slices:                 %12i\n", nslice);
+		fprintf(bgcout->log_file.ptr, "number of iterations:             %12i\n", PAR->niter);
+		fprintf(bgcout->log_file.ptr, "number of fine slice runs:        %12i\n", nk);
+		fprintf(bgcout->log_file.ptr, "converged [0 - no; 1 - yes]:      %12i\n", PAR->converged);
+		fprintf(bgcout->log_file.ptr, "wall time [s]:                    %12.3f\n", PAR->time_wall);
+		fprintf(bgcout->log_file.ptr, "sequential time of slices [s]:    %12.3f\n", time_seq);
+		fprintf(bgcout->log_file.ptr, "speedup:                          %12.3f\n", (PAR->time_wall > 0) ? time_seq / PAR->time_wall : 0.);
+
+		/* cost ratio of the coarse and fine runs of a slice and the bound of the speedup following from it */
+		ratio = (PAR->ncoarse && time_seq > 0) ? (PAR->time_coarseruns / PAR->ncoarse) / (time_seq / nslice) : 0.;
+		bound = 1. / ((double) PAR->niter / nslice + (PAR->niter + 1) * ratio);
+		fprintf(bgcout->log_file.ptr, "cost ratio of coarse/fine runs:   %12.3f\n", ratio);
+		fprintf(bgcout->log_file.ptr, "bound of the speedup:             %12.3f\n", bound);
+		if (bound <= 1)
+			fprintf(bgcout->log_file.ptr, "no speedup possible: the coarse propagator is too expensive for %i iterations (see COARSE_YEARS)\n", PAR->niter);
+		if (!PAR->converged) fprintf(bgcout->log_file.ptr, "no convergence: sequential run\n");
+		fprintf(bgcout->log_file.ptr, " \n");
+	}
+
+	return (errorCode);
+}
+
+
+int parareal_report(const parareal_struct* PAR)
+{
+	/* iterations of the parallel-in-time execution: fine slice runs, maximal relative change at the slice boundaries and times */
+	int errorCode=0;
+	int nj, k;
+	double time_seq;
+	file REP_file;
+
+	strcpy(REP_file.name, PAR->report_file);
+	if (file_open(&REP_file,'o',1))
+	{
+		printf("ERROR opening report file of parallel-in-time execution: %s\n", PAR->report_file);
+		return (1);
+	}
+
+	fprintf(REP_file.ptr, "%9s %9s %14s %14s %14s\n", "iteration", "fineruns", "maxdiff", "time_fine[s]", "time_coarse[s]");
+	for (nj = 0; nj < PAR->niter; nj++)
+		fprintf(REP_file.ptr, "%9i %9i %14.6e %14.3f %14.3f\n", nj+1, PAR->nfine[nj], PAR->maxdiff[nj], PAR->time_fine[nj], PAR->time_coarse[nj]);
+
+	time_seq = 0;
+	for (k = 0; k < PAR->nslice && k < N_PARSLICE; k++) time_seq += PAR->time_slice[k];
+
+	fprintf(REP_file.ptr, "time of the coarse prediction [s]: %12.3f\n", PAR->time_predict);
+	fprintf(REP_file.ptr, "wall time [s]:                     %12.3f\n", PAR->time_wall);
+	fprintf(REP_file.ptr, "sequential time of slices [s]:     %12.3f\n", time_seq);
+	fprintf(REP_file.ptr, "speedup:                           %12.3f\n", (PAR->time_wall > 0) ? time_seq / PAR->time_wall : 0.);
+	fprintf(REP_file.ptr, "converged [0 - no; 1 - yes]:       %12i\n", PAR->converged);
+	fprintf(REP_file.ptr, "simulated years of coarse runs:    %12i\n", PAR->coarse_years);
+	fprintf(REP_file.ptr, "number of coarse runs:             %12i\n", PAR->ncoarse);
+	fprintf(REP_file.ptr, "time of the coarse runs [s]:       %12.3f\n", PAR->time_coarseruns);
+
+	fclose(REP_file.ptr);
+
+	return (errorCode);
+}
+
@@ -0,0 +1,160 @@
+/*
+parareal_init.c
+read the settings of the parallel-in-time execution of the normal run (number of time slices, tolerance, iterations)
+if they are available
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_constants.h"
+#include "bgc_func.h"
+
+
+int parareal_init(parareal_struct* PAR, const control_struct* ctrl, const output_struct* output)
+{
+	int errorCode=0;
+	file PAR_file;
+	char keyword[STRINGSIZE];
+
+	/* default values: sequential run, tolerance 1e-6, at most as many iterations as slices, tipping without diffusion as
+	   coarse hydrology, one simulated year of the coarse propagator in a slice, report file: outprefix.parareal */
+	memset(PAR, 0, sizeof(parareal_struct));
+	PAR->tolerance    = 1e-6;
+	PAR->coarse_SHCM  = 2;
+	PAR->coarse_years = 1;
+	strcpy(PAR->report_file, output->outprefix);
+	strcat(PAR->report_file, ".parareal");
+
+	/********************************************************************
+	**                                                                 **
+	** Reading parallel-in-time settings (only in normal run)          **
+	**                                                                 **
+	********************************************************************/
+
+	if (ctrl->spinup != 0) return (errorCode);
+
+	strcpy(PAR_file.name, "parareal.txt");
+	if (file_open(&PAR_file,'j',1)) return (errorCode);
+
+	/* the file consists of keyword-blocks, the order of the blocks is arbitrary */
+	while (!errorCode && !scan_array(PAR_file, keyword, 's', 1, 0))
+	{
+		/* SLICES block: number of time slices of the simulation period */
+		if (!strcmp(keyword, "SLICES"))
+		{
+			if (!errorCode && scan_value(PAR_file, &PAR->nslice, 'i'))
+			{
+				printf("ERROR reading number of time slices: parareal_init()\n");
+				errorCode=22501;
+			}
+			if (!errorCode && (PAR->nslice < 0 || PAR->nslice > N_PARSLICE))
+			{
+				printf("ERROR in parareal.txt: number of time slices must be between 0 and %i\n", N_PARSLICE);
+				errorCode=22502;
+			}
+		}
+		/* TOLERANCE block: maximal relative difference of the water, carbon and nitrogen states at the slice boundaries */
+		else if (!strcmp(keyword, "TOLERANCE"))
+		{
+			if (!errorCode && scan_value(PAR_file, &PAR->tolerance, 'd'))
+			{
+				printf("ERROR reading tolerance: parareal_init()\n");
+				errorCode=22503;
+			}
+			if (!errorCode && PAR->tolerance < 0)
+			{
+				printf("ERROR in parareal.txt: tolerance must be non-negative\n");
+				errorCode=22504;
+			}
+		}
+		/* ITERATIONS block: maximal number of iterations (0: number of slices), without convergence the run is sequential */
+		else if (!strcmp(keyword, "ITERATIONS"))
+		{
+			if (!errorCode && scan_value(PAR_file, &PAR->maxiter, 'i'))
+			{
+				printf("ERROR reading maximal number of iterations: parareal_init()\n");
+				errorCode=22505;
+			}
+			if (!errorCode && PAR->maxiter < 0)
+			{
+				printf("ERROR in parareal.txt: maximal number of iterations must be non-negative\n");
+				errorCode=22505;
+			}
+		}
+		/* COARSE block: soil hydrology of the coarse propagator (0: tipping with diffusion, 2: tipping without diffusion) */
+		else if (!strcmp(keyword, "COARSE"))
+		{
+			if (!errorCode && scan_value(PAR_file, &PAR->coarse_SHCM, 'i'))
+			{
+				printf("ERROR reading hydrology of coarse propagator: parareal_init()\n");
+				errorCode=22506;
+			}
+			if (!errorCode && PAR->coarse_SHCM != 0 && PAR->coarse_SHCM != 2)
+			{
+				printf("ERROR in parareal.txt: hydrology of coarse propagator must be 0 or 2 (tipping)\n");
+				errorCode=22506;
+			}
+		}
+		/* COARSE_YEARS block: simulated years of the coarse propagator in a slice, the change of the state is extrapolated to the
+		   end of the slice (0: the whole slice is simulated, the coarse propagator is then as expensive as the fine runs) */
+		else if (!strcmp(keyword, "COARSE_YEARS"))
+		{
+			if (!errorCode && scan_value(PAR_file, &PAR->coarse_years, 'i'))
+			{
+				printf("ERROR reading simulated years of coarse propagator: parareal_init()\n");
+				errorCode=22509;
+			}
+			if (!errorCode && PAR->coarse_years < 0)
+			{
+				printf("ERROR in parareal.txt: simulated years of coarse propagator must be non-negative\n");
+				errorCode=22509;
+			}
+		}
+		/* THREADS block: number of parallel slice runs (0: all available processors) */
+		else if (!strcmp(keyword, "THREADS"))
+		{
+			if (!errorCode && scan_value(PAR_file, &PAR->nthreads, 'i'))
+			{
+				printf("ERROR reading number of threads: parareal_init()\n");
+				errorCode=22507;
+			}
+			if (!errorCode && PAR->nthreads < 0)
+			{
+				printf("ERROR in parareal.txt: number of threads must be non-negative\n");
+				errorCode=22507;
+			}
+		}
+		/* REPORT block: name of the file of the iterations */
+		else if (!strcmp(keyword, "REPORT"))
+		{
+			if (!errorCode && scan_value(PAR_file, PAR->report_file, 's'))
+			{
+				printf("ERROR reading name of report file: parareal_init()\n");
+				errorCode=22508;
+			}
+		}
+		else
+		{
+			printf("ERROR in parareal.txt: unknown keyword --> %s\n", keyword);
+			errorCode=225;
+		}
+	}
+
+	fclose(PAR_file.ptr);
+
+	return (errorCode);
+}
+
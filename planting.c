@@ -302,7 +302,7 @@ int planting(control_struct* ctrl, const siteconst_struct* sitec, const planting
 	
 		if (epv->rootDepth > CRIT_PREC)
 		{
-			for (layer=0; layer < N_SOILLAYERS; layer++)
+			for (layer=0; layer < sitec->n_soillayers; layer++)
 			{
 				cs->litr1c[layer]  += cf->STDBc_froot_to_PLT * epc->frootlitr_flab  * epv->rootlengthProp[layer];
 				cs->litr2c[layer]  += cf->STDBc_froot_to_PLT * epc->frootlitr_fucel * epv->rootlengthProp[layer];
@@ -317,7 +317,7 @@ int planting(control_struct* ctrl, const siteconst_struct* sitec, const planting
 		}
 		else
 		{
-			for (layer=0; layer < N_SOILLAYERS; layer++)
+			for (layer=0; layer < sitec->n_soillayers; layer++)
 			{
 				cs->litr1c[layer]  += cf->STDBc_froot_to_PLT * epc->frootlitr_flab  * epv->rootlengthLandD_prop[layer];
 				cs->litr2c[layer]  += cf->STDBc_froot_to_PLT * epc->frootlitr_fucel * epv->rootlengthLandD_prop[layer];
@@ -127,8 +127,6 @@ int planting_init(file init, control_struct* ctrl, planting_struct* PLT, epconst
 	
 		while (!errorCode && !(mgmread = scan_array (PLT_file, &p1, 'i', 0, 0)))
 		{
-			filename_array[nmgm] = (char*) malloc(STRINGSIZE * sizeof(char));
-
 			n_PLTparam = 9;
 
 			mgmread = fscanf(PLT_file.ptr, "%c%d%c%d%lf%lf%lf%lf%s%*[^\n]",&tempvar,&p2,&tempvar,&p3,&p4,&p5,&p6,&p7,(char*)&cropfile);
@@ -153,6 +151,7 @@ int planting_init(file init, control_struct* ctrl, planting_struct* PLT, epconst
 				n_seedlings_array[nmgm]     = p5;
 				weight_1000seed_array[nmgm] = p6;
 				seed_carbon_array[nmgm]     = p7;
+				filename_array[nmgm] = (char*) arena_malloc(STRINGSIZE * sizeof(char));
 				strcpy(filename_array[nmgm], cropfile);
 
 				nmgm += 1;
@@ -164,14 +163,14 @@ int planting_init(file init, control_struct* ctrl, planting_struct* PLT, epconst
 			
 
 		/* allocate space for the temporary MGM array */
-		PLT->PLTyear_array         = (int*) malloc(PLT->PLT_num*sizeof(int));  
-		PLT->PLTmonth_array        = (int*) malloc(PLT->PLT_num*sizeof(int)); 
-		PLT->PLTday_array          = (int*) malloc(PLT->PLT_num*sizeof(int)); 
-		PLT->germDepth_array      = (double*) malloc(PLT->PLT_num*sizeof(double)); 
-		PLT->n_seedlings_array     = (double*) malloc(PLT->PLT_num*sizeof(double)); 
-		PLT->weight_1000seed_array = (double*) malloc(PLT->PLT_num*sizeof(double)); 
-		PLT->seed_carbon_array     = (double*) malloc(PLT->PLT_num*sizeof(double)); 
-		PLT->filename_array        = (char**) malloc(PLT->PLT_num * sizeof(char*));
+		PLT->PLTyear_array         = (int*) arena_malloc(PLT->PLT_num*sizeof(int));  
+		PLT->PLTmonth_array        = (int*) arena_malloc(PLT->PLT_num*sizeof(int)); 
+		PLT->PLTday_array          = (int*) arena_malloc(PLT->PLT_num*sizeof(int)); 
+		PLT->germDepth_array      = (double*) arena_malloc(PLT->PLT_num*sizeof(double)); 
+		PLT->n_seedlings_array     = (double*) arena_malloc(PLT->PLT_num*sizeof(double)); 
+		PLT->weight_1000seed_array = (double*) arena_malloc(PLT->PLT_num*sizeof(double)); 
+		PLT->seed_carbon_array     = (double*) arena_malloc(PLT->PLT_num*sizeof(double)); 
+		PLT->filename_array        = (char**) arena_malloc(PLT->PLT_num * sizeof(char*));
 
 		for (nmgm = 0; nmgm < PLT->PLT_num; nmgm++)
 		{
@@ -184,8 +183,8 @@ int planting_init(file init, control_struct* ctrl, planting_struct* PLT, epconst
 			PLT->weight_1000seed_array[nmgm] = weight_1000seed_array[nmgm];
 			PLT->seed_carbon_array[nmgm]     = seed_carbon_array[nmgm];
 
-			PLT->filename_array[nmgm] = (char*) malloc(STRINGSIZE * sizeof(char));
-			strcpy(PLT->filename_array[nmgm], filename_array[nmgm]);
+			/* the names are allocated in the arena of the simulation: no copy needed */
+			PLT->filename_array[nmgm] = filename_array[nmgm];
 	
 		}
 
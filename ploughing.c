@@ -63,7 +63,7 @@ int ploughing(const control_struct* ctrl, const epconst_struct* epc, siteconst_s
 
 			if (PLGdepth > sitec->soillayer_depth[0])
 			{
-				while (PLGlayer== 0 && layer < N_SOILLAYERS)
+				while (PLGlayer== 0 && layer < sitec->n_soillayers)
 				{
 					if ((PLGdepth > sitec->soillayer_depth[layer-1]) && (PLGdepth <= sitec->soillayer_depth[layer])) layer += 1;
 					PLGlayer  = layer;
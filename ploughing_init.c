@@ -137,10 +137,10 @@ int ploughing_init(file init, const control_struct* ctrl, ploughing_struct* PLG)
 		nmgm = 0;
 
 		
-		PLG->PLGyear_array         = (int*) malloc(PLG->PLG_num*sizeof(double));  
-		PLG->PLGmonth_array        = (int*) malloc(PLG->PLG_num*sizeof(double)); 
-		PLG->PLGday_array          = (int*) malloc(PLG->PLG_num*sizeof(double)); 
-		PLG->PLGdepths_array       = (double*) malloc(PLG->PLG_num*sizeof(double)); 
+		PLG->PLGyear_array         = (int*) arena_malloc(PLG->PLG_num*sizeof(double));  
+		PLG->PLGmonth_array        = (int*) arena_malloc(PLG->PLG_num*sizeof(double)); 
+		PLG->PLGday_array          = (int*) arena_malloc(PLG->PLG_num*sizeof(double)); 
+		PLG->PLGdepths_array       = (double*) arena_malloc(PLG->PLG_num*sizeof(double)); 
 			
 		for (nmgm = 0; nmgm < PLG->PLG_num; nmgm++)
 		{
@@ -2,6 +2,12 @@
 pointbgc.c
 front-end to BIOME-BGC for single-point, single-biome simulations
 Uses BBGC MuSo v6 library function
+Fork mode (second command line argument: fork file): the shared part of the simulation is run once until the
+branch year, then the scenarios are continued from its complete end state in parallel (OpenMP), each with its own
+output files from the branch year
+Server mode (-server): simulation jobs are read from the standard input and run with warm input caches (server.c)
+Sensitivity mode (-sensitivity): global sensitivity analysis by in-process runs of the init files (sensitivity.c)
+Regional mode (-regional): sites of a manifest distributed over MPI processes or threads, one regional file (regional.c)
 
 *-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
 Biome-BGCMuSo v7.0.
@@ -27,10 +33,170 @@ See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentatio
 #include "bgc_io.h"           /* bgc() interface definition */
 #include "bgc_epclist.h"      /* array structure for epc-by-vegtype */
 #include "bgc_constants.h"      /* array structure for epc-by-vegtype */
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 int main(int argc, char *argv[])
 {
 	int errorCode=0;
+	int scen, nmember;
+
+	/* scenario fork control */
+	fork_struct fork;
+
+	/* system time variables */
+	char systime[100];
+	struct tm *tm_ptr;
+	time_t lt;
+	
+	/* get the system time at start of simulation  - WARNING: unsafe functions: localtime, asctime */
+	lt = time(NULL);
+	tm_ptr = localtime(&lt);
+	strcpy(systime,asctime(tm_ptr));
+
+	/* wrinting on screen: model version */
+	if(argc > 1)
+	{
+        if(!strcmp(argv[1],"-v"))
+		{
+           	printf("Model version: Biome-BGCMuSo7.0-b10\n");
+			exit(0);
+        }
+    }
+	
+
+	/* reader utility of the binary outputs: values of a variable from the sidecar index */
+	if (argc > 3 && argc < 7 && !strcmp(argv[1],"-extract"))
+		return (outindex_extract(argv[2], atoi(argv[3]), argc > 4 ? atoi(argv[4]) : -9999, argc > 5 ? atoi(argv[5]) : 9999));
+
+	/* input archives: the input files are read from the members of the archives (the main init file as well);
+	   compact met store: the derived met variables are calculated on demand instead of being stored;
+	   streamed met input: only a window of the given number of met years is stored */
+	while ((argc > 2 && (!strcmp(argv[1],"-archive") || !strcmp(argv[1],"-streammet"))) || (argc > 1 && !strcmp(argv[1],"-compactmet")))
+	{
+		if (!strcmp(argv[1],"-compactmet"))
+		{
+			metarr_compact_mode(1);
+			argc -= 1;
+			argv += 1;
+			continue;
+		}
+		if (!strcmp(argv[1],"-streammet"))
+		{
+			if (atoi(argv[2]) < 1)
+			{
+				printf("ERROR in command line: the window of the streamed met input must be at least 1 year... Exiting\n");
+				exit(102);
+			}
+			metarr_stream_mode(atoi(argv[2]));
+			argc -= 2;
+			argv += 2;
+			continue;
+		}
+		if (input_archive_open(argv[2], &nmember))
+		{
+			printf("ERROR in call to input_archive_open() from pointbgc.c... Exiting\n");
+			exit(104);
+		}
+		argc -= 2;
+		argv += 2;
+	}
+
+	/* sensitivity mode: the sample design of the parameters is evaluated by parallel runs, only the index tables are written */
+	if (argc == 3 && !strcmp(argv[1],"-sensitivity")) return (sensitivity_run(argv[2], systime));
+
+	/* regional mode: the sites of the manifest are run in parallel, only the regional file of the summary outputs is written */
+	if (argc == 3 && !strcmp(argv[1],"-regional")) return (regional_run(argv[2], systime));
+
+	/* server mode: the jobs are read from the standard input (optional: number of threads, number of cache entries) */
+	if (argc > 1 && argc < 5 && !strcmp(argv[1],"-server"))
+		return (server_run(systime, argc > 2 ? atoi(argv[2]) : 0, argc > 3 ? atoi(argv[3]) : 16));
+
+	/* read the name of the main init file (and the fork file) from the command line */
+	if (argc != 2 && argc != 3)
+	{
+		printf("ERROR in reading the main init file from command line. Exiting\n");
+		printf("Correct usage: <executable name>  <initialization file name> [<fork file name>]\n");
+		printf("               <executable name>  -server [<number of threads> [<number of cache entries>]]\n");
+		printf("               <executable name>  -sensitivity <sensitivity file>\n");
+		printf("               <executable name>  -regional <manifest file>  (with MPI: mpirun -np <n> <executable name> -regional ...)\n");
+		printf("               (options before: -archive <input archive file>, -compactmet, -streammet <window years>)\n");
+		printf("               <executable name>  -extract <index file> <output code> [<first year> [<last year>]]\n");
+		exit(102);
+	} 
+
+	/* single simulation */
+	if (argc == 2) return (pointbgc_run(argv[1], systime, NULL, -1, NULL));
+
+	/* fork mode: shared prefix run, then the scenario runs in parallel */
+	errorCode = fork_init(argv[2], &fork);
+	if (errorCode)
+	{
+		printf("ERROR in call to fork_init() from pointbgc.c... Exiting\n");
+		writeErrorCode(errorCode);
+		exit(errorCode);
+	}
+
+	errorCode = pointbgc_run(argv[1], systime, &fork, -1, NULL);
+
+#ifdef _OPENMP
+	if (fork.nthreads > 0) omp_set_num_threads(fork.nthreads);
+#endif
+
+	/* the runs are independent: each has its own input and output structures and files */
+	#pragma omp parallel for schedule(dynamic,1)
+	for (scen = 0; scen < fork.nscen; scen++)
+	{
+		if (!errorCode) fork.scen_error[scen] = pointbgc_run(fork.scen_ini[scen], systime, &fork, scen, NULL);
+	}
+
+	for (scen = 0; scen < fork.nscen; scen++)
+	{
+		if (!errorCode && fork.scen_error[scen])
+		{
+			printf("ERROR in scenario run: %s\n", fork.scen_ini[scen]);
+			errorCode = fork.scen_error[scen];
+		}
+		free(fork.scen_ini[scen]);
+	}
+	free(fork.scen_ini);
+	free(fork.scen_error);
+	free(fork.state);
+
+	return (errorCode);
+}
+
+
+
+static int pointbgc_sim(const char* ininame, const char* systime, fork_struct* fork, int scenario, srvjob_struct* job);
+
+
+int pointbgc_run(const char* ininame, const char* systime, fork_struct* fork, int scenario, srvjob_struct* job)
+{
+	/* the lifetime arrays of the simulation are allocated in its arena, which is released at once also after an error */
+	int errorCode=0;
+	arena_struct arena;
+	arena_struct* previous;
+
+	arena_init(&arena, ARENA_BLOCKSIZE);
+	previous = arena_enter(&arena);
+
+	errorCode = pointbgc_sim(ininame, systime, fork, scenario, job);
+
+	metarr_stream_release();
+	arena_enter(previous);
+	arena_release(&arena);
+
+	return (errorCode);
+}
+
+
+static int pointbgc_sim(const char* ininame, const char* systime, fork_struct* fork, int scenario, srvjob_struct* job)
+{
+	/* simulation defined by a main init file; in fork mode: prefix run (scenario < 0) or scenario run;
+	   in server mode: job of the server (met arrays from the cache of the server) */
+	int errorCode=0;
 	int transient=0;
 
 	/* bgc input and output structures */
@@ -45,23 +211,22 @@ int main(int argc, char *argv[])
 	
 	/* initialization file */
 	file init;
+
+	/* run of the sensitivity analysis in the calling thread (NULL: ordinary run) */
+	senssample_struct* sample = sensitivity_sample();
 	
-	/* system time variables */
-	struct tm *tm_ptr;
-	time_t lt;
-	
-	/* get the system time at start of simulation  - WARNING: unsafe functions: localtime, asctime */
-	lt = time(NULL);
-	tm_ptr = localtime(&lt);
-	strcpy(point.systime,asctime(tm_ptr));
+	strcpy(point.systime, systime);
 	
 	
+	/* zero the input structure: the spinup cache key is calculated from its contents */
+	memset(&bgcin, 0, sizeof(bgcin_struct));
+
 	/* initialize the bgcin state variable structures before filling with
 	values from ini file */
 	if (presim_state_init(&bgcin.ws, &bgcin.cs, &bgcin.ns, &bgcin.cinit))
 	{
 		printf("ERROR in call to presim_state_init() from pointbgc.c ... Exiting()\n");
-		exit(101);
+		return (101);
 	}
 
 	/* initialization */
@@ -99,39 +264,20 @@ int main(int argc, char *argv[])
 	**                           **
 	******************************/
 	
-	/* wrinting on screen: model version */
-	if(argc > 1)
-	{
-        if(!strcmp(argv[1],"-v"))
-		{
-           	printf("Model version: Biome-BGCMuSo7.0-b10\n");
-			exit(0);
-        }
-    }
-	
-
-	/* read the name of the main init file from the command line and store as init.name */
-	if (argc != 2)
-	{
-		printf("ERROR in reading the main init file from command line. Exiting\n");
-		printf("Correct usage: <executable name>  <initialization file name>\n");
-		exit(102);
-	} 
-	
-	strcpy(init.name, argv[1]);
+	strcpy(init.name, ininame);
 
 	/* open the main init file for ascii read and check for errors */
 	if (file_open(&init,'i',1))
 	{
 		printf("ERROR opening init file, pointbg.c ... Exiting\n");
-		exit(103);
+		return (103);
 	}
 
 	/* read the header string from the init file */
 	if (fgets(point.header, 100, init.ptr)==NULL)
 	{
 		printf("ERROR reading header string: pointbgc.c ... Exiting\n");
-		exit(201);
+		return (201);
 	}
 
 	/* open met file, discard header lines */
@@ -140,7 +286,7 @@ int main(int argc, char *argv[])
 	{
 		printf("ERROR in call to met_init() from pointbgc.c... Exiting\n");
 		writeErrorCode(errorCode);
-		exit(errorCode);
+		return (errorCode);
 	}
 
 	/* read restart control parameters */
@@ -149,7 +295,7 @@ int main(int argc, char *argv[])
 	{
 		printf("ERROR in call to restart_init() from pointbgc.c... Exiting\n");
 		writeErrorCode(errorCode);
-		exit(errorCode);
+		return (errorCode);
 	}
 
 	/* read simulation timing control parameters */
@@ -158,17 +304,16 @@ int main(int argc, char *argv[])
 	{
 		printf("ERROR in call to time_init() from pointbgc.c... Exiting\n");
 		writeErrorCode(errorCode);
-		exit(errorCode);
+		return (errorCode);
 	}
-	
-	
+
 	/* read CO2 control parameters */
 	errorCode = co2_init(init, &(bgcin.co2), &(bgcin.ctrl));
 	if (errorCode)
 	{
 		printf("ERROR in call to co2_init() from pointbgc.c... Exiting\n");
 		writeErrorCode(errorCode);
-		exit(errorCode);
+		return (errorCode);
 	}
 
 
@@ -178,7 +323,7 @@ int main(int argc, char *argv[])
 	{
 		printf("ERROR in call to ndep_init() from pointbgc.c... Exiting\n");
 		writeErrorCode(errorCode);
-		exit(errorCode);
+		return (errorCode);
 	}
 
 
@@ -188,16 +333,16 @@ int main(int argc, char *argv[])
 	{
 		printf("ERROR in call to sitec_init() from pointbgc.c... Exiting\n");
 		writeErrorCode(errorCode);
-		exit(errorCode);
+		return (errorCode);
 	}
 	
 	/* read soil properties */
-	errorCode = sprop_init(init, &bgcin.sprop, &bgcin.ctrl);
+	errorCode = sprop_init(init, &bgcin.sitec, &bgcin.sprop, &bgcin.ctrl);
 	if (errorCode)
 	{
 		printf("ERROR in call to sprop_init() from pointbgc.c... Exiting\n");
 		writeErrorCode(errorCode);
-		exit(errorCode);
+		return (errorCode);
 	}
 	
 	/* read ecophysiological constants */
@@ -206,7 +351,7 @@ int main(int argc, char *argv[])
 	{
 		printf("ERROR in call to epc_init() from pointbgc.c... Exiting\n");
 		writeErrorCode(errorCode);
-		exit(errorCode);
+		return (errorCode);
 	}
 
 	/* read management file with management information */
@@ -216,7 +361,7 @@ int main(int argc, char *argv[])
 	{
 		printf("ERROR in call to mgm_init() from pointbgc.c... Exiting\n");
 		writeErrorCode(errorCode);
-		exit(errorCode);
+		return (errorCode);
 	}
 
 	/* read simulation control flags */
@@ -225,7 +370,7 @@ int main(int argc, char *argv[])
 	{
 		printf("ERROR in call to simctrl_init() from pointbgc.c... Exiting\n");
 		writeErrorCode(errorCode);
-		exit(errorCode);
+		return (errorCode);
 	}
 
 	/* initialize water state structure */
@@ -234,7 +379,7 @@ int main(int argc, char *argv[])
 	{
 		printf("ERROR in call to wstate_init() from pointbgc.c... Exiting\n");
 		writeErrorCode(errorCode);
-		exit(errorCode);
+		return (errorCode);
 	}
 
 	/* initialize carbon and nitrogen state structures */
@@ -243,7 +388,7 @@ int main(int argc, char *argv[])
 	{
 		printf("ERROR in call to cstate_init() from pointbgc.c... Exiting\n");
 		writeErrorCode(errorCode);
-		exit(errorCode);
+		return (errorCode);
 	}
   
 	/* read scalar climate change parameters */
@@ -252,7 +397,7 @@ int main(int argc, char *argv[])
 	{
 		printf("ERROR in call to scc_init() from pointbgc.c... Exiting\n");
 		writeErrorCode(errorCode);
-		exit(errorCode);
+		return (errorCode);
 	}
 
 	/* read conditional management strategies parameters */
@@ -261,18 +406,30 @@ int main(int argc, char *argv[])
 	{
 		printf("ERROR in call to scc_init() from pointbgc.c... Exiting\n");
 		writeErrorCode(errorCode);
-		exit(errorCode);
+		return (errorCode);
+	}
+
+	/* read the settings of the incremental re-simulation if they are available (before the output files are opened) */
+	errorCode = resim_init(&bgcin.RSM, &bgcin.ctrl);
+	if (errorCode)
+	{
+		printf("ERROR in call to resim_init() from pointbgc.c... Exiting\n");
+		writeErrorCode(errorCode);
+		return (errorCode);
 	}
 
 	/* read the output control information */
 	if ((bgcin.co2.varco2 == 1 || bgcin.ndep.varndep == 1) && bgcin.ctrl.spinup == 1) transient = 1;
-	errorCode = output_init(init, transient, &bgcin.HRV, &output);
+	errorCode = output_init(init, transient, &bgcin.HRV, &bgcin.RSM, &output);
 	if (errorCode)
 	{
 		printf("ERROR in call to output_init() from pointbgc.c... Exiting\n");
 		writeErrorCode(errorCode);
-		exit(errorCode);
+		return (errorCode);
 	}
+
+	/* server mode: the output prefix of the job is reported to the client */
+	if (job) strcpy(job->outprefix, output.outprefix);
 	
 
 	
@@ -284,17 +441,17 @@ int main(int argc, char *argv[])
 	{
 		printf("ERROR in call to end_init() from pointbgc.c... exiting\n");
 		writeErrorCode(errorCode);
-		exit(errorCode);
+		return (errorCode);
 	}
 	fclose(init.ptr);
 
 	/* read meteorology file, build metarr arrays, compute running avgs */
-	errorCode = metarr_init(&point, &bgcin.metarr, &scc, &bgcin.sitec, &bgcin.ctrl);
+	errorCode = server_metarr_init(&point, &bgcin.metarr, &scc, &bgcin.sitec, &bgcin.ctrl, job);
 	if (errorCode)
 	{
 		printf("ERROR in call to metarr_init() from pointbgc.c... Exiting\n");
 		writeErrorCode(errorCode);
-		exit(errorCode);
+		return (errorCode);
 	}
 	fclose(point.metf.ptr);
 
@@ -304,7 +461,7 @@ int main(int argc, char *argv[])
 	{
 		printf("ERROR in call to groundwater_init() from pointbgc.c... Exiting\n");
 		writeErrorCode(errorCode);
-		exit(errorCode);
+		return (errorCode);
 	}
 
 	/* read flooding height if it is available */
@@ -313,7 +470,52 @@ int main(int argc, char *argv[])
 	{
 		printf("ERROR in call to flooding_init() from pointbgc.c... Exiting\n");
 		writeErrorCode(errorCode);
-		exit(errorCode);
+		return (errorCode);
+	}
+
+	/* read optional spinup settings (spinup cache) if they are available */
+	errorCode = spinupopt_init(&bgcin.SPO, &bgcin.ctrl);
+	if (errorCode)
+	{
+		printf("ERROR in call to spinupopt_init() from pointbgc.c... Exiting\n");
+		writeErrorCode(errorCode);
+		return (errorCode);
+	}
+
+	/* read observation series for the comparison with the model outputs if they are available */
+	errorCode = obscomp_init(&bgcin.OBS, &bgcin.ctrl, &output);
+	if (errorCode)
+	{
+		printf("ERROR in call to obscomp_init() from pointbgc.c... Exiting\n");
+		writeErrorCode(errorCode);
+		return (errorCode);
+	}
+
+	/* read the settings of the management strategy optimizer if they are available */
+	errorCode = optim_init(&bgcin.OPT, &bgcin.ctrl, &bgcin.FRZ, &bgcin.IRG, &bgcin.MOW, &output);
+	if (errorCode)
+	{
+		printf("ERROR in call to optim_init() from pointbgc.c... Exiting\n");
+		writeErrorCode(errorCode);
+		return (errorCode);
+	}
+
+	/* read the user-defined temporal aggregations of the outputs if they are available */
+	errorCode = aggreg_init(&bgcin.AGG, &bgcin.ctrl, &bgcin.RSM, &output);
+	if (errorCode)
+	{
+		printf("ERROR in call to aggreg_init() from pointbgc.c... Exiting\n");
+		writeErrorCode(errorCode);
+		return (errorCode);
+	}
+
+	/* read the settings of the parallel-in-time execution if they are available */
+	errorCode = parareal_init(&bgcin.PAR, &bgcin.ctrl, &output);
+	if (errorCode)
+	{
+		printf("ERROR in call to parareal_init() from pointbgc.c... Exiting\n");
+		writeErrorCode(errorCode);
+		return (errorCode);
 	}
 	
 
@@ -351,6 +553,7 @@ int main(int argc, char *argv[])
 
 	bgcout.log_file = output.log_file;
 	bgcout.econout_file = output.econout_file;
+	bgcout.aggout = output.aggout;
 	
 	
 	
@@ -360,6 +563,45 @@ int main(int argc, char *argv[])
 		fread(&(bgcin.restart_input),sizeof(restart_data_struct),1,restart.in_restart.ptr);
 	}
 
+	/* fork mode: the prefix run passes its complete end state to the scenario runs in memory (the slices of the
+	   parallel-in-time execution would start from the initial state) */
+	if (fork)
+	{
+		errorCode = fork_prepare(fork, scenario, &bgcin.ctrl, &bgcin.epc, &bgcin.RSM);
+		if (errorCode)
+		{
+			printf("ERROR in call to fork_prepare() from pointbgc.c... Exiting\n");
+			writeErrorCode(errorCode);
+			return (errorCode);
+		}
+		bgcin.PAR.nslice = 0;
+	}
+
+	/* sensitivity analysis: only the output variables of the analysis are evaluated (the output files are temporary),
+	   the spinup run passes its end state to the normal runs in memory */
+	if (sample)
+	{
+		bgcin.ctrl.onscreen = 0;
+		bgcin.ctrl.dodaily  = 0;
+		bgcin.ctrl.domonavg = 0;
+		bgcin.ctrl.doannavg = 0;
+		bgcin.ctrl.doannual = 0;
+		bgcin.RSM.flag      = 0;
+		bgcin.OBS.nseries   = 0;
+		bgcin.OPT.ndec      = 0;
+		bgcin.OPT.nobj      = 0;
+		bgcin.AGG.nspec     = 0;
+		bgcin.PAR.nslice    = 0;
+		bgcin.SEN           = sample;
+		if (bgcin.ctrl.spinup)
+			bgcin.ctrl.write_restart = 1;
+		else if (sample->snapshot)
+		{
+			bgcin.restart_input = *sample->snapshot;
+			bgcin.ctrl.read_restart = 1;
+		}
+	}
+
 	/*********************
 	**                  **
 	**  CALL BIOME-BGC  **
@@ -371,7 +613,17 @@ int main(int argc, char *argv[])
 	/* either call the spinup code or the normal simulation code */
 	if (bgcin.ctrl.spinup)
 	{
-		errorCode = spinup_bgc(&bgcin, &bgcout);
+		/* in case of a matching spinup cache entry the spinup phase is skipped */
+		if (bgcin.SPO.cache_flag || bgcin.SPO.warm_flag) errorCode = spinup_cache_resume(&bgcin, &bgcout);
+		
+		/* otherwise the spinup can start from the nearest stored equilibrium state */
+		if (!errorCode && !bgcin.SPO.cache_hit && bgcin.SPO.warm_flag) errorCode = spinup_cache_warmstart(&bgcin);
+		if (!errorCode && !bgcin.SPO.cache_hit) errorCode = spinup_bgc(&bgcin, &bgcout);
+
+		/* size of the arena and of the met store of the simulation */
+		arena_report(output.log_file);
+		metarr_report(&bgcin.metarr, bgcin.ctrl.simyears, output.log_file);
+
 	 	if (errorCode)
 		{
 			fprintf(output.log_file.ptr, "\n");
@@ -380,7 +632,7 @@ int main(int argc, char *argv[])
 			fprintf(output.log_file.ptr, "SIMULATION STATUS [0 - failure; 1 - success]\n");
 			fprintf(output.log_file.ptr, "0\n");
 			writeErrorCode(errorCode);
-			exit(errorCode);
+			return (errorCode);
 		}
 		else
 		{
@@ -392,7 +644,63 @@ int main(int argc, char *argv[])
 	}
 	else
 	{   
-		errorCode = bgc(&bgcin, &bgcout);
+		/* management strategy optimizer: the decisions are fixed by candidate runs before the normal run */
+		if (bgcin.OPT.ndec && optim_run(&bgcin, &bgcout))
+		{
+			printf("ERROR in call to optim_run() from pointbgc.c\n");
+			errorCode=415;
+		}
+
+		/* parallel-in-time execution: the slices of the run are simulated concurrently (sequential run without convergence) */
+		if (!errorCode && bgcin.PAR.nslice > 1 && parareal_run(&bgcin, &bgcout))
+		{
+			printf("ERROR in call to parareal_run() from pointbgc.c\n");
+			errorCode=419;
+		}
+
+		if (!errorCode && !bgcin.PAR.done) errorCode = bgc(&bgcin, &bgcout);
+
+		/* windows of the temporal aggregations open at the end of the simulation */
+		if (!errorCode && bgcin.AGG.nspec && aggreg_finish(&bgcin.AGG, output.aggout))
+		{
+			printf("ERROR in call to aggreg_finish() from pointbgc.c\n");
+			errorCode=417;
+		}
+
+		/* sidecar index of the binary output files */
+		if (!errorCode && ((output.dodaily == 1 && outindex_write(&output.dayout, 0, output.ndayout, output.daycodes, output.daynames, &bgcin.ctrl, fork ? bgcin.RSM.start_simyr : 0)) ||
+			               (output.domonavg == 1 && outindex_write(&output.monavgout, 1, output.ndayout, output.daycodes, output.daynames, &bgcin.ctrl, fork ? bgcin.RSM.start_simyr : 0)) ||
+			               (output.doannavg == 1 && outindex_write(&output.annavgout, 2, output.ndayout, output.daycodes, output.daynames, &bgcin.ctrl, fork ? bgcin.RSM.start_simyr : 0)) ||
+			               (output.doannual == 1 && outindex_write(&output.annout, 3, output.nannout, output.anncodes, output.annnames, &bgcin.ctrl, fork ? bgcin.RSM.start_simyr : 0))))
+		{
+			printf("ERROR in call to outindex_write() from pointbgc.c\n");
+			errorCode=418;
+		}
+
+		/* goodness-of-fit metrics of the comparison with observations */
+		if (!errorCode && bgcin.OBS.nseries && obscomp_summary(&bgcin.OBS))
+		{
+			printf("ERROR in call to obscomp_summary() from pointbgc.c\n");
+			errorCode=412;
+		}
+
+		/* objective of the candidates and of the optimized run */
+		if (!errorCode && bgcin.OPT.nobj && optim_report(&bgcin.OPT))
+		{
+			printf("ERROR in call to optim_report() from pointbgc.c\n");
+			errorCode=416;
+		}
+
+		/* iterations and speedup of the parallel-in-time execution */
+		if (!errorCode && bgcin.PAR.nslice > 1 && parareal_report(&bgcin.PAR))
+		{
+			printf("ERROR in call to parareal_report() from pointbgc.c\n");
+			errorCode=420;
+		}
+
+		arena_report(output.log_file);
+		metarr_report(&bgcin.metarr, bgcin.ctrl.simyears, output.log_file);
+
 		if (errorCode)
 		{
 			fprintf(output.log_file.ptr, "\n");
@@ -402,7 +710,7 @@ int main(int argc, char *argv[])
 			fprintf(output.log_file.ptr, "SIMULATION STATUS [0 - failure; 1 - success]\n");
 			fprintf(output.log_file.ptr, "0\n");
 			writeErrorCode(errorCode);
-			exit(errorCode);
+			return (errorCode);
 		}
 		else
 		{
@@ -413,6 +721,10 @@ int main(int argc, char *argv[])
 	}
 		
 
+	/* the state of the fork mode belongs to the fork control */
+	if (fork) bgcin.RSM.state = 0;
+	if (sample && bgcin.ctrl.spinup && sample->snapshot) *sample->snapshot = bgcout.restart_output;
+
 	/* if using an output restart file, write a record */
 	if (restart.write_restart)
 	{
@@ -422,179 +734,11 @@ int main(int argc, char *argv[])
 
 	/* post-processing output handling, if any, goes here */
 	
-	/* free memory */
-	free(bgcin.metarr.Tmax_array);
-	free(bgcin.metarr.Tmin_array);
-	free(bgcin.metarr.prcp_array);
-	free(bgcin.metarr.vpd_array);
-	free(bgcin.metarr.Tday_array);
-	free(bgcin.metarr.Tavg_array);
-	free(bgcin.metarr.TavgRA11_array);
-	free(bgcin.metarr.TavgRA30_array);
-	free(bgcin.metarr.TavgRA10_array);
-	free(bgcin.metarr.tempradF_array);
-	free(bgcin.metarr.tempradFra_array);
-	free(bgcin.metarr.swavgfd_array);
-	free(bgcin.metarr.par_array);
-	free(bgcin.metarr.dayl_array);
-	free(bgcin.metarr.annTavg_array);
-	free(bgcin.metarr.monTavg_array);
-    free(bgcin.metarr.annTrange_array);
-	free(bgcin.metarr.annTavgRA_array);
-    free(bgcin.metarr.annTrangeRA_array);
-
-	if(bgcin.PLT.PLT_num)
-	{
-		free(bgcin.PLT.PLTyear_array);  
-		free(bgcin.PLT.PLTmonth_array); 
-		free(bgcin.PLT.PLTday_array); 
-		free(bgcin.PLT.germDepth_array); 
-		free(bgcin.PLT.n_seedlings_array); 
-		free(bgcin.PLT.weight_1000seed_array); 
-		free(bgcin.PLT.seed_carbon_array); 
-		free(bgcin.PLT.filename_array);
-	}
-
-	if (bgcin.THN.THN_num)
-	{
-		free(bgcin.THN.THNyear_array);  
-		free(bgcin.THN.THNmonth_array); 
-		free(bgcin.THN.THNday_array); 
-		free(bgcin.THN.thinningRate_w_array); 
-		free(bgcin.THN.thinningRate_nw_array); 
-		free(bgcin.THN.transpCoeff_w_array); 
-		free(bgcin.THN.transpCoeff_nw_array); 
-	}
-
-	if (bgcin.MOW.MOW_num)
-	{
-		free(bgcin.MOW.MOWyear_array);  
-		free(bgcin.MOW.MOWmonth_array); 
-		free(bgcin.MOW.MOWday_array); 
-		free(bgcin.MOW.LAI_limit_array); 
-		free(bgcin.MOW.transportMOW_array); 
-	}
-
-	if (bgcin.GRZ.GRZ_num)
-	{
-		free(bgcin.GRZ.GRZstart_year_array);  
-		free(bgcin.GRZ.GRZstart_month_array); 
-		free(bgcin.GRZ.GRZstart_day_array); 
-		free(bgcin.GRZ.GRZend_year_array);  
-		free(bgcin.GRZ.GRZend_month_array); 
-		free(bgcin.GRZ.GRZend_day_array); 
-		free(bgcin.GRZ.trampling_effect); 
-		free(bgcin.GRZ.weight_LSU); 
-		free(bgcin.GRZ.stocking_rate_array); 
-		free(bgcin.GRZ.DMintake_array);
-		free(bgcin.GRZ.DMintake2excr_array); 
-		free(bgcin.GRZ.excr2litter_array); 
-		free(bgcin.GRZ.DM_Ccontent_array); 
-		free(bgcin.GRZ.EXCR_Ncontent_array);
-		free(bgcin.GRZ.EXCR_Ccontent_array); 
-		free(bgcin.GRZ.Nexrate); 
-		free(bgcin.GRZ.EFman_N2O); 
-		free(bgcin.GRZ.EFman_CH4);
-		free(bgcin.GRZ.EFfer_CH4);
-	}
-
-	if (bgcin.HRV.HRV_num)
-	{
-		free(bgcin.HRV.HRVyear_array);  
-		free(bgcin.HRV.HRVmonth_array); 
-		free(bgcin.HRV.HRVday_array); 
-		free(bgcin.HRV.snagprop_array); 
-		free(bgcin.HRV.transportHRV_array); 
-	}
-
-	if (bgcin.PLG.PLG_num)
-	{
-		free(bgcin.PLG.PLGyear_array);  
-		free(bgcin.PLG.PLGmonth_array); 
-		free(bgcin.PLG.PLGday_array); 
-		free(bgcin.PLG.PLGdepths_array); 
-	}
-
-	if (bgcin.FRZ.FRZ_num)
-	{
-		free(bgcin.FRZ.FRZyear_array);  
-		free(bgcin.FRZ.FRZmonth_array); 
-		free(bgcin.FRZ.FRZday_array); 
-		free(bgcin.FRZ.FRZdepth_array); 
-		free(bgcin.FRZ.fertilizer_array); 
-		free(bgcin.FRZ.DM_array); 
-		free(bgcin.FRZ.NO3content_array); 
-		free(bgcin.FRZ.NH4content_array); 
-		free(bgcin.FRZ.UREAcontent_array); 
-		free(bgcin.FRZ.orgNcontent_array);
-		free(bgcin.FRZ.orgCcontent_array); 
-		free(bgcin.FRZ.litr_flab_array); 
-		free(bgcin.FRZ.litr_fcel_array); 
-		free(bgcin.FRZ.EFfert_N2O);
-	}
-
-	if (bgcin.IRG.IRG_num)
-	{
-		free(bgcin.IRG.IRGyear_array);  
-		free(bgcin.IRG.IRGmonth_array); 
-		free(bgcin.IRG.IRGday_array); 
-		free(bgcin.IRG.IRGquantity_array);
-		free(bgcin.IRG.IRGheight_array); 
-	}
-	
-	if (bgcin.MUL.MUL_num)
-	{
-		free(bgcin.MUL.MULyear_array);  
-		free(bgcin.MUL.MULmonth_array); 
-		free(bgcin.MUL.MULday_array); 
-		free(bgcin.MUL.litrCabove_MUL);
-		free(bgcin.MUL.litrCNabove_MUL); 
-		free(bgcin.MUL.cwdCabove_MUL);
-		free(bgcin.MUL.cwdCNabove_MUL); 
-	}
-
-	if (bgcin.CWE.CWE_num)
-	{
-		free(bgcin.CWE.CWEyear_array);  
-		free(bgcin.CWE.CWEmonth_array); 
-		free(bgcin.CWE.CWEday_array); 
-		free(bgcin.CWE.removePROP_CWE);
-	}
-
-	if (bgcin.GWS.GWD_num)
-	{
-		free(bgcin.GWS.GWyear_array);	
-		free(bgcin.GWS.GWmonth_array);	
-		free(bgcin.GWS.GWday_array);	
-        free(bgcin.GWS.GWdepth_array);	
-	}
-
-	if (bgcin.FLD.FLD_num)
-	{
-		free(bgcin.FLD.FLDstart_year_array);	
-		free(bgcin.FLD.FLDstart_month_array);	
-		free(bgcin.FLD.FLDstart_day_array);	
-		free(bgcin.FLD.FLDend_year_array);	
-		free(bgcin.FLD.FLDend_month_array);	
-		free(bgcin.FLD.FLDend_day_array);
-        free(bgcin.FLD.FLDheight);	
-	}
-
-	if (bgcin.co2.varco2) free(bgcin.co2.co2ppm_array);
-	if (bgcin.co2.varco2) free(bgcin.co2.co2yrs_array);
-	if (bgcin.ndep.varndep) free(bgcin.ndep.Ndep_array);
-	if (bgcin.ndep.varndep) free(bgcin.ndep.Nyrs_array);
-
-	if (bgcin.ctrl.varSGS_flag) free(bgcin.epc.SGS_array);
-	if (bgcin.ctrl.varEGS_flag) free(bgcin.epc.EGS_array);
-	if (bgcin.ctrl.varWPM_flag) free(bgcin.epc.WPMyr_array);
-	if (bgcin.ctrl.varFM_flag) free(bgcin.epc.FMyr_array);
-	if (bgcin.ctrl.varMSC_flag) free(bgcin.epc.MSC_array);
-
-	if (output.ndayout != 0) free(output.daycodes);
-	if (output.ndayout != 0) free(output.daynames);
-	if (output.nannout != 0) free(output.anncodes);
-	if (output.nannout != 0) free(output.annnames);
+	/* free memory (the arrays of the initialization are released with the arena of the simulation) */
+	if (bgcin.RSM.dayhash)  free(bgcin.RSM.dayhash);
+	if (bgcin.RSM.daycheck) free(bgcin.RSM.daycheck);
+	if (bgcin.RSM.state)    free(bgcin.RSM.state);
+	if (bgcin.RSM.pack_buffer) free(bgcin.RSM.pack_buffer);
 	
 	/* close files */
 	if (restart.read_restart) fclose(restart.in_restart.ptr);
@@ -622,6 +766,8 @@ int main(int argc, char *argv[])
 
 	fclose(output.log_file.ptr);
 	if (bgcin.HRV.HRV_num) fclose(output.econout_file.ptr);
+	if (bgcin.RSM.snap_file.ptr) fclose(bgcin.RSM.snap_file.ptr);
+	if (output.aggout.ptr) fclose(output.aggout.ptr);
 
 	return (errorCode); 
 
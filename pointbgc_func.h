@@ -22,9 +22,10 @@ int time_init(file init, point_struct* point, control_struct *ctrl);
 int scc_init(file init, climchange_struct* scc);
 int co2_init(file init, co2control_struct* co2, control_struct *ctrl);
 int sitec_init(file init, siteconst_struct* sitec, control_struct *ctrl);
+int soillayer_init(siteconst_struct* sitec, int n_soillayers);
 int ndep_init(file init, NdepControl_struct* ndep, control_struct *ctrl);
 int epc_init(file init, epconst_struct* epc, control_struct* ctrl, int EPCfromINI);
-int sprop_init(file init, soilprop_struct* sprop, control_struct* ctrl);
+int sprop_init(file init, siteconst_struct* sitec, soilprop_struct* sprop, control_struct* ctrl);
 int mgm_init(file init, control_struct *ctrl, epconst_struct* epc, 
 	         fertilizing_struct* FRZ, grazing_struct* GRZ, harvesting_struct* HRV, mowing_struct* MOW, planting_struct* PLT, ploughing_struct* PLG, 
 			 thinning_struct* THN, irrigating_struct* IRG, mulching_struct* MUL, CWDextract_struct* CWE);
@@ -32,9 +33,12 @@ int simctrl_init(file init, epconst_struct* epc, control_struct* ctrl, planting_
 int wstate_init(file init, const siteconst_struct* sitec, const soilprop_struct* sprop, wstate_struct* ws);
 int cnstate_init(file init, const epconst_struct* epc, const soilprop_struct* sprop, const siteconst_struct* sitec, 
 	             cstate_struct* cs, cinit_struct* cinit, nstate_struct* ns);
-int output_init(file init, int transient, harvesting_struct* HRV, output_struct* output);
+int output_init(file init, int transient, harvesting_struct* HRV, resim_struct* RSM, output_struct* output);
 int end_init(file init);
 int metarr_init(point_struct* point, metarr_struct* metarr, const climchange_struct* scc, const siteconst_struct* sitec, const control_struct* ctrl);
+int metarr_compact_mode(int flag);
+int metarr_stream_mode(int nwindow);
+void metarr_stream_release(void);
 int presim_state_init(wstate_struct* ws, cstate_struct* cs, nstate_struct* ns,
 	cinit_struct* cinit);
 
@@ -42,7 +46,7 @@ int presim_state_init(wstate_struct* ws, cstate_struct* cs, nstate_struct* ns,
 int GSI_calculation(const metarr_struct* metarr, const siteconst_struct* sitec, epconst_struct* epc, 
 	                phenarray_struct* phenarr, control_struct* ctrl);
 
-int conduct_limit_factors(file logfile, const control_struct* ctrl, const soilprop_struct* sprop, const epconst_struct* epc, epvar_struct* epv);
+int conduct_limit_factors(file logfile, const control_struct* ctrl, const siteconst_struct* sitec, const soilprop_struct* sprop, const epconst_struct* epc, epvar_struct* epv);
 
 int prephenology(file logfile, const epconst_struct* epc, const metarr_struct* metarr, 
 	             planting_struct* PLT, harvesting_struct* HRV, control_struct* ctrl, phenarray_struct* phenarr);
@@ -50,7 +54,12 @@ int prephenology(file logfile, const epconst_struct* epc, const metarr_struct* m
 	int date_to_doy(int* mondays, int month, int day);
 
 int output_handling(int* mondays, int* enddays, control_struct* ctrl, double** output_map, double* dayarr, double* monavgarr, double* annavgarr, double* annarr, 
-					file dayout, file monavgout, file annavgout, file annout);
+					file dayout, file monavgout, file annavgout, file annout, obscomp_struct* OBS, aggreg_struct* AGG, file aggout);
+
+	int obscomp_update(obscomp_struct* OBS, const control_struct* ctrl, double** output_map, int* mondays, int* enddays,
+	                   int yearOUT, int monthOUT, int dayOUT);
+
+	int aggreg_update(aggreg_struct* AGG, file aggout, double** output_map, int header, int yearOUT, int monthOUT, int dayOUT);
 
 	int doy_to_date(int* enddays, int yday, int* month, int* day, int from1);
 
@@ -68,6 +77,32 @@ int conditionalMGM_init(file init, control_struct* ctrl, irrigating_struct* IRG,
 int read_mgmarray(int simyr, int varMGM, file MGM_file, double*** mgmarray);
 int groundwater_init(groundwater_struct* GWS, control_struct* ctrl);
 int flooding_init(flooding_struct* FLD, control_struct* ctrl);
+int spinupopt_init(spinupopt_struct* SPO, control_struct* ctrl);
+int obscomp_init(obscomp_struct* OBS, const control_struct* ctrl, const output_struct* output);
+	int obsseries_read(obsseries_struct* series, const control_struct* ctrl);
+int obscomp_summary(const obscomp_struct* OBS);
+int aggreg_init(aggreg_struct* AGG, const control_struct* ctrl, const resim_struct* RSM, output_struct* output);
+int aggreg_finish(aggreg_struct* AGG, file aggout);
+int outindex_write(file* data, int step, int nvar, const int* codes, char** names, const control_struct* ctrl, int first_simyr);
+int outindex_read(const char* idxname, outindex_struct* IDX);
+long outindex_offset(const outindex_struct* IDX, int year, long rec, int var);
+int outindex_column(const outindex_struct* IDX, int code, int first_year, int last_year, double** values, long* nvalues);
+void outindex_free(outindex_struct* IDX);
+int outindex_extract(const char* idxname, int code, int first_year, int last_year);
+int resim_init(resim_struct* RSM, const control_struct* ctrl);
+	int resim_backup(const char* filename);
+int optim_init(optim_struct* OPT, const control_struct* ctrl, const fertilizing_struct* FRZ, const irrigating_struct* IRG, 
+	           const mowing_struct* MOW, const output_struct* output);
+int parareal_init(parareal_struct* PAR, const control_struct* ctrl, const output_struct* output);
+void arena_init(arena_struct* arena, size_t blocksize);
+void* arena_alloc(arena_struct* arena, size_t size);
+void arena_release(arena_struct* arena);
+void arena_cache_free(void);
+arena_struct* arena_enter(arena_struct* arena);
+void* arena_malloc(size_t size);
+int arena_report(file logfile);
+int metarr_report(const metarr_struct* metarr, int nyears, file logfile);
+size_t arena_highwater(void);
 
 
 
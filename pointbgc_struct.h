@@ -64,7 +64,38 @@ typedef struct
     file annoutT;				/* transient annual output file */
 	file log_file;				/* main information about model run */
 	file econout_file;			/* economical information  */
+	file aggout;				/* user-defined temporal aggregations of the outputs */
 } output_struct;
 
+/* sidecar index of a binary output file (outindex.c) */
+typedef struct
+{
+	char data_file[FILENAMESIZE];	/* binary output file */
+	int step;					/* 0=daily, 1=monthly average, 2=annual average, 3=annual records */
+	int nvar;					/* number of variables in a record */
+	int nvar_read;				/* number of variables read from the index file */
+	int recsize;				/* size of a record in bytes */
+	int south_shift;			/* shift of the days in southern hemisphere (0: no shift) */
+	int* codes;					/* output codes of the variables */
+	char (*names)[STRINGSIZE];	/* names of the variables */
+	int nyears;					/* number of indexed years */
+	int* year_array;			/* indexed years */
+	long* first_array;			/* first record of the years */
+	long* nrec_array;			/* number of records of the years */
+} outindex_struct;
+
+/* arena of the lifetime allocations of a simulation (arena.c) */
+#define ARENA_BLOCKSIZE 65536		/* (byte) size of the blocks of the simulation arena */
+
+typedef struct
+{
+	struct arenablock* block;	/* actual block (the earlier blocks are chained) */
+	size_t blocksize;			/* (byte) size of the blocks (larger arrays get their own block) */
+	size_t used;				/* (byte) allocated from the arena */
+	size_t reserved;			/* (byte) size of the blocks */
+	long nalloc;				/* number of allocations */
+	int nblock;					/* number of blocks */
+} arena_struct;
+
 
 
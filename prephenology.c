@@ -284,7 +284,7 @@ int prephenology(file logfile, const epconst_struct* epc, const metarr_struct* m
 				mean_Tavg = 0.0;
 				for (i=0 ; i<ndays ; i++)
 				{
-					mean_Tavg += (metarr->Tmax_array[i] + metarr->Tmin_array[i])/2.;
+					mean_Tavg += (metarr_value(metarr, METARR_TMAX, i) + metarr_value(metarr, METARR_TMIN, i))/2.;
 				}
 				mean_Tavg /= (double)ndays;
 				/* tree onset equation from Mike White, Aug. 1997 */
@@ -301,7 +301,7 @@ int prephenology(file logfile, const epconst_struct* epc, const metarr_struct* m
 					for (pday=244 ; pday<305 ; pday++)
 					{
 				
-						phensoilt = metarr->TavgRA11_array[py*nDAYS_OF_YEAR+pday];
+						phensoilt = metarr_value(metarr, METARR_TAVGRA11, py*nDAYS_OF_YEAR+pday);
 						
 						fall_Tavg += phensoilt;
 						fall_Tavg_count++;
@@ -318,8 +318,8 @@ int prephenology(file logfile, const epconst_struct* epc, const metarr_struct* m
 					for (pday=0 ; pday<nDAYS_OF_YEAR ; pday++)
 					{
 					
-						phensoilt = metarr->TavgRA11_array[py*nDAYS_OF_YEAR+pday];
-						phendayl = metarr->dayl_array[py*nDAYS_OF_YEAR+pday];
+						phensoilt = metarr_value(metarr, METARR_TAVGRA11, py*nDAYS_OF_YEAR+pday);
+						phendayl = metarr_value(metarr, METARR_DAYL, py*nDAYS_OF_YEAR+pday);
 						
 						/* tree onset test */
 						if (onset_day == -1)
@@ -401,8 +401,8 @@ int prephenology(file logfile, const epconst_struct* epc, const metarr_struct* m
 				ann_prcp = 0.0;
 				for (i=0 ; i<ndays ; i++)
 				{
-					mean_Tavg += metarr->Tday_array[i];
-					ann_prcp += metarr->prcp_array[i];
+					mean_Tavg += metarr_value(metarr, METARR_TDAY, i);
+					ann_prcp += metarr_value(metarr, METARR_PRCP, i);
 				}
 				mean_Tavg /= (double)ndays;
 				ann_prcp /= (double)ndays / nDAYS_OF_YEAR;
@@ -426,8 +426,8 @@ int prephenology(file logfile, const epconst_struct* epc, const metarr_struct* m
 					new_Tmax = -1000.0;
 					for (pday=0 ; pday<nDAYS_OF_YEAR ; pday++)
 					{
-						Tmax = metarr->Tmax_array[py*nDAYS_OF_YEAR+pday];
-						Tmin_annavg += metarr->Tmin_array[py*nDAYS_OF_YEAR+pday];
+						Tmax = metarr_value(metarr, METARR_TMAX, py*nDAYS_OF_YEAR+pday);
+						Tmin_annavg += metarr_value(metarr, METARR_TMIN, py*nDAYS_OF_YEAR+pday);
 						
 						if (Tmax > new_Tmax) new_Tmax = Tmax;
 						
@@ -449,11 +449,11 @@ int prephenology(file logfile, const epconst_struct* epc, const metarr_struct* m
 					for (pday=0 ; pday<nDAYS_OF_YEAR ; pday++)
 					{
 					
-						phensoilt = metarr->TavgRA11_array[py*nDAYS_OF_YEAR+pday];
-						phenprcp = metarr->prcp_array[py*nDAYS_OF_YEAR+pday];
+						phensoilt = metarr_value(metarr, METARR_TAVGRA11, py*nDAYS_OF_YEAR+pday);
+						phenprcp = metarr_value(metarr, METARR_PRCP, py*nDAYS_OF_YEAR+pday);
 						grass_prcpyear[pday] = phenprcp;
-						grass_Tminyear[pday] = metarr->Tmin_array[py*nDAYS_OF_YEAR+pday];
-						grass_Tmaxyear[pday] = metarr->Tmax_array[py*nDAYS_OF_YEAR+pday];
+						grass_Tminyear[pday] = metarr_value(metarr, METARR_TMIN, py*nDAYS_OF_YEAR+pday);
+						grass_Tmaxyear[pday] = metarr_value(metarr, METARR_TMAX, py*nDAYS_OF_YEAR+pday);
 						
 						/* grass onset test */
 						if (onset_day == -1)
@@ -64,6 +64,7 @@ int presim_state_init(wstate_struct* ws, cstate_struct* cs, nstate_struct* ns, c
 	ws->FRZsrc_W = 0;
 	ws->GW_waterlogging = 0.0;
 	ws->WbalanceERR = 0;
+	ws->Wbalance_old = 0;
 	ws->inW = 0;
 	ws->outW = 0;
 	ws->storeW = 0;
@@ -164,6 +165,7 @@ int presim_state_init(wstate_struct* ws, cstate_struct* cs, nstate_struct* ns, c
 	cs->frootC_HRV = 0.0;
 	cs->vegC_HRV = 0.0;
 	cs->CbalanceERR = 0;
+	cs->Cbalance_old = 0;
 	cs->CNratioERR = 0.0;
 	cs->inC = 0;
 	cs->outC = 0;
@@ -238,6 +240,7 @@ int presim_state_init(wstate_struct* ws, cstate_struct* cs, nstate_struct* ns, c
 	ns->GRZsrc_N = 0;
 	ns->SPINUPsrc = 0;
 	ns->NbalanceERR = 0;
+	ns->Nbalance_old = 0;
 	ns->inN = 0;
 	ns->outN = 0;
 	ns->storeN = 0;
@@ -0,0 +1,326 @@
+/*
+regional.c
+regional run: the sites of a manifest (spinup and normal run of each site with string substitutions of the input files)
+are distributed over the MPI processes (compiled with MUSO_MPI and started by mpirun) or, without MPI, over the threads
+of the process. The sites are given out one by one to the first free run, so that the slow (e.g. woody) spinups do not
+hold up the others. The runs have no output files: the summary output variables of the sites are gathered into one
+regional file in the order of the manifest.
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_constants.h"
+#include "bgc_io.h"
+#ifdef MUSO_MPI
+#include <mpi.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* messages between the master (rank 0) and the workers */
+#define REGIONAL_TAG_RESULT 1		/* worker -> master: site, error code, run time and summary outputs (site -1: first request) */
+#define REGIONAL_TAG_SITE   2		/* master -> worker: next site (-1: no more sites) */
+
+
+static double regional_time(void)
+{
+#if defined(MUSO_MPI)
+	return (MPI_Wtime());
+#elif defined(_OPENMP)
+	return (omp_get_wtime());
+#else
+	return ((double) clock() / CLOCKS_PER_SEC);
+#endif
+}
+
+
+static int regional_site(const regional_struct* REG, int ns, const char* systime, double* result)
+{
+	/* spinup and normal run of site ns in the calling thread: the spinup passes its end state to the normal run in memory,
+	   the normal run accumulates the summary outputs; result: error code, run time, summary outputs (DATA_GAP if failed) */
+	int errorCode=0;
+	int no;
+	double t_start;
+	regsite_struct site;
+	senssample_struct sample;
+	restart_data_struct* snapshot = NULL;
+
+	t_start = regional_time();
+
+	if (regional_parse(REG->site[ns], &site))
+	{
+		printf("ERROR in call to regional_parse() from regional.c\n");
+		errorCode=1;
+	}
+
+	if (!errorCode && site.spinup_ini[0])
+	{
+		snapshot = (restart_data_struct*) malloc(sizeof(restart_data_struct));
+		if (!snapshot)
+		{
+			printf("ERROR allocating for spun-up state of site %s, regional_site()\n", site.id);
+			errorCode=1;
+		}
+	}
+
+	memset(&sample, 0, sizeof(senssample_struct));
+
+	if (!errorCode)
+	{
+		file_substitution(site.nsubst, site.subst_from, site.subst_to);
+		file_discard(1);
+
+		if (site.spinup_ini[0])
+		{
+			sample.snapshot = snapshot;
+			sensitivity_select(&sample);
+			errorCode = pointbgc_run(site.spinup_ini, systime, NULL, -1, NULL);
+		}
+
+		if (!errorCode)
+		{
+			memset(&sample, 0, sizeof(senssample_struct));
+			sample.nout     = REG->nout;
+			sample.outcode  = REG->outcode;
+			sample.outmode  = REG->outmode;
+			sample.snapshot = snapshot;
+			sensitivity_select(&sample);
+			errorCode = pointbgc_run(site.normal_ini, systime, NULL, -1, NULL);
+		}
+
+		sensitivity_select(NULL);
+		file_discard(0);
+		file_substitution(0, NULL, NULL);
+	}
+
+	free(snapshot);
+
+	result[0] = (double) errorCode;
+	result[1] = regional_time() - t_start;
+	for (no = 0; no < REG->nout; no++) result[2+no] = errorCode ? DATA_GAP : sample.objective[no];
+
+	return (errorCode);
+}
+
+
+#ifdef MUSO_MPI
+static int regional_master(regional_struct* REG, int nrank)
+{
+	/* the master answers the requests of the workers in the order of their arrival: the result of the last site of the
+	   worker is stored, the worker gets the next site of the manifest */
+	int ns, nnext=0, nactive=nrank-1;
+	int nwidth = REG->nout + 2;
+	double message[N_SENSOUT+3];
+	MPI_Status status;
+
+	while (nactive > 0)
+	{
+		MPI_Recv(message, nwidth+1, MPI_DOUBLE, MPI_ANY_SOURCE, REGIONAL_TAG_RESULT, MPI_COMM_WORLD, &status);
+
+		ns = (int) message[0];
+		if (ns >= 0) memcpy(REG->result + (size_t) ns * nwidth, message + 1, nwidth * sizeof(double));
+
+		if (nnext < REG->nsite)
+			ns = nnext++;
+		else
+		{
+			ns = -1;
+			nactive--;
+		}
+		MPI_Send(&ns, 1, MPI_INT, status.MPI_SOURCE, REGIONAL_TAG_SITE, MPI_COMM_WORLD);
+	}
+
+	return (0);
+}
+
+
+static int regional_worker(const regional_struct* REG, const char* systime)
+{
+	/* the worker runs one site at a time; the result of the site is sent together with the request of the next one */
+	int ns;
+	double message[N_SENSOUT+3];
+
+	/* the first message only requests a site: it is cleared to send no uninitialized values */
+	memset(message, 0, sizeof(message));
+	message[0] = -1;
+	while (1)
+	{
+		MPI_Send(message, REG->nout+3, MPI_DOUBLE, 0, REGIONAL_TAG_RESULT, MPI_COMM_WORLD);
+		MPI_Recv(&ns, 1, MPI_INT, 0, REGIONAL_TAG_SITE, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+		if (ns < 0) break;
+
+		message[0] = (double) ns;
+		regional_site(REG, ns, systime, message + 1);
+	}
+
+	return (0);
+}
+#endif
+
+
+static int regional_report(const regional_struct* REG, int nrun, int nfailed)
+{
+	/* one line per site in the order of the manifest: error code, run time and summary outputs */
+	int errorCode=0;
+	int ns, no;
+	int nwidth = REG->nout + 2;
+	char name[STRINGSIZE];
+	const double* row;
+	regsite_struct site;
+	file REP_file;
+
+	strcpy(REP_file.name, REG->report_file);
+	if (file_open(&REP_file,'o',1))
+	{
+		printf("ERROR opening regional file: %s\n", REG->report_file);
+		return (1);
+	}
+
+	fprintf(REP_file.ptr, "REGIONAL RUN\n");
+	fprintf(REP_file.ptr, "number of sites:                  %12i\n", REG->nsite);
+	fprintf(REP_file.ptr, "number of failed sites:           %12i\n", nfailed);
+	fprintf(REP_file.ptr, "number of parallel runs:          %12i\n", nrun);
+	fprintf(REP_file.ptr, " \n");
+
+	fprintf(REP_file.ptr, "%-24s %10s %12s", "site", "error_code", "run_time");
+	for (no = 0; no < REG->nout; no++)
+	{
+		sprintf(name, "%i/%i", REG->outcode[no], REG->outmode[no]);
+		fprintf(REP_file.ptr, " %14s", name);
+	}
+	fprintf(REP_file.ptr, "\n");
+
+	for (ns = 0; ns < REG->nsite; ns++)
+	{
+		row = REG->result + (size_t) ns * nwidth;
+		/* a site line that cannot be parsed gets a DATA_GAP row under its number: the other sites are still reported */
+		if (regional_parse(REG->site[ns], &site))
+		{
+			printf("WARNING: site line %i of the manifest cannot be parsed, DATA_GAP row in the regional file\n", ns+1);
+			if (!site.id[0]) sprintf(site.id, "site_%i", ns+1);
+			fprintf(REP_file.ptr, "%-24s %10i %12.3f", site.id, row[0] ? (int) row[0] : 1, row[1]);
+			for (no = 0; no < REG->nout; no++) fprintf(REP_file.ptr, " %14.6e", (double) DATA_GAP);
+		}
+		else
+		{
+			fprintf(REP_file.ptr, "%-24s %10i %12.3f", site.id, (int) row[0], row[1]);
+			for (no = 0; no < REG->nout; no++) fprintf(REP_file.ptr, " %14.6e", row[2+no]);
+		}
+		fprintf(REP_file.ptr, "\n");
+	}
+
+	if (ferror(REP_file.ptr)) errorCode=1;
+	fclose(REP_file.ptr);
+
+	return (errorCode);
+}
+
+
+int regional_run(const char* manifest, const char* systime)
+{
+	/* with MPI the rank 0 only distributes the sites and writes the regional file; a single process runs the sites
+	   on its threads (dynamic schedule) */
+	int errorCode=0;
+	int ns, nfailed=0, nrun=1, rank=0, nrank=1;
+	int nwidth;
+	regional_struct REG;
+#ifdef MUSO_MPI
+	int initialized=0, globalError;
+
+	MPI_Initialized(&initialized);
+	if (!initialized && MPI_Init(NULL, NULL) != MPI_SUCCESS)
+	{
+		printf("ERROR in call to MPI_Init() from regional.c\n");
+		return (431);
+	}
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &nrank);
+#endif
+
+	/* every process reads the manifest */
+	errorCode = regional_init(manifest, &REG);
+	if (errorCode) printf("ERROR in call to regional_init() from regional.c\n");
+
+	nwidth = REG.nout + 2;
+	if (!errorCode && rank == 0)
+	{
+		REG.result = (double*) calloc((size_t) REG.nsite * nwidth, sizeof(double));
+		if (!REG.result)
+		{
+			printf("ERROR allocating for outputs of the sites, regional_run()\n");
+			errorCode=431;
+		}
+	}
+
+#ifdef MUSO_MPI
+	/* the processes start the exchange of the sites only if all of them are ready */
+	MPI_Allreduce(&errorCode, &globalError, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+	if (!errorCode && globalError) errorCode=431;
+#endif
+
+#ifdef _OPENMP
+	if (nrank == 1 && REG.nthreads > 0) omp_set_num_threads(REG.nthreads);
+	if (nrank == 1) nrun = omp_get_max_threads();
+#endif
+	if (nrank > 1) nrun = nrank - 1;
+
+	if (!errorCode && rank == 0) printf("REGIONAL RUN: %i sites, %i parallel runs\n", REG.nsite, nrun);
+
+	if (!errorCode && nrank == 1)
+	{
+		#pragma omp parallel for schedule(dynamic,1)
+		for (ns = 0; ns < REG.nsite; ns++)
+			regional_site(&REG, ns, systime, REG.result + (size_t) ns * nwidth);
+	}
+#ifdef MUSO_MPI
+	else if (!errorCode && rank == 0)
+		errorCode = regional_master(&REG, nrank);
+	else if (!errorCode)
+		errorCode = regional_worker(&REG, systime);
+#endif
+
+	/* the failed sites are only reported, the others are written as usual */
+	if (!errorCode && rank == 0)
+	{
+		for (ns = 0; ns < REG.nsite; ns++)
+			if (REG.result[(size_t) ns * nwidth] != 0) nfailed++;
+
+		if (regional_report(&REG, nrun, nfailed))
+		{
+			printf("ERROR in call to regional_report() from regional.c\n");
+			errorCode=433;
+		}
+		else if (nfailed)
+		{
+			printf("ERROR in %i sites of the regional run (see error codes in %s)\n", nfailed, REG.report_file);
+			errorCode=432;
+		}
+	}
+
+	if (errorCode && rank == 0) writeErrorCode(errorCode);
+
+	for (ns = 0; ns < REG.nsite; ns++) free(REG.site[ns]);
+	free(REG.site);
+	free(REG.result);
+
+#ifdef MUSO_MPI
+	if (!initialized) MPI_Finalize();
+#endif
+
+	return (errorCode);
+}
+
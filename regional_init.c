@@ -0,0 +1,193 @@
+/*
+regional_init.c
+read the manifest of the regional run (sites with their init files and string substitutions, summary output variables,
+regional file)
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "bgc_func.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_constants.h"
+#include "bgc_io.h"
+
+#define REGIONAL_LINESIZE 8192
+
+
+int regional_parse(const char* line, regsite_struct* site)
+{
+	/* SITE <site id> <spinup init file or -> <normal init file> [<string>=<replacing string> ...] */
+	int errorCode=0;
+	int pos, nread;
+	char keyword[STRINGSIZE];
+	char token[REGIONAL_LINESIZE];
+	char* sep;
+
+	memset(site, 0, sizeof(regsite_struct));
+
+	pos = 0;
+	if (sscanf(line, "%199s %199s %127s %127s%n", keyword, site->id, site->spinup_ini, site->normal_ini, &nread) != 4) return (1);
+	pos += nread;
+
+	if (!strcmp(site->spinup_ini, "-")) site->spinup_ini[0] = '\0';
+
+	while (!errorCode && sscanf(line + pos, "%8191s%n", token, &nread) == 1)
+	{
+		pos += nread;
+		sep  = strchr(token, '=');
+		if (!sep || sep == token || site->nsubst == N_SRVSUBST || strlen(sep+1) >= FILENAMESIZE || (size_t) (sep - token) >= FILENAMESIZE)
+			errorCode=1;
+		else
+		{
+			*sep = '\0';
+			strcpy(site->subst_from[site->nsubst], token);
+			strcpy(site->subst_to[site->nsubst], sep+1);
+			site->nsubst += 1;
+		}
+	}
+
+	return (errorCode);
+}
+
+
+int regional_init(const char* manifest, regional_struct* REG)
+{
+	int errorCode=0;
+	int nline=0, nalloc=0;
+	size_t len;
+	file REG_file;
+	char line[REGIONAL_LINESIZE];
+	char keyword[STRINGSIZE];
+	char** site;
+	regsite_struct check;
+
+	/* default values: report file: <manifest file>.regional */
+	memset(REG, 0, sizeof(regional_struct));
+	strcpy(REG->report_file, manifest);
+	strcat(REG->report_file, ".regional");
+
+	strcpy(REG_file.name, manifest);
+	if (file_open(&REG_file,'i',1))
+	{
+		printf("ERROR opening manifest file of the regional run: %s\n", manifest);
+		return (227);
+	}
+
+	/* one line per keyword (the order of the lines is arbitrary), empty lines and lines starting with # are skipped */
+	while (!errorCode && fgets(line, REGIONAL_LINESIZE, REG_file.ptr))
+	{
+		nline++;
+		len = strlen(line);
+		if (len == REGIONAL_LINESIZE-1 && line[len-1] != '\n' && !feof(REG_file.ptr))
+		{
+			printf("ERROR in manifest file: too long line %i\n", nline);
+			errorCode=22701;
+			break;
+		}
+		if (sscanf(line, "%199s", keyword) != 1 || keyword[0] == '#') continue;
+
+		/* SITE line: identifier, main init files of the spinup (- : none) and of the normal run, string substitutions */
+		if (!strcmp(keyword, "SITE"))
+		{
+			if (regional_parse(line, &check))
+			{
+				printf("ERROR in manifest file: invalid site in line %i\n", nline);
+				errorCode=22702;
+			}
+			if (!errorCode && REG->nsite == nalloc)
+			{
+				nalloc = nalloc ? 2 * nalloc : 1024;
+				site = (char**) realloc(REG->site, nalloc * sizeof(char*));
+				if (!site)
+				{
+					printf("ERROR allocating for sites: regional_init()\n");
+					errorCode=22703;
+				}
+				else
+					REG->site = site;
+			}
+			if (!errorCode)
+			{
+				REG->site[REG->nsite] = (char*) malloc(len + 1);
+				if (!REG->site[REG->nsite])
+				{
+					printf("ERROR allocating for sites: regional_init()\n");
+					errorCode=22703;
+				}
+				else
+				{
+					strcpy(REG->site[REG->nsite], line);
+					REG->nsite += 1;
+				}
+			}
+		}
+		/* OUTPUT line: output code, mode (0: sum of daily values, 1: sum of end-of-year values, 2: end-of-simulation value) */
+		else if (!strcmp(keyword, "OUTPUT"))
+		{
+			if (REG->nout == N_SENSOUT)
+			{
+				printf("ERROR in manifest file: maximum number of output variables is %i\n", N_SENSOUT);
+				errorCode=22704;
+			}
+			if (!errorCode && sscanf(line, "%*s %i %i", &REG->outcode[REG->nout], &REG->outmode[REG->nout]) != 2)
+			{
+				printf("ERROR reading output variable in line %i: regional_init()\n", nline);
+				errorCode=22705;
+			}
+			if (!errorCode && output_code_check(REG->outcode[REG->nout], "manifest file"))
+				errorCode=22706;
+			if (!errorCode && (REG->outmode[REG->nout] < 0 || REG->outmode[REG->nout] > 2))
+			{
+				printf("ERROR in manifest file: mode of output variable must be 0, 1 or 2\n");
+				errorCode=22706;
+			}
+			if (!errorCode) REG->nout += 1;
+		}
+		/* REPORT line: name of the regional file */
+		else if (!strcmp(keyword, "REPORT"))
+		{
+			if (sscanf(line, "%*s %127s", REG->report_file) != 1)
+			{
+				printf("ERROR reading name of regional file in line %i: regional_init()\n", nline);
+				errorCode=22707;
+			}
+		}
+		/* THREADS line: number of parallel runs without MPI (0: all available processors) */
+		else if (!strcmp(keyword, "THREADS"))
+		{
+			if (sscanf(line, "%*s %i", &REG->nthreads) != 1 || REG->nthreads < 0)
+			{
+				printf("ERROR reading number of threads in line %i: regional_init()\n", nline);
+				errorCode=22708;
+			}
+		}
+		else
+		{
+			printf("ERROR in manifest file: unknown keyword in line %i --> %s\n", nline, keyword);
+			errorCode=227;
+		}
+	}
+
+	fclose(REG_file.ptr);
+
+	/* consistency of the settings */
+	if (!errorCode && (REG->nsite == 0 || REG->nout == 0))
+	{
+		printf("ERROR in manifest file: at least one SITE and one OUTPUT line is needed\n");
+		errorCode=22709;
+	}
+
+	return (errorCode);
+}
+
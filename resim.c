@@ -0,0 +1,995 @@
+/*
+resim.c
+incremental re-simulation of the normal run: the inputs are hashed day by day, the state of the simulation is stored
+at the end of the simulation years (snapshots). In the next run with the same output prefix the simulation is continued
+from the last snapshot before the first day with changed input, the unchanged part of the output files is kept
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_constants.h"
+#include "bgc_func.h"
+#include "bgc_io.h"
+
+#define RESIM_MAGIC		0x4D53524DU				/* "MRSM" */
+#define RESIM_VERSION	2						/* format version of the snapshot file (2: packed snapshots, statepack.c) */
+#define RESIM_MODEL		"Biome-BGCMuSo7.0-b10"	/* model version: snapshots of other model versions are not used */
+#define RESIM_BUFSIZE	65536					/* (byte) buffer size of copying the output files */
+
+/* header of the snapshot file, followed by the hashes of the metdays and the snapshots (size of the packed state, packed state) */
+typedef struct
+{
+	unsigned int magic;
+	int version;
+	char model[32];
+	unsigned long long key;
+	int nmetdays;
+	int size_state;
+	int n_soillayers;
+} resim_header_struct;
+
+/* adding data to the hash of a metday (days outside of the simulation period: first or last day) */
+static void resim_hash_day(resim_struct* RSM, int slot, const void* data, size_t nbytes)
+{
+	if (slot < 0) slot = 0;
+	if (slot > RSM->nmetdays - 1) slot = RSM->nmetdays - 1;
+
+	hash_bytes(&RSM->dayhash[slot], &RSM->daycheck[slot], data, nbytes);
+}
+
+/* adding a met variable of a metday (calculated in the compact met store, read from the window of the streamed met input) */
+static void resim_hash_metvalue(resim_struct* RSM, const metarr_struct* metarr, int var, int day)
+{
+	double value;
+
+	value = metarr_value(metarr, var, day);
+	resim_hash_day(RSM, day, &value, sizeof(double));
+}
+
+/* hashing the date of a management action into the metday of the date (returned); in the southern hemisphere
+   the meteorological data are shifted by half a year, therefore the action is assigned to one year earlier */
+static int resim_hash_date(resim_struct* RSM, const control_struct* ctrl, int year, int month, int day)
+{
+	int mondays[nMONTHS_OF_YEAR] = {31,28,31,30,31,30,31,31,30,31,30,31};
+	int date[3];
+	int slot;
+
+	date[0] = year;
+	date[1] = month;
+	date[2] = day;
+
+	if (month < 1 || month > nMONTHS_OF_YEAR) month = 1;
+	slot = (year - ctrl->simstartyear) * nDAYS_OF_YEAR + date_to_doy(mondays, month, day);
+	if (ctrl->south_shift) slot -= nDAYS_OF_YEAR;
+
+	resim_hash_day(RSM, slot, date, sizeof(date));
+
+	return (slot);
+}
+
+/* hashing the content of a file (EPC file of planting) */
+static int resim_hash_file(resim_struct* RSM, int slot, const char* filename)
+{
+	int errorCode=0;
+	file HSH_file;
+	unsigned char buffer[4096];
+	size_t n;
+
+	strcpy(HSH_file.name, filename);
+	if (file_open(&HSH_file,'r',1)) return (1);
+
+	while ((n = fread(buffer, 1, sizeof(buffer), HSH_file.ptr)) > 0) resim_hash_day(RSM, slot, buffer, n);
+
+	fclose(HSH_file.ptr);
+
+	return (errorCode);
+}
+
+
+/* key of the inputs without daily resolution and hash of the inputs of each metday */
+static int resim_hash(const bgcin_struct* bgcin, const phenarray_struct* phenarr, resim_struct* RSM)
+{
+	int errorCode=0;
+	const control_struct* ctrl = &bgcin->ctrl;
+	control_struct ctrlvar;
+	epconst_struct epc;
+	unsigned long long check;
+	double co2ndep[5];
+	int outvar[4];
+	int d, y, i, s, nyear;
+
+	/* 1. key: model version, control variables (except length of simulation), site, soil and EPC parameters, initial state */
+	RSM->key = 0xCBF29CE484222325ULL;
+	check    = 0x84222325CBF29CE4ULL;
+
+	hash_bytes(&RSM->key, &check, RESIM_MODEL, strlen(RESIM_MODEL));
+
+	memcpy(&ctrlvar, ctrl, sizeof(control_struct));
+	ctrlvar.simyears      = 0;
+	ctrlvar.onscreen      = 0;
+	ctrlvar.write_restart = 0;
+	ctrlvar.daycodes      = 0;
+	ctrlvar.daynames      = 0;
+	ctrlvar.anncodes      = 0;
+	ctrlvar.annnames      = 0;
+	ctrlvar.planttypeName = 0;
+	hash_bytes(&RSM->key, &check, &ctrlvar, sizeof(control_struct));
+	hash_array(&RSM->key, &check, ctrl->daycodes, ctrl->ndayout, sizeof(int));
+	hash_array(&RSM->key, &check, ctrl->anncodes, ctrl->nannout, sizeof(int));
+	if (ctrl->planttypeName) hash_bytes(&RSM->key, &check, ctrl->planttypeName, strlen(ctrl->planttypeName));
+
+	hash_bytes(&RSM->key, &check, &bgcin->sitec, sizeof(siteconst_struct));
+	hash_bytes(&RSM->key, &check, &bgcin->sprop, sizeof(soilprop_struct));
+
+	memcpy(&epc, &bgcin->epc, sizeof(epconst_struct));
+	epc.SGS_array   = 0;
+	epc.EGS_array   = 0;
+	epc.FMyr_array  = 0;
+	epc.WPMyr_array = 0;
+	epc.MSC_array   = 0;
+	hash_bytes(&RSM->key, &check, &epc, sizeof(epconst_struct));
+
+	hash_bytes(&RSM->key, &check, &bgcin->ws, sizeof(wstate_struct));
+	hash_bytes(&RSM->key, &check, &bgcin->cs, sizeof(cstate_struct));
+	hash_bytes(&RSM->key, &check, &bgcin->ns, sizeof(nstate_struct));
+	hash_bytes(&RSM->key, &check, &bgcin->cinit, sizeof(cinit_struct));
+	if (ctrl->read_restart) hash_bytes(&RSM->key, &check, &bgcin->restart_input, sizeof(restart_data_struct));
+
+	/* constant CO2 and N-deposition, conditional management settings */
+	co2ndep[0] = bgcin->co2.varco2;
+	co2ndep[1] = bgcin->co2.co2ppm;
+	co2ndep[2] = bgcin->ndep.varndep;
+	co2ndep[3] = bgcin->ndep.ndep;
+	co2ndep[4] = bgcin->ndep.NdepNH4_coeff;
+	hash_bytes(&RSM->key, &check, co2ndep, sizeof(co2ndep));
+
+	hash_bytes(&RSM->key, &check, &bgcin->MOW.condMOW_flag,        sizeof(int));
+	hash_bytes(&RSM->key, &check, &bgcin->MOW.fixLAIbef_condMOW,   sizeof(double));
+	hash_bytes(&RSM->key, &check, &bgcin->MOW.fixLAIaft_condMOW,   sizeof(double));
+	hash_bytes(&RSM->key, &check, &bgcin->MOW.transpCOEFF_condMOW, sizeof(double));
+	hash_bytes(&RSM->key, &check, &bgcin->IRG.condIRG_flag,        sizeof(int));
+	hash_bytes(&RSM->key, &check, &bgcin->IRG.nLayer_condIRG,      sizeof(double));
+	hash_bytes(&RSM->key, &check, &bgcin->IRG.startPoint_condIRG,  sizeof(double));
+	hash_bytes(&RSM->key, &check, &bgcin->IRG.aftVWCratio_condIRG, sizeof(double));
+	hash_bytes(&RSM->key, &check, &bgcin->IRG.maxAMOUNT_condIRG,   sizeof(double));
+
+	/* the set of management types defines the output of the economic file */
+	outvar[0] = bgcin->HRV.HRV_num > 0;
+	outvar[1] = bgcin->OBS.nseries;
+	outvar[2] = bgcin->PLT.PLT_num > 0;
+	outvar[3] = N_SOILLAYERS;
+	hash_bytes(&RSM->key, &check, outvar, sizeof(outvar));
+
+	/* settings of the comparison with observations (the observations themselves are hashed on their date) */
+	for (i = 0; i < bgcin->OBS.nseries; i++)
+	{
+		hash_bytes(&RSM->key, &check, &bgcin->OBS.series[i].outcode,  sizeof(int));
+		hash_bytes(&RSM->key, &check, &bgcin->OBS.series[i].timestep, sizeof(int));
+	}
+
+	/* settings of the temporal aggregations (the actual windows are part of the snapshots) */
+	hash_bytes(&RSM->key, &check, &bgcin->AGG.nspec, sizeof(int));
+	for (i = 0; i < bgcin->AGG.nspec; i++)
+	{
+		hash_bytes(&RSM->key, &check, &bgcin->AGG.spec[i].outcode,      sizeof(int));
+		hash_bytes(&RSM->key, &check, &bgcin->AGG.spec[i].func,         sizeof(int));
+		hash_bytes(&RSM->key, &check, &bgcin->AGG.spec[i].threshold,    sizeof(double));
+		hash_bytes(&RSM->key, &check, &bgcin->AGG.spec[i].window,       sizeof(int));
+		hash_bytes(&RSM->key, &check, &bgcin->AGG.spec[i].start_mmdd,   sizeof(int));
+		hash_bytes(&RSM->key, &check, &bgcin->AGG.spec[i].end_mmdd,     sizeof(int));
+		hash_bytes(&RSM->key, &check, &bgcin->AGG.spec[i].cond_outcode, sizeof(int));
+		hash_bytes(&RSM->key, &check, &bgcin->AGG.spec[i].cond_min,     sizeof(double));
+		hash_bytes(&RSM->key, &check, &bgcin->AGG.spec[i].cond_max,     sizeof(double));
+	}
+	RSM->key ^= check;
+
+	/* 2. daily hashes */
+	RSM->nmetdays = ctrl->simyears * nDAYS_OF_YEAR;
+	RSM->dayhash  = (unsigned long long*) malloc(RSM->nmetdays * sizeof(unsigned long long));
+	RSM->daycheck = (unsigned long long*) malloc(RSM->nmetdays * sizeof(unsigned long long));
+	if (!RSM->dayhash || !RSM->daycheck)
+	{
+		printf("ERROR allocating for hashes of the incremental re-simulation, resim_hash()\n");
+		return (1);
+	}
+
+	for (d = 0; d < RSM->nmetdays; d++)
+	{
+		RSM->dayhash[d]  = 0xCBF29CE484222325ULL;
+		RSM->daycheck[d] = 0x84222325CBF29CE4ULL;
+	}
+
+	/* meteorological data, with the derived running averages */
+	for (d = 0; d < RSM->nmetdays; d++)
+	{
+		resim_hash_metvalue(RSM, &bgcin->metarr, METARR_TMAX,       d);
+		resim_hash_metvalue(RSM, &bgcin->metarr, METARR_TMIN,       d);
+		resim_hash_metvalue(RSM, &bgcin->metarr, METARR_PRCP,       d);
+		resim_hash_metvalue(RSM, &bgcin->metarr, METARR_VPD,        d);
+		resim_hash_metvalue(RSM, &bgcin->metarr, METARR_SWAVGFD,    d);
+		resim_hash_metvalue(RSM, &bgcin->metarr, METARR_PAR,        d);
+		resim_hash_metvalue(RSM, &bgcin->metarr, METARR_DAYL,       d);
+		resim_hash_metvalue(RSM, &bgcin->metarr, METARR_TDAY,       d);
+		resim_hash_metvalue(RSM, &bgcin->metarr, METARR_TAVG,       d);
+		resim_hash_metvalue(RSM, &bgcin->metarr, METARR_TAVGRA11,   d);
+		resim_hash_metvalue(RSM, &bgcin->metarr, METARR_TAVGRA10,   d);
+		resim_hash_metvalue(RSM, &bgcin->metarr, METARR_TAVGRA30,   d);
+		resim_hash_metvalue(RSM, &bgcin->metarr, METARR_TEMPRADF,   d);
+		resim_hash_metvalue(RSM, &bgcin->metarr, METARR_TEMPRADFRA, d);
+	}
+
+	/* annual data: on the first day of the year */
+	for (y = 0; y < ctrl->simyears; y++)
+	{
+		s = y * nDAYS_OF_YEAR;
+		resim_hash_day(RSM, s, &bgcin->metarr.annTavg_array[y],     sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->metarr.annTrange_array[y],   sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->metarr.annTavgRA_array[y],   sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->metarr.annTrangeRA_array[y], sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->metarr.monTavg_array[y*nMONTHS_OF_YEAR], nMONTHS_OF_YEAR * sizeof(double));
+
+		if (bgcin->co2.varco2)    resim_hash_day(RSM, s, &bgcin->co2.co2ppm_array[y], sizeof(double));
+		if (bgcin->ndep.varndep)  resim_hash_day(RSM, s, &bgcin->ndep.Ndep_array[y],  sizeof(double));
+		if (ctrl->varSGS_flag)    resim_hash_day(RSM, s, &bgcin->epc.SGS_array[y],    sizeof(double));
+		if (ctrl->varEGS_flag)    resim_hash_day(RSM, s, &bgcin->epc.EGS_array[y],    sizeof(double));
+		if (ctrl->varFM_flag)     resim_hash_day(RSM, s, &bgcin->epc.FMyr_array[y],   sizeof(double));
+		if (ctrl->varWPM_flag)    resim_hash_day(RSM, s, &bgcin->epc.WPMyr_array[y],  sizeof(double));
+		if (ctrl->varMSC_flag)    resim_hash_day(RSM, s, &bgcin->epc.MSC_array[y],    sizeof(double));
+	}
+
+	/* phenological signals (the model estimated onday and offday may depend on the whole meteorological period) */
+	nyear = bgcin->PLT.PLT_num ? bgcin->PLT.PLT_num : ctrl->simyears;
+	for (i = 0; i < nyear; i++)
+	{
+		s = (phenarr->onday_arr[i][0] - ctrl->simstartyear) * nDAYS_OF_YEAR;
+		if (phenarr->onday_arr[i][1] > 0) s += phenarr->onday_arr[i][1];
+		resim_hash_day(RSM, s, phenarr->onday_arr[i],  2 * sizeof(int));
+		resim_hash_day(RSM, s, phenarr->offday_arr[i], 2 * sizeof(int));
+	}
+
+	if (ctrl->GSI_flag && !bgcin->PLT.PLT_num)
+	{
+		for (y = 0; y < ctrl->simyears; y++)
+		{
+			for (d = 0; d < nDAYS_OF_YEAR; d++)
+			{
+				s = y * nDAYS_OF_YEAR + d;
+				resim_hash_day(RSM, s, &phenarr->Tmin_index[y][d],    sizeof(double));
+				resim_hash_day(RSM, s, &phenarr->vpd_index[y][d],     sizeof(double));
+				resim_hash_day(RSM, s, &phenarr->dayl_index[y][d],    sizeof(double));
+				resim_hash_day(RSM, s, &phenarr->gsi_indexAVG[y][d],  sizeof(double));
+				resim_hash_day(RSM, s, &phenarr->heatsum_index[y][d], sizeof(double));
+				resim_hash_day(RSM, s, &phenarr->heatsum[y][d],       sizeof(double));
+			}
+		}
+	}
+
+	/* management: on the (first) day of the action, planting with the content of the new EPC file */
+	for (i = 0; !errorCode && i < bgcin->PLT.PLT_num; i++)
+	{
+		s = resim_hash_date(RSM, ctrl, bgcin->PLT.PLTyear_array[i], bgcin->PLT.PLTmonth_array[i], bgcin->PLT.PLTday_array[i]);
+		resim_hash_day(RSM, s, &bgcin->PLT.germDepth_array[i],       sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->PLT.n_seedlings_array[i],     sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->PLT.weight_1000seed_array[i], sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->PLT.seed_carbon_array[i],     sizeof(double));
+		resim_hash_day(RSM, s, bgcin->PLT.filename_array[i], strlen(bgcin->PLT.filename_array[i]));
+		if (resim_hash_file(RSM, s, bgcin->PLT.filename_array[i]))
+		{
+			printf("ERROR in hashing EPC file of planting: %s\n", bgcin->PLT.filename_array[i]);
+			errorCode=1;
+		}
+	}
+
+	for (i = 0; i < bgcin->THN.THN_num; i++)
+	{
+		s = resim_hash_date(RSM, ctrl, bgcin->THN.THNyear_array[i], bgcin->THN.THNmonth_array[i], bgcin->THN.THNday_array[i]);
+		resim_hash_day(RSM, s, &bgcin->THN.thinningRate_w_array[i],  sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->THN.thinningRate_nw_array[i], sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->THN.transpCoeff_w_array[i],   sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->THN.transpCoeff_nw_array[i],  sizeof(double));
+	}
+
+	for (i = 0; i < bgcin->MOW.MOW_num; i++)
+	{
+		s = resim_hash_date(RSM, ctrl, bgcin->MOW.MOWyear_array[i], bgcin->MOW.MOWmonth_array[i], bgcin->MOW.MOWday_array[i]);
+		resim_hash_day(RSM, s, &bgcin->MOW.LAI_limit_array[i],    sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->MOW.transportMOW_array[i], sizeof(double));
+	}
+
+	for (i = 0; i < bgcin->GRZ.GRZ_num; i++)
+	{
+		s = resim_hash_date(RSM, ctrl, bgcin->GRZ.GRZstart_year_array[i], bgcin->GRZ.GRZstart_month_array[i], bgcin->GRZ.GRZstart_day_array[i]);
+		resim_hash_day(RSM, s, &bgcin->GRZ.GRZend_year_array[i],   sizeof(int));
+		resim_hash_day(RSM, s, &bgcin->GRZ.GRZend_month_array[i],  sizeof(int));
+		resim_hash_day(RSM, s, &bgcin->GRZ.GRZend_day_array[i],    sizeof(int));
+		resim_hash_day(RSM, s, &bgcin->GRZ.trampling_effect[i],    sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->GRZ.weight_LSU[i],          sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->GRZ.stocking_rate_array[i], sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->GRZ.DMintake_array[i],      sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->GRZ.DMintake2excr_array[i], sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->GRZ.excr2litter_array[i],   sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->GRZ.DM_Ccontent_array[i],   sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->GRZ.EXCR_Ncontent_array[i], sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->GRZ.EXCR_Ccontent_array[i], sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->GRZ.Nexrate[i],             sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->GRZ.EFman_N2O[i],           sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->GRZ.EFman_CH4[i],           sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->GRZ.EFfer_CH4[i],           sizeof(double));
+	}
+
+	for (i = 0; i < bgcin->HRV.HRV_num; i++)
+	{
+		s = resim_hash_date(RSM, ctrl, bgcin->HRV.HRVyear_array[i], bgcin->HRV.HRVmonth_array[i], bgcin->HRV.HRVday_array[i]);
+		resim_hash_day(RSM, s, &bgcin->HRV.snagprop_array[i],     sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->HRV.transportHRV_array[i], sizeof(double));
+	}
+
+	for (i = 0; i < bgcin->PLG.PLG_num; i++)
+	{
+		s = resim_hash_date(RSM, ctrl, bgcin->PLG.PLGyear_array[i], bgcin->PLG.PLGmonth_array[i], bgcin->PLG.PLGday_array[i]);
+		resim_hash_day(RSM, s, &bgcin->PLG.PLGdepths_array[i], sizeof(double));
+	}
+
+	for (i = 0; i < bgcin->FRZ.FRZ_num; i++)
+	{
+		s = resim_hash_date(RSM, ctrl, bgcin->FRZ.FRZyear_array[i], bgcin->FRZ.FRZmonth_array[i], bgcin->FRZ.FRZday_array[i]);
+		resim_hash_day(RSM, s, &bgcin->FRZ.FRZdepth_array[i],    sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->FRZ.fertilizer_array[i],  sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->FRZ.DM_array[i],          sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->FRZ.NO3content_array[i],  sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->FRZ.NH4content_array[i],  sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->FRZ.UREAcontent_array[i], sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->FRZ.orgCcontent_array[i], sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->FRZ.orgNcontent_array[i], sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->FRZ.litr_flab_array[i],   sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->FRZ.litr_fcel_array[i],   sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->FRZ.EFfert_N2O[i],        sizeof(double));
+		resim_hash_day(RSM, s, bgcin->FRZ.ferttype_array[i], strlen(bgcin->FRZ.ferttype_array[i]));
+	}
+
+	for (i = 0; i < bgcin->IRG.IRG_num; i++)
+	{
+		s = resim_hash_date(RSM, ctrl, bgcin->IRG.IRGyear_array[i], bgcin->IRG.IRGmonth_array[i], bgcin->IRG.IRGday_array[i]);
+		resim_hash_day(RSM, s, &bgcin->IRG.IRGquantity_array[i], sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->IRG.IRGheight_array[i],   sizeof(double));
+	}
+
+	for (i = 0; i < bgcin->MUL.MUL_num; i++)
+	{
+		s = resim_hash_date(RSM, ctrl, bgcin->MUL.MULyear_array[i], bgcin->MUL.MULmonth_array[i], bgcin->MUL.MULday_array[i]);
+		resim_hash_day(RSM, s, &bgcin->MUL.litrCabove_MUL[i],  sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->MUL.cwdCabove_MUL[i],   sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->MUL.litrCNabove_MUL[i], sizeof(double));
+		resim_hash_day(RSM, s, &bgcin->MUL.cwdCNabove_MUL[i],  sizeof(double));
+	}
+
+	for (i = 0; i < bgcin->CWE.CWE_num; i++)
+	{
+		s = resim_hash_date(RSM, ctrl, bgcin->CWE.CWEyear_array[i], bgcin->CWE.CWEmonth_array[i], bgcin->CWE.CWEday_array[i]);
+		resim_hash_day(RSM, s, &bgcin->CWE.removePROP_CWE[i], sizeof(double));
+	}
+
+	for (i = 0; i < bgcin->FLD.FLD_num; i++)
+	{
+		s = resim_hash_date(RSM, ctrl, bgcin->FLD.FLDstart_year_array[i], bgcin->FLD.FLDstart_month_array[i], bgcin->FLD.FLDstart_day_array[i]);
+		resim_hash_day(RSM, s, &bgcin->FLD.FLDend_year_array[i],  sizeof(int));
+		resim_hash_day(RSM, s, &bgcin->FLD.FLDend_month_array[i], sizeof(int));
+		resim_hash_day(RSM, s, &bgcin->FLD.FLDend_day_array[i],   sizeof(int));
+		resim_hash_day(RSM, s, &bgcin->FLD.FLDheight[i],          sizeof(double));
+	}
+
+	for (i = 0; i < bgcin->GWS.GWD_num; i++)
+	{
+		s = resim_hash_date(RSM, ctrl, bgcin->GWS.GWyear_array[i], bgcin->GWS.GWmonth_array[i], bgcin->GWS.GWday_array[i]);
+		resim_hash_day(RSM, s, &bgcin->GWS.GWdepth_array[i], sizeof(double));
+	}
+
+	/* observations: on their date (monthly observations: first day of the month) */
+	for (i = 0; i < bgcin->OBS.nseries; i++)
+	{
+		for (d = 0; d < bgcin->OBS.series[i].nobs; d++)
+		{
+			if (bgcin->OBS.series[i].timestep == 0)
+				s = resim_hash_date(RSM, ctrl, bgcin->OBS.series[i].date_array[d] / 10000, (bgcin->OBS.series[i].date_array[d] / 100) % 100,
+				                    bgcin->OBS.series[i].date_array[d] % 100);
+			else
+				s = resim_hash_date(RSM, ctrl, bgcin->OBS.series[i].date_array[d] / 100, bgcin->OBS.series[i].date_array[d] % 100, 1);
+			resim_hash_day(RSM, s, &bgcin->OBS.series[i].value_array[d], sizeof(double));
+		}
+	}
+
+	return (errorCode);
+}
+
+
+/* output files continued by the re-simulation (NULL: not written in this run) */
+static file* resim_outfile(bgcout_struct* bgcout, const control_struct* ctrl, int HRV_num, int n, int* ascii)
+{
+	file* outfile = 0;
+
+	switch (n)
+	{
+	case 0:
+		if (ctrl->dodaily)  outfile = &bgcout->dayout;
+		*ascii = ctrl->dodaily == 2;
+		break;
+	case 1:
+		if (ctrl->domonavg) outfile = &bgcout->monavgout;
+		*ascii = ctrl->domonavg == 2;
+		break;
+	case 2:
+		if (ctrl->doannavg) outfile = &bgcout->annavgout;
+		*ascii = ctrl->doannavg == 2;
+		break;
+	case 3:
+		if (ctrl->doannual) outfile = &bgcout->annout;
+		*ascii = ctrl->doannual == 2;
+		break;
+	case 4:
+		if (HRV_num)        outfile = &bgcout->econout_file;
+		*ascii = 1;
+		break;
+	case 5:
+		if (bgcout->aggout.ptr) outfile = &bgcout->aggout;
+		*ascii = 1;
+		break;
+	}
+
+	return (outfile);
+}
+
+/* size of a file in bytes (-1: the file does not exist) */
+static long resim_filesize(const char* filename)
+{
+	FILE* fp;
+	long size = -1;
+
+	/* the names of the renamed files are used with the file structure (limited length) */
+	if (strlen(filename) >= FILENAMESIZE) return (size);
+
+	if ((fp = fopen(filename, "rb")) != NULL)
+	{
+		if (!fseek(fp, 0, SEEK_END)) size = ftell(fp);
+		fclose(fp);
+	}
+
+	return (size);
+}
+
+/* copying the first part (until position pos) of the renamed earlier output file into the new output file;
+   ascii files are copied in text mode, the snapshot positions are always at the end of a line */
+static int resim_copy(file* outfile, const char* bakname, long pos, int ascii)
+{
+	int errorCode=0;
+	file BAK_file;
+	char* buffer;
+	size_t n, nread;
+	long copied = 0;
+
+	if (strlen(bakname) >= FILENAMESIZE) return (1);
+	strcpy(BAK_file.name, bakname);
+	if (file_open(&BAK_file, ascii ? 'i' : 'r', 1)) return (1);
+
+	buffer = (char*) malloc(RESIM_BUFSIZE * sizeof(char));
+	if (!buffer)
+	{
+		printf("ERROR allocating for copy buffer, resim_copy()\n");
+		errorCode=1;
+	}
+
+	if (!errorCode && ascii)
+	{
+		while (ftell(outfile->ptr) < pos && fgets(buffer, RESIM_BUFSIZE, BAK_file.ptr)) fputs(buffer, outfile->ptr);
+		if (ftell(outfile->ptr) != pos) errorCode=1;
+	}
+	else if (!errorCode)
+	{
+		while (copied < pos)
+		{
+			n = (size_t)(pos - copied) < RESIM_BUFSIZE ? (size_t)(pos - copied) : RESIM_BUFSIZE;
+			nread = fread(buffer, 1, n, BAK_file.ptr);
+			if (nread == 0) break;
+			fwrite(buffer, 1, nread, outfile->ptr);
+			copied += (long) nread;
+		}
+		if (copied != pos) errorCode=1;
+	}
+
+	if (buffer) free(buffer);
+	fclose(BAK_file.ptr);
+
+	return (errorCode);
+}
+
+
+/* reading the next snapshot of a snapshot file into the packing buffer */
+static int resim_readpacked(FILE* ptr, unsigned char* buffer, size_t* nbytes)
+{
+	unsigned int size;
+
+	if (fread(&size, sizeof(unsigned int), 1, ptr) != 1 || (size_t) size > state_packbound() ||
+		fread(buffer, 1, (size_t) size, ptr) != (size_t) size) return (1);
+
+	*nbytes = (size_t) size;
+
+	return (0);
+}
+
+/* writing the snapshot of the packing buffer into the snapshot file */
+static int resim_writepacked(FILE* ptr, const unsigned char* buffer, size_t nbytes)
+{
+	unsigned int size = (unsigned int) nbytes;
+
+	if (fwrite(&size, sizeof(unsigned int), 1, ptr) != 1 || fwrite(buffer, 1, nbytes, ptr) != nbytes) return (1);
+
+	return (0);
+}
+
+/* reading and unpacking the next snapshot into the snapshot buffer */
+static int resim_readstate(FILE* ptr, resim_struct* RSM, size_t* nbytes)
+{
+	if (resim_readpacked(ptr, RSM->pack_buffer, nbytes)) return (1);
+
+	return (state_unpack(RSM->pack_buffer, *nbytes, RSM->state));
+}
+
+
+int resim_prepare(bgcin_struct* bgcin, bgcout_struct* bgcout, const phenarray_struct* phenarr)
+{
+	/* the earlier snapshot file and output files were renamed (by output_init() and here) to <name>.resimbak */
+	int errorCode=0;
+	resim_struct* RSM = &bgcin->RSM;
+	const control_struct* ctrl = &bgcin->ctrl;
+	resim_header_struct header;
+	unsigned long long* oldhash = 0;
+	unsigned long long* oldcheck = 0;
+	file OLD_file, *outfile;
+	char bakname[FILENAMESIZE+16];
+	long header_size = 0;
+	long last_pos = 0, pos;
+	size_t nbytes;
+	int ncmp, nrec, d, n, ascii, resume_ok;
+
+	RSM->start_simyr = 0;
+	RSM->diff_metday = -1;
+	nrec             = 0;
+
+	/* 1. hashing the inputs */
+	if (!errorCode && resim_hash(bgcin, phenarr, RSM))
+	{
+		printf("ERROR in call to resim_hash() from resim_prepare()\n");
+		errorCode=1;
+	}
+
+	if (!errorCode)
+	{
+		RSM->state       = (resimstate_struct*) malloc(sizeof(resimstate_struct));
+		RSM->pack_buffer = (unsigned char*) malloc(state_packbound());
+		if (!RSM->state || !RSM->pack_buffer)
+		{
+			printf("ERROR allocating for snapshot buffer, resim_prepare()\n");
+			errorCode=1;
+		}
+	}
+
+	/* 2. first metday with changed input and number of usable snapshots of the earlier run */
+	resim_backup(RSM->snap_file.name);
+	sprintf(bakname, "%s.resimbak", RSM->snap_file.name);
+	OLD_file.ptr = 0;
+	strcpy(OLD_file.name, strlen(bakname) < FILENAMESIZE ? bakname : "");
+	if (!errorCode && strlen(OLD_file.name) && !file_open(&OLD_file,'r',0))
+	{
+		if (fread(&header, sizeof(resim_header_struct), 1, OLD_file.ptr) == 1 && header.magic == RESIM_MAGIC &&
+			header.version == RESIM_VERSION && !strncmp(header.model, RESIM_MODEL, sizeof(header.model)) && header.key == RSM->key &&
+			header.size_state == (int) sizeof(resimstate_struct) && header.n_soillayers == N_SOILLAYERS && header.nmetdays > 0)
+		{
+			header_size = (long) sizeof(resim_header_struct) + 2 * (long) header.nmetdays * (long) sizeof(unsigned long long);
+			oldhash  = (unsigned long long*) malloc(header.nmetdays * sizeof(unsigned long long));
+			oldcheck = (unsigned long long*) malloc(header.nmetdays * sizeof(unsigned long long));
+			if (oldhash && oldcheck &&
+				fread(oldhash,  sizeof(unsigned long long), header.nmetdays, OLD_file.ptr) == (size_t) header.nmetdays &&
+				fread(oldcheck, sizeof(unsigned long long), header.nmetdays, OLD_file.ptr) == (size_t) header.nmetdays)
+			{
+				ncmp = header.nmetdays < RSM->nmetdays ? header.nmetdays : RSM->nmetdays;
+				RSM->diff_metday = ncmp;
+				for (d = 0; d < ncmp; d++)
+				{
+					if (oldhash[d] != RSM->dayhash[d] || oldcheck[d] != RSM->daycheck[d])
+					{
+						RSM->diff_metday = d;
+						break;
+					}
+				}
+
+				/* snapshots are in chronological order: the ones before the first changed metday are usable */
+				fseek(OLD_file.ptr, header_size, SEEK_SET);
+				while (1)
+				{
+					pos = ftell(OLD_file.ptr);
+					if (resim_readstate(OLD_file.ptr, RSM, &nbytes) || (RSM->state->simyr + 1) * nDAYS_OF_YEAR > RSM->diff_metday) break;
+					last_pos = pos;
+					nrec++;
+				}
+			}
+			if (oldhash)  free(oldhash);
+			if (oldcheck) free(oldcheck);
+		}
+	}
+
+	/* 3. checking the last usable snapshot: after a planting the annual varying EPC data are read again from the new EPC file
+	      (they are not part of the snapshot); the earlier output files have to contain the first part of the outputs */
+	if (nrec)
+	{
+		resume_ok = !fseek(OLD_file.ptr, last_pos, SEEK_SET) && !resim_readstate(OLD_file.ptr, RSM, &nbytes);
+
+		if (resume_ok && RSM->state->mgmd[0] > 0 &&
+			(ctrl->varSGS_flag || ctrl->varEGS_flag || ctrl->varFM_flag || ctrl->varWPM_flag || ctrl->varMSC_flag)) resume_ok = 0;
+
+		for (n = 0; resume_ok && n < N_RESIMOUT; n++)
+		{
+			outfile = resim_outfile(bgcout, ctrl, bgcin->HRV.HRV_num, n, &ascii);
+			if (!outfile) continue;
+
+			sprintf(bakname, "%s.resimbak", outfile->name);
+			if (resim_filesize(bakname) < RSM->state->outpos[n]) resume_ok = 0;
+		}
+
+		if (!resume_ok) nrec = 0;
+	}
+
+	/* 4. output files: copying the unchanged part, removing the renamed earlier files */
+	for (n = 0; n < N_RESIMOUT; n++)
+	{
+		outfile = resim_outfile(bgcout, ctrl, bgcin->HRV.HRV_num, n, &ascii);
+		if (!outfile) continue;
+
+		sprintf(bakname, "%s.resimbak", outfile->name);
+		if (!errorCode && nrec && resim_copy(outfile, bakname, RSM->state->outpos[n], ascii))
+		{
+			printf("ERROR in copying the earlier output file %s, resim_prepare()\n", bakname);
+			errorCode=1;
+		}
+		remove(bakname);
+	}
+
+	/* 5. new snapshot file: hashes of the actual inputs, usable snapshots of the earlier run */
+	if (!errorCode && file_open(&RSM->snap_file,'w',1))
+	{
+		printf("ERROR opening snapshot file %s, resim_prepare()\n", RSM->snap_file.name);
+		errorCode=1;
+	}
+
+	if (!errorCode)
+	{
+		memset(&header, 0, sizeof(resim_header_struct));
+		header.magic        = RESIM_MAGIC;
+		header.version      = RESIM_VERSION;
+		strcpy(header.model, RESIM_MODEL);
+		header.key          = RSM->key;
+		header.nmetdays     = RSM->nmetdays;
+		header.size_state   = (int) sizeof(resimstate_struct);
+		header.n_soillayers = N_SOILLAYERS;
+
+		if (fwrite(&header, sizeof(resim_header_struct), 1, RSM->snap_file.ptr) != 1 ||
+			fwrite(RSM->dayhash,  sizeof(unsigned long long), RSM->nmetdays, RSM->snap_file.ptr) != (size_t) RSM->nmetdays ||
+			fwrite(RSM->daycheck, sizeof(unsigned long long), RSM->nmetdays, RSM->snap_file.ptr) != (size_t) RSM->nmetdays)
+		{
+			printf("ERROR writing snapshot file %s, resim_prepare()\n", RSM->snap_file.name);
+			errorCode=1;
+		}
+	}
+
+	/* the last copied snapshot remains in the buffer: starting state of the continuation (the packed snapshots
+	   are copied in their own format) */
+	if (!errorCode && nrec)
+	{
+		fseek(OLD_file.ptr, header_size, SEEK_SET);
+		for (n = 0; !errorCode && n < nrec; n++)
+		{
+			if (resim_readpacked(OLD_file.ptr, RSM->pack_buffer, &nbytes) ||
+				resim_writepacked(RSM->snap_file.ptr, RSM->pack_buffer, nbytes) ||
+				(n == nrec - 1 && state_unpack(RSM->pack_buffer, nbytes, RSM->state)))
+			{
+				printf("ERROR copying snapshots of the earlier run, resim_prepare()\n");
+				errorCode=1;
+			}
+		}
+		if (!errorCode) RSM->start_simyr = RSM->state->simyr + 1;
+	}
+
+	if (OLD_file.ptr) fclose(OLD_file.ptr);
+	sprintf(bakname, "%s.resimbak", RSM->snap_file.name);
+	remove(bakname);
+
+	/* 6. writing logfile */
+	fprintf(bgcout->log_file.ptr, "INCREMENTAL RE-SIMULATION\n");
+	if (RSM->diff_metday < 0)
+		fprintf(bgcout->log_file.ptr, "no usable snapshots of an earlier run, full simulation\n");
+	else if (RSM->diff_metday < RSM->nmetdays)
+		fprintf(bgcout->log_file.ptr, "first changed input: year %i, yday %i\n",
+			    ctrl->simstartyear + RSM->diff_metday / nDAYS_OF_YEAR, RSM->diff_metday % nDAYS_OF_YEAR);
+	else
+		fprintf(bgcout->log_file.ptr, "no changed input\n");
+
+	if (RSM->start_simyr)
+		fprintf(bgcout->log_file.ptr, "simulation continued from the end of year %i\n", ctrl->simstartyear + RSM->start_simyr - 1);
+	else if (RSM->diff_metday >= 0)
+		fprintf(bgcout->log_file.ptr, "no snapshot before the first changed input, full simulation\n");
+	fprintf(bgcout->log_file.ptr, " \n");
+
+	if (ctrl->onscreen && RSM->start_simyr) printf("INFORMATION: simulation continued from the end of year %i\n", ctrl->simstartyear + RSM->start_simyr - 1);
+
+	return (errorCode);
+}
+
+
+int resim_snapshot(resim_struct* RSM, bgcout_struct* bgcout, int tofile, obscomp_struct* OBS, aggreg_struct* AGG, int first_balance, control_struct* ctrl, 
+	               metvar_struct* metv, wstate_struct* ws, wflux_struct* wf, cinit_struct* cinit, cstate_struct* cs, cflux_struct* cf, 
+				   nstate_struct* ns, nflux_struct* nf, epvar_struct* epv, siteconst_struct* sitec, soilprop_struct* sprop, GWcalc_struct* gwc, 
+				   epconst_struct* epc, phenology_struct* phen, psn_struct* psn_sun, psn_struct* psn_shade, ntemp_struct* nt, summary_struct* summary,
+				   planting_struct* PLT, thinning_struct* THN, mowing_struct* MOW, grazing_struct* GRZ, harvesting_struct* HRV, ploughing_struct* PLG, 
+				   fertilizing_struct* FRZ, irrigating_struct* IRG, mulching_struct* MUL, CWDextract_struct* CWE, flooding_struct* FLD, groundwater_struct* GWS)
+{
+	/* the complete state of the simulation at the end of the year (local variables of bgc()) and the end positions of the output files;
+	   tofile=0: the state is only kept in the buffer (branching point of the management optimizer) */
+	int errorCode=0;
+	resimstate_struct* state = RSM->state;
+	file* outfile;
+	int n, ascii;
+	size_t nbytes;
+
+	state->simyr         = ctrl->simyr;
+	state->first_balance = first_balance;
+	state->ctrl          = *ctrl;
+	state->metv          = *metv;
+	state->ws            = *ws;
+	state->wf            = *wf;
+	state->cinit         = *cinit;
+	state->cs            = *cs;
+	state->cf            = *cf;
+	state->ns            = *ns;
+	state->nf            = *nf;
+	state->epv           = *epv;
+	state->sitec         = *sitec;
+	state->sprop         = *sprop;
+	state->gwc           = *gwc;
+	state->epc           = *epc;
+	state->phen          = *phen;
+	state->psn_sun       = *psn_sun;
+	state->psn_shade     = *psn_shade;
+	state->nt            = *nt;
+	state->summary       = *summary;
+
+	memset(state->planttypeName, 0, STRINGSIZE);
+	if (ctrl->planttypeName) strncpy(state->planttypeName, ctrl->planttypeName, STRINGSIZE-1);
+
+	state->mgmd[0]  = PLT->mgmdPLT;
+	state->mgmd[1]  = THN->mgmdTHN;
+	state->mgmd[2]  = MOW->mgmdMOW;
+	state->mgmd[3]  = GRZ->mgmdGRZ;
+	state->mgmd[4]  = HRV->mgmdHRV;
+	state->mgmd[5]  = PLG->mgmdPLG;
+	state->mgmd[6]  = FRZ->mgmdFRZ;
+	state->mgmd[7]  = IRG->mgmdIRG;
+	state->mgmd[8]  = MUL->mgmdMUL;
+	state->mgmd[9]  = CWE->mgmdCWE;
+	state->mgmd[10] = FLD->mgmdFLD;
+	state->mgmd[11] = GWS->mgmdGWD;
+	state->trampleff_act = GRZ->trampleff_act;
+
+	memcpy(state->obs, OBS->series, N_OBSSERIES * sizeof(obsseries_struct));
+	memcpy(state->agg, AGG->spec, N_AGGSPEC * sizeof(aggspec_struct));
+
+	for (n = 0; n < N_RESIMOUT; n++)
+	{
+		state->outpos[n] = 0;
+		outfile = resim_outfile(bgcout, ctrl, HRV->HRV_num, n, &ascii);
+		if (tofile && outfile)
+		{
+			fflush(outfile->ptr);
+			state->outpos[n] = ftell(outfile->ptr);
+			if (state->outpos[n] < 0) errorCode=1;
+		}
+	}
+
+	if (!errorCode && tofile && (state_pack(state, RSM->pack_mode, RSM->pack_buffer, &nbytes) ||
+		                         resim_writepacked(RSM->snap_file.ptr, RSM->pack_buffer, nbytes))) errorCode=1;
+	if (!errorCode && tofile) fflush(RSM->snap_file.ptr);
+
+	/* size of the snapshot in the formats (first snapshot of the run) */
+	if (!errorCode && tofile && RSM->nsnap == 0 && state_packreport(state, bgcout->log_file)) errorCode=1;
+	if (!errorCode && tofile) RSM->nsnap += 1;
+
+	if (errorCode) printf("ERROR writing snapshot into %s, resim_snapshot()\n", RSM->snap_file.name);
+
+	return (errorCode);
+}
+
+
+static int resim_mgmd(const int* year_array, int num, int year)
+{
+	/* index of the first management event of a single day in or after the given year */
+	int md = 0;
+
+	while (md < num && year_array[md] < year) md++;
+
+	return (md);
+}
+
+
+void resim_mgmdyear(int* mgmd, int year, const planting_struct* PLT, const thinning_struct* THN, const mowing_struct* MOW, 
+	                const harvesting_struct* HRV, const ploughing_struct* PLG, const fertilizing_struct* FRZ, const irrigating_struct* IRG, 
+					const mulching_struct* MUL, const CWDextract_struct* CWE, const groundwater_struct* GWS)
+{
+	/* position counters of the management events of a single day at the beginning of the given year (in the order of the
+	   snapshot; the counters of the grazing and flooding periods are not changed) */
+	if (PLT->PLT_num) mgmd[0]  = resim_mgmd(PLT->PLTyear_array, PLT->PLT_num, year);
+	if (THN->THN_num) mgmd[1]  = resim_mgmd(THN->THNyear_array, THN->THN_num, year);
+	if (MOW->MOW_num) mgmd[2]  = resim_mgmd(MOW->MOWyear_array, MOW->MOW_num, year);
+	if (HRV->HRV_num) mgmd[4]  = resim_mgmd(HRV->HRVyear_array, HRV->HRV_num, year);
+	if (PLG->PLG_num) mgmd[5]  = resim_mgmd(PLG->PLGyear_array, PLG->PLG_num, year);
+	if (FRZ->FRZ_num) mgmd[6]  = resim_mgmd(FRZ->FRZyear_array, FRZ->FRZ_num, year);
+	if (IRG->IRG_num) mgmd[7]  = resim_mgmd(IRG->IRGyear_array, IRG->IRG_num, year);
+	if (MUL->MUL_num) mgmd[8]  = resim_mgmd(MUL->MULyear_array, MUL->MUL_num, year);
+	if (CWE->CWE_num) mgmd[9]  = resim_mgmd(CWE->CWEyear_array, CWE->CWE_num, year);
+	if (GWS->GWD_num) mgmd[11] = resim_mgmd(GWS->GWyear_array, GWS->GWD_num, year);
+}
+
+
+int resim_restore(resim_struct* RSM, obscomp_struct* OBS, aggreg_struct* AGG, int* first_balance, control_struct* ctrl, 
+	              metvar_struct* metv, wstate_struct* ws, wflux_struct* wf, cinit_struct* cinit, cstate_struct* cs, cflux_struct* cf, 
+				  nstate_struct* ns, nflux_struct* nf, epvar_struct* epv, siteconst_struct* sitec, soilprop_struct* sprop, GWcalc_struct* gwc, 
+				  epconst_struct* epc, phenology_struct* phen, psn_struct* psn_sun, psn_struct* psn_shade, ntemp_struct* nt, summary_struct* summary,
+				  planting_struct* PLT, thinning_struct* THN, mowing_struct* MOW, grazing_struct* GRZ, harvesting_struct* HRV, ploughing_struct* PLG, 
+				  fertilizing_struct* FRZ, irrigating_struct* IRG, mulching_struct* MUL, CWDextract_struct* CWE, flooding_struct* FLD, groundwater_struct* GWS)
+{
+	/* the pointers of the stored control and EPC structures belong to the earlier run: they are kept from the actual structures,
+	   and so are the length of the simulation and the output settings; a scenario of the fork mode keeps its own management
+	   options, its own observation accumulators and its own EPC if it differs from the EPC of the common period */
+	int errorCode=0;
+	const resimstate_struct* state = RSM->state;
+	control_struct ctrl_act;
+	epconst_struct epc_act;
+	aggspec_struct* spec;
+	int ns_obs, ns_agg;
+	int mgmd[N_RESIMMGM];
+
+	if (state->simyr + 1 != RSM->start_simyr || RSM->start_simyr > ctrl->simyears)
+	{
+		printf("ERROR in snapshot of incremental re-simulation: year %i\n", state->simyr);
+		return (1);
+	}
+
+	ctrl_act = *ctrl;
+	*ctrl    = state->ctrl;
+	ctrl->simyears      = ctrl_act.simyears;
+	ctrl->onscreen      = ctrl_act.onscreen;
+	ctrl->read_restart  = ctrl_act.read_restart;
+	ctrl->write_restart = ctrl_act.write_restart;
+	ctrl->daycodes      = ctrl_act.daycodes;
+	ctrl->daynames      = ctrl_act.daynames;
+	ctrl->anncodes      = ctrl_act.anncodes;
+	ctrl->annnames      = ctrl_act.annnames;
+	ctrl->dodaily       = ctrl_act.dodaily;
+	ctrl->domonavg      = ctrl_act.domonavg;
+	ctrl->doannavg      = ctrl_act.doannavg;
+	ctrl->doannual      = ctrl_act.doannual;
+	ctrl->ndayout       = ctrl_act.ndayout;
+	ctrl->nannout       = ctrl_act.nannout;
+	ctrl->condMOW_flag  = ctrl_act.condMOW_flag;
+	ctrl->condIRG_flag  = ctrl_act.condIRG_flag;
+	ctrl->planttypeName = ctrl_act.planttypeName;
+
+	if (RSM->fork_flag == 2)
+	{
+		ctrl->GSI_flag    = ctrl_act.GSI_flag;
+		ctrl->varFM_flag  = ctrl_act.varFM_flag;
+		ctrl->varWPM_flag = ctrl_act.varWPM_flag;
+		ctrl->varMSC_flag = ctrl_act.varMSC_flag;
+		ctrl->varSGS_flag = ctrl_act.varSGS_flag;
+		ctrl->varEGS_flag = ctrl_act.varEGS_flag;
+	}
+	else
+	{
+		if (ctrl->planttypeName) strcpy(ctrl->planttypeName, state->planttypeName);
+
+		epc_act = *epc;
+		*epc    = state->epc;
+		epc->SGS_array   = epc_act.SGS_array;
+		epc->EGS_array   = epc_act.EGS_array;
+		epc->FMyr_array  = epc_act.FMyr_array;
+		epc->WPMyr_array = epc_act.WPMyr_array;
+		epc->MSC_array   = epc_act.MSC_array;
+	}
+
+	*first_balance = state->first_balance;
+	*metv          = state->metv;
+	*ws            = state->ws;
+	*wf            = state->wf;
+	*cinit         = state->cinit;
+	*cs            = state->cs;
+	*cf            = state->cf;
+	*ns            = state->ns;
+	*nf            = state->nf;
+	*epv           = state->epv;
+	*sitec         = state->sitec;
+	*sprop         = state->sprop;
+	*gwc           = state->gwc;
+	*phen          = state->phen;
+	*psn_sun       = state->psn_sun;
+	*psn_shade     = state->psn_shade;
+	*nt            = state->nt;
+	*summary       = state->summary;
+
+	/* a fork scenario may have its own management file: the events of a single day are counted from its own arrays
+	   (the grazing and flooding periods of the common period have to be the same as in the first run) */
+	memcpy(mgmd, state->mgmd, sizeof(mgmd));
+	if (RSM->fork_flag) resim_mgmdyear(mgmd, ctrl->simstartyear + RSM->start_simyr, PLT, THN, MOW, HRV, PLG, FRZ, IRG, MUL, CWE, GWS);
+
+	PLT->mgmdPLT = mgmd[0];
+	THN->mgmdTHN = mgmd[1];
+	MOW->mgmdMOW = mgmd[2];
+	GRZ->mgmdGRZ = mgmd[3];
+	HRV->mgmdHRV = mgmd[4];
+	PLG->mgmdPLG = mgmd[5];
+	FRZ->mgmdFRZ = mgmd[6];
+	IRG->mgmdIRG = mgmd[7];
+	MUL->mgmdMUL = mgmd[8];
+	CWE->mgmdCWE = mgmd[9];
+	FLD->mgmdFLD = mgmd[10];
+	GWS->mgmdGWD = mgmd[11];
+	GRZ->trampleff_act = state->trampleff_act;
+
+	/* comparison with observations: only the accumulators (the observation arrays belong to the actual run); the metrics
+	   of a fork scenario cover its own years, the observations of the common period are skipped by their dates */
+	for (ns_obs = 0; !RSM->fork_flag && ns_obs < OBS->nseries; ns_obs++)
+	{
+		OBS->series[ns_obs].mgmdOBS  = state->obs[ns_obs].mgmdOBS;
+		OBS->series[ns_obs].monsum   = state->obs[ns_obs].monsum;
+		OBS->series[ns_obs].n        = state->obs[ns_obs].n;
+		OBS->series[ns_obs].sum_res  = state->obs[ns_obs].sum_res;
+		OBS->series[ns_obs].sum_res2 = state->obs[ns_obs].sum_res2;
+		OBS->series[ns_obs].sum_sim  = state->obs[ns_obs].sum_sim;
+		OBS->series[ns_obs].mean_obs = state->obs[ns_obs].mean_obs;
+		OBS->series[ns_obs].M2_obs   = state->obs[ns_obs].M2_obs;
+	}
+
+	/* temporal aggregations: the actual windows (the settings are hashed in the key of the re-simulation, a fork scenario
+	   continues only the windows of unchanged aggregations) */
+	if (!RSM->fork_flag)
+		memcpy(AGG->spec, state->agg, N_AGGSPEC * sizeof(aggspec_struct));
+	else
+	{
+		for (ns_agg = 0; ns_agg < AGG->nspec; ns_agg++)
+		{
+			spec = &AGG->spec[ns_agg];
+			if (spec->outcode == state->agg[ns_agg].outcode && spec->func == state->agg[ns_agg].func && 
+				spec->threshold == state->agg[ns_agg].threshold && spec->window == state->agg[ns_agg].window && 
+				spec->start_mmdd == state->agg[ns_agg].start_mmdd && spec->end_mmdd == state->agg[ns_agg].end_mmdd &&
+				spec->cond_outcode == state->agg[ns_agg].cond_outcode && spec->cond_min == state->agg[ns_agg].cond_min && 
+				spec->cond_max == state->agg[ns_agg].cond_max)
+			{
+				spec->open       = state->agg[ns_agg].open;
+				spec->start_date = state->agg[ns_agg].start_date;
+				spec->end_date   = state->agg[ns_agg].end_date;
+				spec->ndays      = state->agg[ns_agg].ndays;
+				spec->value      = state->agg[ns_agg].value;
+			}
+		}
+	}
+
+	return (errorCode);
+}
@@ -0,0 +1,137 @@
+/*
+resim_init.c
+read the settings of the incremental re-simulation (snapshots of the normal run, continuation from the first changed input)
+if they are available
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_constants.h"
+#include "bgc_func.h"
+#include "bgc_io.h"
+
+
+int resim_init(resim_struct* RSM, const control_struct* ctrl)
+{
+	int errorCode=0;
+	file RSM_file;
+	char keyword[STRINGSIZE];
+
+	/* default values: no snapshots, the whole simulation is calculated */
+	RSM->flag        = 0;
+	RSM->interval    = 1;
+	RSM->start_simyr = 0;
+	RSM->diff_metday = -1;
+	RSM->key         = 0;
+	RSM->nmetdays    = 0;
+	RSM->dayhash     = 0;
+	RSM->daycheck    = 0;
+	RSM->state       = 0;
+	RSM->pack_mode   = STATEPACK_COMPACT;
+	RSM->pack_buffer = 0;
+	RSM->nsnap       = 0;
+	RSM->stop_simyr  = -1;
+	RSM->init_state  = 0;
+	RSM->fork_flag   = 0;
+	RSM->snap_file.ptr = 0;
+	strcpy(RSM->snap_file.name, "");
+
+	/********************************************************************
+	**                                                                 **
+	** Reading re-simulation options if available (only in normal run) **
+	**                                                                 **
+	********************************************************************/
+
+	if (ctrl->spinup != 0) return (errorCode);
+
+	strcpy(RSM_file.name, "resim_options.txt");
+	if (file_open(&RSM_file,'j',1)) return (errorCode);
+
+	/* the file consists of keyword-blocks, the order of the blocks is arbitrary */
+	while (!errorCode && !scan_array(RSM_file, keyword, 's', 1, 0))
+	{
+		/* INCREMENTAL block: flag, number of years between the snapshots */
+		if (!strcmp(keyword, "INCREMENTAL"))
+		{
+			if (!errorCode && scan_value(RSM_file, &RSM->flag, 'i'))
+			{
+				printf("ERROR reading incremental re-simulation flag: resim_init()\n");
+				errorCode=22201;
+			}
+			if (!errorCode && scan_value(RSM_file, &RSM->interval, 'i'))
+			{
+				printf("ERROR reading snapshot interval: resim_init()\n");
+				errorCode=22202;
+			}
+			if (!errorCode && RSM->flag != 0 && RSM->flag != 1)
+			{
+				printf("ERROR in resim_options.txt: incremental re-simulation flag must be 0 or 1\n");
+				errorCode=22203;
+			}
+			if (!errorCode && RSM->interval < 1)
+			{
+				printf("ERROR in resim_options.txt: snapshot interval must be at least 1 year\n");
+				errorCode=22204;
+			}
+		}
+		/* SNAPSHOT block: format of the snapshots (FULL, NOFLUX or COMPACT) */
+		else if (!strcmp(keyword, "SNAPSHOT"))
+		{
+			if (!errorCode && scan_value(RSM_file, keyword, 's'))
+			{
+				printf("ERROR reading format of the snapshots: resim_init()\n");
+				errorCode=22205;
+			}
+			if (!errorCode)
+			{
+				if (!strcmp(keyword, "FULL"))
+					RSM->pack_mode = STATEPACK_FULL;
+				else if (!strcmp(keyword, "NOFLUX"))
+					RSM->pack_mode = STATEPACK_NOFLUX;
+				else if (!strcmp(keyword, "COMPACT"))
+					RSM->pack_mode = STATEPACK_COMPACT;
+				else
+				{
+					printf("ERROR in resim_options.txt: unknown format of the snapshots --> %s\n", keyword);
+					errorCode=22206;
+				}
+			}
+		}
+		else
+		{
+			printf("ERROR in resim_options.txt: unknown keyword --> %s\n", keyword);
+			errorCode=222;
+		}
+	}
+
+	fclose(RSM_file.ptr);
+
+	return (errorCode);
+}
+
+
+int resim_backup(const char* filename)
+{
+	/* renaming the file of the earlier run (if it exists) to <filename>.resimbak */
+	int errorCode=0;
+	char bakname[FILENAMESIZE+16];
+
+	sprintf(bakname, "%s.resimbak", filename);
+	remove(bakname);
+	if (rename(filename, bakname)) errorCode=1;
+
+	return (errorCode);
+}
@@ -29,11 +29,18 @@ int restart_input(const control_struct* ctrl, const epconst_struct* epc, const s
 	int layer;
 	double soilw_sat;
 	
+	/* 0. the restart record must belong to a profile of the same number of soil layers (every layer of the profile
+	      of the writing run has soil water, the layers below it are empty) */
+	if (restart->soilw[sitec->n_soillayers-1] == 0 || (sitec->n_soillayers < N_SOILLAYERS && restart->soilw[sitec->n_soillayers] != 0))
+	{
+		printf("ERROR in restart data: the restart file was written with a different number of soil layers (%i in the soil file)\n", sitec->n_soillayers);
+		errorCode=1;
+	}
 	
 	/* 1. water: special case to initalize soil water from INI file - WSATE section (read_restart = 2) */
 	if (ctrl->read_restart == 1)
 	{
-		for (layer =0; layer < N_SOILLAYERS; layer++)
+		for (layer =0; layer < sitec->n_soillayers; layer++)
 		{ 
 			ws->soilw[layer]                  = restart->soilw[layer];
 			soilw_sat = sprop->VWCsat[layer] * sitec->soillayer_thickness[layer] * water_density;
@@ -202,7 +209,7 @@ int restart_input(const control_struct* ctrl, const epconst_struct* epc, const s
 	cs->litrc_above     = restart->litrc_above;
 	cs->cwdc_above      = restart->cwdc_above;
 
-	for (layer=0; layer < N_SOILLAYERS; layer++)
+	for (layer=0; layer < sitec->n_soillayers; layer++)
 	{
 		
  		cs->litr1c[layer]                 = restart->litr1c[layer];
@@ -26,7 +26,7 @@ See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentatio
 #define MIN(X, Y) (((X) < (Y)) ? (X) : (Y))
 #define MAX(X, Y) (((X) > (Y)) ? (X) : (Y))   
 
-int richards(const epconst_struct* epc, soilprop_struct* sprop, wstate_struct* ws, wflux_struct* wf, GWcalc_struct* gwc)
+int richards(const siteconst_struct* sitec, const epconst_struct* epc, soilprop_struct* sprop, wstate_struct* ws, wflux_struct* wf, GWcalc_struct* gwc)
 {
 
 	
@@ -79,7 +79,7 @@ int richards(const epconst_struct* epc, soilprop_struct* sprop, wstate_struct* w
 
 	wf->soilwEVP=0;
 
-	for (layer=0 ; layer < N_SOILLAYERS_GWC; layer++) 
+	for (layer=0 ; layer < sitec->n_soillayers+2; layer++) 
 	{
 		gwc->soilwTRPdemand_GWC[layer]     = wf->soilwTRP_POT * gwc->rootlengthProp_GWC[layer]; 
 		transpDEM[layer]                   = gwc->soilwTRPdemand_GWC[layer];
@@ -109,7 +109,7 @@ int richards(const epconst_struct* epc, soilprop_struct* sprop, wstate_struct* w
 
 		/* ----------------------------------------*/
 		/* 1. CALCULATE PROCESSES  LAYER TO LAYER */
-		for (layer=0 ; layer < N_SOILLAYERS_GWC; layer++)
+		for (layer=0 ; layer < sitec->n_soillayers+2; layer++)
 		{	
 			
 			/* -------------------*/
@@ -125,7 +125,7 @@ int richards(const epconst_struct* epc, soilprop_struct* sprop, wstate_struct* w
 
 			Ksat0 = gwc->hydrCONDUCTsat_GWC[layer];
 
-			if (layer < N_SOILLAYERS_GWC-1)
+			if (layer < sitec->n_soillayers+1)
 			{
 				dz1        = gwc->soillayer_thicknessGWC[layer+1];
 				VWC1       = gwc->VWC_GWC[layer+1];
@@ -191,7 +191,7 @@ int richards(const epconst_struct* epc, soilprop_struct* sprop, wstate_struct* w
 			/* 1.4. PERCOLATION */
 
 						
-			if (layer < N_SOILLAYERS_GWC-1)
+			if (layer < sitec->n_soillayers+1)
 			{
 				/* conductivity coefficient - theoretical upper limit: saturation value */
 				Kact0 = Ksat0 * pow(VWC0/VWCsat0, 2*(soilB0)+3);
@@ -211,7 +211,7 @@ int richards(const epconst_struct* epc, soilprop_struct* sprop, wstate_struct* w
 			/* 1.5. DIFFUSION */
 		
 	
-			if (layer < N_SOILLAYERS_GWC-1)
+			if (layer < sitec->n_soillayers+1)
 			{
 				/* diffusivity coefficient 	*/
 				D0 = (((soilB0    * Ksat0   * (-100*PSIsat0)))) * pow(VWC0/VWCsat0,  soilB0 +2);
@@ -323,7 +323,7 @@ int richards(const epconst_struct* epc, soilprop_struct* sprop, wstate_struct* w
 		
 		/* -------------------*/
 		/* 2.2 SOIL WATER CONTENT */
-		for (layer=0 ; layer < N_SOILLAYERS_GWC; layer++)
+		for (layer=0 ; layer < sitec->n_soillayers+2; layer++)
 		{
 			VWC0       = gwc->VWC_GWC[layer];
 			dz0        = gwc->soillayer_thicknessGWC[layer];
@@ -603,13 +603,13 @@ int richards(const epconst_struct* epc, soilprop_struct* sprop, wstate_struct* w
 		{
 			INFILT_act = INFILT/(nSEC_IN_DAY-n_second) * n_sec; 
 			EVP_act = EVP_sum/(nSEC_IN_DAY-n_second) * n_sec;
-			for (layer=0 ; layer < N_SOILLAYERS_GWC; layer++) transpDEM_act[layer] = transpDEM[layer]/(nSEC_IN_DAY-n_second) * n_sec;
+			for (layer=0 ; layer < sitec->n_soillayers+2; layer++) transpDEM_act[layer] = transpDEM[layer]/(nSEC_IN_DAY-n_second) * n_sec;
 		}
 		else
 		{
 			INFILT_act = 0;
 			EVP_act = 0;
-			for (layer=0 ; layer < N_SOILLAYERS_GWC; layer++) transpDEM_act[layer] = 0;
+			for (layer=0 ; layer < sitec->n_soillayers+2; layer++) transpDEM_act[layer] = 0;
 
 			/* pond water formation from the non-infiltrated water */
 			if (INFILT_sum - INFILT_ctrl > 0)
@@ -678,7 +678,7 @@ int richards(const epconst_struct* epc, soilprop_struct* sprop, wstate_struct* w
 	/* 2. control of transpiration */
 
 	wf->soilwTRP_SUM = 0;
-	for (layer=0 ; layer < N_SOILLAYERS_GWC-1; layer++)
+	for (layer=0 ; layer < sitec->n_soillayers+1; layer++)
 	{
 		wf->soilwTRP_SUM               += gwc->soilwTRP_GWC[layer];
 		gwc->soilwTRPdemand_GWC[layer]  = wf->soilwTRP_POT * gwc->rootlengthProp_GWC[layer]; 
@@ -689,7 +689,7 @@ int richards(const epconst_struct* epc, soilprop_struct* sprop, wstate_struct* w
 		diff = wf->soilwTRP_SUM - wf->soilwTRP_POT;
 		if (diff < CRIT_PRECwater)
 		{
-			for (layer=0 ; layer < N_SOILLAYERS_GWC-1; layer++) 
+			for (layer=0 ; layer < sitec->n_soillayers+1; layer++) 
 			{
 				gwc->soilwTRP_GWC[layer] *= (wf->soilwTRP_POT - diff)/wf->soilwTRP_POT;
 				TRP_ctrl                 -= diff;
@@ -724,15 +724,15 @@ int richards(const epconst_struct* epc, soilprop_struct* sprop, wstate_struct* w
 
 
 	/* BOTTOM LAYER IS SPECIAL */
-	if (gwc->HYDROflag[N_SOILLAYERS_GWC-1] == 0)
-		diff = gwc->soilw_GWC[N_SOILLAYERS_GWC-1] - gwc->VWCfc_GWC[N_SOILLAYERS_GWC-1]* gwc->soillayer_thicknessGWC[N_SOILLAYERS_GWC-1] * water_density;
+	if (gwc->HYDROflag[sitec->n_soillayers+1] == 0)
+		diff = gwc->soilw_GWC[sitec->n_soillayers+1] - gwc->VWCfc_GWC[sitec->n_soillayers+1]* gwc->soillayer_thicknessGWC[sitec->n_soillayers+1] * water_density;
 	else
-		diff = gwc->soilw_GWC[N_SOILLAYERS_GWC-1] - gwc->VWCsat_GWC[N_SOILLAYERS_GWC-1]* gwc->soillayer_thicknessGWC[N_SOILLAYERS_GWC-1] * water_density;
+		diff = gwc->soilw_GWC[sitec->n_soillayers+1] - gwc->VWCsat_GWC[sitec->n_soillayers+1]* gwc->soillayer_thicknessGWC[sitec->n_soillayers+1] * water_density;
 	if (fabs(diff) > 0)
 	{
-		gwc->soilwFlux_GWC[N_SOILLAYERS_GWC-1]  = diff;
-		gwc->soilw_GWC[N_SOILLAYERS_GWC-1] -= diff;
-		gwc->VWC_GWC[N_SOILLAYERS_GWC-1] = gwc->soilw_GWC[N_SOILLAYERS_GWC-1] / (water_density * gwc->soillayer_thicknessGWC[layer]);
+		gwc->soilwFlux_GWC[sitec->n_soillayers+1]  = diff;
+		gwc->soilw_GWC[sitec->n_soillayers+1] -= diff;
+		gwc->VWC_GWC[sitec->n_soillayers+1] = gwc->soilw_GWC[sitec->n_soillayers+1] / (water_density * gwc->soillayer_thicknessGWC[layer]);
 	}
 	
 
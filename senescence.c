@@ -411,7 +411,7 @@ int senescence(const siteconst_struct *sitec, const epconst_struct* epc, const g
 	
 	if (epv->rootDepth > CRIT_PREC)
 	{
-		for (layer=0; layer < N_SOILLAYERS; layer++)
+		for (layer=0; layer < sitec->n_soillayers; layer++)
 		{
 			cs->litr1c[layer]  += cf->STDBc_froot_to_litr * epc->frootlitr_flab  * epv->rootlengthProp[layer];
 			cs->litr2c[layer]  += cf->STDBc_froot_to_litr * epc->frootlitr_fucel * epv->rootlengthProp[layer];
@@ -426,7 +426,7 @@ int senescence(const siteconst_struct *sitec, const epconst_struct* epc, const g
 	}
 	else
 	{
-		for (layer=0; layer < N_SOILLAYERS; layer++)
+		for (layer=0; layer < sitec->n_soillayers; layer++)
 		{
 			cs->litr1c[layer]  += cf->STDBc_froot_to_litr * epc->frootlitr_flab  * epv->rootlengthLandD_prop[layer];
 			cs->litr2c[layer]  += cf->STDBc_froot_to_litr * epc->frootlitr_fucel * epv->rootlengthLandD_prop[layer];
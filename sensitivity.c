@@ -0,0 +1,664 @@
+/*
+sensitivity.c
+global sensitivity analysis: Morris screening (elementary effects) and Sobol variance decomposition (first and
+total-order indices) of selected output variables to parameters of the EPC and soil files; the sample design is
+generated and evaluated in parallel by in-process runs of the init files (the parameter values are given to the
+runs as in-memory EPC and soil files). The runs whose parameters differ only in values irrelevant to the spinup
+start from one common spun-up state. Only the index tables are written.
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_constants.h"
+#include "bgc_io.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+static const char* sensitivity_filename[2] = {"EPC", "SOIL"};
+
+/* run of the sensitivity analysis in the calling thread (NULL: ordinary run) */
+static senssample_struct* sensitivity_actual = NULL;
+#pragma omp threadprivate(sensitivity_actual)
+
+/* spun-up state of a run: hash of the values of the parameters influencing the spinup */
+typedef struct
+{
+	unsigned long long key;
+	unsigned long long check;
+	int run;
+} sensgroup_struct;
+
+
+senssample_struct* sensitivity_sample(void)
+{
+	return (sensitivity_actual);
+}
+
+
+int sensitivity_select(senssample_struct* sample)
+{
+	/* output variables and spun-up state of the runs of the calling thread (used also by the regional run) */
+	sensitivity_actual = sample;
+
+	return (0);
+}
+
+
+int sensitivity_update(senssample_struct* sample, const control_struct* ctrl, double** output_map)
+{
+	/* the outputs are read directly from the output map (the runs of the analysis have no output files) */
+	int errorCode=0;
+	int no;
+
+	for (no = 0; !errorCode && no < sample->nout; no++)
+	{
+		if (output_map[sample->outcode[no]] == NULL)
+		{
+			printf("ERROR in sensitivity file: output variable %i is not available (not part of the soil profile of the run)\n", sample->outcode[no]);
+			errorCode=1;
+		}
+		else if (sample->outmode[no] == 0 ||
+			     (sample->outmode[no] == 1 && ctrl->yday == nDAYS_OF_YEAR-1) ||
+				 (sample->outmode[no] == 2 && ctrl->yday == nDAYS_OF_YEAR-1 && ctrl->simyr == ctrl->simyears-1))
+		{
+			sample->objective[no] += *(output_map[sample->outcode[no]]);
+		}
+	}
+
+	return (errorCode);
+}
+
+
+/* pseudo-random numbers of the sample design (splitmix64), uniform in [0,1) */
+static double sensitivity_random(unsigned long long* state)
+{
+	unsigned long long z;
+
+	*state += 0x9E3779B97F4A7C15ULL;
+	z = *state;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z ^= z >> 31;
+
+	return ((double) (z >> 11) / 9007199254740992.0);
+}
+
+
+static int sensitivity_design(sensitivity_struct* SEN)
+{
+	/* parameter values scaled to the ranges (0: minimum, 1: maximum);
+	   Morris: trajectories of npar+1 points on the grid of nlevel levels, one parameter changes by delta in each step;
+	   Sobol: matrices A and B of independent samples and the matrices AB_i (A with column i of B) */
+	int k = SEN->npar;
+	int nt, ns, np, nm, nhalf, tmp;
+	int perm[N_SENSPAR];
+	double dir[N_SENSPAR];
+	double delta;
+	double* row;
+	unsigned long long state = (unsigned long long) SEN->seed;
+
+	if (SEN->method == SENS_MORRIS)
+		SEN->nrun = SEN->nsample * (k + 1);
+	else
+		SEN->nrun = SEN->nsample * (k + 2);
+
+	SEN->design = (double*) malloc((size_t) SEN->nrun * k * sizeof(double));
+	if (!SEN->design)
+	{
+		printf("ERROR allocating for sample design, sensitivity_design()\n");
+		return (1);
+	}
+
+	if (SEN->method == SENS_MORRIS)
+	{
+		delta = SEN->nlevel / (2.0 * (SEN->nlevel - 1));
+		nhalf = SEN->nlevel / 2;
+		for (nt = 0; nt < SEN->nsample; nt++)
+		{
+			/* base point on the lower half of the grid, direction of the steps and random order of the parameters */
+			row = SEN->design + (size_t) nt * (k + 1) * k;
+			for (np = 0; np < k; np++)
+			{
+				dir[np]  = (sensitivity_random(&state) < 0.5) ? -1 : 1;
+				row[np]  = (int) (sensitivity_random(&state) * nhalf) / (double) (SEN->nlevel - 1);
+				if (dir[np] < 0) row[np] += delta;
+				perm[np] = np;
+			}
+			for (np = k-1; np > 0; np--)
+			{
+				nm       = (int) (sensitivity_random(&state) * (np + 1));
+				tmp      = perm[np];
+				perm[np] = perm[nm];
+				perm[nm] = tmp;
+			}
+			for (nm = 1; nm <= k; nm++)
+			{
+				memcpy(row + k, row, k * sizeof(double));
+				row += k;
+				row[perm[nm-1]] += dir[perm[nm-1]] * delta;
+			}
+		}
+	}
+	else
+	{
+		for (ns = 0; ns < 2 * SEN->nsample; ns++)
+		{
+			row = SEN->design + (size_t) ns * k;
+			for (np = 0; np < k; np++) row[np] = sensitivity_random(&state);
+		}
+		for (np = 0; np < k; np++)
+		{
+			for (ns = 0; ns < SEN->nsample; ns++)
+			{
+				row = SEN->design + ((size_t) (2 + np) * SEN->nsample + ns) * k;
+				memcpy(row, SEN->design + (size_t) ns * k, k * sizeof(double));
+				row[np] = SEN->design[((size_t) SEN->nsample + ns) * k + np];
+			}
+		}
+	}
+
+	return (0);
+}
+
+
+static int sensitivity_groupcmp(const void* a, const void* b)
+{
+	const sensgroup_struct* ga = (const sensgroup_struct*) a;
+	const sensgroup_struct* gb = (const sensgroup_struct*) b;
+
+	if (ga->key != gb->key) return (ga->key < gb->key ? -1 : 1);
+	if (ga->check != gb->check) return (ga->check < gb->check ? -1 : 1);
+
+	return (ga->run - gb->run);
+}
+
+
+static int sensitivity_groups(sensitivity_struct* SEN)
+{
+	/* the runs with the same values of the parameters influencing the spinup share one spun-up state */
+	int nr, np;
+	sensgroup_struct* grp;
+	const double* row;
+
+	grp        = (sensgroup_struct*) malloc(SEN->nrun * sizeof(sensgroup_struct));
+	SEN->group = (int*) malloc(SEN->nrun * sizeof(int));
+	if (!grp || !SEN->group)
+	{
+		printf("ERROR allocating for spun-up states, sensitivity_groups()\n");
+		free(grp);
+		return (1);
+	}
+
+	for (nr = 0; nr < SEN->nrun; nr++)
+	{
+		row = SEN->design + (size_t) nr * SEN->npar;
+		grp[nr].key   = 0xCBF29CE484222325ULL;
+		grp[nr].check = 0x84222325CBF29CE4ULL;
+		grp[nr].run   = nr;
+		for (np = 0; np < SEN->npar; np++)
+		{
+			if (SEN->par[np].spinup) hash_bytes(&grp[nr].key, &grp[nr].check, &row[np], sizeof(double));
+		}
+	}
+
+	qsort(grp, SEN->nrun, sizeof(sensgroup_struct), sensitivity_groupcmp);
+
+	SEN->ngroup = 0;
+	for (nr = 0; nr < SEN->nrun; nr++)
+	{
+		if (nr == 0 || grp[nr].key != grp[nr-1].key || grp[nr].check != grp[nr-1].check) SEN->ngroup += 1;
+		SEN->group[grp[nr].run] = SEN->ngroup - 1;
+	}
+
+	free(grp);
+
+	/* without spinup run all runs start from the restart file of the normal run */
+	if (SEN->spinup_ini[0] == '\0') return (0);
+
+	SEN->snapshot = (restart_data_struct*) calloc(SEN->ngroup, sizeof(restart_data_struct));
+	if (!SEN->snapshot)
+	{
+		printf("ERROR allocating for spun-up states, sensitivity_groups()\n");
+		return (1);
+	}
+
+	return (0);
+}
+
+
+static int sensitivity_text(const sensitivity_struct* SEN, int nf, const double* row, int spinup, char** text, size_t* size)
+{
+	/* contents of the EPC or soil file with the parameter values of the run (spinup run: only the parameters influencing
+	   the spinup, the others keep the values of the file); the replaced values are the whitespace-delimited words at the
+	   line and column of the parameters. Returns 1 if a position is not found in the file */
+	int errorCode=0;
+	int np, line, column, found, nfound=0, nused=0;
+	size_t pos, out;
+	const char* src = SEN->text[nf];
+	char* dst;
+	char value[STRINGSIZE];
+
+	for (np = 0; np < SEN->npar; np++)
+	{
+		if (SEN->par[np].file == nf && (!spinup || SEN->par[np].spinup)) nused++;
+	}
+
+	*text = (char*) malloc(SEN->size[nf] + (size_t) nused * 32 + 1);
+	if (!*text)
+	{
+		printf("ERROR allocating for %s file of the run, sensitivity_text()\n", sensitivity_filename[nf]);
+		return (1);
+	}
+	dst = *text;
+
+	pos    = 0;
+	out    = 0;
+	line   = 1;
+	column = 0;
+	while (pos < SEN->size[nf])
+	{
+		if (src[pos] == '\n')
+		{
+			line  += 1;
+			column = 0;
+			dst[out++] = src[pos++];
+		}
+		else if (src[pos] == ' ' || src[pos] == '\t' || src[pos] == '\r')
+			dst[out++] = src[pos++];
+		else
+		{
+			/* beginning of a word */
+			column += 1;
+			found = -1;
+			for (np = 0; found < 0 && np < SEN->npar; np++)
+			{
+				if (SEN->par[np].file == nf && (!spinup || SEN->par[np].spinup) && SEN->par[np].line == line && SEN->par[np].column == column)
+					found = np;
+			}
+			if (found >= 0)
+			{
+				sprintf(value, "%.10g", SEN->par[found].min + row[found] * (SEN->par[found].max - SEN->par[found].min));
+				memcpy(dst + out, value, strlen(value));
+				out += strlen(value);
+				nfound++;
+				while (pos < SEN->size[nf] && src[pos] != ' ' && src[pos] != '\t' && src[pos] != '\r' && src[pos] != '\n') pos++;
+			}
+			else
+			{
+				while (pos < SEN->size[nf] && src[pos] != ' ' && src[pos] != '\t' && src[pos] != '\r' && src[pos] != '\n') dst[out++] = src[pos++];
+			}
+		}
+	}
+
+	if (nfound != nused)
+	{
+		printf("ERROR in sensitivity file: position of a parameter is not found in the %s file\n", sensitivity_filename[nf]);
+		free(*text);
+		*text = NULL;
+		errorCode=1;
+	}
+
+	*size = out;
+
+	return (errorCode);
+}
+
+
+static int sensitivity_load(sensitivity_struct* SEN)
+{
+	/* contents of the EPC and soil files of the parameters, the positions of the parameters are checked */
+	int errorCode=0;
+	int nf;
+	long size;
+	size_t nbytes;
+	char* text;
+	double* row;
+	file in;
+
+	for (nf = 0; !errorCode && nf < 2; nf++)
+	{
+		strcpy(in.name, nf ? SEN->soil_file : SEN->epc_file);
+		if (in.name[0] == '\0') continue;
+
+		if (file_open(&in,'r',1))
+		{
+			printf("ERROR opening %s file of the parameters: %s\n", sensitivity_filename[nf], in.name);
+			errorCode=1;
+			break;
+		}
+		fseek(in.ptr, 0, SEEK_END);
+		size = ftell(in.ptr);
+		rewind(in.ptr);
+		if (size > 0) SEN->text[nf] = (char*) malloc((size_t) size);
+		if (size <= 0 || !SEN->text[nf] || fread(SEN->text[nf], 1, (size_t) size, in.ptr) != (size_t) size)
+		{
+			printf("ERROR reading %s file of the parameters: %s\n", sensitivity_filename[nf], in.name);
+			errorCode=1;
+		}
+		else
+			SEN->size[nf] = (size_t) size;
+		fclose(in.ptr);
+	}
+
+	row = (double*) calloc(SEN->npar, sizeof(double));
+	if (!errorCode && !row)
+	{
+		printf("ERROR allocating for parameter values, sensitivity_load()\n");
+		errorCode=1;
+	}
+	for (nf = 0; !errorCode && nf < 2; nf++)
+	{
+		if (!SEN->text[nf]) continue;
+		errorCode = sensitivity_text(SEN, nf, row, 0, &text, &nbytes);
+		if (!errorCode) free(text);
+	}
+	free(row);
+
+	return (errorCode);
+}
+
+
+static int sensitivity_eval(const sensitivity_struct* SEN, const char* ininame, const char* systime, int nr, int spinup, senssample_struct* sample)
+{
+	/* one run of the init file with the parameter values of design row nr: the modified EPC and soil files are registered
+	   in memory under their own names, which replace the names of the files in the init files of the calling thread */
+	int errorCode=0;
+	int nf, np, nsubst=0, nused;
+	char subst_from[2][FILENAMESIZE];
+	char subst_to[2][FILENAMESIZE];
+	char* text;
+	size_t size;
+	const double* row = SEN->design + (size_t) nr * SEN->npar;
+
+	for (nf = 0; !errorCode && nf < 2; nf++)
+	{
+		nused = 0;
+		for (np = 0; np < SEN->npar; np++)
+		{
+			if (SEN->par[np].file == nf && (!spinup || SEN->par[np].spinup)) nused++;
+		}
+		if (!nused) continue;
+
+		strcpy(subst_from[nsubst], nf ? SEN->soil_file : SEN->epc_file);
+		if (strlen(subst_from[nsubst]) + 16 >= FILENAMESIZE)
+		{
+			printf("ERROR in sensitivity file: too long name of %s file\n", sensitivity_filename[nf]);
+			errorCode=1;
+		}
+		else
+			sprintf(subst_to[nsubst], "%s#%c%i", subst_from[nsubst], spinup ? 'g' : 'r', nr);
+
+		if (!errorCode) errorCode = sensitivity_text(SEN, nf, row, spinup, &text, &size);
+		if (!errorCode)
+		{
+			errorCode = input_buffer_register(subst_to[nsubst], text, size);
+			free(text);
+		}
+		if (!errorCode) nsubst++;
+	}
+
+	if (!errorCode)
+	{
+		file_substitution(nsubst, subst_from, subst_to);
+		file_discard(1);
+		sensitivity_actual = sample;
+
+		errorCode = pointbgc_run(ininame, systime, NULL, -1, NULL);
+
+		sensitivity_actual = NULL;
+		file_discard(0);
+		file_substitution(0, NULL, NULL);
+	}
+
+	for (nf = 0; nf < nsubst; nf++) input_buffer_release(subst_to[nf]);
+
+	return (errorCode);
+}
+
+
+static int sensitivity_report(const sensitivity_struct* SEN)
+{
+	/* Morris: mean, mean of absolute values and standard deviation of the elementary effects (parameters scaled to their ranges);
+	   Sobol: first-order (Saltelli 2010) and total-order (Jansen 1999) indices */
+	int errorCode=0;
+	int k = SEN->npar;
+	int no, np, nt, ns, nm, nr, r = SEN->nsample, N = SEN->nsample;
+	double ee, sum, sumabs, sumsq, mu, var, mean, fA, fB, fAB, first, total;
+	const double* row;
+	file REP_file;
+
+	strcpy(REP_file.name, SEN->report_file);
+	if (file_open(&REP_file,'o',1))
+	{
+		printf("ERROR opening report file of sensitivity analysis: %s\n", SEN->report_file);
+		return (1);
+	}
+
+	fprintf(REP_file.ptr, "GLOBAL SENSITIVITY ANALYSIS: %s\n", SEN->method == SENS_MORRIS ? "MORRIS ELEMENTARY EFFECTS" : "SOBOL INDICES");
+	fprintf(REP_file.ptr, "number of parameters:             %12i\n", k);
+	fprintf(REP_file.ptr, "number of %s:           %12i\n", SEN->method == SENS_MORRIS ? "trajectories" : "base samples", SEN->nsample);
+	if (SEN->method == SENS_MORRIS) fprintf(REP_file.ptr, "number of levels:                 %12i\n", SEN->nlevel);
+	fprintf(REP_file.ptr, "number of runs:                   %12i\n", SEN->nrun);
+	fprintf(REP_file.ptr, "number of spinup runs:            %12i\n", SEN->spinup_ini[0] ? SEN->ngroup : 0);
+	fprintf(REP_file.ptr, " \n");
+
+	if (SEN->method == SENS_MORRIS)
+	{
+		/* the elementary effect of the step of a trajectory belongs to the only parameter changed in the step */
+		fprintf(REP_file.ptr, "%8s %8s %-24s %14s %14s %14s\n", "outcode", "mode", "parameter", "mu", "mu_star", "sigma");
+		for (no = 0; no < SEN->nout; no++)
+		{
+			for (np = 0; np < k; np++)
+			{
+				sum = sumabs = sumsq = 0;
+				for (nt = 0; nt < r; nt++)
+				{
+					for (nm = 1; nm <= k; nm++)
+					{
+						nr  = nt * (k + 1) + nm;
+						row = SEN->design + (size_t) nr * k;
+						if (row[np] == row[np - k]) continue;
+						ee = (SEN->result[(size_t) nr * SEN->nout + no] - SEN->result[(size_t) (nr-1) * SEN->nout + no]) / (row[np] - row[np - k]);
+						sum    += ee;
+						sumabs += fabs(ee);
+						sumsq  += ee * ee;
+					}
+				}
+				mu  = sum / r;
+				var = (sumsq - r * mu * mu) / (r - 1);
+				fprintf(REP_file.ptr, "%8i %8i %-24s %14.6e %14.6e %14.6e\n", SEN->outcode[no], SEN->outmode[no], SEN->par[np].name,
+					    mu, sumabs / r, var > 0 ? sqrt(var) : 0);
+			}
+		}
+	}
+	else
+	{
+		fprintf(REP_file.ptr, "%8s %8s %-24s %14s %14s %14s %14s\n", "outcode", "mode", "parameter", "first_order", "total_order", "mean", "variance");
+		for (no = 0; no < SEN->nout; no++)
+		{
+			/* mean and variance of the outputs of the independent samples (A and B) */
+			sum = sumsq = 0;
+			for (ns = 0; ns < 2 * N; ns++)
+			{
+				sum   += SEN->result[(size_t) ns * SEN->nout + no];
+				sumsq += SEN->result[(size_t) ns * SEN->nout + no] * SEN->result[(size_t) ns * SEN->nout + no];
+			}
+			mean = sum / (2 * N);
+			var  = sumsq / (2 * N) - mean * mean;
+
+			for (np = 0; np < k; np++)
+			{
+				first = total = 0;
+				for (ns = 0; ns < N; ns++)
+				{
+					fA  = SEN->result[(size_t) ns * SEN->nout + no];
+					fB  = SEN->result[((size_t) N + ns) * SEN->nout + no];
+					fAB = SEN->result[((size_t) (2 + np) * N + ns) * SEN->nout + no];
+					first += fB * (fAB - fA);
+					total += (fA - fAB) * (fA - fAB);
+				}
+				if (var > 0)
+				{
+					first = first / N / var;
+					total = total / (2 * N) / var;
+				}
+				else
+				{
+					first = DATA_GAP;
+					total = DATA_GAP;
+				}
+				fprintf(REP_file.ptr, "%8i %8i %-24s %14.6e %14.6e %14.6e %14.6e\n", SEN->outcode[no], SEN->outmode[no], SEN->par[np].name,
+					    first, total, mean, var);
+			}
+		}
+	}
+
+	if (ferror(REP_file.ptr)) errorCode=1;
+	fclose(REP_file.ptr);
+
+	return (errorCode);
+}
+
+
+int sensitivity_run(const char* sensname, const char* systime)
+{
+	/* the spinup runs of the different spun-up states are run first (in parallel), then the runs of the design */
+	int errorCode=0;
+	int ng, nr, nfirst, failed=-1;
+	int* first_run = NULL;
+	senssample_struct sample;
+	sensitivity_struct SEN;
+
+	errorCode = sensitivity_init(sensname, &SEN);
+	if (errorCode)
+	{
+		printf("ERROR in call to sensitivity_init() from sensitivity.c... Exiting\n");
+		writeErrorCode(errorCode);
+		return (errorCode);
+	}
+
+	if (!errorCode && sensitivity_load(&SEN))
+	{
+		printf("ERROR in call to sensitivity_load() from sensitivity.c\n");
+		errorCode=421;
+	}
+
+	if (!errorCode && sensitivity_design(&SEN))
+	{
+		printf("ERROR in call to sensitivity_design() from sensitivity.c\n");
+		errorCode=421;
+	}
+
+	if (!errorCode && sensitivity_groups(&SEN))
+	{
+		printf("ERROR in call to sensitivity_groups() from sensitivity.c\n");
+		errorCode=421;
+	}
+
+	if (!errorCode)
+	{
+		SEN.result = (double*) calloc((size_t) SEN.nrun * SEN.nout, sizeof(double));
+		first_run  = (int*) malloc(SEN.ngroup * sizeof(int));
+		if (!SEN.result || !first_run)
+		{
+			printf("ERROR allocating for outputs of the runs, sensitivity_run()\n");
+			errorCode=421;
+		}
+	}
+
+#ifdef _OPENMP
+	if (SEN.nthreads > 0) omp_set_num_threads(SEN.nthreads);
+#endif
+
+	if (!errorCode) printf("SENSITIVITY ANALYSIS: %i runs, %i spinup runs\n", SEN.nrun, SEN.spinup_ini[0] ? SEN.ngroup : 0);
+
+	/* spinup runs: the parameters influencing the spinup have the values of the first run of the group */
+	if (!errorCode && SEN.spinup_ini[0])
+	{
+		for (ng = 0; ng < SEN.ngroup; ng++) first_run[ng] = -1;
+		for (nr = SEN.nrun-1; nr >= 0; nr--) first_run[SEN.group[nr]] = nr;
+
+		#pragma omp parallel for schedule(dynamic,1) private(sample, nfirst)
+		for (ng = 0; ng < SEN.ngroup; ng++)
+		{
+			nfirst = first_run[ng];
+			memset(&sample, 0, sizeof(senssample_struct));
+			sample.snapshot = &SEN.snapshot[ng];
+			if (sensitivity_eval(&SEN, SEN.spinup_ini, systime, nfirst, 1, &sample))
+			{
+				#pragma omp critical (sensitivity)
+				{
+					if (failed < 0 || nfirst < failed) failed = nfirst;
+				}
+			}
+		}
+
+		if (failed >= 0)
+		{
+			printf("ERROR in spinup run of the sensitivity analysis (parameters of run %i)\n", failed+1);
+			errorCode=422;
+		}
+	}
+
+	/* runs of the design from the spun-up state of their group */
+	if (!errorCode)
+	{
+		#pragma omp parallel for schedule(dynamic,1) private(sample)
+		for (nr = 0; nr < SEN.nrun; nr++)
+		{
+			memset(&sample, 0, sizeof(senssample_struct));
+			sample.nout     = SEN.nout;
+			sample.outcode  = SEN.outcode;
+			sample.outmode  = SEN.outmode;
+			sample.snapshot = SEN.snapshot ? &SEN.snapshot[SEN.group[nr]] : NULL;
+			if (sensitivity_eval(&SEN, SEN.normal_ini, systime, nr, 0, &sample))
+			{
+				#pragma omp critical (sensitivity)
+				{
+					if (failed < 0 || nr < failed) failed = nr;
+				}
+			}
+			else
+				memcpy(SEN.result + (size_t) nr * SEN.nout, sample.objective, SEN.nout * sizeof(double));
+		}
+
+		if (failed >= 0)
+		{
+			printf("ERROR in run %i of the sensitivity analysis\n", failed+1);
+			errorCode=423;
+		}
+	}
+
+	if (!errorCode && sensitivity_report(&SEN))
+	{
+		printf("ERROR in call to sensitivity_report() from sensitivity.c\n");
+		errorCode=424;
+	}
+
+	if (errorCode) writeErrorCode(errorCode);
+
+	free(first_run);
+	free(SEN.design);
+	free(SEN.group);
+	free(SEN.snapshot);
+	free(SEN.result);
+	free(SEN.text[0]);
+	free(SEN.text[1]);
+
+	return (errorCode);
+}
+
@@ -0,0 +1,290 @@
+/*
+sensitivity_init.c
+read the settings of the global sensitivity analysis (method, sample size, init files, parameters with their ranges,
+output variables)
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "bgc_func.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_constants.h"
+#include "bgc_io.h"
+
+
+int sensitivity_init(const char* sensname, sensitivity_struct* SEN)
+{
+	int errorCode=0;
+	int np, nq;
+	file SEN_file;
+	char keyword[STRINGSIZE];
+	char name[STRINGSIZE];
+	senspar_struct* par;
+
+	/* default values: Morris screening with 4 levels, report file: <sensitivity file>.indices */
+	memset(SEN, 0, sizeof(sensitivity_struct));
+	SEN->method = SENS_MORRIS;
+	SEN->nlevel = 4;
+	SEN->seed   = 1;
+	strcpy(SEN->report_file, sensname);
+	strcat(SEN->report_file, ".indices");
+
+	strcpy(SEN_file.name, sensname);
+	if (file_open(&SEN_file,'i',1))
+	{
+		printf("ERROR opening sensitivity file: %s\n", sensname);
+		return (226);
+	}
+
+	/* the file consists of keyword-blocks, the order of the blocks is arbitrary */
+	while (!errorCode && !scan_array(SEN_file, keyword, 's', 1, 0))
+	{
+		/* METHOD block: MORRIS (elementary effects) or SOBOL (first and total-order indices) */
+		if (!strcmp(keyword, "METHOD"))
+		{
+			if (!errorCode && scan_value(SEN_file, name, 's'))
+			{
+				printf("ERROR reading method: sensitivity_init()\n");
+				errorCode=22601;
+			}
+			if (!errorCode)
+			{
+				if (!strcmp(name, "MORRIS"))
+					SEN->method = SENS_MORRIS;
+				else if (!strcmp(name, "SOBOL"))
+					SEN->method = SENS_SOBOL;
+				else
+				{
+					printf("ERROR in sensitivity file: unknown method --> %s\n", name);
+					errorCode=22601;
+				}
+			}
+		}
+		/* SAMPLES block: number of trajectories (Morris) or base samples (Sobol) */
+		else if (!strcmp(keyword, "SAMPLES"))
+		{
+			if (!errorCode && scan_value(SEN_file, &SEN->nsample, 'i'))
+			{
+				printf("ERROR reading number of samples: sensitivity_init()\n");
+				errorCode=22602;
+			}
+		}
+		/* LEVELS block: number of levels of the Morris grid */
+		else if (!strcmp(keyword, "LEVELS"))
+		{
+			if (!errorCode && scan_value(SEN_file, &SEN->nlevel, 'i'))
+			{
+				printf("ERROR reading number of levels: sensitivity_init()\n");
+				errorCode=22603;
+			}
+		}
+		/* SEED block: seed of the random sample design */
+		else if (!strcmp(keyword, "SEED"))
+		{
+			if (!errorCode && scan_value(SEN_file, &SEN->seed, 'i'))
+			{
+				printf("ERROR reading seed: sensitivity_init()\n");
+				errorCode=22604;
+			}
+		}
+		/* THREADS block: number of parallel runs (0: all available processors) */
+		else if (!strcmp(keyword, "THREADS"))
+		{
+			if (!errorCode && scan_value(SEN_file, &SEN->nthreads, 'i'))
+			{
+				printf("ERROR reading number of threads: sensitivity_init()\n");
+				errorCode=22605;
+			}
+		}
+		/* SPINUP block: main init file of the spinup run (without it the runs start from the restart file of the normal run) */
+		else if (!strcmp(keyword, "SPINUP"))
+		{
+			if (!errorCode && scan_value(SEN_file, SEN->spinup_ini, 's'))
+			{
+				printf("ERROR reading init file of spinup run: sensitivity_init()\n");
+				errorCode=22606;
+			}
+		}
+		/* NORMAL block: main init file of the normal run */
+		else if (!strcmp(keyword, "NORMAL"))
+		{
+			if (!errorCode && scan_value(SEN_file, SEN->normal_ini, 's'))
+			{
+				printf("ERROR reading init file of normal run: sensitivity_init()\n");
+				errorCode=22606;
+			}
+		}
+		/* EPC and SOIL blocks: names of the EPC and soil files as they are given in the init files */
+		else if (!strcmp(keyword, "EPC"))
+		{
+			if (!errorCode && scan_value(SEN_file, SEN->epc_file, 's'))
+			{
+				printf("ERROR reading name of EPC file: sensitivity_init()\n");
+				errorCode=22607;
+			}
+		}
+		else if (!strcmp(keyword, "SOIL"))
+		{
+			if (!errorCode && scan_value(SEN_file, SEN->soil_file, 's'))
+			{
+				printf("ERROR reading name of soil file: sensitivity_init()\n");
+				errorCode=22607;
+			}
+		}
+		/* PARAMETER block: name, file (EPC or SOIL), line and column of the value in the file, minimum, maximum,
+		   spinup flag (1: the parameter influences the spinup run); the values can be given in one line */
+		else if (!strcmp(keyword, "PARAMETER"))
+		{
+			if (!errorCode && SEN->npar == N_SENSPAR)
+			{
+				printf("ERROR in sensitivity file: maximum number of parameters is %i\n", N_SENSPAR);
+				errorCode=22608;
+			}
+
+			if (!errorCode) par = &SEN->par[SEN->npar];
+
+			if (!errorCode && (scan_array(SEN_file, par->name, 's', 0, 1) || scan_array(SEN_file, name, 's', 0, 1) ||
+				               scan_array(SEN_file, &par->line, 'i', 0, 1) || scan_array(SEN_file, &par->column, 'i', 0, 1) ||
+							   scan_array(SEN_file, &par->min, 'd', 0, 1) || scan_array(SEN_file, &par->max, 'd', 0, 1) ||
+							   scan_value(SEN_file, &par->spinup, 'i')))
+			{
+				printf("ERROR reading parameter %i: sensitivity_init()\n", SEN->npar+1);
+				errorCode=22609;
+			}
+			if (!errorCode)
+			{
+				if (!strcmp(name, "EPC"))
+					par->file = 0;
+				else if (!strcmp(name, "SOIL"))
+					par->file = 1;
+				else
+				{
+					printf("ERROR in sensitivity file: file of parameter %s must be EPC or SOIL\n", par->name);
+					errorCode=22610;
+				}
+			}
+			if (!errorCode && (par->line < 1 || par->column < 1))
+			{
+				printf("ERROR in sensitivity file: line and column of parameter %s must be positive\n", par->name);
+				errorCode=22610;
+			}
+			if (!errorCode && par->max <= par->min)
+			{
+				printf("ERROR in sensitivity file: maximum of parameter %s must be greater than its minimum\n", par->name);
+				errorCode=22610;
+			}
+			if (!errorCode && par->spinup != 0 && par->spinup != 1)
+			{
+				printf("ERROR in sensitivity file: spinup flag of parameter %s must be 0 or 1\n", par->name);
+				errorCode=22610;
+			}
+			if (!errorCode) SEN->npar += 1;
+		}
+		/* OUTPUT block: output code, mode (0: sum of daily values, 1: sum of end-of-year values, 2: end-of-simulation value) */
+		else if (!strcmp(keyword, "OUTPUT"))
+		{
+			if (!errorCode && SEN->nout == N_SENSOUT)
+			{
+				printf("ERROR in sensitivity file: maximum number of output variables is %i\n", N_SENSOUT);
+				errorCode=22611;
+			}
+			if (!errorCode && (scan_array(SEN_file, &SEN->outcode[SEN->nout], 'i', 0, 1) || scan_value(SEN_file, &SEN->outmode[SEN->nout], 'i')))
+			{
+				printf("ERROR reading output variable: sensitivity_init()\n");
+				errorCode=22612;
+			}
+			if (!errorCode && output_code_check(SEN->outcode[SEN->nout], "sensitivity file"))
+				errorCode=22613;
+			if (!errorCode && (SEN->outmode[SEN->nout] < 0 || SEN->outmode[SEN->nout] > 2))
+			{
+				printf("ERROR in sensitivity file: mode of output variable must be 0, 1 or 2\n");
+				errorCode=22613;
+			}
+			if (!errorCode) SEN->nout += 1;
+		}
+		/* REPORT block: name of the file of the index tables */
+		else if (!strcmp(keyword, "REPORT"))
+		{
+			if (!errorCode && scan_value(SEN_file, SEN->report_file, 's'))
+			{
+				printf("ERROR reading name of report file: sensitivity_init()\n");
+				errorCode=22614;
+			}
+		}
+		else
+		{
+			printf("ERROR in sensitivity file: unknown keyword --> %s\n", keyword);
+			errorCode=226;
+		}
+	}
+
+	fclose(SEN_file.ptr);
+
+	/* consistency of the settings */
+	if (!errorCode && SEN->normal_ini[0] == '\0')
+	{
+		printf("ERROR in sensitivity file: NORMAL block is missing\n");
+		errorCode=22615;
+	}
+
+	if (!errorCode && (SEN->npar == 0 || SEN->nout == 0))
+	{
+		printf("ERROR in sensitivity file: at least one PARAMETER and one OUTPUT block is needed\n");
+		errorCode=22615;
+	}
+
+	if (!errorCode && SEN->nsample < 2)
+	{
+		printf("ERROR in sensitivity file: number of samples must be at least 2\n");
+		errorCode=22602;
+	}
+
+	if (!errorCode && SEN->method == SENS_MORRIS && (SEN->nlevel < 2 || SEN->nlevel % 2))
+	{
+		printf("ERROR in sensitivity file: number of levels must be even and at least 2\n");
+		errorCode=22603;
+	}
+
+	if (!errorCode && SEN->nthreads < 0)
+	{
+		printf("ERROR in sensitivity file: number of threads must be non-negative\n");
+		errorCode=22605;
+	}
+
+	for (np = 0; !errorCode && np < SEN->npar; np++)
+	{
+		par = &SEN->par[np];
+		for (nq = 0; !errorCode && nq < np; nq++)
+		{
+			if (SEN->par[nq].file == par->file && SEN->par[nq].line == par->line && SEN->par[nq].column == par->column)
+			{
+				printf("ERROR in sensitivity file: parameters %s and %s have the same position\n", SEN->par[nq].name, par->name);
+				errorCode=22610;
+			}
+		}
+		if (!errorCode && ((par->file == 0 && SEN->epc_file[0] == '\0') || (par->file == 1 && SEN->soil_file[0] == '\0')))
+		{
+			printf("ERROR in sensitivity file: %s block is missing (parameter %s)\n", par->file ? "SOIL" : "EPC", par->name);
+			errorCode=22607;
+		}
+		if (!errorCode && par->spinup && SEN->spinup_ini[0] == '\0')
+		{
+			printf("ERROR in sensitivity file: parameter %s influences the spinup, but SPINUP block is missing\n", par->name);
+			errorCode=22616;
+		}
+	}
+
+	return (errorCode);
+}
+
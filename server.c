@@ -0,0 +1,536 @@
+/*
+server.c
+simulation server: jobs (main init file with string substitutions) are read from the standard input and run on a pool
+of threads, the results (error code, output prefix, latency) are written to the standard output as the jobs finish;
+in-memory LRU cache of the met arrays and of the end-of-spinup states shared by the jobs.
+The parsed init, EPC, soil and management inputs are not cached: every job reads them again (from the in-memory input
+providers if registered), because their readers also fill the control structure, allocate in the arena of the run and
+advance the init file stream, which a cached copy would have to replay.
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_constants.h"
+#include "bgc_io.h"
+#ifdef _WIN32
+#include <io.h>
+#define dup _dup
+#define dup2 _dup2
+#define fileno _fileno
+#define fdopen _fdopen
+#else
+#include <unistd.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define SERVER_LINESIZE 8192
+
+static srvcache_struct* server_cache = NULL;	/* cache entries */
+static int server_ncache = 0;					/* number of cache entries (0: server is not running) */
+static long server_tick = 0;					/* counter of the cache accesses */
+static long server_hits[3];						/* number of cache hits by kind */
+static long server_misses[3];					/* number of cache misses by kind */
+static FILE* server_out = NULL;					/* protocol output (the original standard output) */
+
+
+static double server_time(void)
+{
+#ifdef _OPENMP
+	return (omp_get_wtime());
+#else
+	return ((double) clock() / CLOCKS_PER_SEC);
+#endif
+}
+
+
+int server_cache_find(int kind, unsigned long long key, unsigned long long check, void* data, size_t size)
+{
+	/* copy of a cached entry: returns 1 if the server is not running or the entry is missing */
+	int miss=1;
+	int n;
+
+	if (!server_ncache) return (miss);
+
+	#pragma omp critical (server_cache)
+	{
+		for (n = 0; miss && n < server_ncache; n++)
+		{
+			if (server_cache[n].kind == kind && server_cache[n].key == key && server_cache[n].check == check && server_cache[n].size == size)
+			{
+				memcpy(data, server_cache[n].data, size);
+				server_tick += 1;
+				server_cache[n].last_used = server_tick;
+				miss = 0;
+			}
+		}
+		if (miss)
+			server_misses[kind] += 1;
+		else
+			server_hits[kind] += 1;
+	}
+
+	return (miss);
+}
+
+
+int server_cache_insert(int kind, unsigned long long key, unsigned long long check, const void* data, size_t size)
+{
+	/* the entry with the same key or the least recently used entry is replaced (no-op if the server is not running) */
+	int errorCode=0;
+	int n, lru;
+	void* copy;
+
+	if (!server_ncache) return (errorCode);
+
+	copy = malloc(size);
+	if (!copy)
+	{
+		printf("ERROR allocating for server cache entry, server_cache_insert()\n");
+		return (1);
+	}
+	memcpy(copy, data, size);
+
+	#pragma omp critical (server_cache)
+	{
+		lru = 0;
+		for (n = 0; n < server_ncache; n++)
+		{
+			if (server_cache[n].kind == kind && server_cache[n].key == key && server_cache[n].check == check)
+			{
+				lru = n;
+				break;
+			}
+			if (server_cache[n].last_used < server_cache[lru].last_used) lru = n;
+		}
+
+		free(server_cache[lru].data);
+		server_tick += 1;
+		server_cache[lru].kind      = kind;
+		server_cache[lru].key       = key;
+		server_cache[lru].check     = check;
+		server_cache[lru].size      = size;
+		server_cache[lru].data      = copy;
+		server_cache[lru].last_used = server_tick;
+	}
+
+	return (errorCode);
+}
+
+
+int server_metarr_init(point_struct* point, metarr_struct* metarr, const climchange_struct* scc, const siteconst_struct* sitec,
+	                   const control_struct* ctrl, srvjob_struct* job)
+{
+	/* met arrays of a server job from the cache (key: name, size and modification time of the met file, climate change
+	   scalars, albedo and simulation period); outside of the server and for streamed met input: metarr_init() */
+	int errorCode=0;
+	int n, nd, nyears, ndays, pos, compact;
+	int length[19];
+	double** array[19];
+	double* block;
+	size_t size;
+	unsigned long long key, check;
+	unsigned long serial;
+	struct stat metstat;
+
+	if (!job || !server_ncache || metarr_stream_mode(-1)) return (metarr_init(point, metarr, scc, sitec, ctrl));
+
+	nyears = ctrl->simyears;
+	ndays  = nDAYS_OF_YEAR * nyears;
+
+	array[0]  = &metarr->Tmax_array;
+	array[1]  = &metarr->Tmin_array;
+	array[2]  = &metarr->prcp_array;
+	array[3]  = &metarr->vpd_array;
+	array[4]  = &metarr->swavgfd_array;
+	array[5]  = &metarr->par_array;
+	array[6]  = &metarr->dayl_array;
+	array[7]  = &metarr->Tday_array;
+	array[8]  = &metarr->Tavg_array;
+	array[9]  = &metarr->TavgRA11_array;
+	array[10] = &metarr->TavgRA10_array;
+	array[11] = &metarr->TavgRA30_array;
+	array[12] = &metarr->tempradF_array;
+	array[13] = &metarr->tempradFra_array;
+	array[14] = &metarr->annTavg_array;
+	array[15] = &metarr->monTavg_array;
+	array[16] = &metarr->annTrange_array;
+	array[17] = &metarr->annTavgRA_array;
+	array[18] = &metarr->annTrangeRA_array;
+
+	for (n = 0; n < 14; n++) length[n] = ndays;
+	for (n = 14; n < 19; n++) length[n] = nyears;
+	length[15] = nyears * nMONTHS_OF_YEAR;
+
+	/* compact met store (metarr_compact_mode()): the derived arrays are missing; daylength is cached in double precision
+	   and the second element of the block shows whether it is stored in single precision */
+	compact = metarr_compact_mode(-1);
+	if (compact)
+	{
+		length[8] = length[9] = length[10] = length[11] = length[13] = 0;
+		if (scc->s_swavgfd == 1) length[5] = 0;
+	}
+
+	/* the first element of the cached block is the number of days of the last simulation year */
+	size = 2 * sizeof(double);
+	for (n = 0; n < 19; n++) size += length[n] * sizeof(double);
+
+	/* registered met inputs (input providers) are identified by their registration serial number */
+	memset(&metstat, 0, sizeof(struct stat));
+	input_provider_open(point->metf.name, NULL, &serial);
+	if (!serial && stat(point->metf.name, &metstat)) return (metarr_init(point, metarr, scc, sitec, ctrl));
+
+	key   = 0xCBF29CE484222325ULL;
+	check = 0x84222325CBF29CE4ULL;
+	hash_bytes(&key, &check, point->metf.name, strlen(point->metf.name));
+	hash_bytes(&key, &check, &metstat.st_size, sizeof(metstat.st_size));
+	hash_bytes(&key, &check, &metstat.st_mtime, sizeof(metstat.st_mtime));
+	hash_bytes(&key, &check, &serial, sizeof(serial));
+	hash_bytes(&key, &check, scc, sizeof(climchange_struct));
+	hash_bytes(&key, &check, &sitec->albedo_sw, sizeof(double));
+	hash_bytes(&key, &check, &ctrl->simstartyear, sizeof(int));
+	hash_bytes(&key, &check, &ctrl->simyears, sizeof(int));
+	hash_bytes(&key, &check, &ctrl->south_shift, sizeof(int));
+	hash_bytes(&key, &check, &point->nday_lastsimyear, sizeof(int));
+	hash_bytes(&key, &check, &compact, sizeof(int));
+
+	block = (double*) malloc(size);
+	if (!block)
+	{
+		printf("ERROR allocating for met cache block, server_metarr_init()\n");
+		return (218);
+	}
+
+	if (!server_cache_find(SRVCACHE_MET, key, check, block, size))
+	{
+		job->metcache_hit = 1;
+		point->nday_lastsimyear = (int) block[0];
+		metarr->compact    = compact;
+		metarr->dayl_float = NULL;
+		pos = 2;
+		for (n = 0; !errorCode && n < 19; n++)
+		{
+			*array[n] = NULL;
+			if (!length[n]) continue;
+			if (n == 6 && block[1])
+			{
+				metarr->dayl_float = (float*) arena_malloc(length[n] * sizeof(float));
+				if (!metarr->dayl_float)
+				{
+					printf("ERROR allocating for met arrays, server_metarr_init()\n");
+					errorCode=218;
+				}
+				for (nd = 0; !errorCode && nd < length[n]; nd++) metarr->dayl_float[nd] = (float) block[pos+nd];
+			}
+			else
+			{
+				*array[n] = (double*) arena_malloc(length[n] * sizeof(double));
+				if (!*array[n])
+				{
+					printf("ERROR allocating for met arrays, server_metarr_init()\n");
+					errorCode=218;
+				}
+				else
+					memcpy(*array[n], block + pos, length[n] * sizeof(double));
+			}
+			pos += length[n];
+		}
+	}
+	else
+	{
+		job->metcache_hit = 0;
+		errorCode = metarr_init(point, metarr, scc, sitec, ctrl);
+		if (!errorCode)
+		{
+			block[0] = point->nday_lastsimyear;
+			block[1] = metarr->dayl_float ? 1 : 0;
+			pos = 2;
+			for (n = 0; n < 19; n++)
+			{
+				if (n == 6 && metarr->dayl_float)
+				{
+					for (nd = 0; nd < length[n]; nd++) block[pos+nd] = metarr->dayl_float[nd];
+				}
+				else if (length[n])
+					memcpy(block + pos, *array[n], length[n] * sizeof(double));
+				pos += length[n];
+			}
+			/* a full memory only means that the next job reads the met file again */
+			server_cache_insert(SRVCACHE_MET, key, check, block, size);
+		}
+	}
+
+	free(block);
+
+	return (errorCode);
+}
+
+
+static void server_job(srvjob_struct* job, const char* systime)
+{
+	/* one simulation; the string substitutions are valid in the thread of the job */
+	file_substitution(job->nsubst, job->subst_from, job->subst_to);
+
+	job->t_start   = server_time();
+	job->errorCode = pointbgc_run(job->ini, systime, NULL, -1, job);
+	job->t_end     = server_time();
+
+	file_substitution(0, NULL, NULL);
+
+	#pragma omp critical (server_out)
+	{
+		fprintf(server_out, "DONE %s %i %.3f %.3f %.3f %s %s\n", job->id, job->errorCode,
+			    job->t_start - job->t_accept, job->t_end - job->t_start, job->t_end - job->t_accept,
+				job->metcache_hit ? "HIT" : "MISS", job->outprefix[0] ? job->outprefix : "-");
+		fflush(server_out);
+	}
+
+	free(job);
+}
+
+
+static int server_parse(const char* line, srvjob_struct* job)
+{
+	/* RUN <job id> <main init file> [<string>=<replacing string> ...] */
+	int errorCode=0;
+	int pos, nread;
+	char command[STRINGSIZE];
+	char token[SERVER_LINESIZE];
+	char* sep;
+
+	pos = 0;
+	if (sscanf(line, "%199s %199s %127s%n", command, job->id, job->ini, &nread) != 3) return (1);
+	pos += nread;
+
+	while (!errorCode && sscanf(line + pos, "%8191s%n", token, &nread) == 1)
+	{
+		pos += nread;
+		sep  = strchr(token, '=');
+		if (!sep || sep == token || job->nsubst == N_SRVSUBST || strlen(sep+1) >= FILENAMESIZE || (size_t) (sep - token) >= FILENAMESIZE)
+			errorCode=1;
+		else
+		{
+			*sep = '\0';
+			strcpy(job->subst_from[job->nsubst], token);
+			strcpy(job->subst_to[job->nsubst], sep+1);
+			job->nsubst += 1;
+		}
+	}
+
+	return (errorCode);
+}
+
+
+static int server_input(const char* line, const char* command)
+{
+	/* registration of inputs in the memory (input providers): archive, memory-mapped file or buffer read from the standard input */
+	int errorCode=0;
+	int nmember=0;
+	long nbytes=0;
+	char name[SERVER_LINESIZE];
+	char* data;
+
+	if (sscanf(line, "%*s %8191s %li", name, &nbytes) < 1) return (1);
+
+	if (!strcmp(command, "ARCHIVE"))
+		errorCode = input_archive_open(name, &nmember);
+	else if (!strcmp(command, "MAP"))
+		errorCode = input_file_map(name);
+	else
+	{
+		/* the contents follow the request line (exactly nbytes bytes) */
+		if (nbytes <= 0 || !(data = (char*) malloc((size_t) nbytes))) return (1);
+		if (fread(data, 1, (size_t) nbytes, stdin) != (size_t) nbytes)
+			errorCode=1;
+		else
+			errorCode = input_buffer_register(name, data, (size_t) nbytes);
+		free(data);
+	}
+
+	if (!errorCode)
+	{
+		#pragma omp critical (server_out)
+		{
+			if (!strcmp(command, "ARCHIVE"))
+				fprintf(server_out, "ARCHIVE %i\n", nmember);
+			else if (!strcmp(command, "MAP"))
+				fprintf(server_out, "MAPPED %s\n", name);
+			else
+				fprintf(server_out, "BUFFERED %s\n", name);
+			fflush(server_out);
+		}
+	}
+
+	return (errorCode);
+}
+
+
+int server_run(const char* systime, int nthreads, int ncache)
+{
+	/* protocol (one line per request and per answer):
+	   RUN <job id> <main init file> [<string>=<replacing string> ...]  ->  ACCEPTED <job id>, later
+	                                      DONE <job id> <error code> <queue time> <run time> <total time> <met cache> <output prefix>
+	   STATS  ->  STATS <met hits> <met misses> <spinup hits> <spinup misses> <largest simulation arena (bytes)>
+	   ARCHIVE <archive file>  ->  ARCHIVE <number of members>: the members are read from the memory by the next jobs
+	   MAP <input file>  ->  MAPPED <input file>: the file is read from the memory by the next jobs
+	   BUFFER <name> <number of bytes>, followed by the contents  ->  BUFFERED <name>: input file in memory
+	   RELEASE <name or archive file>  ->  RELEASED <name>: the input (or all members of the archive) is read from the disk
+	                                      again, the memory is freed after the running jobs which have opened it
+	   QUIT (or end of input)  ->  the running jobs are finished, BYE */
+	int errorCode=0;
+	int quit=0;
+	int out_fd;
+	char line[SERVER_LINESIZE];
+	char name[SERVER_LINESIZE];
+	char command[STRINGSIZE];
+	srvjob_struct* job;
+
+	if (ncache < 1)
+	{
+		printf("ERROR in server mode: the number of cache entries must be at least 1\n");
+		return (1);
+	}
+
+	server_cache = (srvcache_struct*) calloc(ncache, sizeof(srvcache_struct));
+	if (!server_cache)
+	{
+		printf("ERROR allocating for server cache\n");
+		return (1);
+	}
+	server_ncache = ncache;
+
+	/* the answers are written to the original standard output, the messages of the simulations go to the standard error */
+	fflush(stdout);
+	out_fd = dup(fileno(stdout));
+	if (out_fd < 0 || dup2(fileno(stderr), fileno(stdout)) < 0 || !(server_out = fdopen(out_fd, "w")))
+	{
+		printf("ERROR redirecting standard output in server mode\n");
+		free(server_cache);
+		server_ncache = 0;
+		return (1);
+	}
+
+#ifdef _OPENMP
+	if (nthreads > 0) omp_set_num_threads(nthreads);
+#endif
+
+	fprintf(server_out, "READY\n");
+	fflush(server_out);
+
+	/* one thread reads the requests, the jobs are run by the pool of threads as tasks */
+	#pragma omp parallel
+	{
+		#pragma omp single
+		{
+			while (!quit && fgets(line, SERVER_LINESIZE, stdin))
+			{
+				if (sscanf(line, "%199s", command) != 1) continue;
+
+				if (!strcmp(command, "RUN"))
+				{
+					job = (srvjob_struct*) calloc(1, sizeof(srvjob_struct));
+					if (job && !server_parse(line, job))
+					{
+						job->t_accept = server_time();
+						#pragma omp critical (server_out)
+						{
+							fprintf(server_out, "ACCEPTED %s\n", job->id);
+							fflush(server_out);
+						}
+						#pragma omp task firstprivate(job)
+						server_job(job, systime);
+					}
+					else
+					{
+						#pragma omp critical (server_out)
+						{
+							fprintf(server_out, "ERROR invalid job: %s", line);
+							fflush(server_out);
+						}
+						free(job);
+					}
+				}
+				else if (!strcmp(command, "STATS"))
+				{
+					#pragma omp critical (server_cache)
+					{
+						#pragma omp critical (server_out)
+						{
+							fprintf(server_out, "STATS %li %li %li %li %lu\n", server_hits[SRVCACHE_MET], server_misses[SRVCACHE_MET],
+								    server_hits[SRVCACHE_SPINUP], server_misses[SRVCACHE_SPINUP], (unsigned long) arena_highwater());
+							fflush(server_out);
+						}
+					}
+				}
+				else if (!strcmp(command, "ARCHIVE") || !strcmp(command, "MAP") || !strcmp(command, "BUFFER"))
+				{
+					if (server_input(line, command))
+					{
+						#pragma omp critical (server_out)
+						{
+							fprintf(server_out, "ERROR invalid input: %s", line);
+							fflush(server_out);
+						}
+					}
+				}
+				else if (!strcmp(command, "RELEASE"))
+				{
+					if (sscanf(line, "%*s %8191s", name) != 1 || input_buffer_release(name))
+					{
+						#pragma omp critical (server_out)
+						{
+							fprintf(server_out, "ERROR invalid input: %s", line);
+							fflush(server_out);
+						}
+					}
+					else
+					{
+						#pragma omp critical (server_out)
+						{
+							fprintf(server_out, "RELEASED %s\n", name);
+							fflush(server_out);
+						}
+					}
+				}
+				else if (!strcmp(command, "QUIT"))
+					quit = 1;
+				else
+				{
+					#pragma omp critical (server_out)
+					{
+						fprintf(server_out, "ERROR unknown request: %s", line);
+						fflush(server_out);
+					}
+				}
+			}
+			#pragma omp taskwait
+		}
+	}
+
+	fprintf(server_out, "BYE\n");
+	fclose(server_out);
+
+	for (out_fd = 0; out_fd < server_ncache; out_fd++) free(server_cache[out_fd].data);
+	free(server_cache);
+	server_ncache = 0;
+	input_provider_free();
+	arena_cache_free();
+
+	return (errorCode);
+}
+
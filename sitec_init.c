@@ -30,7 +30,6 @@ int sitec_init(file init, siteconst_struct* sitec, control_struct *ctrl)
 
 	int errorCode=0;
 
-	int layer;
 	char key[] = "SITE";
 	char keyword[STRINGSIZE];
 	
@@ -86,41 +85,81 @@ int sitec_init(file init, siteconst_struct* sitec, control_struct *ctrl)
 		errorCode=20703;
 	}
 
-	/*--------------------------------------------------------------------------------------*/
-	/* INITALIZING */
+	/* the depths of the soil layers are set by soillayer_init() when the number of layers is known (sprop_init) */
+	sitec->n_soillayers = 0;
+
+ 	return (errorCode);
+}
 
-	/* predefined values: depth of the layers (soillayer_depth;[m])  */
-	sitec->soillayer_depth[0] = 0.03;
-	sitec->soillayer_depth[1] = 0.10;
-	sitec->soillayer_depth[2] = 0.30;
-	sitec->soillayer_depth[3] = 0.60;
-	sitec->soillayer_depth[4] = 0.90;
-	sitec->soillayer_depth[5] = 1.20;
-	sitec->soillayer_depth[6] = 1.50;
-	sitec->soillayer_depth[7] = 2.00;
-	sitec->soillayer_depth[8] = 4.00;
-	sitec->soillayer_depth[9] = 10.0;
 
 
-	/* calculated values: thickness and depth of the layers (soillayer_thickness[m] and soillayer_midpoint[m]) */
-	
-	for (layer = 0; layer < N_SOILLAYERS; layer++)
+int soillayer_init(siteconst_struct* sitec, int n_soillayers)
+{
+	/* depth, thickness and midpoint of the soil layers of the run */
+
+	int errorCode=0;
+	int layer;
+
+	/* predefined depths of the soil layers [m] */
+	double soillayer_depth4[4]   = {0.03, 0.10, 0.30, 10.0};
+	double soillayer_depth6[6]   = {0.03, 0.10, 0.30, 1.00, 2.00, 10.0};
+	double soillayer_depth10[10] = {0.03, 0.10, 0.30, 0.60, 0.90, 1.20, 1.50, 2.00, 4.00, 10.0};
+	double soillayer_depth20[20] = {0.03, 0.10, 0.30, 0.45, 0.60, 0.75, 0.90, 1.05, 1.20, 1.35, 
+	                                1.50, 1.75, 2.00, 2.50, 3.00, 4.00, 5.00, 6.50, 8.00, 10.0};
+	double* soillayer_depth_array;
+
+	if (n_soillayers < 4 || n_soillayers > N_SOILLAYERS)
 	{
-		if (layer == 0)
+		printf("ERROR in soil file: number of soil layers must be between 4 and %i (N_SOILLAYERS of the build), soillayer_init()\n", N_SOILLAYERS);
+		errorCode=1;
+	}
+
+	if (!errorCode)
+	{
+		sitec->n_soillayers = n_soillayers;
+
+		switch (n_soillayers)
 		{
-			sitec->soillayer_thickness[layer] = sitec->soillayer_depth[layer];
-			sitec->soillayer_midpoint[layer]  = sitec->soillayer_thickness[layer] / 2.;
+			case 4:  soillayer_depth_array = soillayer_depth4;  break;
+			case 6:  soillayer_depth_array = soillayer_depth6;  break;
+			case 20: soillayer_depth_array = soillayer_depth20; break;
+			default: soillayer_depth_array = soillayer_depth10; break;
 		}
-		else
+
+		/* predefined values: depth of the layers (soillayer_depth;[m]) - the top 30 cm is always divided into 3 layers (0-3, 3-10, 10-30 cm) 
+		   and the bottom of the profile is always 10 m; predefined profiles: 4, 6, 10 (default) and 20 layers, 
+		   for other numbers of layers the layers below 30 cm are thickening geometrically; the layers below the profile are empty */
+		for (layer = 0; layer < N_SOILLAYERS; layer++)
 		{
-			sitec->soillayer_thickness[layer] = sitec->soillayer_depth[layer]-sitec->soillayer_depth[layer-1];
-			sitec->soillayer_midpoint[layer]  = sitec->soillayer_depth[layer-1]+ sitec->soillayer_thickness[layer] / 2.;
+			if (layer >= n_soillayers)
+				sitec->soillayer_depth[layer] = 0;
+			else if (n_soillayers == 4 || n_soillayers == 6 || n_soillayers == 10 || n_soillayers == 20 || layer < 3)
+				sitec->soillayer_depth[layer] = soillayer_depth_array[layer];
+			else
+				sitec->soillayer_depth[layer] = soillayer_depth_array[2] * pow(10.0 / soillayer_depth_array[2], (double) (layer-2) / (double) (n_soillayers-3));
+		}
+
+		/* calculated values: thickness and depth of the layers (soillayer_thickness[m] and soillayer_midpoint[m]) */
+		for (layer = 0; layer < N_SOILLAYERS; layer++)
+		{
+			if (layer >= n_soillayers)
+			{
+				sitec->soillayer_thickness[layer] = 0;
+				sitec->soillayer_midpoint[layer]  = 0;
+			}
+			else if (layer == 0)
+			{
+				sitec->soillayer_thickness[layer] = sitec->soillayer_depth[layer];
+				sitec->soillayer_midpoint[layer]  = sitec->soillayer_thickness[layer] / 2.;
+			}
+			else
+			{
+				sitec->soillayer_thickness[layer] = sitec->soillayer_depth[layer]-sitec->soillayer_depth[layer-1];
+				sitec->soillayer_midpoint[layer]  = sitec->soillayer_depth[layer-1]+ sitec->soillayer_thickness[layer] / 2.;
+			}
 		}
 	}
-	
 
-	
- 	return (errorCode);
+	return (errorCode);
 }
 
-
@@ -20,7 +20,7 @@ See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentatio
 #include "bgc_constants.h"
 #include "bgc_func.h"    
 
-int soilstress_calculation(soilprop_struct* sprop, const epconst_struct* epc, 
+int soilstress_calculation(const siteconst_struct* sitec, soilprop_struct* sprop, const epconst_struct* epc, 
 	                       epvar_struct* epv, wstate_struct* ws, wflux_struct* wf)
 {
 	int layer;
@@ -38,7 +38,7 @@ int soilstress_calculation(soilprop_struct* sprop, const epconst_struct* epc,
 		if (epc->soilstress_flag == 0)
 		{
 			layerSATfull = 0;
-			for (layer = 0; layer < N_SOILLAYERS; layer++)
+			for (layer = 0; layer < sitec->n_soillayers; layer++)
 			{
 				/* DROUGHT STRESS */
 				if (epv->VWC[layer] <= epv->VWC_SScrit1[layer])
@@ -115,14 +115,14 @@ int soilstress_calculation(soilprop_struct* sprop, const epconst_struct* epc,
 			}
 			else
 			{
-				for (layer = 0; layer < N_SOILLAYERS; layer++) epv->m_SWCstress_layer[layer] = 1;
+				for (layer = 0; layer < sitec->n_soillayers; layer++) epv->m_SWCstress_layer[layer] = 1;
 				m_SWCstress_avg = 1;
 			}
 		}
 	}
 	else
 	{
-		for (layer = 0; layer < N_SOILLAYERS; layer++) 
+		for (layer = 0; layer < sitec->n_soillayers; layer++) 
 		{
 				epv->m_SWCstress_layer[layer] = 1;
 				ws->soilw_avail[layer] = 0;
@@ -135,7 +135,7 @@ int soilstress_calculation(soilprop_struct* sprop, const epconst_struct* epc,
 	if (fabs(layerSATfull - 1) < CRIT_PREC)
 	{
 		epv->m_SWCstress = 0;
-		for (layer = 0; layer < N_SOILLAYERS; layer++) epv->m_SWCstress_layer[layer] =  0;
+		for (layer = 0; layer < sitec->n_soillayers; layer++) epv->m_SWCstress_layer[layer] =  0;
 	}
 	else
 		epv->m_SWCstress = m_SWCstress_avg;
@@ -166,7 +166,7 @@ int soilstress_calculation(soilprop_struct* sprop, const epconst_struct* epc,
 	/* 3. N-stress based on immobilization ratio */
 
 	if (epv->rootDepth)
-		for (layer = 0; layer < N_SOILLAYERS; layer++) m_Nstress_avg += epv->IMMOBratio[layer] * epv->rootlengthProp[layer];
+		for (layer = 0; layer < sitec->n_soillayers; layer++) m_Nstress_avg += epv->IMMOBratio[layer] * epv->rootlengthProp[layer];
 	else
 		m_Nstress_avg = 1;
 
@@ -0,0 +1,649 @@
+/*
+spinup_cache.c
+content-addressed cache of the end-of-spinup states: every input influencing the spinup phase is hashed,
+the state at the end of the spinup is stored under the hash key and reused (skipping the spinup phase) in
+later runs with the same inputs. The stored states also form a library for warm start of spinups with
+similar (but not identical) inputs
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_constants.h"
+#include "bgc_func.h"
+#include "bgc_io.h"
+
+#define SPINUPCACHE_MAGIC	0x4350534DU				/* "MSPC" */
+#define SPINUPCACHE_VERSION	1						/* format version of the cache entries */
+#define SPINUPCACHE_MODEL	"Biome-BGCMuSo7.0-b10"	/* model version: entries of other model versions are stale */
+#define N_WARMFEATURES		8						/* number of features in the warm start distance */
+
+/* header of the cache entries, followed by ws, cs, ns and epv */
+typedef struct
+{
+	unsigned int magic;
+	int version;
+	char model[32];
+	unsigned long long key;
+	unsigned long long check;
+	int size_ws;
+	int size_cs;
+	int size_ns;
+	int size_epv;
+	int spinup_years;
+	double spinup_resid_trend;
+} spinupcache_header_struct;
+
+/* cache entry in the memory of the simulation server */
+typedef struct
+{
+	spinupcache_header_struct header;
+	wstate_struct ws;
+	cstate_struct cs;
+	nstate_struct ns;
+	epvar_struct epv;
+} spinupcache_entry_struct;
+
+/* running hash values: FNV-1a (key) and an independent multiplicative hash (check) */
+void hash_bytes(unsigned long long* key, unsigned long long* check, const void* data, size_t nbytes)
+{
+	const unsigned char* p = (const unsigned char*) data;
+	size_t i;
+
+	for (i = 0; i < nbytes; i++)
+	{
+		*key ^= p[i];
+		*key *= 0x100000001B3ULL;
+
+		*check += p[i] + 1;
+		*check *= 0x9E3779B97F4A7C15ULL;
+		*check ^= *check >> 29;
+	}
+}
+
+/* hashing an array (NULL pointer or zero length is hashed as length only) */
+void hash_array(unsigned long long* key, unsigned long long* check, const void* data, int n, size_t size)
+{
+	hash_bytes(key, check, &n, sizeof(int));
+	if (data && n > 0) hash_bytes(key, check, data, n * size);
+}
+
+/* hashing a daily variable of the met arrays by its values (the same as the hash of the stored array, also in the compact
+   met store and in the streamed met input) */
+static void hash_metarr(unsigned long long* key, unsigned long long* check, const metarr_struct* metarr, int var, int n)
+{
+	int i;
+	double value;
+
+	hash_bytes(key, check, &n, sizeof(int));
+	for (i = 0; i < n; i++)
+	{
+		value = metarr_value(metarr, var, i);
+		hash_bytes(key, check, &value, sizeof(double));
+	}
+}
+
+static void spinup_cache_key(const bgcin_struct* bgcin, unsigned long long* key, unsigned long long* check)
+{
+	const control_struct* ctrl = &bgcin->ctrl;
+	epconst_struct epc;
+	int ctrlvar[13];
+	int convvar[3];
+	double co2ndep[3];
+	int nmetdays, i;
+
+	*key   = 0xCBF29CE484222325ULL;
+	*check = 0x84222325CBF29CE4ULL;
+
+	/* 1. control variables influencing the spinup phase */
+	ctrlvar[0]  = ctrl->simyears;
+	ctrlvar[1]  = ctrl->simstartyear;
+	ctrlvar[2]  = ctrl->maxspincycles;
+	ctrlvar[3]  = ctrl->NaddSPINUP_flag;
+	ctrlvar[4]  = ctrl->south_shift;
+	ctrlvar[5]  = ctrl->GSI_flag;
+	ctrlvar[6]  = ctrl->varSGS_flag;
+	ctrlvar[7]  = ctrl->varEGS_flag;
+	ctrlvar[8]  = ctrl->varFM_flag;
+	ctrlvar[9]  = ctrl->varWPM_flag;
+	ctrlvar[10] = ctrl->varMSC_flag;
+	ctrlvar[11] = ctrl->read_restart;
+	ctrlvar[12] = ctrl->soiltype;
+	hash_bytes(key, check, ctrlvar, sizeof(ctrlvar));
+
+	/* 2. site constants, soil properties and ecophysiological constants (pointers are hashed by their content) */
+	hash_bytes(key, check, &bgcin->sitec, sizeof(siteconst_struct));
+	hash_bytes(key, check, &bgcin->sprop, sizeof(soilprop_struct));
+
+	memcpy(&epc, &bgcin->epc, sizeof(epconst_struct));
+	epc.SGS_array   = 0;
+	epc.EGS_array   = 0;
+	epc.FMyr_array  = 0;
+	epc.WPMyr_array = 0;
+	epc.MSC_array   = 0;
+	hash_bytes(key, check, &epc, sizeof(epconst_struct));
+
+	hash_array(key, check, ctrl->varSGS_flag ? bgcin->epc.SGS_array   : 0, ctrl->simyears, sizeof(double));
+	hash_array(key, check, ctrl->varEGS_flag ? bgcin->epc.EGS_array   : 0, ctrl->simyears, sizeof(double));
+	hash_array(key, check, ctrl->varFM_flag  ? bgcin->epc.FMyr_array  : 0, ctrl->simyears, sizeof(double));
+	hash_array(key, check, ctrl->varWPM_flag ? bgcin->epc.WPMyr_array : 0, ctrl->simyears, sizeof(double));
+	hash_array(key, check, ctrl->varMSC_flag ? bgcin->epc.MSC_array   : 0, ctrl->simyears, sizeof(double));
+
+	/* 3. initial state variables (and restart data, if used) */
+	hash_bytes(key, check, &bgcin->ws, sizeof(wstate_struct));
+	hash_bytes(key, check, &bgcin->cs, sizeof(cstate_struct));
+	hash_bytes(key, check, &bgcin->ns, sizeof(nstate_struct));
+	hash_bytes(key, check, &bgcin->cinit, sizeof(cinit_struct));
+	if (ctrl->read_restart) hash_bytes(key, check, &bgcin->restart_input, sizeof(restart_data_struct));
+
+	/* 4. spinup CO2 and N-deposition */
+	co2ndep[0] = bgcin->co2.co2ppm;
+	co2ndep[1] = bgcin->ndep.ndep;
+	co2ndep[2] = bgcin->ndep.NdepNH4_coeff;
+	hash_bytes(key, check, co2ndep, sizeof(co2ndep));
+
+	/* 5. meteorological data (after scalar climate change and southern hemisphere shift) */
+	nmetdays = ctrl->simyears * nDAYS_OF_YEAR;
+	hash_metarr(key, check, &bgcin->metarr, METARR_TMAX,    nmetdays);
+	hash_metarr(key, check, &bgcin->metarr, METARR_TMIN,    nmetdays);
+	hash_metarr(key, check, &bgcin->metarr, METARR_PRCP,    nmetdays);
+	hash_metarr(key, check, &bgcin->metarr, METARR_VPD,     nmetdays);
+	hash_metarr(key, check, &bgcin->metarr, METARR_SWAVGFD, nmetdays);
+	hash_metarr(key, check, &bgcin->metarr, METARR_PAR,     nmetdays);
+	hash_metarr(key, check, &bgcin->metarr, METARR_DAYL,    nmetdays);
+	hash_metarr(key, check, &bgcin->metarr, METARR_TDAY,    nmetdays);
+	hash_metarr(key, check, &bgcin->metarr, METARR_TAVG,    nmetdays);
+
+	/* 6. management data used in the spinup phase: groundwater, flooding, planting and harvesting (phenology) */
+	hash_array(key, check, bgcin->GWS.GWyear_array,  bgcin->GWS.GWD_num, sizeof(int));
+	hash_array(key, check, bgcin->GWS.GWmonth_array, bgcin->GWS.GWD_num, sizeof(int));
+	hash_array(key, check, bgcin->GWS.GWday_array,   bgcin->GWS.GWD_num, sizeof(int));
+	hash_array(key, check, bgcin->GWS.GWdepth_array, bgcin->GWS.GWD_num, sizeof(double));
+
+	hash_array(key, check, bgcin->FLD.FLDstart_year_array,  bgcin->FLD.FLD_num, sizeof(int));
+	hash_array(key, check, bgcin->FLD.FLDstart_month_array, bgcin->FLD.FLD_num, sizeof(int));
+	hash_array(key, check, bgcin->FLD.FLDstart_day_array,   bgcin->FLD.FLD_num, sizeof(int));
+	hash_array(key, check, bgcin->FLD.FLDend_year_array,    bgcin->FLD.FLD_num, sizeof(int));
+	hash_array(key, check, bgcin->FLD.FLDend_month_array,   bgcin->FLD.FLD_num, sizeof(int));
+	hash_array(key, check, bgcin->FLD.FLDend_day_array,     bgcin->FLD.FLD_num, sizeof(int));
+	hash_array(key, check, bgcin->FLD.FLDheight,            bgcin->FLD.FLD_num, sizeof(double));
+
+	hash_array(key, check, bgcin->PLT.PLTyear_array,         bgcin->PLT.PLT_num, sizeof(int));
+	hash_array(key, check, bgcin->PLT.PLTmonth_array,        bgcin->PLT.PLT_num, sizeof(int));
+	hash_array(key, check, bgcin->PLT.PLTday_array,          bgcin->PLT.PLT_num, sizeof(int));
+	hash_array(key, check, bgcin->PLT.germDepth_array,       bgcin->PLT.PLT_num, sizeof(double));
+	hash_array(key, check, bgcin->PLT.n_seedlings_array,     bgcin->PLT.PLT_num, sizeof(double));
+	hash_array(key, check, bgcin->PLT.weight_1000seed_array, bgcin->PLT.PLT_num, sizeof(double));
+	hash_array(key, check, bgcin->PLT.seed_carbon_array,     bgcin->PLT.PLT_num, sizeof(double));
+	for (i = 0; i < bgcin->PLT.PLT_num; i++)
+	{
+		if (bgcin->PLT.filename_array && bgcin->PLT.filename_array[i])
+			hash_bytes(key, check, bgcin->PLT.filename_array[i], strlen(bgcin->PLT.filename_array[i]));
+	}
+
+	hash_array(key, check, bgcin->HRV.HRVyear_array,  bgcin->HRV.HRV_num, sizeof(int));
+	hash_array(key, check, bgcin->HRV.HRVmonth_array, bgcin->HRV.HRV_num, sizeof(int));
+	hash_array(key, check, bgcin->HRV.HRVday_array,   bgcin->HRV.HRV_num, sizeof(int));
+
+	/* 7. spinup options changing the end state: convergence monitor (the minimum number of windows only if it is used; 2:
+	      yearly decision on sliding windows, the entries of the earlier window-end decision are not reused) and warm start
+	      (a warm-started equilibrium is not the same as the one reached from the initial state) */
+	convvar[0] = bgcin->SPO.conv_flag ? 2 : 0;
+	convvar[1] = bgcin->SPO.conv_flag ? bgcin->SPO.conv_minwindows : 0;
+	convvar[2] = bgcin->SPO.warm_flag;
+	hash_bytes(key, check, convvar, sizeof(convvar));
+}
+
+
+/* features of the warm start distance: soil (sand, silt, pH in 0-30 cm), climate (mean temperature, 
+   annual precipitation) and EPC (woody, evergreen, C3) */
+static void spinup_cache_features(const bgcin_struct* bgcin, double* feature)
+{
+	int layer, i, nmetdays;
+	double thick = 0;
+
+	for (i = 0; i < N_WARMFEATURES; i++) feature[i] = 0;
+
+	for (layer = 0; layer < 3; layer++)
+	{
+		feature[0] += bgcin->sprop.sand[layer] * bgcin->sitec.soillayer_thickness[layer];
+		feature[1] += bgcin->sprop.silt[layer] * bgcin->sitec.soillayer_thickness[layer];
+		feature[2] += bgcin->sprop.pH[layer]   * bgcin->sitec.soillayer_thickness[layer];
+		thick      += bgcin->sitec.soillayer_thickness[layer];
+	}
+	feature[0] /= thick * 100.;
+	feature[1] /= thick * 100.;
+	feature[2] /= thick * 14.;
+
+	nmetdays = bgcin->ctrl.simyears * nDAYS_OF_YEAR;
+	for (i = 0; i < nmetdays; i++)
+	{
+		feature[3] += metarr_value(&bgcin->metarr, METARR_TAVG, i);
+		feature[4] += metarr_value(&bgcin->metarr, METARR_PRCP, i);
+	}
+	feature[3] /= nmetdays * 10.;
+	feature[4] /= bgcin->ctrl.simyears * 100.;
+
+	feature[5] = bgcin->epc.woody;
+	feature[6] = bgcin->epc.evergreen;
+	feature[7] = bgcin->epc.c3_flag;
+}
+
+/* directory of the written entries: the spinup cache, or the state library if only warm start is used (every directory
+   of entries is a state library with its own index) */
+static const char* spinup_cache_dir(const spinupopt_struct* SPO)
+{
+	return (SPO->cache_flag ? SPO->cache_dir : SPO->library_dir);
+}
+
+
+/* names of an entry and of the library index in a directory of entries: returns 1 if the name is too long */
+static int spinup_cache_entryname(char* name, const char* dir, unsigned long long key)
+{
+	int n;
+
+	n = snprintf(name, FILENAMESIZE, "%s/%016llx.spc", dir, key);
+
+	return (n < 0 || n >= FILENAMESIZE);
+}
+
+
+static int spinup_cache_indexname(char* name, const char* dir)
+{
+	int n;
+
+	n = snprintf(name, FILENAMESIZE, "%s/spinup_library.txt", dir);
+
+	return (n < 0 || n >= FILENAMESIZE);
+}
+
+
+/* checking whether an entry is already listed in the index of a state library */
+static int spinup_library_listed(const char* name, unsigned long long key)
+{
+	int listed=0;
+	unsigned long long keyLIB;
+	char line[STRINGSIZE];
+	file library_file;
+
+	strcpy(library_file.name, name);
+	if (file_open(&library_file,'j',0)) return (listed);
+
+	while (!listed && fgets(line, STRINGSIZE, library_file.ptr))
+	{
+		if (sscanf(line, "%llx", &keyLIB) == 1 && keyLIB == key) listed = 1;
+	}
+	fclose(library_file.ptr);
+
+	return (listed);
+}
+
+
+/* reading a cache entry: returns 1 if the entry is missing, stale or damaged (key and check hash are tested only if key != 0) */
+static int spinup_cache_read(const char* name, unsigned long long key, unsigned long long check, spinupcache_header_struct* header, 
+	                         wstate_struct* ws, cstate_struct* cs, nstate_struct* ns, epvar_struct* epv)
+{
+	int stale=0;
+	file cache_file;
+	spinupcache_entry_struct* entry;
+
+	/* server mode: the entry is first searched in the memory of the server */
+	entry = key ? (spinupcache_entry_struct*) malloc(sizeof(spinupcache_entry_struct)) : NULL;
+	if (entry && !server_cache_find(SRVCACHE_SPINUP, key, check, entry, sizeof(spinupcache_entry_struct)))
+	{
+		*header = entry->header;
+		*ws     = entry->ws;
+		*cs     = entry->cs;
+		*ns     = entry->ns;
+		*epv    = entry->epv;
+		free(entry);
+		return (stale);
+	}
+
+	strcpy(cache_file.name, name);
+	if (file_open(&cache_file,'r',0))
+	{
+		free(entry);
+		return (1);
+	}
+
+	if (fread(header, sizeof(spinupcache_header_struct), 1, cache_file.ptr) != 1) stale = 1;
+
+	if (!stale && (header->magic != SPINUPCACHE_MAGIC || header->version != SPINUPCACHE_VERSION ||
+		           strcmp(header->model, SPINUPCACHE_MODEL) ||
+		           header->size_ws  != (int) sizeof(wstate_struct) || header->size_cs  != (int) sizeof(cstate_struct) ||
+		           header->size_ns  != (int) sizeof(nstate_struct) || header->size_epv != (int) sizeof(epvar_struct)))
+		stale = 1;
+
+	if (!stale && key && (header->key != key || header->check != check)) stale = 1;
+
+	if (!stale && (fread(ws,  sizeof(wstate_struct), 1, cache_file.ptr) != 1 ||
+		           fread(cs,  sizeof(cstate_struct), 1, cache_file.ptr) != 1 ||
+		           fread(ns,  sizeof(nstate_struct), 1, cache_file.ptr) != 1 ||
+		           fread(epv, sizeof(epvar_struct),  1, cache_file.ptr) != 1))
+		stale = 1;
+
+	fclose(cache_file.ptr);
+
+	if (!stale && entry)
+	{
+		entry->header = *header;
+		entry->ws     = *ws;
+		entry->cs     = *cs;
+		entry->ns     = *ns;
+		entry->epv    = *epv;
+		server_cache_insert(SRVCACHE_SPINUP, key, check, entry, sizeof(spinupcache_entry_struct));
+	}
+	free(entry);
+
+	return (stale);
+}
+
+
+int spinup_cache_resume(bgcin_struct* bgcin, bgcout_struct* bgcout)
+{
+	int errorCode=0;
+	int stale=0;
+	file cache_file;
+	spinupcache_header_struct header;
+	wstate_struct ws;
+	cstate_struct cs;
+	nstate_struct ns;
+	epvar_struct epv;
+
+	spinupopt_struct* SPO = &bgcin->SPO;
+
+	SPO->cache_hit = 0;
+
+	/* key of the spinup inputs - calculated before any modification by the simulation (also used by the state library) */
+	spinup_cache_key(bgcin, &SPO->cache_key, &SPO->cache_check);
+	if (spinup_cache_entryname(SPO->cache_file, spinup_cache_dir(SPO), SPO->cache_key))
+	{
+		printf("ERROR in spinup cache: name of the cache entry is too long (directory: %s)\n", spinup_cache_dir(SPO));
+		return (409);
+	}
+
+	if (!SPO->cache_flag) return (errorCode);
+
+	if (spinup_cache_read(SPO->cache_file, SPO->cache_key, SPO->cache_check, &header, &ws, &cs, &ns, &epv))
+	{
+		/* missing entry: normal spinup; existing but unusable entry: stale */
+		strcpy(cache_file.name, SPO->cache_file);
+		if (file_open(&cache_file,'r',0))
+		{
+			if (bgcin->ctrl.onscreen) printf("INFORMATION: no spinup cache entry found (%s), running spinup\n", SPO->cache_file);
+			return (errorCode);
+		}
+		fclose(cache_file.ptr);
+		stale = 1;
+	}
+
+	if (stale)
+	{
+		if (SPO->cache_strict)
+		{
+			printf("ERROR in spinup cache: stale or damaged cache entry %s (strict mode)\n", SPO->cache_file);
+			errorCode=409;
+		}
+		else
+		{
+			if (bgcin->ctrl.onscreen) printf("WARNING: stale spinup cache entry %s is ignored, running spinup\n", SPO->cache_file);
+		}
+		return (errorCode);
+	}
+
+	SPO->cache_hit = 1;
+	bgcout->spinup_years       = header.spinup_years;
+	bgcout->spinup_resid_trend = header.spinup_resid_trend;
+
+	/* writing log file */
+	fprintf(bgcout->log_file.ptr, "SPINUP RUN\n");
+	fprintf(bgcout->log_file.ptr, " \n");
+	fprintf(bgcout->log_file.ptr, "SPINUP CACHE\n");
+	fprintf(bgcout->log_file.ptr, "end-of-spinup state restored from cache entry: %s\n", SPO->cache_file);
+	fprintf(bgcout->log_file.ptr, " \n");
+	fprintf(bgcout->log_file.ptr,"spinyears = %d \n",bgcout->spinup_years);
+	fprintf(bgcout->log_file.ptr, " \n");
+
+	if (bgcin->ctrl.onscreen)
+	{
+		printf("\n");
+		printf("SPINUP: restored from cache entry %s\n", SPO->cache_file);
+		printf("SPINUP: residual trend   = %.6lf\n",bgcout->spinup_resid_trend);
+ 		printf("SPINUP: number of years  = %d\n",bgcout->spinup_years);
+	}
+
+	/* TRANSIENT RUN between spinup and normal run (same as in spinup_bgc) */
+	if (!errorCode && (bgcin->co2.varco2 || bgcin->ndep.varndep))
+	{
+		bgcin->ws = ws;
+		bgcin->cs = cs;
+		bgcin->ns = ns;
+
+		bgcin->cinit.max_leafc      = epv.annmax_leafc;
+		bgcin->cinit.max_frootc     = epv.annmax_frootc;
+		bgcin->cinit.max_yieldc     = epv.annmax_yieldc;
+		bgcin->cinit.max_softstemc  = epv.annmax_softstemc;
+		bgcin->cinit.max_livestemc  = epv.annmax_livestemc;
+		bgcin->cinit.max_livecrootc = epv.annmax_livecrootc;
+
+		if (bgcin->ctrl.onscreen)
+		{
+			printf("-----------------------------------------\n");
+			printf("Start of transient run.\n");
+		}
+
+		errorCode = transient_bgc(bgcin, bgcout);
+		if (errorCode)
+		{
+			printf("ERROR in call to transient_bgc.c\n");
+		}
+
+		ws = bgcin->ws;
+		cs = bgcin->cs;
+		ns = bgcin->ns;
+	}
+
+	/* RESTART OUTPUT HANDLING */
+	if (!errorCode && bgcin->ctrl.write_restart)
+	{
+		if (restart_output(&ws, &cs, &ns, &epv, &(bgcout->restart_output)))
+		{
+			printf("ERROR in call to restart_output.c from spinup_cache.c\n");
+			errorCode=600;
+		}
+	}
+
+	return (errorCode);
+}
+
+
+int spinup_cache_store(const bgcin_struct* bgcin, const bgcout_struct* bgcout, const wstate_struct* ws, const cstate_struct* cs,
+	                   const nstate_struct* ns, const epvar_struct* epv)
+{
+	int errorCode=0;
+	int i;
+	double feature[N_WARMFEATURES];
+	file cache_file, library_file;
+	spinupcache_header_struct header;
+	spinupcache_entry_struct* entry;
+
+	const spinupopt_struct* SPO = &bgcin->SPO;
+
+	memset(&header, 0, sizeof(spinupcache_header_struct));
+	header.magic   = SPINUPCACHE_MAGIC;
+	header.version = SPINUPCACHE_VERSION;
+	strcpy(header.model, SPINUPCACHE_MODEL);
+	header.key     = SPO->cache_key;
+	header.check   = SPO->cache_check;
+	header.size_ws  = (int) sizeof(wstate_struct);
+	header.size_cs  = (int) sizeof(cstate_struct);
+	header.size_ns  = (int) sizeof(nstate_struct);
+	header.size_epv = (int) sizeof(epvar_struct);
+	header.spinup_years       = bgcout->spinup_years;
+	header.spinup_resid_trend = bgcout->spinup_resid_trend;
+
+	strcpy(cache_file.name, SPO->cache_file);
+	if (file_open(&cache_file,'w',1))
+	{
+		errorCode=1;
+	}
+
+	if (!errorCode)
+	{
+		if (fwrite(&header, sizeof(spinupcache_header_struct), 1, cache_file.ptr) != 1 ||
+			fwrite(ws,  sizeof(wstate_struct), 1, cache_file.ptr) != 1 ||
+			fwrite(cs,  sizeof(cstate_struct), 1, cache_file.ptr) != 1 ||
+			fwrite(ns,  sizeof(nstate_struct), 1, cache_file.ptr) != 1 ||
+			fwrite(epv, sizeof(epvar_struct),  1, cache_file.ptr) != 1)
+		{
+			errorCode=1;
+		}
+		fclose(cache_file.ptr);
+
+		/* incomplete entries are removed (they would be stale in the next run) */
+		if (errorCode) remove(cache_file.name);
+	}
+
+	if (errorCode)
+	{
+		if (SPO->cache_strict)
+			printf("ERROR writing spinup cache entry %s\n", SPO->cache_file);
+		else
+		{
+			printf("WARNING: spinup cache entry %s could not be written\n", SPO->cache_file);
+			errorCode=0;
+		}
+	}
+	else
+	{
+		if (bgcin->ctrl.onscreen) printf("INFORMATION: end-of-spinup state stored in spinup cache: %s\n", SPO->cache_file);
+
+		/* server mode: the entry is kept also in the memory of the server */
+		entry = (spinupcache_entry_struct*) malloc(sizeof(spinupcache_entry_struct));
+		if (entry)
+		{
+			entry->header = header;
+			entry->ws     = *ws;
+			entry->cs     = *cs;
+			entry->ns     = *ns;
+			entry->epv    = *epv;
+			server_cache_insert(SRVCACHE_SPINUP, header.key, header.check, entry, sizeof(spinupcache_entry_struct));
+			free(entry);
+		}
+
+		/* adding the entry to the state library index (key, spinup years, features) if it is not listed yet (a rewritten
+		   entry keeps its line) */
+		spinup_cache_features(bgcin, feature);
+		if (spinup_cache_indexname(library_file.name, spinup_cache_dir(SPO)))
+			printf("WARNING: name of the state library index is too long (directory: %s)\n", spinup_cache_dir(SPO));
+		else if (!spinup_library_listed(library_file.name, SPO->cache_key))
+		{
+			if (!file_open(&library_file,'a',0))
+			{
+				fprintf(library_file.ptr, "%016llx %6i", SPO->cache_key, bgcout->spinup_years);
+				for (i = 0; i < N_WARMFEATURES; i++) fprintf(library_file.ptr, " %12.6f", feature[i]);
+				fprintf(library_file.ptr, "\n");
+				fclose(library_file.ptr);
+			}
+			else
+				printf("WARNING: state library index %s could not be written\n", library_file.name);
+		}
+	}
+
+	return (errorCode);
+}
+
+
+int spinup_cache_warmstart(bgcin_struct* bgcin)
+{
+	int errorCode=0;
+	int i, years, ok_scan;
+	unsigned long long key;
+	double dist, diff, feature[N_WARMFEATURES], featureLIB[N_WARMFEATURES];
+	file library_file;
+	char entry[FILENAMESIZE];
+	spinupcache_header_struct header;
+	wstate_struct ws;
+	cstate_struct cs;
+	nstate_struct ns;
+	epvar_struct epv;
+
+	spinupopt_struct* SPO = &bgcin->SPO;
+
+	SPO->warm_years = -1;
+	SPO->warm_dist  = DATA_GAP;
+
+	/* in case of restart input the initial state is defined by the restart file */
+	if (bgcin->ctrl.read_restart) return (errorCode);
+
+	if (spinup_cache_indexname(library_file.name, SPO->library_dir))
+	{
+		printf("WARNING: name of the state library index is too long (directory: %s), spinup without warm start\n", SPO->library_dir);
+		return (errorCode);
+	}
+	if (file_open(&library_file,'j',0))
+	{
+		if (bgcin->ctrl.onscreen) printf("INFORMATION: no state library found (%s), spinup without warm start\n", library_file.name);
+		return (errorCode);
+	}
+
+	spinup_cache_features(bgcin, feature);
+
+	/* searching the nearest neighbour: weighted distance of soil (0-2), climate (3-4) and EPC (5-7) features */
+	while ((ok_scan = fscanf(library_file.ptr, "%llx%d", &key, &years)) == 2)
+	{
+		for (i = 0; i < N_WARMFEATURES && fscanf(library_file.ptr, "%lf", &featureLIB[i]) == 1; i++);
+		if (i < N_WARMFEATURES) break;
+
+		dist = 0;
+		for (i = 0; i < N_WARMFEATURES; i++)
+		{
+			diff = feature[i] - featureLIB[i];
+			if (i < 3)
+				dist += SPO->warm_weight[0] * diff * diff;
+			else if (i < 5)
+				dist += SPO->warm_weight[1] * diff * diff;
+			else
+				dist += SPO->warm_weight[2] * diff * diff;
+		}
+		dist = sqrt(dist);
+
+		if ((SPO->warm_maxdist == DATA_GAP || dist <= SPO->warm_maxdist) && (SPO->warm_dist == DATA_GAP || dist < SPO->warm_dist))
+		{
+			if (!spinup_cache_entryname(entry, SPO->library_dir, key) && !spinup_cache_read(entry, 0, 0, &header, &ws, &cs, &ns, &epv))
+			{
+				SPO->warm_dist  = dist;
+				SPO->warm_years = header.spinup_years;
+				strcpy(SPO->warm_file, entry);
+
+				/* seeding the carbon and nitrogen pools; water state remains consistent with the actual soil */
+				bgcin->cs = cs;
+				bgcin->ns = ns;
+			}
+		}
+	}
+	fclose(library_file.ptr);
+
+	if (bgcin->ctrl.onscreen)
+	{
+		if (SPO->warm_years >= 0)
+			printf("INFORMATION: warm start from %s (distance: %.4f)\n", SPO->warm_file, SPO->warm_dist);
+		else
+			printf("INFORMATION: no suitable state in library, spinup without warm start\n");
+	}
+
+	return (errorCode);
+}
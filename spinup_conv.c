@@ -0,0 +1,191 @@
+/*
+spinup_conv.c
+spinup convergence monitor: annual tracking of litter C, CWD C, SOM C and soil N in every soil layer,
+exponential approach fitted yearly to the means of three met-cycle windows of the last years (sliding by one
+year) to estimate the projected trend and the residual of the pools
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_func.h"
+#include "bgc_constants.h"
+
+static const char* convpool_names[N_CONVPOOLS] = {"litter C", "CWD C", "SOM C", "soil N"};
+
+int conv_monitor_init(const control_struct* ctrl, convmonitor_struct* conv)
+{
+	int errorCode=0;
+
+	memset(conv, 0, sizeof(convmonitor_struct));
+	conv->ncycle      = ctrl->simyears;
+	conv->limit_pool  = -1;
+	conv->limit_layer = -1;
+	conv->limit_ratio = DATA_GAP;
+
+	/* end-of-year pools of three met cycles (lifetime array of the simulation) */
+	conv->history = (double*) arena_malloc(3 * conv->ncycle * N_CONVPOOLS * N_SOILLAYERS * sizeof(double));
+	if (!conv->history)
+	{
+		printf("ERROR allocating for the history of the convergence monitor, conv_monitor_init()\n");
+		errorCode=1;
+	}
+
+	return (errorCode);
+}
+
+
+int conv_monitor_update(const control_struct* ctrl, const cstate_struct* cs, const nstate_struct* ns, int Nadd, 
+	                    double spinup_tolerance, int minwindows, convmonitor_struct* conv)
+{
+	int errorCode=0;
+	int pool, layer, w, y, nhist;
+	double d1, d2, r, totalC, tol_pool, ratio;
+	double* pools;
+
+	nhist = 3 * conv->ncycle;
+
+	/* 1. end-of-year pools in the history: a year with spinup N-addition restarts the history */
+	if (Nadd)
+	{
+		conv->nyears = 0;
+		return (errorCode);
+	}
+
+	pools = conv->history + (conv->nyears % nhist) * N_CONVPOOLS * N_SOILLAYERS;
+	for (layer = 0; layer < N_SOILLAYERS; layer++)
+	{
+		pools[0 * N_SOILLAYERS + layer] = cs->litr1c[layer] + cs->litr2c[layer] + cs->litr3c[layer] + cs->litr4c[layer];
+		pools[1 * N_SOILLAYERS + layer] = cs->cwdc[layer];
+		pools[2 * N_SOILLAYERS + layer] = cs->soil1c[layer] + cs->soil2c[layer] + cs->soil3c[layer] + cs->soil4c[layer];
+		pools[3 * N_SOILLAYERS + layer] = ns->soil1n[layer] + ns->soil2n[layer] + ns->soil3n[layer] + ns->soil4n[layer] + 
+			                              ns->sminNH4[layer] + ns->sminNO3[layer];
+	}
+	conv->nyears++;
+
+	if (conv->nyears < nhist || conv->nyears < minwindows * conv->ncycle) return (errorCode);
+
+	/* 2. means of the three met-cycle windows of the last 3*ncycle years: the windows slide by one year, every window holds
+	      each year of the met cycle once (the met-cycle variation of the pools is averaged out), the decision is made yearly */
+	memset(conv->mean, 0, sizeof(conv->mean));
+	for (y = conv->nyears - nhist; y < conv->nyears; y++)
+	{
+		w     = (y - (conv->nyears - nhist)) / conv->ncycle;
+		pools = conv->history + (y % nhist) * N_CONVPOOLS * N_SOILLAYERS;
+		for (pool = 0; pool < N_CONVPOOLS; pool++)
+			for (layer = 0; layer < N_SOILLAYERS; layer++)
+				conv->mean[w][pool][layer] += pools[pool * N_SOILLAYERS + layer] / conv->ncycle;
+	}
+
+	/* 3. relative tolerance: the trend limit of total soil C (spinup_tolerance) related to the actual total soil C */
+	totalC = 0;
+	for (pool = 0; pool < 3; pool++)
+		for (layer = 0; layer < N_SOILLAYERS; layer++)
+			totalC += conv->mean[2][pool][layer];
+
+	if (totalC > CRIT_PREC)
+		conv->tolerance = spinup_tolerance / totalC;
+	else
+		conv->tolerance = spinup_tolerance;
+
+	/* 4. exponential approach (x(n) = x_eq - A*r^n) fitted to the three window means: 
+	      r = d2/d1, projected change in the next window = r*d2, residual = r*d2/(1-r). 
+		  Non-monotonic or accelerating series are tested with their latest change. */
+	conv->limit_ratio  = 0;
+	conv->trend_totalC = 0;
+	for (pool = 0; pool < N_CONVPOOLS; pool++)
+	{
+		for (layer = 0; layer < N_SOILLAYERS; layer++)
+		{
+			d1 = conv->mean[1][pool][layer] - conv->mean[0][pool][layer];
+			d2 = conv->mean[2][pool][layer] - conv->mean[1][pool][layer];
+
+			if (d1 * d2 > 0 && fabs(d2) < fabs(d1))
+			{
+				r = d2 / d1;
+				conv->trend[pool][layer]    = r * d2 / ctrl->simyears;
+				conv->residual[pool][layer] = r * d2 / (1 - r);
+			}
+			else
+			{
+				conv->trend[pool][layer]    = d2 / ctrl->simyears;
+				conv->residual[pool][layer] = d2;
+			}
+
+			if (pool < 3) conv->trend_totalC += conv->trend[pool][layer];
+
+			tol_pool = conv->tolerance * fabs(conv->mean[2][pool][layer]) + CRIT_PREC;
+			ratio    = fabs(conv->trend[pool][layer]) / tol_pool;
+			if (ratio >= conv->limit_ratio)
+			{
+				conv->limit_ratio = ratio;
+				conv->limit_pool  = pool;
+				conv->limit_layer = layer;
+			}
+		}
+	}
+
+	conv->converged = (conv->limit_ratio < 1);
+
+	return (errorCode);
+}
+
+
+int conv_monitor_report(file logfile, const convmonitor_struct* conv)
+{
+	int errorCode=0;
+	int pool, layer, maxlayer;
+	double ratio, maxratio;
+
+	fprintf(logfile.ptr, "SPINUP CONVERGENCE MONITOR\n");
+	fprintf(logfile.ptr, "number of consecutive years without N-addition:              %12i\n", conv->nyears);
+
+	if (conv->limit_pool < 0)
+	{
+		fprintf(logfile.ptr, "not enough years for trend estimation (three met-cycle windows)\n");
+		fprintf(logfile.ptr, " \n");
+		return (errorCode);
+	}
+
+	if (conv->converged)
+		fprintf(logfile.ptr, "end of spinup: projected trends of all pools below tolerance\n");
+	
+	fprintf(logfile.ptr, "relative tolerance of pool trends [1/yr]:                   %12.3e\n", conv->tolerance);
+	fprintf(logfile.ptr, "projected trend of total soil C [kgC/m2/yr]:                %12.3e\n", conv->trend_totalC);
+	fprintf(logfile.ptr, "limiting pool: %s in soil layer %i (trend/tolerance: %.3f)\n", 
+		    convpool_names[conv->limit_pool], conv->limit_layer+1, conv->limit_ratio);
+	fprintf(logfile.ptr, "projected trend of limiting pool [kg/m2/yr]:                %12.3e\n", conv->trend[conv->limit_pool][conv->limit_layer]);
+	fprintf(logfile.ptr, "estimated residual of limiting pool [kg/m2]:                %12.3e\n", conv->residual[conv->limit_pool][conv->limit_layer]);
+
+	/* most limiting layer of each pool group */
+	for (pool = 0; pool < N_CONVPOOLS; pool++)
+	{
+		maxratio = 0;
+		maxlayer = 0;
+		for (layer = 0; layer < N_SOILLAYERS; layer++)
+		{
+			ratio = fabs(conv->trend[pool][layer]) / (conv->tolerance * fabs(conv->mean[2][pool][layer]) + CRIT_PREC);
+			if (ratio > maxratio)
+			{
+				maxratio = ratio;
+				maxlayer = layer;
+			}
+		}
+		fprintf(logfile.ptr, "%-8s - most limiting layer: %2i  trend/tolerance: %12.3f\n", convpool_names[pool], maxlayer+1, maxratio);
+	}
+	fprintf(logfile.ptr, " \n");
+
+	return (errorCode);
+}
@@ -0,0 +1,162 @@
+/*
+spinupopt_init.c
+read optional spinup settings (spinup cache, warm start, convergence monitor) if they are available
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#include "bgc_constants.h"
+#include "bgc_func.h"
+
+
+int spinupopt_init(spinupopt_struct* SPO, control_struct* ctrl)
+{
+	int errorCode=0;
+	file SPO_file;
+	char keyword[STRINGSIZE];
+
+	/* default values: no spinup cache, no warm start, original steady-state test */
+	SPO->cache_flag   = 0;
+	SPO->cache_strict = 0;
+	SPO->cache_hit    = 0;
+	SPO->cache_key    = 0;
+	SPO->cache_check  = 0;
+	strcpy(SPO->cache_dir, ".");
+	strcpy(SPO->cache_file, "");
+	SPO->warm_flag      = 0;
+	strcpy(SPO->library_dir, ".");
+	SPO->warm_weight[0] = 1;
+	SPO->warm_weight[1] = 1;
+	SPO->warm_weight[2] = 1;
+	SPO->warm_maxdist   = DATA_GAP;
+	SPO->warm_years     = -1;
+	SPO->warm_dist      = DATA_GAP;
+	strcpy(SPO->warm_file, "");
+	SPO->conv_flag       = 0;
+	SPO->conv_minwindows = 3;
+
+	/********************************************************************
+	**                                                                 **
+	** Reading spinup options if available (only in spinup run)        **
+	**                                                                 **
+	********************************************************************/
+
+	if (ctrl->spinup == 0) return (errorCode);
+
+	strcpy(SPO_file.name, "spinup_options.txt");
+	if (file_open(&SPO_file,'j',1)) return (errorCode);
+
+	/* the file consists of keyword-blocks, the order of the blocks is arbitrary */
+	while (!errorCode && !scan_array(SPO_file, keyword, 's', 1, 0))
+	{
+		/* SPINUP_CACHE block: flag, directory of the cache entries, strict mode flag */
+		if (!strcmp(keyword, "SPINUP_CACHE"))
+		{
+			if (!errorCode && scan_value(SPO_file, &SPO->cache_flag, 'i'))
+			{
+				printf("ERROR reading spinup cache flag: spinupopt_init()\n");
+				errorCode=21901;
+			}
+			if (!errorCode && scan_value(SPO_file, SPO->cache_dir, 's'))
+			{
+				printf("ERROR reading directory of spinup cache: spinupopt_init()\n");
+				errorCode=21902;
+			}
+			if (!errorCode && scan_value(SPO_file, &SPO->cache_strict, 'i'))
+			{
+				printf("ERROR reading strict mode flag of spinup cache: spinupopt_init()\n");
+				errorCode=21903;
+			}
+			if (!errorCode && strlen(SPO->cache_dir) > FILENAMESIZE - 24)
+			{
+				printf("ERROR in spinup options: name of the spinup cache directory is too long\n");
+				errorCode=21904;
+			}
+		}
+		/* WARM_START block: flag, directory of the state library, weights of soil, climate and EPC features, maximal distance */
+		else if (!strcmp(keyword, "WARM_START"))
+		{
+			if (!errorCode && scan_value(SPO_file, &SPO->warm_flag, 'i'))
+			{
+				printf("ERROR reading warm start flag: spinupopt_init()\n");
+				errorCode=21905;
+			}
+			if (!errorCode && scan_value(SPO_file, SPO->library_dir, 's'))
+			{
+				printf("ERROR reading directory of state library: spinupopt_init()\n");
+				errorCode=21906;
+			}
+			if (!errorCode && scan_value(SPO_file, &SPO->warm_weight[0], 'd'))
+			{
+				printf("ERROR reading weight of soil features: spinupopt_init()\n");
+				errorCode=21907;
+			}
+			if (!errorCode && scan_value(SPO_file, &SPO->warm_weight[1], 'd'))
+			{
+				printf("ERROR reading weight of climate features: spinupopt_init()\n");
+				errorCode=21908;
+			}
+			if (!errorCode && scan_value(SPO_file, &SPO->warm_weight[2], 'd'))
+			{
+				printf("ERROR reading weight of EPC features: spinupopt_init()\n");
+				errorCode=21909;
+			}
+			if (!errorCode && scan_value(SPO_file, &SPO->warm_maxdist, 'd'))
+			{
+				printf("ERROR reading maximal distance of warm start: spinupopt_init()\n");
+				errorCode=21910;
+			}
+			if (!errorCode && (SPO->warm_weight[0] < 0 || SPO->warm_weight[1] < 0 || SPO->warm_weight[2] < 0))
+			{
+				printf("ERROR in spinup options: weights of warm start must be non-negative\n");
+				errorCode=21911;
+			}
+			if (!errorCode && strlen(SPO->library_dir) > FILENAMESIZE - 24)
+			{
+				printf("ERROR in spinup options: name of the state library directory is too long\n");
+				errorCode=21904;
+			}
+		}
+		/* CONVERGENCE block: flag of early end of spinup, minimum number of met-cycle windows */
+		else if (!strcmp(keyword, "CONVERGENCE"))
+		{
+			if (!errorCode && scan_value(SPO_file, &SPO->conv_flag, 'i'))
+			{
+				printf("ERROR reading convergence monitor flag: spinupopt_init()\n");
+				errorCode=21912;
+			}
+			if (!errorCode && scan_value(SPO_file, &SPO->conv_minwindows, 'i'))
+			{
+				printf("ERROR reading minimum number of met-cycle windows: spinupopt_init()\n");
+				errorCode=21913;
+			}
+			if (!errorCode && SPO->conv_minwindows < 3)
+			{
+				printf("ERROR in spinup options: at least 3 met-cycle windows are needed for the convergence monitor\n");
+				errorCode=21914;
+			}
+		}
+		else
+		{
+			printf("ERROR in spinup_options.txt: unknown keyword --> %s\n", keyword);
+			errorCode=219;
+		}
+	}
+
+	fclose(SPO_file.ptr);
+
+	return (errorCode);
+}
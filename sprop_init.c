@@ -27,10 +27,10 @@ which gave an error.
 #include "bgc_func.h"
 
 
-int sprop_init(file init, soilprop_struct* sprop, control_struct* ctrl)
+int sprop_init(file init, siteconst_struct* sitec, soilprop_struct* sprop, control_struct* ctrl)
 {
 	int errorCode=0;
-	int layer, scanflag;
+	int layer, scanflag, n_soillayers;
 	int dofilecloseSOILPROP = 1;
 	file sprop_file;
 	char key[] = "SOIL_FILE";
@@ -665,24 +665,25 @@ int sprop_init(file init, soilprop_struct* sprop, control_struct* ctrl)
 	/****************************/
 	/* SOIL COMPOSITION AND CHARACTERISTIC VALUES (-9999: no measured data) */
 	
-	/* SAND array - mulilayer soil  */
-	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	/* SAND array - mulilayer soil: the number of values gives the number of soil layers of the run */
+	if (!errorCode && scan_row(sprop_file, sprop->sand, N_SOILLAYERS, &n_soillayers))
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
-		if (!errorCode && scan_array(sprop_file, &(sprop->sand[layer]), 'd', scanflag, 1))
-		{
-			printf("ERROR reading percent sand in layer %i, sprop_init()\n", layer);
-			errorCode=208090;
-		}
+		printf("ERROR reading percent sand, sprop_init()\n");
+		errorCode=208090;
+	}
+
+	if (!errorCode && soillayer_init(sitec, n_soillayers))
+	{
+		printf("ERROR in soillayer_init() in sprop_init.c\n");
+		errorCode=2080901;
 	}
 	
 
 	/* SILT array - mulilayer soil   */
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(sprop_file, &(sprop->silt[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading percent silt in layer %i, sprop_init()\n", layer);
@@ -693,9 +694,9 @@ int sprop_init(file init, soilprop_struct* sprop, control_struct* ctrl)
 
 	/* pH array - mulilayer soil */
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(sprop_file, &(sprop->pH[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading soil pH in layer %i, sprop_init()\n", layer);
@@ -706,9 +707,9 @@ int sprop_init(file init, soilprop_struct* sprop, control_struct* ctrl)
 
 	/* soilB parameter - mulilayer soil */
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(sprop_file, &(sprop->soilB[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading soilB in layer %i, sprop_init()\n", layer);
@@ -719,9 +720,9 @@ int sprop_init(file init, soilprop_struct* sprop, control_struct* ctrl)
 
 	/* measured bulk density    */
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(sprop_file, &(sprop->BD_mes[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading BD_mes in layer %i, sprop_init()\n", layer);
@@ -732,9 +733,9 @@ int sprop_init(file init, soilprop_struct* sprop, control_struct* ctrl)
 
 	/* measured critical VWC values - saturation    */
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(sprop_file, &(sprop->VWCsat_mes[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading VWCsat_mes in layer %i, sprop_init()\n", layer);
@@ -745,9 +746,9 @@ int sprop_init(file init, soilprop_struct* sprop, control_struct* ctrl)
 	
 	/* measured critical VWC values - field capacity     */
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(sprop_file, &(sprop->VWCfc_mes[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading VWCfc_mes in layer %i, sprop_init()\n", layer);
@@ -758,9 +759,9 @@ int sprop_init(file init, soilprop_struct* sprop, control_struct* ctrl)
 	
 	/* measured critical VWC values - wilting point    */
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(sprop_file, &(sprop->VWCwp_mes[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading VWCwp_mes in layer %i, sprop_init()\n", layer);
@@ -771,9 +772,9 @@ int sprop_init(file init, soilprop_struct* sprop, control_struct* ctrl)
 
 	/* measured critical VWC values - hygr. water    */
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(sprop_file, &(sprop->VWChw_mes[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading VWChw_mes in layer %i, sprop_init()\n", layer);
@@ -786,7 +787,7 @@ int sprop_init(file init, soilprop_struct* sprop, control_struct* ctrl)
 	{	
 		if (sprop->VWCsat_mes[0] == DATA_GAP && sprop->VWCfc_mes[0] == DATA_GAP && sprop->VWCwp_mes[0] == DATA_GAP  && sprop->VWChw_mes[0] == DATA_GAP)
 		{	
-			for (layer=0; layer < N_SOILLAYERS; layer++)
+			for (layer=0; layer < sitec->n_soillayers; layer++)
 			{
 				sprop->VWCsat_mes[layer] = DATA_GAP;
 				sprop->VWCfc_mes[layer]  = DATA_GAP;
@@ -805,9 +806,9 @@ int sprop_init(file init, soilprop_struct* sprop, control_struct* ctrl)
 
 	/* measured drainage coeff */
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(sprop_file, &(sprop->drainCoeff_mes[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading drainCoeff_mes in layer %i, sprop_init()\n", layer);
@@ -818,9 +819,9 @@ int sprop_init(file init, soilprop_struct* sprop, control_struct* ctrl)
 
 	/* measured hydraulic conductivity  */
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(sprop_file, &(sprop->hydrCONTUCTsatMES_cmPERday[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading hydrCONTUCTsatMES_cmPERday in layer %i, sprop_init()\n", layer);
@@ -831,9 +832,9 @@ int sprop_init(file init, soilprop_struct* sprop, control_struct* ctrl)
 
    /* capillary fringe */
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(sprop_file, &(sprop->CapillFringeMES_cm[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading CapillFringeMES_cm in layer %i, sprop_init()\n", layer);
@@ -845,7 +846,7 @@ int sprop_init(file init, soilprop_struct* sprop, control_struct* ctrl)
 
 
 	/* MULTILAYER SOIL CALCULATION: calculation of soil properties layer by layer (soilb, BD, PSI and VWC critical values),hydr.conduct and hydr.diffus  */
-	if (!errorCode && multilayer_soilcalc(ctrl, sprop))
+	if (!errorCode && multilayer_soilcalc(ctrl, sitec, sprop))
 	{
 		printf("\n");
 		printf("ERROR in multilayer_soilcalc() in sprop_init.c\n");
@@ -949,7 +950,7 @@ int soilb_estimation(double sand, double silt, double* soilB, double* VWCsat,dou
   
 }
 
-int multilayer_soilcalc(control_struct* ctrl,  soilprop_struct* sprop)
+int multilayer_soilcalc(control_struct* ctrl, const siteconst_struct* sitec, soilprop_struct* sprop)
 {
 	int layer;
 	double m_to_cm, conduct_sat;
@@ -974,7 +975,7 @@ int multilayer_soilcalc(control_struct* ctrl,  soilprop_struct* sprop)
 	/* 2. Calculate the soil pressure-volume coefficients from texture data (soil water content, soil water potential and Clapp-Hornberger parameter) 
 		    - different estimation methods 4: modell estimtaion, talajharomszog, measured data )*/
 
-	for (layer=0; layer < N_SOILLAYERS; layer++)
+	for (layer=0; layer < sitec->n_soillayers; layer++)
 	{
 
 		sand		= sprop->sand[layer];
@@ -1119,7 +1120,7 @@ int multilayer_soilcalc(control_struct* ctrl,  soilprop_struct* sprop)
 	sprop->preGWlayer   = DATA_GAP;
 	sprop->GWlayer		= DATA_GAP;					
 	sprop->CFlayer		= DATA_GAP;		
-	for (layer = 0; layer<N_SOILLAYERS; layer++) 
+	for (layer = 0; layer<sitec->n_soillayers; layer++) 
 	{
 		sprop->GWeff[layer] = DATA_GAP;
 		sprop->CFeff[layer] = DATA_GAP;
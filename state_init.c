@@ -65,7 +65,7 @@ int wstate_init(file init, const siteconst_struct* sitec, const soilprop_struct*
 	{
 		/* calculate initial soilwater in kg/m2 from proportion of
 		field capacity volumetric water content, depth, and density of water */
-		for (layer = 0; layer < N_SOILLAYERS; layer ++)
+		for (layer = 0; layer < sitec->n_soillayers; layer ++)
 		{
 			if (prop_fc > sprop->VWCsat[layer]/sprop->VWCfc[layer])
 			{
@@ -161,9 +161,9 @@ int cnstate_init(file init, const epconst_struct* epc, const soilprop_struct* sp
 	/* 2. read the cwdc initial values in multilayer soil  */
 
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(init, &(cs->cwdc[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading cwdc in layer %i, cstate_init()\n", layer);
@@ -172,7 +172,7 @@ int cnstate_init(file init, const epconst_struct* epc, const soilprop_struct* sp
 	}
 
     /* to avoid dividing by 0: if no deadwood, cwdn is zero. */
-	for (layer = 0; layer < N_SOILLAYERS; layer++)
+	for (layer = 0; layer < sitec->n_soillayers; layer++)
 	{
 		if (!errorCode && epc->deadwood_cn > 0.0) 
 			ns->cwdn[layer] = cs->cwdc[layer]/epc->deadwood_cn;
@@ -184,9 +184,9 @@ int cnstate_init(file init, const epconst_struct* epc, const soilprop_struct* sp
 	/*--------------------------------------------------*/
 	/* 3. read the litter carbon pool initial values in multilayer soil  */
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(init, &(cs->litr1c[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading litter carbon in labile pool in layer %i, cstate_init()\n", layer);
@@ -195,9 +195,9 @@ int cnstate_init(file init, const epconst_struct* epc, const soilprop_struct* sp
 	}
 	
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(init, &(cs->litr2c[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading litter carbon in unshielded cellulose pool in layer %i, cstate_init()\n", layer);
@@ -206,9 +206,9 @@ int cnstate_init(file init, const epconst_struct* epc, const soilprop_struct* sp
 	}
 	
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(init, &(cs->litr3c[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading litter carbon in shielded cellulose pool in layer %i, cstate_init()\n", layer);
@@ -217,9 +217,9 @@ int cnstate_init(file init, const epconst_struct* epc, const soilprop_struct* sp
 	}
 
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(init, &(cs->litr4c[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading litter carbon in lignin pool in layer %i, cstate_init()\n", layer);
@@ -231,7 +231,7 @@ int cnstate_init(file init, const epconst_struct* epc, const soilprop_struct* sp
 	/* calculate the litter nitrogen pool initial values for cellulose and and lignin pools, 
 	using the leaf litter C:N as the basis for determining N content in all litter components  */
 	
-	for (layer = 0; layer < N_SOILLAYERS; layer++)
+	for (layer = 0; layer < sitec->n_soillayers; layer++)
 	{
 		ns->litr1n[layer] = cs->litr1c[layer] / epc->leaflitr_cn;
 		ns->litr2n[layer] = cs->litr2c[layer] / epc->leaflitr_cn;
@@ -244,9 +244,9 @@ int cnstate_init(file init, const epconst_struct* epc, const soilprop_struct* sp
 	/* 4. read the soil carbon pool initial values in multilayer soil  */
 
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(init, &(cs->soil1c[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading labile SOM carbon pool in layer %i, cstate_init()\n", layer);
@@ -255,9 +255,9 @@ int cnstate_init(file init, const epconst_struct* epc, const soilprop_struct* sp
 	}
 		
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(init, &(cs->soil2c[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading fast decomposing SOM carbon pool in layer %i, cstate_init()\n", layer);
@@ -266,9 +266,9 @@ int cnstate_init(file init, const epconst_struct* epc, const soilprop_struct* sp
 	}
 
  	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(init, &(cs->soil3c[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading slow decomposing SOM carbon pool in layer %i, cstate_init()\n", layer);
@@ -278,9 +278,9 @@ int cnstate_init(file init, const epconst_struct* epc, const soilprop_struct* sp
 
 
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(init, &(cs->soil4c[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading stable SOM carbon pool in layer %i, cstate_init()\n", layer);
@@ -290,7 +290,7 @@ int cnstate_init(file init, const epconst_struct* epc, const soilprop_struct* sp
 
 
 	/* multilayer soil */
-	for (layer = 0; layer < N_SOILLAYERS; layer++)
+	for (layer = 0; layer < sitec->n_soillayers; layer++)
 	{
 		ns->soil1n[layer] = cs->soil1c[layer]/sprop->soil1_CN;
 		ns->soil2n[layer] = cs->soil2c[layer]/sprop->soil2_CN;
@@ -300,9 +300,9 @@ int cnstate_init(file init, const epconst_struct* epc, const soilprop_struct* sp
 	
 	/* 5. read nitrogen state variable initial values from *.init */
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(init, &trash, 'd', scanflag, 1))
 		{
 			printf("ERROR reading litter nitrogen in labile pool layer %i, cnstate_init()\n", layer);
@@ -311,9 +311,9 @@ int cnstate_init(file init, const epconst_struct* epc, const soilprop_struct* sp
 	}
 	
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(init, &(sminNH4_ppm[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading soil mineral nitrogen (NH4 pool) in layer %i, cnstate_init()\n", layer);
@@ -322,9 +322,9 @@ int cnstate_init(file init, const epconst_struct* epc, const soilprop_struct* sp
 	}
 
 	scanflag=0; 
-	for (layer=0; layer<N_SOILLAYERS; layer++)
+	for (layer=0; layer<sitec->n_soillayers; layer++)
 	{
-		if (layer==N_SOILLAYERS-1) scanflag=1;
+		if (layer==sitec->n_soillayers-1) scanflag=1;
 		if (!errorCode && scan_array(init, &(sminNO3_ppm[layer]), 'd', scanflag, 1))
 		{
 			printf("ERROR reading soil mineral nitrogen (NO3 pool) in layer %i, cnstate_init()\n", layer);
@@ -26,7 +26,7 @@ for complete description of this change.
 #include "bgc_constants.h"
 
 
-int water_state_update(const wflux_struct* wf, wstate_struct* ws)
+int water_state_update(const siteconst_struct* sitec, const wflux_struct* wf, wstate_struct* ws)
 {
 	/* daily update of the water state variables */
 	 
@@ -62,13 +62,13 @@ int water_state_update(const wflux_struct* wf, wstate_struct* ws)
 	/* runoff */
 	ws->runoff_snk	  += wf->pondw_to_runoff;
 	 
-	ws->deeppercolation_snk += wf->soilwFlux[N_SOILLAYERS-1];
+	ws->deeppercolation_snk += wf->soilwFlux[sitec->n_soillayers-1];
 		
 	/* groundwater src/snk */
 
 	preGWsrc = ws->groundwater_src;
 
-	for (layer = 0; layer < N_SOILLAYERS; layer++)
+	for (layer = 0; layer < sitec->n_soillayers; layer++)
 	{
 		ws->groundwater_src += wf->GWdischarge[layer];
 
@@ -109,7 +109,7 @@ int CN_state_update(const siteconst_struct* sitec, const epconst_struct* epc, co
 	double cwdc_total1, cwdc_total2, litrc_total1, litrc_total2;
 	cwdc_total1=cwdc_total2=litrc_total1=litrc_total2=0;
 			
-	for (layer = 0; layer < N_SOILLAYERS; layer++) 
+	for (layer = 0; layer < sitec->n_soillayers; layer++) 
 	{
 		cwdc_total1 += cs->cwdc[layer];
 		litrc_total1 += cs->litr1c[layer] + cs->litr2c[layer] + cs->litr3c[layer] + cs->litr4c[layer];
@@ -378,7 +378,7 @@ int CN_state_update(const siteconst_struct* sitec, const epconst_struct* epc, co
 	frootn_to_litr = nf->frootn_to_litr1n + nf->frootn_to_litr2n + nf->frootn_to_litr3n + nf->frootn_to_litr4n;
 	if (!errorCode && epc->froot_cn && CNratio_control(cs, epc->froot_cn, cs->frootc, ns->frootn, frootc_to_litr, frootn_to_litr, 0)) 
 	{
-		for (layer = 0; layer < N_SOILLAYERS; layer++)
+		for (layer = 0; layer < sitec->n_soillayers; layer++)
 		{
 			cs->litr1c[layer] += cf->frootc_to_litr1c * epv->rootlengthProp[layer];
 			cs->litr2c[layer] += cf->frootc_to_litr2c * epv->rootlengthProp[layer];
@@ -427,7 +427,7 @@ int CN_state_update(const siteconst_struct* sitec, const epconst_struct* epc, co
 
 	
 	/* 8. Litter decomposition fluxes - MULTILAYER SOIL */
-	for (layer = 0; layer < N_SOILLAYERS; layer++)
+	for (layer = 0; layer < sitec->n_soillayers; layer++)
 	{
 		/* Fluxes out of coarse woody debris into litter pools */
 		cs->litr2c[layer]       += cf->cwdc_to_litr2c[layer];
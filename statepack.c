@@ -0,0 +1,291 @@
+/*
+statepack.c
+compact format of the stored simulation state (snapshots of the incremental re-simulation, states of ensembles):
+the daily fluxes are not stored since they are set to zero at the beginning of the next simulation day
+(make_zero_flux_struct()) and are recalculated by the daily step; the temporary nitrogen variables of the decomposition
+(nt) are not stored either, decomp() sets them every day before daily_allocation() reads them.
+All other variables are kept, also the diagnostic ones, since they carry history over the days: epv (e.g. the leaf
+cohorts of the genetically programmed senescence), metv (e.g. the acclimation temperature of the previous day), psn
+(not recalculated on days without leaves, but written to the outputs) and summary (cumulated values)
+
+modes of the format:
+STATEPACK_FULL:       the complete state
+STATEPACK_NOFLUX:     the state without the daily fluxes
+STATEPACK_COMPACT:    the state without the daily fluxes, runs of zero words are stored by their length
+
+a packed state: header, then the stored 8-byte words of the state (STATEPACK_COMPACT: pairs of
+the number of zero words and the number of literal words (2 x 16 bit), followed by the literal words)
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "bgc_func.h"
+#include "bgc_io.h"
+
+#define STATEPACK_MAGIC  0x4B505453U						/* "STPK" */
+#define STATEPACK_NWORD  (sizeof(resimstate_struct) / sizeof(unsigned long long))
+#define STATEPACK_MAXRUN 65535								/* maximal length of a run in the compact mode */
+
+/* header of a packed state */
+typedef struct
+{
+	unsigned int magic;
+	int mode;
+	int size_state;
+	int nbytes;			/* (byte) size of the packed words (without the header) */
+} statepack_header_struct;
+
+/* words of the state which are kept in the noflux and compact modes (1) and daily fluxes and nt (0) */
+static unsigned char statepack_mask[STATEPACK_NWORD];
+static int statepack_ready = 0;
+
+
+/* the daily fluxes are the words set to zero by make_zero_flux_struct(): new flux variables are handled automatically;
+   nt is recalculated by decomp() before its first use on the next day */
+static void statepack_mask_init(void)
+{
+	resimstate_struct* probe;
+	const unsigned long long* word;
+	size_t w;
+
+	#pragma omp critical (statepack)
+	{
+		if (!statepack_ready)
+		{
+			probe = (resimstate_struct*) malloc(sizeof(resimstate_struct));
+			if (probe)
+			{
+				memset(probe, 0xFF, sizeof(resimstate_struct));
+				make_zero_flux_struct(&probe->wf, &probe->cf, &probe->nf, &probe->gwc);
+				memset(&probe->nt, 0, sizeof(ntemp_struct));
+				word = (const unsigned long long*) probe;
+				for (w = 0; w < STATEPACK_NWORD; w++) statepack_mask[w] = (word[w] != 0);
+				free(probe);
+			}
+			else
+			{
+				/* without the probe all words are kept */
+				memset(statepack_mask, 1, STATEPACK_NWORD);
+			}
+			statepack_ready = 1;
+		}
+	}
+}
+
+
+size_t state_packbound(void)
+{
+	/* maximal size of a packed state (compact mode: one run header per word in the worst case) */
+	return (sizeof(statepack_header_struct) + STATEPACK_NWORD * (sizeof(unsigned long long) + 2 * sizeof(unsigned short)) +
+		    2 * sizeof(unsigned short));
+}
+
+
+int state_pack(const resimstate_struct* state, int mode, unsigned char* buffer, size_t* nbytes)
+{
+	/* the buffer has to be at least state_packbound() bytes */
+	statepack_header_struct header;
+	const unsigned long long* word = (const unsigned long long*) state;
+	unsigned char* pos;
+	unsigned short nzero, nlit;
+	size_t w, v;
+
+	if (mode < STATEPACK_FULL || mode > STATEPACK_COMPACT)
+	{
+		printf("ERROR in mode of the state format (%i), state_pack()\n", mode);
+		return (1);
+	}
+
+	statepack_mask_init();
+
+	pos = buffer + sizeof(statepack_header_struct);
+
+	switch (mode)
+	{
+	case STATEPACK_FULL:
+		memcpy(pos, state, sizeof(resimstate_struct));
+		pos += sizeof(resimstate_struct);
+		break;
+
+	case STATEPACK_NOFLUX:
+		for (w = 0; w < STATEPACK_NWORD; w++)
+		{
+			if (!statepack_mask[w]) continue;
+			memcpy(pos, &word[w], sizeof(unsigned long long));
+			pos += sizeof(unsigned long long);
+		}
+		break;
+
+	default:
+		w = 0;
+		while (w < STATEPACK_NWORD)
+		{
+			/* run of zero words (the daily fluxes are skipped), then run of literal words */
+			nzero = 0;
+			while (w < STATEPACK_NWORD && nzero < STATEPACK_MAXRUN && (!statepack_mask[w] || word[w] == 0))
+			{
+				if (statepack_mask[w]) nzero++;
+				w++;
+			}
+			nlit = 0;
+			for (v = w; v < STATEPACK_NWORD && nlit < STATEPACK_MAXRUN && statepack_mask[v] && word[v] != 0; v++) nlit++;
+
+			memcpy(pos, &nzero, sizeof(unsigned short));
+			memcpy(pos + sizeof(unsigned short), &nlit, sizeof(unsigned short));
+			pos += 2 * sizeof(unsigned short);
+			memcpy(pos, &word[w], nlit * sizeof(unsigned long long));
+			pos += nlit * sizeof(unsigned long long);
+			w += nlit;
+		}
+		break;
+	}
+
+	header.magic      = STATEPACK_MAGIC;
+	header.mode       = mode;
+	header.size_state = (int) sizeof(resimstate_struct);
+	header.nbytes     = (int) (pos - buffer - sizeof(statepack_header_struct));
+	memcpy(buffer, &header, sizeof(statepack_header_struct));
+
+	*nbytes = (size_t) (pos - buffer);
+
+	return (0);
+}
+
+
+int state_unpack(const unsigned char* buffer, size_t nbytes, resimstate_struct* state)
+{
+	/* the daily fluxes and nt of the noflux and compact modes are set to zero (the fluxes: their value after make_zero_flux_struct()) */
+	int errorCode=0;
+	statepack_header_struct header;
+	unsigned long long* word = (unsigned long long*) state;
+	const unsigned char* pos;
+	const unsigned char* end;
+	unsigned short nzero, nlit;
+	size_t w;
+
+	if (nbytes < sizeof(statepack_header_struct)) return (1);
+	memcpy(&header, buffer, sizeof(statepack_header_struct));
+	if (header.magic != STATEPACK_MAGIC || header.size_state != (int) sizeof(resimstate_struct) || header.nbytes < 0 ||
+		(size_t) header.nbytes + sizeof(statepack_header_struct) != nbytes)
+	{
+		printf("ERROR in format of the packed state, state_unpack()\n");
+		return (1);
+	}
+
+	statepack_mask_init();
+
+	pos = buffer + sizeof(statepack_header_struct);
+	end = buffer + nbytes;
+
+	switch (header.mode)
+	{
+	case STATEPACK_FULL:
+		if ((size_t) (end - pos) != sizeof(resimstate_struct))
+			errorCode=1;
+		else
+			memcpy(state, pos, sizeof(resimstate_struct));
+		break;
+
+	case STATEPACK_NOFLUX:
+		memset(state, 0, sizeof(resimstate_struct));
+		for (w = 0; !errorCode && w < STATEPACK_NWORD; w++)
+		{
+			if (!statepack_mask[w]) continue;
+			if (end - pos < (long) sizeof(unsigned long long))
+				errorCode=1;
+			else
+			{
+				memcpy(&word[w], pos, sizeof(unsigned long long));
+				pos += sizeof(unsigned long long);
+			}
+		}
+		if (pos != end) errorCode=1;
+		break;
+
+	case STATEPACK_COMPACT:
+		memset(state, 0, sizeof(resimstate_struct));
+		w = 0;
+		while (!errorCode && pos < end)
+		{
+			if (end - pos < (long) (2 * sizeof(unsigned short)))
+			{
+				errorCode=1;
+				break;
+			}
+			memcpy(&nzero, pos, sizeof(unsigned short));
+			memcpy(&nlit, pos + sizeof(unsigned short), sizeof(unsigned short));
+			pos += 2 * sizeof(unsigned short);
+
+			/* the zero run counts only the kept words (the daily fluxes between them remain zero) */
+			while (w < STATEPACK_NWORD && (nzero || !statepack_mask[w]))
+			{
+				if (statepack_mask[w]) nzero--;
+				w++;
+			}
+			if (nzero || w + nlit > STATEPACK_NWORD || end - pos < (long) (nlit * sizeof(unsigned long long)))
+			{
+				errorCode=1;
+				break;
+			}
+			memcpy(&word[w], pos, nlit * sizeof(unsigned long long));
+			pos += nlit * sizeof(unsigned long long);
+			w += nlit;
+		}
+		break;
+
+	default:
+		errorCode=1;
+		break;
+	}
+
+	if (errorCode) printf("ERROR in format of the packed state, state_unpack()\n");
+
+	return (errorCode);
+}
+
+
+int state_packreport(const resimstate_struct* state, file logfile)
+{
+	/* bytes per site of the stored state in each mode */
+	int errorCode=0;
+	int mode;
+	size_t nbytes[3];
+	unsigned char* buffer;
+	static const char* modename[] = {"full", "noflux", "compact"};
+
+	buffer = (unsigned char*) malloc(state_packbound());
+	if (!buffer)
+	{
+		printf("ERROR allocating for packed state, state_packreport()\n");
+		return (1);
+	}
+
+	for (mode = STATEPACK_FULL; !errorCode && mode <= STATEPACK_COMPACT; mode++)
+		errorCode = state_pack(state, mode, buffer, &nbytes[mode]);
+
+	if (!errorCode)
+	{
+		fprintf(logfile.ptr, "SIZE OF THE STORED STATE (bytes per site)\n");
+		for (mode = STATEPACK_FULL; mode <= STATEPACK_COMPACT; mode++)
+			fprintf(logfile.ptr, "%-10s %8lu\n", modename[mode], (unsigned long) nbytes[mode]);
+		fprintf(logfile.ptr, "not stored in noflux and compact: daily fluxes, temporary variables of decomposition\n");
+		fprintf(logfile.ptr, "kept diagnostic variables (history over days): epv, metv, psn, summary\n");
+		fprintf(logfile.ptr, " \n");
+	}
+
+	free(buffer);
+
+	return (errorCode);
+}
+
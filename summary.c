@@ -227,7 +227,7 @@ int cnw_summary(const epconst_struct* epc, const siteconst_struct* sitec, const
 	summary->litrN_maxRZ = 0;
 	summary->sminNavail_maxRZ = 0;
 
-	for (layer = 0; layer < N_SOILLAYERS; layer++)
+	for (layer = 0; layer < sitec->n_soillayers; layer++)
 	{
 		/* sminNH4: kgN/m2; BD: g/cm3 -> kg/m3: *10-3; ppm: *1000000 */
 		summary->sminNH4_ppm[layer] = ns->sminNH4[layer] / (sprop->BD[layer] * g_per_cm3_to_kg_per_m3 * sitec->soillayer_thickness[layer]) * 1000000;
@@ -313,7 +313,7 @@ int cnw_summary(const epconst_struct* epc, const siteconst_struct* sitec, const
 	summary->soil3HR_total=0;
 	summary->soil4HR_total=0;
 
-	for (layer = 0; layer < N_SOILLAYERS; layer++)
+	for (layer = 0; layer < sitec->n_soillayers; layer++)
 	{
 		summary->litr1HR_total += cf->litr1_hr[layer];
 		summary->litr2HR_total += cf->litr2_hr[layer];
@@ -394,7 +394,7 @@ int cnw_summary(const epconst_struct* epc, const siteconst_struct* sitec, const
 	summary->litter = cs->litr1c_total + cs->litr2c_total + cs->litr3c_total + cs->litr4c_total;
 	
 	summary->litdecomp = 0;
-	for (layer = 0; layer < N_SOILLAYERS; layer++)
+	for (layer = 0; layer < sitec->n_soillayers; layer++)
 	{
 		summary->litdecomp += cf->litr1c_to_soil1c[layer] + cf->litr2c_to_soil2c[layer]  + cf->litr4c_to_soil3c[layer];
 	}
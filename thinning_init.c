@@ -144,13 +144,13 @@ int thinning_init(file init, const control_struct* ctrl, thinning_struct* THN)
 		THN->THN_num = nmgm;
 		nmgm = 0;
 		
-		THN->THNyear_array         = (int*) malloc(THN->THN_num*sizeof(double));  
-		THN->THNmonth_array        = (int*) malloc(THN->THN_num*sizeof(double)); 
-		THN->THNday_array          = (int*) malloc(THN->THN_num*sizeof(double)); 
-		THN->thinningRate_w_array  = (double*) malloc(THN->THN_num*sizeof(double)); 
-		THN->thinningRate_nw_array = (double*) malloc(THN->THN_num*sizeof(double)); 
-		THN->transpCoeff_w_array   = (double*) malloc(THN->THN_num*sizeof(double)); 
-		THN->transpCoeff_nw_array  = (double*) malloc(THN->THN_num*sizeof(double)); 
+		THN->THNyear_array         = (int*) arena_malloc(THN->THN_num*sizeof(double));  
+		THN->THNmonth_array        = (int*) arena_malloc(THN->THN_num*sizeof(double)); 
+		THN->THNday_array          = (int*) arena_malloc(THN->THN_num*sizeof(double)); 
+		THN->thinningRate_w_array  = (double*) arena_malloc(THN->THN_num*sizeof(double)); 
+		THN->thinningRate_nw_array = (double*) arena_malloc(THN->THN_num*sizeof(double)); 
+		THN->transpCoeff_w_array   = (double*) arena_malloc(THN->THN_num*sizeof(double)); 
+		THN->transpCoeff_nw_array  = (double*) arena_malloc(THN->THN_num*sizeof(double)); 
 
 		for (nmgm = 0; nmgm < THN->THN_num; nmgm++)
 		{
@@ -45,7 +45,7 @@ int tipping(siteconst_struct* sitec, soilprop_struct* sprop, const epconst_struc
 	m_to_cm   = 100;
 	mm_to_cm  = 0.1;
 
-	for  (layer=0 ; layer<N_SOILLAYERS; layer++) GWR[layer]=0;
+	for  (layer=0 ; layer<sitec->n_soillayers; layer++) GWR[layer]=0;
 
 
 	/* --------------------------------------------------------------------------------------------------------------------*/
@@ -59,7 +59,7 @@ int tipping(siteconst_struct* sitec, soilprop_struct* sprop, const epconst_struc
 	{
 
 		/* 1.1.1. BEGIN LOOP: layer */
-		for  (layer=0 ; layer<N_SOILLAYERS; layer++) 
+		for  (layer=0 ; layer<sitec->n_soillayers; layer++) 
 		{
 	
 			VWC = epv->VWC[layer];
@@ -228,7 +228,7 @@ int tipping(siteconst_struct* sitec, soilprop_struct* sprop, const epconst_struc
 	{
 		
 		/* BEGIN LOOP: VWCsat flow */
-		for (layer=0; layer<N_SOILLAYERS; layer++)   
+		for (layer=0; layer<sitec->n_soillayers; layer++)   
 		{
 
 			VWC = epv->VWC[layer];
@@ -307,7 +307,7 @@ int tipping(siteconst_struct* sitec, soilprop_struct* sprop, const epconst_struc
  
 		} /* END LOOP: VWCsat flow */
 
-		for (layer=N_SOILLAYERS-1; layer >= 0; layer--)
+		for (layer=sitec->n_soillayers-1; layer >= 0; layer--)
 		{
 			
 				VWC = epv->VWC[layer];
@@ -348,7 +348,7 @@ int tipping(siteconst_struct* sitec, soilprop_struct* sprop, const epconst_struc
 
 	if (epc->SHCM_flag == 0)
 	{
-		for (layer=N_SOILLAYERS-2; layer>=0; layer--)
+		for (layer=sitec->n_soillayers-2; layer>=0; layer--)
 		{
 			dz0      = sitec->soillayer_thickness[layer];
 			VWC0     = epv->VWC[layer];
@@ -405,7 +405,7 @@ int tipping(siteconst_struct* sitec, soilprop_struct* sprop, const epconst_struc
 	}
 	else
 	{
-		for (layer=0; layer<N_SOILLAYERS-1; layer++) soilwDiffus[layer] = 0;
+		for (layer=0; layer<sitec->n_soillayers-1; layer++) soilwDiffus[layer] = 0;
 	}
 
 
@@ -414,28 +414,28 @@ int tipping(siteconst_struct* sitec, soilprop_struct* sprop, const epconst_struc
 	/* 6. BOTTOM LAYER IS SPECIAL 	*/
 
 	/* if no GW, water from above flows through the layer */
-	if (sprop->GWeff[N_SOILLAYERS-1] == DATA_GAP)
+	if (sprop->GWeff[sitec->n_soillayers-1] == DATA_GAP)
 	{
-		soilwDiffus[N_SOILLAYERS-1] = soilwDiffus[N_SOILLAYERS-2];
+		soilwDiffus[sitec->n_soillayers-1] = soilwDiffus[sitec->n_soillayers-2];
 	}
 	else
 	{
 		/* if GW: no percolation, but if layer is saturated: GWrecharge */
-		if (fabs(epv->VWC[N_SOILLAYERS-1]-sprop->VWCsat[N_SOILLAYERS-1]) < CRIT_PRECwater)
+		if (fabs(epv->VWC[sitec->n_soillayers-1]-sprop->VWCsat[sitec->n_soillayers-1]) < CRIT_PRECwater)
 		{
-			if (soilwDiffus[N_SOILLAYERS-2] > 0)
-				wf->GWrecharge[N_SOILLAYERS-2] += soilwDiffus[N_SOILLAYERS-2];
+			if (soilwDiffus[sitec->n_soillayers-2] > 0)
+				wf->GWrecharge[sitec->n_soillayers-2] += soilwDiffus[sitec->n_soillayers-2];
 		}
 
-		soilwDiffus[N_SOILLAYERS-1] = 0;
+		soilwDiffus[sitec->n_soillayers-1] = 0;
 	}
 
-	ws->soilw[N_SOILLAYERS-1]   -= soilwDiffus[N_SOILLAYERS-1];
-	epv->VWC[N_SOILLAYERS-1]     = ws->soilw[N_SOILLAYERS-1]   / sitec->soillayer_thickness[N_SOILLAYERS-1]   / water_density;
+	ws->soilw[sitec->n_soillayers-1]   -= soilwDiffus[sitec->n_soillayers-1];
+	epv->VWC[sitec->n_soillayers-1]     = ws->soilw[sitec->n_soillayers-1]   / sitec->soillayer_thickness[sitec->n_soillayers-1]   / water_density;
 	
 	/* ********************************/
 	/* calculation of net water transport */
-	for (layer=0; layer<N_SOILLAYERS; layer++) wf->soilwFlux[layer]=soilwPercol[layer]+soilwDiffus[layer];
+	for (layer=0; layer<sitec->n_soillayers; layer++) wf->soilwFlux[layer]=soilwPercol[layer]+soilwDiffus[layer];
 
 
 
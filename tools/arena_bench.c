@@ -0,0 +1,156 @@
+/*
+arena_bench.c
+benchmark of the simulation arena (arena.c) against malloc/free: the lifetime allocations of a simulation (met and
+observation arrays, varying parameters, management arrays, output names) are made and released again and again, one by
+one with malloc/free or from an arena released at once; with OpenMP all threads run simulations at the same time.
+
+compile and run from the source directory:
+  gcc -O2 -fopenmp -I. -o arena_bench tools/arena_bench.c arena.c
+  ./arena_bench [number of simulations per thread, default: 2000] [simulation years, default: 50]
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ini.h"
+#include "bgc_struct.h"
+#include "pointbgc_struct.h"
+#include "pointbgc_func.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define NMETVAR  16			/* met and observation arrays (one value per simulation day) */
+#define NVARPAR  20			/* varying parameters (one value per simulation year) */
+#define NMGMARR  250		/* management arrays (4..80 values) */
+#define NNAMES   300		/* output names and per-row strings (16..100 bytes) */
+#define NALLOC   (NMETVAR + NVARPAR + NMGMARR + NNAMES)
+#define BENCH_BLOCKSIZE 65536	/* (byte) block size of the simulation arena of the model */
+
+
+static double bench_time(void)
+{
+#ifdef _OPENMP
+	return (omp_get_wtime());
+#else
+	return ((double) clock() / CLOCKS_PER_SEC);
+#endif
+}
+
+
+/* sizes of the allocations of a simulation in a random order */
+static void bench_sizes(size_t* size, int nyears)
+{
+	int n, k;
+	size_t tmp;
+
+	for (n = 0; n < NALLOC; n++)
+	{
+		if (n < NMETVAR)
+			size[n] = (size_t) 365 * nyears * sizeof(double);
+		else if (n < NMETVAR + NVARPAR)
+			size[n] = (size_t) nyears * sizeof(double);
+		else if (n < NMETVAR + NVARPAR + NMGMARR)
+			size[n] = (size_t) (4 + rand() % 77) * sizeof(int);
+		else
+			size[n] = (size_t) (16 + rand() % 85);
+	}
+	for (n = NALLOC-1; n > 0; n--)
+	{
+		k       = rand() % (n + 1);
+		tmp     = size[n];
+		size[n] = size[k];
+		size[k] = tmp;
+	}
+}
+
+
+/* nsim simulations of the calling thread (arena: 0: malloc/free, 1: arena); error: 1 */
+static int bench_run(const size_t* size, int nsim, int use_arena)
+{
+	int sim, n, errorCode=0;
+	void* ptr[NALLOC];
+	arena_struct arena, *previous=NULL;
+
+	for (sim = 0; !errorCode && sim < nsim; sim++)
+	{
+		if (use_arena)
+		{
+			arena_init(&arena, BENCH_BLOCKSIZE);
+			previous = arena_enter(&arena);
+		}
+
+		/* every array is written as by the readers of the inputs */
+		for (n = 0; n < NALLOC; n++)
+		{
+			ptr[n] = use_arena ? arena_malloc(size[n]) : malloc(size[n]);
+			if (!ptr[n])
+				errorCode=1;
+			else
+				memset(ptr[n], n, size[n]);
+		}
+
+		if (use_arena)
+		{
+			arena_enter(previous);
+			arena_release(&arena);
+		}
+		else
+		{
+			for (n = 0; n < NALLOC; n++) free(ptr[n]);
+		}
+	}
+
+	return (errorCode);
+}
+
+
+int main(int argc, char* argv[])
+{
+	int nsim = 2000, nyears = 50, nthreads = 1;
+	int use_arena, errorCode=0;
+	size_t size[NALLOC];
+	double t[2];
+
+	if (argc > 1) nsim   = atoi(argv[1]);
+	if (argc > 2) nyears = atoi(argv[2]);
+	if (nsim < 1 || nyears < 1)
+	{
+		printf("usage: arena_bench [number of simulations per thread] [simulation years]\n");
+		return (1);
+	}
+#ifdef _OPENMP
+	nthreads = omp_get_max_threads();
+#endif
+
+	srand(1);
+	bench_sizes(size, nyears);
+
+	for (use_arena = 0; use_arena < 2; use_arena++)
+	{
+		t[use_arena] = bench_time();
+		#pragma omp parallel reduction(|:errorCode)
+		errorCode |= bench_run(size, nsim, use_arena);
+		t[use_arena] = bench_time() - t[use_arena];
+	}
+
+	if (errorCode)
+	{
+		printf("ERROR allocating memory\n");
+		return (1);
+	}
+
+	printf("%i threads, %i simulations per thread, %i allocations per simulation (%i years)\n", nthreads, nsim, NALLOC, nyears);
+	printf("malloc/free: %8.3f s %8.1f us/simulation\n", t[0], 1e6 * t[0] / nsim);
+	printf("arena:       %8.3f s %8.1f us/simulation (%.2fx)\n", t[1], 1e6 * t[1] / nsim, t[0] / t[1]);
+
+	return (0);
+}
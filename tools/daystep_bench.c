@@ -0,0 +1,157 @@
+/*
+daystep_bench.c
+benchmark of the specialized daily steps (daystep.c) against the generic step: every simulation of the given init files
+is run with the specialized step of its configuration and with the generic step of its run phase (daystep_generic_mode()),
+the generic step has the runtime tests of the configuration that were made on every day by the separate daily loops of the
+normal, spinup and transient runs. The run times and the binary daily and annual outputs of the two steps are compared
+(the output prefix is taken from the OUTPUT_CONTROL block of the init file).
+
+compile and run from the source directory (pointbgc.c is included with its main() renamed):
+  gcc -O2 -I. -o daystep_bench tools/daystep_bench.c $(ls *.c | grep -v '^pointbgc.c$') -lm
+  ./daystep_bench [-r <number of repetitions, default: 3>] <init file> [<init file> ...]
+a spinup and a normal init file of the same site give the spinup and the normal daily steps; the normal run reads the
+restart file of the spinup run, so the spinup init file has to be given first.
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#define main muso_main
+#include "pointbgc.c"
+#undef main
+
+#define NOUTFILE 2			/* compared outputs: daily and annual binary outputs */
+
+
+/* output prefix of an init file (the first value after the OUTPUT_CONTROL keyword); error: 1 */
+static int bench_prefix(const char* ininame, char* prefix)
+{
+	FILE* f;
+	char line[1000], key[1000];
+	int found=0, errorCode=1;
+
+	if (!(f = fopen(ininame, "r"))) return (1);
+
+	while (errorCode && fgets(line, sizeof(line), f))
+	{
+		if (sscanf(line, "%999s", key) != 1) continue;
+		if (found)
+		{
+			strcpy(prefix, key);
+			errorCode=0;
+		}
+		if (!strcmp(key, "OUTPUT_CONTROL")) found=1;
+	}
+
+	fclose(f);
+	return (errorCode);
+}
+
+
+/* content of a file (NULL: the file does not exist) */
+static char* bench_read(const char* name, long* nbytes)
+{
+	FILE* f;
+	char* data=NULL;
+
+	*nbytes = 0;
+	if (!(f = fopen(name, "rb"))) return (NULL);
+
+	fseek(f, 0, SEEK_END);
+	*nbytes = ftell(f);
+	rewind(f);
+	if ((data = (char*) malloc(*nbytes + 1)) && (long) fread(data, 1, *nbytes, f) != *nbytes)
+	{
+		free(data);
+		data = NULL;
+	}
+
+	fclose(f);
+	return (data);
+}
+
+
+int main(int argc, char* argv[])
+{
+	const char* ext[NOUTFILE] = {".dayout", ".annout"};
+	int arg, rep, generic, k, nrep = 3, errorCode=0, ndiff=0, nfilediff;
+	long nbytes[NOUTFILE][2];
+	double t, tmin[2];
+	char prefix[FILENAMESIZE], name[FILENAMESIZE+10];
+	char* data[NOUTFILE][2];
+	char systime[100] = "daystep_bench\n";
+	clock_t start;
+
+	if (argc > 2 && !strcmp(argv[1], "-r"))
+	{
+		nrep  = atoi(argv[2]);
+		argc -= 2;
+		argv += 2;
+	}
+	if (argc < 2 || nrep < 1)
+	{
+		printf("usage: daystep_bench [-r <number of repetitions>] <init file> [<init file> ...]\n");
+		return (1);
+	}
+
+	printf("%-24s %14s %14s %8s %s\n", "init file", "specialized (s)", "generic (s)", "ratio", "outputs");
+
+	for (arg = 1; !errorCode && arg < argc; arg++)
+	{
+		if (bench_prefix(argv[arg], prefix))
+		{
+			printf("ERROR reading the output prefix of %s\n", argv[arg]);
+			errorCode=1;
+		}
+
+		/* the two steps alternate in the repetitions, the shortest run time of each is reported */
+		for (generic = 0; generic < 2; generic++) tmin[generic] = 1e30;
+		for (k = 0; k < NOUTFILE; k++) data[k][0] = data[k][1] = NULL;
+		nfilediff = 0;
+
+		for (rep = 0; !errorCode && rep < nrep; rep++)
+		{
+			for (generic = 0; !errorCode && generic < 2; generic++)
+			{
+				daystep_generic_mode(generic);
+
+				start = clock();
+				if (pointbgc_run(argv[arg], systime, NULL, -1, NULL))
+				{
+					printf("ERROR in the simulation of %s (%s step)\n", argv[arg], generic ? "generic" : "specialized");
+					errorCode=1;
+				}
+				t = (double) (clock() - start) / CLOCKS_PER_SEC;
+				if (t < tmin[generic]) tmin[generic] = t;
+
+				/* outputs of the first repetition */
+				for (k = 0; !errorCode && !rep && k < NOUTFILE; k++)
+				{
+					sprintf(name, "%s%s", prefix, ext[k]);
+					data[k][generic] = bench_read(name, &nbytes[k][generic]);
+					if (generic && (!data[k][0] != !data[k][1] || nbytes[k][0] != nbytes[k][1] ||
+									(data[k][0] && memcmp(data[k][0], data[k][1], nbytes[k][0]))))
+						nfilediff++;
+				}
+			}
+		}
+
+		ndiff += nfilediff;
+		for (k = 0; k < NOUTFILE; k++)
+		{
+			free(data[k][0]);
+			free(data[k][1]);
+		}
+
+		if (!errorCode)
+			printf("%-24s %14.3f %14.3f %8.3f %s\n", argv[arg], tmin[0], tmin[1], tmin[1] / tmin[0], nfilediff ? "DIFFERENT" : "identical");
+	}
+
+	daystep_generic_mode(0);
+
+	return (errorCode || ndiff ? 1 : 0);
+}
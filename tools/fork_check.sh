@@ -0,0 +1,52 @@
+#!/bin/sh
+# fork_check.sh
+# check of the fork mode: a scenario run with the same inputs as the shared prefix run has to give the same binary outputs
+# as the unforked simulation from the branch year on.
+#
+# usage: fork_check.sh <binary output of the unforked run> <binary output of the identical scenario>
+#
+# the index files (<output file>.idx, outindex.c) give the first record of the branch year in the unforked output;
+# the scenario output has to be byte-identical to the rest of the unforked output.
+#
+# example (main init file: run.ini, fork file with the branch year and one scenario with the same inputs: same.ini):
+#   muso run.ini             (unforked run, outputs renamed to full.dayout)
+#   muso run.ini fork.txt    (scenario outputs: same.dayout)
+#   tools/fork_check.sh full.dayout same.dayout
+#
+# *-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+# Biome-BGCMuSo v7.0.
+# Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+# Hungarian Academy of Sciences, Hungary
+# See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+# *-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+
+if [ $# -ne 2 ] || [ ! -f "$1.idx" ] || [ ! -f "$2.idx" ]; then
+	echo "usage: fork_check.sh <unforked binary output> <scenario binary output> (both with .idx files)"
+	exit 2
+fi
+
+recsize=$(awk '$1 == "RECSIZE" { print $2 }' "$1.idx")
+branch=$(awk '$1 == "YEAR" { print $2; exit }' "$2.idx")
+first=$(awk -v year="$branch" '$1 == "YEAR" && $2 == year { print $3 }' "$1.idx")
+
+if [ -z "$recsize" ] || [ -z "$branch" ] || [ -z "$first" ]; then
+	echo "ERROR: branch year $branch is not in the index of $1"
+	exit 2
+fi
+if [ "$recsize" != "$(awk '$1 == "RECSIZE" { print $2 }' "$2.idx")" ]; then
+	echo "ERROR: different output variables in $1 and $2"
+	exit 1
+fi
+
+# the unforked output from the first record of the branch year
+tail -c +$((first * recsize + 1)) "$1" > "$2.forkcheck"
+if cmp -s "$2.forkcheck" "$2"; then
+	echo "fork check OK: $2 = $1 from $branch"
+	rm -f "$2.forkcheck"
+	exit 0
+fi
+
+echo "fork check FAILED: $2 differs from $1 from $branch (first difference below)"
+cmp "$2.forkcheck" "$2"
+rm -f "$2.forkcheck"
+exit 1
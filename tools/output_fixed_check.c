@@ -0,0 +1,178 @@
+/*
+output_fixed_check.c
+randomized comparison of the formatters of the ASCII outputs (output_handling.c) with fprintf() formatting: output_fixed()
+against "%<width>.<prec>f", output_int() against "%<width>i" and output_string() against "%<width>s". Every difference
+is counted, the first ones are listed; exit code 1 if any is found.
+
+compile and run from the source directory (output_handling.c is included to reach its static functions):
+  gcc -O2 -I. -o output_fixed_check tools/output_fixed_check.c aggreg.c obscomp.c doy_to_date.c ini.c input_provider.c -lm
+  ./output_fixed_check [number of values per class and format, default: 1000000] [seed, default: 1]
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include "output_handling.c"
+#include <limits.h>
+#include <float.h>
+
+#define NCLASS  6			/* classes of random values, see check_value() */
+#define NFORMAT 5			/* formats: the three of the outputs and two random ones */
+#define MAXLIST 10			/* number of listed differences */
+
+static unsigned long long seed = 1;
+static long ndiff = 0;
+
+
+/* xorshift64* generator (the same sequence on every platform) */
+static unsigned long long random64(void)
+{
+	seed ^= seed >> 12;
+	seed ^= seed << 25;
+	seed ^= seed >> 27;
+	return (seed * 2685821657736338717ULL);
+}
+
+
+static double from_bits(unsigned long long bits)
+{
+	double value;
+	memcpy(&value, &bits, sizeof(double));
+	return (value);
+}
+
+
+/* random value of the given class for precision prec */
+static double check_value(int class, int prec)
+{
+	unsigned long long r = random64();
+	double sign = (r & 1) ? -1.0 : 1.0;
+	int k;
+
+	switch (class)
+	{
+	case 0:	/* any bit pattern (NaN, infinity and large values: snprintf() fallback) */
+		return (from_bits(r));
+	case 1:	/* any bit pattern below 2^32 (exponent 0..1054) */
+		return (from_bits((r & 0x800FFFFFFFFFFFFFULL) | ((random64() % 1055) << 52)));
+	case 2:	/* decimal fractions (k / 10^d, the typical output values) */
+		k = (int) ((r >> 1) % 16);
+		return (sign * (double) (random64() % 10000000000000ULL) / output_pow10[k % 10] / (k >= 10 ? 1e6 : 1.0));
+	case 3:	/* exact ties: i + m/2^(prec+1), m odd */
+		return (sign * ((double) ((r >> 1) % 100000) + (double) (2 * (random64() % (1ULL << prec)) + 1) / (double) (2ULL << prec)));
+	case 4:	/* near the rounding boundary of prec digits and negative values rounding to zero */
+		return (sign * ((double) ((r >> 1) % 1000000) + 0.5) / output_pow10[prec] + sign * (double) ((int) (random64() % 7) - 3) * 1e-17);
+	default:	/* special and border values */
+		switch ((r >> 1) % 10)
+		{
+		case 0: return (0.0);
+		case 1: return (-0.0);
+		case 2: return (from_bits(random64() & 0x000FFFFFFFFFFFFFULL) * sign);	/* subnormal */
+		case 3: return (sign * 4294967296.0);
+		case 4: return (sign * from_bits(0x41EFFFFFFFFFFFFFULL));				/* largest value below 2^32 */
+		case 5: return (sign * (4294967295.5 - 1.0 / output_pow10[prec] / 4));
+		case 6: return (sign * HUGE_VAL);
+		case 7: return (from_bits(0x7FF8000000000000ULL | (random64() & 0x8007FFFFFFFFFFFFULL)));
+		case 8: return (sign * 1e-300);
+		default: return (sign * DBL_MAX);
+		}
+	}
+}
+
+
+static void difference(const char* what, const char* expected, const char* got)
+{
+	ndiff++;
+	if (ndiff <= MAXLIST) printf("DIFFERENCE %s: fprintf \"%s\" formatter \"%s\"\n", what, expected, got);
+}
+
+
+int main(int argc, char* argv[])
+{
+	const char* class_name[NCLASS] = {"bit patterns", "bit patterns < 2^32", "decimal fractions", "exact ties",
+	                                  "rounding boundaries", "special values"};
+	int width[NFORMAT] = {14, 14, 12, 0, 0};
+	int prec[NFORMAT]  = {9, 8, 6, 0, 0};
+	int class, fmt, len, ivalue;
+	long n, nvalue = 1000000, nchecked = 0;
+	double value;
+	char expected[OUTPUT_MAXFIXED+1], got[OUTPUT_MAXFIXED+1], what[64], str[32];
+
+	if (argc > 1) nvalue = atol(argv[1]);
+	if (argc > 2) seed = strtoull(argv[2], NULL, 10) | 1;
+
+	/* real values: the formats of the outputs and random width/precision */
+	for (class = 0; class < NCLASS; class++)
+	{
+		for (fmt = 0; fmt < NFORMAT; fmt++)
+		{
+			for (n = 0; n < nvalue; n++)
+			{
+				if (fmt >= 3)
+				{
+					width[fmt] = (int) (random64() % 21);
+					prec[fmt]  = (int) (random64() % 10);
+				}
+				value = check_value(class, prec[fmt]);
+
+				snprintf(expected, sizeof(expected), "%*.*f", width[fmt], prec[fmt], value);
+				len = output_fixed(got, value, width[fmt], prec[fmt]);
+				got[len] = '\0';
+
+				if (strcmp(expected, got))
+				{
+					sprintf(what, "%%%i.%if of %a", width[fmt], prec[fmt], value);
+					difference(what, expected, got);
+				}
+				nchecked++;
+			}
+		}
+		printf("%-20s checked\n", class_name[class]);
+	}
+
+	/* integers and strings of the date fields and headers */
+	for (n = 0; n < nvalue; n++)
+	{
+		switch (n % 4)
+		{
+		case 0:  ivalue = (int) (random64() % 10000); break;
+		case 1:  ivalue = (int) random64(); break;
+		case 2:  ivalue = (n % 8 == 2) ? INT_MIN : INT_MAX; break;
+		default: ivalue = -(int) (random64() % 1000); break;
+		}
+		width[0] = (int) (random64() % 14);
+
+		snprintf(expected, sizeof(expected), "%*i", width[0], ivalue);
+		len = output_int(got, ivalue, width[0]);
+		got[len] = '\0';
+		if (strcmp(expected, got))
+		{
+			sprintf(what, "%%%ii of %i", width[0], ivalue);
+			difference(what, expected, got);
+		}
+
+		len = (int) (random64() % 31);
+		memset(str, 'a' + (int) (n % 26), len);
+		str[len] = '\0';
+		width[0] = (int) (random64() % 51);
+
+		snprintf(expected, sizeof(expected), "%*s", width[0], str);
+		len = output_string(got, str, width[0]);
+		got[len] = '\0';
+		if (strcmp(expected, got))
+		{
+			sprintf(what, "%%%is", width[0]);
+			difference(what, expected, got);
+		}
+		nchecked += 2;
+	}
+	printf("%-20s checked\n", "integers, strings");
+
+	printf("%li values checked, %li differences\n", nchecked, ndiff);
+
+	return (ndiff ? 1 : 0);
+}
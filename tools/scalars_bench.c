@@ -0,0 +1,172 @@
+/*
+scalars_bench.c
+microbenchmark of the soil response kernels of multilayer_scalars.c: every kernel of the given number of soil layers is
+timed with the library exp/log/pow (default build) and with the inlined functions of -DMUSO_VECMATH on random soil
+profiles, and the generic kernel (multilayer_generic_mode()) with the library functions; the maximal relative difference
+of the library and the inlined versions is also reported.
+The model is built with the library functions unless MUSO_VECMATH is defined: the vectorized path is opt-in.
+
+compile and run from the source directory (multilayer_scalars.c is built once as in the model and once with MUSO_VECMATH
+by tools/scalars_vec.c):
+  gcc -O3 -fno-trapping-math -mavx2 -I. -o scalars_bench tools/scalars_bench.c tools/scalars_vec.c multilayer_scalars.c -lm
+  ./scalars_bench [number of repetitions, default: 1000000] [number of soil layers, default: 10]
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+
+#include "ini.h"
+#include "bgc_struct.h"
+#include "bgc_func.h"
+#include "bgc_constants.h"
+
+/* vectorized version of the kernels (scalars_vec.c) */
+const multilayer_kernels_struct* multilayer_kernels_vec(int n_soillayers);
+
+#define NPROFILE 64			/* number of random soil profiles (the inputs stay in the L1 cache) */
+
+static int nlayers = 10;
+static siteconst_struct sitec;
+static soilprop_struct sprop[NPROFILE];
+static double tsoil[NPROFILE][N_SOILLAYERS], WFPS[NPROFILE][N_SOILLAYERS];
+static double out_lib[NPROFILE][2][N_SOILLAYERS], out_vec[NPROFILE][2][N_SOILLAYERS], out_gen[NPROFILE][2][N_SOILLAYERS];
+
+
+static double uniform(double min, double max)
+{
+	return (min + (max - min) * rand() / (double) RAND_MAX);
+}
+
+
+static double reldiff(int nvalue, const double* a, const double* b)
+{
+	int i;
+	double diff, maxdiff=0;
+
+	for (i = 0; i < nvalue; i++)
+	{
+		diff = a[i] == b[i] ? 0 : fabs(a[i] - b[i]) / (fabs(a[i]) > 1e-300 ? fabs(a[i]) : 1e-300);
+		if (diff > maxdiff) maxdiff = diff;
+	}
+	return (maxdiff);
+}
+
+
+/* kernel k of the given kernel set on profile p */
+static void kernel(int k, const multilayer_kernels_struct* K, double out[NPROFILE][2][N_SOILLAYERS], int p)
+{
+	double* out0 = out[p][0];
+	double* out1 = out[p][1];
+	const soilprop_struct* sp = &sprop[p];
+
+	switch (k)
+	{
+	case 0:	/* Lloyd and Taylor temperature response of decomposition */
+		K->tresponse(nlayers, tsoil[p], sp->Tmin_decomp, DATA_GAP, sp->Tp2_decomp, sp->Tp3_decomp, sp->Tp4_decomp, out0);
+		break;
+	case 1:	/* bell shaped temperature response of nitrification */
+		K->tresponse(nlayers, tsoil[p], sp->Tmin_decomp, sp->Tp1_nitrif, sp->Tp2_nitrif, sp->Tp3_nitrif, sp->Tp4_nitrif, out0);
+		break;
+	case 2:	/* depth scalar */
+		K->zscalar(nlayers, &sitec, sp->efolding_depth, out0);
+		break;
+	case 3:	/* pH response of nitrification */
+		K->pHresponse(nlayers, sp, out0);
+		break;
+	case 4:	/* WFPS and pH factors of the N2/N2O ratio */
+		K->denitr_ratio(nlayers, WFPS[p], sp->pH, out0, out1);
+		break;
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	const char* name[5] = {"tresponse (Lloyd-Taylor)", "tresponse (bell shaped)", "zscalar", "pHresponse", "denitr_ratio"};
+	const int nout[5] = {1, 1, 1, 1, 2};
+	int k, version, p, layer;
+	long rep, nrep = 1000000;
+	double t[3], diff, d;
+	clock_t start;
+	const multilayer_kernels_struct* K[3];
+	double (*out[3])[2][N_SOILLAYERS] = {out_lib, out_vec, out_gen};
+
+	if (argc > 1) nrep = atol(argv[1]);
+	if (argc > 2) nlayers = atoi(argv[2]);
+	if (nrep < NPROFILE) nrep = NPROFILE;
+	if (nlayers < 1 || nlayers > N_SOILLAYERS)
+	{
+		printf("ERROR: the number of soil layers has to be between 1 and %i\n", N_SOILLAYERS);
+		return (1);
+	}
+
+	/* kernels of the number of layers (library and inlined functions) and generic kernels */
+	K[0] = multilayer_kernels(nlayers);
+	K[1] = multilayer_kernels_vec(nlayers);
+	multilayer_generic_mode(1);
+	K[2] = multilayer_kernels(nlayers);
+	multilayer_generic_mode(0);
+
+	srand(1);
+	for (layer = 0; layer < N_SOILLAYERS; layer++)
+		sitec.soillayer_midpoint[layer] = 0.05 + layer * 0.3;
+
+	for (p = 0; p < NPROFILE; p++)
+	{
+		sprop[p].Tmin_decomp    = -10;
+		sprop[p].Tp2_decomp     = uniform(250, 350);
+		sprop[p].Tp3_decomp     = 56.02;
+		sprop[p].Tp4_decomp     = uniform(220, 240);
+		sprop[p].Tp1_nitrif     = uniform(0.8, 1.2);
+		sprop[p].Tp2_nitrif     = uniform(10, 20);
+		sprop[p].Tp3_nitrif     = uniform(2, 5);
+		sprop[p].Tp4_nitrif     = uniform(25, 35);
+		sprop[p].pHp1_nitrif    = 1.0;
+		sprop[p].pHp2_nitrif    = 0.56;
+		sprop[p].pHp3_nitrif    = uniform(5, 6);
+		sprop[p].pHp4_nitrif    = uniform(-1.2, -0.8);
+		sprop[p].efolding_depth = uniform(0.5, 15);
+		for (layer = 0; layer < N_SOILLAYERS; layer++)
+		{
+			tsoil[p][layer]     = uniform(-15, 35);
+			WFPS[p][layer]      = uniform(0.05, 1);
+			sprop[p].pH[layer]  = uniform(4, 8.5);
+		}
+	}
+
+	printf("%i soil layers (%s kernels), %li kernel calls\n", nlayers, K[0]->nlayers ? "specialized" : "generic", nrep);
+	printf("%-26s %12s %12s %8s %12s %14s\n", "kernel", "libm (ns)", "vecmath (ns)", "ratio", "generic (ns)", "max rel. diff");
+
+	for (k = 0; k < 5; k++)
+	{
+		for (version = 0; version < 3; version++)
+		{
+			start = clock();
+			for (rep = 0; rep < nrep; rep++) kernel(k, K[version], out[version], (int) (rep % NPROFILE));
+			t[version] = 1e9 * (double) (clock() - start) / CLOCKS_PER_SEC / nrep;
+		}
+
+		diff = 0;
+		for (p = 0; p < NPROFILE; p++)
+		{
+			for (version = 0; version < nout[k]; version++)
+			{
+				d = reldiff(nlayers, out_lib[p][version], out_vec[p][version]);
+				if (d > diff) diff = d;
+			}
+		}
+
+		printf("%-26s %12.1f %12.1f %8.2f %12.1f %14.2e\n", name[k], t[0], t[1], t[0] / t[1], t[2], diff);
+	}
+
+	return (0);
+}
@@ -0,0 +1,17 @@
+/*
+scalars_vec.c
+the kernels of multilayer_scalars.c with the inlined exp/log/pow of MUSO_VECMATH under the names *_vec for the comparison
+with the default build in scalars_bench.c
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#define MUSO_VECMATH
+#define multilayer_kernels      multilayer_kernels_vec
+#define multilayer_generic_mode multilayer_generic_mode_vec
+#include "multilayer_scalars.c"
@@ -0,0 +1,169 @@
+/*
+scan_bench.c
+benchmark of the tokenizer of scan_array() (ini.c) against the earlier fscanf() reading ("%d", "%lf", "%s", with
+"%*[^\n]" for the rest of the line): a temporary file of random init file lines (value and comment) and of rows of values
+is read by both, the values and the stream positions are compared and the reading times are reported.
+
+compile and run from the source directory:
+  gcc -O2 -I. -o scan_bench tools/scan_bench.c ini.c input_provider.c -lm
+  ./scan_bench [number of lines, default: 1000000]
+
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+Biome-BGCMuSo v7.0.
+Copyright 2022, D. Hidy [dori.hidy@gmail.com]
+Hungarian Academy of Sciences, Hungary
+See the website of Biome-BGCMuSo at http://nimbus.elte.hu/bbgc/ for documentation, model executable and example input files.
+*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ini.h"
+
+#define NROW 8			/* values of a row without line ends (year-varying parameters) */
+
+
+static double uniform(double min, double max)
+{
+	return (min + (max - min) * rand() / (double) RAND_MAX);
+}
+
+
+/* one random line; the type of the first value is returned ('i', 'd', 's' or 'r': row of NROW doubles) */
+static char write_line(FILE* f)
+{
+	int k;
+	const char* fmt[4] = {"%.4f", "%.10g", "%.3e", "%.17g"};
+
+	switch (rand() % 8)
+	{
+	case 0:
+		fprintf(f, "%i\t\t\t\t(flag) switching %i\n", rand() % 2000 - 1000, rand());
+		return ('i');
+	case 1:
+		fprintf(f, "%s_%i.txt\t\t\t(file) name of the input\n", "input", rand());
+		return ('s');
+	case 2:
+		for (k = 0; k < NROW; k++)
+		{
+			fprintf(f, fmt[rand() % 4], uniform(-1000, 1000));
+			fprintf(f, k < NROW-1 ? " " : "\n");
+		}
+		return ('r');
+	default:
+		fprintf(f, fmt[rand() % 4], uniform(-1, 1) * (rand() % 2 ? 1.0 : 1e-5));
+		fprintf(f, "\t\t\t\t(kgC/m2) parameter of the %i. layer\n", rand() % 10);
+		return ('d');
+	}
+}
+
+
+/* earlier reading of scan_array() */
+static int read_fscanf(FILE* f, char type, void* var, int nl)
+{
+	switch (type)
+	{
+	case 'i': return (nl ? fscanf(f, "%d%*[^\n]", (int*) var) : fscanf(f, "%d", (int*) var));
+	case 'd': return (nl ? fscanf(f, "%lf%*[^\n]", (double*) var) : fscanf(f, "%lf", (double*) var));
+	default:  return (nl ? fscanf(f, "%s%*[^\n]", (char*) var) : fscanf(f, "%s", (char*) var));
+	}
+}
+
+
+/* reading of all lines (method 0: fscanf, 1: scan_array); the values and positions are stored if values is given */
+static int read_all(file ini, const char* types, long nline, int method, double* values, long* pos)
+{
+	long line, n=0;
+	int k, ival, errorCode=0;
+	double dval;
+	char sval[FILENAMESIZE];
+	char type;
+
+	rewind(ini.ptr);
+	for (line = 0; !errorCode && line < nline; line++)
+	{
+		for (k = 0; k < (types[line] == 'r' ? NROW : 1); k++)
+		{
+			type = types[line] == 'r' ? 'd' : types[line];
+			if (method == 0)
+				errorCode = read_fscanf(ini.ptr, type, type == 'i' ? (void*) &ival : (type == 'd' ? (void*) &dval : (void*) sval),
+										types[line] != 'r') == 1 ? 0 : 1;
+			else
+				errorCode = scan_array(ini, type == 'i' ? (void*) &ival : (type == 'd' ? (void*) &dval : (void*) sval), type,
+									   types[line] != 'r', 1);
+			if (values)
+			{
+				values[n] = type == 'i' ? (double) ival : (type == 'd' ? dval : (double) strlen(sval) + atoi(sval + 6));
+				pos[n]    = ftell(ini.ptr);
+				n++;
+			}
+		}
+	}
+
+	return (errorCode);
+}
+
+
+int main(int argc, char* argv[])
+{
+	long line, n, nline = 1000000, ntoken = 0, ndiff = 0;
+	int method;
+	char* types;
+	double* values[2];
+	long* pos[2];
+	double t[2];
+	clock_t start;
+	file ini;
+
+	if (argc > 1) nline = atol(argv[1]);
+	if (nline < 1) nline = 1;
+
+	strcpy(ini.name, "scan_bench temporary file");
+	ini.ptr = tmpfile();
+	types   = (char*) malloc(nline);
+	if (!ini.ptr || !types)
+	{
+		printf("ERROR creating the temporary file\n");
+		return (1);
+	}
+
+	srand(1);
+	for (line = 0; line < nline; line++)
+	{
+		types[line] = write_line(ini.ptr);
+		ntoken += types[line] == 'r' ? NROW : 1;
+	}
+
+	/* the values and stream positions of the two methods */
+	for (method = 0; method < 2; method++)
+	{
+		values[method] = (double*) malloc(ntoken * sizeof(double));
+		pos[method]    = (long*) malloc(ntoken * sizeof(long));
+		if (!values[method] || !pos[method] || read_all(ini, types, nline, method, values[method], pos[method]))
+		{
+			printf("ERROR reading the temporary file (method %i)\n", method);
+			return (1);
+		}
+	}
+	for (n = 0; n < ntoken; n++)
+		if (memcmp(&values[0][n], &values[1][n], sizeof(double)) || pos[0][n] != pos[1][n]) ndiff++;
+
+	/* reading times (the file is in the page cache after the first reading) */
+	for (method = 0; method < 2; method++)
+	{
+		start = clock();
+		read_all(ini, types, nline, method, NULL, NULL);
+		t[method] = (double) (clock() - start) / CLOCKS_PER_SEC;
+	}
+
+	printf("%li lines, %li values, %li bytes\n", nline, ntoken, ftell(ini.ptr));
+	printf("fscanf:     %8.3f s %8.1f ns/value\n", t[0], 1e9 * t[0] / ntoken);
+	printf("scan_array: %8.3f s %8.1f ns/value (%.2fx)\n", t[1], 1e9 * t[1] / ntoken, t[0] / t[1]);
+	printf("%li differences in values or stream positions\n", ndiff);
+
+	fclose(ini.ptr);
+
+	return (ndiff ? 1 : 0);
+}
@@ -110,14 +110,15 @@ int transient_bgc(bgcin_struct* bgcin, bgcout_struct* bgcout)
 	double* annarr=0;
 	double** output_map=0;
 
+	/* daily step engine */
+	daystep_struct D;
+
 	
 
 	/* miscelaneous variables for program control in main */
 	int simyr = 0;
 	int yday  = 0;
 	int first_balance;
-	int annual_alloc;
-	double dailyNdep; 
 	double tair_annavg;
 	double nmetdays;
 	int i;
@@ -234,26 +235,27 @@ int transient_bgc(bgcin_struct* bgcin, bgcout_struct* bgcout)
 		}
 	}
 	
-	/* allocate space for the onday_arr and offday_arr: first column - year, second column: day*/
+	/* allocate space for the onday_arr and offday_arr: first column - year, second column: day
+	   (the rows are in one block, which is pointed by the first row) */
 	if (!errorCode)
 	{
 		phenarr.onday_arr  = (int**) malloc(nyears*sizeof(int*));  
         phenarr.offday_arr = (int**) malloc(nyears*sizeof(int*));  
-			
-		for (i = 0; i<nyears; i++)
-		{
-			phenarr.onday_arr[i]  = (int*) malloc(2*sizeof(int));  
-			phenarr.offday_arr[i] = (int*) malloc(2*sizeof(int));  
-			phenarr.onday_arr[i]  = (int*) malloc(2*sizeof(int));  
-			phenarr.offday_arr[i] = (int*) malloc(2*sizeof(int));  
-		}
 
-
-		if (!phenarr.onday_arr || !phenarr.onday_arr)
+		if (!phenarr.onday_arr || !phenarr.offday_arr || !(phenarr.onday_arr[0] = (int*) malloc(2*nyears*sizeof(int))) ||
+			!(phenarr.offday_arr[0] = (int*) malloc(2*nyears*sizeof(int))))
 		{
 			printf("ERROR allocating for onday_arr/offday_arr, prephenology()\n");
 			errorCode=3060;
 		}
+		else
+		{
+			for (i = 1; i<nyears; i++)
+			{
+				phenarr.onday_arr[i]  = phenarr.onday_arr[0] + 2*i;  
+				phenarr.offday_arr[i] = phenarr.offday_arr[0] + 2*i;  
+			}
+		}
 	}
 
 	/* allocate space for enddays */
@@ -281,11 +283,17 @@ int transient_bgc(bgcin_struct* bgcin, bgcout_struct* bgcout)
 	
 	
 	/* initialize the output mapping array */
-	if (!errorCode && output_map_init(output_map,&phen,&metv,&ws,&wf,&cs,&cf,&ns,&nf,&sprop,&epv,&psn_sun,&psn_shade,&summary))
+	if (!errorCode && output_map_init(output_map,&phen,&metv,&ws,&wf,&cs,&cf,&ns,&nf,&sprop,&epv,&psn_sun,&psn_shade,&summary,sitec.n_soillayers))
 	{
 		printf("ERROR in call to output_map_init() from transient_bgc.c\n");
 		errorCode=4010;
 	}
+
+	if (!errorCode && output_map_check(output_map, &ctrl))
+	{
+		printf("ERROR in call to output_map_check() from transient_bgc.c\n");
+		errorCode=4010;
+	}
 	
 	
 	/* atmospheric pressure (Pa) as a function of elevation (m) */
@@ -310,7 +318,7 @@ int transient_bgc(bgcin_struct* bgcin, bgcout_struct* bgcout)
 
 
 	/* calculate conductance limitation factors 	*/	
-	if (!errorCode && conduct_limit_factors(bgcout->log_file, &ctrl, &sprop, &epc, &epv))
+	if (!errorCode && conduct_limit_factors(bgcout->log_file, &ctrl, &sitec, &sprop, &epc, &epv))
 	{
 		printf("ERROR in call to conduct_limit_factors(), from transient_bgc.c\n");
 		errorCode=4040;
@@ -329,7 +337,7 @@ int transient_bgc(bgcin_struct* bgcin, bgcout_struct* bgcout)
 	nmetdays = ctrl.simyears * nDAYS_OF_YEAR;
 	for (i=0 ; i<nmetdays ; i++)
 	{
-		tair_annavg += metarr.Tavg_array[i];
+		tair_annavg += metarr_value(&metarr, METARR_TAVG, i);
 	}
 	tair_annavg /= (double)nmetdays;
 
@@ -352,6 +360,18 @@ int transient_bgc(bgcin_struct* bgcin, bgcout_struct* bgcout)
 	/* initialize the indicator for first day of current simulation, so that the checks for mass balance can have two days for comparison */
 	first_balance = 1;
 	
+	/* daily step engine on the local structures */
+	daystep_init(&D, bgcin, bgcout, &first_balance, &ctrl, &metarr, &metv, &ndep, &ws, &wf, &cs, &cf, &ns, &nf, &epc, &epv, &sitec, &sprop, &gwc, 
+		         &phenarr, &phen, &psn_sun, &psn_shade, &nt, &summary, &PLT, &THN, &MOW, &GRZ, &HRV, &PLG, &FRZ, &IRG, &MUL, &CWE, &FLD, &GWS, 
+				 output_map, dayarr, monavgarr, annavgarr, annarr, mondays, enddays);
+
+	/* daily step specialized for the configuration of the run */
+	if (!errorCode && daystep_select(&D, DAYSTEP_TRANSIENT))
+	{
+		printf("ERROR in call to daystep_select() from transient_bgc.c\n");
+		errorCode=4300;
+	}
+
 	/* !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! */
 	/* 1. BEGIN OF THE ANNUAL LOOP */
 	for (simyr=0 ; !errorCode && simyr<ctrl.simyears ; simyr++)
@@ -399,12 +419,12 @@ int transient_bgc(bgcin_struct* bgcin, bgcout_struct* bgcout)
 		if (!(ndep.varndep))
 		{
 			/*constant Ndep */
-			dailyNdep = ndep.ndep / nDAYS_OF_YEAR;
+			D.dailyNdep = ndep.ndep / nDAYS_OF_YEAR;
 		}
 		else
 		{	
 			/* Ndep from file */
-			dailyNdep = ndep.Ndep_array[simyr] / nDAYS_OF_YEAR;
+			D.dailyNdep = ndep.Ndep_array[simyr] / nDAYS_OF_YEAR;
 		}
 		
 	
@@ -412,483 +432,8 @@ int transient_bgc(bgcin_struct* bgcin, bgcout_struct* bgcout)
 		/* 2. BEGIN OF THE DAILY LOOP */
 		for (yday=0 ; !errorCode && yday<nDAYS_OF_YEAR ; yday++)
 		{
-
-
-			/* set the day index for meteorological and phenological arrays */
-			ctrl.yday   = yday;
-			ctrl.metday	= simyr*nDAYS_OF_YEAR + yday;		
-
-			/* set fluxes to zero */
-			if (!errorCode && make_zero_flux_struct(&wf, &cf, &nf, &gwc))
-			{
-				printf("ERROR in call to make_zero_flux_struct() from transient_bgc.c\n");
-				errorCode=5010;
-			}
-			
-
-			/* initalizing annmax and cumulative variables */
-			if (yday == 0)
-			{
-				if (!errorCode && annVARinit(&summary, &epv, &cs, &ws, &cf, &nf))
-				{
-					printf("ERROR in call to annVARinit() from bgc.c\n");
-					errorCode=5020;
-				}
-			}
-			
-
-		    /* nitrogen deposition and fixation */
-			nf.ndep_to_sminn_total = dailyNdep;
-			nf.nfix_to_sminn_total = epc.nfix / nDAYS_OF_YEAR;
-
-
-			/* calculating actual onday and offday */
-			if (!errorCode && dayphen(&ctrl, &epc, &phenarr, &PLT, &phen))
-			{
-				printf("ERROR in dayphen from transient_bgc.c\n");
-				errorCode=5030;
-			}
-			
-
-			/* setting MANAGEMENT DAYS based on input data */
-			if (!errorCode && management(&ctrl, &FRZ, &GRZ, &HRV, &MOW, &PLT, &PLG, &THN, &IRG, &MUL, &CWE, &FLD, &GWS, mondays))
-			{
-				printf("ERROR in management days() from transient_bgc.c\n");
-				errorCode=5040;
-			}
-			
-
-			/* determining soil hydrological parameters */
- 			if (!errorCode && multilayer_hydrolparams(&sitec, &sprop, &ws, &epv))
-			{
-				printf("ERROR in multilayer_hydrolparams() from transient_bgc.c\n");
-				errorCode=5050;
-			}
-			
-
-
-			/* daily meteorological variables from metarrays */
-			if (!errorCode && daymet(&ctrl, &metarr, &epc, &metv, ws.snoww))
-			{
-				printf("ERROR in daymet() from transient_bgc.c\n");
-				errorCode=5060;
-			}
-			
-			
-			/* phenophases calculation */
-			if (!errorCode && phenphase(bgcout->log_file, &ctrl, &epc, &sprop, &PLT, &phen, &metv, &epv, &cs))
-			{
-				printf("ERROR in phenphase() from transient_bgc.c\n");
-				errorCode=5070;
-			}
-			
-
-
-			/* soil temperature calculations */
-			if (!errorCode && multilayer_tsoil(&epc, &sitec, &sprop, &epv, yday, ws.snoww, &metv))
-			{
-				printf("ERROR in multilayer_tsoil() from transient_bgc.c\n");
-				errorCode=5080;
-			}
-			
-
-			/* soilCover calculations */
-			if (!errorCode && soilCover(&sitec, &sprop, &metv, &epv, &cs))
-			{
-				printf("ERROR in soilCover() from transient_bgc.c\n");
-				errorCode=5090;
-			}
-			
-
-
-			/* phenology calculation */
-			if (!errorCode && phenology(&epc, &cs, &ns, &phen, &metv, &epv, &cf, &nf))
-			{
-				printf("ERROR in phenology() from transient_bgc.c\n");
-				errorCode=5100;
-			}
-			
-		
-			/* calculate leaf area index, sun and shade fractions, and specific leaf area for sun and shade canopy fractions, then calculate canopy radiation interception and transmission */          
-			if (!errorCode && radtrans(&ctrl, &phen, &cs, &epc, &sitec, &metv, &epv))
-			{
-				printf("ERROR in radtrans() from transient_bgc.c\n");
-				errorCode=5110;
-			}
-			
-			
-			/* update the ann max LAI for annual diagnostic output */
-			if (epv.proj_lai > epv.annmax_lai)             epv.annmax_lai = epv.proj_lai;
-			if (epv.rootDepth > epv.annmax_rootDepth)      epv.annmax_rootDepth = epv.rootDepth;
-			if (epv.plantHeight > epv.annmax_plantHeight) epv.annmax_plantHeight = epv.plantHeight;
-			
-
-			
-			/* IRRIGATING separately from other management routines*/
-			if (!errorCode && irrigating(&ctrl, &IRG, &sitec, &sprop, &epv, &ws, &wf))
-			{
-				printf("ERROR in irrigating() from bgc.c\n");
-				errorCode=5120;
-			}
-			
-
-
-			/* precip routing (when there is precip) */
-			if (!errorCode && metv.prcp && prcpANDrunoffH(&metv, &sprop, &epc, &epv, &wf))
-			{
-				printf("ERROR in prcpANDrunoffH() from transient_bgc.c\n");
-				errorCode=5130;
-			}
-			
-	
-			/* snowmelt (when there is a snowpack) */
-			if (!errorCode && ws.snoww && snowmelt(&metv, &wf, ws.snoww))
-			{
-				printf("ERROR in snowmelt() from transient_bgc.c\n");
-				errorCode=5140;
-			}
-			
-
-			/* potential evaporation and transpiration */
-			if (!errorCode && Elimit_and_PET(&epc, &sprop, &metv, &epv, &wf))
-			{
-				printf("ERROR in Elimit_and_PET() from bgc.c\n");
-				errorCode=5150;
-			}
-			
-
-		  	/* conductance calculation */
-			if (!errorCode && conduct_calc(&ctrl, &metv, &epc, &epv, simyr))
-			{
-				printf("ERROR in conduct_calc() from transient_bgc.c\n");
-				errorCode=5160;
-			}
-			
-			
-
-			/* begin canopy bio-physical process simulation */
-			/* do canopy ET calculations whenever there is leaf areadisplayed, since there may be intercepted water on the canopy that needs to be dealt with */
-			if (!errorCode && epv.n_actphen > epc.n_emerg_phenophase && metv.dayl)
-			{
-				/* evapotranspiration */
-				if (!errorCode && cs.leafc && canopy_et(&epc, &metv, &epv, &wf))
-				{
-					printf("ERROR in canopy_et() from transient_bgc.c\n");
-					errorCode=5170;
-				}
-			}
-			
-
-			/* daily maintenance respiration */
-			if (!errorCode && maint_resp(&PLT, &cs, &ns, &epc, &metv, &epv, &cf))
-			{
-				printf("ERROR in m_resp() from transient_bgc.c\n");
-				errorCode=5180;
-			}
-			
-
-			/* do photosynthesis calculation */
-			if (!errorCode && cs.leafc && photosynthesis(&epc, &metv, &cs, &ws, &phen, &epv, &psn_sun, &psn_shade, &cf))
-			{
-				printf("ERROR in photosynthesis() from transient_bgc.c\n");
-				errorCode=5190;
-			}
-			
-				
-			/* daily litter and soil decomp and nitrogen fluxes */
-			if (!errorCode && decomp(&metv,&epc,&sprop,&sitec,&cs,&ns,&epv,&cf,&nf,&nt))
-			{
-				printf("ERROR in decomp() from bgc.c\n");
-				errorCode=5200;
-			}
-			
-
-
-	        /* Daily allocation gets called whether or not this is a current growth day, because the competition between decomp immobilization fluxes 
-			and plant growth N demand is resolved here.  On days with no growth, no allocation occurs, but immobilization fluxes are updated normally */
-
-			if (!errorCode && daily_allocation(&epc,&sprop,&metv,&ndep,&cs,&ns,&cf,&nf,&epv,&nt,0))
-			{
-				printf("ERROR in daily_allocation() from bgc.c\n");
-				errorCode=5210;
-			}
-			
-
-            /* heat stress during flowering can affect daily allocation of yield */
-			if (epc.n_flowHS_phenophase != DATA_GAP)
-			{
-				if (!errorCode && flowering_heatstress(&epc, &metv, &cs, &epv, &cf, &nf))
-				{
-					printf("ERROR in flowering_heatstress() from transient_bgc.c\n");
-					errorCode=5220;
-				}
-			}
-			
-			/* reassess the annual turnover rates for livewood --> deadwood, and for evergreen leaf and fine root litterfall. 
-			This happens once each year, on the annual_alloc day (the last litterfall day - test for annual allocation day) */
-			
-			if (phen.remdays_litfall == 1) annual_alloc = 1;
-			else annual_alloc = 0;
-
-			if (!errorCode && annual_alloc)
-			{
-				if (!errorCode && annual_rates(&epc,&epv))
-				{
-					printf("ERROR in annual_rates() from transient_bgc.c\n");
-					errorCode=5230;
-				}
-			} 
-			
-
-
-			/* daily growth respiration */
-			if (!errorCode && growth_resp(&epc, &cf))
-			{
-				printf("ERROR in growth_resp() from bgc.c\n");
-				errorCode=5240;
-			}
-			
-			
-			/* !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! */
-			/* 3. WATER CALCULATIONS WITH STATE UPDATE */
-			
-
-			/* EVAPORATION: calculation of actual evaporation from potential evaporation */
-			if (!errorCode && potEVPsurface_to_actEVPsurface(&ctrl, &sitec, &sprop, &epv, &ws, &wf))
-			{
-				printf("ERROR in potEVPsurface_to_actEVPsurface() from bgc.c()\n");
-				errorCode=5250;;
-			}
-			
-         
-			/* multilayer soil hydrology: percolation calculation based on PRCP, RUNOFF, EVP, TRANS */
-			if (!errorCode && multilayer_hydrolprocess(&ctrl,  &sitec, &sprop, &epc, &epv, &ws, &wf, &GWS, &gwc, &FLD, mondays))
-			{
-				printf("ERROR in multilayer_hydrolprocess() from transient_bgc.c\n");
-				errorCode=5260;
-			}
-			
-
-           
-			/* !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! */
-			/* 4. STATE UPDATE */
-
-			/* daily update of the water state variables */
-			if (!errorCode && water_state_update(&wf, &ws))
-			{
-				printf("ERROR in water_state_update() from transient_bgc.c\n");
-				errorCode=5270;
-			}
-			
-		
-	        /* daily update of carbon and nitrogen state variables */
-			if (!errorCode && CN_state_update(&sitec, &epc, &ctrl, &epv, &cf, &nf, &cs, &ns, annual_alloc, epc.evergreen))
-			{
-				printf("ERROR in CN_state_update() from transient_bgc.c\n");
-				errorCode=5280;
-			}
-			
-
-       
-			/* !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! */
-			/* 5. MORTALITY AND NITROGEN FLUXES CALCULATION WITH OWN STATE UPDATE: 
-			to insure that pools don't go negative due to mortality/leaching fluxes conflicting with other proportional fluxes  */
-
-			/* calculate daily senescence mortality fluxes and update state variables */
-			if (!errorCode && senescence(&sitec, &epc, &GRZ, &metv, &ctrl, &cs, &cf, &ns, &nf, &epv))
-			{
-				printf("ERROR in senescence() from transient_bgc.c\n");
-				errorCode=5290;
-			}
-			
-			
-		     /* calculate daily mortality fluxes  and update state variables */
-			if (!errorCode && mortality(&ctrl, &sitec, &epc, &epv, &cs, &cf, &ns, &nf, simyr))
-			{
-				printf("ERROR in mortality() from transient_bgc.c\n");
-				errorCode=5300;
-			}
-			
-	
-			/* calculate the change of soil mineralized N in multilayer soil */ 
-			if (!errorCode && multilayer_sminn(&ctrl, &metv, &sprop, &sitec, &cf, &ndep, &epv, &ns, &nf))
-			{
-				printf("ERROR in multilayer_sminn() from transient_bgc.c\n");
-				errorCode=5310;
-			}
-			
-
-			/* calculate the leaching of N, DOC and DON from multilayer soil */
-			if (!errorCode && multilayer_leaching(&sprop, &epv, &ctrl, &cs, &cf, &ns, &nf, &ws, &wf))
-			{
-				printf("ERROR in multilayer_leaching() from transient_bgc.c\n");
-				errorCode=5320;
-			}
-			
-	
-			/* !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! */
-			/* 6. MANAGEMENT FLUXES */
-			
-			/* PLANTING */
-			if (!errorCode && planting(&ctrl, &sitec, &PLT, &epc, &epv, &phen, &cs, &ns, &cf, &nf))
-			{
-				printf("ERROR in planting() from transient_bgc.c\n");
-				errorCode=5330;
-			}
-			
-
-		   	/* THINNIG  */
-			if (!errorCode && thinning(&ctrl, &epc, &THN, &cs, &ns, &ws, &cf, &nf, &wf))
-			{
-				printf("ERROR in thinning() from transient_bgc.c\n");
-				errorCode=5340;
-			}
-			
-
-			/* MOWING  */
-			if (!errorCode && mowing(&ctrl, &epc, &MOW, &epv, &cs, &ns, &ws, &cf, &nf, &wf))
-			{
-				printf("ERROR in mowing() from transient_bgc.c\n");
-				errorCode=5350;
-			}
-			
-
-			/* grazing  */
-			if (!errorCode && grazing(&ctrl, &epc, &sitec, &GRZ, &epv, &cs, &ns, &ws, &cf, &nf, &wf, mondays))
-			{
-				printf("ERROR in grazing() from transient_bgc.c\n");
-				errorCode=5360;
-			}
-	
-		   	/* HARVESTING  */
-			if (!errorCode && harvesting(bgcout->econout_file, &ctrl, &phen, &epc, &HRV, &IRG, &epv, &cs, &ns, &ws, &cf, &nf, &wf))
-			{
-				printf("ERROR in harvesting() from transient_bgc.c\n");
-				errorCode=5370;
-			}
-			
- 
-			/* PLOUGHING */
- 			if (!errorCode && ploughing(&ctrl, &epc, &sitec, &sprop, &metv, &epv, &PLG, &cs, &ns, &ws, &cf, &nf, &wf))
-			{
-				printf("ERROR in ploughing() from transient_bgc.c\n");
-				errorCode=5380;
-			}
-			
-		 
-			/* FERTILIZING  */
-	    	if (!errorCode && fertilizing(&ctrl, &sitec, &sprop, &FRZ, &cs, &ns, &ws, &cf, &nf, &wf))
-			{
-				printf("ERROR in fertilizing() from transient_bgc.c\n");
-				errorCode=5390;
-			}	
-			
-			
-			/* MULCHING */
-			if (!errorCode && mulching(&ctrl, &MUL, &cs, &ns, &cf, &nf))
-			{
-				printf("ERROR in mulching() from bgc.c\n");
-				errorCode=5400;
-			}
-			
-
-			/* CWD-extract */
-			if (!errorCode && CWDextract(&ctrl, &CWE, &cs, &ns, &cf, &nf))
-			{
-				printf("ERROR in CWDextract() from bgc.c\n");
-				errorCode=5410;
-			}
-			
-
-				
-			/* cut-down plant material (due to management) */
-			if (!errorCode && cutdown2litter(&sitec, &epc, &epv, &cs, &cf, &ns, &nf))
-			{
-				printf("ERROR in cutdown2litter() from transient_bgc.c\n");
-				errorCode=5420;
-			}
-			
-
-			/* calculating rooting depth, n_rootlayers, n_maxrootlayers, rootlengthProp */
- 			 if (!errorCode && multilayer_rootDepth(&epc, &sprop, &cs, &sitec, &epv))
-			 {
-				printf("ERROR in multilayer_rootDepth() from transient_bgc.c\n");
-				errorCode=5430;
-			 }
-			 
-
-			
-			/* !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! */
-			/* 7. ERROR CHECKING AND SUMMARY VARIABLES  */
-			
-			/* test for very low state variable values and force them to 0.0 to avoid rounding and floating point overflow errors */
-			if (!errorCode && precision_control(&ws, &cs, &ns))
-			{
-				printf("ERROR in call to precision_control() from transient_bgc.c\n");
-				errorCode=5440;
-			} 
-			
-				
-			/* test for water balance*/
-			if (!errorCode && check_water_balance(&ws, first_balance))
-			{
-				printf("ERROR in check_water_balance() from transient_bgc.c\n");
-				errorCode=5450;
-			}
-			
-			 
-
-            /* test for carbon balance */
-			if (!errorCode  && check_carbon_balance(&cs, first_balance))
-			{
-				printf("ERROR in check_carbon_balance() from transient_bgc.c\n");
-				errorCode=5460;
-			}
-			
-			
-
-			/* test for nitrogen balance */
-			if (!errorCode && check_nitrogen_balance(&ns, first_balance))
-			{
-				printf("ERROR in check_nitrogen_balance() from transient_bgc.c\n");
-				errorCode=5470;
-			}
-			
-			
-
-			/* calculate summary variables */
-			if (!errorCode && cnw_summary(&epc, &sitec, &sprop, &metv, &cs, &cf, &ns, &nf, &wf, &epv, &summary))
-			{
-				printf("ERROR in cnw_summary() from transient_bgc.c\n");
-				errorCode=5480;
-			}
-	        
-	
-	        /* output handling */
-			if (!errorCode && output_handling(mondays, enddays, &ctrl, output_map, dayarr, monavgarr, annavgarr, annarr, 
-				                            bgcout->dayoutT, bgcout->monavgoutT, bgcout->annavgoutT, bgcout->annoutT))
-			{
-				printf("ERROR in output_handling() from transient_bgc.c\n");
-				errorCode=5490;
-			}
-			
-
-			/* at the end of first day of simulation, turn off the first_balance switch */
-			if (first_balance) first_balance = 0;
-
-			/*  if no dormant period (e.g. evergreen): last day is the dormant day */
-			if (phen.offday - phen.onday == 364 && phen.offday == phen.yday_total) 
-			{
-				epv.n_actphen = 0;
-				phen.onday = -1;
-				phen.offday = -1;
-				phen.remdays_litfall =-1;
-			}
-
-			/* if this is the last day of the current month: increment current month counter */
-			if (yday == enddays[ctrl.curmonth]) ctrl.curmonth++;
-		
-	}
+			errorCode = D.step(&D, simyr, yday);
+		}   /* end of daily model loop */
 
 }
 	bgcin->ws = ws;
@@ -1064,15 +609,23 @@ int transient_bgc(bgcin_struct* bgcin, bgcout_struct* bgcout)
 	if ((errorCode == 0 || errorCode > 3050)) free(output_map);
     if (((errorCode == 0 || errorCode > 3060) && !ctrl.GSI_flag) || ((errorCode == 0 || errorCode > 4050) && ctrl.GSI_flag)) 
 	{
+		free(phenarr.onday_arr[0]);
+		free(phenarr.offday_arr[0]);
 		free(phenarr.onday_arr);
 		free(phenarr.offday_arr);
 		if (ctrl.GSI_flag)
 		{
+			free(phenarr.Tmin_index[0]);
 			free(phenarr.Tmin_index);
+			free(phenarr.vpd_index[0]);
 			free(phenarr.vpd_index);
+			free(phenarr.heatsum_index[0]);
 			free(phenarr.heatsum_index);
+			free(phenarr.heatsum[0]);
 			free(phenarr.heatsum);
+			free(phenarr.dayl_index[0]);
 			free(phenarr.dayl_index);
+			free(phenarr.gsi_indexAVG[0]);
 			free(phenarr.gsi_indexAVG);
 		}
 	}